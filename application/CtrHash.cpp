@@ -113,6 +113,12 @@ Hash::build(const std::wstring& string)
     MurmurHash3_x64_128(string.c_str(), (int32_t)(string.length() * sizeof(wchar_t)), 0, &_hash[0]);
 }
 
+void
+Hash::build(const void* data, size_t size)
+{
+    MurmurHash3_x64_128(data, (int32_t)(size), 0, &_hash[0]);
+}
+
 void
 Hash::append(const Hash& other)
 {
@@ -121,4 +127,12 @@ Hash::append(const Hash& other)
     MurmurHash3_x64_128(stream.str().c_str(), (int32_t)(stream.str().length() * sizeof(uint8_t)), 0, &_hash[0]);
 }
 
-}
\ No newline at end of file
+std::string
+Hash::hexString() const
+{
+    char buffer[Hash::HashSize * 2 + 1];
+    snprintf(buffer, sizeof(buffer), "%016llx%016llx",
+             (unsigned long long)_hash[0], (unsigned long long)_hash[1]);
+    return std::string(buffer);
+}
+}
@@ -63,8 +63,12 @@ class Hash
     
     void                       build(const std::string& string);
     void                       build(const std::wstring& string);
+    void                       build(const void* data, size_t size);
     void                       append(const Hash& hash);
 
+    // 32 hex digits, usable as a file name.
+    std::string                hexString() const;
+
   private:
     static const size_t HashSize = sizeof(uint64_t)* 2;
     uint64_t                   _hash[2];
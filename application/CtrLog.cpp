@@ -40,6 +40,11 @@
 //------------------------------------------------------------------------------------//
 
 #include <CtrLog.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 namespace Ctr
 {
@@ -49,19 +54,270 @@ LoggingLevel   Log::_logLevel = LogCritical;
 
 namespace
 {
+//-----------------------------------------------------------
+// Bounded multi producer, single consumer ring buffer.
+// Each cell carries a sequence number: producers claim a
+// slot with a CAS on the enqueue position, fill it and then
+// publish it by bumping the sequence. The writer thread is
+// the only consumer.
+//-----------------------------------------------------------
+class LogWriter
+{
+  public:
+    LogWriter(const std::string& filePathName) :
+        _file(nullptr),
+        _enqueuePos(0),
+        _dequeuePos(0),
+        _flushTarget(0),
+        _synced(0),
+        _pending(false),
+        _stop(false)
+    {
+        for (size_t i = 0; i < Capacity; i++)
+        {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        _file = fopen(filePathName.c_str(), "w");
+        _thread = std::thread(&LogWriter::run, this);
+    }
+
+    ~LogWriter()
+    {
+        _stop.store(true);
+        wake();
+        _thread.join();
+        if (_file)
+        {
+            fclose(_file);
+        }
+    }
+
+    void push(const std::string& text, LogEntryLevel level)
+    {
+        Cell* cell = nullptr;
+        size_t position = _enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &_cells[position & (Capacity - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+            if (difference == 0)
+            {
+                if (_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                // Full. Let the writer catch up rather than drop entries.
+                wake();
+                std::this_thread::yield();
+                position = _enqueuePos.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                position = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->text = text;
+        cell->level = level;
+        cell->sequence.store(position + 1, std::memory_order_release);
+
+        if (!_pending.exchange(true))
+        {
+            wake();
+        }
+    }
+
+    void flush()
+    {
+        size_t target = _enqueuePos.load(std::memory_order_acquire);
+        size_t requested = _flushTarget.load();
+        while (requested < target && !_flushTarget.compare_exchange_weak(requested, target))
+        {
+        }
+        wake();
+
+        std::unique_lock<std::mutex> lock(_flushMutex);
+        _flushed.wait(lock, [&] { return _synced.load() >= target; });
+    }
+
+  private:
+    void wake()
+    {
+        std::lock_guard<std::mutex> lock(_wakeMutex);
+        _wakeCondition.notify_one();
+    }
+
+    bool pop(std::string& text, LogEntryLevel& level)
+    {
+        Cell* cell = &_cells[_dequeuePos & (Capacity - 1)];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if ((intptr_t)sequence - (intptr_t)(_dequeuePos + 1) < 0)
+        {
+            return false;
+        }
+
+        text.swap(cell->text);
+        level = cell->level;
+        cell->sequence.store(_dequeuePos + Capacity, std::memory_order_release);
+        _dequeuePos++;
+        return true;
+    }
+
+    void run()
+    {
+        std::string text;
+        LogEntryLevel level;
+
+        for (;;)
+        {
+            _pending.store(false);
+
+            bool critical = false;
+            while (pop(text, level))
+            {
+                if (_file)
+                {
+                    fwrite(text.c_str(), sizeof(char), text.length(), _file);
+                    fputc('\n', _file);
+                }
+                std::cout << text << "\n";
+                critical |= level == CriticalEntry;
+            }
+
+            // Sync to disk for critical entries and outstanding flush requests.
+            if (critical || _flushTarget.load() > _synced.load())
+            {
+                if (_file)
+                    fflush(_file);
+                std::cout.flush();
+
+                {
+                    std::lock_guard<std::mutex> lock(_flushMutex);
+                    _synced.store(_dequeuePos);
+                }
+                _flushed.notify_all();
+            }
+
+            if (_stop.load() && _dequeuePos == _enqueuePos.load())
+            {
+                break;
+            }
+
+            std::unique_lock<std::mutex> lock(_wakeMutex);
+            _wakeCondition.wait_for(lock, std::chrono::milliseconds(50), 
+                                    [&] { return _pending.load() || _stop.load() || _flushTarget.load() > _synced.load(); });
+        }
+
+        if (_file)
+            fflush(_file);
+    }
+
+    enum { Capacity = 4096 };
+
+    struct Cell
+    {
+        std::atomic<size_t>    sequence;
+        std::string            text;
+        LogEntryLevel          level;
+    };
+
+    Cell                       _cells[Capacity];
+    FILE*                      _file;
+
+    std::atomic<size_t>        _enqueuePos;
+    size_t                     _dequeuePos;
+    // Highest position a flush is waiting on, and the last position synced to disk.
+    std::atomic<size_t>        _flushTarget;
+    std::atomic<size_t>        _synced;
+
+    std::atomic<bool>          _pending;
+    std::atomic<bool>          _stop;
+
+    std::mutex                 _wakeMutex;
+    std::condition_variable    _wakeCondition;
+    std::mutex                 _flushMutex;
+    std::condition_variable    _flushed;
+    std::thread                _thread;
+};
+
+std::mutex                     logWriterMutex;
+std::atomic<LogWriter*>        logWriter(nullptr);
+bool                           logWriterShutdown = false;
+// Threads using the current writer. Only threads that got the writer
+// are counted, under logWriterUseMutex, so shutdown waits for those
+// alone and is never starved by new writes.
+std::mutex                     logWriterUseMutex;
+std::atomic<uint32_t>          logWriterUsers(0);
+
+//-----------------------------------------------------------
+// Keeps the writer it got alive for the current scope.
+//-----------------------------------------------------------
+class LogWriterUse
+{
+  public:
+    LogWriterUse()
+    {
+        std::lock_guard<std::mutex> lock(logWriterUseMutex);
+        _writer = logWriter.load();
+        if (_writer)
+            logWriterUsers.fetch_add(1);
+    }
+
+    ~LogWriterUse()
+    {
+        if (_writer)
+            logWriterUsers.fetch_sub(1);
+    }
+
+    LogWriter*                 writer() const { return _writer; }
+
+  private:
+    LogWriter*                 _writer;
+};
+
 Log applicationLog;
 }
 
+Log::Log()
+{
+}
+
+Log::~Log()
+{
+    // Static teardown of applicationLog, drain whatever is queued.
+    Log::shutdown();
+}
+
 void Log::initialize(const std::string& filePathName)
 {
+    std::lock_guard<std::mutex> lock(logWriterMutex);
+    if (!_initialized)
     {
         std::cout.precision (4);
         _filePathName = filePathName;
-        DeleteFileA(_filePathName.c_str());
+        if (!logWriterShutdown)
+        {
+            logWriter.store(new LogWriter(_filePathName));
+        }
         _initialized = true;
     }
 }
 
+void
+Log::setLogLevel(LoggingLevel level)
+{
+    _logLevel = level;
+}
+
+LoggingLevel
+Log::logLevel()
+{
+    return _logLevel;
+}
+
 void 
 Log::write (const std::string& buffer, LogEntryLevel level)
 {
@@ -73,17 +329,66 @@ Log::write (const std::string& buffer, LogEntryLevel level)
         Log::initialize(Log::_filePathName);
     }
 
-    FILE* file = 0;
-    int result;
-    if((result = fopen_s(&file, Log::_filePathName.c_str(), "a+"))!=0)
+    {
+        LogWriterUse use;
+        if (LogWriter* writer = use.writer())
+        {
+            writer->push(buffer, level);
+            if (level == CriticalEntry)
+            {
+                writer->flush();
+            }
+            return;
+        }
+    }
+    writeSynchronous(buffer);
+}
+
+void
+Log::writeSynchronous(const std::string& buffer)
+{
+    std::lock_guard<std::mutex> lock(logWriterMutex);
+
+    FILE* file = fopen(Log::_filePathName.c_str(), "a+");
+    if (!file)
         return;
 
-    std::ostringstream _file;
-    _file.precision (4);
-    _file << buffer << std::endl;
     std::cout << buffer << "\n";
-    fwrite (_file.str().c_str(), sizeof (char), strlen (_file.str().c_str()), file);
+    fwrite (buffer.c_str(), sizeof (char), buffer.length(), file);
+    fputc ('\n', file);
     fclose (file);
 }
 
-}
\ No newline at end of file
+void
+Log::flush()
+{
+    LogWriterUse use;
+    if (LogWriter* writer = use.writer())
+    {
+        writer->flush();
+    }
+}
+
+void
+Log::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(logWriterMutex);
+        logWriterShutdown = true;
+    }
+
+    // Later writes see no writer and go synchronous; wait out the threads
+    // still using it. Deleting drains the queue and joins the thread.
+    LogWriter* writer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(logWriterUseMutex);
+        writer = logWriter.exchange(nullptr);
+    }
+    while (logWriterUsers.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+    safedelete(writer);
+}
+
+}
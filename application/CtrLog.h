@@ -49,7 +49,10 @@ namespace Ctr
 //-----------------------------------------------------------
 // class Log
 // Very, very simple and dumb logging to file wrapper.
-// Not threadsafe. Prints to std out along with file io.
+// Entries are pushed onto a lock free ring buffer and written
+// (and echoed to std out) by a dedicated writer thread that
+// keeps the log file open. Critical entries are flushed before
+// write returns. Threadsafe.
 //-----------------------------------------------------------
 enum LogEntryLevel
 {
@@ -68,11 +71,24 @@ enum LoggingLevel
 class Log
 {
   public:
+    Log();
+    ~Log();
+
     static void                write(const std::string& s, Ctr::LogEntryLevel level = Ctr::InfoEntry);
-    static void                setLogLevel();
+    static void                setLogLevel(LoggingLevel level);
+    static LoggingLevel        logLevel();
+
+    // Checked by the LOG macros before any formatting is done.
+    static bool                enabled(LogEntryLevel level) { return level >= _logLevel; }
+
+    // Blocks until every entry written so far is on disk.
+    static void                flush();
+    // Drains the queue and stops the writer thread. Later writes are synchronous.
+    static void                shutdown();
 
   protected:
     static void                initialize(const std::string& logFilePathName);
+    static void                writeSynchronous(const std::string& s);
 
   private:
     static bool                _initialized;
@@ -80,25 +96,34 @@ class Log
     static LoggingLevel        _logLevel;
 };
 
-#define LOG(text)                                     \
-{                                                     \
-    std::ostringstream s;                             \
-    s << text << "\0";                                \
-    Ctr::Log::write (std::string(s.str().c_str()),Ctr::InfoEntry);   \
+#define LOG(text)                                      \
+{                                                      \
+    if (Ctr::Log::enabled(Ctr::InfoEntry))             \
+    {                                                  \
+        std::ostringstream s;                          \
+        s << text;                                     \
+        Ctr::Log::write (s.str(), Ctr::InfoEntry);     \
+    }                                                  \
 }
 
-#define LOG_WARNING(text)                                  \
-{                                                          \
-    std::ostringstream s;                                  \
-    s << text << "\0";                                     \
-    Ctr::Log::write (std::string(s.str().c_str()), Ctr::WarningEntry); \
+#define LOG_WARNING(text)                              \
+{                                                      \
+    if (Ctr::Log::enabled(Ctr::WarningEntry))          \
+    {                                                  \
+        std::ostringstream s;                          \
+        s << text;                                     \
+        Ctr::Log::write (s.str(), Ctr::WarningEntry);  \
+    }                                                  \
 }
 
-#define LOG_CRITICAL(text)                                \
-{                                                          \
-    std::ostringstream s;                                  \
-    s << text << "\0";                                     \
-    Ctr::Log::write (std::string(s.str().c_str()), Ctr::CriticalEntry); \
+#define LOG_CRITICAL(text)                             \
+{                                                      \
+    if (Ctr::Log::enabled(Ctr::CriticalEntry))         \
+    {                                                  \
+        std::ostringstream s;                          \
+        s << text;                                     \
+        Ctr::Log::write (s.str(), Ctr::CriticalEntry); \
+    }                                                  \
 }
 
 #define IBLASSERT(expression, text) \
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+
+#include <CtrParallel.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace Ctr
+{
+namespace
+{
+thread_local bool insideParallelRun = false;
+
+//------------------------------------------------------------------
+// One worker per core but the caller's, started on first use. Each
+// run bumps the generation and waits for every worker to report
+// back, so a worker never sees two jobs overlap.
+//------------------------------------------------------------------
+class WorkerPool
+{
+  public:
+    WorkerPool() :
+        _stop(false),
+        _generation(0),
+        _active(0),
+        _count(0),
+        _next(0),
+        _function(nullptr)
+    {
+        uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+        for (uint32_t threadId = 0; threadId < threadCount; threadId++)
+        {
+            _threads.push_back(std::thread(&WorkerPool::work, this));
+        }
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto it = _threads.begin(); it != _threads.end(); it++)
+        {
+            it->join();
+        }
+    }
+
+    bool run(uint64_t count, const std::function<void(uint64_t)>& function)
+    {
+        std::unique_lock<std::mutex> runLock(_runMutex, std::try_to_lock);
+        if (!runLock.owns_lock() || _threads.size() == 0)
+            return false;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _function = &function;
+            _count = count;
+            _next.store(0);
+            _error = nullptr;
+            _active = uint32_t(_threads.size());
+            _generation++;
+        }
+        _wake.notify_all();
+
+        insideParallelRun = true;
+        process();
+        insideParallelRun = false;
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [this]() { return _active == 0; });
+            _function = nullptr;
+            error = _error;
+        }
+        if (error)
+            std::rethrow_exception(error);
+        return true;
+    }
+
+  private:
+    void process()
+    {
+        for (uint64_t i = _next++; i < _count; i = _next++)
+        {
+            try
+            {
+                (*_function)(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_error)
+                    _error = std::current_exception();
+                _next.store(_count);
+            }
+        }
+    }
+
+    void work()
+    {
+        insideParallelRun = true;
+        uint64_t generation = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [&]() { return _stop || _generation != generation; });
+                if (_stop)
+                    return;
+                generation = _generation;
+            }
+
+            process();
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (--_active == 0)
+                    _done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread>   _threads;
+    std::mutex                 _runMutex;
+    std::mutex                 _mutex;
+    std::condition_variable    _wake;
+    std::condition_variable    _done;
+    bool                       _stop;
+    uint64_t                   _generation;
+    uint32_t                   _active;
+    uint64_t                   _count;
+    std::atomic<uint64_t>      _next;
+    const std::function<void(uint64_t)>* _function;
+    std::exception_ptr         _error;
+};
+}
+
+void
+parallelRun(uint64_t count, const std::function<void(uint64_t)>& function)
+{
+    if (count == 0)
+        return;
+
+    if (count > 1 && !insideParallelRun)
+    {
+        static WorkerPool pool;
+        if (pool.run(count, function))
+            return;
+    }
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+        function(i);
+    }
+}
+
+}
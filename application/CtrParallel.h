@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+
+#ifndef INCLUDED_CRT_PARALLEL
+#define INCLUDED_CRT_PARALLEL
+
+#include <CtrPlatform.h>
+#include <functional>
+
+#if _WIN32 || _WIN64
+#include <ppl.h>
+#endif
+
+namespace Ctr
+{
+//------------------------------------------------------------------
+// Calls function(i) for every i in [0, count) on a shared pool of
+// worker threads and the calling thread, returning once all calls
+// have finished. The first exception thrown is rethrown here. Calls
+// made from inside a pool job, or while another thread owns the
+// pool, run serially on the calling thread.
+//------------------------------------------------------------------
+void                           parallelRun(uint64_t count, 
+                                           const std::function<void(uint64_t)>& function);
+
+//------------------------------------------------------------------
+// concurrency::parallel_for on Windows, parallelRun elsewhere.
+//------------------------------------------------------------------
+template <typename Index, typename Function>
+void
+parallelFor(Index first, Index last, const Function& function)
+{
+#if _WIN32 || _WIN64
+    concurrency::parallel_for(first, last, function);
+#else
+    if (!(first < last))
+        return;
+
+    parallelRun(uint64_t(last - first), [&](uint64_t i)
+    {
+        function(Index(first + Index(i)));
+    });
+#endif
+}
+}
+
+#endif
@@ -57,6 +57,7 @@
 #include <map>
 #include <vector>
 #include <algorithm>
+#include <stdexcept>
 
 // Include streams
 #include <iostream>
@@ -74,6 +75,14 @@
 #include <string.h>
 #include <stdint.h>
 
+// SSE2 is the baseline for x64 and is forced for x86 builds (/arch:SSE2).
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define CTR_SSE 1
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#else
+#define CTR_SSE 0
+#endif
 
 // Typedef Win32 stuff out of the way
 #if _WIN32 || _WIN64
@@ -128,6 +137,34 @@ typedef HANDLE    OSHandle;
 #endif
 #endif
 
+typedef void*     ApplicationHandle;
+typedef void*     WindowHandle;
+typedef void*     OSHandle;
+
+// Win32 integer types used by the render api.
+typedef uint8_t     BYTE;
+typedef uint16_t    WORD;
+typedef uint32_t    DWORD;
+typedef const char* LPCSTR;
+
+// Win32 window message types used by the window interfaces.
+typedef uint32_t    UINT;
+typedef uintptr_t   WPARAM;
+typedef intptr_t    LPARAM;
+typedef intptr_t    LRESULT;
+typedef void*       HWND;
+typedef void*       HBRUSH;
+#define CALLBACK
+
+#include <strings.h>
+#define _strcmpi strcasecmp
+
+#define FORCEINLINE inline __attribute__((always_inline))
+
+#define MAKEFOURCC(ch0, ch1, ch2, ch3)                             \
+    ((DWORD)(BYTE)(ch0) | ((DWORD)(BYTE)(ch1) << 8) |              \
+    ((DWORD)(BYTE)(ch2) << 16) | ((DWORD)(BYTE)(ch3) << 24))
+
 #endif
 
 #define THROW(text)                                                \
@@ -0,0 +1,463 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrProfiler.h>
+#include <CtrTimer.h>
+#include <CtrLog.h>
+#include <atomic>
+#include <mutex>
+#include <tuple>
+
+namespace Ctr
+{
+namespace
+{
+struct ProfileEvent
+{
+    const char*                name;
+    uint64_t                   start;
+    uint64_t                   end;
+    uint32_t                   depth;
+};
+
+//-----------------------------------------------------------
+// Single producer, single consumer ring of closed zones.
+// The owning thread is the only writer, endFrame the only
+// reader. A full buffer drops events rather than stalling
+// the thread being measured.
+//-----------------------------------------------------------
+class ProfileBuffer
+{
+  public:
+    static const size_t        Capacity = 1 << 14;
+    static const uint32_t      MaxDepth = 64;
+
+    ProfileBuffer(uint32_t thread) :
+        _head(0),
+        _tail(0),
+        _thread(thread),
+        _depth(0)
+    {
+        std::ostringstream stream;
+        stream << "Thread " << thread;
+        _name = stream.str();
+    }
+
+    void begin(const char* name, bool enabled)
+    {
+        if (_depth < MaxDepth)
+        {
+            _open[_depth].name = enabled ? name : nullptr;
+            _open[_depth].start = enabled ? Timer::ticks() : 0;
+        }
+        _depth++;
+    }
+
+    void end(std::atomic<uint64_t>& dropped)
+    {
+        if (_depth == 0)
+            return;
+
+        _depth--;
+        if (_depth >= MaxDepth || !_open[_depth].name)
+            return;
+
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= Capacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        ProfileEvent& event = _events[head & (Capacity - 1)];
+        event.name = _open[_depth].name;
+        event.start = _open[_depth].start;
+        event.end = Timer::ticks();
+        event.depth = _depth;
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    template <typename Function>
+    void drain(Function function)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t head = _head.load(std::memory_order_acquire);
+        for (; tail != head; tail++)
+        {
+            function(_events[tail & (Capacity - 1)]);
+        }
+        _tail.store(tail, std::memory_order_release);
+    }
+
+    uint32_t                   thread() const { return _thread; }
+    const std::string&         name() const { return _name; }
+    void                       setName(const char* name) { _name = name; }
+
+  private:
+    ProfileEvent               _events[Capacity];
+    std::atomic<size_t>        _head;
+    std::atomic<size_t>        _tail;
+
+    ProfileEvent               _open[MaxDepth];
+    uint32_t                   _thread;
+    uint32_t                   _depth;
+    std::string                _name;
+};
+
+struct CapturedEvent
+{
+    ProfileEvent               event;
+    uint32_t                   thread;
+};
+
+typedef std::tuple<const char*, uint32_t, uint32_t> ZoneKey;
+
+struct ZoneRecord
+{
+    ProfileZoneStats           stats;
+    uint64_t                   firstStart;
+    uint64_t                   lastSeenFrame;
+};
+
+class ProfilerState
+{
+  public:
+    ProfilerState() :
+        enabled(true),
+        dropped(0),
+        frame(0),
+        frameMs(0),
+        frameStart(Timer::ticks()),
+        capturing(false),
+        captureStart(0)
+    {
+    }
+
+    ProfileBuffer* threadBuffer()
+    {
+        static thread_local ProfileBuffer* buffer = nullptr;
+        if (!buffer)
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            buffers.push_back(std::unique_ptr<ProfileBuffer>(new ProfileBuffer(uint32_t(buffers.size()))));
+            buffer = buffers.back().get();
+        }
+        return buffer;
+    }
+
+    std::atomic<bool>          enabled;
+    std::atomic<uint64_t>      dropped;
+
+    // Buffers are never released, a thread may exit with events still queued.
+    std::mutex                 buffersMutex;
+    std::vector<std::unique_ptr<ProfileBuffer> > buffers;
+
+    std::mutex                 statsMutex;
+    std::map<ZoneKey, ZoneRecord> zones;
+    std::vector<ProfileZoneStats> frameStats;
+    uint64_t                   frame;
+    double                     frameMs;
+    uint64_t                   frameStart;
+
+    std::vector<CapturedEvent> captured;
+    bool                       capturing;
+    uint64_t                   captureStart;
+};
+
+ProfilerState&
+profilerState()
+{
+    static ProfilerState state;
+    return state;
+}
+
+// Zones that have not been seen for this many frames are forgotten.
+const uint64_t ZoneLifetime = 120;
+const double   AverageWeight = 0.1;
+
+double
+ticksToMs(uint64_t ticks)
+{
+    return double(ticks) * 1000.0 / double(Timer::ticksPerSecond());
+}
+
+void
+writeEscaped(std::ostream& stream, const std::string& text)
+{
+    for (auto it = text.begin(); it != text.end(); it++)
+    {
+        if (*it == '"' || *it == '\\')
+            stream << '\\';
+        if ((unsigned char)(*it) >= 0x20)
+            stream << *it;
+    }
+}
+}
+
+void
+Profiler::beginZone(const char* name)
+{
+    ProfilerState& state = profilerState();
+    state.threadBuffer()->begin(name, state.enabled.load(std::memory_order_relaxed));
+}
+
+void
+Profiler::endZone()
+{
+    ProfilerState& state = profilerState();
+    state.threadBuffer()->end(state.dropped);
+}
+
+void
+Profiler::endFrame()
+{
+    ProfilerState& state = profilerState();
+    uint64_t now = Timer::ticks();
+
+    std::lock_guard<std::mutex> statsLock(state.statsMutex);
+    state.frame++;
+    state.frameMs = ticksToMs(now - state.frameStart);
+    state.frameStart = now;
+
+    for (auto it = state.zones.begin(); it != state.zones.end(); it++)
+    {
+        it->second.stats.calls = 0;
+        it->second.stats.totalMs = 0;
+        it->second.stats.maxMs = 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> buffersLock(state.buffersMutex);
+        for (auto buffer = state.buffers.begin(); buffer != state.buffers.end(); buffer++)
+        {
+            uint32_t thread = (*buffer)->thread();
+            (*buffer)->drain([&](const ProfileEvent& event)
+            {
+                double ms = ticksToMs(event.end - event.start);
+                ZoneRecord& record = state.zones[ZoneKey(event.name, thread, event.depth)];
+                if (record.stats.calls == 0)
+                {
+                    record.stats.name = event.name;
+                    record.stats.thread = thread;
+                    record.stats.depth = event.depth;
+                    record.firstStart = event.start;
+                }
+                record.stats.calls++;
+                record.stats.totalMs += ms;
+                record.stats.maxMs = std::max(record.stats.maxMs, ms);
+                record.firstStart = std::min(record.firstStart, event.start);
+                record.lastSeenFrame = state.frame;
+
+                // Events drained late can have closed before the capture began.
+                if (state.capturing && event.end > state.captureStart)
+                {
+                    CapturedEvent captured = { event, thread };
+                    state.captured.push_back(captured);
+                }
+            });
+        }
+    }
+
+    // Threads in order, zones in the order they were first entered this frame.
+    std::vector<std::pair<uint64_t, const ProfileZoneStats*> > visible;
+    for (auto it = state.zones.begin(); it != state.zones.end();)
+    {
+        ZoneRecord& record = it->second;
+        if (state.frame - record.lastSeenFrame > ZoneLifetime)
+        {
+            it = state.zones.erase(it);
+            continue;
+        }
+
+        if (record.lastSeenFrame == state.frame)
+        {
+            record.stats.averageMs = record.stats.averageMs == 0 ? record.stats.totalMs :
+                record.stats.averageMs + (record.stats.totalMs - record.stats.averageMs) * AverageWeight;
+            visible.push_back(std::make_pair(record.firstStart, &record.stats));
+        }
+        it++;
+    }
+
+    std::sort(visible.begin(), visible.end(),
+              [](const std::pair<uint64_t, const ProfileZoneStats*>& a,
+                 const std::pair<uint64_t, const ProfileZoneStats*>& b)
+    {
+        if (a.second->thread != b.second->thread)
+            return a.second->thread < b.second->thread;
+        if (a.first != b.first)
+            return a.first < b.first;
+        return a.second->depth < b.second->depth;
+    });
+
+    state.frameStats.clear();
+    for (auto it = visible.begin(); it != visible.end(); it++)
+    {
+        state.frameStats.push_back(*it->second);
+    }
+}
+
+void
+Profiler::setEnabled(bool enabled)
+{
+    profilerState().enabled.store(enabled);
+}
+
+bool
+Profiler::enabled()
+{
+    return profilerState().enabled.load();
+}
+
+void
+Profiler::setThreadName(const char* name)
+{
+    ProfilerState& state = profilerState();
+    ProfileBuffer* buffer = state.threadBuffer();
+    std::lock_guard<std::mutex> lock(state.buffersMutex);
+    buffer->setName(name);
+}
+
+uint64_t
+Profiler::frame()
+{
+    ProfilerState& state = profilerState();
+    std::lock_guard<std::mutex> lock(state.statsMutex);
+    return state.frame;
+}
+
+double
+Profiler::frameMs()
+{
+    ProfilerState& state = profilerState();
+    std::lock_guard<std::mutex> lock(state.statsMutex);
+    return state.frameMs;
+}
+
+uint64_t
+Profiler::droppedEvents()
+{
+    return profilerState().dropped.load();
+}
+
+void
+Profiler::frameStats(std::vector<ProfileZoneStats>& stats)
+{
+    ProfilerState& state = profilerState();
+    std::lock_guard<std::mutex> lock(state.statsMutex);
+    stats = state.frameStats;
+}
+
+void
+Profiler::beginCapture()
+{
+    ProfilerState& state = profilerState();
+    std::lock_guard<std::mutex> lock(state.statsMutex);
+    state.captured.clear();
+    state.capturing = true;
+    state.captureStart = Timer::ticks();
+}
+
+bool
+Profiler::capturing()
+{
+    ProfilerState& state = profilerState();
+    std::lock_guard<std::mutex> lock(state.statsMutex);
+    return state.capturing;
+}
+
+bool
+Profiler::endCapture(const std::string& filePathName)
+{
+    ProfilerState& state = profilerState();
+    std::vector<CapturedEvent> events;
+    uint64_t captureStart = 0;
+    {
+        std::lock_guard<std::mutex> lock(state.statsMutex);
+        if (!state.capturing)
+            return false;
+        state.capturing = false;
+        events.swap(state.captured);
+        captureStart = state.captureStart;
+    }
+
+    std::ofstream file(filePathName.c_str(), std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        LOG("Failed to open profile trace " << filePathName);
+        return false;
+    }
+
+    const double ticksToUs = 1000000.0 / double(Timer::ticksPerSecond());
+    file << "{\"traceEvents\":[\n";
+
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(state.buffersMutex);
+        for (auto buffer = state.buffers.begin(); buffer != state.buffers.end(); buffer++)
+        {
+            file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                 << (*buffer)->thread() << ",\"args\":{\"name\":\"";
+            writeEscaped(file, (*buffer)->name());
+            file << "\"}}";
+            first = false;
+        }
+    }
+
+    file << std::fixed;
+    file.precision(3);
+    for (auto it = events.begin(); it != events.end(); it++)
+    {
+        // Zones opened before the capture started are clamped to it.
+        uint64_t start = std::max(it->event.start, captureStart);
+        file << (first ? "" : ",\n") << "{\"name\":\"";
+        writeEscaped(file, it->event.name);
+        file << "\",\"cat\":\"critter\",\"ph\":\"X\",\"pid\":1,\"tid\":" << it->thread
+             << ",\"ts\":" << double(start - captureStart) * ticksToUs
+             << ",\"dur\":" << double(it->event.end - start) * ticksToUs << "}";
+        first = false;
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    LOG("Wrote " << events.size() << " profile events to " << filePathName);
+    return file.good();
+}
+
+}
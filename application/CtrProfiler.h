@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CTR_PROFILER
+#define INCLUDED_CTR_PROFILER
+
+#include <CtrPlatform.h>
+
+// Set by the build (CRITTER_PROFILE). When 0 the macros below expand to
+// nothing and no profiler code is emitted at the call sites.
+#ifndef CTR_PROFILE
+#define CTR_PROFILE 0
+#endif
+
+namespace Ctr
+{
+//-----------------------------------------------------------
+// Aggregated timings for one zone over the last frame.
+// Zones are keyed by name, nesting depth and thread.
+//-----------------------------------------------------------
+struct ProfileZoneStats
+{
+    const char*                name;
+    uint32_t                   thread;
+    uint32_t                   depth;
+    uint32_t                   calls;
+    double                     totalMs;
+    double                     maxMs;
+    double                     averageMs;
+};
+
+//-----------------------------------------------------------
+// class Profiler
+// Hierarchical scoped CPU profiler. Each thread records closed
+// zones into its own single producer ring buffer, so entering
+// and leaving a zone is two tick reads and no locks. endFrame
+// drains every buffer, aggregates per zone statistics and, while
+// a capture is running, keeps the raw events for export in the
+// Chrome trace format (chrome://tracing, Perfetto).
+// Zone names must be string literals or otherwise outlive the
+// profiler. Threadsafe.
+//-----------------------------------------------------------
+class Profiler
+{
+  public:
+    static void                beginZone(const char* name);
+    static void                endZone();
+
+    // Called once per frame, from Timer::update.
+    static void                endFrame();
+
+    static void                setEnabled(bool enabled);
+    static bool                enabled();
+    static void                setThreadName(const char* name);
+
+    static uint64_t            frame();
+    static double              frameMs();
+    static uint64_t            droppedEvents();
+    static void                frameStats(std::vector<ProfileZoneStats>& stats);
+
+    // Records every zone until endCapture, which writes the trace.
+    static void                beginCapture();
+    static bool                endCapture(const std::string& filePathName);
+    static bool                capturing();
+};
+
+class ProfileScope
+{
+  public:
+    ProfileScope(const char* name) { Profiler::beginZone(name); }
+    ~ProfileScope() { Profiler::endZone(); }
+
+  private:
+    ProfileScope(const ProfileScope&);
+    ProfileScope& operator=(const ProfileScope&);
+};
+
+#define CTR_PROFILE_CONCAT_INNER(a, b) a##b
+#define CTR_PROFILE_CONCAT(a, b) CTR_PROFILE_CONCAT_INNER(a, b)
+
+#if CTR_PROFILE
+#define CTR_PROFILE_SCOPE(name) Ctr::ProfileScope CTR_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define CTR_PROFILE_FRAME()     Ctr::Profiler::endFrame()
+#define CTR_PROFILE_THREAD(name) Ctr::Profiler::setThreadName(name)
+#else
+#define CTR_PROFILE_SCOPE(name)
+#define CTR_PROFILE_FRAME()
+#define CTR_PROFILE_THREAD(name)
+#endif
+
+}
+
+#endif
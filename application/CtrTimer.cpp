@@ -41,9 +41,45 @@
 
 #include <CtrTimer.h>
 #include <CtrLog.h>
+#include <CtrProfiler.h>
+#include <chrono>
+#include <thread>
 
 namespace Ctr
 {
+namespace
+{
+//------------------------------------------------------------------
+// Performance counter and its frequency. Other platforms count
+// nanoseconds on the monotonic clock.
+//------------------------------------------------------------------
+int64_t
+queryCounter()
+{
+#if _WIN32 || _WIN64
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+int64_t
+queryFrequency()
+{
+#if _WIN32 || _WIN64
+    LARGE_INTEGER frequency;
+    frequency.QuadPart = 0;
+    QueryPerformanceFrequency(&frequency);
+    return frequency.QuadPart;
+#else
+    return 1000000000;
+#endif
+}
+}
+
 Timer::Timer() :
     _timerInitialized(false),
     _llQPFTicksPerSec(0),
@@ -61,16 +97,21 @@ Timer::Timer() :
     _frameRate(0),
     _frameRateCounter(0),
     _frameRateTimeElapsed(0.0),
-    _timerMask(0)
+    _timerMask(0),
+    _timeEvent(nullptr)
 {
+#if _WIN32 || _WIN64
     _timeEvent = CreateEvent(nullptr,TRUE,FALSE,nullptr);
     ResetEvent(_timeEvent);    
+#endif
     initialize();
 }
 
 Timer::~Timer()
 {
+#if _WIN32 || _WIN64
     CloseHandle(_timeEvent);
+#endif
 }
 
 const double&
@@ -83,14 +124,18 @@ void
 Timer::preciseSleep(double seconds)
 { 
     const unsigned int milliseconds= (unsigned int)(seconds*1000.0);
-    HANDLE thread = GetCurrentThread();
     if (milliseconds == 0)
         return;
 
+#if _WIN32 || _WIN64
     // Set affinity to the first core
+    HANDLE thread = GetCurrentThread();
     intptr_t oldMask = SetThreadAffinityMask(thread, _timerMask);
 	WaitForSingleObject(_timeEvent, milliseconds);
     SetThreadAffinityMask(thread, oldMask);
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+#endif
 }
 
 size_t
@@ -105,14 +150,27 @@ Timer::time (size_t frame, double rate)
     return double(frame) * (1.0f / rate);
 }
 
+uint64_t
+Timer::ticks()
+{
+    return uint64_t(queryCounter());
+}
+
+uint64_t
+Timer::ticksPerSecond()
+{
+    static const uint64_t frequency = uint64_t(queryFrequency());
+    return frequency;
+}
+
 bool 
 Timer::initialize()
 {
-    if(_timerInitialized  == FALSE)
+    if (!_timerInitialized)
     {
-        _timerInitialized = TRUE;
-        LARGE_INTEGER qwTicksPerSec;
+        _timerInitialized = true;
 
+#if _WIN32 || _WIN64
         DWORD_PTR procMask;
         DWORD_PTR sysMask;
         GetProcessAffinityMask(GetCurrentProcess(), &procMask, &sysMask);
@@ -134,22 +192,24 @@ Timer::initialize()
 
         // Set affinity to the first core
         DWORD_PTR oldMask = SetThreadAffinityMask(thread, _timerMask);
+#endif
 
         // Assert if we cannot use query performance counter.
-        qwTicksPerSec.QuadPart = 0;
-        if (QueryPerformanceFrequency( &qwTicksPerSec ) == 0)
+        _llQPFTicksPerSec = queryFrequency();
+        if (_llQPFTicksPerSec == 0)
         {
             LOG ("Failed to get performance frequency.");
         }
 
+        _startTime = queryCounter();
+        _qwTime = _startTime;
 
-        _llQPFTicksPerSec = qwTicksPerSec.QuadPart;
-
-        QueryPerformanceCounter(&_startTime);
+#if _WIN32 || _WIN64
         _startTick = GetTickCount();
         
         // Reset affinity
         SetThreadAffinityMask(thread, oldMask);
+#endif
         _zeroClock = clock();
                
         return true;
@@ -186,16 +246,20 @@ Timer::lockFrameCounter()
 double
 Timer::elapsedSeconds()
 {
-    LARGE_INTEGER time = _qwTime;
+#if _WIN32 || _WIN64
     HANDLE thread = GetCurrentThread();
     DWORD_PTR oldMask = SetThreadAffinityMask(thread, _timerMask);
-    QueryPerformanceCounter(&time);
+    int64_t time = queryCounter();
     SetThreadAffinityMask(thread, oldMask);
+#else
+    int64_t time = queryCounter();
+#endif
 
     // scale by 1000 for milliseconds
-    LONGLONG newTime = time.QuadPart - _startTime.QuadPart;
+    int64_t newTime = time - _startTime;
     unsigned long newTicks = (unsigned long) (1000 * newTime / _llQPFTicksPerSec);
 
+#if _WIN32 || _WIN64
     // detect and compensate for performance counter leaps
     // (surprisingly common, see Microsoft KB: Q274323)
     uint64_t check = GetTickCount() - _startTick;
@@ -203,13 +267,14 @@ Timer::elapsedSeconds()
     if (msecOff < -100 || msecOff > 100)
     {
         // We must keep the timer running forward :)
-        LONGLONG adjust = (std::min)((LONGLONG)(msecOff * _llQPFTicksPerSec / 1000), (LONGLONG)(time.QuadPart - _qwTime.QuadPart));
-        _startTime.QuadPart += adjust;
+        int64_t adjust = (std::min)((int64_t)(msecOff * _llQPFTicksPerSec / 1000), (int64_t)(time - _qwTime));
+        _startTime += adjust;
         newTime -= adjust;
 
         // Re-calculate milliseconds
         newTicks = (unsigned long) (1000 * newTime / _llQPFTicksPerSec);
     }
+#endif
 
     _qwTime = time;
     return (double)(newTicks) / 1000.0;
@@ -218,6 +283,8 @@ Timer::elapsedSeconds()
 bool     
 Timer::update (bool stop)
 {
+    CTR_PROFILE_FRAME();
+
     if (!_timerStarted)
     {
        startTimer();
@@ -228,15 +295,15 @@ Timer::update (bool stop)
         lockFrameCounter();
     }
     
-    _llLastElapsedTime = _qwTime.QuadPart;
+    _llLastElapsedTime = _qwTime;
     
     double seconds = elapsedSeconds();
     _elapsedTime = seconds - _lastSeconds;
     _lastSeconds = seconds;
     
-    _appTime  = (double)( _qwTime.QuadPart - _startTime.QuadPart ) / 
+    _appTime  = (double)( _qwTime - _startTime ) / 
             (double) _llQPFTicksPerSec;
-    _absTime  = _qwTime.QuadPart / (double) _llQPFTicksPerSec;
+    _absTime  = _qwTime / (double) _llQPFTicksPerSec;
     _normalizedTime  = -(floor (_appTime) - _appTime);
 
     _frameRateCounter++;
@@ -257,8 +324,8 @@ Timer::reset()
 {
     update();
 
-    _llBaseTime        = _qwTime.QuadPart;
-    _llLastElapsedTime = _qwTime.QuadPart;
+    _llBaseTime        = _qwTime;
+    _llLastElapsedTime = _qwTime;
 
     _appTime = 0;
     _absTime = 0;
@@ -271,15 +338,15 @@ Timer::startTimer()
     _timerStarted = true;
     update();
 
-    _llBaseTime = _llBaseTime + _qwTime.QuadPart - _llStopTime;
+    _llBaseTime = _llBaseTime + _qwTime - _llStopTime;
     _llStopTime = 0;
-    _llLastElapsedTime = _qwTime.QuadPart;
+    _llLastElapsedTime = _qwTime;
 }
 
 void
 Timer::stopTimer()
 {
-    _llLastElapsedTime = _qwTime.QuadPart;
+    _llLastElapsedTime = _qwTime;
 }
 
 uint32_t
@@ -65,6 +65,12 @@ class Timer
     static size_t              frame (double time, double rate = 24.0);
     static double              time (size_t frame, double rate = 24.0);
 
+    //------------------------------------------------------
+    // Raw high resolution counter, for fine grained timing.
+    //------------------------------------------------------
+    static uint64_t            ticks();
+    static uint64_t            ticksPerSecond();
+
     //------------------
     // Updates the timer
     //------------------
@@ -92,10 +98,10 @@ class Timer
 
     bool                       _timerInitialized;
 
-    LONGLONG                   _llQPFTicksPerSec;
-    LONGLONG                   _llStopTime; 
-    LONGLONG                   _llLastElapsedTime;
-    LONGLONG                   _llBaseTime;
+    int64_t                    _llQPFTicksPerSec;
+    int64_t                    _llStopTime; 
+    int64_t                    _llLastElapsedTime;
+    int64_t                    _llBaseTime;
 
     double                     _lastElapsedTime;
     double                     _elapsedTime;
@@ -104,11 +110,11 @@ class Timer
     double                     _normalizedTime;
 
     double                     _time;
-    LARGE_INTEGER              _qwTime;
-    LARGE_INTEGER              _startTime;
+    int64_t                    _qwTime;
+    int64_t                    _startTime;
     bool                       _timerStarted;
 
-    HANDLE                     _timeEvent;
+    OSHandle                   _timeEvent;
     double                     _lastSeconds;
 
     uint32_t                   _lockFrameCounter;
@@ -81,7 +81,7 @@ Title::create(const std::string& texturePathName,
 
     if (_texturePath.size() > 0 && _image == nullptr)
     {
-        _image = dynamic_cast <const Ctr::ITexture*>
+        _image = dynamic_cast <Ctr::ITexture*>
             (_device->textureMgr()->loadTexture(_texturePath));
     }
 
@@ -87,10 +87,14 @@ Window::~Window()
 Ctr::Vector2i
 Window::mousePosition() const
 {
+#if _WIN32 || _WIN64
     POINT cursorPosition;
     GetCursorPos( &cursorPosition );
     ScreenToClient(windowHandle(), &cursorPosition );
     return Ctr::Vector2i (cursorPosition.x, cursorPosition.y);
+#else
+    return Ctr::Vector2i (0, 0);
+#endif
 }
 
 
@@ -164,7 +168,9 @@ Window::created() const
 bool
 Window::destroy()
 {
+#if _WIN32 || _WIN64
     DestroyWindow (_window);
+#endif
     _window = 0;
     return true;
 }
@@ -191,8 +197,13 @@ Window::clientRect() const
 void 
 Window::updateBounds()
 {
+#if _WIN32 || _WIN64
     RECT crect;
     GetClientRect(_window, &crect);
+#else
+    // No native window, the client area is the requested size.
+    struct { int left, top, right, bottom; } crect = { 0, 0, _width, _height };
+#endif
 
     if (crect.left < 0 && crect.right < 0 &&
         crect.top < 0 && crect.bottom < 0)
@@ -241,7 +252,9 @@ Window::setShowCursor(bool show)
     if (_showCursor != show)
     {
         _showCursor = show;
+#if _WIN32 || _WIN64
         ShowCursor (_showCursor);
+#endif
     }
 }
 
@@ -293,6 +306,7 @@ Window::callback(HWND window,
                  WPARAM wParam, 
                  LPARAM lParam)
 {
+#if _WIN32 || _WIN64
     switch (msg)
     {
         case WM_EXITSIZEMOVE:
@@ -319,19 +333,29 @@ Window::callback(HWND window,
             break;
         }
     };
+#endif
 
     Ctr::WindowData windowData(window, msg, wParam, lParam);
     sendWindowChanged (&windowData);
 
+#if _WIN32 || _WIN64
     return DefWindowProc (window, msg, wParam, lParam);
+#else
+    return 0;
+#endif
 }
 
 bool
 Window::hasFocus() const
 {
+#if _WIN32 || _WIN64
     return GetFocus() == _window;
+#else
+    return false;
+#endif
 }
 
+#if _WIN32 || _WIN64
 LRESULT
 Window::windowProc (HWND window, 
                     UINT msg, 
@@ -369,4 +393,5 @@ Window::windowProc (HWND window,
 
     return DefWindowProc (window, msg, wParam, lParam);
 }
+#endif
 }
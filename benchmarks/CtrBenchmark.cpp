@@ -0,0 +1,373 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrBenchmark.h>
+#include <chrono>
+#include <iomanip>
+
+//------------------------------------------------------
+// critter_bench: codec, resampling, conversion and
+// property graph throughput. Touches no render device.
+//
+//  critter_bench [--filter text] [--sizes 256,1024]
+//                [--json out.json] [--baseline in.json]
+//                [--tolerance 0.05] [--quick]
+//------------------------------------------------------
+namespace Ctr
+{
+namespace
+{
+typedef std::chrono::high_resolution_clock Clock;
+
+double
+percentile(const std::vector<double>& sorted, double fraction)
+{
+    // Nearest rank.
+    size_t rank = (size_t)ceil(fraction * (double)sorted.size());
+    rank = rank > 0 ? rank - 1 : 0;
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+std::string
+jsonEscape(const std::string& text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+// Reads the string value following "key": on a line of our own output.
+bool
+jsonString(const std::string& line, const std::string& key, std::string& value)
+{
+    std::string token = "\"" + key + "\": \"";
+    size_t start = line.find(token);
+    if (start == std::string::npos)
+        return false;
+    start += token.size();
+    size_t end = line.find('"', start);
+    if (end == std::string::npos)
+        return false;
+    value = line.substr(start, end - start);
+    return true;
+}
+
+bool
+jsonNumber(const std::string& line, const std::string& key, double& value)
+{
+    std::string token = "\"" + key + "\": ";
+    size_t start = line.find(token);
+    if (start == std::string::npos)
+        return false;
+    value = atof(line.c_str() + start + token.size());
+    return true;
+}
+}
+
+double
+BenchmarkResult::itemsPerSecond() const
+{
+    return medianMs > 0.0 ? (double)items / (medianMs * 1e-3) : 0.0;
+}
+
+double
+BenchmarkResult::bytesPerSecond() const
+{
+    return medianMs > 0.0 ? (double)bytes / (medianMs * 1e-3) : 0.0;
+}
+
+BenchmarkSuite::BenchmarkSuite() :
+    _minimumSeconds(0.25),
+    _minRuns(10),
+    _maxRuns(500)
+{
+}
+
+void
+BenchmarkSuite::setFilter(const std::string& filter)
+{
+    _filter = filter;
+}
+
+void
+BenchmarkSuite::setMinimumTime(double seconds)
+{
+    _minimumSeconds = seconds;
+}
+
+void
+BenchmarkSuite::setRunLimits(uint32_t minRuns, uint32_t maxRuns)
+{
+    _minRuns = std::max(minRuns, 1u);
+    _maxRuns = std::max(maxRuns, _minRuns);
+}
+
+bool
+BenchmarkSuite::enabled(const std::string& name) const
+{
+    return _filter.empty() || name.find(_filter) != std::string::npos;
+}
+
+void
+BenchmarkSuite::run(const std::string& name,
+                    const std::string& unit,
+                    size_t items,
+                    size_t bytes,
+                    const std::function<void()>& function)
+{
+    if (!enabled(name))
+        return;
+
+    // Warm caches and any lazily built tables.
+    function();
+
+    std::vector<double> samples;
+    samples.reserve(_maxRuns);
+    double totalSeconds = 0.0;
+    while (samples.size() < _maxRuns &&
+           (samples.size() < _minRuns || totalSeconds < _minimumSeconds))
+    {
+        Clock::time_point start = Clock::now();
+        function();
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        samples.push_back(ns * 1e-6);
+        totalSeconds += ns * 1e-9;
+    }
+    std::sort(samples.begin(), samples.end());
+
+    BenchmarkResult result;
+    result.name = name;
+    result.unit = unit;
+    result.items = items;
+    result.bytes = bytes;
+    result.runs = (uint32_t)samples.size();
+    result.minMs = samples.front();
+    result.medianMs = percentile(samples, 0.5);
+    result.p99Ms = percentile(samples, 0.99);
+    _results.push_back(result);
+
+    std::cout << std::left << std::setw(56) << name << std::right << std::fixed
+              << std::setprecision(3)
+              << " min " << std::setw(9) << result.minMs << " ms"
+              << " med " << std::setw(9) << result.medianMs << " ms"
+              << " p99 " << std::setw(9) << result.p99Ms << " ms"
+              << std::setprecision(1)
+              << std::setw(10) << result.itemsPerSecond() * 1e-6 << " M" << unit << "/s";
+    if (bytes > 0)
+    {
+        std::cout << std::setprecision(2) << std::setw(8) << result.bytesPerSecond() * 1e-9 << " GB/s";
+    }
+    std::cout << std::endl;
+}
+
+const std::vector<BenchmarkResult>&
+BenchmarkSuite::results() const
+{
+    return _results;
+}
+
+bool
+BenchmarkSuite::writeJson(const std::string& path) const
+{
+    std::ofstream file(path.c_str());
+    if (!file)
+    {
+        std::cerr << "Failed to open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    // One result per line so baselines diff cleanly.
+    file << "{" << std::endl;
+    file << "  \"suite\": \"critter_bench\"," << std::endl;
+    file << "  \"results\": [" << std::endl;
+    file << std::setprecision(6);
+    for (size_t i = 0; i < _results.size(); i++)
+    {
+        const BenchmarkResult& result = _results[i];
+        file << "    {\"name\": \"" << jsonEscape(result.name) << "\""
+             << ", \"unit\": \"" << result.unit << "\""
+             << ", \"items\": " << result.items
+             << ", \"bytes\": " << result.bytes
+             << ", \"runs\": " << result.runs
+             << ", \"min_ms\": " << result.minMs
+             << ", \"median_ms\": " << result.medianMs
+             << ", \"p99_ms\": " << result.p99Ms
+             << ", \"mitems_per_s\": " << result.itemsPerSecond() * 1e-6
+             << ", \"gb_per_s\": " << result.bytesPerSecond() * 1e-9
+             << "}" << (i + 1 < _results.size() ? "," : "") << std::endl;
+    }
+    file << "  ]" << std::endl;
+    file << "}" << std::endl;
+    return true;
+}
+
+bool
+BenchmarkSuite::compareBaseline(const std::string& path, double tolerance, uint32_t& regressions) const
+{
+    regressions = 0;
+    std::ifstream file(path.c_str());
+    if (!file)
+    {
+        std::cerr << "Failed to open baseline " << path << std::endl;
+        return false;
+    }
+
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::string name;
+        double medianMs = 0.0;
+        if (jsonString(line, "name", name) && jsonNumber(line, "median_ms", medianMs))
+        {
+            baseline[name] = medianMs;
+        }
+    }
+
+    if (baseline.empty())
+    {
+        std::cerr << "No benchmark results in baseline " << path << std::endl;
+        return false;
+    }
+
+    std::cout << std::endl << "Against " << path << ":" << std::endl;
+    for (const BenchmarkResult& result : _results)
+    {
+        auto it = baseline.find(result.name);
+        if (it == baseline.end() || it->second <= 0.0)
+        {
+            std::cout << std::left << std::setw(56) << result.name << " (new)" << std::endl;
+            continue;
+        }
+
+        double delta = (result.medianMs - it->second) / it->second;
+        bool regressed = delta > tolerance;
+        regressions += regressed ? 1 : 0;
+        std::cout << std::left << std::setw(56) << result.name << std::right << std::fixed
+                  << std::setprecision(3)
+                  << " " << std::setw(9) << it->second << " -> " << std::setw(9) << result.medianMs << " ms"
+                  << std::setprecision(1) << std::showpos
+                  << std::setw(8) << delta * 100.0 << "%" << std::noshowpos
+                  << (regressed ? "  REGRESSION" : "") << std::endl;
+    }
+    return true;
+}
+}
+
+int
+main(int argc, char** argv)
+{
+    Ctr::BenchmarkSuite suite;
+    std::vector<size_t> sizes = { 256, 1024, 2048 };
+    std::string jsonPath;
+    std::string baselinePath;
+    double tolerance = 0.05;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue)
+        {
+            suite.setFilter(argv[++i]);
+        }
+        else if (arg == "--sizes" && hasValue)
+        {
+            sizes.clear();
+            std::stringstream list(argv[++i]);
+            std::string size;
+            while (std::getline(list, size, ','))
+            {
+                if (atoi(size.c_str()) > 0)
+                    sizes.push_back((size_t)atoi(size.c_str()));
+            }
+        }
+        else if (arg == "--json" && hasValue)
+        {
+            jsonPath = argv[++i];
+        }
+        else if (arg == "--baseline" && hasValue)
+        {
+            baselinePath = argv[++i];
+        }
+        else if (arg == "--tolerance" && hasValue)
+        {
+            tolerance = atof(argv[++i]);
+        }
+        else if (arg == "--quick")
+        {
+            suite.setMinimumTime(0.02);
+            suite.setRunLimits(3, 50);
+        }
+        else
+        {
+            std::cout << "usage: critter_bench [--filter text] [--sizes 256,1024] [--json out.json]" << std::endl
+                      << "                     [--baseline in.json] [--tolerance 0.05] [--quick]" << std::endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    Ctr::runImageBenchmarks(suite, sizes);
+    Ctr::runPropertyBenchmarks(suite);
+
+    if (!jsonPath.empty() && !suite.writeJson(jsonPath))
+        return 1;
+
+    if (!baselinePath.empty())
+    {
+        uint32_t regressions = 0;
+        if (!suite.compareBaseline(baselinePath, tolerance, regressions))
+            return 1;
+
+        if (regressions > 0)
+        {
+            std::cout << regressions << " case(s) slower than baseline by more than "
+                      << tolerance * 100.0 << "%" << std::endl;
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRITTER_BENCHMARK
+#define INCLUDED_CRITTER_BENCHMARK
+
+#include <CtrPlatform.h>
+#include <functional>
+
+namespace Ctr
+{
+//------------------------------------------------------
+// Timing statistics for one benchmark case.
+// items are pixels for the image cases and lookups
+// for the property graph; bytes counts everything
+// read and written by one run.
+//------------------------------------------------------
+struct BenchmarkResult
+{
+    std::string                name;
+    std::string                unit;
+    size_t                     items;
+    size_t                     bytes;
+    uint32_t                   runs;
+    double                     minMs;
+    double                     medianMs;
+    double                     p99Ms;
+
+    double                     itemsPerSecond() const;
+    double                     bytesPerSecond() const;
+};
+
+//------------------------------------------------------
+// Runs each case until both a minimum run count and a
+// minimum wall time have been reached, then records
+// min / median / p99 of the per-run samples.
+//------------------------------------------------------
+class BenchmarkSuite
+{
+  public:
+    BenchmarkSuite();
+
+    void                       setFilter(const std::string& filter);
+    void                       setMinimumTime(double seconds);
+    void                       setRunLimits(uint32_t minRuns, uint32_t maxRuns);
+
+    bool                       enabled(const std::string& name) const;
+
+    void                       run(const std::string& name,
+                                   const std::string& unit,
+                                   size_t items,
+                                   size_t bytes,
+                                   const std::function<void()>& function);
+
+    const std::vector<BenchmarkResult>& results() const;
+
+    bool                       writeJson(const std::string& path) const;
+
+    // Prints the median delta of every case found in the baseline and
+    // counts the cases slower than it by more than tolerance (0.05 == 5%).
+    // Returns false if the baseline can't be read or holds no cases.
+    bool                       compareBaseline(const std::string& path, double tolerance,
+                                               uint32_t& regressions) const;
+
+  private:
+    std::string                _filter;
+    double                     _minimumSeconds;
+    uint32_t                   _minRuns;
+    uint32_t                   _maxRuns;
+    std::vector<BenchmarkResult> _results;
+};
+
+// Each runs its cases through the suite; sizes are square image edge lengths.
+void runImageBenchmarks(BenchmarkSuite& suite, const std::vector<size_t>& sizes);
+void runPropertyBenchmarks(BenchmarkSuite& suite);
+}
+
+#endif
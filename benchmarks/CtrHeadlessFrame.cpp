@@ -0,0 +1,260 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrPlatform.h>
+#include <CtrRenderDeviceHeadless.h>
+#include <CtrCommandLogHeadless.h>
+#include <CtrScene.h>
+#include <CtrEntity.h>
+#include <CtrMesh.h>
+#include <CtrCamera.h>
+#include <CtrColorPass.h>
+#include <CtrShaderMgr.h>
+#include <CtrTimer.h>
+#include <CtrLog.h>
+
+//------------------------------------------------------
+// Renders frames of a scene on the headless device and
+// prints the command log, so the CPU side of a frame can
+// be run and measured without D3D11. Without --obj a grid
+// of cubes is written to a temporary obj and loaded. With
+// --instanced the cubes share geometry and are placed by
+// their transforms, so shaders that declare instancing
+// draw them in batches. --lists sets how many command
+// lists the render queue is recorded into, 1 draws it
+// on the calling thread.
+//------------------------------------------------------
+namespace
+{
+Ctr::Vector3f
+gridPosition(uint32_t cubeId, uint32_t gridSize)
+{
+    return Ctr::Vector3f((float(cubeId % gridSize) - float(gridSize) * 0.5f) * 4.0f,
+                         0.0f, float(cubeId / gridSize) * 4.0f);
+}
+
+bool
+writeCubeGrid(const std::string& objPathName, const std::string& mtlPathName, 
+              uint32_t gridSize, bool shared)
+{
+    std::ofstream mtl(mtlPathName.c_str());
+    mtl << "newmtl grey\n";
+    if (!mtl)
+        return false;
+
+    std::ofstream obj(objPathName.c_str());
+    size_t slash = mtlPathName.find_last_of("/\\");
+    obj << "mtllib " << (slash == std::string::npos ? mtlPathName : mtlPathName.substr(slash + 1)) << "\n";
+
+    static const float corners[8][3] =
+    {
+        { -1, -1, -1 }, { 1, -1, -1 }, { 1, 1, -1 }, { -1, 1, -1 },
+        { -1, -1,  1 }, { 1, -1,  1 }, { 1, 1,  1 }, { -1, 1,  1 }
+    };
+    static const uint32_t faces[6][4] =
+    {
+        { 0, 3, 2, 1 }, { 4, 5, 6, 7 }, { 0, 1, 5, 4 },
+        { 2, 3, 7, 6 }, { 1, 2, 6, 5 }, { 0, 4, 7, 3 }
+    };
+
+    uint32_t vertexBase = 1;
+    for (uint32_t z = 0; z < gridSize; z++)
+    {
+        for (uint32_t x = 0; x < gridSize; x++)
+        {
+            Ctr::Vector3f center = shared ? Ctr::Vector3f(0.0f, 0.0f, 0.0f) : 
+                                            gridPosition(z * gridSize + x, gridSize);
+            obj << "o cube" << z * gridSize + x << "\nusemtl grey\n";
+            for (uint32_t cornerId = 0; cornerId < 8; cornerId++)
+            {
+                obj << "v " << center.x + corners[cornerId][0] << " " 
+                    << corners[cornerId][1] << " " 
+                    << center.z + corners[cornerId][2] << "\n";
+            }
+            for (uint32_t faceId = 0; faceId < 6; faceId++)
+            {
+                obj << "f";
+                for (uint32_t cornerId = 0; cornerId < 4; cornerId++)
+                {
+                    obj << " " << vertexBase + faces[faceId][cornerId];
+                }
+                obj << "\n";
+            }
+            vertexBase += 8;
+        }
+    }
+    return bool(obj);
+}
+}
+
+int
+main(int argc, char** argv)
+{
+    std::string objPathName;
+    uint32_t gridSize = 8;
+    uint32_t frameCount = 1;
+    bool instanced = false;
+    uint32_t listCount = 0;
+    Ctr::Vector2i size(1280, 720);
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--obj" && i + 1 < argc)
+        {
+            objPathName = argv[++i];
+        }
+        else if (arg == "--grid" && i + 1 < argc)
+        {
+            gridSize = std::max(atoi(argv[++i]), 1);
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            frameCount = std::max(atoi(argv[++i]), 1);
+        }
+        else if (arg == "--instanced")
+        {
+            instanced = true;
+        }
+        else if (arg == "--lists" && i + 1 < argc)
+        {
+            listCount = std::max(atoi(argv[++i]), 1);
+        }
+        else
+        {
+            std::cerr << "usage: critter_headless_frame [--obj scene.obj] [--grid 8] [--frames 1] [--instanced] [--lists 4]" << std::endl;
+            return 2;
+        }
+    }
+
+    Ctr::Log::setLogLevel(Ctr::LogWarningsAndCritical);
+
+    bool generated = objPathName.length() == 0;
+    std::string mtlPathName;
+    if (generated)
+    {
+        objPathName = "critter_headless_frame.obj";
+        mtlPathName = "critter_headless_frame.mtl";
+        if (!writeCubeGrid(objPathName, mtlPathName, gridSize, instanced))
+        {
+            std::cerr << "Could not write " << objPathName << std::endl;
+            return 1;
+        }
+    }
+
+    int result = 0;
+    try
+    {
+        Ctr::DeviceHeadless device;
+        device.initialize(Ctr::ApplicationRenderParameters(nullptr, "critter_headless_frame", size, true, true));
+        device.setCommandListCount(listCount);
+
+        // Imported materials use PBRDebug, which the shader manifest provides in
+        // the application. Headless shaders without source still resolve.
+        const Ctr::IShader* shader = nullptr;
+        device.shaderMgr()->addShader("PBRDebug.fx", shader, true);
+
+        Ctr::Scene::setInstanceMeshesOnImport(instanced);
+        Ctr::Scene* scene = new Ctr::Scene(&device);
+        Ctr::Entity* entity = scene->load(objPathName, std::string());
+        if (!entity)
+        {
+            THROW("Could not load " << objPathName);
+        }
+        if (instanced && generated)
+        {
+            for (size_t meshId = 0; meshId < entity->numMeshes(); meshId++)
+            {
+                entity->mesh(meshId)->translationProperty()->set(gridPosition(uint32_t(meshId), gridSize));
+            }
+        }
+        scene->camera()->translationProperty()->set(Ctr::Vector3f(0.0f, 8.0f, -24.0f));
+
+        Ctr::ColorPass* colorPass = new Ctr::ColorPass(&device);
+        Ctr::CommandLogHeadless* commandLog = device.commandLog();
+
+        for (uint32_t frameId = 0; frameId < frameCount; frameId++)
+        {
+            device.update();
+            device.beginRender();
+            scene->camera()->updateViewProjection();
+            scene->camera()->cacheCameraTransforms();
+            scene->update();
+            colorPass->render(scene);
+            device.present();
+        }
+
+        const Ctr::CommandLogHeadless::FrameStats& frame = commandLog->lastFrame();
+        std::cout << "frames " << frameCount 
+                  << " meshes " << colorPass->meshesSubmitted() 
+                  << " culled " << colorPass->meshesCulled() 
+                  << " command lists " << colorPass->renderQueueStats().commandLists << std::endl;
+        const Ctr::MeshInstancer::Stats& instancer = colorPass->instancerStats();
+        std::cout << "instancer batches " << instancer.batches 
+                  << " meshes " << instancer.instancedMeshes
+                  << " uploads " << instancer.uploads 
+                  << " unchanged " << instancer.unchangedUploads << std::endl;
+        commandLog->writeSummary(std::cout);
+
+        if (frame.draws == 0)
+        {
+            std::cerr << "The last frame recorded no draws" << std::endl;
+            result = 1;
+        }
+
+        safedelete(colorPass);
+        safedelete(scene);
+        device.free();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        result = 1;
+    }
+
+    if (generated)
+    {
+        remove(objPathName.c_str());
+        remove(mtlPathName.c_str());
+    }
+    Ctr::Log::shutdown();
+    return result;
+}
@@ -0,0 +1,272 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrBenchmark.h>
+#include <CtrPixelFormat.h>
+#include <CtrTextureImage.h>
+#include <CtrImageResampler.h>
+#include <CtrImageConversion.h>
+#include <CtrDDSCodec.h>
+#include <CtrDataStream.h>
+#include <type_traits>
+
+namespace Ctr
+{
+namespace
+{
+std::string
+caseName(const std::string& group, const std::string& variant, size_t size)
+{
+    std::ostringstream name;
+    name << group << "/" << variant << "/" << size;
+    return name.str();
+}
+
+// Deterministic noise so runs are comparable between builds.
+void
+fillNoise(std::vector<uint8_t>& buffer, PixelFormat format)
+{
+    uint32_t state = 0x12345678;
+    if (format == PF_FLOAT32_RGBA || format == PF_FLOAT32_RGB)
+    {
+        float* values = (float*)&buffer[0];
+        for (size_t i = 0; i < buffer.size() / sizeof(float); i++)
+        {
+            state = state * 1664525u + 1013904223u;
+            values[i] = (float)(state >> 8) / (float)(1 << 24);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < buffer.size(); i++)
+        {
+            state = state * 1664525u + 1013904223u;
+            buffer[i] = (uint8_t)(state >> 24);
+        }
+    }
+}
+
+struct Image
+{
+    Image(size_t width, size_t height, PixelFormat format) :
+        data(PixelUtil::getMemorySize(width, height, 1, format)),
+        box(width, height, 1, format)
+    {
+        fillNoise(data, format);
+        box.data = &data[0];
+    }
+
+    size_t bytes() const { return data.size(); }
+
+    std::vector<uint8_t>   data;
+    PixelBox               box;
+};
+
+void
+runBulkConversion(BenchmarkSuite& suite, size_t size, PixelFormat srcFormat, PixelFormat dstFormat)
+{
+    std::string name = caseName("bulkPixelConversion",
+                                PixelUtil::getFormatName(srcFormat) + "->" + PixelUtil::getFormatName(dstFormat),
+                                size);
+    if (!suite.enabled(name))
+        return;
+
+    Image src(size, size, srcFormat);
+    Image dst(size, size, dstFormat);
+    suite.run(name, "pix", size * size, src.bytes() + dst.bytes(),
+              [&]() { PixelUtil::bulkPixelConversion(src.box, dst.box); });
+}
+
+template <typename Resampler>
+void
+runResampler(BenchmarkSuite& suite, const std::string& resampler, size_t size, PixelFormat format)
+{
+    std::string name = caseName(resampler, PixelUtil::getFormatName(format) + " half", size);
+    if (!suite.enabled(name))
+        return;
+
+    size_t half = std::max(size / 2, (size_t)1);
+    Image src(size, size, format);
+    Image dst(half, half, format);
+    suite.run(name, "pix", half * half, src.bytes() + dst.bytes(),
+              [&]() { Resampler::scale(src.box, dst.box); });
+}
+
+template <typename T, typename S>
+void
+runConvertImage(BenchmarkSuite& suite, const std::string& variant, size_t size,
+                float dstGamma, float srcGamma)
+{
+    std::string name = caseName("ConvertImage", variant, size);
+    if (!suite.enabled(name))
+        return;
+
+    const size_t channels = 4;
+    std::vector<S> src(size * size * channels);
+    std::vector<T> dst(size * size * channels);
+    std::vector<uint8_t> noise(src.size());
+    fillNoise(noise, PF_A8R8G8B8);
+    // Float sources get normalized values.
+    float scale = std::is_floating_point<S>::value ? 1.0f / 255.0f : 1.0f;
+    for (size_t i = 0; i < src.size(); i++)
+    {
+        src[i] = (S)(noise[i] * scale);
+    }
+
+    uint32_t channelMapping[] = { 2, 1, 0, 3 };
+    suite.run(name, "pix", size * size, src.size() * sizeof(S) + dst.size() * sizeof(T),
+              [&]() 
+    {
+        ConvertImage converter;
+        for (size_t rowId = 0; rowId < size; rowId++)
+        {
+            converter.convert<T, S>(rowId, &dst[0], &src[0], size, size, channels, channels,
+                                    channelMapping, dstGamma, srcGamma);
+        }
+    });
+}
+
+// Builds a single mip, single face DDS file in memory.
+std::vector<uint8_t>
+buildDDS(size_t size, PixelFormat format)
+{
+    const uint32_t ddsMagic = 'D' | ('D' << 8) | ('S' << 16) | (' ' << 24);
+    uint32_t header[31] = {};
+    header[0] = 124;                       // size
+    header[1] = 0x1 | 0x2 | 0x4 | 0x1000;  // caps, height, width, pixelformat
+    header[2] = (uint32_t)size;
+    header[3] = (uint32_t)size;
+    header[6] = 1;                         // mipMapCount
+    header[18] = 32;                       // pixelFormat.size
+    header[26] = 0x1000;                   // DDSCAPS_TEXTURE
+
+    switch (format)
+    {
+        case PF_DXT1:
+            header[19] = 0x4;
+            header[20] = 'D' | ('X' << 8) | ('T' << 16) | ('1' << 24);
+            break;
+        case PF_DXT5:
+            header[19] = 0x4;
+            header[20] = 'D' | ('X' << 8) | ('T' << 16) | ('5' << 24);
+            break;
+        case PF_FLOAT32_RGBA:
+            header[19] = 0x4;
+            header[20] = 116;              // D3DFMT_A32B32G32R32F
+            break;
+        default:
+            // A8R8G8B8
+            header[19] = 0x40 | 0x1;       // DDPF_RGB | DDPF_ALPHAPIXELS
+            header[21] = 32;
+            header[22] = 0x00ff0000;
+            header[23] = 0x0000ff00;
+            header[24] = 0x000000ff;
+            header[25] = 0xff000000;
+            break;
+    }
+
+    size_t payload = PixelUtil::getMemorySize(size, size, 1, format);
+    std::vector<uint8_t> file(sizeof(ddsMagic) + sizeof(header) + payload);
+    memcpy(&file[0], &ddsMagic, sizeof(ddsMagic));
+    memcpy(&file[sizeof(ddsMagic)], header, sizeof(header));
+
+    std::vector<uint8_t> pixels(payload);
+    fillNoise(pixels, format);
+    memcpy(&file[sizeof(ddsMagic) + sizeof(header)], &pixels[0], payload);
+    return file;
+}
+
+void
+runDDSDecode(BenchmarkSuite& suite, size_t size, PixelFormat format, bool forceDecompression)
+{
+    std::string variant = PixelUtil::getFormatName(format) + (forceDecompression ? " decompress" : "");
+    std::string name = caseName("DDSCodec::decode", variant, size);
+    if (!suite.enabled(name))
+        return;
+
+    std::vector<uint8_t> file = buildDDS(size, format);
+    DDSCodec codec;
+    size_t decodedBytes = 0;
+    {
+        DDSCodec::_forceDecompression = forceDecompression;
+        DataStreamPtr stream(new MemoryDataStream(&file[0], file.size(), false, true));
+        Codec::DecodeResult result = codec.decode(stream);
+        decodedBytes = result.first->size();
+    }
+
+    suite.run(name, "pix", size * size, file.size() + decodedBytes, [&]() 
+    {
+        DataStreamPtr stream(new MemoryDataStream(&file[0], file.size(), false, true));
+        Codec::DecodeResult result = codec.decode(stream);
+    });
+    DDSCodec::_forceDecompression = false;
+}
+}
+
+void
+runImageBenchmarks(BenchmarkSuite& suite, const std::vector<size_t>& sizes)
+{
+    for (size_t size : sizes)
+    {
+        runBulkConversion(suite, size, PF_A8R8G8B8, PF_A8B8G8R8);
+        runBulkConversion(suite, size, PF_R8G8B8, PF_A8R8G8B8);
+        runBulkConversion(suite, size, PF_A8R8G8B8, PF_FLOAT32_RGBA);
+        runBulkConversion(suite, size, PF_FLOAT32_RGBA, PF_A8R8G8B8);
+        runBulkConversion(suite, size, PF_FLOAT32_RGBA, PF_FLOAT16_RGBA);
+
+        runResampler<LinearResampler>(suite, "LinearResampler", size, PF_A8R8G8B8);
+        runResampler<LinearResampler>(suite, "LinearResampler", size, PF_FLOAT32_RGBA);
+        runResampler<LinearResampler_Float32>(suite, "LinearResampler_Float32", size, PF_FLOAT32_RGBA);
+        runResampler<LinearResampler_Byte<4> >(suite, "LinearResampler_Byte<4>", size, PF_A8R8G8B8);
+
+        runConvertImage<float, uint8_t>(suite, "uint8->float", size, 1.0f, 1.0f);
+        runConvertImage<float, uint8_t>(suite, "uint8->float gamma", size, 1.0f, 2.2f);
+        runConvertImage<uint8_t, float>(suite, "float->uint8 gamma", size, 2.2f, 1.0f);
+        runConvertImage<float, float>(suite, "float->float gamma", size, 2.2f, 1.0f);
+
+        runDDSDecode(suite, size, PF_DXT1, false);
+        runDDSDecode(suite, size, PF_DXT1, true);
+        runDDSDecode(suite, size, PF_DXT5, true);
+        runDDSDecode(suite, size, PF_A8R8G8B8, false);
+        runDDSDecode(suite, size, PF_FLOAT32_RGBA, false);
+    }
+}
+}
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrPlatform.h>
+#include <CtrMatrix44.h>
+#include <CtrMatrixAlgo.h>
+#include <chrono>
+
+//------------------------------------------------------
+// Compares the scalar reference and SSE paths of
+// Matrix44f and the batch transforms in CtrMatrixAlgo.h.
+//------------------------------------------------------
+namespace
+{
+typedef std::chrono::high_resolution_clock Clock;
+
+template <typename Function>
+double
+bestNanosecondsPerOp(size_t opsPerRun, Function function)
+{
+    double best = DBL_MAX;
+    for (uint32_t run = 0; run < 16; run++)
+    {
+        Clock::time_point start = Clock::now();
+        function();
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        best = Ctr::minValue(best, ns / (double)opsPerRun);
+    }
+    return best;
+}
+
+void
+report(const char* name, double scalarNs, double simdNs)
+{
+    std::cout << name 
+              << " scalar " << scalarNs << " ns"
+              << " sse " << simdNs << " ns"
+              << " speedup " << scalarNs / simdNs << "x" << std::endl;
+}
+
+Ctr::Matrix44f
+randomMatrix()
+{
+    Ctr::Matrix44f m;
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        m._mat[i] = Ctr::random() * 2.0f - 1.0f;
+    }
+    return m;
+}
+}
+
+int
+main(int argc, char** argv)
+{
+    const size_t count = 1 << 16;
+
+    std::vector<Ctr::Matrix44f> lhs(count), rhs(count), result(count);
+    std::vector<Ctr::Vector3f> points(count), transformed(count);
+    std::vector<Ctr::Vector4f> vectors(count), vectorResults(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        lhs[i] = randomMatrix();
+        rhs[i] = randomMatrix();
+        points[i] = Ctr::Vector3f(Ctr::random(), Ctr::random(), Ctr::random());
+        vectors[i] = Ctr::Vector4f(Ctr::random(), Ctr::random(), Ctr::random(), 1.0f);
+    }
+    Ctr::Matrix44f m = randomMatrix();
+
+    report("Matrix44f multiply     ",
+           bestNanosecondsPerOp(count, [&]() { Ctr::multiplyManyScalar(&lhs[0], &rhs[0], &result[0], count); }),
+           bestNanosecondsPerOp(count, [&]() { Ctr::multiplyMany(&lhs[0], &rhs[0], &result[0], count); }));
+
+    report("Matrix44f transpose    ",
+           bestNanosecondsPerOp(count, [&]() { for (size_t i = 0; i < count; i++) result[i].transposeScalar(); }),
+           bestNanosecondsPerOp(count, [&]() { for (size_t i = 0; i < count; i++) result[i].transpose(); }));
+
+    report("Matrix44f transform v4 ",
+           bestNanosecondsPerOp(count, [&]() { for (size_t i = 0; i < count; i++) vectorResults[i] = m.transformScalar(vectors[i]); }),
+           bestNanosecondsPerOp(count, [&]() { for (size_t i = 0; i < count; i++) vectorResults[i] = m.transform(vectors[i]); }));
+
+    report("transformPoints        ",
+           bestNanosecondsPerOp(count, [&]() { Ctr::transformPointsScalar(m, &points[0], &transformed[0], count); }),
+           bestNanosecondsPerOp(count, [&]() { Ctr::transformPoints(m, &points[0], &transformed[0], count); }));
+
+    // Check the two paths agree.
+    std::vector<Ctr::Vector3f> reference(count);
+    Ctr::transformPointsScalar(m, &points[0], &reference[0], count);
+    float maxError = 0.0f;
+    for (size_t i = 0; i < count; i++)
+    {
+        maxError = Ctr::maxValue(maxError, reference[i].distance(transformed[i]));
+    }
+    std::cout << "transformPoints max error " << maxError << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrBenchmark.h>
+#include <CtrNode.h>
+#include <CtrTypedProperty.h>
+
+namespace Ctr
+{
+namespace
+{
+void
+runPropertyLookup(BenchmarkSuite& suite, size_t propertyCount)
+{
+    std::ostringstream name;
+    name << "Node::property/" << propertyCount << " properties";
+    if (!suite.enabled(name.str()))
+        return;
+
+    // The node owns and deletes its properties.
+    Node node("bench");
+    std::vector<std::string> names;
+    for (size_t i = 0; i < propertyCount; i++)
+    {
+        std::ostringstream propertyName;
+        propertyName << "property" << i;
+        names.push_back(propertyName.str());
+        new FloatProperty(&node, names.back());
+    }
+    // Misses walk the full list.
+    names.push_back("missing");
+
+    const size_t lookups = 1 << 16;
+    size_t found = 0;
+    suite.run(name.str(), "op", lookups, 0, [&]()
+    {
+        for (size_t i = 0; i < lookups; i++)
+        {
+            found += node.property(names[i % names.size()]) != nullptr ? 1 : 0;
+        }
+    });
+
+    if (found == 0)
+    {
+        std::cout << "Node::property found nothing" << std::endl;
+    }
+}
+}
+
+void
+runPropertyBenchmarks(BenchmarkSuite& suite)
+{
+    runPropertyLookup(suite, 8);
+    runPropertyLookup(suite, 64);
+    runPropertyLookup(suite, 256);
+}
+}
@@ -102,7 +102,7 @@ namespace Ctr
             std::ostringstream message;
             message << "Can not find codec for '" << extension << "' image format.\n" << formats_str;
             LOG (message.str());
-            throw(std::exception(message.str().c_str()));
+            throw(std::runtime_error(message.str().c_str()));
         }
 
         return i->second;
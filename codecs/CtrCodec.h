@@ -126,7 +126,7 @@ namespace Ctr
             {
                 std::ostringstream message;
                 message << pCodec->getType() << " already has a registered codec. " << __FUNCTION__;
-				throw(std::exception(message.str().c_str()));
+				throw(std::runtime_error(message.str().c_str()));
             }
 
             msMapCodecs[pCodec->getType()] = pCodec;
@@ -0,0 +1,312 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CUBEMAP_PROJECTION
+#define INCLUDED_CUBEMAP_PROJECTION
+
+#include <CtrPlatform.h>
+#include <CtrMath.h>
+#include <CtrTextureImage.h>
+#include <CtrParallel.h>
+
+namespace Ctr
+{
+    // CPU reprojection between equirectangular (lat-long) images and cube maps.
+    // Both sides work on consecutive PF_FLOAT32_RGBA pixel boxes, so a texel is 
+    // exactly one SSE register. Face order and orientation follow D3D11:
+    // +X, -X, +Y, -Y, +Z, -Z with u to the right and v down.
+    // Lat-long mapping: u = atan2(z, x) / 2pi + 0.5, v = acos(y) / pi.
+    struct CubeMapProjection
+    {
+        // Direction table: dir = forward + u * right + v * down, u,v in [-1, 1].
+        struct FaceBasis
+        {
+            float forward[3];
+            float right[3];
+            float down[3];
+        };
+
+        static const FaceBasis& faceBasis(size_t faceId)
+        {
+            static const FaceBasis basis[6] =
+            {
+                {{ 1, 0, 0}, { 0, 0,-1}, {0,-1, 0}}, // +X
+                {{-1, 0, 0}, { 0, 0, 1}, {0,-1, 0}}, // -X
+                {{ 0, 1, 0}, { 1, 0, 0}, {0, 0, 1}}, // +Y
+                {{ 0,-1, 0}, { 1, 0, 0}, {0, 0,-1}}, // -Y
+                {{ 0, 0, 1}, { 1, 0, 0}, {0,-1, 0}}, // +Z
+                {{ 0, 0,-1}, {-1, 0, 0}, {0,-1, 0}}  // -Z
+            };
+            return basis[faceId];
+        }
+
+        // Number of sub samples per axis for the filtered modes.
+        // ratio is the number of source texels covered by one destination texel.
+        static uint32_t subSamples(TextureImage::Filter filter, float ratio)
+        {
+            switch (filter)
+            {
+                case TextureImage::FILTER_BOX:
+                case TextureImage::FILTER_TRIANGLE:
+                case TextureImage::FILTER_BICUBIC:
+                    return (uint32_t)Ctr::clamped((int32_t)ceilf(ratio), 1, 8);
+                default:
+                    return 1;
+            }
+        }
+
+        static inline void blend(float* dst, 
+                                 const float* t00, const float* t10, 
+                                 const float* t01, const float* t11,
+                                 float fx, float fy, float weight)
+        {
+#if CTR_SSE
+            __m128 a = _mm_loadu_ps(t00);
+            __m128 b = _mm_loadu_ps(t10);
+            __m128 c = _mm_loadu_ps(t01);
+            __m128 d = _mm_loadu_ps(t11);
+            __m128 vfx = _mm_set1_ps(fx);
+            __m128 top = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), vfx));
+            __m128 bottom = _mm_add_ps(c, _mm_mul_ps(_mm_sub_ps(d, c), vfx));
+            __m128 result = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), _mm_set1_ps(fy)));
+            _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(result, _mm_set1_ps(weight))));
+#else
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                float top = t00[c] + (t10[c] - t00[c]) * fx;
+                float bottom = t01[c] + (t11[c] - t01[c]) * fx;
+                dst[c] += (top + (bottom - top) * fy) * weight;
+            }
+#endif
+        }
+
+        // Accumulates a weighted bilinear (or nearest) lookup into dst. 
+        // u wraps around the horizon, v clamps at the poles.
+        static inline void sampleLatLong(float* dst, const PixelBox& src, 
+                                         float x, float y, float z, 
+                                         bool nearest, float weight)
+        {
+            const float* data = (const float*)src.data;
+            size_t width = src.size().x;
+            size_t height = src.size().y;
+
+            float u = atan2f(z, x) * (0.5f / BB_PI) + 0.5f;
+            float v = atan2f(sqrtf(x*x + z*z), y) * (1.0f / BB_PI);
+
+            float px = u * width - 0.5f;
+            float py = v * height - 0.5f;
+            if (nearest)
+            {
+                px = floorf(px + 0.5f);
+                py = floorf(py + 0.5f);
+            }
+
+            float fx0 = floorf(px);
+            float fy0 = floorf(py);
+            float fx = px - fx0;
+            float fy = py - fy0;
+
+            int32_t x0 = (int32_t)fx0 % (int32_t)width;
+            if (x0 < 0) x0 += (int32_t)width;
+            int32_t x1 = (x0 + 1) % (int32_t)width;
+            int32_t y0 = Ctr::clamped((int32_t)fy0, 0, (int32_t)height - 1);
+            int32_t y1 = Ctr::clamped((int32_t)fy0 + 1, 0, (int32_t)height - 1);
+
+            const float* row0 = data + y0 * src.rowPitch * 4;
+            const float* row1 = data + y1 * src.rowPitch * 4;
+            blend(dst, row0 + x0 * 4, row0 + x1 * 4, row1 + x0 * 4, row1 + x1 * 4, fx, fy, weight);
+        }
+
+        // Accumulates a weighted lookup into one of the 6 faces. Bilinear taps clamp
+        // to the face they land in; fixupCubeEdges removes the remaining seams.
+        static inline void sampleCube(float* dst, const PixelBox* faces, 
+                                      float x, float y, float z, 
+                                      bool nearest, float weight)
+        {
+            float ax = fabsf(x), ay = fabsf(y), az = fabsf(z);
+            size_t faceId;
+            float sc, tc, ma;
+            if (ax >= ay && ax >= az)
+            {
+                faceId = x >= 0 ? 0 : 1;
+                sc = x >= 0 ? -z : z;
+                tc = -y;
+                ma = ax;
+            }
+            else if (ay >= az)
+            {
+                faceId = y >= 0 ? 2 : 3;
+                sc = x;
+                tc = y >= 0 ? z : -z;
+                ma = ay;
+            }
+            else
+            {
+                faceId = z >= 0 ? 4 : 5;
+                sc = z >= 0 ? x : -x;
+                tc = -y;
+                ma = az;
+            }
+
+            const PixelBox& face = faces[faceId];
+            const float* data = (const float*)face.data;
+            int32_t size = (int32_t)face.size().x;
+
+            float px = (sc / ma * 0.5f + 0.5f) * size - 0.5f;
+            float py = (tc / ma * 0.5f + 0.5f) * size - 0.5f;
+            if (nearest)
+            {
+                px = floorf(px + 0.5f);
+                py = floorf(py + 0.5f);
+            }
+
+            float fx0 = floorf(px);
+            float fy0 = floorf(py);
+            float fx = px - fx0;
+            float fy = py - fy0;
+
+            int32_t x0 = Ctr::clamped((int32_t)fx0, 0, size - 1);
+            int32_t x1 = Ctr::clamped((int32_t)fx0 + 1, 0, size - 1);
+            int32_t y0 = Ctr::clamped((int32_t)fy0, 0, size - 1);
+            int32_t y1 = Ctr::clamped((int32_t)fy0 + 1, 0, size - 1);
+
+            const float* row0 = data + y0 * face.rowPitch * 4;
+            const float* row1 = data + y1 * face.rowPitch * 4;
+            blend(dst, row0 + x0 * 4, row0 + x1 * 4, row1 + x0 * 4, row1 + x1 * 4, fx, fy, weight);
+        }
+
+        // faces must be 6 square PF_FLOAT32_RGBA boxes of equal size.
+        static void latLongToCube(const PixelBox& latLong, const PixelBox* faces, TextureImage::Filter filter)
+        {
+            size_t size = faces[0].size().x;
+            bool nearest = filter == TextureImage::FILTER_NEAREST;
+            uint32_t samples = subSamples(filter, (float)latLong.size().x / (4.0f * size));
+            float weight = 1.0f / (float)(samples * samples);
+
+            // Face coordinate table, shared by the rows and columns of every face.
+            std::vector<float> coords(size * samples);
+            for (size_t i = 0; i < size; i++)
+            {
+                for (uint32_t s = 0; s < samples; s++)
+                {
+                    float offset = ((float)s + 0.5f) / (float)samples;
+                    coords[i * samples + s] = 2.0f * ((float)i + offset) / (float)size - 1.0f;
+                }
+            }
+
+            Ctr::parallelFor(size_t(0), size_t(6 * size), [&](size_t faceRowId)
+            {
+                size_t faceId = faceRowId / size;
+                size_t y = faceRowId % size;
+                const FaceBasis& basis = faceBasis(faceId);
+                float* dst = (float*)faces[faceId].data + y * faces[faceId].rowPitch * 4;
+
+                for (size_t x = 0; x < size; x++, dst += 4)
+                {
+                    dst[0] = dst[1] = dst[2] = dst[3] = 0.0f;
+                    for (uint32_t sy = 0; sy < samples; sy++)
+                    {
+                        float v = coords[y * samples + sy];
+                        for (uint32_t sx = 0; sx < samples; sx++)
+                        {
+                            float u = coords[x * samples + sx];
+                            sampleLatLong(dst, latLong,
+                                          basis.forward[0] + u * basis.right[0] + v * basis.down[0],
+                                          basis.forward[1] + u * basis.right[1] + v * basis.down[1],
+                                          basis.forward[2] + u * basis.right[2] + v * basis.down[2],
+                                          nearest, weight);
+                        }
+                    }
+                }
+            });
+        }
+
+        // faces must be 6 square PF_FLOAT32_RGBA boxes of equal size.
+        static void cubeToLatLong(const PixelBox* faces, const PixelBox& latLong, TextureImage::Filter filter)
+        {
+            size_t width = latLong.size().x;
+            size_t height = latLong.size().y;
+            bool nearest = filter == TextureImage::FILTER_NEAREST;
+            uint32_t samples = subSamples(filter, (4.0f * faces[0].size().x) / (float)width);
+            float weight = 1.0f / (float)(samples * samples);
+
+            // Direction tables for longitude (columns) and latitude (rows).
+            std::vector<float> cosPhi(width * samples), sinPhi(width * samples);
+            std::vector<float> cosTheta(height * samples), sinTheta(height * samples);
+            for (size_t x = 0; x < width * samples; x++)
+            {
+                float phi = (((float)x + 0.5f) / (float)(width * samples)) * 2.0f * BB_PI - BB_PI;
+                cosPhi[x] = cosf(phi);
+                sinPhi[x] = sinf(phi);
+            }
+            for (size_t y = 0; y < height * samples; y++)
+            {
+                float theta = (((float)y + 0.5f) / (float)(height * samples)) * BB_PI;
+                cosTheta[y] = cosf(theta);
+                sinTheta[y] = sinf(theta);
+            }
+
+            Ctr::parallelFor(size_t(0), height, [&](size_t y)
+            {
+                float* dst = (float*)latLong.data + y * latLong.rowPitch * 4;
+                for (size_t x = 0; x < width; x++, dst += 4)
+                {
+                    dst[0] = dst[1] = dst[2] = dst[3] = 0.0f;
+                    for (uint32_t sy = 0; sy < samples; sy++)
+                    {
+                        size_t row = y * samples + sy;
+                        for (uint32_t sx = 0; sx < samples; sx++)
+                        {
+                            size_t column = x * samples + sx;
+                            sampleCube(dst, faces,
+                                       sinTheta[row] * cosPhi[column],
+                                       cosTheta[row],
+                                       sinTheta[row] * sinPhi[column],
+                                       nearest, weight);
+                        }
+                    }
+                }
+            });
+        }
+    };
+}
+
+#endif
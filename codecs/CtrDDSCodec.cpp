@@ -221,7 +221,7 @@ typedef struct
     //---------------------------------------------------------------------
     DataStreamPtr DDSCodec::code(MemoryDataStreamPtr& input, Codec::CodecDataPtr& pData) const
     {        
-        throw (std::exception("DDS encoding not supported DDSCodec::code" ));
+        throw (std::runtime_error("DDS encoding not supported DDSCodec::code" ));
     }
     //---------------------------------------------------------------------
     void DDSCodec::codeToFile(MemoryDataStreamPtr& input, 
@@ -537,7 +537,7 @@ typedef struct
             return PF_FLOAT32_RGBA;
         // We could support 3Dc here, but only ATI cards support it, not nVidia
         default:
-            throw(std::exception("Unsupported FourCC format found in DDS file - DDSCodec::decode"));
+            throw(std::runtime_error("Unsupported FourCC format found in DDS file - DDSCodec::decode"));
         };
 
     }
@@ -567,7 +567,7 @@ typedef struct
 
         }
 
-        throw(std::exception("Cannot determine pixel format - DDSCodec::convertPixelFormat"));
+        throw(std::runtime_error("Cannot determine pixel format - DDSCodec::convertPixelFormat"));
 
     }
     //---------------------------------------------------------------------
@@ -721,7 +721,7 @@ typedef struct
         
         if (FOURCC('D', 'D', 'S', ' ') != fileType)
         {
-            throw(std::exception("This is not a DDS file!"));
+            throw(std::runtime_error("This is not a DDS file!"));
         }
 
         
@@ -735,11 +735,11 @@ typedef struct
         // Check some sizes
         if (header.size != DDS_HEADER_SIZE)
         {
-            throw(std::exception("DDS header size mismatch! - DDSCodec::decode"));
+            throw(std::runtime_error("DDS header size mismatch! - DDSCodec::decode"));
         }
         if (header.pixelFormat.size != DDS_PIXELFORMAT_SIZE)
         {
-            throw(std::exception("DDS header size mismatch! - DDSCodec::decode"));
+            throw(std::runtime_error("DDS header size mismatch! - DDSCodec::decode"));
         }
 
         if ((header.pixelFormat.flags &  0x00000004) &&
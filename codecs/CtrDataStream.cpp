@@ -446,7 +446,7 @@ namespace Ctr
         if (delim.length() == 0)
         {
             LOG("No delimiter provided FileStreamDataStream::readLine" << __LINE__ << " " << __FILE__);
-            throw (std::exception("Failed to readLine"));
+            throw (std::runtime_error("Failed to readLine"));
         }
         if (delim.size() > 1)
         {
@@ -482,7 +482,7 @@ namespace Ctr
             }
             else
             {
-                throw(std::exception("Streaming error occurred FileStreamDataStream::readLine"));
+                throw(std::runtime_error("Streaming error occurred FileStreamDataStream::readLine"));
             }
         }
         else 
@@ -111,7 +111,7 @@ namespace Ctr
     void FreeImageSaveErrorHandler(FREE_IMAGE_FORMAT fif, const char *message) 
     {
         // Callback method as required by FreeImage to report problems
-        throw(std::exception(message));
+        throw(std::runtime_error(message));
     }
     //---------------------------------------------------------------------
     void FreeImageCodec::startup(void)
@@ -277,7 +277,7 @@ namespace Ctr
             break;
 
         default:
-            throw(std::exception("Invalid image format - FreeImageCodec::encode"));
+            throw(std::runtime_error("Invalid image format - FreeImageCodec::encode"));
         };
 
         // Check support for this image type & bit depth
@@ -348,7 +348,7 @@ namespace Ctr
             if (conversionRequired)
                 free(convBox.data);
 
-            throw(std::exception("FreeImage_AllocateT failed - possibly out of memory. "));
+            throw(std::runtime_error("FreeImage_AllocateT failed - possibly out of memory. "));
         }
 
         if (requiredFormat == PF_L8 || requiredFormat == PF_A8)
@@ -444,7 +444,7 @@ namespace Ctr
             (FREE_IMAGE_FORMAT)mFreeImageType, fiMem);
         if (!fiBitmap)
         {
-            throw(std::exception("Error decoding image"));
+            throw(std::runtime_error("Error decoding image"));
         }
 
 
@@ -471,7 +471,7 @@ namespace Ctr
         case FIT_INT32:
         case FIT_DOUBLE:
         default:
-            throw(std::exception("Unknown or unsupported image format - FreeImageCodec::decode"));
+            throw(std::runtime_error("Unknown or unsupported image format - FreeImageCodec::decode"));
                 
             break;
         case FIT_BITMAP:
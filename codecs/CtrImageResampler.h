@@ -70,7 +70,7 @@ THE SOFTWARE.
 #define IBL_IMAGE_SAMPLER
 
 #include <algorithm>
-#include <ppl.h>
+#include <CtrParallel.h>
 
 namespace Ctr
 {
@@ -344,7 +344,7 @@ namespace Ctr
             // fractional bits are the blend weight of the second sample
             
 
-            concurrency::parallel_for(size_t(dst.minExtent.y), size_t(dst.maxExtent.y), [&](uint64_t y)
+            Ctr::parallelFor(size_t(dst.minExtent.y), size_t(dst.maxExtent.y), [&](uint64_t y)
             //for (size_t y = dst.minExtent.y; y < dst.maxExtent.y; y++) 
             {
                 uint64_t sy_48 = ((stepy >> 1) - 1) + (stepy * y);
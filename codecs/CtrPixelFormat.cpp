@@ -748,11 +748,11 @@ namespace Ctr
                 // Entire buffer is being queried
                 return *this;
             }
-            throw(std::exception("Cannot return subvolume of compressed PixelBuffer, PixelBox::getSubVolume"));
+            throw(std::runtime_error("Cannot return subvolume of compressed PixelBuffer, PixelBox::getSubVolume"));
         }
 
         //if(!intersects(def))
-        //    throw(std::exception("Bounds out of range"));
+        //    throw(std::runtime_error("Bounds out of range"));
 
         const size_t elemSize = PixelUtil::getNumElemBytes(format);
         // Calculate new data origin
@@ -816,7 +816,7 @@ namespace Ctr
                     assert(depth == 1);
                     return (std::max((int)width, 8) * std::max((int)height, 8) * 4 + 7) / 8;
                 default:
-                throw(std::exception("Invalid compressed pixel format - PixelUtil::getMemorySize"));
+                throw(std::runtime_error("Invalid compressed pixel format - PixelUtil::getMemorySize"));
             }
         }
         else
@@ -1158,7 +1158,7 @@ namespace Ctr
             default:
                 // Not yet supported
                 throw(
-                    std::exception("pack to not implemented"));
+                    std::runtime_error("pack to not implemented"));
                 break;
             }
         }
@@ -1297,7 +1297,7 @@ namespace Ctr
             default:
                 // Not yet supported
                 // "+getFormatName(pf)+"
-                throw(std::exception("unpack from  not implemented - pixel::unpackColor"));
+                throw(std::runtime_error("unpack from  not implemented - pixel::unpackColor"));
                 break;
             }
         }
@@ -1329,7 +1329,7 @@ namespace Ctr
             }
             else
             {
-                throw(std::exception("This method can not be used to compress or decompress images PixelUtil::bulkPixelConversion"));
+                throw(std::runtime_error("This method can not be used to compress or decompress images PixelUtil::bulkPixelConversion"));
             }
         }
 
@@ -73,6 +73,8 @@ THE SOFTWARE.
 #include <CtrAssetManager.h>
 #include <CtrLog.h>
 #include <CtrImageResampler.h>
+#include <CtrCubeMapProjection.h>
+#include <CtrParallel.h>
 
 namespace Ctr
 {
@@ -169,7 +171,7 @@ TextureImage & TextureImage::flipAroundY()
 {
     if( !mBuffer )
     {
-        throw(std::exception("Can not flip an unitialized texture TextureImage::flipAroundY"));
+        throw(std::runtime_error("Can not flip an unitialized texture TextureImage::flipAroundY"));
     }
     
      mNumMipmaps = 0; // TextureImage operations lose precomputed mipmaps
@@ -245,7 +247,7 @@ TextureImage & TextureImage::flipAroundY()
         break;
 
     default:
-        throw( std::exception("Unknown pixel depth TextureImage::flipAroundY" ));
+        throw( std::runtime_error("Unknown pixel depth TextureImage::flipAroundY" ));
         break;
     }
 
@@ -257,7 +259,7 @@ TextureImage & TextureImage::flipAroundX()
 {
     if( !mBuffer )
     {
-        throw(std::exception( "Can not flip an unitialized texture TextureImage::flipAroundX" ));
+        throw(std::runtime_error( "Can not flip an unitialized texture TextureImage::flipAroundX" ));
     }
     
     mNumMipmaps = 0; // TextureImage operations lose precomputed mipmaps
@@ -304,7 +306,7 @@ TextureImage& TextureImage::loadDynamicTextureImage(uint8_t* pData, size_t uWidt
     if(numFaces == 6)
         mFlags |= IF_CUBEMAP;
     if(numFaces != 6 && numFaces != 1)
-        throw(std::exception("Number of faces currently must be 6 or 1. TextureImage::loadDynamicTextureImage"));
+        throw(std::runtime_error("Number of faces currently must be 6 or 1. TextureImage::loadDynamicTextureImage"));
 
     mBufSize = calculateSize(numMipMaps, numFaces, uWidth, uHeight, depth, eFormat);
     mBuffer = pData;
@@ -323,7 +325,7 @@ TextureImage & TextureImage::loadRawData(
     size_t size = calculateSize(numMipMaps, numFaces, uWidth, uHeight, uDepth, eFormat);
     if (size != stream->size())
     {
-        throw(std::exception("Stream size does not match calculated image size TextureImage::loadRawData"));
+        throw(std::runtime_error("Stream size does not match calculated image size TextureImage::loadRawData"));
     }
 
     uint8_t *buffer = (uint8_t*)malloc(sizeof(uint8_t) * size);
@@ -348,18 +350,18 @@ TextureImage & TextureImage::load(const std::string& strFileName,
         strExt = strFileName.substr(pos+1, strFileName.size()-(pos+1));
     }
 
-    std::unique_ptr<typename DataStream> dataStream;
+    std::unique_ptr<DataStream> dataStream;
     
     if (archiveHandle.valid())
     {
         dataStream = 
-            std::unique_ptr<typename DataStream>
+            std::unique_ptr<DataStream>
             (Ctr::AssetManager::assetManager()->openCompressedStream(archiveHandle, strFileName));
     }
     else
     {
         dataStream =
-            std::unique_ptr<typename DataStream>
+            std::unique_ptr<DataStream>
             (Ctr::AssetManager::assetManager()->openStream(strFileName));
 
     }
@@ -386,20 +388,20 @@ void TextureImage::save(const std::string& filename)
 {
     if( !mBuffer )
     {
-        throw(std::exception("No image data loaded - TextureImage::save"));
+        throw(std::runtime_error("No image data loaded - TextureImage::save"));
     }
 
     std::string strExt;
     size_t pos = filename.rfind(".");
     if( pos == std::string::npos )
-        throw(std::exception("Unable to save image file invalid extension. TextureImage::save" ));
+        throw(std::runtime_error("Unable to save image file invalid extension. TextureImage::save" ));
 
     while( pos != filename.length() - 1 )
         strExt += filename.c_str()[++pos];
 
     Codec * pCodec = Codec::getCodec(strExt);
     if( !pCodec )
-        throw(std::exception("Unable to save image file  - invalid extension. TextureImage::save" ));
+        throw(std::runtime_error("Unable to save image file  - invalid extension. TextureImage::save" ));
 
     ImageCodec::ImageData* imgData = new ImageCodec::ImageData();
     imgData->format = mFormat;
@@ -422,12 +424,12 @@ DataStreamPtr TextureImage::encode(const std::string& formatextension)
 {
     if( !mBuffer )
     {
-        throw(std::exception("No image data loaded TextureImage::encode"));
+        throw(std::runtime_error("No image data loaded TextureImage::encode"));
     }
 
     Codec * pCodec = Codec::getCodec(formatextension);
     if( !pCodec )
-        throw(std::exception("Unable to encode image data as - invalid extension. TextureImage::encode" ));
+        throw(std::runtime_error("Unable to encode image data as - invalid extension. TextureImage::encode" ));
 
     ImageCodec::ImageData* imgData = new ImageCodec::ImageData();
     imgData->format = mFormat;
@@ -464,7 +466,7 @@ TextureImage & TextureImage::load(DataStreamPtr& stream, const std::string& type
         pCodec = Codec::getCodec(magicBuf, magicLen);
 
         if( !pCodec )
-            throw(std::exception("Unable to load image: TextureImage format is unknown. Unable to identify codec. "));
+            throw(std::runtime_error("Unable to load image: TextureImage format is unknown. Unable to identify codec. "));
     }
 
     Codec::DecodeResult res = pCodec->decode(stream);
@@ -764,6 +766,144 @@ void TextureImage::scale(const PixelBox &src, const PixelBox &scaled, Filter fil
     }
 }
 
+TextureImage & 
+TextureImage::createCubeMapFromLatLong(const TextureImage& latLong, 
+                                       size_t faceSize,
+                                       PixelFormat format,
+                                       size_t numMipMaps,
+                                       Filter filter)
+{
+    if (latLong.getNumFaces() != 1 || latLong.getDepth() != 1)
+    {
+        throw(std::runtime_error("Source must be a 2D image - TextureImage::createCubeMapFromLatLong"));
+    }
+    if (PixelUtil::isCompressed(format) || PixelUtil::isCompressed(latLong.getFormat()))
+    {
+        throw(std::runtime_error("Compressed formats are not supported in this method TextureImage::createCubeMapFromLatLong"));
+    }
+
+    // Promote the source to float RGBA once, the projection only deals with one layout.
+    PixelBox src = latLong.getPixelBox();
+    MemoryDataStreamPtr srcBuf;
+    if (src.format != PF_FLOAT32_RGBA)
+    {
+        PixelBox converted(src.size().x, src.size().y, 1, PF_FLOAT32_RGBA);
+        srcBuf.reset(new MemoryDataStream(converted.getConsecutiveSize()));
+        converted.data = srcBuf->getPtr();
+        PixelUtil::bulkPixelConversion(src, converted);
+        src = converted;
+    }
+
+    create(Ctr::Vector2i((int32_t)faceSize, (int32_t)faceSize), format, (uint32_t)numMipMaps, IF_CUBEMAP);
+
+    PixelBox faces[6];
+    MemoryDataStreamPtr faceBuf;
+    if (format != PF_FLOAT32_RGBA)
+    {
+        size_t faceBytes = PixelUtil::getMemorySize(faceSize, faceSize, 1, PF_FLOAT32_RGBA);
+        faceBuf.reset(new MemoryDataStream(faceBytes * 6));
+        for (size_t faceId = 0; faceId < 6; faceId++)
+        {
+            faces[faceId] = PixelBox(faceSize, faceSize, 1, PF_FLOAT32_RGBA, faceBuf->getPtr() + faceBytes * faceId);
+        }
+    }
+    else
+    {
+        for (size_t faceId = 0; faceId < 6; faceId++)
+        {
+            faces[faceId] = getPixelBox(faceId, 0);
+        }
+    }
+
+    CubeMapProjection::latLongToCube(src, faces, filter);
+
+    if (faceBuf)
+    {
+        for (size_t faceId = 0; faceId < 6; faceId++)
+        {
+            PixelUtil::bulkPixelConversion(faces[faceId], getPixelBox(faceId, 0));
+        }
+    }
+
+    return generateMipMaps(filter);
+}
+
+TextureImage & 
+TextureImage::createLatLongFromCubeMap(const TextureImage& cubeMap, 
+                                       size_t width, 
+                                       size_t height,
+                                       PixelFormat format,
+                                       Filter filter)
+{
+    if (cubeMap.getNumFaces() != 6)
+    {
+        throw(std::runtime_error("Source must be a cube map - TextureImage::createLatLongFromCubeMap"));
+    }
+    if (PixelUtil::isCompressed(format) || PixelUtil::isCompressed(cubeMap.getFormat()))
+    {
+        throw(std::runtime_error("Compressed formats are not supported in this method TextureImage::createLatLongFromCubeMap"));
+    }
+
+    PixelBox faces[6];
+    MemoryDataStreamPtr faceBuf;
+    if (cubeMap.getFormat() != PF_FLOAT32_RGBA)
+    {
+        size_t faceSize = cubeMap.getWidth();
+        size_t faceBytes = PixelUtil::getMemorySize(faceSize, faceSize, 1, PF_FLOAT32_RGBA);
+        faceBuf.reset(new MemoryDataStream(faceBytes * 6));
+        for (size_t faceId = 0; faceId < 6; faceId++)
+        {
+            faces[faceId] = PixelBox(faceSize, faceSize, 1, PF_FLOAT32_RGBA, faceBuf->getPtr() + faceBytes * faceId);
+            PixelUtil::bulkPixelConversion(cubeMap.getPixelBox(faceId, 0), faces[faceId]);
+        }
+    }
+    else
+    {
+        for (size_t faceId = 0; faceId < 6; faceId++)
+        {
+            faces[faceId] = cubeMap.getPixelBox(faceId, 0);
+        }
+    }
+
+    create(Ctr::Vector2i((int32_t)width, (int32_t)height), format, 1, 0);
+
+    PixelBox dst = getPixelBox();
+    MemoryDataStreamPtr dstBuf;
+    if (format != PF_FLOAT32_RGBA)
+    {
+        dst = PixelBox(width, height, 1, PF_FLOAT32_RGBA);
+        dstBuf.reset(new MemoryDataStream(dst.getConsecutiveSize()));
+        dst.data = dstBuf->getPtr();
+    }
+
+    CubeMapProjection::cubeToLatLong(faces, dst, filter);
+
+    if (dstBuf)
+    {
+        PixelUtil::bulkPixelConversion(dst, getPixelBox());
+    }
+
+    return *this;
+}
+
+TextureImage & 
+TextureImage::generateMipMaps(Filter filter)
+{
+    // scale only distinguishes nearest from linear; the wider filters are 
+    // a box filter when halving anyway.
+    Filter mipFilter = filter == FILTER_NEAREST ? FILTER_NEAREST : FILTER_BILINEAR;
+
+    Ctr::parallelFor(size_t(0), getNumFaces(), [&](size_t faceId)
+    {
+        for (size_t mipId = 1; mipId < getNumMipmaps(); mipId++)
+        {
+            scale(getPixelBox(faceId, mipId - 1), getPixelBox(faceId, mipId), mipFilter);
+        }
+    });
+
+    return *this;
+}
+
 ColorValue TextureImage::getColorAt(size_t x, size_t y, size_t z) const
 {
     ColorValue rval;
@@ -788,9 +928,9 @@ PixelBox TextureImage::getPixelBox(size_t face, size_t mipmap) const
     // face 1, mip 2
     // etc
     if(mipmap > getNumMipmaps())
-        throw(std::exception("Mipmap index out of range TextureImage::getPixelBox" )) ;
+        throw(std::runtime_error("Mipmap index out of range TextureImage::getPixelBox" )) ;
     if(face >= getNumFaces())
-        throw(std::exception("Face index out of range TextureImage::getPixelBox"));
+        throw(std::runtime_error("Face index out of range TextureImage::getPixelBox"));
     // Calculate mipmap offset and size
     // Not mine. [MattD].
     uint8_t *offset = const_cast<uint8_t*>(getData());
@@ -905,22 +1045,22 @@ TextureImage & TextureImage::combineTwoTextureImagesAsRGBA(const TextureImage& r
         rgb.getHeight() != alpha.getHeight() ||
         rgb.getDepth() != alpha.getDepth())
     {
-        throw(std::exception("TextureImages must be the same dimensions - TextureImage::combineTwoTextureImagesAsRGBA"));
+        throw(std::runtime_error("TextureImages must be the same dimensions - TextureImage::combineTwoTextureImagesAsRGBA"));
     }
     if (rgb.getNumMipmaps() != alpha.getNumMipmaps() ||
         rgb.getNumFaces() != alpha.getNumFaces())
     {
-        throw(std::exception("TextureImages must have the same number of surfaces (faces & mipmaps) - TextureImage::combineTwoTextureImages"));
+        throw(std::runtime_error("TextureImages must have the same number of surfaces (faces & mipmaps) - TextureImage::combineTwoTextureImages"));
     }
     // Format check
     if (PixelUtil::getComponentCount(fmt) != 4)
     {
-        throw(std::exception("Target format must have 4 components - TextureImage::combineTwoTextureImagesAsRGBA"));
+        throw(std::runtime_error("Target format must have 4 components - TextureImage::combineTwoTextureImagesAsRGBA"));
     }
     if (PixelUtil::isCompressed(fmt) || PixelUtil::isCompressed(rgb.getFormat()) 
         || PixelUtil::isCompressed(alpha.getFormat()))
     {
-        throw(std::exception("Compressed formats are not supported in this method TextureImage::combineTwoTextureImagesAsRGBA"));
+        throw(std::runtime_error("Compressed formats are not supported in this method TextureImage::combineTwoTextureImagesAsRGBA"));
     }
 
     freeMemory();
@@ -197,6 +197,22 @@ class TextureImage
 
     static void scale(const PixelBox &src, const PixelBox &dst, Filter filter = FILTER_BILINEAR);
     void   resize(size_t width, size_t height, Filter filter = FILTER_BILINEAR);
+
+    // Reprojects an equirectangular (lat-long) image into a cube map with faceSize^2 faces.
+    // Mips beyond the first are generated with generateMipMaps.
+    TextureImage & createCubeMapFromLatLong(const TextureImage& latLong, size_t faceSize,
+                                            PixelFormat format = PF_FLOAT32_RGBA,
+                                            size_t numMipMaps = 1,
+                                            Filter filter = FILTER_BILINEAR);
+
+    // Reprojects a cube map (mip 0) into an equirectangular (lat-long) image.
+    TextureImage & createLatLongFromCubeMap(const TextureImage& cubeMap, size_t width, size_t height,
+                                            PixelFormat format = PF_FLOAT32_RGBA,
+                                            Filter filter = FILTER_BILINEAR);
+
+    // Rebuilds mips 1..n of every face by downsampling the previous level.
+    TextureImage & generateMipMaps(Filter filter = FILTER_BILINEAR);
+
     static size_t calculateSize(size_t mipmaps, size_t faces, size_t width, size_t height, size_t depth, PixelFormat format);
     static std::string getFileExtFromMagic(DataStreamPtr stream);
 
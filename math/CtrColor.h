@@ -73,10 +73,10 @@ inline Vector4f                fromPackedColor (PackedColor colour)
 {
     const float f = 1.0f / 255.0f;
     Vector4f color;
-    color.x = f * (FLOAT)(unsigned char)(colour >> 16);
-    color.y = f * (FLOAT)(unsigned char)(colour >>  8);
-    color.z = f * (FLOAT)(unsigned char)colour;
-    color.w = f * (FLOAT)(unsigned char)(colour >> 24);
+    color.x = f * (float)(unsigned char)(colour >> 16);
+    color.y = f * (float)(unsigned char)(colour >>  8);
+    color.z = f * (float)(unsigned char)colour;
+    color.w = f * (float)(unsigned char)(colour >> 24);
     return color;
 }
 
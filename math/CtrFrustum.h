@@ -0,0 +1,207 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_FRUSTUM
+#define INCLUDED_CRT_FRUSTUM
+
+#include <CtrPlatform.h>
+#include <CtrVector3.h>
+#include <CtrVector4.h>
+#include <CtrMatrix44.h>
+#include <CtrRegion.h>
+
+namespace Ctr
+{
+//--------------------------------------------------------------------
+//
+// Frustum
+//
+// Six clip planes extracted from a (row vector) view projection matrix.
+// Planes point inwards and are normalized. They are also kept in SoA 
+// form, padded to 8, so that a box can be tested against 4 planes
+// per SSE instruction.
+//
+//--------------------------------------------------------------------
+class Frustum
+{
+  public:
+    enum Containment
+    {
+        Outside,
+        Intersecting,
+        Inside
+    };
+
+    enum PlaneId
+    {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        PlaneCount
+    };
+
+    Frustum()
+    {
+        set(Matrix44f());
+    }
+
+    explicit Frustum(const Matrix44f& viewProj)
+    {
+        set(viewProj);
+    }
+
+    void                       set(const Matrix44f& m)
+    {
+        // clip = p * M, so each clip coordinate is a column of M.
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            _planes[Left][i]   = m[i][3] + m[i][0];
+            _planes[Right][i]  = m[i][3] - m[i][0];
+            _planes[Bottom][i] = m[i][3] + m[i][1];
+            _planes[Top][i]    = m[i][3] - m[i][1];
+            // D3D clip space depth is [0, w].
+            _planes[Near][i]   = m[i][2];
+            _planes[Far][i]    = m[i][3] - m[i][2];
+        }
+
+        for (uint32_t p = 0; p < 8; p++)
+        {
+            float* plane = _planes[p < PlaneCount ? p : 0];
+            if (p < PlaneCount)
+            {
+                float length = sqrtf(plane[0]*plane[0] + plane[1]*plane[1] + plane[2]*plane[2]);
+                if (length > 0.0f)
+                {
+                    float invLength = 1.0f / length;
+                    for (uint32_t i = 0; i < 4; i++)
+                        plane[i] *= invLength;
+                }
+            }
+
+            _nx[p] = plane[0];
+            _ny[p] = plane[1];
+            _nz[p] = plane[2];
+            _nd[p] = plane[3];
+        }
+    }
+
+    Vector4f                   plane(uint32_t planeId) const
+    {
+        const float* plane = _planes[planeId];
+        return Vector4f(plane[0], plane[1], plane[2], plane[3]);
+    }
+
+    Containment                classify(const Region3f& bounds) const
+    {
+        const Vector3f& minExtent = bounds.minExtent;
+        const Vector3f& maxExtent = bounds.maxExtent;
+        float cx = (maxExtent.x + minExtent.x) * 0.5f;
+        float cy = (maxExtent.y + minExtent.y) * 0.5f;
+        float cz = (maxExtent.z + minExtent.z) * 0.5f;
+        float ex = (maxExtent.x - minExtent.x) * 0.5f;
+        float ey = (maxExtent.y - minExtent.y) * 0.5f;
+        float ez = (maxExtent.z - minExtent.z) * 0.5f;
+
+#if CTR_SSE
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const __m128 vcx = _mm_set1_ps(cx);
+        const __m128 vcy = _mm_set1_ps(cy);
+        const __m128 vcz = _mm_set1_ps(cz);
+        const __m128 vex = _mm_set1_ps(ex);
+        const __m128 vey = _mm_set1_ps(ey);
+        const __m128 vez = _mm_set1_ps(ez);
+        const __m128 zero = _mm_setzero_ps();
+
+        int straddles = 0;
+        for (uint32_t p = 0; p < 8; p += 4)
+        {
+            __m128 nx = _mm_load_ps(&_nx[p]);
+            __m128 ny = _mm_load_ps(&_ny[p]);
+            __m128 nz = _mm_load_ps(&_nz[p]);
+
+            // Signed distance of the box center, and the projected radius of the box.
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, vcx), _mm_mul_ps(ny, vcy)),
+                                         _mm_add_ps(_mm_mul_ps(nz, vcz), _mm_load_ps(&_nd[p])));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(nx, signMask), vex),
+                                                  _mm_mul_ps(_mm_and_ps(ny, signMask), vey)),
+                                       _mm_mul_ps(_mm_and_ps(nz, signMask), vez));
+
+            if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero)))
+                return Outside;
+            straddles |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(distance, radius), zero));
+        }
+        return straddles ? Intersecting : Inside;
+#else
+        bool straddles = false;
+        for (uint32_t p = 0; p < PlaneCount; p++)
+        {
+            float distance = _nx[p] * cx + _ny[p] * cy + _nz[p] * cz + _nd[p];
+            float radius = fabsf(_nx[p]) * ex + fabsf(_ny[p]) * ey + fabsf(_nz[p]) * ez;
+            if (distance + radius < 0.0f)
+                return Outside;
+            if (distance - radius < 0.0f)
+                straddles = true;
+        }
+        return straddles ? Intersecting : Inside;
+#endif
+    }
+
+    bool                       intersects(const Region3f& bounds) const
+    {
+        return classify(bounds) != Outside;
+    }
+
+  private:
+    float                      _planes[PlaneCount][4];
+
+    // SoA copy of the planes. Slots 6 and 7 repeat the left plane.
+    alignas(16) float          _nx[8];
+    alignas(16) float          _ny[8];
+    alignas(16) float          _nz[8];
+    alignas(16) float          _nd[8];
+};
+
+}
+
+#endif
@@ -64,7 +64,7 @@ class Limits
     static bool                isEqual ( T a,  T b) { return isZero (a - b); }
     static bool                isZero ( T a) { return (a == 0); }
     static bool                isNaN ( T a) { return  false; }
-    static bool                isInf ( T) { return !_finite (a); }
+    static bool                isInf ( T a) { return !std::isfinite (double(a)); }
 
     static size_t              maxVal (const T& a, const T& b) { return (a > b) ? a : b; }
     static size_t              minVal (const T& a, const T& b) { return (a < b) ? a : b; }
@@ -116,8 +116,8 @@ template<> class Limits <int32_t>
 template<> class Limits <int64_t>
 {
   public:
-    static int64_t             maximum() { return _I64_MAX; }
-    static int64_t             minimum() { return _I64_MIN; }    
+    static int64_t             maximum() { return INT64_MAX; }
+    static int64_t             minimum() { return INT64_MIN; }    
     static int64_t             maxVal (const int64_t& a, const int64_t& b) { return (a > b) ? a : b; }
     static int64_t             minVal (const int64_t& a, const int64_t& b) { return (a < b) ? a : b; }
     static bool                isZero (int64_t a) { return (a == 0); }
@@ -127,7 +127,7 @@ template<> class Limits <int64_t>
 template<> class Limits <uint64_t>
 {
   public:
-    static uint64_t            maximum() { return _UI64_MAX; }
+    static uint64_t            maximum() { return UINT64_MAX; }
     static uint64_t            minimum() { return 0; }
     static uint64_t            maxVal (const uint64_t& a, const uint64_t& b) { return (a > b) ? a : b; }
     static uint64_t            minVal (const uint64_t& a, const uint64_t& b) { return (a < b) ? a : b; }
@@ -144,6 +144,8 @@ template<> class Limits <uint32_t>
     static bool                isEqual (uint32_t a,  uint32_t b) { return a == b; }
 };
 
+// On LP64 platforms long is int64_t and unsigned long is uint64_t.
+#if !(defined(__LP64__) || defined(_LP64))
 template<> class Limits <long>
 {
   public:
@@ -162,6 +164,7 @@ template<> class Limits <unsigned long>
     static bool                isZero (unsigned long a) { return (a == 0); }
     static bool                isEqual (unsigned long a, unsigned long b) { return a == b; }
 };
+#endif
 
 template<> class Limits <float>
 {
@@ -180,7 +183,7 @@ template<> class Limits <double>
     static double              maximum() { return DBL_MAX; }
     static double              minimum() { return DBL_MIN; }
     static double              epsilon() { return DBL_EPSILON; }
-    static bool                isZero (double a) { return (abs (a) < epsilon()); }
+    static bool                isZero (double a) { return (fabs (a) < epsilon()); }
     static bool                isEqual (double a, double b) { return isZero (a - b); }
     static double              one() { return 1.0; }
 };
@@ -47,11 +47,15 @@
 #include <CtrQuaternion.h>
 #include <CtrVector3.h>
 #include <CtrVector4.h>
+#include <CtrMatrixSSE.h>
 
 namespace Ctr
 {
+// Matrix44<float> routes multiply, transpose and Vector4 transforms through 
+// the SSE kernels in CtrMatrixSSE.h. The scalar versions stay available
+// as multiplyScalar, transposeScalar and transformScalar for reference.
 template <typename  T>
-class Matrix44
+class alignas(16) Matrix44
 {
 public:
     union
@@ -92,14 +96,20 @@ public:
     inline void                setIdentity()
     {
         memset(&_mat[0], 0, sizeof(T) * 16);
-        _mat[0] = Ctr::Limits<typename T>::one();
-        _mat[5] = Ctr::Limits<typename T>::one();
-        _mat[10] = Ctr::Limits<typename T>::one();
-        _mat[15] = Ctr::Limits<typename T>::one();
+        _mat[0] = Ctr::Limits<T>::one();
+        _mat[5] = Ctr::Limits<T>::one();
+        _mat[10] = Ctr::Limits<T>::one();
+        _mat[15] = Ctr::Limits<T>::one();
     } 
 
     Matrix44<T>& 
     transpose()
+    {
+        return transposeScalar();
+    }
+
+    Matrix44<T>& 
+    transposeScalar()
     {
         T src [4][4];
         memcpy (&src[0][0], &_m[0][0], 16 * sizeof(T));
@@ -208,6 +218,11 @@ public:
     }
 
     Matrix44<T>                operator*( const Matrix44<T>& other ) const
+    {
+        return multiplyScalar(other);
+    }
+
+    Matrix44<T>                multiplyScalar( const Matrix44<T>& other ) const
     {
         Matrix44<T> result;
         for (uint32_t i=0; i<4; i++)
@@ -224,9 +239,52 @@ public:
         return result;
     }
 
+    //------------------------------------------------------
+    // General inverse by cofactor expansion.
+    // Returns false and leaves result untouched if singular.
+    //------------------------------------------------------
+    bool                       inverse(Matrix44<T>& result) const
+    {
+        const T* m = _mat;
+        T inv[16];
+
+        inv[0] = m[5]*m[10]*m[15] - m[5]*m[11]*m[14] - m[9]*m[6]*m[15] + m[9]*m[7]*m[14] + m[13]*m[6]*m[11] - m[13]*m[7]*m[10];
+        inv[4] = -m[4]*m[10]*m[15] + m[4]*m[11]*m[14] + m[8]*m[6]*m[15] - m[8]*m[7]*m[14] - m[12]*m[6]*m[11] + m[12]*m[7]*m[10];
+        inv[8] = m[4]*m[9]*m[15] - m[4]*m[11]*m[13] - m[8]*m[5]*m[15] + m[8]*m[7]*m[13] + m[12]*m[5]*m[11] - m[12]*m[7]*m[9];
+        inv[12] = -m[4]*m[9]*m[14] + m[4]*m[10]*m[13] + m[8]*m[5]*m[14] - m[8]*m[6]*m[13] - m[12]*m[5]*m[10] + m[12]*m[6]*m[9];
+        inv[1] = -m[1]*m[10]*m[15] + m[1]*m[11]*m[14] + m[9]*m[2]*m[15] - m[9]*m[3]*m[14] - m[13]*m[2]*m[11] + m[13]*m[3]*m[10];
+        inv[5] = m[0]*m[10]*m[15] - m[0]*m[11]*m[14] - m[8]*m[2]*m[15] + m[8]*m[3]*m[14] + m[12]*m[2]*m[11] - m[12]*m[3]*m[10];
+        inv[9] = -m[0]*m[9]*m[15] + m[0]*m[11]*m[13] + m[8]*m[1]*m[15] - m[8]*m[3]*m[13] - m[12]*m[1]*m[11] + m[12]*m[3]*m[9];
+        inv[13] = m[0]*m[9]*m[14] - m[0]*m[10]*m[13] - m[8]*m[1]*m[14] + m[8]*m[2]*m[13] + m[12]*m[1]*m[10] - m[12]*m[2]*m[9];
+        inv[2] = m[1]*m[6]*m[15] - m[1]*m[7]*m[14] - m[5]*m[2]*m[15] + m[5]*m[3]*m[14] + m[13]*m[2]*m[7] - m[13]*m[3]*m[6];
+        inv[6] = -m[0]*m[6]*m[15] + m[0]*m[7]*m[14] + m[4]*m[2]*m[15] - m[4]*m[3]*m[14] - m[12]*m[2]*m[7] + m[12]*m[3]*m[6];
+        inv[10] = m[0]*m[5]*m[15] - m[0]*m[7]*m[13] - m[4]*m[1]*m[15] + m[4]*m[3]*m[13] + m[12]*m[1]*m[7] - m[12]*m[3]*m[5];
+        inv[14] = -m[0]*m[5]*m[14] + m[0]*m[6]*m[13] + m[4]*m[1]*m[14] - m[4]*m[2]*m[13] - m[12]*m[1]*m[6] + m[12]*m[2]*m[5];
+        inv[3] = -m[1]*m[6]*m[11] + m[1]*m[7]*m[10] + m[5]*m[2]*m[11] - m[5]*m[3]*m[10] - m[9]*m[2]*m[7] + m[9]*m[3]*m[6];
+        inv[7] = m[0]*m[6]*m[11] - m[0]*m[7]*m[10] - m[4]*m[2]*m[11] + m[4]*m[3]*m[10] + m[8]*m[2]*m[7] - m[8]*m[3]*m[6];
+        inv[11] = -m[0]*m[5]*m[11] + m[0]*m[7]*m[9] + m[4]*m[1]*m[11] - m[4]*m[3]*m[9] - m[8]*m[1]*m[7] + m[8]*m[3]*m[5];
+        inv[15] = m[0]*m[5]*m[10] - m[0]*m[6]*m[9] - m[4]*m[1]*m[10] + m[4]*m[2]*m[9] + m[8]*m[1]*m[6] - m[8]*m[2]*m[5];
+
+        T det = m[0]*inv[0] + m[1]*inv[4] + m[2]*inv[8] + m[3]*inv[12];
+        if (det == T(0))
+            return false;
+
+        T invDet = Ctr::Limits<T>::one() / det;
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            result._mat[i] = inv[i] * invDet;
+        }
+        return true;
+    }
 
     Vector4<T>
     transform( const Vector4<T>& other ) const
+    {
+        return transformScalar(other);
+    }
+
+    Vector4<T>
+    transformScalar( const Vector4<T>& other ) const
     {
         Vector4<T> result;
         result.x = _mat[0]*other.x + _mat[4]*other.y + _mat[8]*other.z + _mat[12]*other.w;
@@ -298,6 +356,34 @@ public:
     }
 };
 
+#if CTR_SSE
+template <>
+inline Matrix44<float>
+Matrix44<float>::operator*( const Matrix44<float>& other ) const
+{
+    Matrix44<float> result;
+    sseMatrixMultiply(_mat, other._mat, result._mat);
+    return result;
+}
+
+template <>
+inline Matrix44<float>&
+Matrix44<float>::transpose()
+{
+    sseMatrixTranspose(_mat);
+    return *this;
+}
+
+template <>
+inline Vector4<float>
+Matrix44<float>::transform( const Vector4<float>& other ) const
+{
+    Vector4<float> result;
+    sseTransformVector4(_mat, &other.x, &result.x);
+    return result;
+}
+#endif
+
 typedef Matrix44<float> Matrix44f;
 }
 
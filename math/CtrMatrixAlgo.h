@@ -44,6 +44,7 @@
 
 #include <CtrPlatform.h>
 #include <CtrMath.h>
+#include <CtrMatrix44.h>
 
 namespace Ctr
 {
@@ -110,6 +111,78 @@ projectionPerspectiveMatrixLH (float fovy, float fovx, float aspect, float zn, f
 }
 
 
+//------------------------------------------------------
+// Batch transforms.
+// The SSE paths process 4 points per iteration; the
+// Scalar variants are kept as the reference implementation.
+//------------------------------------------------------
+inline void
+transformPointsScalar(const Matrix44f& m, const Vector3f* src, Vector3f* dst, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        dst[i] = m.transform(src[i]);
+    }
+}
+
+// dst[i] = (src[i], 1) * m. src and dst may be the same array.
+inline void
+transformPoints(const Matrix44f& m, const Vector3f* src, Vector3f* dst, size_t count)
+{
+#if CTR_SSE
+    sseTransformPoints(m._mat, &src->x, &dst->x, count);
+#else
+    transformPointsScalar(m, src, dst, count);
+#endif
+}
+
+inline void
+transformPoints(const Matrix44f& m, std::vector<Vector3f>& points)
+{
+    if (!points.empty())
+        transformPoints(m, &points[0], &points[0], points.size());
+}
+
+inline void
+multiplyManyScalar(const Matrix44f* lhs, const Matrix44f* rhs, Matrix44f* result, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        result[i] = lhs[i].multiplyScalar(rhs[i]);
+    }
+}
+
+// result[i] = lhs[i] * rhs[i]. result may alias lhs or rhs.
+inline void
+multiplyMany(const Matrix44f* lhs, const Matrix44f* rhs, Matrix44f* result, size_t count)
+{
+#if CTR_SSE
+    for (size_t i = 0; i < count; i++)
+    {
+        sseMatrixMultiply(lhs[i]._mat, rhs[i]._mat, result[i]._mat);
+    }
+#else
+    multiplyManyScalar(lhs, rhs, result, count);
+#endif
+}
+
+// result[i] = lhs[i] * rhs, e.g. local transforms into a shared parent.
+inline void
+multiplyMany(const Matrix44f* lhs, const Matrix44f& rhs, Matrix44f* result, size_t count)
+{
+#if CTR_SSE
+    for (size_t i = 0; i < count; i++)
+    {
+        sseMatrixMultiply(lhs[i]._mat, rhs._mat, result[i]._mat);
+    }
+#else
+    for (size_t i = 0; i < count; i++)
+    {
+        result[i] = lhs[i].multiplyScalar(rhs);
+    }
+#endif
+}
+
 template <typename T>
 inline
 void vecTransform(Vector3<T>& v, const Quaternion<T>& q)
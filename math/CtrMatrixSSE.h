@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_MATRIX_SSE
+#define INCLUDED_CRT_MATRIX_SSE
+
+#include <CtrPlatform.h>
+
+// SSE kernels behind Matrix44<float>, Vector4<float> and the batch 
+// transforms in CtrMatrixAlgo.h. Matrices are row major, vectors are
+// rows: v' = v * M, so a result is a sum of matrix rows scaled by
+// the vector components. Loads and stores are unaligned so that
+// storage allocated with an 8 byte aligned heap (x86) is still safe.
+#if CTR_SSE
+
+namespace Ctr
+{
+inline __m128
+sseTransformRow(__m128 v, __m128 r0, __m128 r1, __m128 r2, __m128 r3)
+{
+    __m128 result = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0,0,0,0)), r0);
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1,1,1,1)), r1));
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2,2,2,2)), r2));
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3,3,3,3)), r3));
+    return result;
+}
+
+// result = a * b. result may alias a or b.
+inline void
+sseMatrixMultiply(const float* a, const float* b, float* result)
+{
+    __m128 b0 = _mm_loadu_ps(b);
+    __m128 b1 = _mm_loadu_ps(b + 4);
+    __m128 b2 = _mm_loadu_ps(b + 8);
+    __m128 b3 = _mm_loadu_ps(b + 12);
+
+    __m128 r0 = sseTransformRow(_mm_loadu_ps(a), b0, b1, b2, b3);
+    __m128 r1 = sseTransformRow(_mm_loadu_ps(a + 4), b0, b1, b2, b3);
+    __m128 r2 = sseTransformRow(_mm_loadu_ps(a + 8), b0, b1, b2, b3);
+    __m128 r3 = sseTransformRow(_mm_loadu_ps(a + 12), b0, b1, b2, b3);
+
+    _mm_storeu_ps(result, r0);
+    _mm_storeu_ps(result + 4, r1);
+    _mm_storeu_ps(result + 8, r2);
+    _mm_storeu_ps(result + 12, r3);
+}
+
+inline void
+sseMatrixTranspose(float* m)
+{
+    __m128 r0 = _mm_loadu_ps(m);
+    __m128 r1 = _mm_loadu_ps(m + 4);
+    __m128 r2 = _mm_loadu_ps(m + 8);
+    __m128 r3 = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(m, r0);
+    _mm_storeu_ps(m + 4, r1);
+    _mm_storeu_ps(m + 8, r2);
+    _mm_storeu_ps(m + 12, r3);
+}
+
+// result = (v.x, v.y, v.z, v.w) * m
+inline void
+sseTransformVector4(const float* m, const float* v, float* result)
+{
+    _mm_storeu_ps(result, sseTransformRow(_mm_loadu_ps(v), 
+                                          _mm_loadu_ps(m), 
+                                          _mm_loadu_ps(m + 4), 
+                                          _mm_loadu_ps(m + 8), 
+                                          _mm_loadu_ps(m + 12)));
+}
+
+// Transforms count (x, y, z, 1) points stored as packed float triplets.
+// Four points are processed at a time as x, y and z registers.
+// src and dst may be the same array.
+inline void
+sseTransformPoints(const float* m, const float* src, float* dst, size_t count)
+{
+    __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]);
+    __m128 m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]), m6 = _mm_set1_ps(m[6]);
+    __m128 m8 = _mm_set1_ps(m[8]), m9 = _mm_set1_ps(m[9]), m10 = _mm_set1_ps(m[10]);
+    __m128 m12 = _mm_set1_ps(m[12]), m13 = _mm_set1_ps(m[13]), m14 = _mm_set1_ps(m[14]);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, src += 12, dst += 12)
+    {
+        // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+        __m128 a = _mm_loadu_ps(src);
+        __m128 b = _mm_loadu_ps(src + 4);
+        __m128 c = _mm_loadu_ps(src + 8);
+
+        __m128 t0 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2,1,3,2));
+        __m128 t1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1,0,2,1));
+        __m128 x = _mm_shuffle_ps(a, t0, _MM_SHUFFLE(2,0,3,0));
+        __m128 y = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3,1,2,0));
+        __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1,1,2,2)),
+                                  _mm_shuffle_ps(c, c, _MM_SHUFFLE(3,3,0,0)),
+                                  _MM_SHUFFLE(2,0,2,0));
+
+        __m128 ox = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m0), _mm_mul_ps(y, m4)), _mm_add_ps(_mm_mul_ps(z, m8), m12));
+        __m128 oy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m1), _mm_mul_ps(y, m5)), _mm_add_ps(_mm_mul_ps(z, m9), m13));
+        __m128 oz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m2), _mm_mul_ps(y, m6)), _mm_add_ps(_mm_mul_ps(z, m10), m14));
+
+        // Back to x0 y0 z0 x1, y1 z1 x2 y2, z2 x3 y3 z3
+        __m128 xy01 = _mm_unpacklo_ps(ox, oy);
+        __m128 xy23 = _mm_unpackhi_ps(ox, oy);
+        a = _mm_shuffle_ps(xy01, _mm_shuffle_ps(oz, xy01, _MM_SHUFFLE(2,2,0,0)), _MM_SHUFFLE(2,0,1,0));
+        b = _mm_shuffle_ps(_mm_shuffle_ps(xy01, oz, _MM_SHUFFLE(1,1,3,3)), xy23, _MM_SHUFFLE(1,0,2,0));
+        c = _mm_shuffle_ps(_mm_shuffle_ps(oz, xy23, _MM_SHUFFLE(2,2,2,2)), 
+                           _mm_shuffle_ps(xy23, oz, _MM_SHUFFLE(3,3,3,3)),
+                           _MM_SHUFFLE(2,0,2,0));
+
+        _mm_storeu_ps(dst, a);
+        _mm_storeu_ps(dst + 4, b);
+        _mm_storeu_ps(dst + 8, c);
+    }
+
+    for (; i < count; i++, src += 3, dst += 3)
+    {
+        float x = src[0], y = src[1], z = src[2];
+        dst[0] = m[0]*x + m[4]*y + m[8]*z + m[12];
+        dst[1] = m[1]*x + m[5]*y + m[9]*z + m[13];
+        dst[2] = m[2]*x + m[6]*y + m[10]*z + m[14];
+    }
+}
+}
+
+#endif
+
+#endif
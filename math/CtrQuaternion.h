@@ -95,7 +95,7 @@ class Quaternion
     { x = y = z = 0.0; w = 1.0;}
 
     Quaternion<T> operator-() const
-    { return Quaternion<T> ( -x, -y, -z, -w,);}
+    { return Quaternion<T> ( -x, -y, -z, -w);}
 
     inline bool                operator == (const Quaternion<T>& other) const
     {
@@ -170,7 +170,7 @@ class Quaternion
     }
 
 };
-typedef Quaternion<typename float> Quaternionf;
+typedef Quaternion<float> Quaternionf;
 }
 
 #endif
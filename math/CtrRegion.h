@@ -96,17 +96,17 @@ class Region
 
     T               center() const
     {
-        return (max + min)*0.5;
+        return (maxExtent + minExtent)*0.5;
     }
 
     T               minExtent;
     T               maxExtent;
 };
 
-typedef Region < typename Vector2i > Region2i;
-typedef Region < typename Vector2f > Region2f;
-typedef Region < typename Vector3i > Region3i;
-typedef Region < typename Vector3f > Region3f;
+typedef Region < Vector2i > Region2i;
+typedef Region < Vector2f > Region2f;
+typedef Region < Vector3i > Region3i;
+typedef Region < Vector3f > Region3f;
 }
 
 #endif
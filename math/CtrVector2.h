@@ -43,6 +43,7 @@
 #define INCLUDED_VECTOR2
 
 #include <CtrPlatform.h>
+#include <CtrLimits.h>
 
 namespace Ctr
 {
@@ -139,14 +140,14 @@ class Vector2
 
     friend inline Vector2<T>   operator*(const Vector2<T>& v, T s)
     {
-        Vector2<T> result = *this;
+        Vector2<T> result = v;
         result *= s;
         return result;
     }
 
     friend inline Vector2<T>   operator*(T s, const Vector2<T>& v)
     {
-        Vector2<T> result = *this;
+        Vector2<T> result = v;
         result *= s;
         return result;
     }
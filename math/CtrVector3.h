@@ -78,9 +78,9 @@ class Vector3
 
     inline T&                  operator[] (unsigned int i) { return (&x)[i]; }
     inline T                   operator[] (unsigned int i) const { return (&x)[i]; }
-    inline T                   length() const { return Ctr::sqrt( x*x + y*y + z*z); }
+    inline T                   length() const { return T(std::sqrt( x*x + y*y + z*z)); }
     inline T                   lengthSquared() const { return (x*x + y*y + z*z); }
-    inline T                   distance (const Vector3<T>& b) const { return Ctr::sqrt( distanceSquared (b) ); }
+    inline T                   distance (const Vector3<T>& b) const { return T(std::sqrt( distanceSquared (b) )); }
 
     inline T                   distanceSquared (const Vector3<T>& b) const
     {
@@ -226,8 +226,8 @@ class Vector3
     }
 };
 
-typedef Vector3<typename int> Vector3i;
-typedef Vector3<typename float> Vector3f;
+typedef Vector3<int> Vector3i;
+typedef Vector3<float> Vector3f;
 }
 
 #endif
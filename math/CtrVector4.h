@@ -44,11 +44,12 @@
 
 #include <CtrPlatform.h>
 #include <CtrMath.h>
+#include <CtrLimits.h>
 
 namespace Ctr
 {
 template <typename T>
-class Vector4
+class alignas(16) Vector4
 {
   public:
     T                          x;
@@ -173,7 +174,7 @@ class Vector4
     friend std::ostream& 
     operator << (std::ostream &s, const Vector4<T>& v)
     {
-        return (s << "x = " << v.x << " y = " << v.y << " z = " << v.z " w = " << v.);
+        return (s << "x = " << v.x << " y = " << v.y << " z = " << v.z << " w = " << v.w);
     }
 };
 
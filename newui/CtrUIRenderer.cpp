@@ -51,11 +51,70 @@
 #include <CtrGpuVariable.h>
 #include <CtrIShader.h>
 #include <CtrScene.h>
+#include <CtrProfiler.h>
+#include <CtrLog.h>
 
 namespace Ctr
 {
+namespace
+{
+// Nominal size of one map of the transient buffers, the buffers are ring
+// buffered at 10 times this.
+const uint32_t TransientVertices = 10000;
+const uint32_t TransientIndices = 15000;
+
+// Commands searched backwards for a merge.
+const size_t MaxMergeDistance = 32;
+
+bool
+overlaps(const float a[4], const float b[4])
+{
+    return a[0] < b[2] && b[0] < a[2] && a[1] < b[3] && b[1] < a[3];
+}
+}
 
 UIRenderer*         UIRenderer::_uiRenderer = nullptr;
+UIRenderer::Stats   UIRenderer::_frameStats = { 0, 0, 0, 0 };
+UIRenderer::Stats   UIRenderer::_lastFrameStats = { 0, 0, 0, 0 };
+
+UIRenderer::DrawState::DrawState() :
+    shader(nullptr),
+    texture(nullptr),
+    scissorEnabled(false),
+    hasViewProj(false)
+{
+    memset(scissor, 0, sizeof(scissor));
+    for (uint32_t i = 0; i < MaxVectors; i++)
+    {
+        vectorNames[i] = nullptr;
+        vectors[i] = Ctr::Vector4f(0, 0, 0, 0);
+    }
+}
+
+bool
+UIRenderer::DrawState::operator == (const DrawState& other) const
+{
+    if (shader != other.shader ||
+        texture != other.texture ||
+        scissorEnabled != other.scissorEnabled ||
+        hasViewProj != other.hasViewProj)
+    {
+        return false;
+    }
+    if (scissorEnabled && memcmp(scissor, other.scissor, sizeof(scissor)) != 0)
+        return false;
+    if (hasViewProj && memcmp(&viewProj._m[0][0], &other.viewProj._m[0][0], sizeof(float) * 16) != 0)
+        return false;
+
+    for (uint32_t i = 0; i < MaxVectors; i++)
+    {
+        if (vectorNames[i] != other.vectorNames[i])
+            return false;
+        if (vectorNames[i] && memcmp(&vectors[i].x, &other.vectors[i].x, sizeof(float) * 4) != 0)
+            return false;
+    }
+    return true;
+}
 
 void
 UIRenderer::create(Ctr::IDevice* device)
@@ -72,6 +131,13 @@ UIRenderer::renderer()
 UIRenderer::UIRenderer(Ctr::IDevice* device) :
     Ctr::Mesh (device),
     _vertexOffset(0),
+    _indexOffset(0),
+    _drawIndexed(false),
+    _commandCount(0),
+    _pendingCommand(0),
+    _pendingFirstIndex(0),
+    _pendingIndexCount(0),
+    _pendingBaseVertex(0),
     _indexBuffer(nullptr),
     _currentShader(nullptr),
     _currentVertexBuffer(nullptr)
@@ -83,7 +149,7 @@ UIRenderer::UIRenderer(Ctr::IDevice* device) :
     setMaterial(new Material(device));
 
     // Setup Ringbuffered index buffer.
-    IndexBufferParameters ibResource = IndexBufferParameters(sizeof(uint32_t)*15000, true, true);
+    IndexBufferParameters ibResource = IndexBufferParameters(sizeof(uint32_t)*TransientIndices, true, true);
     _indexBuffer = _device->createIndexBuffer(&ibResource);
     if (!_indexBuffer)
     {
@@ -137,8 +203,6 @@ UIRenderer::setViewProj(const Ctr::Matrix44f& viewProj)
 IVertexBuffer*
 UIRenderer::vertexBuffer(IVertexDeclaration* declaration)
 {
-    // This is a bit of a waste. I really prefer the bgfx "Transient Buffer" idea.
-
     // Find the matching vertex declaration for this buffer.
     // If it doesn't exist, create it.
     auto vit = _vertexBuffers.find(declaration);
@@ -147,7 +211,7 @@ UIRenderer::vertexBuffer(IVertexDeclaration* declaration)
         // Create one.
         VertexBufferParameters vertexBufferParameters;
         vertexBufferParameters =
-            VertexBufferParameters((uint32_t)(10000 * (declaration->vertexStride())), true, false,
+            VertexBufferParameters((uint32_t)(TransientVertices * (declaration->vertexStride())), true, false,
             declaration->vertexStride(),
             nullptr, false, true);
         if (IVertexBuffer* vertexBuffer = _device->createVertexBuffer(&vertexBufferParameters))
@@ -182,7 +246,7 @@ UIRenderer::render(const Ctr::RenderRequest* request,
         return _device->drawIndexedPrimitive(_currentVertexBuffer->vertexDeclaration(), 
                                              _indexBuffer,
                                              _currentVertexBuffer, technique, (PrimitiveType)primitiveType(),
-                                             _primitiveCount, 0, _vertexOffset);
+                                             _primitiveCount, _indexOffset, _vertexOffset);
 
     }
     else
@@ -227,4 +291,268 @@ UIRenderer::render(uint32_t count, uint32_t vertexOffset)
     shader->renderMesh (Ctr::RenderRequest(material()->technique(), nullptr, nullptr, this));
 }
 
+
+void
+UIRenderer::beginFrame()
+{
+    _lastFrameStats = _frameStats;
+    memset(&_frameStats, 0, sizeof(_frameStats));
+}
+
+const UIRenderer::Stats&
+UIRenderer::stats()
+{
+    return _lastFrameStats;
+}
+
+void
+UIRenderer::resolveIndices()
+{
+    if (_pendingIndexCount > 0)
+    {
+        uint32_t* indices = &_commands[_pendingCommand].indices[_pendingFirstIndex];
+        for (size_t i = 0; i < _pendingIndexCount; i++)
+        {
+            indices[i] += _pendingBaseVertex;
+        }
+        _pendingIndexCount = 0;
+    }
+}
+
+UIRenderer::Allocation
+UIRenderer::allocate(const DrawState& state, IVertexDeclaration* declaration,
+                     uint32_t vertexCount, uint32_t indexCount,
+                     const float bounds[4])
+{
+    resolveIndices();
+    _frameStats.recorded++;
+
+    // Geometry outside the scissor is never drawn, so it can not overlap.
+    float clipped[4] = { bounds[0], bounds[1], bounds[2], bounds[3] };
+    if (state.scissorEnabled)
+    {
+        clipped[0] = std::max(clipped[0], float(state.scissor[0]));
+        clipped[1] = std::max(clipped[1], float(state.scissor[1]));
+        clipped[2] = std::min(clipped[2], float(state.scissor[0] + state.scissor[2]));
+        clipped[3] = std::min(clipped[3], float(state.scissor[1] + state.scissor[3]));
+    }
+
+    const bool indexed = indexCount > 0;
+    DrawCommand* command = nullptr;
+    for (size_t i = _commandCount; i > 0 && _commandCount - i < MaxMergeDistance; i--)
+    {
+        DrawCommand& candidate = _commands[i-1];
+        if (candidate.declaration == declaration &&
+            candidate.indices.empty() != indexed &&
+            candidate.vertexCount + vertexCount <= TransientVertices &&
+            candidate.indices.size() + indexCount <= TransientIndices &&
+            candidate.state == state)
+        {
+            command = &candidate;
+            break;
+        }
+
+        // Drawing ahead of an overlapping command would change the blend order.
+        if (overlaps(candidate.bounds, clipped))
+            break;
+    }
+
+    if (command)
+    {
+        command->bounds[0] = std::min(command->bounds[0], clipped[0]);
+        command->bounds[1] = std::min(command->bounds[1], clipped[1]);
+        command->bounds[2] = std::max(command->bounds[2], clipped[2]);
+        command->bounds[3] = std::max(command->bounds[3], clipped[3]);
+    }
+    else
+    {
+        if (_commandCount == _commands.size())
+            _commands.push_back(DrawCommand());
+        command = &_commands[_commandCount++];
+        command->state = state;
+        command->declaration = declaration;
+        memcpy(command->bounds, clipped, sizeof(clipped));
+        command->vertices.clear();
+        command->indices.clear();
+        command->vertexCount = 0;
+    }
+
+    const uint32_t stride = declaration->vertexStride();
+    const size_t vertexStart = command->vertices.size();
+    const size_t indexStart = command->indices.size();
+    command->vertices.resize(vertexStart + size_t(vertexCount) * stride);
+    command->indices.resize(indexStart + indexCount);
+
+    _pendingCommand = command - &_commands[0];
+    _pendingFirstIndex = indexStart;
+    _pendingIndexCount = indexCount;
+    _pendingBaseVertex = command->vertexCount;
+    command->vertexCount += vertexCount;
+
+    Allocation allocation;
+    allocation.vertices = &command->vertices[vertexStart];
+    allocation.indices = indexCount > 0 ? &command->indices[indexStart] : nullptr;
+    return allocation;
+}
+
+void
+UIRenderer::flush()
+{
+    resolveIndices();
+    if (_commandCount == 0)
+        return;
+
+    CTR_PROFILE_SCOPE("UIRenderer::flush");
+
+    _device->enableAlphaBlending();
+    _device->setupBlendPipeline(Ctr::BlendAlpha);
+
+    size_t first = 0;
+    while (first < _commandCount)
+    {
+        // The longest run of commands that fits one map of each buffer.
+        std::map<IVertexDeclaration*, uint32_t> vertexCounts;
+        uint32_t indexCount = 0;
+        size_t last = first;
+        for (; last < _commandCount; last++)
+        {
+            const DrawCommand& command = _commands[last];
+            uint32_t& vertices = vertexCounts[command.declaration];
+            if (last > first &&
+                (vertices + command.vertexCount > TransientVertices ||
+                 indexCount + command.indices.size() > TransientIndices))
+            {
+                break;
+            }
+            vertices += command.vertexCount;
+            indexCount += uint32_t(command.indices.size());
+        }
+
+        for (auto it = vertexCounts.begin(); it != vertexCounts.end(); it++)
+        {
+            if (it->second == 0)
+                continue;
+
+            IVertexDeclaration* declaration = it->first;
+            const uint32_t stride = declaration->vertexStride();
+            IVertexBuffer* buffer = vertexBuffer(declaration);
+            uint8_t* data = (uint8_t*)buffer->lock(it->second * stride);
+            if (!data)
+            {
+                LOG_CRITICAL("Failed to map UIRenderer vertex buffer");
+                continue;
+            }
+            _frameStats.maps++;
+
+            uint32_t baseVertex = 0;
+            for (size_t i = first; i < last; i++)
+            {
+                DrawCommand& command = _commands[i];
+                if (command.declaration != declaration || command.vertexCount == 0)
+                    continue;
+                memcpy(data + size_t(baseVertex) * stride, &command.vertices[0], command.vertices.size());
+                command.baseVertex = baseVertex;
+                baseVertex += command.vertexCount;
+            }
+            buffer->unlock();
+            _frameStats.vertices += baseVertex;
+        }
+
+        if (indexCount > 0)
+        {
+            if (uint32_t* data = (uint32_t*)_indexBuffer->lock(indexCount * sizeof(uint32_t)))
+            {
+                _frameStats.maps++;
+
+                uint32_t firstIndex = 0;
+                for (size_t i = first; i < last; i++)
+                {
+                    DrawCommand& command = _commands[i];
+                    if (command.indices.empty())
+                        continue;
+                    memcpy(data + firstIndex, &command.indices[0], command.indices.size() * sizeof(uint32_t));
+                    command.firstIndex = firstIndex;
+                    firstIndex += uint32_t(command.indices.size());
+                }
+                _indexBuffer->unlock();
+            }
+            else
+            {
+                LOG_CRITICAL("Failed to map UIRenderer index buffer");
+            }
+        }
+
+        for (size_t i = first; i < last; i++)
+        {
+            submit(_commands[i]);
+        }
+
+        first = last;
+    }
+
+    _device->disableAlphaBlending();
+    _device->setScissorEnabled(false);
+    _commandCount = 0;
+}
+
+void
+UIRenderer::submit(const DrawCommand& command)
+{
+    const DrawState& state = command.state;
+    if (!state.shader || command.vertexCount == 0)
+        return;
+
+    setShader(state.shader);
+    setVertexBuffer(vertexBuffer(command.declaration));
+    setPrimitiveType(Ctr::TriangleList);
+
+    if (state.texture)
+    {
+        const Ctr::GpuVariable* textureVariable = nullptr;
+        if (state.shader->getParameterByName("s_tex", textureVariable))
+            textureVariable->setTexture(state.texture);
+    }
+    for (uint32_t i = 0; i < DrawState::MaxVectors; i++)
+    {
+        const Ctr::GpuVariable* vectorVariable = nullptr;
+        if (state.vectorNames[i] && 
+            state.shader->getParameterByName(state.vectorNames[i], vectorVariable))
+        {
+            vectorVariable->setVector(&state.vectors[i].x);
+        }
+    }
+
+    if (state.scissorEnabled)
+    {
+        _device->setScissorEnabled(true);
+        _device->setScissorRect(state.scissor[0], state.scissor[1], state.scissor[2], state.scissor[3]);
+    }
+    else
+    {
+        _device->setScissorEnabled(false);
+        _device->setScissorRect(0, 0, _device->backbuffer()->width(), _device->backbuffer()->height());
+    }
+
+    Ctr::Matrix44f frameViewProj = _viewProj;
+    if (state.hasViewProj)
+        _viewProj = state.viewProj;
+
+    if (command.indices.empty())
+    {
+        setDrawIndexed(false);
+        render(command.vertexCount, command.baseVertex);
+    }
+    else
+    {
+        setDrawIndexed(true);
+        _indexOffset = command.firstIndex;
+        render(uint32_t(command.indices.size()), command.baseVertex);
+        _indexOffset = 0;
+        setDrawIndexed(false);
+    }
+    _frameStats.draws++;
+
+    _viewProj = frameViewProj;
+}
+
 }
@@ -50,6 +50,7 @@
 namespace Ctr
 {
 class IShader;
+class ITexture;
 class RenderPass;
 class IIndexBuffer;
 class IVertexBuffer;
@@ -80,6 +81,78 @@ class UIRenderer :
 
     void                       setViewProj(const Ctr::Matrix44f& ortho);
 
+    //--------------------------------------------------------------------
+    // Transient batching.
+    //
+    // Widgets record their geometry into frame storage with allocate().
+    // A draw is merged into the latest command with the same state unless
+    // a command recorded in between overlaps it, and flush() uploads every
+    // run of commands with one map per buffer before drawing them.
+    //--------------------------------------------------------------------
+    struct DrawState
+    {
+        DrawState();
+        bool                   operator == (const DrawState& other) const;
+
+        enum { MaxVectors = 2 };
+
+        const Ctr::IShader*    shader;
+        // Bound to s_tex.
+        const Ctr::ITexture*   texture;
+        bool                   scissorEnabled;
+        uint16_t               scissor[4];
+        // u_viewProj, the frame ortho when not set.
+        bool                   hasViewProj;
+        Ctr::Matrix44f         viewProj;
+        const char*            vectorNames[MaxVectors];
+        Ctr::Vector4f          vectors[MaxVectors];
+    };
+
+    struct Allocation
+    {
+        void*                  vertices;
+        // Relative to the first of the allocated vertices.
+        uint32_t*              indices;
+    };
+
+    // Counters for the last UI frame.
+    struct Stats
+    {
+        // allocate calls.
+        uint32_t               recorded;
+        uint32_t               draws;
+        uint32_t               maps;
+        uint32_t               vertices;
+    };
+
+    // Storage is valid until the next allocate or flush. bounds is the
+    // screen rectangle (x0, y0, x1, y1) covered by the geometry.
+    Allocation                 allocate(const DrawState& state, IVertexDeclaration* declaration,
+                                        uint32_t vertexCount, uint32_t indexCount,
+                                        const float bounds[4]);
+    void                       flush();
+
+    // Called at the start of each UI frame.
+    void                       beginFrame();
+    static const Stats&        stats();
+
+  protected:
+    struct DrawCommand
+    {
+        DrawState              state;
+        IVertexDeclaration*    declaration;
+        float                  bounds[4];
+        std::vector<uint8_t>   vertices;
+        std::vector<uint32_t>  indices;
+        uint32_t               vertexCount;
+        // Upload placement.
+        uint32_t               baseVertex;
+        uint32_t               firstIndex;
+    };
+
+    void                       resolveIndices();
+    void                       submit(const DrawCommand& command);
+
   protected:
     // Pipeline State.
     Ctr::IShader*              _currentShader;
@@ -87,6 +160,7 @@ class UIRenderer :
 
     // Buffer offset state.
     uint32_t                   _vertexOffset;
+    uint32_t                   _indexOffset;
     bool                       _drawIndexed;
     uint32_t                   _primitiveCount;
 
@@ -96,6 +170,17 @@ class UIRenderer :
 
     Ctr::Matrix44f             _viewProj;
 
+    // Commands are kept across frames to reuse their storage.
+    std::vector<DrawCommand>   _commands;
+    size_t                     _commandCount;
+    // Indices of the last allocation, rebased once written.
+    size_t                     _pendingCommand;
+    size_t                     _pendingFirstIndex;
+    size_t                     _pendingIndexCount;
+    uint32_t                   _pendingBaseVertex;
+
+    static Stats               _frameStats;
+    static Stats               _lastFrameStats;
     static UIRenderer*         _uiRenderer;
 };
 }
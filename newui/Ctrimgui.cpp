@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
+#include <unordered_map>
 
 #include <CtrLog.h>
 #include <CtrIDevice.h>
@@ -41,8 +42,11 @@
 #include <CtrIVertexBuffer.h>
 #include <CtrIIndexBuffer.h>
 #include <CtrUIRenderer.h>
+#if _WIN32 || _WIN64
 #include <CtrInputState.h>
+#endif
 #include <CtrTextureImage.h>
+#include <CtrProfiler.h>
 #include "Ctrimgui.h"
 #include "ocornut_imgui.h"
 #include "../nanovg/nanovg.h"
@@ -54,6 +58,7 @@
 #define USE_NANOVG_FONT 0
 #define IMGUI_CONFIG_MAX_FONTS 20
 #define MAX_TEMP_COORDS 100
+#define MAX_GLYPH_RUNS 1024
 #define NUM_CIRCLE_VERTS (8 * 4)
 
 static const int32_t BUTTON_HEIGHT = 20;
@@ -100,6 +105,25 @@ namespace
         return 6;
     }
 
+    // FNV-1a over the text and everything else that changes the layout.
+    uint64_t glyphRunKey(const char* _text, uint32_t _font, uint32_t _align, float _x, float _y)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const char* ch = _text; *ch; ++ch)
+        {
+            hash = (hash ^ uint8_t(*ch)) * 1099511628211ull;
+        }
+
+        uint32_t words[4] = { _font, _align, 0, 0 };
+        memcpy(&words[2], &_x, sizeof(float));
+        memcpy(&words[3], &_y, sizeof(float));
+        for (uint32_t ii = 0; ii < 4; ++ii)
+        {
+            hash = (hash ^ words[ii]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
     float sign(float px, float py, float ax, float ay, float bx, float by)
     {
         return (px - bx) * (ay - by) - (ax - bx) * (py - by);
@@ -360,7 +384,7 @@ namespace
 
 } // namespace
 
-static float getTextLength(stbtt_bakedchar* _chardata, const char* _text, uint32_t& _numVertices)
+static float getTextLength(const stbtt_bakedchar* _chardata, const char* _text, uint32_t& _numVertices)
 {
     float xpos = 0;
     float len = 0;
@@ -383,7 +407,7 @@ static float getTextLength(stbtt_bakedchar* _chardata, const char* _text, uint32
         else if (ch >= ' '
              &&  ch < 128)
         {
-            stbtt_bakedchar* b = _chardata + ch - ' ';
+            const stbtt_bakedchar* b = _chardata + ch - ' ';
             int32_t round_x = STBTT_ifloor( (xpos + b->xoff) + 0.5);
             len = round_x + b->x1 - b->x0 + 0.5f;
             xpos += b->xadvance;
@@ -781,6 +805,7 @@ struct Imgui
         m_char = _inputChar;
     }
 
+#if _WIN32 || _WIN64
     inline bool scanCodeToAscii(HKL keyboardLayout, uint8_t* keyboardState, uint32_t scancode, uint8_t& result)
     {
         UINT vk = MapVirtualKeyEx(scancode, 1, keyboardLayout);
@@ -792,6 +817,7 @@ struct Imgui
         }
         return false;
     }
+#endif
 
 
     void beginFrame(Ctr::InputState* inputState, int32_t _mx, int32_t _my, uint8_t _button, int32_t _scroll, uint16_t _width, uint16_t _height, char _inputChar, uint8_t _view)
@@ -818,6 +844,7 @@ struct Imgui
             memcpy(&ortho._m[0][0], &mvp[0][0], sizeof(ortho._m));
 
             Ctr::UIRenderer* uiRenderer = Ctr::UIRenderer::renderer();
+            uiRenderer->beginFrame();
             uiRenderer->setViewProj(ortho);
             Ctr::Viewport viewport(0.0f, 0.0f, float(_width), float(_height), 0.0f, 1.0f);
             m_Device->setViewport(&viewport);
@@ -828,6 +855,7 @@ struct Imgui
         // Update Inputs
         {
             updateInput(_mx, _my, _button, _scroll, _inputChar);
+#if _WIN32 || _WIN64
             static HKL keyboardLayout = GetKeyboardLayout(0);
             static uint8_t keyboardState[256];
             GetKeyboardState(keyboardState);
@@ -866,6 +894,7 @@ struct Imgui
                     m_KeyRepeatTimes[scanCode] += 1.0f / 60.0f;
                 }
             }
+#endif
         }
         m_hot = m_hotToBe;
         m_hotToBe = 0;
@@ -897,6 +926,7 @@ struct Imgui
 
         clearInput();
 
+        Ctr::UIRenderer::renderer()->flush();
         IMGUI_endFrame();
         // Reset Scissor Enabled.
         m_Device->setScissorEnabled(false);
@@ -1187,6 +1217,8 @@ struct Imgui
 
     void endArea()
     {
+        // Widget geometry is drawn underneath the area's vector graphics.
+        Ctr::UIRenderer::renderer()->flush();
         nvgResetScissor(m_nvg);
         nvgEndFrame(m_nvg);
     }
@@ -1599,7 +1631,6 @@ struct Imgui
     {
         const uint32_t id = getId();
         Area& area = getCurrentArea();
-        Ctr::UIRenderer* uiRenderer = Ctr::UIRenderer::renderer();
 
         int32_t xx;
         if (ImguiAlign::Left == _align)
@@ -1630,30 +1661,11 @@ struct Imgui
         const bool over = enabled && inRect(xx, yy, _width, _height);
         const bool res = buttonLogic(id, over);
 
-        const float lodEnabled[4] = { _lod, float(enabled), 0.0f, 0.0f };
-
-        screenQuad(xx, yy, _width, _height, _originBottomLeft);
-
-        // TODO. Primitive type!
-        const Ctr::GpuVariable* imageLodEnabledVariable = nullptr;
-        if (m_imageProgram->getParameterByName("u_imageLodEnabled", imageLodEnabledVariable))
-        {
-            imageLodEnabledVariable->setVector(lodEnabled);
-        }
-        const Ctr::GpuVariable* textureVariable = nullptr;
-        if (m_imageProgram->getParameterByName("s_tex", textureVariable))
-        {
-            textureVariable->setTexture(_image ? _image : m_missingTexture);
-        }
-
-        uiRenderer->device()->enableAlphaBlending();
-        uiRenderer->device()->setupBlendPipeline(Ctr::BlendAlpha);
-        uiRenderer->setShader(m_imageProgram);
-        setCurrentScissor();
-        uiRenderer->render(6, 0);
-        uiRenderer->device()->disableAlphaBlending();
-
+        Ctr::UIRenderer::DrawState state = currentDrawState(m_imageProgram, _image ? _image : m_missingTexture);
+        state.vectorNames[0] = "u_imageLodEnabled";
+        state.vectors[0] = Ctr::Vector4f(_lod, float(enabled), 0.0f, 0.0f);
 
+        screenQuad(state, xx, yy, _width, _height, _originBottomLeft);
 
         return res;
     }
@@ -1671,7 +1683,6 @@ struct Imgui
 //        BX_CHECK(_channel < 4, "Channel param must be from 0 to 3!");
         const uint32_t id = getId();
         Area& area = getCurrentArea();
-        Ctr::UIRenderer* uiRenderer = Ctr::UIRenderer::renderer();
 
         int32_t xx;
         if (ImguiAlign::Left == _align)
@@ -1702,39 +1713,16 @@ struct Imgui
         const bool over = enabled && inRect(xx, yy, _width, _height);
         const bool res = buttonLogic(id, over);
 
-        screenQuad(xx, yy, _width, _height);
-
-        const float lodEnabled[4] = { _lod, float(enabled), 0.0f, 0.0f };
-        const Ctr::GpuVariable* imageLodEnabledVariable = nullptr;
-        if (m_imageSwizzProgram->getParameterByName("u_imageLodEnabled", imageLodEnabledVariable))
-        {
-            imageLodEnabledVariable->setVector(lodEnabled);
-        }
-
-
-        const Ctr::GpuVariable* imageSwizzleVariable = nullptr;
         float swizz[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
         swizz[_channel] = 1.0f;
 
-        if (m_imageSwizzProgram->getParameterByName("u_imageSwizzle", imageSwizzleVariable))
-        {
-            imageSwizzleVariable->setVector(swizz);
-        }
+        Ctr::UIRenderer::DrawState state = currentDrawState(m_imageSwizzProgram, _image ? _image : m_missingTexture);
+        state.vectorNames[0] = "u_imageLodEnabled";
+        state.vectors[0] = Ctr::Vector4f(_lod, float(enabled), 0.0f, 0.0f);
+        state.vectorNames[1] = "u_imageSwizzle";
+        state.vectors[1] = Ctr::Vector4f(swizz[0], swizz[1], swizz[2], swizz[3]);
 
-        const Ctr::GpuVariable* textureVariable = nullptr;
-        if (m_imageSwizzProgram->getParameterByName("s_tex", textureVariable))
-        {
-            textureVariable->setTexture(_image ? _image : m_missingTexture);
-        }
-
-        uiRenderer->device()->enableAlphaBlending();
-        uiRenderer->device()->setupBlendPipeline(Ctr::BlendAlpha);
-
-        uiRenderer->setShader(m_imageSwizzProgram);
-        setCurrentScissor();
-        // Draw screen quad.
-        uiRenderer->render(6, 0);
-        uiRenderer->device()->disableAlphaBlending();
+        screenQuad(state, xx, yy, _width, _height);
 
         return res;
     }
@@ -1752,168 +1740,134 @@ struct Imgui
         const uint32_t numVertices = 14;
         const uint32_t numIndices  = 36;
 
-        {
-            Ctr::UIRenderer* uiRenderer = Ctr::UIRenderer::renderer();
-            Ctr::IVertexBuffer* vb = uiRenderer->vertexBuffer(PosNormalVertex::ms_decl);
-            PosNormalVertex* vertex = (PosNormalVertex*)vb->lock(numVertices * sizeof(PosNormalVertex));
-
-            Ctr::IIndexBuffer * ib = uiRenderer->indexBuffer();
-            uint32_t* indices = (uint32_t*)ib->lock(numIndices * sizeof(uint32_t));
-
-            if (_cross)
-            {
-                vertex->set(0.0f, 0.5f, 0.0f, -1.0f,  1.0f, -1.0f); ++vertex;
-                vertex->set(0.0f, 1.0f, 0.0f, -1.0f, -1.0f, -1.0f); ++vertex;
-
-                vertex->set(0.5f, 0.0f, 0.0f, -1.0f,  1.0f, -1.0f); ++vertex;
-                vertex->set(0.5f, 0.5f, 0.0f, -1.0f,  1.0f,  1.0f); ++vertex;
-                vertex->set(0.5f, 1.0f, 0.0f, -1.0f, -1.0f,  1.0f); ++vertex;
-                vertex->set(0.5f, 1.5f, 0.0f, -1.0f, -1.0f, -1.0f); ++vertex;
-
-                vertex->set(1.0f, 0.0f, 0.0f,  1.0f,  1.0f, -1.0f); ++vertex;
-                vertex->set(1.0f, 0.5f, 0.0f,  1.0f,  1.0f,  1.0f); ++vertex;
-                vertex->set(1.0f, 1.0f, 0.0f,  1.0f, -1.0f,  1.0f); ++vertex;
-                vertex->set(1.0f, 1.5f, 0.0f,  1.0f, -1.0f, -1.0f); ++vertex;
-
-                vertex->set(1.5f, 0.5f, 0.0f,  1.0f,  1.0f, -1.0f); ++vertex;
-                vertex->set(1.5f, 1.0f, 0.0f,  1.0f, -1.0f, -1.0f); ++vertex;
-
-                vertex->set(2.0f, 0.5f, 0.0f, -1.0f,  1.0f, -1.0f); ++vertex;
-                vertex->set(2.0f, 1.0f, 0.0f, -1.0f, -1.0f, -1.0f); ++vertex;
-
-                indices += addQuad(indices,  0,  3,  4,  1);
-                indices += addQuad(indices,  2,  6,  7,  3);
-                indices += addQuad(indices,  3,  7,  8,  4);
-                indices += addQuad(indices,  4,  8,  9,  5);
-                indices += addQuad(indices,  7, 10, 11,  8);
-                indices += addQuad(indices, 10, 12, 13, 11);
-            }
-            else
-            {
-                vertex->set(0.0f, 0.25f, 0.0f, -1.0f,  1.0f, -1.0f); ++vertex;
-                vertex->set(0.0f, 0.75f, 0.0f, -1.0f, -1.0f, -1.0f); ++vertex;
-
-                vertex->set(0.5f, 0.00f, 0.0f, -1.0f,  1.0f,  1.0f); ++vertex;
-                vertex->set(0.5f, 0.50f, 0.0f, -1.0f, -1.0f,  1.0f); ++vertex;
-                vertex->set(0.5f, 1.00f, 0.0f,  1.0f, -1.0f, -1.0f); ++vertex;
-
-                vertex->set(1.0f, 0.25f, 0.0f,  1.0f,  1.0f,  1.0f); ++vertex;
-                vertex->set(1.0f, 0.75f, 0.0f,  1.0f, -1.0f,  1.0f); ++vertex;
-
-                vertex->set(1.0f, 0.25f, 0.0f,  1.0f,  1.0f,  1.0f); ++vertex;
-                vertex->set(1.0f, 0.75f, 0.0f,  1.0f, -1.0f,  1.0f); ++vertex;
-
-                vertex->set(1.5f, 0.00f, 0.0f, -1.0f,  1.0f,  1.0f); ++vertex;
-                vertex->set(1.5f, 0.50f, 0.0f,  1.0f,  1.0f, -1.0f); ++vertex;
-                vertex->set(1.5f, 1.00f, 0.0f,  1.0f, -1.0f, -1.0f); ++vertex;
+        const uint32_t id = getId();
 
-                vertex->set(2.0f, 0.25f, 0.0f, -1.0f,  1.0f, -1.0f); ++vertex;
-                vertex->set(2.0f, 0.75f, 0.0f, -1.0f, -1.0f, -1.0f); ++vertex;
+        Area& area = getCurrentArea();
+        int32_t xx;
+        int32_t width;
+        if (ImguiAlign::Left == _align)
+        {
+            xx = area.m_contentX + SCROLL_AREA_PADDING;
+            width = area.m_widgetW;
+        }
+        else if (ImguiAlign::LeftIndented == _align
+             ||  ImguiAlign::Right        == _align)
+        {
+            xx = area.m_widgetX;
+            width = area.m_widgetW;
+        }
+        else //if (ImguiAlign::Center         == _align
+             //||  ImguiAlign::CenterIndented == _align).
+        {
+            xx = area.m_widgetX;
+            width = area.m_widgetW - (area.m_widgetX-area.m_scissorX);
+        }
 
-                indices += addQuad(indices,  0,  2,  3,  1);
-                indices += addQuad(indices,  1,  3,  6,  4);
-                indices += addQuad(indices,  2,  5,  6,  3);
-                indices += addQuad(indices,  7,  9, 12, 10);
-                indices += addQuad(indices,  7, 10, 11,  8);
-                indices += addQuad(indices, 10, 12, 13, 11);
-            }
-            vb->unlock();
-            uiRenderer->indexBuffer()->unlock();
+        const uint32_t height = _cross ? (width*3)/4 : (width/2);
+        const int32_t yy = area.m_widgetY;
+        area.m_widgetY += height + DEFAULT_SPACING;
 
-            const uint32_t id = getId();
+        const bool enabled = _enabled && isEnabled(m_areaId);
+        const bool over = enabled && inRect(xx, yy, width, height);
+        const bool res = buttonLogic(id, over);
 
-            Area& area = getCurrentArea();
-            int32_t xx;
-            int32_t width;
-            if (ImguiAlign::Left == _align)
-            {
-                xx = area.m_contentX + SCROLL_AREA_PADDING;
-                width = area.m_widgetW;
-            }
-            else if (ImguiAlign::LeftIndented == _align
-                 ||  ImguiAlign::Right        == _align)
-            {
-                xx = area.m_widgetX;
-                width = area.m_widgetW;
-            }
-            else //if (ImguiAlign::Center         == _align
-                 //||  ImguiAlign::CenterIndented == _align).
-            {
-                xx = area.m_widgetX;
-                width = area.m_widgetW - (area.m_widgetX-area.m_scissorX);
-            }
+        const float scale = float(width/2)+0.25f;
 
-            const uint32_t height = _cross ? (width*3)/4 : (width/2);
-            const int32_t yy = area.m_widgetY;
-            area.m_widgetY += height + DEFAULT_SPACING;
+        Ctr::Matrix44f srt;
+        Ctr::Matrix44f projection;
+        Ctr::Matrix44f transform;
 
-            const bool enabled = _enabled && isEnabled(m_areaId);
-            const bool over = enabled && inRect(xx, yy, width, height);
-            const bool res = buttonLogic(id, over);
+        const float L = 0.0f;
+        const float R = float(m_Device->backbuffer()->width());
+        const float B = float(m_Device->backbuffer()->height());
+        const float T = 0.0f;
+        const float ortho[4][4] =
+        {
+            { 2.0f / (R - L), 0.0f, 0.0f, 0.0f },
+            { 0.0f, 2.0f / (T - B), 0.0f, 0.0f, },
+            { 0.0f, 0.0f, 0.5f, 0.0f },
+            { (R + L) / (L - R), (T + B) / (B - T), 0.5f, 1.0f },
+        };
+        memcpy(&projection._m[0][0], &ortho[0][0], sizeof(float) * 16); 
 
-            const float scale = float(width/2)+0.25f;
+        Ctr::Matrix44f t;
+        Ctr::Matrix44f s;
 
-            Ctr::Matrix44f srt;
-            Ctr::Matrix44f projection;
-            Ctr::Matrix44f transform;
+        s.scaling(Ctr::Vector3f(scale, scale, 1.0f));
+        t.setTranslation(Ctr::Vector3f(float(xx),float(yy),0));
+        transform = s * t * projection;
 
-            const float L = 0.0f;
-            const float R = float(m_Device->backbuffer()->width());
-            const float B = float(m_Device->backbuffer()->height());
-            const float T = 0.0f;
-            const float ortho[4][4] =
-            {
-                { 2.0f / (R - L), 0.0f, 0.0f, 0.0f },
-                { 0.0f, 2.0f / (T - B), 0.0f, 0.0f, },
-                { 0.0f, 0.0f, 0.5f, 0.0f },
-                { (R + L) / (L - R), (T + B) / (B - T), 0.5f, 1.0f },
-            };
-            memcpy(&projection._m[0][0], &ortho[0][0], sizeof(float) * 16); 
+        Ctr::UIRenderer::DrawState state = currentDrawState(m_cubeMapProgram, _cubemap);
+        state.hasViewProj = true;
+        state.viewProj = transform;
+        state.vectorNames[0] = "u_imageLodEnabled";
+        state.vectors[0] = Ctr::Vector4f(_lod, float(enabled), 0.0f, 0.0f);
 
-            Ctr::Matrix44f t;
-            Ctr::Matrix44f s;
+        const float bounds[4] = { float(xx), float(yy), float(xx + width), float(yy + height) };
+        Ctr::UIRenderer::Allocation allocation = 
+            Ctr::UIRenderer::renderer()->allocate(state, PosNormalVertex::ms_decl, numVertices, numIndices, bounds);
+        PosNormalVertex* vertex = (PosNormalVertex*)allocation.vertices;
+        uint32_t* indices = allocation.indices;
 
-            s.scaling(Ctr::Vector3f(scale, scale, 1.0f));
-            t.setTranslation(Ctr::Vector3f(float(xx),float(yy),0));
-            transform = s * t * projection;
-
-            uiRenderer->setViewProj(transform);
+        if (_cross)
+        {
+            vertex->set(0.0f, 0.5f, 0.0f, -1.0f,  1.0f, -1.0f); ++vertex;
+            vertex->set(0.0f, 1.0f, 0.0f, -1.0f, -1.0f, -1.0f); ++vertex;
 
+            vertex->set(0.5f, 0.0f, 0.0f, -1.0f,  1.0f, -1.0f); ++vertex;
+            vertex->set(0.5f, 0.5f, 0.0f, -1.0f,  1.0f,  1.0f); ++vertex;
+            vertex->set(0.5f, 1.0f, 0.0f, -1.0f, -1.0f,  1.0f); ++vertex;
+            vertex->set(0.5f, 1.5f, 0.0f, -1.0f, -1.0f, -1.0f); ++vertex;
 
-            const float lodEnabled[4] = { _lod, float(enabled), 0.0f, 0.0f };
-            const Ctr::GpuVariable* imageLodEnabledVariable = nullptr;
-            if (m_cubeMapProgram->getParameterByName("u_imageLodEnabled", imageLodEnabledVariable))
-            {
-                imageLodEnabledVariable->setVector(lodEnabled);
-            }
+            vertex->set(1.0f, 0.0f, 0.0f,  1.0f,  1.0f, -1.0f); ++vertex;
+            vertex->set(1.0f, 0.5f, 0.0f,  1.0f,  1.0f,  1.0f); ++vertex;
+            vertex->set(1.0f, 1.0f, 0.0f,  1.0f, -1.0f,  1.0f); ++vertex;
+            vertex->set(1.0f, 1.5f, 0.0f,  1.0f, -1.0f, -1.0f); ++vertex;
 
+            vertex->set(1.5f, 0.5f, 0.0f,  1.0f,  1.0f, -1.0f); ++vertex;
+            vertex->set(1.5f, 1.0f, 0.0f,  1.0f, -1.0f, -1.0f); ++vertex;
 
-            const Ctr::GpuVariable* textureVariable = nullptr;
-            if (m_cubeMapProgram->getParameterByName("s_tex", textureVariable))
-            {
-                textureVariable->setTexture(_cubemap);
-            }
+            vertex->set(2.0f, 0.5f, 0.0f, -1.0f,  1.0f, -1.0f); ++vertex;
+            vertex->set(2.0f, 1.0f, 0.0f, -1.0f, -1.0f, -1.0f); ++vertex;
 
+            indices += addQuad(indices,  0,  3,  4,  1);
+            indices += addQuad(indices,  2,  6,  7,  3);
+            indices += addQuad(indices,  3,  7,  8,  4);
+            indices += addQuad(indices,  4,  8,  9,  5);
+            indices += addQuad(indices,  7, 10, 11,  8);
+            indices += addQuad(indices, 10, 12, 13, 11);
+        }
+        else
+        {
+            vertex->set(0.0f, 0.25f, 0.0f, -1.0f,  1.0f, -1.0f); ++vertex;
+            vertex->set(0.0f, 0.75f, 0.0f, -1.0f, -1.0f, -1.0f); ++vertex;
 
+            vertex->set(0.5f, 0.00f, 0.0f, -1.0f,  1.0f,  1.0f); ++vertex;
+            vertex->set(0.5f, 0.50f, 0.0f, -1.0f, -1.0f,  1.0f); ++vertex;
+            vertex->set(0.5f, 1.00f, 0.0f,  1.0f, -1.0f, -1.0f); ++vertex;
 
-            uiRenderer->setShader(m_cubeMapProgram);
-            uiRenderer->setVertexBuffer(vb);
-            uiRenderer->setDrawIndexed(true);
-            
+            vertex->set(1.0f, 0.25f, 0.0f,  1.0f,  1.0f,  1.0f); ++vertex;
+            vertex->set(1.0f, 0.75f, 0.0f,  1.0f, -1.0f,  1.0f); ++vertex;
 
-            uiRenderer->device()->enableAlphaBlending();
-            uiRenderer->device()->setupBlendPipeline(Ctr::BlendAlpha);
+            vertex->set(1.0f, 0.25f, 0.0f,  1.0f,  1.0f,  1.0f); ++vertex;
+            vertex->set(1.0f, 0.75f, 0.0f,  1.0f, -1.0f,  1.0f); ++vertex;
 
-            setCurrentScissor();
-            uiRenderer->render(numIndices, 0);
-            uiRenderer->setDrawIndexed(false);
+            vertex->set(1.5f, 0.00f, 0.0f, -1.0f,  1.0f,  1.0f); ++vertex;
+            vertex->set(1.5f, 0.50f, 0.0f,  1.0f,  1.0f, -1.0f); ++vertex;
+            vertex->set(1.5f, 1.00f, 0.0f,  1.0f, -1.0f, -1.0f); ++vertex;
 
-            uiRenderer->device()->disableAlphaBlending();
-            uiRenderer->setViewProj(projection);
+            vertex->set(2.0f, 0.25f, 0.0f, -1.0f,  1.0f, -1.0f); ++vertex;
+            vertex->set(2.0f, 0.75f, 0.0f, -1.0f, -1.0f, -1.0f); ++vertex;
 
-            return res;
+            indices += addQuad(indices,  0,  2,  3,  1);
+            indices += addQuad(indices,  1,  3,  6,  4);
+            indices += addQuad(indices,  2,  5,  6,  3);
+            indices += addQuad(indices,  7,  9, 12, 10);
+            indices += addQuad(indices,  7, 10, 11,  8);
+            indices += addQuad(indices, 10, 12, 13, 11);
         }
-        return false;
+
+        return res;
     }
 
     bool collapse(const char* _text, const char* _subtext, bool _checked, bool _enabled)
@@ -2319,9 +2273,20 @@ struct Imgui
 
         uint32_t numVertices = _numCoords*6 + (_numCoords-2)*3;
         {
-            Ctr::UIRenderer* uiRenderer = Ctr::UIRenderer::renderer();
-            Ctr::IVertexBuffer* vb = uiRenderer->vertexBuffer(PosColorVertex::ms_decl);
-            PosColorVertex* vertex = (PosColorVertex*)vb->lock(numVertices * sizeof(PosColorVertex));
+            // The expanded outline bounds the polygon.
+            float bounds[4] = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+            for (uint32_t ii = 0; ii < _numCoords; ++ii)
+            {
+                bounds[0] = std::min(bounds[0], std::min(_coords[ii*2+0], m_tempCoords[ii*2+0]));
+                bounds[1] = std::min(bounds[1], std::min(_coords[ii*2+1], m_tempCoords[ii*2+1]));
+                bounds[2] = std::max(bounds[2], std::max(_coords[ii*2+0], m_tempCoords[ii*2+0]));
+                bounds[3] = std::max(bounds[3], std::max(_coords[ii*2+1], m_tempCoords[ii*2+1]));
+            }
+
+            Ctr::UIRenderer::Allocation allocation = 
+                Ctr::UIRenderer::renderer()->allocate(currentDrawState(m_colorProgram), PosColorVertex::ms_decl, 
+                                                      numVertices, 0, bounds);
+            PosColorVertex* vertex = (PosColorVertex*)allocation.vertices;
             uint32_t trans = _abgr&0xffffff;
 
             for (uint32_t ii = 0, jj = _numCoords-1; ii < _numCoords; jj = ii++)
@@ -2374,16 +2339,6 @@ struct Imgui
                 vertex->m_abgr = _abgr;
                 ++vertex;
             }
-            vb->unlock();
-
-            uiRenderer->setVertexBuffer(vb);
-            uiRenderer->device()->enableAlphaBlending();
-            uiRenderer->device()->setupBlendPipeline(Ctr::BlendAlpha);
-
-            uiRenderer->setShader(m_colorProgram);
-            setCurrentScissor();
-            uiRenderer->render(numVertices, 0);
-            uiRenderer->device()->disableAlphaBlending();
         }
     }
 
@@ -2544,9 +2499,9 @@ struct Imgui
     }
 
 
-    void getBakedQuad(stbtt_bakedchar* _chardata, int32_t char_index, float* _xpos, float* _ypos, stbtt_aligned_quad* _quad)
+    void getBakedQuad(const stbtt_bakedchar* _chardata, int32_t char_index, float* _xpos, float* _ypos, stbtt_aligned_quad* _quad)
     {
-        stbtt_bakedchar* b = _chardata + char_index;
+        const stbtt_bakedchar* b = _chardata + char_index;
         int32_t round_x = STBTT_ifloor(*_xpos + b->xoff);
         int32_t round_y = STBTT_ifloor(*_ypos + b->yoff);
 
@@ -2563,6 +2518,20 @@ struct Imgui
         *_xpos += b->xadvance;
     }
 
+    // Laid out label, positions are relative to the whole pixel origin it
+    // was drawn at and the color is applied when it is emitted.
+    struct GlyphRun
+    {
+        uint64_t                      m_key;
+        std::string                   m_text;
+        float                         m_bounds[4];
+        std::vector<PosColorUvVertex> m_vertices;
+    };
+
+    // Most recently drawn first.
+    typedef std::list<GlyphRun> GlyphRunList;
+    typedef std::unordered_map<uint64_t, GlyphRunList::iterator> GlyphRunLookup;
+
     void drawText(int32_t _x, int32_t _y, ImguiTextAlign::Enum _align, const char* _text, uint32_t _abgr)
     {
         drawText( (float)_x, (float)_y, _text, _align, _abgr);
@@ -2576,118 +2545,160 @@ struct Imgui
             return;
         }
 
+        // Runs are laid out against the fractional part of the origin, so
+        // labels drawn at whole pixels share an entry wherever they move.
+        const float originX = floorf(_x);
+        const float originY = floorf(_y);
+        const GlyphRun& run = glyphRun(_text, _x - originX, _y - originY, _align);
+        const uint32_t numVertices = uint32_t(run.m_vertices.size());
+        if (numVertices == 0)
+        {
+            return;
+        }
 
-        uint32_t numVertices = 0;
-        if (_align == ImguiTextAlign::Center)
+        const float bounds[4] = { originX + run.m_bounds[0], originY + run.m_bounds[1],
+                                  originX + run.m_bounds[2], originY + run.m_bounds[3] };
+
+        Ctr::UIRenderer::Allocation allocation = 
+            Ctr::UIRenderer::renderer()->allocate(currentDrawState(m_textureProgram, m_fonts[m_currentFontIdx-1].m_texture),
+                                                  PosColorUvVertex::ms_decl, numVertices, 0, bounds);
+        PosColorUvVertex* vertex = (PosColorUvVertex*)allocation.vertices;
+        for (uint32_t ii = 0; ii < numVertices; ++ii, ++vertex)
         {
-            _x -= getTextLength(m_fonts[m_currentFontIdx-1].m_cdata, _text, numVertices) / 2;
+            const PosColorUvVertex& source = run.m_vertices[ii];
+            vertex->m_x = originX + source.m_x;
+            vertex->m_y = originY + source.m_y;
+            vertex->m_u = source.m_u;
+            vertex->m_v = source.m_v;
+            vertex->m_abgr = _abgr;
         }
-        else if (_align == ImguiTextAlign::Right)
+    }
+
+    const GlyphRun& glyphRun(const char* _text, float _x, float _y, ImguiTextAlign::Enum _align)
+    {
+        const uint64_t key = glyphRunKey(_text, m_currentFontIdx, _align, _x, _y);
+
+        GlyphRunLookup::iterator it = m_glyphRunLookup.find(key);
+        if (it != m_glyphRunLookup.end())
         {
-            _x -= getTextLength(m_fonts[m_currentFontIdx - 1].m_cdata, _text, numVertices);
+            GlyphRunList::iterator run = it->second;
+            if (run->m_text == _text)
+            {
+                m_glyphRuns.splice(m_glyphRuns.begin(), m_glyphRuns, run);
+                return *run;
+            }
+
+            // Hash collision, lay the new text out in its place.
+            m_glyphRuns.erase(run);
+            m_glyphRunLookup.erase(it);
         }
-        else // just count vertices
+
+        if (m_glyphRuns.size() >= MAX_GLYPH_RUNS)
         {
-            getTextLength(m_fonts[m_currentFontIdx - 1].m_cdata, _text, numVertices);
+            m_glyphRunLookup.erase(m_glyphRuns.back().m_key);
+            m_glyphRuns.pop_back();
         }
 
+        m_glyphRuns.push_front(GlyphRun());
+        GlyphRun& run = m_glyphRuns.front();
+        run.m_key = key;
+        run.m_text = _text;
+        layoutText(run, _x, _y, _align);
+        m_glyphRunLookup[key] = m_glyphRuns.begin();
+        return run;
+    }
+
+    void layoutText(GlyphRun& _run, float _x, float _y, ImguiTextAlign::Enum _align)
+    {
+        const Font& font = m_fonts[m_currentFontIdx-1];
+        const char* text = _run.m_text.c_str();
+
+        uint32_t numVertices = 0;
+        const float length = getTextLength(font.m_cdata, text, numVertices);
+        if (_align == ImguiTextAlign::Center)
         {
-            Ctr::UIRenderer* uiRenderer = Ctr::UIRenderer::renderer();
-            Ctr::IVertexBuffer* vb = uiRenderer->vertexBuffer(PosColorUvVertex::ms_decl);
-            PosColorUvVertex* vertex = (PosColorUvVertex*)vb->lock(numVertices * sizeof(PosColorUvVertex));
+            _x -= length / 2;
+        }
+        else if (_align == ImguiTextAlign::Right)
+        {
+            _x -= length;
+        }
+
+        // Baked glyphs stay within a font size of the baseline.
+        _run.m_bounds[0] = _x - font.m_size;
+        _run.m_bounds[1] = _y - font.m_size;
+        _run.m_bounds[2] = _x + length + font.m_size;
+        _run.m_bounds[3] = _y + font.m_size;
+
+        _run.m_vertices.resize(numVertices);
+        PosColorUvVertex* vertex = _run.m_vertices.empty() ? NULL : &_run.m_vertices[0];
 
-            const float ox = _x;
+        const float ox = _x;
 
-            while (*_text)
+        while (*text)
+        {
+            int32_t ch = (uint8_t)*text;
+            if (ch == '\t')
             {
-                int32_t ch = (uint8_t)*_text;
-                if (ch == '\t')
+                for (int32_t i = 0; i < 4; ++i)
                 {
-                    for (int32_t i = 0; i < 4; ++i)
+                    if (_x < s_tabStops[i] + ox)
                     {
-                        if (_x < s_tabStops[i] + ox)
-                        {
-                            _x = s_tabStops[i] + ox;
-                            break;
-                        }
+                        _x = s_tabStops[i] + ox;
+                        break;
                     }
                 }
-                else if (ch >= ' '
-                     &&  ch < 128)
-                {
-                    stbtt_aligned_quad quad;
-                    getBakedQuad(m_fonts[m_currentFontIdx-1].m_cdata, ch - 32, &_x, &_y, &quad);
-
-                    vertex->m_x = quad.x0;
-                    vertex->m_y = quad.y0;
-                    vertex->m_u = quad.s0;
-                    vertex->m_v = quad.t0;
-                    vertex->m_abgr = _abgr;
-                    ++vertex;
-
-                    vertex->m_x = quad.x1;
-                    vertex->m_y = quad.y1;
-                    vertex->m_u = quad.s1;
-                    vertex->m_v = quad.t1;
-                    vertex->m_abgr = _abgr;
-                    ++vertex;
-
-                    vertex->m_x = quad.x1;
-                    vertex->m_y = quad.y0;
-                    vertex->m_u = quad.s1;
-                    vertex->m_v = quad.t0;
-                    vertex->m_abgr = _abgr;
-                    ++vertex;
-
-                    vertex->m_x = quad.x0;
-                    vertex->m_y = quad.y0;
-                    vertex->m_u = quad.s0;
-                    vertex->m_v = quad.t0;
-                    vertex->m_abgr = _abgr;
-                    ++vertex;
-
-                    vertex->m_x = quad.x0;
-                    vertex->m_y = quad.y1;
-                    vertex->m_u = quad.s0;
-                    vertex->m_v = quad.t1;
-                    vertex->m_abgr = _abgr;
-                    ++vertex;
-
-                    vertex->m_x = quad.x1;
-                    vertex->m_y = quad.y1;
-                    vertex->m_u = quad.s1;
-                    vertex->m_v = quad.t1;
-                    vertex->m_abgr = _abgr;
-                    ++vertex;
-                }
-
-                ++_text;
             }
-            vb->unlock();
-
-            const Ctr::GpuVariable* textureVariable = nullptr;
-            if (m_textureProgram->getParameterByName("s_tex", textureVariable))
+            else if (ch >= ' '
+                 &&  ch < 128)
             {
-                textureVariable->setTexture(m_fonts[m_currentFontIdx-1].m_texture);
+                stbtt_aligned_quad quad;
+                getBakedQuad(font.m_cdata, ch - 32, &_x, &_y, &quad);
+
+                vertex->m_x = quad.x0;
+                vertex->m_y = quad.y0;
+                vertex->m_u = quad.s0;
+                vertex->m_v = quad.t0;
+                ++vertex;
+
+                vertex->m_x = quad.x1;
+                vertex->m_y = quad.y1;
+                vertex->m_u = quad.s1;
+                vertex->m_v = quad.t1;
+                ++vertex;
+
+                vertex->m_x = quad.x1;
+                vertex->m_y = quad.y0;
+                vertex->m_u = quad.s1;
+                vertex->m_v = quad.t0;
+                ++vertex;
+
+                vertex->m_x = quad.x0;
+                vertex->m_y = quad.y0;
+                vertex->m_u = quad.s0;
+                vertex->m_v = quad.t0;
+                ++vertex;
+
+                vertex->m_x = quad.x0;
+                vertex->m_y = quad.y1;
+                vertex->m_u = quad.s0;
+                vertex->m_v = quad.t1;
+                ++vertex;
+
+                vertex->m_x = quad.x1;
+                vertex->m_y = quad.y1;
+                vertex->m_u = quad.s1;
+                vertex->m_v = quad.t1;
+                ++vertex;
             }
 
-            uiRenderer->setVertexBuffer(vb);
-            uiRenderer->device()->enableAlphaBlending();
-            uiRenderer->device()->setupBlendPipeline(Ctr::BlendAlpha);
-            uiRenderer->setShader(m_textureProgram);
-            setCurrentScissor();
-            uiRenderer->render(numVertices, 0);
-            uiRenderer->device()->disableAlphaBlending();
+            ++text;
         }
     }
 
-    void screenQuad(int32_t _x, int32_t _y, int32_t _width, uint32_t _height, bool _originBottomLeft = false)
+    void screenQuad(const Ctr::UIRenderer::DrawState& _state, int32_t _x, int32_t _y, int32_t _width, uint32_t _height, bool _originBottomLeft = false)
     {
         {
-            Ctr::UIRenderer* uiRenderer = Ctr::UIRenderer::renderer();
-            Ctr::IVertexBuffer* vb = uiRenderer->vertexBuffer(PosUvVertex::ms_decl);            
-            PosUvVertex* vertex = (PosUvVertex*)vb->lock(6 * sizeof(PosUvVertex));
-
             const float widthf  = float(_width);
             const float heightf = float(_height);
 
@@ -2696,6 +2707,11 @@ struct Imgui
             const float maxx = minx+widthf;
             const float maxy = miny+heightf;
 
+            const float bounds[4] = { minx, miny, maxx, maxy };
+            Ctr::UIRenderer::Allocation allocation = 
+                Ctr::UIRenderer::renderer()->allocate(_state, PosUvVertex::ms_decl, 6, 0, bounds);
+            PosUvVertex* vertex = (PosUvVertex*)allocation.vertices;
+
             const float texelHalfW = m_halfTexel/widthf;
             const float texelHalfH = m_halfTexel/heightf;
             const float minu = texelHalfW;
@@ -2732,9 +2748,6 @@ struct Imgui
             vertex[5].m_y = miny;
             vertex[5].m_u = minu;
             vertex[5].m_v = minv;
-
-            vb->unlock();
-            uiRenderer->setVertexBuffer(vb);
         }
     }
 
@@ -3013,6 +3026,24 @@ struct Imgui
         return m_areas[m_areaId];
     }
 
+    inline Ctr::UIRenderer::DrawState currentDrawState(const Ctr::IShader* _shader, const Ctr::ITexture* _texture = nullptr)
+    {
+        Ctr::UIRenderer::DrawState state;
+        state.shader = _shader;
+        state.texture = _texture;
+
+        const Area& area = getCurrentArea();
+        if (area.m_scissorEnabled)
+        {
+            state.scissorEnabled = true;
+            state.scissor[0] = uint16_t(IMGUI_MAX(0, area.m_scissorX));
+            state.scissor[1] = uint16_t(IMGUI_MAX(0, area.m_scissorY-1));
+            state.scissor[2] = uint16_t(area.m_scissorWidth);
+            state.scissor[3] = uint16_t(area.m_scissorHeight+1);
+        }
+        return state;
+    }
+
     inline void setCurrentScissor()
     {
         const Area& area = getCurrentArea();
@@ -3124,6 +3155,9 @@ struct Imgui
         uint32_t        m_id;
     };
 
+    GlyphRunList   m_glyphRuns;
+    GlyphRunLookup m_glyphRunLookup;
+
     ImguiFontReference m_currentFontIdx;
     ImguiFontReference m_fontHandle[IMGUI_CONFIG_MAX_FONTS];
     Font m_fonts[IMGUI_CONFIG_MAX_FONTS];
@@ -3176,6 +3210,7 @@ void imguiBeginFrame(Ctr::InputState* inputState, int32_t _mx, int32_t _my, uint
 
 void imguiEndFrame()
 {
+    CTR_PROFILE_SCOPE("imguiEndFrame");
     s_imgui.endFrame();
 
 }
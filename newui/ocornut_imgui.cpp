@@ -20,7 +20,9 @@
 #include <CtrShaderMgr.h>
 #include <CtrUIRenderer.h>
 #include <CtrVertexDeclarationMgr.h>
+#if _WIN32 || _WIN64
 #include <CtrInputState.h>
+#endif
 #include <CtrApplication.h>
 
 static void imguiRender(ImDrawList** const _lists, int cmd_lists_count);
@@ -117,6 +119,7 @@ struct OcornutImguiContext
         io.DeltaTime = 1.0f / 60.0f;
 
         // Keyboard mapping. ImGui will use those indices to peek into the io.KeyDown[] array that we will update during the application lifetime.
+#if _WIN32 || _WIN64
         io.KeyMap[ImGuiKey_Tab] = DIK_TAB;                              
         io.KeyMap[ImGuiKey_LeftArrow] = DIK_LEFT;
         io.KeyMap[ImGuiKey_RightArrow] = DIK_RIGHT;
@@ -128,6 +131,7 @@ struct OcornutImguiContext
         io.KeyMap[ImGuiKey_Backspace] = DIK_BACK;
         io.KeyMap[ImGuiKey_Enter] = DIK_RETURN;
         io.KeyMap[ImGuiKey_Escape] = DIK_ESCAPE;
+#endif
         io.KeyMap[ImGuiKey_A] = 'A';
         io.KeyMap[ImGuiKey_C] = 'C';
         io.KeyMap[ImGuiKey_V] = 'V';
@@ -188,6 +192,7 @@ struct OcornutImguiContext
     }
 
 
+#if _WIN32 || _WIN64
     bool scanCodeToAscii(HKL keyboardLayout, uint8_t* keyboardState, uint32_t scancode, uint8_t& result)
     {
         UINT vk = MapVirtualKeyEx(scancode, 1, keyboardLayout);
@@ -199,6 +204,7 @@ struct OcornutImguiContext
         }
         return false;
     }
+#endif
 
     // TODO: Fix this quick hack for keyboard input.
     void beginFrame(Ctr::InputState* inputState, int32_t _mx, int32_t _my, uint8_t _button, int _width, int _height, char _inputChar, uint8_t _viewId)
@@ -206,6 +212,8 @@ struct OcornutImguiContext
         m_viewId = _viewId;
         ImGuiIO& io = ImGui::GetIO();
 
+        // Keyboard state comes from DirectInput, so only Windows builds feed it.
+#if _WIN32 || _WIN64
         static HKL keyboardLayout = GetKeyboardLayout(0);
         static uint8_t keyboardState[256];
         GetKeyboardState(keyboardState);
@@ -243,6 +251,7 @@ struct OcornutImguiContext
         io.MouseWheel = inputState->_z / 100.0f;
         io.KeyCtrl = (inputState->getKeyState(DIK_LCONTROL) || inputState->getKeyState(DIK_RCONTROL)) ? 1 : 0;
         io.KeyShift = (inputState->getKeyState(DIK_LSHIFT) || inputState->getKeyState(DIK_RSHIFT)) ? 1 : 0;
+#endif
 
         io.DisplaySize = ImVec2((float)_width, (float)_height);
         io.DeltaTime = 1.0f / 60.0f;
@@ -75,15 +75,15 @@ Brdf::load(const std::string& brdfInclude)
     _device->shaderMgr()->addComputeShaderFromFile("IblBrdf.hlsl", brdfInclude, "CSMain", _brdfLutShader,
         std::map<std::string, std::string>());
 
-    _brdfLut = _device->
-        createTexture(&TextureParameters("tempTex",
-                                        TextureImagePtr(),
-                                        Ctr::TwoD,
-                                        Ctr::RenderTarget,
-                                        PF_FLOAT32_RGBA,
-                                        Ctr::Vector3i(256, 256, 1),
-                                        false,
-                                        1, 1, 0, 1, true));
+    TextureParameters brdfLutInit("tempTex",
+                                  TextureImagePtr(),
+                                  Ctr::TwoD,
+                                  Ctr::RenderTarget,
+                                  PF_FLOAT32_RGBA,
+                                  Ctr::Vector3i(256, 256, 1),
+                                  false,
+                                  1, 1, 0, 1, true);
+    _brdfLut = _device->createTexture(&brdfLutInit);
 
     assert(_brdfLut);
 
@@ -50,7 +50,8 @@ namespace Ctr
 CameraTransformCache::CameraTransformCache () :
     _zNear(0),
     _zFar(1000),
-    _dpDir(1.0f)
+    _dpDir(1.0f),
+    _revision(0)
 {
 }
 
@@ -116,6 +117,13 @@ CameraTransformCache::set(const Ctr::Matrix44f& view,
     _zNear = zNear;
     _zFar = zFar;
     _dpDir = dp;
+    _revision++;
+}
+
+uint32_t
+CameraTransformCache::revision() const
+{
+    return _revision;
 }
 
 Camera::Camera (Ctr::IDevice* device) :
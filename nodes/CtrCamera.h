@@ -76,6 +76,8 @@ class CameraTransformCache
     float                      zNear() const;
     float                      zFar() const;
     float                      dpDir() const;
+    // Incremented by set, lets shaders skip camera scoped parameters.
+    uint32_t                   revision() const;
 
     Matrix44f                  _view;
     Matrix44f                  _proj;
@@ -84,6 +86,7 @@ class CameraTransformCache
     float                      _zFar;
     float                      _dpDir;
     Vector3f                   _cameraLocation;
+    uint32_t                   _revision;
 };
 
 typedef std::shared_ptr<CameraTransformCache> CameraTransformCachePtr;
@@ -47,6 +47,7 @@
 #include <CtrVertexStream.h>
 #include <CtrLog.h>
 #include <CtrVertexDeclarationMgr.h>
+#include <CtrRenderRequest.h>
 
 #if IBL_USE_ASS_IMP_AND_FREEIMAGE
 // Assimp includes
@@ -60,9 +61,13 @@ namespace Ctr
 IndexedMesh::IndexedMesh(Ctr::IDevice* device) : 
     StreamedMesh  (device),
     _indices (0),
+    _indexFormat (INDEX32),
+    _compressed (false),
+    _geometry (nullptr),
     _indexBuffer (0),
     _indexBufferLocked (false)
 {
+    memset(&_compressionReport, 0, sizeof(_compressionReport));
     _indexCount = new IntProperty(this, std::string("intbuffer"));
     _indicesBufferAttr = new UIntPtrProperty(this, std::string ("indbuffer"));
 
@@ -81,186 +86,181 @@ IndexedMesh::~IndexedMesh()
     }
 }
 
-#if IBL_USE_ASS_IMP_AND_FREEIMAGE
-bool
-IndexedMesh::load(const aiMesh* inputMesh)
+Hash
+IndexedMeshData::hash() const
 {
-    size_t inputIndexCount = inputMesh->mNumFaces * 3;
-    size_t inputVertexCount = inputMesh->mNumVertices;
-
-    Vector3f* verticesPtr = new Vector3f[inputVertexCount];
-    Vector3f* normalsPtr = new Vector3f[inputVertexCount];
-    Vector2f* uvsPtr = new Vector2f[inputVertexCount];
-    uint32_t* indiciesPtr = new uint32_t[inputIndexCount];
+    Hash hash;
+    if (positions.size() > 0)
+        hash.build(&positions[0], positions.size() * sizeof(Vector3f));
 
-    // Copy the vertex buffer
+    Hash streamHash;
+    if (normals.size() > 0)
     {
-        Vector3f* vertexPtr = verticesPtr;
-        Vector3f* normalPtr = normalsPtr;
-        Vector2f* uvPtr = uvsPtr;
-
-        memset(&vertexPtr[0], 0, sizeof(float)* 3 * inputVertexCount);
-        memset(&normalPtr[0], 0, sizeof(float)* 3 * inputVertexCount);
-        memset(&uvPtr[0], 0, sizeof(float)* 2 * inputVertexCount);
-
-        if (inputMesh->HasPositions())
-        {
-            memcpy(&vertexPtr[0], inputMesh->mVertices, sizeof(float)* 3 * inputVertexCount);
-        }
-        if (inputMesh->HasNormals())
-        {
-            memcpy(&normalPtr[0], inputMesh->mNormals, sizeof(float)* 3 * inputVertexCount);
-        }
-        if (inputMesh->HasTextureCoords(0))
-        {
-            for (uint32_t uvId = 0; uvId < inputVertexCount; uvId++)
-            {
-                uvPtr[uvId].x = inputMesh->mTextureCoords[0][uvId].x;
-                uvPtr[uvId].y = inputMesh->mTextureCoords[0][uvId].y;
-            }
-        }
+        streamHash.build(&normals[0], normals.size() * sizeof(Vector3f));
+        hash.append(streamHash);
     }
-
-    // Copy the index buffer
-    size_t triangleCount = inputMesh->mNumFaces;
-    for (size_t triangleId = 0; triangleId < triangleCount; triangleId++)
+    if (uvs.size() > 0)
     {
-        for (size_t indexId = 0; indexId < 3; indexId++)
-        {
-            indiciesPtr[(triangleId * 3) + indexId] = inputMesh->mFaces[triangleId].mIndices[indexId];
-        }
+        streamHash.build(&uvs[0], uvs.size() * sizeof(Vector2f));
+        hash.append(streamHash);
+    }
+    if (indices.size() > 0)
+    {
+        streamHash.build(&indices[0], indices.size() * sizeof(uint32_t));
+        hash.append(streamHash);
     }
+    return hash;
+}
 
-    // Create mesh representation.
-    uint32_t newPrimitiveCount = inputMesh->mNumFaces;
+void
+IndexedMeshData::remap(const std::vector<uint32_t>& remap, uint32_t vertexCount)
+{
+    std::vector<Vector3f> remappedPositions(vertexCount);
+    std::vector<Vector3f> remappedNormals(vertexCount);
+    std::vector<Vector2f> remappedUvs(vertexCount);
+    std::vector<Vector4f> remappedTangents(tangents.size() > 0 ? vertexCount : 0);
 
-    // Initialize topology information
-    setIndices(indiciesPtr,
-        (uint32_t)(inputIndexCount),
-        newPrimitiveCount);
+    for (size_t vertex = 0; vertex < remap.size(); vertex++)
+    {
+        uint32_t target = remap[vertex];
+        if (target == ~0u)
+            continue;
+
+        remappedPositions[target] = positions[vertex];
+        if (vertex < normals.size())
+            remappedNormals[target] = normals[vertex];
+        if (vertex < uvs.size())
+            remappedUvs[target] = uvs[vertex];
+        if (vertex < tangents.size())
+            remappedTangents[target] = tangents[vertex];
+    }
 
-    setVertexCount((uint32_t)(inputVertexCount));
+    positions.swap(remappedPositions);
+    normals.swap(remappedNormals);
+    uvs.swap(remappedUvs);
+    tangents.swap(remappedTangents);
 
-    setPrimitiveType(Ctr::TriangleList);
+    for (size_t level = 0; level < lodIndices.size(); level++)
+    {
+        std::vector<uint32_t>& levelIndices = lodIndices[level];
+        for (size_t i = 0; i < levelIndices.size(); i++)
+            levelIndices[i] = remap[levelIndices[i]];
+    }
+}
 
-    uint32_t offset = 0;
-    // Setup Elements
-    std::vector<Ctr::VertexElement> vertexElements;
-    vertexElements.push_back(Ctr::VertexElement(0, 0, Ctr::FLOAT3, Ctr::METHOD_DEFAULT, Ctr::POSITION, 0));
-    vertexElements.push_back(Ctr::VertexElement(0, 12, Ctr::FLOAT3, Ctr::METHOD_DEFAULT, Ctr::NORMAL, 0));
-    vertexElements.push_back(Ctr::VertexElement(0, 24, Ctr::FLOAT2, Ctr::METHOD_DEFAULT, Ctr::TEXCOORD, 0));
-    vertexElements.push_back(Ctr::VertexElement(0xFF, 0, Ctr::UNUSED, 0, 0, 0));
+#if IBL_USE_ASS_IMP_AND_FREEIMAGE
+bool
+IndexedMesh::read(const aiMesh* inputMesh, IndexedMeshData& data)
+{
+    size_t inputVertexCount = inputMesh->mNumVertices;
 
-    Ctr::VertexDeclarationParameters resource = Ctr::VertexDeclarationParameters(vertexElements);
+    // Copy the vertex buffer
+    data.positions.assign(inputVertexCount, Vector3f(0.0f));
+    data.normals.assign(inputVertexCount, Vector3f(0.0f));
+    data.uvs.assign(inputVertexCount, Vector2f(0.0f));
 
-    if (Ctr::IVertexDeclaration* vertexDeclaration =
-        Ctr::VertexDeclarationMgr::vertexDeclarationMgr()->createVertexDeclaration(&resource))
+    if (inputMesh->HasPositions())
     {
-        setVertexDeclaration(vertexDeclaration);
-
-        Ctr::VertexStream* vertexStream =
-            new Ctr::VertexStream(Ctr::POSITION, 0, 3,
-            vertexCount(), (float*)verticesPtr);
-        Ctr::VertexStream* normalStream =
-            new Ctr::VertexStream(Ctr::NORMAL, 0, 3,
-            vertexCount(), (float*)normalsPtr);
-        Ctr::VertexStream* texCoordStream =
-            new Ctr::VertexStream(Ctr::TEXCOORD, 0, 2,
-            vertexCount(), (float*)uvsPtr);
-        addStream(vertexStream);
-        addStream(normalStream);
-        addStream(texCoordStream);
+        memcpy(&data.positions[0], inputMesh->mVertices, sizeof(float)* 3 * inputVertexCount);
+    }
+    if (inputMesh->HasNormals())
+    {
+        memcpy(&data.normals[0], inputMesh->mNormals, sizeof(float)* 3 * inputVertexCount);
+    }
+    if (inputMesh->HasTextureCoords(0))
+    {
+        for (uint32_t uvId = 0; uvId < inputVertexCount; uvId++)
+        {
+            data.uvs[uvId].x = inputMesh->mTextureCoords[0][uvId].x;
+            data.uvs[uvId].y = inputMesh->mTextureCoords[0][uvId].y;
+        }
     }
 
-    // Nuke pointers
-    delete[] verticesPtr;
-    delete[] normalsPtr;
-    delete[] uvsPtr;
-    delete[] indiciesPtr;
-
-    if (create())
+    // Copy the index buffer
+    size_t triangleCount = inputMesh->mNumFaces;
+    data.indices.resize(triangleCount * 3);
+    for (size_t triangleId = 0; triangleId < triangleCount; triangleId++)
     {
-        if (cache())
+        for (size_t indexId = 0; indexId < 3; indexId++)
         {
-            return true;
+            data.indices[(triangleId * 3) + indexId] = inputMesh->mFaces[triangleId].mIndices[indexId];
         }
     }
-    return false;
+
+    return inputVertexCount > 0 && triangleCount > 0;
 }
-#else 
+
 bool
-IndexedMesh::load(const tinyobj::shape_t* shape)
+IndexedMesh::load(const aiMesh* inputMesh)
 {
+    IndexedMeshData data;
+    read(inputMesh, data);
+    return load(data);
+}
+#endif
 
-    const tinyobj::mesh_t* inputMesh = &shape->mesh;
-
-    size_t inputIndexCount = inputMesh->indices.size();
-    size_t inputVertexCount = inputMesh->positions.size();
-
-
-
-    if (inputIndexCount == 0)
-        return false;
-    if (inputVertexCount == 0)
+bool
+IndexedMesh::load(const IndexedMeshData& data, bool compress)
+{
+    if (data.positions.size() == 0 || data.indices.size() == 0)
         return false;
 
-    float * verticesPtr = new float[inputVertexCount * 3];
-    float * normalsPtr = new float[inputVertexCount * 3];
-    float * uvsPtr = new float[inputVertexCount * 2];
-    uint32_t* indiciesPtr = new uint32_t[inputIndexCount];
-
-    // Copy the vertex buffer
-
+    // Index buffers are sized for their format, so a format change needs a new one.
+    IndexFormat indexFormat = 
+        compress && VertexCompression::shortIndices(data.positions.size()) ? INDEX16 : INDEX32;
+    if (indexFormat != _indexFormat && _indexBuffer)
     {
-        memset(&verticesPtr[0], 0, sizeof(float) * 3 * inputVertexCount);
-        memset(&normalsPtr[0], 0, sizeof(float)* 3 * inputVertexCount);
-        memset(&uvsPtr[0], 0, sizeof(float)* 2 * inputVertexCount);
-
-        {
-            for (size_t positionId = 0; positionId < inputMesh->positions.size(); positionId++)
-            {
-                verticesPtr[positionId] = inputMesh->positions[positionId];
-            }
-        }
-        {
-            for (size_t normalsId = 0; normalsId < inputMesh->normals.size(); normalsId++)
-            {
-                normalsPtr[normalsId] = inputMesh->normals[normalsId];
-            }
-        }
-        {
-            for (uint32_t uvId = 0; uvId < inputMesh->texcoords.size(); uvId++)
-            {
-                uvsPtr[uvId] = inputMesh->texcoords[uvId];
-                if (uvId%2)
-                    uvsPtr[uvId] = 1.0f-uvsPtr[uvId];
-            }
-        }
+        _device->destroyResource(_indexBuffer);
+        _indexBuffer = nullptr;
     }
+    _indexFormat = indexFormat;
+    _compressed = compress;
 
-    // Copy the index buffer
-    size_t newPrimitiveCount = inputMesh->indices.size() * 3;
-    for (size_t indexId = 0; indexId < inputMesh->indices.size(); indexId++)
+    // Coarser levels follow level 0 in the index buffer.
+    std::vector<Lod> lods;
+    std::vector<uint32_t> lodIndices;
+    for (size_t level = 0; level < data.lodIndices.size(); level++)
+    {
+        const std::vector<uint32_t>& levelIndices = data.lodIndices[level];
+        Lod lod = { uint32_t(data.indices.size() + lodIndices.size()),
+                    uint32_t(levelIndices.size() / 3),
+                    level < data.lodErrors.size() ? data.lodErrors[level] : 0.0f };
+        lods.push_back(lod);
+        lodIndices.insert(lodIndices.end(), levelIndices.begin(), levelIndices.end());
+    }
+    if (lodIndices.size() != _lodIndices.size() && _indexBuffer)
     {
-        indiciesPtr[indexId] = (uint32_t)(inputMesh->indices[indexId]);
+        _device->destroyResource(_indexBuffer);
+        _indexBuffer = nullptr;
     }
+    _lods.swap(lods);
+    _lodIndices.swap(lodIndices);
 
     // Initialize topology information
-    setIndices(indiciesPtr,
-        (uint32_t)(inputIndexCount),
-        (uint32_t)(newPrimitiveCount));
+    setVertexCount((uint32_t)(data.positions.size()));
 
-    setVertexCount((uint32_t)(inputVertexCount));
+    setIndices(&data.indices[0],
+        (uint32_t)(data.indices.size()),
+        (uint32_t)(data.indices.size() / 3));
 
     setPrimitiveType(Ctr::TriangleList);
 
-    uint32_t offset = 0;
     // Setup Elements
+    bool tangents = data.tangents.size() == data.positions.size();
     std::vector<Ctr::VertexElement> vertexElements;
-    vertexElements.push_back(Ctr::VertexElement(0, 0, Ctr::FLOAT3, Ctr::METHOD_DEFAULT, Ctr::POSITION, 0));
-    vertexElements.push_back(Ctr::VertexElement(0, 12, Ctr::FLOAT3, Ctr::METHOD_DEFAULT, Ctr::NORMAL, 0));
-    vertexElements.push_back(Ctr::VertexElement(0, 24, Ctr::FLOAT2, Ctr::METHOD_DEFAULT, Ctr::TEXCOORD, 0));
-    vertexElements.push_back(Ctr::VertexElement(0xFF, 0, Ctr::UNUSED, 0, 0, 0));
+    if (compress)
+    {
+        VertexCompression::declaration(vertexElements, tangents);
+    }
+    else
+    {
+        vertexElements.push_back(Ctr::VertexElement(0, 0, Ctr::FLOAT3, Ctr::METHOD_DEFAULT, Ctr::POSITION, 0));
+        vertexElements.push_back(Ctr::VertexElement(0, 12, Ctr::FLOAT3, Ctr::METHOD_DEFAULT, Ctr::NORMAL, 0));
+        vertexElements.push_back(Ctr::VertexElement(0, 24, Ctr::FLOAT2, Ctr::METHOD_DEFAULT, Ctr::TEXCOORD, 0));
+        if (tangents)
+            vertexElements.push_back(Ctr::VertexElement(0, 32, Ctr::FLOAT4, Ctr::METHOD_DEFAULT, Ctr::TANGENT, 0));
+        vertexElements.push_back(Ctr::VertexElement(0xFF, 0, Ctr::UNUSED, 0, 0, 0));
+    }
 
     Ctr::VertexDeclarationParameters resource = Ctr::VertexDeclarationParameters(vertexElements);
 
@@ -271,36 +271,67 @@ IndexedMesh::load(const tinyobj::shape_t* shape)
 
         Ctr::VertexStream* vertexStream =
             new Ctr::VertexStream(Ctr::POSITION, 0, 3,
-            vertexCount(), (float*)verticesPtr);
+            vertexCount(), (const float*)&data.positions[0]);
         Ctr::VertexStream* normalStream =
             new Ctr::VertexStream(Ctr::NORMAL, 0, 3,
-            vertexCount(), (float*)normalsPtr);
+            vertexCount(), (const float*)&data.normals[0]);
         Ctr::VertexStream* texCoordStream =
             new Ctr::VertexStream(Ctr::TEXCOORD, 0, 2,
-            vertexCount(), (float*)uvsPtr);
+            vertexCount(), (const float*)&data.uvs[0]);
         addStream(vertexStream);
         addStream(normalStream);
         addStream(texCoordStream);
+        if (tangents)
+        {
+            addStream(new Ctr::VertexStream(Ctr::TANGENT, 0, 4,
+                vertexCount(), (const float*)&data.tangents[0]));
+        }
     }
 
-    bool result = false;
     if (create())
     {
+        if (_compressed && _vertexDeclaration)
+        {
+            // Against the float layout with 32 bit indices.
+            VertexCompression::Report& report = _compressionReport;
+            VertexCompression::measure(report, &data.indices[0], data.indices.size(),
+                                       data.positions.size(), tangents ? 48 : 32, _vertexDeclaration->vertexStride(),
+                                       sizeof(uint32_t), 
+                                       _indexFormat == INDEX16 ? sizeof(uint16_t) : sizeof(uint32_t),
+                                       positionDecodeScale());
+            LOG("Compressed mesh " << name() << ": " 
+                << report.vertexStrideBefore << " -> " << report.vertexStrideAfter << " bytes per vertex, "
+                << report.indexSizeBefore << " -> " << report.indexSizeAfter << " bytes per index, memory "
+                << report.memoryBefore / 1024 << " -> " << report.memoryAfter / 1024 << " KB, fetch per draw "
+                << report.fetchBefore / 1024 << " -> " << report.fetchAfter / 1024 << " KB, position error "
+                << report.positionError);
+        }
+
         if (cache())
         {
-            result = true;;
+            return true;
         }
     }
+    return false;
+}
 
-    safedeletearray(verticesPtr);
-    safedeletearray(normalsPtr);
-    safedeletearray(uvsPtr);
-    safedeletearray(indiciesPtr);
+bool
+IndexedMesh::compressed() const
+{
+    return _compressed;
+}
 
-    return result;
+const VertexCompression::Report&
+IndexedMesh::compressionReport() const
+{
+    return _compressionReport;
 }
-#endif
 
+IndexFormat
+IndexedMesh::indexFormat() const
+{
+    return _indexFormat;
+}
 
 uint32_t
 IndexedMesh::indexCount() const
@@ -343,7 +374,7 @@ IndexedMesh::free()
 const IIndexBuffer*
 IndexedMesh::indexBuffer() const
 {
-    return _indexBuffer;
+    return geometry()->_indexBuffer;
 }
 
 void
@@ -352,6 +383,20 @@ IndexedMesh::setIndices (const uint32_t* indexBuffer, uint32_t indexCount, uint3
     uint32_t lastIndexCount = _indexCount->get();
     _indexCount->set (indexCount);
 
+    if (_indexFormat == INDEX16)
+    {
+        for (uint32_t i = 0; i < indexCount; i++)
+        {
+            if (indexBuffer[i] > 0xFFFF)
+            {
+                // Widen, the larger buffer is created below.
+                _indexFormat = INDEX32;
+                lastIndexCount = 0;
+                break;
+            }
+        }
+    }
+
     setPrimitiveCount (faceCount);
     indexCount = _indexCount->get();
 
@@ -386,9 +431,30 @@ bool
 IndexedMesh::fillIndexBuffer()
 { 
     
-    if (uint32_t* indices =  static_cast<uint32_t*>(lockIndexBuffer()))
+    if (void* indices = lockIndexBuffer())
     {
-        memcpy(indices, _indices, sizeof(uint32_t)*_indexCount->get());
+        uint32_t indexCount = _indexCount->get();
+        if (_indexFormat == INDEX16)
+        {
+            uint16_t* shortIndices = static_cast<uint16_t*>(indices);
+            for (uint32_t i = 0; i < indexCount; i++)
+            {
+                shortIndices[i] = uint16_t(_indices[i]);
+            }
+            for (size_t i = 0; i < _lodIndices.size(); i++)
+            {
+                shortIndices[indexCount + i] = uint16_t(_lodIndices[i]);
+            }
+        }
+        else
+        {
+            memcpy(indices, _indices, sizeof(uint32_t)*indexCount);
+            if (_lodIndices.size() > 0)
+            {
+                memcpy(static_cast<uint32_t*>(indices) + indexCount, &_lodIndices[0], 
+                       sizeof(uint32_t)*_lodIndices.size());
+            }
+        }
         unlockIndexBuffer();
         return true;
     }
@@ -400,7 +466,9 @@ IndexedMesh::createIndexBuffer()
 {
     if (!_indexBuffer)
     {
-        IndexBufferParameters ibResource= IndexBufferParameters(sizeof(uint32_t)*_indexCount->get());
+        uint32_t indexSize = _indexFormat == INDEX16 ? sizeof(uint16_t) : sizeof(uint32_t);
+        IndexBufferParameters ibResource= IndexBufferParameters(indexSize*(_indexCount->get() + (uint32_t)_lodIndices.size()), 
+                                                                false, false, _indexFormat);
         if (_indexBuffer = _device->createIndexBuffer(&ibResource))
         {
             return true;
@@ -437,13 +505,75 @@ bool
 IndexedMesh::render(const Ctr::RenderRequest* request,
                     const Ctr::GpuTechnique* technique) const
 {
+    const IndexedMesh* source = geometry();
+    uint32_t primitives = primitiveDrawCount();
+    uint32_t indexOffset = 0;
+    if (request && request->lod > 0 && request->lod <= _lods.size())
     {
-        return _device->drawIndexedPrimitive (_vertexDeclaration, _indexBuffer, 
-                                              vertexBuffer(), technique, (PrimitiveType)primitiveType(), 
-                                              primitiveDrawCount(), 0, 0);
+        const Lod& lod = _lods[request->lod - 1];
+        primitives = lod.primitiveCount;
+        indexOffset = lod.indexOffset;
+    }
+
+    if (request && request->instanceCount > 1)
+    {
+        return _device->drawIndexedPrimitiveInstanced (_vertexDeclaration, source->_indexBuffer, 
+                                                       source->vertexBuffer(), technique, (PrimitiveType)primitiveType(), 
+                                                       primitives, indexOffset, 0, request->instanceCount);
+    }
+    return _device->drawIndexedPrimitive (_vertexDeclaration, source->_indexBuffer, 
+                                          source->vertexBuffer(), technique, (PrimitiveType)primitiveType(), 
+                                          primitives, indexOffset, 0);
+}
+
+bool
+IndexedMesh::share(const IndexedMesh* source)
+{
+    if (!source || !source->vertexDeclaration())
+        return false;
+
+    _geometry = source->geometry();
+    _indexFormat = _geometry->_indexFormat;
+    _compressed = _geometry->_compressed;
+    _compressionReport = _geometry->_compressionReport;
+    _indexCount->set(_geometry->indexCount());
+    _lods = _geometry->_lods;
+
+    setVertexDeclaration(_geometry->vertexDeclaration());
+    setVertexCount(_geometry->vertexCount());
+    setPrimitiveType(_geometry->primitiveType());
+    setPrimitiveCount(_geometry->primitiveCount());
+    setPositionDecode(_geometry->positionDecodeOffset(), _geometry->positionDecodeScale());
+    if (_geometry->hasBounds())
+    {
+        setLocalBounds(_geometry->localBounds());
     }
     return true;
 }
 
+const IndexedMesh*
+IndexedMesh::geometry() const
+{
+    return _geometry ? _geometry : this;
+}
+
+uint32_t
+IndexedMesh::lodCount() const
+{
+    return uint32_t(_lods.size()) + 1;
+}
+
+float
+IndexedMesh::lodError(uint32_t level) const
+{
+    return level > 0 && level <= _lods.size() ? _lods[level - 1].error : 0.0f;
+}
+
+uint32_t
+IndexedMesh::lodPrimitiveCount(uint32_t level) const
+{
+    return level > 0 && level <= _lods.size() ? _lods[level - 1].primitiveCount : primitiveCount();
+}
+
 }
 
@@ -44,6 +44,8 @@
 
 #include <CtrPlatform.h>
 #include <CtrStreamedMesh.h>
+#include <CtrVertexCompression.h>
+#include <CtrHash.h>
 
 #if IBL_USE_ASS_IMP_AND_FREEIMAGE
 // Assimp includes
@@ -51,8 +53,6 @@
 #include <scene.h>
 #include <postprocess.h>
 struct aiMesh;
-#else
-#include <tiny_obj_loader.h>
 #endif
 
 namespace Ctr
@@ -60,6 +60,32 @@ namespace Ctr
 class IDevice;
 class IIndexBuffer;
 
+//------------------------------------------------------------------------
+// Host copy of an imported triangle list. Importers fill it with read()
+// and load() builds the streams and buffers from it, so import stages
+// such as MeshOptimizer can run on worker threads in between.
+//------------------------------------------------------------------------
+struct IndexedMeshData
+{
+    // Moves vertex i to remap[i], dropping vertices mapped to ~0u.
+    void                       remap(const std::vector<uint32_t>& remap,
+                                     uint32_t vertexCount);
+
+    // Content hash of the streams and indices, equal for identical geometry.
+    Hash                       hash() const;
+
+    std::vector<Vector3f>      positions;
+    std::vector<Vector3f>      normals;
+    std::vector<Vector2f>      uvs;
+    // Optional, xyz and the bitangent sign. See TangentGenerator.
+    std::vector<Vector4f>      tangents;
+    std::vector<uint32_t>      indices;
+
+    // Coarser index lists over the same vertices, finest first, and the
+    // object space error of each. See MeshSimplifier.
+    std::vector<std::vector<uint32_t> > lodIndices;
+    std::vector<float>         lodErrors;
+};
 
 class IndexedMesh : public Ctr::StreamedMesh
 {
@@ -82,12 +108,30 @@ class IndexedMesh : public Ctr::StreamedMesh
 
     uint32_t*                  indices() const;
     uint32_t                   indexCount() const;
+    // INDEX16 for compressed meshes under 65536 vertices. indices() stays 32 bit.
+    IndexFormat                indexFormat() const;
 
 #if IBL_USE_ASS_IMP_AND_FREEIMAGE
+    static bool                read(const aiMesh* mesh, IndexedMeshData& data);
     bool                       load(const aiMesh* mesh);
-#else
-    bool                       load(const tinyobj::shape_t* shape);
 #endif
+    // compress stores quantized vertices and, where they fit, 16 bit
+    // indices (see VertexCompression). The host streams stay in float.
+    bool                       load(const IndexedMeshData& data, bool compress = false);
+    bool                       compressed() const;
+    const VertexCompression::Report& compressionReport() const;
+
+    // Draws from the buffers of source rather than buffers of its own.
+    // source must outlive this mesh.
+    bool                       share(const IndexedMesh* source);
+    // The mesh owning the buffers this mesh draws, this unless shared.
+    const IndexedMesh*         geometry() const;
+
+    // Levels from IndexedMeshData::lodIndices. Their indices follow
+    // level 0 in the index buffer and use the same vertex buffer.
+    virtual uint32_t           lodCount() const;
+    virtual float              lodError(uint32_t level) const;
+    virtual uint32_t           lodPrimitiveCount(uint32_t level) const;
 
   protected:
     const IIndexBuffer*        indexBuffer() const;
@@ -97,7 +141,21 @@ class IndexedMesh : public Ctr::StreamedMesh
     void                       unlockIndexBuffer();
 
   protected:
+    struct Lod
+    {
+        uint32_t               indexOffset;
+        uint32_t               primitiveCount;
+        float                  error;
+    };
+
     uint32_t*                  _indices;
+    IndexFormat                _indexFormat;
+    bool                       _compressed;
+    VertexCompression::Report  _compressionReport;
+    const IndexedMesh*         _geometry;
+    // Levels after 0, and their indices in level order.
+    std::vector<Lod>           _lods;
+    std::vector<uint32_t>      _lodIndices;
 
   private:
 
@@ -65,7 +65,11 @@ _locked (false),
 _entity (0),
 _material (0),
 _topologySubtype(Tri),
-_groupId(0)
+_groupId(0),
+_hasBounds(false),
+_worldBoundsCached(false),
+_positionDecodeOffset(0.0f, 0.0f, 0.0f),
+_positionDecodeScale(1.0f, 1.0f, 1.0f)
 {
     _visible = new BoolProperty (this, std::string("visible"));
     setVisible (true);
@@ -90,6 +94,78 @@ Mesh::setGroupId(uint32_t group)
     _groupId = group;
 }
 
+void
+Mesh::setLocalBounds(const Region3f& bounds)
+{
+    _localBounds = bounds;
+    _hasBounds = true;
+    _worldBoundsCached = false;
+}
+
+const Region3f&
+Mesh::localBounds() const
+{
+    return _localBounds;
+}
+
+bool
+Mesh::hasBounds() const
+{
+    return _hasBounds;
+}
+
+void
+Mesh::setPositionDecode(const Vector3f& offset, const Vector3f& scale)
+{
+    _positionDecodeOffset = offset;
+    _positionDecodeScale = scale;
+}
+
+const Vector3f&
+Mesh::positionDecodeOffset() const
+{
+    return _positionDecodeOffset;
+}
+
+const Vector3f&
+Mesh::positionDecodeScale() const
+{
+    return _positionDecodeScale;
+}
+
+const Region3f&
+Mesh::worldBounds() const
+{
+    const Matrix44f& world = worldTransform();
+    if (_worldBoundsCached && world == _worldBoundsTransform)
+    {
+        return _worldBounds;
+    }
+
+    // Transform the center and project the extents onto the
+    // world axes (Arvo), rather than transforming all 8 corners.
+    Vector3f center = (_localBounds.maxExtent + _localBounds.minExtent) * 0.5f;
+    Vector3f extents = (_localBounds.maxExtent - _localBounds.minExtent) * 0.5f;
+
+    Vector3f worldCenter;
+    Vector3f worldExtents;
+    for (uint32_t j = 0; j < 3; j++)
+    {
+        worldCenter[j] = world[3][j];
+        worldExtents[j] = 0;
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            worldCenter[j] += center[i] * world[i][j];
+            worldExtents[j] += extents[i] * fabsf(world[i][j]);
+        }
+    }
+
+    _worldBounds = Region3f(worldCenter - worldExtents, worldCenter + worldExtents);
+    _worldBoundsTransform = world;
+    _worldBoundsCached = true;
+    return _worldBounds;
+}
+
 bool
 Mesh::dynamic() const 
 { 
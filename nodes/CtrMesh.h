@@ -151,6 +151,27 @@ class Mesh : public Ctr::TransformNode
     void                            setShadowMask(uint32_t);
     uint32_t                        shadowMask() const;
 
+    // Object space bounds. Meshes without bounds are never culled.
+    void                            setLocalBounds(const Region3f& bounds);
+    const Region3f&                 localBounds() const;
+    bool                            hasBounds() const;
+
+    // World space bounds, refreshed when the world transform changes.
+    const Region3f&                 worldBounds() const;
+
+    // Object space position is offset + stored position * scale. Identity
+    // unless the vertex buffer holds quantized positions, bound to shaders
+    // through the MESHPOSITIONDECODE semantic.
+    void                            setPositionDecode(const Vector3f& offset, const Vector3f& scale);
+    const Vector3f&                 positionDecodeOffset() const;
+    const Vector3f&                 positionDecodeScale() const;
+
+    // Levels of detail, finest first. Meshes without a chain have one.
+    virtual uint32_t                lodCount() const { return 1; }
+    // Object space error of a level against level 0.
+    virtual float                   lodError(uint32_t level) const { return 0.0f; }
+    virtual uint32_t                lodPrimitiveCount(uint32_t level) const { return primitiveCount(); }
+
   protected:
     const IVertexBuffer*            vertexBuffer() const;
 
@@ -171,6 +192,15 @@ class Mesh : public Ctr::TransformNode
     Ctr::BoolProperty*               _visible;
     bool                            _dynamic;
     uint32_t                        _groupId;
+
+    Region3f                        _localBounds;
+    bool                            _hasBounds;
+    mutable Region3f                _worldBounds;
+    mutable Matrix44f               _worldBoundsTransform;
+    mutable bool                    _worldBoundsCached;
+
+    Vector3f                        _positionDecodeOffset;
+    Vector3f                        _positionDecodeScale;
 };
 }
 #endif
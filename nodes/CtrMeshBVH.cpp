@@ -0,0 +1,830 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+#include <CtrMeshBVH.h>
+#include <CtrMesh.h>
+#include <CtrFrustum.h>
+#include <functional>
+#include <queue>
+
+namespace Ctr
+{
+namespace
+{
+// Rebuild when refits have made the tree this much more costly.
+const float RebuildCostRatio = 2.0f;
+
+inline void
+growBounds(Region3f& bounds, const Region3f& other)
+{
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        bounds.minExtent[k] = std::min(bounds.minExtent[k], other.minExtent[k]);
+        bounds.maxExtent[k] = std::max(bounds.maxExtent[k], other.maxExtent[k]);
+    }
+}
+
+// Half the surface area, which is all SAH needs.
+inline float
+halfArea(const Region3f& bounds)
+{
+    Vector3f size = bounds.maxExtent - bounds.minExtent;
+    return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+inline bool
+overlaps(const Region3f& a, const Region3f& b)
+{
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        if (a.maxExtent[k] < b.minExtent[k] || a.minExtent[k] > b.maxExtent[k])
+            return false;
+    }
+    return true;
+}
+
+inline float
+distanceSquared(const Region3f& bounds, const Vector3f& point)
+{
+    float distance = 0.0f;
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        float d = std::max(std::max(bounds.minExtent[k] - point[k], point[k] - bounds.maxExtent[k]), 0.0f);
+        distance += d * d;
+    }
+    return distance;
+}
+
+struct Ray
+{
+    Ray(const Vector3f& originValue, const Vector3f& direction, float maxDistanceValue) :
+        origin(originValue),
+        maxDistance(maxDistanceValue)
+    {
+        // Axis parallel rays get a large finite inverse, so the slab
+        // test sees no 0 * inf.
+        for (uint32_t k = 0; k < 3; k++)
+            inverse[k] = direction[k] != 0.0f ? 1.0f / direction[k] : FLT_MAX;
+    }
+
+    // Entry distance into bounds, clamped to 0, if the ray enters
+    // before maxDistance.
+    bool                       enters(const Region3f& bounds, float& entry) const
+    {
+        float enter = 0.0f;
+        float exit = maxDistance;
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            float t0 = (bounds.minExtent[k] - origin[k]) * inverse[k];
+            float t1 = (bounds.maxExtent[k] - origin[k]) * inverse[k];
+            enter = std::max(enter, std::min(t0, t1));
+            exit = std::min(exit, std::max(t0, t1));
+        }
+        entry = enter;
+        return enter <= exit;
+    }
+
+    Vector3f                   origin;
+    Vector3f                   inverse;
+    float                      maxDistance;
+};
+}
+
+MeshBVH::MeshBVH() :
+    _count(0),
+    _buildCost(0.0f),
+    _valid(false)
+{
+}
+
+MeshBVH::~MeshBVH()
+{
+}
+
+void
+MeshBVH::invalidate()
+{
+    _valid = false;
+}
+
+bool
+MeshBVH::valid() const
+{
+    return _valid;
+}
+
+size_t
+MeshBVH::nodeCount() const
+{
+    return _nodes.size();
+}
+
+size_t
+MeshBVH::meshCount() const
+{
+    return _count;
+}
+
+void
+MeshBVH::build(const std::vector<Mesh*>& meshes)
+{
+    _meshes.assign(meshes.begin(), meshes.end());
+    collectMeshes();
+    buildTree();
+}
+
+void
+MeshBVH::build(const std::vector<Region3f>& bounds)
+{
+    _meshes.clear();
+    _count = (uint32_t)bounds.size();
+    _unbounded.clear();
+    _pending.clear();
+    _leafBounds = bounds;
+    _order.resize(bounds.size());
+    for (uint32_t index = 0; index < _count; index++)
+        _order[index] = index;
+    buildTree();
+}
+
+void
+MeshBVH::collectMeshes()
+{
+    _count = (uint32_t)_meshes.size();
+    _order.clear();
+    _leafBounds.clear();
+    _unbounded.clear();
+    _pending.clear();
+
+    for (uint32_t meshId = 0; meshId < _count; meshId++)
+    {
+        const Mesh* mesh = _meshes[meshId];
+        if (!mesh->hasBounds())
+        {
+            _unbounded.push_back(meshId);
+            continue;
+        }
+
+        _order.push_back(meshId);
+        _leafBounds.push_back(mesh->worldBounds());
+    }
+}
+
+void
+MeshBVH::buildTree()
+{
+    _nodes.clear();
+    if (_order.size() > 0)
+    {
+        std::vector<Vector3f> centers(_order.size());
+        for (size_t slot = 0; slot < _order.size(); slot++)
+            centers[slot] = (_leafBounds[slot].minExtent + _leafBounds[slot].maxExtent) * 0.5f;
+
+        _nodes.reserve(2 * _order.size() / MaxLeafSize + 1);
+        buildRecursive(0, (uint32_t)_order.size(), 0, centers);
+    }
+    _buildCost = cost();
+    _valid = true;
+}
+
+void
+MeshBVH::append(Mesh* mesh)
+{
+    if (!_valid || _meshes.size() != _count)
+    {
+        invalidate();
+        return;
+    }
+
+    uint32_t index = _count++;
+    _meshes.push_back(mesh);
+    if (!mesh->hasBounds())
+        _unbounded.push_back(index);
+    else
+        _pending.push_back(index);
+
+    if (_pending.size() > std::max(size_t(MinPending), _order.size() / 8))
+        invalidate();
+}
+
+const Region3f*
+MeshBVH::pendingBounds(uint32_t index) const
+{
+    const Mesh* mesh = _meshes[index];
+    return mesh->hasBounds() ? &mesh->worldBounds() : nullptr;
+}
+
+uint32_t
+MeshBVH::buildRecursive(uint32_t first, uint32_t count, uint32_t depth, std::vector<Vector3f>& centers)
+{
+    uint32_t nodeId = (uint32_t)_nodes.size();
+    _nodes.push_back(BVHNode());
+
+    Region3f bounds = _leafBounds[first];
+    Region3f centerBounds(centers[first]);
+    for (uint32_t i = first + 1; i < first + count; i++)
+    {
+        growBounds(bounds, _leafBounds[i]);
+        growBounds(centerBounds, Region3f(centers[i]));
+    }
+
+    _nodes[nodeId].bounds = bounds;
+    _nodes[nodeId].first = first;
+    _nodes[nodeId].count = count;
+    _nodes[nodeId].right = 0;
+
+    Vector3f spread = centerBounds.maxExtent - centerBounds.minExtent;
+    if (count <= MaxLeafSize || (spread.x <= 0 && spread.y <= 0 && spread.z <= 0))
+    {
+        return nodeId;
+    }
+
+    std::vector<uint32_t> slots(count);
+    for (uint32_t i = 0; i < count; i++)
+        slots[i] = first + i;
+
+    // Binned SAH over every axis with extent, keeping the cheapest
+    // split. Past half the traversal stack, median splits bound the
+    // depth of degenerate inputs.
+    uint32_t half = 0;
+    uint32_t axis = 0;
+    if (spread.y > spread[axis]) axis = 1;
+    if (spread.z > spread[axis]) axis = 2;
+
+    if (depth < MaxDepth / 2)
+    {
+        float bestCost = FLT_MAX;
+        uint32_t bestAxis = axis;
+        uint32_t bestBin = 0;
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            if (spread[k] <= 0)
+                continue;
+
+            uint32_t binCounts[SahBins] = {};
+            Region3f binBounds[SahBins];
+            float scale = float(SahBins) / spread[k];
+            for (uint32_t i = first; i < first + count; i++)
+            {
+                uint32_t bin = std::min(uint32_t((centers[i][k] - centerBounds.minExtent[k]) * scale), uint32_t(SahBins - 1));
+                if (binCounts[bin]++ == 0)
+                    binBounds[bin] = _leafBounds[i];
+                else
+                    growBounds(binBounds[bin], _leafBounds[i]);
+            }
+
+            // Sweep from the right for suffix areas, then from the left.
+            float rightCosts[SahBins];
+            Region3f rightBounds;
+            uint32_t rightCount = 0;
+            for (uint32_t bin = SahBins - 1; bin > 0; bin--)
+            {
+                if (binCounts[bin] > 0)
+                {
+                    if (rightCount == 0)
+                        rightBounds = binBounds[bin];
+                    else
+                        growBounds(rightBounds, binBounds[bin]);
+                    rightCount += binCounts[bin];
+                }
+                rightCosts[bin] = rightCount > 0 ? halfArea(rightBounds) * rightCount : 0.0f;
+            }
+
+            Region3f leftBounds;
+            uint32_t leftCount = 0;
+            for (uint32_t bin = 0; bin < SahBins - 1; bin++)
+            {
+                if (binCounts[bin] > 0)
+                {
+                    if (leftCount == 0)
+                        leftBounds = binBounds[bin];
+                    else
+                        growBounds(leftBounds, binBounds[bin]);
+                    leftCount += binCounts[bin];
+                }
+                if (leftCount == 0 || leftCount == count)
+                    continue;
+
+                float splitCost = halfArea(leftBounds) * leftCount + rightCosts[bin + 1];
+                if (splitCost < bestCost)
+                {
+                    bestCost = splitCost;
+                    bestAxis = k;
+                    bestBin = bin;
+                }
+            }
+        }
+
+        if (bestCost < FLT_MAX)
+        {
+            float scale = float(SahBins) / spread[bestAxis];
+            float minExtent = centerBounds.minExtent[bestAxis];
+            auto split = std::partition(slots.begin(), slots.end(), [&](uint32_t slot)
+            {
+                return std::min(uint32_t((centers[slot][bestAxis] - minExtent) * scale), uint32_t(SahBins - 1)) <= bestBin;
+            });
+            half = (uint32_t)(split - slots.begin());
+        }
+    }
+
+    if (half == 0 || half == count)
+    {
+        half = count / 2;
+        std::nth_element(slots.begin(), slots.begin() + half, slots.end(),
+                         [&centers, axis](uint32_t a, uint32_t b) { return centers[a][axis] < centers[b][axis]; });
+    }
+
+    // Permute the slot arrays into the split order.
+    std::vector<uint32_t> order(count);
+    std::vector<Region3f> leafBounds(count);
+    std::vector<Vector3f> splitCenters(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        order[i] = _order[slots[i]];
+        leafBounds[i] = _leafBounds[slots[i]];
+        splitCenters[i] = centers[slots[i]];
+    }
+    std::copy(order.begin(), order.end(), _order.begin() + first);
+    std::copy(leafBounds.begin(), leafBounds.end(), _leafBounds.begin() + first);
+    std::copy(splitCenters.begin(), splitCenters.end(), centers.begin() + first);
+
+    buildRecursive(first, half, depth + 1, centers);
+    uint32_t right = buildRecursive(first + half, count - half, depth + 1, centers);
+    _nodes[nodeId].right = right;
+    return nodeId;
+}
+
+float
+MeshBVH::cost() const
+{
+    if (_nodes.size() == 0)
+        return 0.0f;
+
+    float rootArea = halfArea(_nodes[0].bounds);
+    if (rootArea <= 0.0f)
+        return 0.0f;
+
+    float total = 0.0f;
+    for (auto node = _nodes.begin(); node != _nodes.end(); node++)
+    {
+        total += halfArea(node->bounds) * (node->right ? 1.0f : float(node->count));
+    }
+    return total / rootArea;
+}
+
+bool
+MeshBVH::refit()
+{
+    bool changed = false;
+    for (size_t slot = 0; slot < _order.size(); slot++)
+    {
+        const Region3f& bounds = _meshes[_order[slot]]->worldBounds();
+        if (bounds != _leafBounds[slot])
+        {
+            _leafBounds[slot] = bounds;
+            changed = true;
+        }
+    }
+
+    if (changed)
+    {
+        refitTree();
+        if (cost() > _buildCost * RebuildCostRatio)
+        {
+            collectMeshes();
+            buildTree();
+        }
+    }
+    return changed;
+}
+
+bool
+MeshBVH::refit(const std::vector<Region3f>& bounds)
+{
+    if (bounds.size() != _count || _meshes.size() > 0)
+    {
+        build(bounds);
+        return true;
+    }
+
+    bool changed = false;
+    for (size_t slot = 0; slot < _order.size(); slot++)
+    {
+        if (bounds[_order[slot]] != _leafBounds[slot])
+        {
+            _leafBounds[slot] = bounds[_order[slot]];
+            changed = true;
+        }
+    }
+
+    if (changed)
+    {
+        refitTree();
+        if (cost() > _buildCost * RebuildCostRatio)
+            build(bounds);
+    }
+    return changed;
+}
+
+void
+MeshBVH::refitTree()
+{
+    // Children always follow their parent, so walk backwards.
+    for (size_t nodeId = _nodes.size(); nodeId-- > 0;)
+    {
+        refitNode((uint32_t)nodeId);
+    }
+}
+
+void
+MeshBVH::refitNode(uint32_t nodeId)
+{
+    BVHNode& node = _nodes[nodeId];
+    if (node.right)
+    {
+        node.bounds = _nodes[nodeId + 1].bounds;
+        growBounds(node.bounds, _nodes[node.right].bounds);
+    }
+    else
+    {
+        node.bounds = _leafBounds[node.first];
+        for (uint32_t slot = node.first + 1; slot < node.first + node.count; slot++)
+        {
+            growBounds(node.bounds, _leafBounds[slot]);
+        }
+    }
+}
+
+void
+MeshBVH::cull(const Frustum& frustum, std::vector<uint32_t>& visible) const
+{
+    size_t firstVisible = visible.size();
+    visible.insert(visible.end(), _unbounded.begin(), _unbounded.end());
+    for (auto index = _pending.begin(); index != _pending.end(); index++)
+    {
+        const Region3f* bounds = pendingBounds(*index);
+        if (!bounds || frustum.intersects(*bounds))
+            visible.push_back(*index);
+    }
+
+    if (_nodes.size() > 0)
+    {
+        uint32_t stack[MaxDepth];
+        uint32_t stackSize = 0;
+        uint32_t nodeId = 0;
+
+        for (;;)
+        {
+            const BVHNode& node = _nodes[nodeId];
+            Frustum::Containment containment = frustum.classify(node.bounds);
+
+            bool descend = false;
+            if (containment == Frustum::Inside)
+            {
+                visible.insert(visible.end(), _order.begin() + node.first,
+                               _order.begin() + node.first + node.count);
+            }
+            else if (containment == Frustum::Intersecting)
+            {
+                if (node.right)
+                {
+                    stack[stackSize++] = node.right;
+                    nodeId = nodeId + 1;
+                    descend = true;
+                }
+                else
+                {
+                    for (uint32_t slot = node.first; slot < node.first + node.count; slot++)
+                    {
+                        if (frustum.intersects(_leafBounds[slot]))
+                            visible.push_back(_order[slot]);
+                    }
+                }
+            }
+
+            if (!descend)
+            {
+                if (stackSize == 0)
+                    break;
+                nodeId = stack[--stackSize];
+            }
+        }
+    }
+
+    // Keep submission order stable with respect to the pass.
+    std::sort(visible.begin() + firstVisible, visible.end());
+}
+
+bool
+MeshBVH::intersect(const Vector3f& origin,
+                   const Vector3f& direction,
+                   float maxDistance,
+                   RayHit& hit) const
+{
+    Ray ray(origin, direction, maxDistance);
+    float entry = 0.0f;
+    bool found = false;
+
+    for (auto index = _pending.begin(); index != _pending.end(); index++)
+    {
+        const Region3f* bounds = pendingBounds(*index);
+        if (bounds && ray.enters(*bounds, entry))
+        {
+            hit.index = *index;
+            hit.distance = entry;
+            ray.maxDistance = entry;
+            found = true;
+        }
+    }
+
+    if (_nodes.size() == 0 || !ray.enters(_nodes[0].bounds, entry))
+        return found;
+
+    // Nearer child first, and skip anything entered past the best hit.
+    struct Entry
+    {
+        uint32_t               nodeId;
+        float                  distance;
+    };
+    Entry stack[MaxDepth];
+    uint32_t stackSize = 0;
+    stack[stackSize].nodeId = 0;
+    stack[stackSize++].distance = entry;
+
+    while (stackSize > 0)
+    {
+        Entry current = stack[--stackSize];
+        if (current.distance > ray.maxDistance)
+            continue;
+
+        const BVHNode& node = _nodes[current.nodeId];
+        if (!node.right)
+        {
+            for (uint32_t slot = node.first; slot < node.first + node.count; slot++)
+            {
+                if (ray.enters(_leafBounds[slot], entry))
+                {
+                    hit.index = _order[slot];
+                    hit.distance = entry;
+                    ray.maxDistance = entry;
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        float leftEntry = 0.0f, rightEntry = 0.0f;
+        bool left = ray.enters(_nodes[current.nodeId + 1].bounds, leftEntry);
+        bool right = ray.enters(_nodes[node.right].bounds, rightEntry);
+        if (left && right)
+        {
+            Entry nearer = { current.nodeId + 1, leftEntry };
+            Entry farther = { node.right, rightEntry };
+            if (rightEntry < leftEntry)
+                std::swap(nearer, farther);
+            stack[stackSize++] = farther;
+            stack[stackSize++] = nearer;
+        }
+        else if (left || right)
+        {
+            Entry only = { left ? current.nodeId + 1 : node.right, left ? leftEntry : rightEntry };
+            stack[stackSize++] = only;
+        }
+    }
+    return found;
+}
+
+void
+MeshBVH::intersect(const Vector3f& origin,
+                   const Vector3f& direction,
+                   float maxDistance,
+                   std::vector<RayHit>& hits) const
+{
+    Ray ray(origin, direction, maxDistance);
+    size_t firstHit = hits.size();
+    float entry = 0.0f;
+
+    for (auto index = _pending.begin(); index != _pending.end(); index++)
+    {
+        const Region3f* bounds = pendingBounds(*index);
+        if (bounds && ray.enters(*bounds, entry))
+        {
+            RayHit hit = { *index, entry };
+            hits.push_back(hit);
+        }
+    }
+
+    if (_nodes.size() > 0)
+    {
+        uint32_t stack[MaxDepth];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            uint32_t nodeId = stack[--stackSize];
+            const BVHNode& node = _nodes[nodeId];
+            if (!ray.enters(node.bounds, entry))
+                continue;
+
+            if (node.right)
+            {
+                stack[stackSize++] = node.right;
+                stack[stackSize++] = nodeId + 1;
+                continue;
+            }
+            for (uint32_t slot = node.first; slot < node.first + node.count; slot++)
+            {
+                if (ray.enters(_leafBounds[slot], entry))
+                {
+                    RayHit hit = { _order[slot], entry };
+                    hits.push_back(hit);
+                }
+            }
+        }
+    }
+
+    std::sort(hits.begin() + firstHit, hits.end(), [](const RayHit& a, const RayHit& b) 
+    {
+        return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+    });
+}
+
+void
+MeshBVH::overlap(const Region3f& bounds, std::vector<uint32_t>& overlapping) const
+{
+    size_t firstOverlapping = overlapping.size();
+    for (auto index = _pending.begin(); index != _pending.end(); index++)
+    {
+        const Region3f* pending = pendingBounds(*index);
+        if (pending && overlaps(*pending, bounds))
+            overlapping.push_back(*index);
+    }
+
+    if (_nodes.size() > 0)
+    {
+        uint32_t stack[MaxDepth];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            uint32_t nodeId = stack[--stackSize];
+            const BVHNode& node = _nodes[nodeId];
+            if (!overlaps(node.bounds, bounds))
+                continue;
+
+            if (node.right)
+            {
+                stack[stackSize++] = node.right;
+                stack[stackSize++] = nodeId + 1;
+                continue;
+            }
+            for (uint32_t slot = node.first; slot < node.first + node.count; slot++)
+            {
+                if (overlaps(_leafBounds[slot], bounds))
+                    overlapping.push_back(_order[slot]);
+            }
+        }
+    }
+    std::sort(overlapping.begin() + firstOverlapping, overlapping.end());
+}
+
+void
+MeshBVH::overlap(const Vector3f& center, float radius, std::vector<uint32_t>& overlapping) const
+{
+    size_t firstOverlapping = overlapping.size();
+    float radiusSquared = radius * radius;
+    for (auto index = _pending.begin(); index != _pending.end(); index++)
+    {
+        const Region3f* pending = pendingBounds(*index);
+        if (pending && distanceSquared(*pending, center) <= radiusSquared)
+            overlapping.push_back(*index);
+    }
+
+    if (_nodes.size() > 0)
+    {
+        uint32_t stack[MaxDepth];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            uint32_t nodeId = stack[--stackSize];
+            const BVHNode& node = _nodes[nodeId];
+            if (distanceSquared(node.bounds, center) > radiusSquared)
+                continue;
+
+            if (node.right)
+            {
+                stack[stackSize++] = node.right;
+                stack[stackSize++] = nodeId + 1;
+                continue;
+            }
+            for (uint32_t slot = node.first; slot < node.first + node.count; slot++)
+            {
+                if (distanceSquared(_leafBounds[slot], center) <= radiusSquared)
+                    overlapping.push_back(_order[slot]);
+            }
+        }
+    }
+    std::sort(overlapping.begin() + firstOverlapping, overlapping.end());
+}
+
+void
+MeshBVH::nearest(const Vector3f& point, uint32_t count, std::vector<uint32_t>& nearest) const
+{
+    if (count == 0)
+        return;
+
+    // Best first: nodes by distance to their bounds, while a max heap
+    // keeps the closest count found so far.
+    typedef std::pair<float, uint32_t> Candidate;
+    std::priority_queue<Candidate> found;
+    auto consider = [&](float distance, uint32_t index)
+    {
+        if (found.size() < count)
+            found.push(Candidate(distance, index));
+        else if (distance < found.top().first)
+        {
+            found.pop();
+            found.push(Candidate(distance, index));
+        }
+    };
+
+    for (auto index = _pending.begin(); index != _pending.end(); index++)
+    {
+        const Region3f* bounds = pendingBounds(*index);
+        if (bounds)
+            consider(distanceSquared(*bounds, point), *index);
+    }
+
+    if (_nodes.size() > 0)
+    {
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > open;
+        open.push(Candidate(distanceSquared(_nodes[0].bounds, point), 0));
+        while (!open.empty())
+        {
+            Candidate current = open.top();
+            open.pop();
+            if (found.size() == count && current.first > found.top().first)
+                break;
+
+            const BVHNode& node = _nodes[current.second];
+            if (node.right)
+            {
+                open.push(Candidate(distanceSquared(_nodes[current.second + 1].bounds, point), current.second + 1));
+                open.push(Candidate(distanceSquared(_nodes[node.right].bounds, point), node.right));
+                continue;
+            }
+            for (uint32_t slot = node.first; slot < node.first + node.count; slot++)
+            {
+                consider(distanceSquared(_leafBounds[slot], point), _order[slot]);
+            }
+        }
+    }
+
+    size_t firstNearest = nearest.size();
+    nearest.resize(firstNearest + found.size());
+    for (size_t i = nearest.size(); i-- > firstNearest;)
+    {
+        nearest[i] = found.top().second;
+        found.pop();
+    }
+}
+
+}
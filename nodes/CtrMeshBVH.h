@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+#ifndef INCLUDED_CRT_MESH_BVH
+#define INCLUDED_CRT_MESH_BVH
+
+#include <CtrPlatform.h>
+#include <CtrRegion.h>
+
+namespace Ctr
+{
+class Mesh;
+class Frustum;
+
+//--------------------------------------------------------------------
+//
+// MeshBVH
+//
+// Bounding volume hierarchy over the world bounds of a set of meshes,
+// or over plain bounds such as probe positions.
+// Nodes are stored depth first; a node's left child directly follows
+// it and every node covers a contiguous range of the mesh ordering.
+//
+// The tree is built with binned SAH and refit when transforms move.
+// Refits that degrade its cost too far rebuild it, and meshes appended
+// after a build are tested one by one until there are enough of them
+// to be worth a rebuild.
+//
+//--------------------------------------------------------------------
+class MeshBVH
+{
+  public:
+    struct RayHit
+    {
+        uint32_t               index;
+        // Distance along the ray to the bounds, 0 when the ray starts inside.
+        float                  distance;
+    };
+
+    MeshBVH();
+    ~MeshBVH();
+
+    // Builds the tree over meshes. Indices returned by queries refer to this list.
+    void                       build(const std::vector<Mesh*>& meshes);
+    // Builds the tree over bounds, refit with refit(bounds).
+    void                       build(const std::vector<Region3f>& bounds);
+    void                       invalidate();
+    bool                       valid() const;
+
+    // Adds mesh as the next index without rebuilding. Invalidates the
+    // tree once enough meshes are pending.
+    void                       append(Mesh* mesh);
+
+    // Refreshes leaf bounds from the meshes, or from bounds, and refits
+    // the tree. Returns true if any bounds changed.
+    bool                       refit();
+    bool                       refit(const std::vector<Region3f>& bounds);
+
+    // Appends the sorted indices of meshes whose bounds intersect frustum.
+    // Meshes without bounds are always returned.
+    void                       cull(const Frustum& frustum,
+                                    std::vector<uint32_t>& visible) const;
+
+    // The remaining queries skip meshes without bounds.
+    // Nearest bounds entered by the ray within maxDistance.
+    bool                       intersect(const Vector3f& origin,
+                                         const Vector3f& direction,
+                                         float maxDistance,
+                                         RayHit& hit) const;
+    // Appends every bounds entered within maxDistance, nearest first.
+    void                       intersect(const Vector3f& origin,
+                                         const Vector3f& direction,
+                                         float maxDistance,
+                                         std::vector<RayHit>& hits) const;
+
+    // Appends the sorted indices of bounds overlapping the box or sphere.
+    void                       overlap(const Region3f& bounds,
+                                       std::vector<uint32_t>& overlapping) const;
+    void                       overlap(const Vector3f& center,
+                                       float radius,
+                                       std::vector<uint32_t>& overlapping) const;
+
+    // Appends up to count indices by distance from point to their
+    // bounds, nearest first.
+    void                       nearest(const Vector3f& point,
+                                       uint32_t count,
+                                       std::vector<uint32_t>& nearest) const;
+
+    size_t                     nodeCount() const;
+    size_t                     meshCount() const;
+
+  private:
+    struct BVHNode
+    {
+        Region3f               bounds;
+        uint32_t               first;
+        uint32_t               count;
+        // Index of the right child, 0 for leaves.
+        uint32_t               right;
+    };
+
+    void                       collectMeshes();
+    void                       buildTree();
+    uint32_t                   buildRecursive(uint32_t first, uint32_t count,
+                                              uint32_t depth,
+                                              std::vector<Vector3f>& centers);
+    void                       refitTree();
+    void                       refitNode(uint32_t nodeId);
+    float                      cost() const;
+    const Region3f*            pendingBounds(uint32_t index) const;
+
+    enum { MaxLeafSize = 4, MaxDepth = 64, SahBins = 16, MinPending = 16 };
+
+    std::vector<const Mesh*>   _meshes;
+    uint32_t                   _count;
+    std::vector<BVHNode>       _nodes;
+    // Mesh index for each slot of the tree ordering, and the slot bounds.
+    std::vector<uint32_t>      _order;
+    std::vector<Region3f>      _leafBounds;
+    std::vector<uint32_t>      _unbounded;
+    // Appended since the last build, see append.
+    std::vector<uint32_t>      _pending;
+    // SAH cost when built, refits past RebuildCostRatio times it rebuild.
+    float                      _buildCost;
+    bool                       _valid;
+};
+}
+
+#endif
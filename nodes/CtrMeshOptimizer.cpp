@@ -0,0 +1,495 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrMeshOptimizer.h>
+#include <CtrIndexedMesh.h>
+
+namespace Ctr
+{
+namespace
+{
+// Forsyth's scoring, with his suggested constants.
+const uint32_t ScoringCacheSize = 32;
+const float    CacheDecayPower = 1.5f;
+const float    LastTriangleScore = 0.75f;
+const float    ValenceBoostScale = 2.0f;
+const float    ValenceBoostPower = 0.5f;
+
+class VertexScoreTable
+{
+  public:
+    VertexScoreTable()
+    {
+        for (uint32_t position = 0; position < ScoringCacheSize; position++)
+        {
+            if (position < 3)
+            {
+                _cache[position] = LastTriangleScore;
+            }
+            else
+            {
+                float scaler = 1.0f / float(ScoringCacheSize - 3);
+                _cache[position] = powf(1.0f - float(position - 3) * scaler, CacheDecayPower);
+            }
+        }
+        for (uint32_t valence = 0; valence < MaxValence; valence++)
+        {
+            _valence[valence] = valence == 0 ? 0.0f :
+                ValenceBoostScale * powf(float(valence), -ValenceBoostPower);
+        }
+    }
+
+    float score(int32_t cachePosition, uint32_t liveTriangles) const
+    {
+        if (liveTriangles == 0)
+            return -1.0f;
+
+        float result = cachePosition >= 0 ? _cache[cachePosition] : 0.0f;
+        result += liveTriangles < MaxValence ? _valence[liveTriangles] :
+            ValenceBoostScale * powf(float(liveTriangles), -ValenceBoostPower);
+        return result;
+    }
+
+  private:
+    enum { MaxValence = 64 };
+    float                      _cache[ScoringCacheSize];
+    float                      _valence[MaxValence];
+};
+
+// FIFO cache simulation. A vertex is resident while fewer than cacheSize
+// misses have happened since it was last loaded.
+class FifoCache
+{
+  public:
+    FifoCache(size_t vertexCount, uint32_t cacheSize) :
+        _timestamps(vertexCount, 0),
+        _time(cacheSize + 1),
+        _cacheSize(cacheSize)
+    {
+    }
+
+    bool miss(uint32_t vertex)
+    {
+        if (_time - _timestamps[vertex] > _cacheSize)
+        {
+            _timestamps[vertex] = _time++;
+            return true;
+        }
+        return false;
+    }
+
+    void flush()
+    {
+        _time += _cacheSize + 1;
+    }
+
+  private:
+    std::vector<uint32_t>      _timestamps;
+    uint32_t                   _time;
+    uint32_t                   _cacheSize;
+};
+
+bool
+validIndices(const uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        if (indices[i] >= vertexCount)
+            return false;
+    }
+    return indexCount % 3 == 0;
+}
+}
+
+MeshOptimizer::CacheStats
+MeshOptimizer::analyzeVertexCache(const uint32_t* indices, size_t indexCount,
+                                  size_t vertexCount, uint32_t cacheSize)
+{
+    CacheStats stats = { 0.0f, 0.0f };
+    if (indexCount < 3 || !validIndices(indices, indexCount, vertexCount))
+        return stats;
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    size_t misses = 0;
+    size_t uniqueVertices = 0;
+
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        uint32_t vertex = indices[i];
+        if (cache.miss(vertex))
+            misses++;
+        if (!referenced[vertex])
+        {
+            referenced[vertex] = true;
+            uniqueVertices++;
+        }
+    }
+
+    stats.acmr = float(misses) / float(indexCount / 3);
+    stats.atvr = float(misses) / float(uniqueVertices);
+    return stats;
+}
+
+void
+MeshOptimizer::optimizeVertexCache(uint32_t* indices, size_t indexCount,
+                                   size_t vertexCount)
+{
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2 || !validIndices(indices, indexCount, vertexCount))
+        return;
+
+    static const VertexScoreTable scoreTable;
+
+    // Triangles adjacent to each vertex. Emitted triangles are swapped past
+    // the live count of each of their vertices.
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        liveTriangles[indices[i]]++;
+    }
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + liveTriangles[vertex];
+    }
+
+    std::vector<uint32_t> adjacency(indexCount);
+    {
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                adjacency[fill[indices[triangle * 3 + corner]]++] = uint32_t(triangle);
+            }
+        }
+    }
+
+    std::vector<int32_t> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        vertexScores[vertex] = scoreTable.score(-1, liveTriangles[vertex]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    for (size_t triangle = 0; triangle < triangleCount; triangle++)
+    {
+        triangleScores[triangle] = vertexScores[indices[triangle * 3]] +
+                                   vertexScores[indices[triangle * 3 + 1]] +
+                                   vertexScores[indices[triangle * 3 + 2]];
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> result(indexCount);
+
+    uint32_t cache[ScoringCacheSize + 3];
+    uint32_t nextCache[ScoringCacheSize + 3];
+    uint32_t cacheCount = 0;
+
+    int64_t bestTriangle = std::max_element(triangleScores.begin(), triangleScores.end()) - 
+                           triangleScores.begin();
+    size_t scanCursor = 0;
+
+    for (size_t output = 0; output < triangleCount; output++)
+    {
+        if (bestTriangle < 0)
+        {
+            // Dead end, restart from the first triangle not yet emitted.
+            while (emitted[scanCursor])
+                scanCursor++;
+            bestTriangle = int64_t(scanCursor);
+        }
+
+        const uint32_t* corners = &indices[bestTriangle * 3];
+        memcpy(&result[output * 3], corners, sizeof(uint32_t) * 3);
+        emitted[size_t(bestTriangle)] = true;
+
+        // Retire the triangle from its vertices' live lists.
+        for (size_t corner = 0; corner < 3; corner++)
+        {
+            uint32_t vertex = corners[corner];
+            uint32_t* live = &adjacency[adjacencyOffsets[vertex]];
+            uint32_t count = liveTriangles[vertex];
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (live[i] == uint32_t(bestTriangle))
+                {
+                    std::swap(live[i], live[count - 1]);
+                    break;
+                }
+            }
+            liveTriangles[vertex]--;
+        }
+
+        // Move the triangle's vertices to the front of the LRU cache.
+        uint32_t nextCount = 0;
+        for (size_t corner = 0; corner < 3; corner++)
+        {
+            if (std::find(nextCache, nextCache + nextCount, corners[corner]) == nextCache + nextCount)
+                nextCache[nextCount++] = corners[corner];
+        }
+        for (uint32_t i = 0; i < cacheCount; i++)
+        {
+            uint32_t vertex = cache[i];
+            if (vertex != corners[0] && vertex != corners[1] && vertex != corners[2])
+            {
+                nextCache[nextCount++] = vertex;
+            }
+        }
+
+        // Rescore everything that moved, including vertices pushed out.
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (uint32_t i = 0; i < nextCount; i++)
+        {
+            uint32_t vertex = nextCache[i];
+            int32_t position = i < ScoringCacheSize ? int32_t(i) : -1;
+            cachePositions[vertex] = position;
+
+            float score = scoreTable.score(position, liveTriangles[vertex]);
+            float delta = score - vertexScores[vertex];
+            vertexScores[vertex] = score;
+
+            const uint32_t* live = &adjacency[adjacencyOffsets[vertex]];
+            for (uint32_t j = 0; j < liveTriangles[vertex]; j++)
+            {
+                uint32_t triangle = live[j];
+                triangleScores[triangle] += delta;
+                if (triangleScores[triangle] > bestScore)
+                {
+                    bestScore = triangleScores[triangle];
+                    bestTriangle = triangle;
+                }
+            }
+        }
+
+        cacheCount = std::min(nextCount, ScoringCacheSize);
+        memcpy(cache, nextCache, sizeof(uint32_t) * cacheCount);
+    }
+
+    memcpy(indices, &result[0], sizeof(uint32_t) * indexCount);
+}
+
+uint32_t
+MeshOptimizer::optimizeOverdraw(uint32_t* indices, size_t indexCount,
+                                const Vector3f* positions, size_t vertexCount,
+                                float threshold)
+{
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2 || !validIndices(indices, indexCount, vertexCount))
+        return triangleCount > 0 ? 1 : 0;
+
+    const uint32_t cacheSize = 16;
+
+    // Hard boundaries fall where every vertex of a triangle misses, since
+    // reordering there cannot make the cache any worse.
+    std::vector<uint32_t> hardBoundaries;
+    size_t meshMisses = 0;
+    {
+        FifoCache cache(vertexCount, cacheSize);
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            uint32_t misses = 0;
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                misses += cache.miss(indices[triangle * 3 + corner]) ? 1 : 0;
+            }
+            if (misses == 3)
+                hardBoundaries.push_back(uint32_t(triangle));
+            meshMisses += misses;
+        }
+        hardBoundaries.push_back(uint32_t(triangleCount));
+    }
+
+    // Soft boundaries split a cluster once its own ACMR, from a cold cache,
+    // has come back down to threshold times the mesh ACMR.
+    float acmrLimit = threshold * float(meshMisses) / float(triangleCount);
+    std::vector<uint32_t> clusterStarts;
+    {
+        FifoCache cache(vertexCount, cacheSize);
+        for (size_t hard = 0; hard + 1 < hardBoundaries.size(); hard++)
+        {
+            uint32_t start = hardBoundaries[hard];
+            uint32_t end = hardBoundaries[hard + 1];
+
+            cache.flush();
+            clusterStarts.push_back(start);
+            size_t clusterMisses = 0;
+            for (uint32_t triangle = start; triangle < end; triangle++)
+            {
+                for (size_t corner = 0; corner < 3; corner++)
+                {
+                    clusterMisses += cache.miss(indices[triangle * 3 + corner]) ? 1 : 0;
+                }
+
+                uint32_t clusterTriangles = triangle + 1 - clusterStarts.back();
+                if (triangle + 1 < end &&
+                    float(clusterMisses) / float(clusterTriangles) <= acmrLimit)
+                {
+                    cache.flush();
+                    clusterStarts.push_back(triangle + 1);
+                    clusterMisses = 0;
+                }
+            }
+        }
+        clusterStarts.push_back(uint32_t(triangleCount));
+    }
+
+    size_t clusterCount = clusterStarts.size() - 1;
+
+    // Area weighted centroid and normal of each cluster.
+    std::vector<Vector3f> centroids(clusterCount);
+    std::vector<Vector3f> normals(clusterCount);
+    Vector3f meshCentroid(0.0f);
+    float meshArea = 0.0f;
+
+    for (size_t cluster = 0; cluster < clusterCount; cluster++)
+    {
+        Vector3f centroid(0.0f);
+        Vector3f normal(0.0f);
+        float area = 0.0f;
+
+        for (uint32_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; triangle++)
+        {
+            const Vector3f& a = positions[indices[triangle * 3]];
+            const Vector3f& b = positions[indices[triangle * 3 + 1]];
+            const Vector3f& c = positions[indices[triangle * 3 + 2]];
+
+            Vector3f weightedNormal = (b - a).cross(c - a);
+            float triangleArea = weightedNormal.length();
+
+            centroid += (a + b + c) * (triangleArea / 3.0f);
+            normal += weightedNormal;
+            area += triangleArea;
+        }
+
+        meshCentroid += centroid;
+        meshArea += area;
+        centroids[cluster] = area > 0.0f ? centroid * (1.0f / area) : centroid;
+        normals[cluster] = normal.normalized();
+    }
+    if (meshArea > 0.0f)
+        meshCentroid *= 1.0f / meshArea;
+
+    // Clusters facing away from the centre are likely occluders, draw them first.
+    std::vector<float> sortKeys(clusterCount);
+    std::vector<uint32_t> order(clusterCount);
+    for (size_t cluster = 0; cluster < clusterCount; cluster++)
+    {
+        sortKeys[cluster] = (centroids[cluster] - meshCentroid).dot(normals[cluster]);
+        order[cluster] = uint32_t(cluster);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+    {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    std::vector<uint32_t> result;
+    result.reserve(indexCount);
+    for (size_t i = 0; i < clusterCount; i++)
+    {
+        uint32_t cluster = order[i];
+        result.insert(result.end(),
+                      indices + clusterStarts[cluster] * 3,
+                      indices + clusterStarts[cluster + 1] * 3);
+    }
+    memcpy(indices, &result[0], sizeof(uint32_t) * indexCount);
+
+    return uint32_t(clusterCount);
+}
+
+uint32_t
+MeshOptimizer::optimizeVertexFetch(uint32_t* indices, size_t indexCount,
+                                   size_t vertexCount,
+                                   std::vector<uint32_t>& remap)
+{
+    remap.assign(vertexCount, ~0u);
+    if (!validIndices(indices, indexCount, vertexCount))
+    {
+        for (size_t vertex = 0; vertex < vertexCount; vertex++)
+            remap[vertex] = uint32_t(vertex);
+        return uint32_t(vertexCount);
+    }
+
+    uint32_t nextVertex = 0;
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        uint32_t& target = remap[indices[i]];
+        if (target == ~0u)
+            target = nextVertex++;
+        indices[i] = target;
+    }
+    return nextVertex;
+}
+
+bool
+MeshOptimizer::optimize(IndexedMeshData& mesh, Report* report)
+{
+    size_t vertexCount = mesh.positions.size();
+    size_t indexCount = mesh.indices.size();
+    if (indexCount < 3 || !validIndices(&mesh.indices[0], indexCount, vertexCount))
+        return false;
+
+    uint32_t* indices = &mesh.indices[0];
+    CacheStats before = analyzeVertexCache(indices, indexCount, vertexCount);
+
+    optimizeVertexCache(indices, indexCount, vertexCount);
+    uint32_t clusters = optimizeOverdraw(indices, indexCount, &mesh.positions[0], vertexCount);
+
+    std::vector<uint32_t> remap;
+    uint32_t newVertexCount = optimizeVertexFetch(indices, indexCount, vertexCount, remap);
+    mesh.remap(remap, newVertexCount);
+
+    if (report)
+    {
+        report->before = before;
+        report->after = analyzeVertexCache(indices, indexCount, newVertexCount);
+        report->triangles = uint32_t(indexCount / 3);
+        report->vertices = newVertexCount;
+        report->clusters = clusters;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_MESH_OPTIMIZER
+#define INCLUDED_CRT_MESH_OPTIMIZER
+
+#include <CtrPlatform.h>
+#include <CtrVector3.h>
+
+namespace Ctr
+{
+struct IndexedMeshData;
+
+//--------------------------------------------------------------------
+//
+// MeshOptimizer
+//
+// Import time reordering of triangle lists. Triangles are ordered for
+// the post transform vertex cache (Forsyth), then split into clusters
+// at cache boundaries and the clusters sorted outside in to reduce
+// overdraw (after Tipsify), and finally vertices are renumbered in
+// first use order for fetch locality. Only host data is touched, so
+// meshes can be optimized concurrently.
+//
+//--------------------------------------------------------------------
+class MeshOptimizer
+{
+  public:
+    struct CacheStats
+    {
+        // Vertex shader invocations per triangle, 0.5 at best and 3 at worst.
+        float                  acmr;
+        // Vertex shader invocations per referenced vertex, 1 at best.
+        float                  atvr;
+    };
+
+    struct Report
+    {
+        CacheStats             before;
+        CacheStats             after;
+        uint32_t               triangles;
+        uint32_t               vertices;
+        uint32_t               clusters;
+    };
+
+    // Simulates a FIFO cache of cacheSize entries, the usual hardware model.
+    static CacheStats          analyzeVertexCache(const uint32_t* indices, size_t indexCount,
+                                                  size_t vertexCount, uint32_t cacheSize = 16);
+
+    static void                optimizeVertexCache(uint32_t* indices, size_t indexCount,
+                                                   size_t vertexCount);
+
+    // Reorders clusters of an optimizeVertexCache ordering. threshold is the
+    // ACMR increase allowed for shorter clusters; returns the cluster count.
+    static uint32_t            optimizeOverdraw(uint32_t* indices, size_t indexCount,
+                                                const Vector3f* positions, size_t vertexCount,
+                                                float threshold = 1.05f);
+
+    // Fills remap with the new index of each vertex, ~0u for unreferenced
+    // ones, and rewrites indices. Returns the new vertex count.
+    static uint32_t            optimizeVertexFetch(uint32_t* indices, size_t indexCount,
+                                                   size_t vertexCount,
+                                                   std::vector<uint32_t>& remap);
+
+    // All three stages on an imported mesh, streams included.
+    static bool                optimize(IndexedMeshData& mesh, Report* report = nullptr);
+};
+}
+
+#endif
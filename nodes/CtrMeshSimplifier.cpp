@@ -0,0 +1,482 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrMeshSimplifier.h>
+#include <CtrMeshOptimizer.h>
+#include <CtrIndexedMesh.h>
+#include <unordered_map>
+
+namespace Ctr
+{
+namespace
+{
+// Weight of the planes through open border edges, against the area
+// weighted face planes. Keeps the outline of open meshes in place.
+const double BorderWeight = 10.0;
+// Weight of squared normal and uv differences, scaled by the squared
+// length of the collapsed edge in the unit cube.
+const double AttributeWeight = 0.1;
+// A level that keeps more than this fraction of its parent's triangles
+// is stuck on locked vertices and is dropped.
+const float  MinLevelReduction = 0.9f;
+
+enum VertexKind
+{
+    Manifold,
+    Border,
+    Locked
+};
+
+// Symmetric 4x4 quadric of weighted squared plane distances.
+struct Quadric
+{
+    Quadric() : 
+        a00(0), a01(0), a02(0), a11(0), a12(0), a22(0),
+        b0(0), b1(0), b2(0), c(0), w(0)
+    {
+    }
+
+    void addPlane(double nx, double ny, double nz, double d, double weight)
+    {
+        a00 += weight * nx * nx; a01 += weight * nx * ny; a02 += weight * nx * nz;
+        a11 += weight * ny * ny; a12 += weight * ny * nz; a22 += weight * nz * nz;
+        b0 += weight * nx * d; b1 += weight * ny * d; b2 += weight * nz * d;
+        c += weight * d * d;
+        w += weight;
+    }
+
+    void add(const Quadric& q)
+    {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02;
+        a11 += q.a11; a12 += q.a12; a22 += q.a22;
+        b0 += q.b0; b1 += q.b1; b2 += q.b2;
+        c += q.c;
+        w += q.w;
+    }
+
+    // Mean squared distance of p to the planes.
+    double error(const Vector3f& p) const
+    {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a00 * x * x + a11 * y * y + a22 * z * z +
+                   2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                   2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return w > 0 ? std::max(e, 0.0) / w : 0.0;
+    }
+
+    double a00, a01, a02, a11, a12, a22;
+    double b0, b1, b2;
+    double c;
+    double w;
+};
+
+struct Collapse
+{
+    uint32_t                   vertex;
+    uint32_t                   target;
+    double                     cost;
+
+    bool operator<(const Collapse& other) const { return cost < other.cost; }
+};
+
+inline uint64_t
+edgeKey(uint32_t a, uint32_t b)
+{
+    return (uint64_t(a) << 32) | b;
+}
+
+inline Vector3f
+faceNormal(const Vector3f& a, const Vector3f& b, const Vector3f& c)
+{
+    return (b - a).cross(c - a);
+}
+
+// Maps every vertex to the first vertex at the same position.
+void
+buildCanonical(const Vector3f* positions, size_t vertexCount, 
+               std::vector<uint32_t>& canonical)
+{
+    std::vector<uint32_t> order(vertexCount);
+    for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+        order[vertex] = vertex;
+
+    std::sort(order.begin(), order.end(), [positions](uint32_t a, uint32_t b)
+    {
+        int compare = memcmp(&positions[a], &positions[b], sizeof(Vector3f));
+        return compare < 0 || (compare == 0 && a < b);
+    });
+
+    canonical.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        uint32_t vertex = order[i];
+        bool same = i > 0 && memcmp(&positions[order[i - 1]], &positions[vertex], sizeof(Vector3f)) == 0;
+        canonical[vertex] = same ? canonical[order[i - 1]] : vertex;
+    }
+}
+
+double
+attributeDistance(const Vector3f* normals, const Vector2f* uvs, uint32_t a, uint32_t b)
+{
+    double distance = 0;
+    if (normals)
+        distance += (normals[a] - normals[b]).lengthSquared();
+    if (uvs)
+    {
+        Vector2f delta = uvs[a] - uvs[b];
+        distance += delta.x * delta.x + delta.y * delta.y;
+    }
+    return distance;
+}
+}
+
+float
+MeshSimplifier::simplify(std::vector<uint32_t>& indices,
+                         const Vector3f* positions,
+                         const Vector3f* normals,
+                         const Vector2f* uvs,
+                         size_t vertexCount,
+                         size_t targetIndexCount,
+                         float maxError)
+{
+    if (indices.size() <= targetIndexCount || vertexCount == 0)
+        return 0.0f;
+
+    // Costs are measured in the unit cube so the weights are scale free.
+    Vector3f minExtent = positions[0], maxExtent = positions[0];
+    for (size_t vertex = 1; vertex < vertexCount; vertex++)
+    {
+        minExtent = Vector3f(std::min(minExtent.x, positions[vertex].x),
+                             std::min(minExtent.y, positions[vertex].y),
+                             std::min(minExtent.z, positions[vertex].z));
+        maxExtent = Vector3f(std::max(maxExtent.x, positions[vertex].x),
+                             std::max(maxExtent.y, positions[vertex].y),
+                             std::max(maxExtent.z, positions[vertex].z));
+    }
+    Vector3f size = maxExtent - minExtent;
+    float extent = std::max(size.x, std::max(size.y, size.z));
+    float scale = extent > 0 ? 1.0f / extent : 1.0f;
+
+    std::vector<Vector3f> points(vertexCount);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+        points[vertex] = (positions[vertex] - minExtent) * scale;
+
+    // Wedges: vertices sharing a position with different attributes.
+    std::vector<uint32_t> canonical;
+    buildCanonical(positions, vertexCount, canonical);
+    std::vector<uint32_t> wedges(vertexCount, 0);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+        wedges[canonical[vertex]]++;
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const Vector3f& p0 = points[indices[i]];
+        Vector3f normal = faceNormal(p0, points[indices[i + 1]], points[indices[i + 2]]);
+        float area = normal.length();
+        if (area <= 0)
+            continue;
+
+        normal = normal * (1.0f / area);
+        double d = -normal.dot(p0);
+        for (size_t corner = 0; corner < 3; corner++)
+            quadrics[canonical[indices[i + corner]]].addPlane(normal.x, normal.y, normal.z, d, area * 0.5);
+    }
+
+    const double maxCost = maxError < FLT_MAX ? double(maxError) * scale * maxError * scale : DBL_MAX;
+    double resultCost = 0;
+
+    std::vector<uint32_t> result(indices);
+    std::vector<uint8_t> kinds(vertexCount);
+    std::vector<uint8_t> touched(vertexCount);
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> collapses;
+    std::unordered_map<uint64_t, uint32_t> edges;
+    bool bordersAdded = false;
+
+    while (result.size() > targetIndexCount)
+    {
+        // Classify against the current triangles, in position space.
+        edges.clear();
+        for (size_t i = 0; i + 2 < result.size(); i += 3)
+        {
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                uint32_t a = canonical[result[i + corner]];
+                uint32_t b = canonical[result[i + (corner + 1) % 3]];
+                edges[edgeKey(a, b)]++;
+            }
+        }
+
+        for (size_t vertex = 0; vertex < vertexCount; vertex++)
+            kinds[vertex] = wedges[canonical[vertex]] > 1 ? Locked : Manifold;
+
+        for (auto it = edges.begin(); it != edges.end(); it++)
+        {
+            uint32_t a = uint32_t(it->first >> 32), b = uint32_t(it->first);
+            if (it->second > 1)
+            {
+                kinds[a] = kinds[b] = Locked;
+            }
+            else if (edges.find(edgeKey(b, a)) == edges.end())
+            {
+                if (kinds[a] == Manifold) kinds[a] = Border;
+                if (kinds[b] == Manifold) kinds[b] = Border;
+            }
+        }
+
+        // Planes through the open borders of the input hold them in place.
+        if (!bordersAdded)
+        {
+            bordersAdded = true;
+            for (size_t i = 0; i + 2 < result.size(); i += 3)
+            {
+                Vector3f normal = faceNormal(points[result[i]], points[result[i + 1]], points[result[i + 2]]);
+                for (size_t corner = 0; corner < 3; corner++)
+                {
+                    uint32_t a = canonical[result[i + corner]];
+                    uint32_t b = canonical[result[i + (corner + 1) % 3]];
+                    if (edges.find(edgeKey(b, a)) != edges.end())
+                        continue;
+
+                    Vector3f edge = points[b] - points[a];
+                    Vector3f plane = edge.cross(normal);
+                    float length = plane.length();
+                    if (length <= 0)
+                        continue;
+
+                    plane = plane * (1.0f / length);
+                    double d = -plane.dot(points[a]);
+                    double weight = BorderWeight * edge.lengthSquared();
+                    quadrics[a].addPlane(plane.x, plane.y, plane.z, d, weight);
+                    quadrics[b].addPlane(plane.x, plane.y, plane.z, d, weight);
+                }
+            }
+        }
+
+        // Triangles around each vertex.
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (size_t i = 0; i < result.size(); i++)
+            adjacencyOffsets[result[i] + 1]++;
+        for (size_t vertex = 0; vertex < vertexCount; vertex++)
+            adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+        adjacency.resize(result.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < result.size(); i++)
+                adjacency[fill[result[i]]++] = uint32_t(i / 3);
+        }
+
+        // The cheapest collapse of every vertex that may be removed. A
+        // vertex that is not Locked has a single wedge, so it is its own
+        // canonical vertex.
+        collapses.clear();
+        for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+        {
+            if (kinds[vertex] == Locked || adjacencyOffsets[vertex] == adjacencyOffsets[vertex + 1])
+                continue;
+
+            Collapse best = { vertex, vertex, DBL_MAX };
+            for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; a++)
+            {
+                const uint32_t* triangle = &result[adjacency[a] * 3];
+                for (size_t corner = 0; corner < 3; corner++)
+                {
+                    uint32_t target = triangle[corner];
+                    uint32_t c = canonical[target];
+                    if (c == vertex)
+                        continue;
+
+                    // Borders collapse along border edges only.
+                    if (kinds[vertex] == Border &&
+                        (kinds[c] == Manifold ||
+                         (edges.find(edgeKey(vertex, c)) != edges.end() &&
+                          edges.find(edgeKey(c, vertex)) != edges.end())))
+                        continue;
+
+                    Quadric quadric = quadrics[vertex];
+                    quadric.add(quadrics[c]);
+                    double cost = quadric.error(points[target]) + 
+                        AttributeWeight * attributeDistance(normals, uvs, vertex, target) *
+                        (points[target] - points[vertex]).lengthSquared();
+                    if (cost < best.cost)
+                    {
+                        best.target = target;
+                        best.cost = cost;
+                    }
+                }
+            }
+            if (best.target != vertex)
+                collapses.push_back(best);
+        }
+        std::sort(collapses.begin(), collapses.end());
+
+        // Collapses of one pass must not share triangles, so each flip
+        // test sees the triangles as they will be rewritten.
+        std::fill(touched.begin(), touched.end(), 0);
+        for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+            remap[vertex] = vertex;
+
+        size_t removeTriangles = (result.size() - targetIndexCount) / 3;
+        size_t removed = 0;
+        size_t applied = 0;
+        for (auto it = collapses.begin(); it != collapses.end() && removed < std::max(removeTriangles, size_t(1)); it++)
+        {
+            const Collapse& collapse = *it;
+            if (collapse.cost > maxCost)
+                break;
+
+            uint32_t vertex = collapse.vertex;
+            uint32_t target = collapse.target;
+            uint32_t targetCanonical = canonical[target];
+            if (touched[vertex] || touched[targetCanonical])
+                continue;
+
+            bool flips = false;
+            size_t collapsing = 0;
+            for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1] && !flips; a++)
+            {
+                const uint32_t* triangle = &result[adjacency[a] * 3];
+                if (canonical[triangle[0]] == targetCanonical ||
+                    canonical[triangle[1]] == targetCanonical ||
+                    canonical[triangle[2]] == targetCanonical)
+                {
+                    collapsing++;
+                    continue;
+                }
+
+                Vector3f before = faceNormal(points[triangle[0]], points[triangle[1]], points[triangle[2]]);
+                Vector3f after = faceNormal(triangle[0] == vertex ? points[target] : points[triangle[0]],
+                                            triangle[1] == vertex ? points[target] : points[triangle[1]],
+                                            triangle[2] == vertex ? points[target] : points[triangle[2]]);
+                flips = before.dot(after) <= 0;
+            }
+            if (flips)
+                continue;
+
+            remap[vertex] = target;
+            quadrics[targetCanonical].add(quadrics[vertex]);
+            resultCost = std::max(resultCost, collapse.cost);
+
+            for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; a++)
+            {
+                const uint32_t* triangle = &result[adjacency[a] * 3];
+                for (size_t corner = 0; corner < 3; corner++)
+                    touched[canonical[triangle[corner]]] = 1;
+            }
+            removed += collapsing;
+            applied++;
+        }
+
+        if (applied == 0)
+            break;
+
+        // Rewrite, dropping triangles that lost their area.
+        size_t write = 0;
+        for (size_t i = 0; i + 2 < result.size(); i += 3)
+        {
+            uint32_t a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+            if (canonical[a] == canonical[b] || canonical[b] == canonical[c] || canonical[c] == canonical[a])
+                continue;
+
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    indices.swap(result);
+    return float(sqrt(resultCost)) / scale;
+}
+
+bool
+MeshSimplifier::buildLodChain(IndexedMeshData& mesh, uint32_t maxLevels, float reduction,
+                              uint32_t minTriangles, Report* report)
+{
+    mesh.lodIndices.clear();
+    mesh.lodErrors.clear();
+
+    size_t vertexCount = mesh.positions.size();
+    if (mesh.indices.size() < 3 || vertexCount == 0)
+        return false;
+
+    for (size_t i = 0; i < mesh.indices.size(); i++)
+    {
+        if (mesh.indices[i] >= vertexCount)
+            return false;
+    }
+
+    const Vector3f* normals = mesh.normals.size() == vertexCount ? &mesh.normals[0] : nullptr;
+    const Vector2f* uvs = mesh.uvs.size() == vertexCount ? &mesh.uvs[0] : nullptr;
+
+    // Each level simplifies the one before, so errors add up.
+    std::vector<uint32_t> indices(mesh.indices);
+    float error = 0.0f;
+    while (mesh.lodIndices.size() < maxLevels)
+    {
+        size_t triangles = indices.size() / 3;
+        size_t targetTriangles = size_t(float(triangles) * reduction);
+        if (targetTriangles < minTriangles)
+            break;
+
+        error += simplify(indices, &mesh.positions[0], normals, uvs, vertexCount, targetTriangles * 3);
+        if (indices.size() / 3 > size_t(float(triangles) * MinLevelReduction))
+            break;
+
+        MeshOptimizer::optimizeVertexCache(&indices[0], indices.size(), vertexCount);
+        mesh.lodIndices.push_back(indices);
+        mesh.lodErrors.push_back(error);
+    }
+
+    if (report)
+    {
+        report->triangles = uint32_t(mesh.indices.size() / 3);
+        report->levels = uint32_t(mesh.lodIndices.size());
+        report->lodTriangles = mesh.lodIndices.size() > 0 ?
+            uint32_t(mesh.lodIndices.back().size() / 3) : report->triangles;
+    }
+    return mesh.lodIndices.size() > 0;
+}
+
+}
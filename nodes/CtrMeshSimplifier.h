@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_MESH_SIMPLIFIER
+#define INCLUDED_CRT_MESH_SIMPLIFIER
+
+#include <CtrPlatform.h>
+#include <CtrVector3.h>
+#include <CtrVector2.h>
+
+namespace Ctr
+{
+struct IndexedMeshData;
+
+//--------------------------------------------------------------------
+//
+// MeshSimplifier
+//
+// Import time level of detail generation. Edges are collapsed in
+// order of quadric error (Garland and Heckbert) with a penalty for
+// normal and uv differences. Collapses only ever move a vertex onto a
+// neighbour, so every level indexes the vertex streams of the full
+// mesh and all levels can share one vertex buffer.
+//
+// Vertices on uv or normal seams, where wedges with different
+// attributes share a position, and on non manifold edges are never
+// removed, so seams stay watertight. Open borders only collapse along
+// themselves.
+//
+//--------------------------------------------------------------------
+class MeshSimplifier
+{
+  public:
+    struct Report
+    {
+        uint32_t               triangles;
+        uint32_t               levels;
+        // Triangles of the coarsest level.
+        uint32_t               lodTriangles;
+    };
+
+    // Simplifies indices in place until at most targetIndexCount remain,
+    // no collapse is possible or the next one would exceed maxError.
+    // normals and uvs may be null. Returns the object space error.
+    static float               simplify(std::vector<uint32_t>& indices,
+                                        const Vector3f* positions,
+                                        const Vector3f* normals,
+                                        const Vector2f* uvs,
+                                        size_t vertexCount,
+                                        size_t targetIndexCount,
+                                        float maxError = FLT_MAX);
+
+    // Fills mesh.lodIndices and mesh.lodErrors with up to maxLevels
+    // coarser levels, each with about reduction times the triangles of
+    // the one before. Stops at minTriangles or when the mesh no longer
+    // reduces.
+    static bool                buildLodChain(IndexedMeshData& mesh,
+                                             uint32_t maxLevels = 4,
+                                             float reduction = 0.5f,
+                                             uint32_t minTriangles = 64,
+                                             Report* report = nullptr);
+};
+}
+
+#endif
@@ -0,0 +1,855 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrObjReader.h>
+#include <CtrLog.h>
+#include <CtrParallel.h>
+#include <thread>
+
+#if !(_WIN32 || _WIN64)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Ctr
+{
+namespace
+{
+// Small files stay on one chunk, larger ones get a few per thread so
+// chunks heavy in faces do not hold up the rest.
+const size_t MinimumChunkBytes = 1 << 20;
+const size_t ChunksPerThread = 4;
+const uint32_t NoIndex = 0xffffffff;
+
+//------------------------------------------------------
+// Read only view of a whole file. Mapped where the
+// platform allows it, read into memory otherwise.
+//------------------------------------------------------
+class FileView
+{
+  public:
+    FileView();
+    ~FileView();
+
+    bool                       open(const std::string& filePathName);
+
+    const char*                begin() const { return _data; }
+    const char*                end() const { return _data + _size; }
+    size_t                     size() const { return _size; }
+    bool                       mapped() const { return _mapped; }
+
+  private:
+    const char*                _data;
+    size_t                     _size;
+    bool                       _mapped;
+    std::vector<char>          _buffer;
+#if _WIN32 || _WIN64
+    HANDLE                     _file;
+    HANDLE                     _mapping;
+#else
+    int                        _file;
+#endif
+};
+
+FileView::FileView() :
+    _data(nullptr),
+    _size(0),
+    _mapped(false),
+#if _WIN32 || _WIN64
+    _file(INVALID_HANDLE_VALUE),
+    _mapping(nullptr)
+#else
+    _file(-1)
+#endif
+{
+}
+
+FileView::~FileView()
+{
+#if _WIN32 || _WIN64
+    if (_mapped)
+        UnmapViewOfFile(_data);
+    if (_mapping)
+        CloseHandle(_mapping);
+    if (_file != INVALID_HANDLE_VALUE)
+        CloseHandle(_file);
+#else
+    if (_mapped)
+        munmap(const_cast<char*>(_data), _size);
+    if (_file >= 0)
+        close(_file);
+#endif
+}
+
+bool
+FileView::open(const std::string& filePathName)
+{
+    uint64_t fileSize = 0;
+#if _WIN32 || _WIN64
+    _file = CreateFileA(filePathName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, 
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(_file, &size))
+        return false;
+    fileSize = uint64_t(size.QuadPart);
+    if (fileSize == 0 || fileSize > uint64_t(SIZE_MAX))
+        return fileSize == 0;
+    _size = size_t(fileSize);
+
+    _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mapping)
+    {
+        _data = (const char*)(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        _mapped = _data != nullptr;
+    }
+#else
+    _file = ::open(filePathName.c_str(), O_RDONLY);
+    if (_file < 0)
+        return false;
+
+    struct stat status;
+    if (fstat(_file, &status) != 0)
+        return false;
+    fileSize = uint64_t(status.st_size);
+    if (fileSize == 0 || fileSize > uint64_t(SIZE_MAX))
+        return fileSize == 0;
+    _size = size_t(fileSize);
+
+    void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _file, 0);
+    if (data != MAP_FAILED)
+    {
+        _data = (const char*)(data);
+        _mapped = true;
+    }
+#endif
+    if (_mapped)
+        return true;
+
+    // Address space or mapping limits, fall back to a plain read.
+    std::ifstream stream(filePathName.c_str(), std::ios::binary);
+    if (!stream)
+        return false;
+    _buffer.resize(_size);
+    stream.read(&_buffer[0], _size);
+    if (size_t(stream.gcount()) != _size)
+        return false;
+    _data = &_buffer[0];
+    return true;
+}
+
+struct Corner
+{
+    uint32_t                   position;
+    uint32_t                   uv;
+    uint32_t                   normal;
+
+    bool operator == (const Corner& other) const
+    {
+        return position == other.position && uv == other.uv && normal == other.normal;
+    }
+};
+
+inline uint32_t
+hashCorner(const Corner& corner)
+{
+    uint32_t h = corner.position * 0x9e3779b1u;
+    h ^= corner.uv * 0x85ebca77u + (h << 6) + (h >> 2);
+    h ^= corner.normal * 0xc2b2ae3du + (h << 6) + (h >> 2);
+    return h ^ (h >> 15);
+}
+
+// Starts a new shape, or renames the open one when it has no faces yet.
+struct Event
+{
+    enum Type
+    {
+        Group,
+        UseMaterial
+    };
+
+    Type                       type;
+    size_t                     triangle;
+    std::string                name;
+};
+
+struct Chunk
+{
+    const char*                begin;
+    const char*                end;
+
+    // Counted by the first pass, the bases are their prefix sums.
+    uint32_t                   lines;
+    uint32_t                   positions;
+    uint32_t                   uvs;
+    uint32_t                   normals;
+    uint32_t                   firstLine;
+    uint32_t                   positionBase;
+    uint32_t                   uvBase;
+    uint32_t                   normalBase;
+
+    // Three corners per triangle, in file order.
+    std::vector<Corner>        corners;
+    std::vector<Event>         events;
+    std::vector<std::string>   materialLibraries;
+    std::string                error;
+};
+
+// A run of triangles of one chunk belonging to a shape.
+struct Span
+{
+    size_t                     chunk;
+    size_t                     first;
+    size_t                     last;
+};
+
+struct ShapeSpans
+{
+    std::string                name;
+    std::string                material;
+    std::vector<Span>          spans;
+    size_t                     triangles;
+};
+
+inline bool
+isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool
+isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline const char*
+skipBlanks(const char* p, const char* end)
+{
+    while (p < end && isBlank(*p))
+        p++;
+    return p;
+}
+
+inline const char*
+findLineEnd(const char* p, const char* end)
+{
+    const char* newline = (const char*)(memchr(p, '\n', end - p));
+    return newline ? newline : end;
+}
+
+// True when the line starts with the statement, followed by a blank or
+// the end of the line.
+inline bool
+isStatement(const char* p, const char* end, const char* statement, size_t length)
+{
+    if (size_t(end - p) < length || memcmp(p, statement, length) != 0)
+        return false;
+    return p + length == end || isBlank(p[length]);
+}
+
+// The rest of the line with surrounding blanks removed.
+std::string
+restOfLine(const char* p, const char* end)
+{
+    p = skipBlanks(p, end);
+    while (end > p && isBlank(end[-1]))
+        end--;
+    return std::string(p, end);
+}
+
+const double PowersOfTen[] = 
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Decimal to float without strtod and its locale lookups. Digits past
+// the 19th are dropped, far below float precision. Returns nullptr when
+// there is no number at p.
+const char*
+parseFloat(const char* p, const char* end, float& value)
+{
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int32_t exponent = 0;
+    uint32_t digits = 0;
+    bool any = false;
+    for (; p < end && isDigit(*p); p++)
+    {
+        any = true;
+        if (digits < 19)
+        {
+            mantissa = mantissa * 10 + uint64_t(*p - '0');
+            if (mantissa)
+                digits++;
+        }
+        else
+        {
+            exponent++;
+        }
+    }
+    if (p < end && *p == '.')
+    {
+        for (p++; p < end && isDigit(*p); p++)
+        {
+            any = true;
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + uint64_t(*p - '0');
+                if (mantissa)
+                    digits++;
+                exponent--;
+            }
+        }
+    }
+    if (!any)
+        return nullptr;
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if (q < end && (*q == '-' || *q == '+'))
+        {
+            negativeExponent = *q == '-';
+            q++;
+        }
+        if (q < end && isDigit(*q))
+        {
+            int32_t e = 0;
+            for (; q < end && isDigit(*q); q++)
+            {
+                if (e < 1000)
+                    e = e * 10 + (*q - '0');
+            }
+            exponent += negativeExponent ? -e : e;
+            p = q;
+        }
+    }
+
+    double result = double(mantissa);
+    if (result != 0.0)
+    {
+        for (; exponent < -22; exponent += 22)
+            result /= PowersOfTen[22];
+        for (; exponent > 22; exponent -= 22)
+            result *= PowersOfTen[22];
+        result = exponent < 0 ? result / PowersOfTen[-exponent] : result * PowersOfTen[exponent];
+    }
+    value = float(negative ? -result : result);
+    return p;
+}
+
+// Reads up to count floats, leaving missing ones untouched.
+const char*
+parseFloats(const char* p, const char* end, float* values, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        p = skipBlanks(p, end);
+        const char* next = parseFloat(p, end, values[i]);
+        if (!next)
+            break;
+        p = next;
+    }
+    return p;
+}
+
+// One based obj index, negative when relative to the last vertex read.
+const char*
+parseIndex(const char* p, const char* end, int64_t& value)
+{
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        p++;
+    }
+    if (p >= end || !isDigit(*p))
+        return nullptr;
+
+    int64_t result = 0;
+    for (; p < end && isDigit(*p); p++)
+    {
+        if (result < (int64_t(1) << 40))
+            result = result * 10 + (*p - '0');
+    }
+    value = negative ? -result : result;
+    return p;
+}
+
+// Turns an obj index into a zero based one into a table of count
+// entries, of which read have been seen before this statement.
+inline bool
+resolveIndex(int64_t index, uint32_t read, uint32_t count, uint32_t& resolved)
+{
+    int64_t absolute = index > 0 ? index - 1 : int64_t(read) + index;
+    if (index == 0 || absolute < 0 || absolute >= int64_t(count))
+        return false;
+    resolved = uint32_t(absolute);
+    return true;
+}
+
+void
+countChunk(Chunk& chunk)
+{
+    chunk.lines = chunk.positions = chunk.uvs = chunk.normals = 0;
+    for (const char* line = chunk.begin; line < chunk.end; chunk.lines++)
+    {
+        const char* lineEnd = findLineEnd(line, chunk.end);
+        const char* p = skipBlanks(line, lineEnd);
+        if (p < lineEnd && *p == 'v')
+        {
+            if (isStatement(p, lineEnd, "v", 1))
+                chunk.positions++;
+            else if (isStatement(p, lineEnd, "vt", 2))
+                chunk.uvs++;
+            else if (isStatement(p, lineEnd, "vn", 2))
+                chunk.normals++;
+        }
+        line = lineEnd < chunk.end ? lineEnd + 1 : chunk.end;
+    }
+}
+
+struct Tables
+{
+    std::vector<Vector3f>      positions;
+    std::vector<Vector2f>      uvs;
+    std::vector<Vector3f>      normals;
+};
+
+void
+parseChunk(Chunk& chunk, Tables& tables)
+{
+    uint32_t positionCount = uint32_t(tables.positions.size());
+    uint32_t uvCount = uint32_t(tables.uvs.size());
+    uint32_t normalCount = uint32_t(tables.normals.size());
+    uint32_t positionsRead = chunk.positionBase;
+    uint32_t uvsRead = chunk.uvBase;
+    uint32_t normalsRead = chunk.normalBase;
+
+    std::vector<Corner> face;
+    uint32_t lineNumber = chunk.firstLine;
+    const char* lineEnd = chunk.begin;
+    for (const char* line = chunk.begin; line < chunk.end; line = lineEnd < chunk.end ? lineEnd + 1 : chunk.end)
+    {
+        lineNumber++;
+        lineEnd = findLineEnd(line, chunk.end);
+        const char* p = skipBlanks(line, lineEnd);
+        if (p == lineEnd || *p == '#')
+            continue;
+
+        if (isStatement(p, lineEnd, "v", 1))
+        {
+            float values[3] = { 0.0f, 0.0f, 0.0f };
+            parseFloats(p + 1, lineEnd, values, 3);
+            tables.positions[positionsRead++] = Vector3f(values[0], values[1], values[2]);
+        }
+        else if (isStatement(p, lineEnd, "vt", 2))
+        {
+            float values[2] = { 0.0f, 0.0f };
+            parseFloats(p + 2, lineEnd, values, 2);
+            tables.uvs[uvsRead++] = Vector2f(values[0], 1.0f - values[1]);
+        }
+        else if (isStatement(p, lineEnd, "vn", 2))
+        {
+            float values[3] = { 0.0f, 0.0f, 0.0f };
+            parseFloats(p + 2, lineEnd, values, 3);
+            tables.normals[normalsRead++] = Vector3f(values[0], values[1], values[2]);
+        }
+        else if (isStatement(p, lineEnd, "f", 1))
+        {
+            face.clear();
+            p = skipBlanks(p + 1, lineEnd);
+            while (p < lineEnd)
+            {
+                // v, v/vt, v//vn or v/vt/vn
+                Corner corner = { NoIndex, NoIndex, NoIndex };
+                int64_t index = 0;
+                bool valid = (p = parseIndex(p, lineEnd, index)) != nullptr &&
+                             resolveIndex(index, positionsRead, positionCount, corner.position);
+                if (valid && p < lineEnd && *p == '/')
+                {
+                    p++;
+                    if (p < lineEnd && *p != '/')
+                    {
+                        valid = (p = parseIndex(p, lineEnd, index)) != nullptr &&
+                                resolveIndex(index, uvsRead, uvCount, corner.uv);
+                    }
+                    if (valid && p < lineEnd && *p == '/')
+                    {
+                        valid = (p = parseIndex(p + 1, lineEnd, index)) != nullptr &&
+                                resolveIndex(index, normalsRead, normalCount, corner.normal);
+                    }
+                }
+                if (!valid || (p < lineEnd && !isBlank(*p)))
+                {
+                    if (chunk.error.empty())
+                        chunk.error = "invalid face on line " + std::to_string(lineNumber);
+                    face.clear();
+                    break;
+                }
+                face.push_back(corner);
+                p = skipBlanks(p, lineEnd);
+            }
+
+            for (size_t cornerId = 2; cornerId < face.size(); cornerId++)
+            {
+                chunk.corners.push_back(face[0]);
+                chunk.corners.push_back(face[cornerId - 1]);
+                chunk.corners.push_back(face[cornerId]);
+            }
+        }
+        else if (isStatement(p, lineEnd, "g", 1) || isStatement(p, lineEnd, "o", 1))
+        {
+            Event event = { Event::Group, chunk.corners.size() / 3, restOfLine(p + 1, lineEnd) };
+            chunk.events.push_back(event);
+        }
+        else if (isStatement(p, lineEnd, "usemtl", 6))
+        {
+            Event event = { Event::UseMaterial, chunk.corners.size() / 3, restOfLine(p + 6, lineEnd) };
+            chunk.events.push_back(event);
+        }
+        else if (isStatement(p, lineEnd, "mtllib", 6))
+        {
+            chunk.materialLibraries.push_back(restOfLine(p + 6, lineEnd));
+        }
+    }
+}
+
+// Welds the corners of a shape into vertices, one per distinct
+// position, uv and normal triple.
+void
+buildShape(const ShapeSpans& spans, 
+           const std::vector<Chunk>& chunks, 
+           const Tables& tables, 
+           IndexedMeshData& data)
+{
+    size_t cornerCount = spans.triangles * 3;
+    size_t tableSize = 64;
+    while (tableSize < cornerCount * 2)
+        tableSize *= 2;
+    size_t mask = tableSize - 1;
+
+    std::vector<uint32_t> table(tableSize, NoIndex);
+    std::vector<Corner> vertices;
+    vertices.reserve(cornerCount / 4 + 16);
+    data.indices.resize(cornerCount);
+
+    size_t indexId = 0;
+    for (auto span = spans.spans.begin(); span != spans.spans.end(); span++)
+    {
+        const Chunk& chunk = chunks[span->chunk];
+        for (size_t cornerId = span->first * 3; cornerId < span->last * 3; cornerId++)
+        {
+            const Corner& corner = chunk.corners[cornerId];
+            size_t slot = hashCorner(corner) & mask;
+            while (table[slot] != NoIndex && !(vertices[table[slot]] == corner))
+                slot = (slot + 1) & mask;
+            if (table[slot] == NoIndex)
+            {
+                table[slot] = uint32_t(vertices.size());
+                vertices.push_back(corner);
+            }
+            data.indices[indexId++] = table[slot];
+        }
+    }
+
+    data.positions.resize(vertices.size());
+    data.normals.assign(vertices.size(), Vector3f(0.0f));
+    data.uvs.assign(vertices.size(), Vector2f(0.0f));
+    for (size_t vertexId = 0; vertexId < vertices.size(); vertexId++)
+    {
+        const Corner& vertex = vertices[vertexId];
+        data.positions[vertexId] = tables.positions[vertex.position];
+        if (vertex.normal != NoIndex)
+            data.normals[vertexId] = tables.normals[vertex.normal];
+        if (vertex.uv != NoIndex)
+            data.uvs[vertexId] = tables.uvs[vertex.uv];
+    }
+}
+
+std::string
+joinPath(const std::string& basePath, const std::string& fileName)
+{
+    if (basePath.empty())
+        return fileName;
+    char last = basePath[basePath.length() - 1];
+    return (last == '/' || last == '\\') ? basePath + fileName : basePath + "/" + fileName;
+}
+
+// The texture of a map statement, after any options.
+std::string
+mapFileName(const char* p, const char* end)
+{
+    std::string rest = restOfLine(p, end);
+    size_t separator = rest.find_last_of(" \t");
+    return separator == std::string::npos ? rest : rest.substr(separator + 1);
+}
+}
+
+bool
+ObjReader::readMaterials(const std::string& filePathName, 
+                         std::vector<Material>& materials)
+{
+    std::ifstream stream(filePathName.c_str());
+    if (!stream)
+        return false;
+
+    std::string text;
+    while (std::getline(stream, text))
+    {
+        const char* lineEnd = text.c_str() + text.length();
+        const char* p = skipBlanks(text.c_str(), lineEnd);
+
+        if (isStatement(p, lineEnd, "newmtl", 6))
+        {
+            materials.push_back(Material());
+            materials.back().name = restOfLine(p + 6, lineEnd);
+        }
+        else if (materials.empty())
+        {
+            continue;
+        }
+        else if (isStatement(p, lineEnd, "map_Kd", 6))
+        {
+            materials.back().diffuseMap = mapFileName(p + 6, lineEnd);
+        }
+        else if (isStatement(p, lineEnd, "map_Ks", 6))
+        {
+            materials.back().specularMap = mapFileName(p + 6, lineEnd);
+        }
+        else if (isStatement(p, lineEnd, "norm", 4))
+        {
+            materials.back().normalMap = mapFileName(p + 4, lineEnd);
+        }
+        else if (isStatement(p, lineEnd, "map_Bump", 8) || isStatement(p, lineEnd, "map_bump", 8))
+        {
+            materials.back().normalMap = mapFileName(p + 8, lineEnd);
+        }
+        else if (isStatement(p, lineEnd, "bump", 4))
+        {
+            materials.back().normalMap = mapFileName(p + 4, lineEnd);
+        }
+    }
+    return true;
+}
+
+bool
+ObjReader::read(const std::string& filePathName,
+                const std::string& materialBasePath,
+                std::vector<Shape>& shapes,
+                std::vector<Material>& materials,
+                std::string& error,
+                Report* report)
+{
+    shapes.clear();
+    materials.clear();
+
+    FileView file;
+    if (!file.open(filePathName))
+    {
+        error = "Could not read " + filePathName;
+        return false;
+    }
+
+    // Newline aligned chunks, each owning the lines that start in it.
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkBytes = std::max(MinimumChunkBytes, file.size() / (threads * ChunksPerThread) + 1);
+    std::vector<Chunk> chunks;
+    for (const char* begin = file.begin(); begin < file.end();)
+    {
+        const char* end = begin + std::min(chunkBytes, size_t(file.end() - begin));
+        if (end < file.end())
+            end = findLineEnd(end, file.end());
+        if (end < file.end())
+            end++;
+
+        chunks.push_back(Chunk());
+        chunks.back().begin = begin;
+        chunks.back().end = end;
+        begin = end;
+    }
+
+    Ctr::parallelFor(size_t(0), chunks.size(), [&](size_t chunkId)
+    {
+        countChunk(chunks[chunkId]);
+    });
+
+    uint64_t lines = 0, positions = 0, uvs = 0, normals = 0;
+    for (auto chunk = chunks.begin(); chunk != chunks.end(); chunk++)
+    {
+        chunk->firstLine = uint32_t(lines);
+        chunk->positionBase = uint32_t(positions);
+        chunk->uvBase = uint32_t(uvs);
+        chunk->normalBase = uint32_t(normals);
+        lines += chunk->lines;
+        positions += chunk->positions;
+        uvs += chunk->uvs;
+        normals += chunk->normals;
+    }
+    if (positions >= NoIndex || uvs >= NoIndex || normals >= NoIndex)
+    {
+        error = filePathName + " has too many vertices";
+        return false;
+    }
+
+    Tables tables;
+    tables.positions.resize(size_t(positions));
+    tables.uvs.resize(size_t(uvs));
+    tables.normals.resize(size_t(normals));
+    Ctr::parallelFor(size_t(0), chunks.size(), [&](size_t chunkId)
+    {
+        parseChunk(chunks[chunkId], tables);
+    });
+
+    // Merge the face tables in file order into shapes.
+    std::vector<ShapeSpans> shapeSpans(1);
+    shapeSpans.back().triangles = 0;
+    std::vector<std::string> materialLibraries;
+    for (size_t chunkId = 0; chunkId < chunks.size(); chunkId++)
+    {
+        Chunk& chunk = chunks[chunkId];
+        if (chunk.error.length() > 0)
+        {
+            error = filePathName + ": " + chunk.error;
+            return false;
+        }
+        materialLibraries.insert(materialLibraries.end(), 
+                                 chunk.materialLibraries.begin(), chunk.materialLibraries.end());
+
+        size_t first = 0;
+        size_t triangleCount = chunk.corners.size() / 3;
+        for (size_t eventId = 0; eventId <= chunk.events.size(); eventId++)
+        {
+            size_t last = eventId < chunk.events.size() ? chunk.events[eventId].triangle : triangleCount;
+            if (last > first)
+            {
+                Span span = { chunkId, first, last };
+                shapeSpans.back().spans.push_back(span);
+                shapeSpans.back().triangles += last - first;
+                first = last;
+            }
+            if (eventId == chunk.events.size())
+                break;
+
+            const Event& event = chunk.events[eventId];
+            if (shapeSpans.back().triangles > 0)
+            {
+                ShapeSpans next;
+                next.name = shapeSpans.back().name;
+                next.material = shapeSpans.back().material;
+                next.triangles = 0;
+                shapeSpans.push_back(next);
+            }
+            if (event.type == Event::Group)
+                shapeSpans.back().name = event.name;
+            else
+                shapeSpans.back().material = event.name;
+        }
+    }
+    if (shapeSpans.back().triangles == 0)
+        shapeSpans.pop_back();
+    if (shapeSpans.empty())
+    {
+        error = filePathName + " has no faces";
+        return false;
+    }
+
+    std::string basePath = materialBasePath;
+    if (basePath.empty())
+    {
+        size_t separator = filePathName.find_last_of("/\\");
+        if (separator != std::string::npos)
+            basePath = filePathName.substr(0, separator);
+    }
+    for (auto library = materialLibraries.begin(); library != materialLibraries.end(); library++)
+    {
+        if (!readMaterials(joinPath(basePath, *library), materials))
+        {
+            LOG("Could not read material library " << *library << " of " << filePathName);
+        }
+    }
+
+    uint64_t triangles = 0;
+    shapes.resize(shapeSpans.size());
+    for (size_t shapeId = 0; shapeId < shapes.size(); shapeId++)
+    {
+        shapes[shapeId].name = shapeSpans[shapeId].name;
+        shapes[shapeId].materialId = -1;
+        for (size_t materialId = 0; materialId < materials.size(); materialId++)
+        {
+            if (materials[materialId].name == shapeSpans[shapeId].material)
+            {
+                shapes[shapeId].materialId = int32_t(materialId);
+                break;
+            }
+        }
+        triangles += shapeSpans[shapeId].triangles;
+    }
+
+    Ctr::parallelFor(size_t(0), shapes.size(), [&](size_t shapeId)
+    {
+        buildShape(shapeSpans[shapeId], chunks, tables, shapes[shapeId].data);
+    });
+
+    if (report)
+    {
+        report->bytes = file.size();
+        report->chunks = uint32_t(chunks.size());
+        report->positions = uint32_t(positions);
+        report->triangles = uint32_t(triangles);
+        report->mapped = file.mapped();
+    }
+    return true;
+}
+}
@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_OBJ_READER
+#define INCLUDED_CRT_OBJ_READER
+
+#include <CtrPlatform.h>
+#include <CtrIndexedMesh.h>
+
+namespace Ctr
+{
+//--------------------------------------------------------------------
+//
+// ObjReader
+//
+// Reads Wavefront OBJ files straight into IndexedMeshData.
+//
+// The file is mapped rather than streamed, then split into newline
+// aligned chunks that are parsed in parallel. A first pass counts the
+// vertex records of each chunk, so the second can write positions,
+// normals and uvs to their final place and resolve relative indices
+// without a merge. Face tables are merged in file order and split into
+// shapes on g, o and usemtl, and shapes weld their corners into
+// vertices in parallel with each other.
+//
+// Polygons are triangulated as fans. Points, lines, free form geometry,
+// smoothing groups and line continuations are ignored.
+//
+//--------------------------------------------------------------------
+class ObjReader
+{
+  public:
+    struct Material
+    {
+        std::string            name;
+        std::string            diffuseMap;
+        std::string            normalMap;
+        std::string            specularMap;
+    };
+
+    struct Shape
+    {
+        std::string            name;
+        // Index into the materials, -1 for faces without one.
+        int32_t                materialId;
+        IndexedMeshData        data;
+    };
+
+    struct Report
+    {
+        uint64_t               bytes;
+        uint32_t               chunks;
+        uint32_t               positions;
+        uint32_t               triangles;
+        // False when the file was read into memory instead.
+        bool                   mapped;
+    };
+
+    // Material libraries are found relative to materialBasePath, or to
+    // the obj file when it is empty. Returns false with error set when
+    // the file cannot be read, is malformed or holds no faces.
+    static bool                read(const std::string& filePathName,
+                                    const std::string& materialBasePath,
+                                    std::vector<Shape>& shapes,
+                                    std::vector<Material>& materials,
+                                    std::string& error,
+                                    Report* report = nullptr);
+
+    // Appends the materials of an mtl library. Unknown statements are skipped.
+    static bool                readMaterials(const std::string& filePathName,
+                                             std::vector<Material>& materials);
+};
+}
+
+#endif
@@ -74,9 +74,10 @@ RenderTargetQuad::initialize (const Ctr::Region2f& screenLocation)
     vertexElements.push_back (VertexElement( 0, 16, FLOAT2, METHOD_DEFAULT, TEXCOORD, 0));
     vertexElements.push_back (VertexElement(0xFF,0, UNUSED,0,0,0));
 
+    VertexDeclarationParameters vertexDeclarationParameters (vertexElements);
     if (IVertexDeclaration* vertexDeclaration = 
         VertexDeclarationMgr::vertexDeclarationMgr()
-        ->createVertexDeclaration (&VertexDeclarationParameters (vertexElements)))
+        ->createVertexDeclaration (&vertexDeclarationParameters))
     {
         float lhx = _screenLocation.minExtent.x * width;
         float lhy = _screenLocation.minExtent.y * height;
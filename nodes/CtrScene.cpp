@@ -49,6 +49,13 @@
 #include <CtrCamera.h>
 #include <CtrBrdf.h>
 #include <Ctrimgui.h>
+#include <CtrFrustum.h>
+#include <CtrProfiler.h>
+#include <CtrMeshOptimizer.h>
+#include <CtrMeshSimplifier.h>
+#include <CtrTangentGenerator.h>
+#include <CtrTimer.h>
+#include <CtrParallel.h>
 
 #if IBL_USE_ASS_IMP_AND_FREEIMAGE
 // Assimp
@@ -56,7 +63,13 @@
 #include <scene.h>
 #include <postprocess.h>
 #else
-#include <tiny_obj_loader.h>
+#include <CtrObjReader.h>
+#endif
+
+#if !(_WIN32 || _WIN64)
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fnmatch.h>
 #endif
 
 
@@ -64,10 +77,7 @@ namespace Ctr
 {
 namespace
 {
-//
-// Windows only.
-// [TODO] Will need abstraction for linux / osx.
-//
+#if _WIN32 || _WIN64
 void findFiles(std::wstring path, std::wstring pattern, 
                std::vector<std::string>& files)
 {
@@ -137,6 +147,42 @@ void findFiles(std::wstring path, std::wstring pattern,
 
     FindClose(hFind);
 }
+#else
+void findFiles(std::wstring path, std::wstring pattern, 
+               std::vector<std::string>& files)
+{
+    std::string pathName(path.begin(), path.end());
+    std::string patternName(pattern.begin(), pattern.end());
+
+    DIR* directory = opendir(pathName.c_str());
+    if (!directory)
+    {
+        LOG("Could not open directory " << pathName);
+        return;
+    }
+
+    while (struct dirent* entry = readdir(directory))
+    {
+        std::string entryName = entry->d_name;
+        if (entryName == "." || entryName == "..")
+            continue;
+
+        struct stat entryStat;
+        if (stat((pathName + "/" + entryName).c_str(), &entryStat) != 0)
+            continue;
+
+        if (S_ISDIR(entryStat.st_mode))
+        {
+            findFiles(path + L"/" + std::wstring(entryName.begin(), entryName.end()), pattern, files);
+        }
+        else if (fnmatch(patternName.c_str(), entryName.c_str(), 0) == 0)
+        {
+            files.push_back(entryName);
+        }
+    }
+    closedir(directory);
+}
+#endif
 
 std::string trimPathName(const std::string& filePath)
 {
@@ -174,9 +220,14 @@ bool fileExists(const std::string& filePath)
     if (filePath.length() == 0)
         return false;
 
+#if _WIN32 || _WIN64
     std::wstring filePathW(filePath.begin(), filePath.end());
     uint32_t fileAttr = GetFileAttributes(filePathW.c_str());
     if (fileAttr == INVALID_FILE_ATTRIBUTES)
+#else
+    struct stat fileStat;
+    if (stat(filePath.c_str(), &fileStat) != 0)
+#endif
     { 
         LOG("FilePath " << filePath)
         return false;
@@ -218,8 +269,138 @@ std::string GetFileNameWithoutExtension(const std::string& filePath)
     return filePathWithoutExtension(tmp);
 }
 
+void
+optimizeImportedMeshes(const std::string& meshFilePathName, 
+                       std::vector<IndexedMeshData>& meshes)
+{
+    CTR_PROFILE_SCOPE("Scene::optimizeMeshes");
+
+    std::vector<MeshOptimizer::Report> reports(meshes.size());
+    std::vector<uint8_t> optimized(meshes.size(), 0);
+    Ctr::parallelFor(size_t(0), meshes.size(), [&](size_t meshId)
+    {
+        optimized[meshId] = MeshOptimizer::optimize(meshes[meshId], &reports[meshId]) ? 1 : 0;
+    });
+
+    // Triangle weighted ACMR and vertex weighted ATVR over the import.
+    double triangles = 0, vertices = 0;
+    double acmrBefore = 0, acmrAfter = 0, atvrBefore = 0, atvrAfter = 0;
+    for (size_t meshId = 0; meshId < meshes.size(); meshId++)
+    {
+        if (!optimized[meshId])
+            continue;
+
+        const MeshOptimizer::Report& report = reports[meshId];
+        triangles += report.triangles;
+        vertices += report.vertices;
+        acmrBefore += report.before.acmr * report.triangles;
+        acmrAfter += report.after.acmr * report.triangles;
+        atvrBefore += report.before.atvr * report.vertices;
+        atvrAfter += report.after.atvr * report.vertices;
+    }
+
+    if (triangles > 0 && vertices > 0)
+    {
+        LOG("Optimized " << meshes.size() << " meshes from " << meshFilePathName 
+            << ": ACMR " << acmrBefore / triangles << " -> " << acmrAfter / triangles
+            << ", ATVR " << atvrBefore / vertices << " -> " << atvrAfter / vertices);
+    }
 }
 
+void
+generateImportedLods(const std::string& meshFilePathName, 
+                     std::vector<IndexedMeshData>& meshes)
+{
+    CTR_PROFILE_SCOPE("Scene::generateLods");
+
+    std::vector<MeshSimplifier::Report> reports(meshes.size());
+    Ctr::parallelFor(size_t(0), meshes.size(), [&](size_t meshId)
+    {
+        memset(&reports[meshId], 0, sizeof(MeshSimplifier::Report));
+        MeshSimplifier::buildLodChain(meshes[meshId], 4, 0.5f, 64, &reports[meshId]);
+    });
+
+    uint32_t levels = 0;
+    uint64_t triangles = 0, lodTriangles = 0;
+    for (size_t meshId = 0; meshId < meshes.size(); meshId++)
+    {
+        levels += reports[meshId].levels;
+        triangles += reports[meshId].triangles;
+        lodTriangles += reports[meshId].lodTriangles;
+    }
+
+    if (levels > 0)
+    {
+        LOG("Generated " << levels << " levels of detail for " << meshes.size() << " meshes from " 
+            << meshFilePathName << ": " << triangles << " -> " << lodTriangles << " triangles at the coarsest");
+    }
+}
+
+double
+millisecondsSince(uint64_t start)
+{
+    return double(Timer::ticks() - start) * 1000.0 / double(Timer::ticksPerSecond());
+}
+
+void
+generateImportedTangents(const std::string& meshFilePathName, 
+                         std::vector<IndexedMeshData>& meshes)
+{
+    CTR_PROFILE_SCOPE("Scene::generateTangents");
+
+    uint64_t start = Timer::ticks();
+    std::vector<TangentGenerator::Report> reports(meshes.size());
+    Ctr::parallelFor(size_t(0), meshes.size(), [&](size_t meshId)
+    {
+        memset(&reports[meshId], 0, sizeof(TangentGenerator::Report));
+        TangentGenerator::generate(meshes[meshId], &reports[meshId]);
+    });
+    double milliseconds = millisecondsSince(start);
+
+    uint64_t vertices = 0, splitVertices = 0, degenerateTriangles = 0;
+    for (size_t meshId = 0; meshId < meshes.size(); meshId++)
+    {
+        vertices += reports[meshId].vertices;
+        splitVertices += reports[meshId].splitVertices;
+        degenerateTriangles += reports[meshId].degenerateTriangles;
+    }
+
+    LOG("Generated tangents for " << meshes.size() << " meshes from " << meshFilePathName 
+        << " in " << milliseconds << " ms: "
+        << vertices << " vertices, " << splitVertices << " split, " 
+        << degenerateTriangles << " degenerate triangles");
+}
+
+// Import stages that only touch host data, run across all meshes at once.
+// Tangents come first as they may split vertices, levels of detail last,
+// over the optimized vertex order.
+void
+prepareImportedMeshes(const std::string& meshFilePathName, 
+                      std::vector<IndexedMeshData>& meshes)
+{
+    if (meshes.size() == 0)
+        return;
+
+    uint64_t start = Timer::ticks();
+    if (Scene::generateTangentsOnImport())
+        generateImportedTangents(meshFilePathName, meshes);
+    if (Scene::optimizeMeshesOnImport())
+        optimizeImportedMeshes(meshFilePathName, meshes);
+    if (Scene::generateLodsOnImport())
+        generateImportedLods(meshFilePathName, meshes);
+    LOG("Prepared " << meshes.size() << " meshes from " << meshFilePathName 
+        << " in " << millisecondsSince(start) << " ms");
+}
+
+}
+
+bool Scene::_optimizeMeshesOnImport = false;
+bool Scene::_compressMeshesOnImport = false;
+bool Scene::_generateLodsOnImport = false;
+bool Scene::_generateTangentsOnImport = false;
+bool Scene::_useTransformHierarchy = false;
+bool Scene::_instanceMeshesOnImport = false;
+
 Scene::Scene(Ctr::IDevice* device) : 
     Ctr::RenderNode(device),
     _camera(nullptr),
@@ -244,6 +425,15 @@ Scene::~Scene()
     }
     _entities.clear();
 
+    // Prototypes outlive the meshes sharing their buffers.
+    for (auto it = _sharedGeometry.begin(); it != _sharedGeometry.end(); it++)
+    {
+        Ctr::IndexedMesh* mesh = it->second;
+        safedelete(mesh);
+    }
+    _sharedGeometry.clear();
+    _sharedMaterials.clear();
+
     for (auto it = _probes.begin(); it != _probes.end(); it++)
     {
         Ctr::IBLProbe* probe = *it;
@@ -286,6 +476,14 @@ Scene::loadBrdfs()
         }
     }
 
+    if (_brdfCache.size() == 0)
+    {
+        LOG("No brdfs found, scenes will render without a brdf lut");
+        _activeBrdfProperty = new IntProperty(this, "Brdf");
+        _activeBrdfProperty->set(0);
+        return false;
+    }
+
     // Build the enum for display
     uint32_t brdfId = 0;
     std::vector<ImguiEnumVal> _brdfEnumValues;
@@ -314,6 +512,8 @@ Scene::activeBrdfProperty()
 const Brdf*
 Scene::activeBrdf() const
 {
+    if (_brdfCache.size() == 0)
+        return nullptr;
     return _brdfCache[_activeBrdfProperty->get()];
 }
 
@@ -325,11 +525,12 @@ Scene::load(const std::string& meshFilePathName,
 const std::string& userMaterialPathName)
 {
     Assimp::Importer importer;
-    uint32_t flags = aiProcess_CalcTangentSpace |
-        aiProcess_Triangulate |
+    uint32_t flags = aiProcess_Triangulate |
         aiProcess_PreTransformVertices |
         aiProcess_FlipUVs;
+    uint64_t readStart = Timer::ticks();
     const aiScene* scene = importer.ReadFile(meshFilePathName, flags);
+    LOG("Read " << meshFilePathName << " in " << millisecondsSince(readStart) << " ms");
 
     if (scene == nullptr)
     {
@@ -349,6 +550,13 @@ const std::string& userMaterialPathName)
         implicitlyGenerateMaterials = true;
     }
 
+    std::vector<IndexedMeshData> meshData(scene->mNumMeshes);
+    for (size_t meshId = 0; meshId < scene->mNumMeshes; meshId++)
+    {
+        IndexedMesh::read(scene->mMeshes[meshId], meshData[meshId]);
+    }
+    prepareImportedMeshes(meshFilePathName, meshData);
+
     Ctr::Entity* entity = new Ctr::Entity(_device);
     entity->setName(meshFilePathName);
 
@@ -356,89 +564,98 @@ const std::string& userMaterialPathName)
     {
         Ctr::IndexedMesh* mesh = new Ctr::IndexedMesh(_device);
         mesh->setName(scene->mMeshes[meshId]->mName.C_Str());
-        mesh->load(scene->mMeshes[meshId]);
-        Material * material = new Material(_device);
+        loadImportedMesh(mesh, meshData[meshId]);
 
-        if (userMaterialPathName.length() > 0)
+        std::string materialKey = userMaterialPathName.length() > 0 ? userMaterialPathName :
+            meshFilePathName + "|" + std::to_string(scene->mMeshes[meshId]->mMaterialIndex);
+        Material * material = sharedMaterial(materialKey);
+        if (!material)
         {
-            if (!material->load(userMaterialPathName))
+            material = new Material(_device);
+
+            if (userMaterialPathName.length() > 0)
             {
-                delete material;
-                throw (std::runtime_error("Can't load user material " +
-                    userMaterialPathName));
+                if (!material->load(userMaterialPathName))
+                {
+                    delete material;
+                    throw (std::runtime_error("Can't load user material " +
+                        userMaterialPathName));
+                }
             }
-        }
-        else if (implicitlyGenerateMaterials)
-        {
-            // TODO: Setup default based on passed in material.
-            // Related to very, very old code (2003).
-            assert(0);
-        }
-        else
-        {
-            size_t materialId = scene->mMeshes[meshId]->mMaterialIndex;
-            const aiMaterial& mat = *scene->mMaterials[materialId];
-
-
-            // Setup material. This is a little braindead, but it
-            // is good enough for the purposes of this demo.
-            material->textureGammaProperty()->set(2.2f);
-            material->setShaderName("PBRDebug");
-            material->setTechniqueName("Default");
-            material->addPass("color");
-
-            // Thank you DCC tool for this. Meah.
-            char name[512];
-            memset(name, 0, sizeof(char) * 512);
-            uint32_t nameLength = 512;
-            mat.Get("?mat.name", 0, 0,  name, &nameLength);
-            material->setName(name);
-            material->twoSidedProperty()->set(true);
-
-            //
-            // Load textures
-            //
-            std::string assetPath = trimPathName(meshFilePathName);
-            LOG("asset path " << assetPath)
-                aiString textureFilePath;
-            if (mat.GetTexture(aiTextureType_DIFFUSE, 0, &textureFilePath) == aiReturn_SUCCESS)
+            else if (implicitlyGenerateMaterials)
             {
-                std::string mapFilePathName = assetPath + trimFileName(std::string(textureFilePath.C_Str()));
-                material->setAlbedoMap(mapFilePathName);
-                // Retarded necessity. ArseImp doesn't load material or mesh names.
-                material->setName(mapFilePathName);
+                // TODO: Setup default based on passed in material.
+                // Related to very, very old code (2003).
+                assert(0);
             }
             else
             {
-                LOG("Could not find albedo map for " << meshFilePathName);
-            }
+                size_t materialId = scene->mMeshes[meshId]->mMaterialIndex;
+                const aiMaterial& mat = *scene->mMaterials[materialId];
+
+
+                // Setup material. This is a little braindead, but it
+                // is good enough for the purposes of this demo.
+                material->textureGammaProperty()->set(2.2f);
+                material->setShaderName("PBRDebug");
+                material->setTechniqueName("Default");
+                material->addPass("color");
+
+                // Thank you DCC tool for this. Meah.
+                char name[512];
+                memset(name, 0, sizeof(char) * 512);
+                uint32_t nameLength = 512;
+                mat.Get("?mat.name", 0, 0,  name, &nameLength);
+                material->setName(name);
+                material->twoSidedProperty()->set(true);
+
+                //
+                // Load textures
+                //
+                std::string assetPath = trimPathName(meshFilePathName);
+                LOG("asset path " << assetPath)
+                    aiString textureFilePath;
+                if (mat.GetTexture(aiTextureType_DIFFUSE, 0, &textureFilePath) == aiReturn_SUCCESS)
+                {
+                    std::string mapFilePathName = assetPath + trimFileName(std::string(textureFilePath.C_Str()));
+                    material->setAlbedoMap(mapFilePathName);
+                    // Retarded necessity. ArseImp doesn't load material or mesh names.
+                    material->setName(mapFilePathName);
+                }
+                else
+                {
+                    LOG("Could not find albedo map for " << meshFilePathName);
+                }
 
-            if (mat.GetTexture(aiTextureType_NORMALS, 0, &textureFilePath) == aiReturn_SUCCESS ||
-                mat.GetTexture(aiTextureType_HEIGHT, 0, &textureFilePath) == aiReturn_SUCCESS)
-            {
-                std::string mapFilePathName = assetPath + trimFileName(std::string(textureFilePath.C_Str()));
-                material->setNormalMap(mapFilePathName);
-            }
-            else
-            {
-                LOG("Could not find normal map for " << meshFilePathName);
-            }
+                if (mat.GetTexture(aiTextureType_NORMALS, 0, &textureFilePath) == aiReturn_SUCCESS ||
+                    mat.GetTexture(aiTextureType_HEIGHT, 0, &textureFilePath) == aiReturn_SUCCESS)
+                {
+                    std::string mapFilePathName = assetPath + trimFileName(std::string(textureFilePath.C_Str()));
+                    material->setNormalMap(mapFilePathName);
+                }
+                else
+                {
+                    LOG("Could not find normal map for " << meshFilePathName);
+                }
 
-            if (mat.GetTexture(aiTextureType_SPECULAR, 0, &textureFilePath) == aiReturn_SUCCESS)
-            {
-                std::string mapFilePathName = assetPath + trimFileName(std::string(textureFilePath.C_Str()));
-                material->setSpecularRMCMap(mapFilePathName);
-            }
-            else
-            {
-                LOG("Could not find specular map for " << meshFilePathName);
+                if (mat.GetTexture(aiTextureType_SPECULAR, 0, &textureFilePath) == aiReturn_SUCCESS)
+                {
+                    std::string mapFilePathName = assetPath + trimFileName(std::string(textureFilePath.C_Str()));
+                    material->setSpecularRMCMap(mapFilePathName);
+                }
+                else
+                {
+                    LOG("Could not find specular map for " << meshFilePathName);
+                }
             }
+
+            _materials.insert(material);
+            addSharedMaterial(materialKey, material);
         }
 
         mesh->setMaterial(material);
         entity->addMesh(mesh);
         addMesh(mesh);
-        _materials.insert(material);
     }
 
     // Resolve shaders
@@ -454,10 +671,8 @@ Entity*
 Scene::load(const std::string& meshFilePathName, 
             const std::string& userMaterialPathName)
 {
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-
-
+    std::vector<ObjReader::Shape> shapes;
+    std::vector<ObjReader::Material> materials;
 
     size_t materialBaseIndex = meshFilePathName.rfind("/");
     if (materialBaseIndex == std::string::npos)
@@ -470,26 +685,24 @@ Scene::load(const std::string& meshFilePathName,
         LOG("Have mesh base index " << materialBasePath);
     }
 
-    std::string error = tinyobj::LoadObj(shapes, materials, meshFilePathName.c_str(), materialBasePath.length() ? materialBasePath.c_str() : nullptr);
-
-    if (error.length() > 0)
+    uint64_t readStart = Timer::ticks();
+    std::string error;
+    ObjReader::Report report;
+    if (!ObjReader::read(meshFilePathName, materialBasePath, shapes, materials, error, &report))
     {
         LOG("Failed to load any meshes " << error);
         return nullptr;
     }
+    LOG("Read " << meshFilePathName << " in " << millisecondsSince(readStart) << " ms: " 
+        << report.triangles << " triangles from " << report.chunks << " chunks");
 
-    if(shapes.size() == 0)
-    {
-        LOG("Failed to load any meshes " << meshFilePathName);
-        return nullptr;
-    }
-    
-    bool implicitlyGenerateMaterials = false;
-    if(materials.size() == 0)
+    std::vector<IndexedMeshData> meshData(shapes.size());
+    for (size_t meshId = 0; meshId < shapes.size(); meshId++)
     {
-        implicitlyGenerateMaterials = true;
+        meshData[meshId] = std::move(shapes[meshId].data);
     }
-    
+    prepareImportedMeshes(meshFilePathName, meshData);
+
     Ctr::Entity* entity = new Ctr::Entity(_device);
     entity->setName(meshFilePathName);
     
@@ -497,62 +710,75 @@ Scene::load(const std::string& meshFilePathName,
     {
         Ctr::IndexedMesh* mesh = new Ctr::IndexedMesh(_device);
         mesh->setName(shapes[meshId].name);
-        mesh->load(&shapes[meshId]);
-        Material * material = new Material(_device);
-    
-
+        loadImportedMesh(mesh, meshData[meshId]);
 
+        // Shapes without a material each get their own default one.
+        std::string materialKey;
         if (userMaterialPathName.length() > 0)
+            materialKey = userMaterialPathName;
+        else if (shapes[meshId].materialId >= 0)
+            materialKey = meshFilePathName + "|" + std::to_string(shapes[meshId].materialId);
+
+        Material * material = materialKey.length() > 0 ? sharedMaterial(materialKey) : nullptr;
+        if (!material)
         {
-            if (!material->load(userMaterialPathName))
-            {
-                delete material;
-                throw (std::runtime_error("Can't load user material " + 
-                                          userMaterialPathName));
-            }
-        }
-        else if (implicitlyGenerateMaterials)
-        {
-            // TODO: Setup default based on passed in material.
-        }
-        else
-        {
-            tinyobj::material_t* mat = &materials[meshId];
-
-            // Setup material. This is a little braindead, but it
-            // is good enough for the purposes of this demo.
-            material->textureGammaProperty()->set(2.2f);
-            material->setShaderName("PBRDebug");
-            material->setTechniqueName("Default");
-            material->addPass("color");
-
-            //
-            // Load textures
-            //
-            std::string assetPath = trimPathName(meshFilePathName);
-            LOG("asset path " << assetPath)
-            
-            if (mat->diffuse_texname.length())
+            material = new Material(_device);
+
+            if (userMaterialPathName.length() > 0)
             {
-                std::string mapFilePathName = assetPath + (mat->diffuse_texname);
-                material->setAlbedoMap(mapFilePathName);
+                if (!material->load(userMaterialPathName))
+                {
+                    delete material;
+                    throw (std::runtime_error("Can't load user material " + 
+                                              userMaterialPathName));
+                }
             }
-            if (mat->normal_texname.length())
+            else if (shapes[meshId].materialId < 0)
             {
-                std::string mapFilePathName = assetPath + (mat->normal_texname);
-                material->setNormalMap(mapFilePathName);
+                // TODO: Setup default based on passed in material.
             }
-            if (mat->specular_texname.length())
+            else
             {
-                std::string mapFilePathName = assetPath + (mat->specular_texname);
-                material->setSpecularRMCMap(mapFilePathName);
+                const ObjReader::Material* mat = &materials[shapes[meshId].materialId];
+
+                // Setup material. This is a little braindead, but it
+                // is good enough for the purposes of this demo.
+                material->textureGammaProperty()->set(2.2f);
+                material->setShaderName("PBRDebug");
+                material->setTechniqueName("Default");
+                material->addPass("color");
+
+                //
+                // Load textures
+                //
+                std::string assetPath = trimPathName(meshFilePathName);
+                LOG("asset path " << assetPath)
+            
+                if (mat->diffuseMap.length())
+                {
+                    std::string mapFilePathName = assetPath + (mat->diffuseMap);
+                    material->setAlbedoMap(mapFilePathName);
+                }
+                if (mat->normalMap.length())
+                {
+                    std::string mapFilePathName = assetPath + (mat->normalMap);
+                    material->setNormalMap(mapFilePathName);
+                }
+                if (mat->specularMap.length())
+                {
+                    std::string mapFilePathName = assetPath + (mat->specularMap);
+                    material->setSpecularRMCMap(mapFilePathName);
+                }
             }
+
+            _materials.insert(material);
+            if (materialKey.length() > 0)
+                addSharedMaterial(materialKey, material);
         }
 
         mesh->setMaterial(material);
         entity->addMesh(mesh);
         addMesh(mesh);
-        _materials.insert(material);
     }
     
     _device->shaderMgr()->resolveShaders(entity);
@@ -562,6 +788,134 @@ Scene::load(const std::string& meshFilePathName,
 }
 #endif
 
+void
+Scene::setOptimizeMeshesOnImport(bool optimize)
+{
+    _optimizeMeshesOnImport = optimize;
+}
+
+bool
+Scene::optimizeMeshesOnImport()
+{
+    return _optimizeMeshesOnImport;
+}
+
+void
+Scene::setCompressMeshesOnImport(bool compress)
+{
+    _compressMeshesOnImport = compress;
+}
+
+bool
+Scene::compressMeshesOnImport()
+{
+    return _compressMeshesOnImport;
+}
+
+void
+Scene::setGenerateLodsOnImport(bool generate)
+{
+    _generateLodsOnImport = generate;
+}
+
+bool
+Scene::generateLodsOnImport()
+{
+    return _generateLodsOnImport;
+}
+
+void
+Scene::setGenerateTangentsOnImport(bool generate)
+{
+    _generateTangentsOnImport = generate;
+}
+
+bool
+Scene::generateTangentsOnImport()
+{
+    return _generateTangentsOnImport;
+}
+
+void
+Scene::setUseTransformHierarchy(bool use)
+{
+    _useTransformHierarchy = use;
+}
+
+bool
+Scene::useTransformHierarchy()
+{
+    return _useTransformHierarchy;
+}
+
+const TransformHierarchy&
+Scene::transformHierarchy() const
+{
+    return _transformHierarchy;
+}
+
+void
+Scene::setInstanceMeshesOnImport(bool instance)
+{
+    _instanceMeshesOnImport = instance;
+}
+
+bool
+Scene::instanceMeshesOnImport()
+{
+    return _instanceMeshesOnImport;
+}
+
+void
+Scene::loadImportedMesh(IndexedMesh* mesh, const IndexedMeshData& data)
+{
+    if (!_instanceMeshesOnImport)
+    {
+        mesh->load(data, _compressMeshesOnImport);
+        return;
+    }
+
+    Hash key = data.hash();
+    if (_compressMeshesOnImport)
+        key.append(Hash(std::string("compressed")));
+    if (data.lodIndices.size() > 0)
+        key.append(Hash(std::string("lods")));
+    if (data.tangents.size() > 0)
+        key.append(Hash(std::string("tangents")));
+
+    // The prototype belongs to no entity, so destroying an entity never
+    // frees buffers that other meshes still draw.
+    auto it = _sharedGeometry.find(key);
+    if (it == _sharedGeometry.end())
+    {
+        Ctr::IndexedMesh* prototype = new Ctr::IndexedMesh(_device);
+        prototype->setName(mesh->name());
+        prototype->load(data, _compressMeshesOnImport);
+        it = _sharedGeometry.insert(std::make_pair(key, prototype)).first;
+    }
+    if (!mesh->share(it->second))
+        mesh->load(data, _compressMeshesOnImport);
+}
+
+Material*
+Scene::sharedMaterial(const std::string& key) const
+{
+    if (_instanceMeshesOnImport)
+    {
+        auto it = _sharedMaterials.find(key);
+        if (it != _sharedMaterials.end())
+            return it->second;
+    }
+    return nullptr;
+}
+
+void
+Scene::addSharedMaterial(const std::string& key, Material* material)
+{
+    if (_instanceMeshesOnImport)
+        _sharedMaterials[key] = material;
+}
+
 void
 Scene::destroy(Entity* entity)
 {
@@ -581,6 +935,7 @@ Scene::destroy(Entity* entity)
                 if (meshIt != passIt->second.end())
                 {
                     passIt->second.erase(meshIt);
+                    _meshBVHByPass[passIt->first].invalidate();
                 }
             }
         }
@@ -601,12 +956,13 @@ Scene::load(Ctr::IDevice* device,
 const std::string& meshFilePathName)
 {
     Assimp::Importer importer;
-    uint32_t flags = aiProcess_CalcTangentSpace |
-        aiProcess_Triangulate |
+    uint32_t flags = aiProcess_Triangulate |
         aiProcess_PreTransformVertices |
         aiProcess_FlipUVs;
     //aiProcess_FlipWindingOrder ;
+    uint64_t readStart = Timer::ticks();
     const aiScene* scene = importer.ReadFile(meshFilePathName, flags);
+    LOG("Read " << meshFilePathName << " in " << millisecondsSince(readStart) << " ms");
 
     if (scene == nullptr)
     {
@@ -626,6 +982,13 @@ const std::string& meshFilePathName)
         implicitlyGenerateMaterials = true;
     }
 
+    std::vector<IndexedMeshData> meshData(scene->mNumMeshes);
+    for (size_t meshId = 0; meshId < scene->mNumMeshes; meshId++)
+    {
+        IndexedMesh::read(scene->mMeshes[meshId], meshData[meshId]);
+    }
+    prepareImportedMeshes(meshFilePathName, meshData);
+
     Ctr::Entity* entity = new Ctr::Entity(device);
     entity->setName(meshFilePathName);
 
@@ -633,7 +996,7 @@ const std::string& meshFilePathName)
     {
         Ctr::IndexedMesh* mesh = new Ctr::IndexedMesh(device);
         mesh->setName(scene->mMeshes[meshId]->mName.C_Str());
-        mesh->load(scene->mMeshes[meshId]);
+        mesh->load(meshData[meshId], _compressMeshesOnImport);
         Material * material = new Material(device);
 
         material->twoSidedProperty()->set(true);
@@ -649,16 +1012,24 @@ Entity*
 Scene::load(Ctr::IDevice* device,
             const std::string& meshFilePathName)
 {
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-
-    std::string error = tinyobj::LoadObj(shapes, materials, meshFilePathName.c_str(), nullptr);
+    std::vector<ObjReader::Shape> shapes;
+    std::vector<ObjReader::Material> materials;
 
-    if (error.length() > 0)
+    uint64_t readStart = Timer::ticks();
+    std::string error;
+    if (!ObjReader::read(meshFilePathName, std::string(), shapes, materials, error))
     {
-        LOG_CRITICAL("Could not load any meshes from " << meshFilePathName)
+        LOG_CRITICAL("Could not load any meshes from " << meshFilePathName << ": " << error)
         return nullptr;
     }
+    LOG("Read " << meshFilePathName << " in " << millisecondsSince(readStart) << " ms");
+
+    std::vector<IndexedMeshData> meshData(shapes.size());
+    for (size_t meshId = 0; meshId < shapes.size(); meshId++)
+    {
+        meshData[meshId] = std::move(shapes[meshId].data);
+    }
+    prepareImportedMeshes(meshFilePathName, meshData);
 
     Ctr::Entity* entity = new Ctr::Entity(device);
     entity->setName(meshFilePathName);
@@ -667,7 +1038,7 @@ Scene::load(Ctr::IDevice* device,
     {
         Ctr::IndexedMesh* mesh = new Ctr::IndexedMesh(device);
         mesh->setName(shapes[meshId].name);
-        mesh->load(&shapes[meshId]);
+        mesh->load(meshData[meshId], _compressMeshesOnImport);
         entity->addMesh(mesh);
     }
 
@@ -678,12 +1049,21 @@ Scene::load(Ctr::IDevice* device,
 void
 Scene::update()
 {
+    CTR_PROFILE_SCOPE("Scene::update");
+
+    _transformHierarchy.update();
+    refitMeshBVHs();
+
     for (auto it = _probes.begin(); it != _probes.end(); it++)
     {
         (*it)->update();
     }
+    refitProbeBVH();
 
-    _brdfCache[_activeBrdfProperty->get()]->compute();
+    if (_brdfCache.size() > 0)
+    {
+        _brdfCache[_activeBrdfProperty->get()]->compute();
+    }
 
 }
 
@@ -698,9 +1078,50 @@ Scene::addProbe()
 {
     IBLProbe * probe = new IBLProbe(_device);
     _probes.push_back(probe);
+    _probeBVH.invalidate();
     return probe;
 }
 
+void
+Scene::refitProbeBVH() const
+{
+    std::vector<Region3f> positions(_probes.size());
+    for (size_t probeId = 0; probeId < _probes.size(); probeId++)
+    {
+        positions[probeId] = Region3f(_probes[probeId]->worldTranslation());
+    }
+
+    if (!_probeBVH.valid())
+        _probeBVH.build(positions);
+    else
+        _probeBVH.refit(positions);
+}
+
+void
+Scene::nearestProbes(const Vector3f& point, 
+                     uint32_t count,
+                     std::vector<uint32_t>& nearest) const
+{
+    if (!_probeBVH.valid())
+        refitProbeBVH();
+    _probeBVH.nearest(point, count, nearest);
+}
+
+IBLProbe*
+Scene::nearestProbe(const Mesh* mesh) const
+{
+    Vector3f point = mesh->worldTranslation();
+    if (mesh->hasBounds())
+    {
+        const Region3f& bounds = mesh->worldBounds();
+        point = (bounds.minExtent + bounds.maxExtent) * 0.5f;
+    }
+
+    std::vector<uint32_t> nearest;
+    nearestProbes(point, 1, nearest);
+    return nearest.size() > 0 ? _probes[nearest[0]] : nullptr;
+}
+
 const Camera *
 Scene::camera() const
 {
@@ -728,12 +1149,96 @@ Scene::meshesForPass(const std::string& passName) const
     }
 }
 
+void
+Scene::cullMeshesForPass(const std::string& passName, 
+                         const Frustum& frustum,
+                         std::vector<uint32_t>& visible) const
+{
+    CTR_PROFILE_SCOPE("Scene::cullMeshesForPass");
+
+    if (meshesForPass(passName).size() == 0)
+    {
+        return;
+    }
+    meshBVHForPass(passName).cull(frustum, visible);
+}
+
+bool
+Scene::intersectMeshesForPass(const std::string& passName,
+                              const Vector3f& origin,
+                              const Vector3f& direction,
+                              float maxDistance,
+                              MeshBVH::RayHit& hit) const
+{
+    if (meshesForPass(passName).size() == 0)
+    {
+        return false;
+    }
+    return meshBVHForPass(passName).intersect(origin, direction, maxDistance, hit);
+}
+
+void
+Scene::overlapMeshesForPass(const std::string& passName,
+                            const Region3f& bounds,
+                            std::vector<uint32_t>& overlapping) const
+{
+    if (meshesForPass(passName).size() == 0)
+    {
+        return;
+    }
+    meshBVHForPass(passName).overlap(bounds, overlapping);
+}
+
+void
+Scene::overlapMeshesForPass(const std::string& passName,
+                            const Vector3f& center,
+                            float radius,
+                            std::vector<uint32_t>& overlapping) const
+{
+    if (meshesForPass(passName).size() == 0)
+    {
+        return;
+    }
+    meshBVHForPass(passName).overlap(center, radius, overlapping);
+}
+
+MeshBVH&
+Scene::meshBVHForPass(const std::string& passName) const
+{
+    MeshBVH& bvh = _meshBVHByPass[passName];
+    if (!bvh.valid())
+    {
+        bvh.build(meshesForPass(passName));
+    }
+    return bvh;
+}
+
+void
+Scene::refitMeshBVHs()
+{
+    CTR_PROFILE_SCOPE("Scene::refitMeshBVHs");
+
+    // Trees not built yet are built on their first query.
+    for (auto it = _meshBVHByPass.begin(); it != _meshBVHByPass.end(); it++)
+    {
+        if (it->second.valid())
+        {
+            it->second.refit();
+        }
+    }
+}
+
 void
 Scene::addMesh(Mesh* mesh)
 {
     Ctr::Material* material = mesh->material();
     const std::vector<std::string>& passes = material->passes();
 
+    if (_useTransformHierarchy)
+    {
+        mesh->setHierarchy(&_transformHierarchy);
+    }
+
     // Cache meshes by contributing pass name.
     addToPass("all", mesh);
     for (auto passIt = passes.begin(); passIt != passes.end(); passIt++)
@@ -752,6 +1257,7 @@ Scene::addToPass(const std::string& passName, Mesh* mesh)
         meshPassIt = _meshesByPass.find(passName);
     }
     meshPassIt->second.push_back(mesh);
+    _meshBVHByPass[passName].append(mesh);
 }
 
 }
\ No newline at end of file
@@ -44,6 +44,9 @@
 #include <CtrPlatform.h>
 #include <CtrNode.h>
 #include <CtrRenderNode.h>
+#include <CtrMeshBVH.h>
+#include <CtrTransformHierarchy.h>
+#include <CtrHash.h>
 
 
 
@@ -51,10 +54,13 @@ namespace Ctr
 {
 class Entity;
 class Mesh;
+class IndexedMesh;
+struct IndexedMeshData;
 class Material;
 class Camera;
 class Brdf;
 class IBLProbe;
+class Frustum;
 
 class Scene : public Ctr::RenderNode
 {
@@ -72,14 +78,77 @@ class Scene : public Ctr::RenderNode
 
     void                       destroy(Entity* entity);
 
+    // Reorders imported meshes for the vertex cache, overdraw and vertex
+    // fetch. Off by default as it adds to load times.
+    static void                setOptimizeMeshesOnImport(bool optimize);
+    static bool                optimizeMeshesOnImport();
+
+    // Imports meshes with quantized vertices and 16 bit indices where
+    // they fit. Off by default, shaders must decode MESHPOSITIONDECODE.
+    static void                setCompressMeshesOnImport(bool compress);
+    static bool                compressMeshesOnImport();
+
+    // Builds a level of detail chain for imported meshes, drawn by
+    // render passes by projected size. Off by default.
+    static void                setGenerateLodsOnImport(bool generate);
+    static bool                generateLodsOnImport();
+
+    // Generates tangent frames for imported meshes with normals and uvs,
+    // in parallel across and within meshes. Off by default.
+    static void                setGenerateTangentsOnImport(bool generate);
+    static bool                generateTangentsOnImport();
+
+    // Keeps the world transforms of added meshes in a flat hierarchy
+    // updated by update(), rather than through their properties.
+    // Off by default, applies to meshes added after it is set.
+    static void                setUseTransformHierarchy(bool use);
+    static bool                useTransformHierarchy();
+    const TransformHierarchy&  transformHierarchy() const;
+
+    // Imported meshes with identical streams share one set of buffers,
+    // and meshes loaded with the same material share one Material, so
+    // that render passes can draw them instanced. Off by default.
+    static void                setInstanceMeshesOnImport(bool instance);
+    static bool                instanceMeshesOnImport();
+
     const Camera *             camera() const;
     Camera *                   camera();
 
     const std::vector<Ctr::Mesh*>& meshesForPass(const std::string& passName) const;
 
+    // Appends indices into meshesForPass(passName) of the meshes that
+    // intersect frustum. The pass BVH is built on first use and refit to
+    // the current mesh bounds once per frame by update().
+    void                       cullMeshesForPass(const std::string& passName,
+                                                 const Frustum& frustum,
+                                                 std::vector<uint32_t>& visible) const;
+
+    // Spatial queries over the world bounds of the meshes of a pass, for
+    // picking and the like. Indices refer to meshesForPass(passName).
+    bool                       intersectMeshesForPass(const std::string& passName,
+                                                      const Vector3f& origin,
+                                                      const Vector3f& direction,
+                                                      float maxDistance,
+                                                      MeshBVH::RayHit& hit) const;
+    void                       overlapMeshesForPass(const std::string& passName,
+                                                    const Region3f& bounds,
+                                                    std::vector<uint32_t>& overlapping) const;
+    void                       overlapMeshesForPass(const std::string& passName,
+                                                    const Vector3f& center,
+                                                    float radius,
+                                                    std::vector<uint32_t>& overlapping) const;
+
     const std::vector<IBLProbe*>& probes() const;
     IBLProbe*                   addProbe();
 
+    // Appends indices into probes() of the count probes nearest point,
+    // nearest first. Probe positions are refreshed by update().
+    void                       nearestProbes(const Vector3f& point,
+                                             uint32_t count,
+                                             std::vector<uint32_t>& nearest) const;
+    // The probe nearest the center of the mesh bounds, or its origin.
+    IBLProbe*                  nearestProbe(const Mesh* mesh) const;
+
     const Brdf*                activeBrdf() const;
     IntProperty*               activeBrdfProperty();
 
@@ -91,6 +160,15 @@ class Scene : public Ctr::RenderNode
     void                       addMesh(Mesh* mesh);
     void                       addToPass(const std::string& passName,
                                          Mesh* mesh);
+    void                       loadImportedMesh(IndexedMesh* mesh,
+                                                const IndexedMeshData& data);
+    // The BVH of a pass, built if it isn't valid.
+    MeshBVH&                   meshBVHForPass(const std::string& passName) const;
+    void                       refitMeshBVHs();
+    void                       refitProbeBVH() const;
+    Material*                  sharedMaterial(const std::string& key) const;
+    void                       addSharedMaterial(const std::string& key,
+                                                 Material* material);
 
   private:  
     Camera*                    _camera;
@@ -103,6 +181,19 @@ class Scene : public Ctr::RenderNode
     std::vector<IBLProbe*>     _probes;
     std::set<Material*>        _materials;
     std::map<std::string, std::vector<Ctr::Mesh*> > _meshesByPass;
+    mutable std::map<std::string, MeshBVH> _meshBVHByPass;
+    mutable MeshBVH            _probeBVH;
+    TransformHierarchy         _transformHierarchy;
+    // Geometry prototypes and materials by import key, see setInstanceMeshesOnImport.
+    std::map<Hash, IndexedMesh*> _sharedGeometry;
+    std::map<std::string, Material*> _sharedMaterials;
+
+    static bool                _optimizeMeshesOnImport;
+    static bool                _compressMeshesOnImport;
+    static bool                _generateLodsOnImport;
+    static bool                _generateTangentsOnImport;
+    static bool                _useTransformHierarchy;
+    static bool                _instanceMeshesOnImport;
 };
 
 }
@@ -42,6 +42,7 @@
 #include <CtrIDevice.h>
 #include <CtrIVertexDeclaration.h>
 #include <CtrVertexStream.h>
+#include <CtrVertexCompression.h>
 #include <CtrLog.h>
 
 namespace Ctr
@@ -92,60 +93,59 @@ StreamedMesh::internalStreamPtr()
 
     if (!_vertexBufferCpuMemory)
     {
-        _vertexBufferCpuMemory = (float*)malloc(sizeof(float)*vertexBufferSize());
+        _vertexBufferCpuMemory = malloc(vertexBufferSize());
     }
 
-    // stash the buffer and put it in an array
-    std::map <uint32_t, float*> streamMap;
+    // Resolve the stream of each element once, null where there is none.
+    const std::vector <VertexElement>& declaration = _vertexDeclaration->getDeclaration();
+    std::vector<const VertexStream*> elementStreams(declaration.size(), nullptr);
+    bool quantizedPositions = false;
+    for (uint32_t j = 0; j + 1 < declaration.size(); j++)
+    {
+        VertexStream* stream = nullptr;
+        if (findStream (stream, declaration[j]) && stream->stream())
+        {
+            elementStreams[j] = stream;
+        }
+        if (declaration[j].usage() == Ctr::POSITION &&
+            (declaration[j].type() == Ctr::USHORT4N || declaration[j].type() == Ctr::USHORT2N))
+        {
+            quantizedPositions = true;
+        }
+    }
 
-    for (auto it = _vertexStreams.begin();
-        it != _vertexStreams.end();
-        it++)
+    // Quantized positions are stored relative to the bounds.
+    if (quantizedPositions)
+    {
+        const Region3f& bounds = localBounds();
+        setPositionDecode(bounds.minExtent, bounds.maxExtent - bounds.minExtent);
+    }
+    else
     {
-        streamMap.insert (std::make_pair(it->first, it->second->stream()));
+        setPositionDecode(Vector3f(0.0f, 0.0f, 0.0f), Vector3f(1.0f, 1.0f, 1.0f));
     }
 
-    const std::vector <VertexElement>& declaration = _vertexDeclaration->getDeclaration();
-    float* vb = (float*)_vertexBufferCpuMemory;
+    const Vector3f& offset = positionDecodeOffset();
+    const Vector3f& scale = positionDecodeScale();
+    const uint32_t vertexStride = _vertexDeclaration->vertexStride();
+    uint8_t* vb = (uint8_t*)_vertexBufferCpuMemory;
 
     for (uint32_t i = 0; i < vertexCount(); i++)
     {    
-        for (uint32_t j = 0; j < declaration.size()-1; j++)
+        uint8_t* vertex = vb + size_t(i) * vertexStride;
+        for (uint32_t j = 0; j + 1 < declaration.size(); j++)
         {
-            VertexElement element = declaration[j];
-            VertexStream* stream = 0;
-            if (findStream (stream, element))
+            const VertexElement& element = declaration[j];
+            if (const VertexStream* stream = elementStreams[j])
             {
-                uint32_t streamId = VertexStream::id(*stream);
-                auto streamIt =  streamMap.find(streamId);
-
-                if (streamIt != streamMap.end() &&
-                    streamIt->second)
-                {
-                    for (uint32_t k = 0; k < stream->stride(); k++)
-                    {
-                        *vb++ = streamIt->second[k];
-                    }
-                    streamIt->second += stream->stride();
-                }
-                else
-                {
-                    uint32_t stride = IVertexDeclaration::elementToSize(element.type());
-                    for (uint32_t k = 0; k < stride; stride++)
-                    {
-                        *vb++ = 0;
-                    }
-                }
+                VertexCompression::encodeElement(element, stream->stream() + size_t(i) * stream->stride(),
+                                                 stream->stride(), offset, scale,
+                                                 vertex + element.offset());
             }
             else
             {
-                // can't find a stream for this element.
-                // warn user, and 0 the buffer for the stride size
-                uint32_t stride = IVertexDeclaration::elementToSize(element.type());
-                for (uint32_t k = 0; k < stride; stride++)
-                {
-                    *vb++ = 0;
-                }
+                // can't find a stream for this element, 0 the element.
+                memset (vertex + element.offset(), 0, IVertexDeclaration::elementToSize(element.type()));
             }
         }
     }
@@ -162,6 +162,7 @@ StreamedMesh::addStream (VertexStream* stream)
     if (stream->usage() == Ctr::POSITION)
     {
         _positionStream->set (stream);
+        updateBounds();
     }
     if (stream->usage() == Ctr::NORMAL)
     {
@@ -175,6 +176,30 @@ StreamedMesh::addStream (VertexStream* stream)
     return true;
 }
 
+void
+StreamedMesh::updateBounds()
+{
+    const VertexStream* positions = positionStream();
+    if (!positions || positions->count() == 0 || positions->stride() < 3 || !positions->stream())
+    {
+        return;
+    }
+
+    const float* position = positions->stream();
+    Vector3f minExtent (position[0], position[1], position[2]);
+    Vector3f maxExtent = minExtent;
+    for (uint32_t i = 1; i < positions->count(); i++)
+    {
+        position += positions->stride();
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            minExtent[k] = std::min(minExtent[k], position[k]);
+            maxExtent[k] = std::max(maxExtent[k], position[k]);
+        }
+    }
+    setLocalBounds(Region3f(minExtent, maxExtent));
+}
+
 const VertexStream*
 StreamedMesh::stream(DeclarationUsage type, uint32_t index) const
 {
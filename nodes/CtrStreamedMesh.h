@@ -61,6 +61,10 @@ class StreamedMesh : public Mesh
     const VertexStream*        texCoordStream(uint32_t index = 0) const;
     const VertexStream*        stream(DeclarationUsage type, uint32_t index = 0) const;
 
+    // Recomputes the local bounds from the position stream.
+    // Call after modifying positions in place.
+    void                       updateBounds();
+
   protected:
     bool                       findStream (VertexStream*&, 
                                           const VertexElement&);
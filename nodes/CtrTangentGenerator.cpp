@@ -0,0 +1,264 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrTangentGenerator.h>
+#include <CtrIndexedMesh.h>
+#include <CtrParallel.h>
+
+namespace Ctr
+{
+namespace
+{
+const size_t TrianglesPerBatch = 4096;
+const size_t VerticesPerBatch = 4096;
+
+// Vertex copies per handedness, see Corner::orientation.
+enum Handedness
+{
+    Mirrored = 0,
+    Preserved = 1
+};
+
+struct Corner
+{
+    // Angle weighted tangent, projected onto the vertex normal.
+    Vector3f                   tangent;
+    uint8_t                    orientation;
+    uint8_t                    valid;
+};
+
+inline Vector3f
+projectOnPlane(const Vector3f& v, const Vector3f& normal)
+{
+    return v - normal * normal.dot(v);
+}
+
+inline bool
+normalizeSafe(Vector3f& v)
+{
+    float length = v.length();
+    if (length <= FLT_MIN)
+        return false;
+    v = v * (1.0f / length);
+    return true;
+}
+
+// Some unit vector perpendicular to normal.
+Vector3f
+anyTangent(const Vector3f& normal)
+{
+    Vector3f axis = fabsf(normal.x) < 0.9f ? Vector3f(1.0f, 0.0f, 0.0f) : Vector3f(0.0f, 1.0f, 0.0f);
+    Vector3f tangent = projectOnPlane(axis, normal);
+    if (!normalizeSafe(tangent))
+        tangent = Vector3f(1.0f, 0.0f, 0.0f);
+    return tangent;
+}
+}
+
+bool
+TangentGenerator::generate(IndexedMeshData& mesh, Report* report)
+{
+    size_t vertexCount = mesh.positions.size();
+    size_t indexCount = mesh.indices.size();
+    if (indexCount < 3 || indexCount % 3 != 0 ||
+        mesh.normals.size() != vertexCount || mesh.uvs.size() != vertexCount)
+        return false;
+
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        if (mesh.indices[i] >= vertexCount)
+            return false;
+    }
+
+    const size_t triangleCount = indexCount / 3;
+    const uint32_t* indices = &mesh.indices[0];
+    const Vector3f* positions = &mesh.positions[0];
+    const Vector3f* normals = &mesh.normals[0];
+    const Vector2f* uvs = &mesh.uvs[0];
+
+    // Face and corner terms, written only by the batch owning the triangle.
+    std::vector<Corner> corners(indexCount);
+    std::vector<uint32_t> degenerate((triangleCount + TrianglesPerBatch - 1) / TrianglesPerBatch, 0);
+    Ctr::parallelFor(size_t(0), degenerate.size(), [&](size_t batch)
+    {
+        size_t last = std::min(triangleCount, (batch + 1) * TrianglesPerBatch);
+        for (size_t triangle = batch * TrianglesPerBatch; triangle < last; triangle++)
+        {
+            const uint32_t* face = &indices[triangle * 3];
+            Vector3f edge1 = positions[face[1]] - positions[face[0]];
+            Vector3f edge2 = positions[face[2]] - positions[face[0]];
+            Vector2f st1 = uvs[face[1]] - uvs[face[0]];
+            Vector2f st2 = uvs[face[2]] - uvs[face[0]];
+
+            float signedAreaSTx2 = st1.x * st2.y - st1.y * st2.x;
+            Vector3f faceTangent = edge1 * st2.y - edge2 * st1.y;
+            uint8_t orientation = signedAreaSTx2 > 0.0f ? Preserved : Mirrored;
+            if (signedAreaSTx2 < 0.0f)
+                faceTangent = -faceTangent;
+
+            bool valid = fabsf(signedAreaSTx2) > FLT_MIN && normalizeSafe(faceTangent);
+            if (!valid)
+                degenerate[batch]++;
+
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                Corner& corner = corners[triangle * 3 + k];
+                corner.orientation = orientation;
+                corner.valid = 0;
+                corner.tangent = Vector3f(0.0f);
+                if (!valid)
+                    continue;
+
+                uint32_t vertex = face[k];
+                const Vector3f& normal = normals[vertex];
+                Vector3f tangent = projectOnPlane(faceTangent, normal);
+                Vector3f next = projectOnPlane(positions[face[(k + 1) % 3]] - positions[vertex], normal);
+                Vector3f previous = projectOnPlane(positions[face[(k + 2) % 3]] - positions[vertex], normal);
+                if (!normalizeSafe(tangent) || !normalizeSafe(next) || !normalizeSafe(previous))
+                    continue;
+
+                float cosine = std::min(std::max(next.dot(previous), -1.0f), 1.0f);
+                corner.tangent = tangent * acosf(cosine);
+                corner.valid = 1;
+            }
+        }
+    });
+
+    // Corners of each vertex, by counting sort.
+    std::vector<uint32_t> cornerOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < indexCount; i++)
+        cornerOffsets[indices[i] + 1]++;
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+        cornerOffsets[vertex + 1] += cornerOffsets[vertex];
+    std::vector<uint32_t> vertexCorners(indexCount);
+    {
+        std::vector<uint32_t> fill(cornerOffsets.begin(), cornerOffsets.end() - 1);
+        for (size_t i = 0; i < indexCount; i++)
+            vertexCorners[fill[indices[i]]++] = uint32_t(i);
+    }
+
+    // Gather both handedness sums of each vertex. A vertex whose valid
+    // corners disagree keeps the preserved frame and its mirrored
+    // corners move to a copy.
+    std::vector<Vector3f> sums(vertexCount * 2, Vector3f(0.0f));
+    std::vector<uint8_t> handedness(vertexCount, 0);
+    size_t vertexBatches = (vertexCount + VerticesPerBatch - 1) / VerticesPerBatch;
+    Ctr::parallelFor(size_t(0), vertexBatches, [&](size_t batch)
+    {
+        size_t last = std::min(vertexCount, (batch + 1) * VerticesPerBatch);
+        for (size_t vertex = batch * VerticesPerBatch; vertex < last; vertex++)
+        {
+            uint8_t seen = 0;
+            for (uint32_t c = cornerOffsets[vertex]; c < cornerOffsets[vertex + 1]; c++)
+            {
+                const Corner& corner = corners[vertexCorners[c]];
+                if (!corner.valid)
+                    continue;
+                sums[vertex * 2 + corner.orientation] += corner.tangent;
+                seen |= uint8_t(1 << corner.orientation);
+            }
+            handedness[vertex] = seen;
+        }
+    });
+
+    std::vector<uint32_t> splits(vertexCount, ~0u);
+    uint32_t splitCount = 0;
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        if (handedness[vertex] == ((1 << Mirrored) | (1 << Preserved)))
+            splits[vertex] = uint32_t(vertexCount + splitCount++);
+    }
+
+    size_t outputCount = vertexCount + splitCount;
+    mesh.positions.resize(outputCount);
+    mesh.normals.resize(outputCount);
+    mesh.uvs.resize(outputCount);
+    mesh.tangents.resize(outputCount);
+
+    Ctr::parallelFor(size_t(0), vertexBatches, [&](size_t batch)
+    {
+        size_t last = std::min(vertexCount, (batch + 1) * VerticesPerBatch);
+        for (size_t vertex = batch * VerticesPerBatch; vertex < last; vertex++)
+        {
+            const Vector3f& normal = mesh.normals[vertex];
+            uint8_t seen = handedness[vertex];
+            uint8_t primary = (seen & (1 << Preserved)) || seen == 0 ? Preserved : Mirrored;
+
+            Vector3f tangent = projectOnPlane(sums[vertex * 2 + primary], normal);
+            if (!normalizeSafe(tangent))
+                tangent = anyTangent(normal);
+            mesh.tangents[vertex] = Vector4f(tangent.x, tangent.y, tangent.z, primary == Preserved ? 1.0f : -1.0f);
+
+            uint32_t split = splits[vertex];
+            if (split == ~0u)
+                continue;
+
+            mesh.positions[split] = mesh.positions[vertex];
+            mesh.normals[split] = normal;
+            mesh.uvs[split] = mesh.uvs[vertex];
+
+            tangent = projectOnPlane(sums[vertex * 2 + Mirrored], normal);
+            if (!normalizeSafe(tangent))
+                tangent = anyTangent(normal);
+            mesh.tangents[split] = Vector4f(tangent.x, tangent.y, tangent.z, -1.0f);
+
+            for (uint32_t c = cornerOffsets[vertex]; c < cornerOffsets[vertex + 1]; c++)
+            {
+                uint32_t index = vertexCorners[c];
+                if (corners[index].valid && corners[index].orientation == Mirrored)
+                    mesh.indices[index] = split;
+            }
+        }
+    });
+
+    if (report)
+    {
+        report->triangles = uint32_t(triangleCount);
+        report->vertices = uint32_t(outputCount);
+        report->splitVertices = splitCount;
+        report->degenerateTriangles = 0;
+        for (size_t batch = 0; batch < degenerate.size(); batch++)
+            report->degenerateTriangles += degenerate[batch];
+    }
+    return true;
+}
+
+}
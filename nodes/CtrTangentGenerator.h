@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_TANGENT_GENERATOR
+#define INCLUDED_CRT_TANGENT_GENERATOR
+
+#include <CtrPlatform.h>
+
+namespace Ctr
+{
+struct IndexedMeshData;
+
+//--------------------------------------------------------------------
+//
+// TangentGenerator
+//
+// Per vertex tangent frames following the MikkTSpace conventions, so
+// normal maps baked by the usual tools decode without seams:
+//
+// - The face tangent is the direction of increasing u, negated with
+//   the uv winding, and each corner projects it onto the vertex normal.
+// - Corners are weighted by their angle in the tangent plane.
+// - w holds the bitangent sign, bitangent = w * cross(normal, tangent),
+//   in the shader.
+// - Vertices shared by faces with mirrored uvs are split, one copy per
+//   handedness.
+//
+// Face and corner terms are computed in parallel over triangles into
+// per corner storage. Each vertex then gathers its own corners, so no
+// two threads write the same value and no atomics are needed. The
+// result does not depend on the thread count.
+//
+//--------------------------------------------------------------------
+class TangentGenerator
+{
+  public:
+    struct Report
+    {
+        uint32_t               triangles;
+        uint32_t               vertices;
+        // Copies added where mirrored uvs meet.
+        uint32_t               splitVertices;
+        // Triangles without uv area, which add nothing to their vertices.
+        uint32_t               degenerateTriangles;
+    };
+
+    // Fills mesh.tangents, appending split vertices to every stream.
+    // Run before levels of detail are built.
+    static bool                generate(IndexedMeshData& mesh, Report* report = nullptr);
+};
+}
+
+#endif
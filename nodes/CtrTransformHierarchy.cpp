@@ -0,0 +1,327 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrTransformHierarchy.h>
+#include <CtrTransformNode.h>
+#include <CtrProfiler.h>
+#include <CtrLog.h>
+#include <CtrParallel.h>
+
+namespace Ctr
+{
+namespace
+{
+// Levels narrower than two batches are updated on the calling thread.
+const uint32_t NodesPerBatch = 256;
+}
+
+const TransformHierarchy::Handle TransformHierarchy::InvalidHandle;
+
+TransformHierarchy::TransformHierarchy() :
+    _layoutDirty (false)
+{
+    memset(&_stats, 0, sizeof(Stats));
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+}
+
+TransformHierarchy::Handle
+TransformHierarchy::add(TransformNode* node)
+{
+    Handle handle;
+    if (_freeHandles.size() > 0)
+    {
+        handle = _freeHandles.back();
+        _freeHandles.pop_back();
+    }
+    else
+    {
+        handle = (Handle)_records.size();
+        _records.push_back(Record());
+    }
+
+    // Appended as a root until the next rebuild sorts it into its level.
+    Record& record = _records[handle];
+    record.node = node;
+    record.index = (uint32_t)_handles.size();
+    record.dirty = false;
+
+    _handles.push_back(handle);
+    _parents.push_back(InvalidHandle);
+    _locals.push_back(Matrix44f());
+    _worlds.push_back(Matrix44f());
+    _dirty.push_back(0);
+
+    _layoutDirty = true;
+    markDirty(handle);
+    return handle;
+}
+
+void
+TransformHierarchy::remove(Handle handle)
+{
+    Record& record = _records[handle];
+    record.node = nullptr;
+    record.dirty = false;
+    _freeHandles.push_back(handle);
+    _layoutDirty = true;
+}
+
+void
+TransformHierarchy::markDirty(Handle handle)
+{
+    Record& record = _records[handle];
+    if (!record.dirty)
+    {
+        record.dirty = true;
+        _dirtyHandles.push_back(handle);
+    }
+}
+
+void
+TransformHierarchy::invalidate()
+{
+    _layoutDirty = true;
+}
+
+const Ctr::Matrix44f&
+TransformHierarchy::world(Handle handle) const
+{
+    return _worlds[_records[handle].index];
+}
+
+const TransformHierarchy::Stats&
+TransformHierarchy::stats() const
+{
+    return _stats;
+}
+
+uint32_t
+TransformHierarchy::level(uint32_t index) const
+{
+    return (uint32_t)(std::upper_bound(_levels.begin(), _levels.end(), index) - _levels.begin()) - 1;
+}
+
+void
+TransformHierarchy::rebuild()
+{
+    const uint32_t handleCount = (uint32_t)_records.size();
+
+    // Parent handle of each live node.
+    uint32_t externalParents = 0;
+    std::vector<Handle> parentHandles(handleCount, InvalidHandle);
+    for (Handle handle = 0; handle < handleCount; handle++)
+    {
+        const TransformNode* node = _records[handle].node;
+        const TransformNode* parent = node ? node->parent() : nullptr;
+        if (parent)
+        {
+            if (parent->hierarchy() == this)
+                parentHandles[handle] = parent->hierarchyHandle();
+            else
+                externalParents++;
+        }
+    }
+
+    if (externalParents > 0)
+    {
+        LOG_WARNING("TransformHierarchy: " << externalParents << 
+                    " nodes have parents outside of the hierarchy and are treated as roots.");
+    }
+
+    // Depth of each live node, walking up to the first node with a known depth.
+    std::vector<uint32_t> depths(handleCount, InvalidHandle);
+    std::vector<Handle> chain;
+    uint32_t levelCount = 0;
+    for (Handle handle = 0; handle < handleCount; handle++)
+    {
+        if (!_records[handle].node || depths[handle] != InvalidHandle)
+            continue;
+
+        chain.clear();
+        Handle ancestor = handle;
+        while (ancestor != InvalidHandle && depths[ancestor] == InvalidHandle)
+        {
+            chain.push_back(ancestor);
+            ancestor = parentHandles[ancestor];
+        }
+
+        uint32_t depth = ancestor == InvalidHandle ? 0 : depths[ancestor] + 1;
+        for (auto it = chain.rbegin(); it != chain.rend(); it++)
+        {
+            depths[*it] = depth++;
+        }
+        levelCount = std::max(levelCount, depth);
+    }
+
+    // Counting sort by depth.
+    _levels.assign(levelCount + 1, 0);
+    for (Handle handle = 0; handle < handleCount; handle++)
+    {
+        if (_records[handle].node)
+            _levels[depths[handle] + 1]++;
+    }
+    for (uint32_t levelId = 0; levelId < levelCount; levelId++)
+    {
+        _levels[levelId + 1] += _levels[levelId];
+    }
+
+    const uint32_t nodeCount = _levels[levelCount];
+    std::vector<uint32_t> cursors(_levels.begin(), _levels.end() - 1);
+    std::vector<Handle> handles(nodeCount);
+    std::vector<Matrix44f> locals(nodeCount);
+    std::vector<Matrix44f> worlds(nodeCount);
+    for (Handle handle = 0; handle < handleCount; handle++)
+    {
+        Record& record = _records[handle];
+        if (!record.node)
+            continue;
+
+        uint32_t index = cursors[depths[handle]]++;
+        handles[index] = handle;
+        locals[index] = _locals[record.index];
+        worlds[index] = _worlds[record.index];
+        record.index = index;
+    }
+
+    _parents.resize(nodeCount);
+    for (uint32_t index = 0; index < nodeCount; index++)
+    {
+        Handle parent = parentHandles[handles[index]];
+        _parents[index] = parent != InvalidHandle ? _records[parent].index : InvalidHandle;
+    }
+
+    _handles.swap(handles);
+    _locals.swap(locals);
+    _worlds.swap(worlds);
+    // Parents may have changed anywhere, so recompute every world transform.
+    _dirty.assign(nodeCount, 1);
+
+    _stats.nodes = nodeCount;
+    _stats.levels = levelCount;
+}
+
+void
+TransformHierarchy::update()
+{
+    CTR_PROFILE_SCOPE("TransformHierarchy::update");
+
+    _stats.dirtyNodes = 0;
+    _stats.updatedNodes = 0;
+
+    uint32_t firstLevel = (uint32_t)_levels.size();
+    if (_layoutDirty)
+    {
+        rebuild();
+        firstLevel = 0;
+        _layoutDirty = false;
+    }
+
+    // Pull the local transforms that changed, through the node properties.
+    for (auto it = _dirtyHandles.begin(); it != _dirtyHandles.end(); it++)
+    {
+        Record& record = _records[*it];
+        if (!record.node || !record.dirty)
+            continue;
+
+        record.dirty = false;
+        _locals[record.index] = record.node->localTransform();
+        _dirty[record.index] = 1;
+        firstLevel = std::min(firstLevel, level(record.index));
+        _stats.dirtyNodes++;
+    }
+    _dirtyHandles.clear();
+
+    if (firstLevel + 1 >= _levels.size())
+        return;
+
+    // A node is recomputed when it or its parent is dirty, and then marks
+    // itself dirty for its children on the next level.
+    auto updateRange = [this](uint32_t first, uint32_t last)
+    {
+        for (uint32_t index = first; index < last; index++)
+        {
+            uint32_t parent = _parents[index];
+            if (parent == InvalidHandle)
+            {
+                if (_dirty[index])
+                    _worlds[index] = _locals[index];
+            }
+            else if (_dirty[index] || _dirty[parent])
+            {
+                _dirty[index] = 1;
+                _worlds[index] = _locals[index] * _worlds[parent];
+            }
+        }
+    };
+
+    for (uint32_t levelId = firstLevel; levelId + 1 < _levels.size(); levelId++)
+    {
+        uint32_t first = _levels[levelId];
+        uint32_t last = _levels[levelId + 1];
+        if (last - first < NodesPerBatch * 2)
+        {
+            updateRange(first, last);
+        }
+        else
+        {
+            uint32_t batchCount = (last - first + NodesPerBatch - 1) / NodesPerBatch;
+            Ctr::parallelFor(uint32_t(0), batchCount, [&](uint32_t batchId)
+            {
+                uint32_t batchFirst = first + batchId * NodesPerBatch;
+                updateRange(batchFirst, std::min(batchFirst + NodesPerBatch, last));
+            });
+        }
+    }
+
+    for (uint32_t index = _levels[firstLevel]; index < (uint32_t)_dirty.size(); index++)
+    {
+        if (_dirty[index])
+        {
+            _stats.updatedNodes++;
+            _dirty[index] = 0;
+        }
+    }
+}
+
+}
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_TRANSFORM_HIERARCHY
+#define INCLUDED_CRT_TRANSFORM_HIERARCHY
+
+#include <CtrPlatform.h>
+#include <CtrMatrix44.h>
+
+namespace Ctr
+{
+class TransformNode;
+
+//------------------------------------------------------------------
+// Flat storage for the world transforms of many TransformNodes.
+// Local and world matrices live in contiguous arrays sorted by depth,
+// so every parent precedes its children. update() pulls the local
+// transforms of nodes that changed since the last update, then walks
+// the levels in order, recomputing only nodes under a dirty ancestor.
+// Nodes on the same level are independent and are updated in parallel.
+//
+// Nodes join with TransformNode::setHierarchy. Their world transforms
+// are valid after the next update(). Parents outside the hierarchy
+// are ignored, the node is treated as a root.
+//------------------------------------------------------------------
+class TransformHierarchy
+{
+  public:
+    typedef uint32_t           Handle;
+    static const Handle        InvalidHandle = UINT32_MAX;
+
+    struct Stats
+    {
+        uint32_t               nodes;
+        uint32_t               levels;
+        // Nodes whose local transform changed.
+        uint32_t               dirtyNodes;
+        // Nodes whose world transform was recomputed.
+        uint32_t               updatedNodes;
+    };
+
+    TransformHierarchy();
+    ~TransformHierarchy();
+
+    Handle                     add(TransformNode* node);
+    void                       remove(Handle handle);
+
+    // The node's local transform changed.
+    void                       markDirty(Handle handle);
+    // A parent changed, the levels are rebuilt on the next update.
+    void                       invalidate();
+
+    const Ctr::Matrix44f&      world(Handle handle) const;
+
+    void                       update();
+
+    const Stats&               stats() const;
+
+  private:
+    struct Record
+    {
+        TransformNode*         node;
+        uint32_t               index;
+        bool                   dirty;
+    };
+
+    void                       rebuild();
+    uint32_t                   level(uint32_t index) const;
+
+    std::vector<Record>        _records;
+    std::vector<Handle>        _freeHandles;
+    std::vector<Handle>        _dirtyHandles;
+
+    // Depth sorted, indexed by Record::index.
+    std::vector<Handle>        _handles;
+    std::vector<uint32_t>      _parents;
+    std::vector<Ctr::Matrix44f> _locals;
+    std::vector<Ctr::Matrix44f> _worlds;
+    std::vector<uint8_t>       _dirty;
+    // First index of each level, plus the end.
+    std::vector<uint32_t>      _levels;
+
+    bool                       _layoutDirty;
+    Stats                      _stats;
+};
+
+}
+
+#endif
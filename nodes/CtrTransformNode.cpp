@@ -40,12 +40,15 @@
 //------------------------------------------------------------------------------------//
 #include <CtrTransformNode.h>
 #include <CtrTransformProperty.h>
+#include <CtrTransformHierarchy.h>
 
 namespace Ctr
 {
 TransformNode::TransformNode(Ctr::IDevice* device) : 
 RenderNode(device), 
-_parent (nullptr) 
+_parent (nullptr),
+_hierarchy (nullptr),
+_hierarchyHandle (TransformHierarchy::InvalidHandle)
 {
     _translationProperty = new VectorProperty (this, std::string("Translation"));
 
@@ -69,6 +72,10 @@ _parent (nullptr)
 
 TransformNode::~TransformNode()
 {
+    if (_hierarchy)
+    {
+        _hierarchy->remove(_hierarchyHandle);
+    }
 }
 
 void
@@ -86,9 +93,19 @@ TransformNode::lastWorldTransformProperty() const
 const Ctr::Matrix44f&
 TransformNode::worldTransform() const
 {
+    if (_hierarchy)
+    {
+        return _hierarchy->world(_hierarchyHandle);
+    }
     return _worldTransformProperty->worldProperty()->get();
 }
 
+Ctr::Matrix44f
+TransformNode::localTransform() const
+{
+    return _worldTransformProperty->localTransform();
+}
+
 const Ctr::Vector3f&
 TransformNode::translation() const
 {
@@ -98,9 +115,7 @@ TransformNode::translation() const
 Ctr::Vector3f
 TransformNode::worldTranslation() const
 {
-   const Ctr::Matrix44f& transform = 
-       worldTransformProperty()->worldProperty()->get();
-   return transform.translation();
+   return worldTransform().translation();
 }
 
 const Ctr::Vector3f&
@@ -172,13 +187,21 @@ TransformNode::children() const
 void
 TransformNode::setParent(Ctr::TransformNode* parent)
 {
-    if (_parent)
+    // Within a hierarchy the parent is applied by the hierarchy, not through the properties.
+    if (_hierarchy)
     {
-        worldTransformProperty()->removeDependency (_parent->worldTransformProperty()->worldProperty(), Ctr::TransformProperty::Parent);
+        _hierarchy->invalidate();
     }
-    if (parent)
+    else
     {
-        worldTransformProperty()->addDependency (parent->worldTransformProperty()->worldProperty(), Ctr::TransformProperty::Parent);
+        if (_parent)
+        {
+            worldTransformProperty()->removeDependency (_parent->worldTransformProperty()->worldProperty(), Ctr::TransformProperty::Parent);
+        }
+        if (parent)
+        {
+            worldTransformProperty()->addDependency (parent->worldTransformProperty()->worldProperty(), Ctr::TransformProperty::Parent);
+        }
     }
     _parent = parent;
 }
@@ -189,4 +212,49 @@ TransformNode::parent()
     return _parent;
 }
 
+const Ctr::TransformNode*
+TransformNode::parent() const
+{
+    return _parent;
+}
+
+void
+TransformNode::setHierarchy(TransformHierarchy* hierarchy)
+{
+    if (hierarchy == _hierarchy)
+    {
+        return;
+    }
+
+    if (_hierarchy)
+    {
+        _hierarchy->remove(_hierarchyHandle);
+    }
+    else if (_parent)
+    {
+        worldTransformProperty()->removeDependency (_parent->worldTransformProperty()->worldProperty(), Ctr::TransformProperty::Parent);
+    }
+
+    _hierarchy = hierarchy;
+    _hierarchyHandle = _hierarchy ? _hierarchy->add(this) : TransformHierarchy::InvalidHandle;
+    _worldTransformProperty->setHierarchy(_hierarchy, _hierarchyHandle);
+
+    if (!_hierarchy && _parent)
+    {
+        worldTransformProperty()->addDependency (_parent->worldTransformProperty()->worldProperty(), Ctr::TransformProperty::Parent);
+    }
+}
+
+const TransformHierarchy*
+TransformNode::hierarchy() const
+{
+    return _hierarchy;
+}
+
+uint32_t
+TransformNode::hierarchyHandle() const
+{
+    return _hierarchyHandle;
+}
+
 }
\ No newline at end of file
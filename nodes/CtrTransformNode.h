@@ -50,6 +50,7 @@ namespace Ctr
 {
 class TransformProperty;
 class TransformNode;
+class TransformHierarchy;
 
 class TransformNode : public Ctr::RenderNode
 {
@@ -60,6 +61,7 @@ class TransformNode : public Ctr::RenderNode
     Ctr::Vector3f               worldTranslation() const;
 
     const Ctr::Matrix44f&       worldTransform() const;
+    Ctr::Matrix44f              localTransform() const;
     const Ctr::Vector3f&        translation() const;
     const Ctr::Vector3f&        rotation() const;
     const Ctr::Vector3f&        scale () const;
@@ -76,12 +78,19 @@ class TransformNode : public Ctr::RenderNode
 
     void                       setParent(Ctr::TransformNode* parent);
     Ctr::TransformNode*         parent();
+    const Ctr::TransformNode*   parent() const;
     Ctr::TransformNode*         child(const std::string& name);
     const std::vector <Ctr::TransformNode*> &    children() const;
 
     void                       cacheLastWorldTransform() const;
     MatrixProperty*            lastWorldTransformProperty() const;
 
+    // Opt in to flat storage of the world transform. While in a hierarchy
+    // worldTransform() is only refreshed by TransformHierarchy::update.
+    void                       setHierarchy(TransformHierarchy* hierarchy);
+    const TransformHierarchy*  hierarchy() const;
+    uint32_t                   hierarchyHandle() const;
+
   protected:
     TransformProperty*         _worldTransformProperty;
     VectorProperty*            _translationProperty;
@@ -91,6 +100,8 @@ class TransformNode : public Ctr::RenderNode
     std::vector <Ctr::TransformNode*> _entities;
     Ctr::TransformNode*       _parent;
     MatrixProperty*                 _lastWorldTransformProperty;
+    TransformHierarchy*        _hierarchy;
+    uint32_t                   _hierarchyHandle;
 };
 
 }
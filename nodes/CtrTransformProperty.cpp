@@ -39,6 +39,7 @@
 //                                                                                    //
 //------------------------------------------------------------------------------------//
 #include <CtrTransformProperty.h>
+#include <CtrTransformHierarchy.h>
 #include <CtrLog.h>
 #include <CtrMath.h>
 
@@ -52,7 +53,9 @@ TransformProperty::TransformProperty(Node* node, const std::string& name) :
     _rotationDependency (nullptr),
     _scaleDependency (nullptr),
     _parentDependency (nullptr),
-    _drivenDependency (nullptr)
+    _drivenDependency (nullptr),
+    _hierarchy (nullptr),
+    _hierarchyHandle (TransformHierarchy::InvalidHandle)
 {
     _preWorldProperty = new MatrixProperty(this, std::string("preWorldProperty"), this);
     _worldProperty = new MatrixProperty(this, std::string("worldProperty"), this);
@@ -116,19 +119,36 @@ TransformProperty::removeDependency(Property* p, size_t dependencyId)
 }
 
 void
-TransformProperty::computeWorld (const Property* property) const
+TransformProperty::setHierarchy(TransformHierarchy* hierarchy, uint32_t handle)
 {
-    Ctr::Matrix44f world;
-    if (_drivenDependency)
+    _hierarchy = hierarchy;
+    _hierarchyHandle = handle;
+}
+
+void
+TransformProperty::uncache()
+{
+    Property::uncache();
+    if (_hierarchy)
     {
-        memcpy(&world, &_drivenDependency->get(), sizeof (Ctr::Matrix44f));
-        world = _preWorldProperty->get() * world;
+        _hierarchy->markDirty(_hierarchyHandle);
     }
-    else
+}
+
+Ctr::Matrix44f
+TransformProperty::localTransform() const
+{
+    if (_drivenDependency)
     {
-        world = _preWorldProperty->get();
+        return _preWorldProperty->get() * _drivenDependency->get();
     }
+    return _preWorldProperty->get();
+}
 
+void
+TransformProperty::computeWorld (const Property* property) const
+{
+    Ctr::Matrix44f world = localTransform();
     if (_parentDependency)
     {
         world = world * _parentDependency->get();
@@ -46,6 +46,8 @@
 
 namespace Ctr
 {
+class TransformHierarchy;
+
 class TransformProperty : public Property
 {
   public:
@@ -57,6 +59,13 @@ class TransformProperty : public Property
     void                       computePreWorld(const Property* property) const;
     void                       computeWorld(const Property* property) const;
 
+    // The world transform before the parent is applied.
+    Ctr::Matrix44f             localTransform() const;
+
+    // Changes to the local transform are forwarded to the hierarchy.
+    void                       setHierarchy(TransformHierarchy* hierarchy, uint32_t handle);
+    virtual void               uncache();
+
     enum DependencyId
     {
         Parent,
@@ -77,6 +86,8 @@ class TransformProperty : public Property
     const VectorProperty*      _translationDependency;
     const VectorProperty*      _rotationDependency;
     const VectorProperty*      _scaleDependency;    
+    TransformHierarchy*        _hierarchy;
+    uint32_t                   _hierarchyHandle;
 };
 
 }
@@ -0,0 +1,303 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrVertexCompression.h>
+#include <CtrMeshOptimizer.h>
+#include <CtrIVertexDeclaration.h>
+#include <CtrRenderEnums.h>
+#include <CtrBitwise.h>
+
+namespace Ctr
+{
+namespace
+{
+uint32_t
+componentCount(BYTE type)
+{
+    switch (type)
+    {
+        case FLOAT1:
+            return 1;
+        case FLOAT2:
+        case SHORT2:
+        case SHORT2N:
+        case USHORT2N:
+        case FLOAT16_2:
+            return 2;
+        case FLOAT3:
+            return 3;
+        case FLOAT4:
+        case UBYTE4:
+        case UBYTE4N:
+        case SHORT4:
+        case SHORT4N:
+        case USHORT4N:
+        case FLOAT16_4:
+            return 4;
+    }
+    return 0;
+}
+
+float
+signOf(float value)
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+}
+
+uint16_t
+VertexCompression::quantizeUnorm16(float value)
+{
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return uint16_t(value * 65535.0f + 0.5f);
+}
+
+float
+VertexCompression::dequantizeUnorm16(uint16_t value)
+{
+    return float(value) / 65535.0f;
+}
+
+int16_t
+VertexCompression::quantizeSnorm16(float value)
+{
+    value = std::min(std::max(value, -1.0f), 1.0f);
+    return int16_t(value * 32767.0f + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+float
+VertexCompression::dequantizeSnorm16(int16_t value)
+{
+    return std::max(float(value) / 32767.0f, -1.0f);
+}
+
+void
+VertexCompression::encodeOctahedral(const Vector3f& normal, int16_t encoded[2])
+{
+    // Project onto the octahedron and fold the lower hemisphere over the diagonals.
+    float length = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+    if (length <= 0.0f)
+    {
+        encoded[0] = encoded[1] = 0;
+        return;
+    }
+
+    float x = normal.x / length;
+    float y = normal.y / length;
+    if (normal.z < 0.0f)
+    {
+        float foldedX = (1.0f - fabsf(y)) * signOf(x);
+        float foldedY = (1.0f - fabsf(x)) * signOf(y);
+        x = foldedX;
+        y = foldedY;
+    }
+
+    encoded[0] = quantizeSnorm16(x);
+    encoded[1] = quantizeSnorm16(y);
+}
+
+Vector3f
+VertexCompression::decodeOctahedral(const int16_t encoded[2])
+{
+    Vector3f normal(dequantizeSnorm16(encoded[0]), dequantizeSnorm16(encoded[1]), 0.0f);
+    normal.z = 1.0f - fabsf(normal.x) - fabsf(normal.y);
+
+    float t = std::max(-normal.z, 0.0f);
+    normal.x += normal.x >= 0.0f ? -t : t;
+    normal.y += normal.y >= 0.0f ? -t : t;
+
+    float length = normal.length();
+    return length > 0.0f ? normal * (1.0f / length) : normal;
+}
+
+void
+VertexCompression::encodePosition(const Vector3f& position, 
+                                  const Vector3f& offset, const Vector3f& scale,
+                                  uint16_t encoded[4])
+{
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        float value = scale[axis] > 0.0f ? (position[axis] - offset[axis]) / scale[axis] : 0.0f;
+        encoded[axis] = quantizeUnorm16(value);
+    }
+    encoded[3] = 0;
+}
+
+Vector3f
+VertexCompression::decodePosition(const uint16_t encoded[4],
+                                  const Vector3f& offset, const Vector3f& scale)
+{
+    Vector3f position;
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        position[axis] = offset[axis] + dequantizeUnorm16(encoded[axis]) * scale[axis];
+    }
+    return position;
+}
+
+void
+VertexCompression::declaration(std::vector<VertexElement>& elements, bool tangents)
+{
+    elements.clear();
+    elements.push_back(VertexElement(0, 0, USHORT4N, METHOD_DEFAULT, POSITION, 0));
+    elements.push_back(VertexElement(0, 8, SHORT2N, METHOD_DEFAULT, NORMAL, 0));
+    elements.push_back(VertexElement(0, 12, FLOAT16_2, METHOD_DEFAULT, TEXCOORD, 0));
+    if (tangents)
+        elements.push_back(VertexElement(0, 16, SHORT4N, METHOD_DEFAULT, TANGENT, 0));
+    elements.push_back(VertexElement(0xFF, 0, UNUSED, 0, 0, 0));
+}
+
+void
+VertexCompression::encodeElement(const VertexElement& element,
+                                 const float* source, uint32_t components,
+                                 const Vector3f& offset, const Vector3f& scale,
+                                 uint8_t* destination)
+{
+    uint32_t count = componentCount(element.type());
+    uint32_t size = IVertexDeclaration::elementToSize(element.type());
+
+    // Missing components read as 0, as the input assembler would.
+    float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (uint32_t k = 0; k < components && k < 4; k++)
+    {
+        values[k] = source[k];
+    }
+
+    switch (element.type())
+    {
+        case FLOAT1:
+        case FLOAT2:
+        case FLOAT3:
+        case FLOAT4:
+            memcpy(destination, values, size);
+            break;
+        case USHORT2N:
+        case USHORT4N:
+        {
+            uint16_t encoded[4] = { 0, 0, 0, 0 };
+            if (element.usage() == POSITION && components >= 3)
+            {
+                encodePosition(Vector3f(values[0], values[1], values[2]), offset, scale, encoded);
+            }
+            else
+            {
+                for (uint32_t k = 0; k < count; k++)
+                    encoded[k] = quantizeUnorm16(values[k]);
+            }
+            memcpy(destination, encoded, size);
+            break;
+        }
+        case SHORT2N:
+        case SHORT4N:
+        {
+            int16_t encoded[4] = { 0, 0, 0, 0 };
+            if (count == 2 && components >= 3)
+            {
+                encodeOctahedral(Vector3f(values[0], values[1], values[2]), encoded);
+            }
+            else
+            {
+                for (uint32_t k = 0; k < count; k++)
+                    encoded[k] = quantizeSnorm16(values[k]);
+            }
+            memcpy(destination, encoded, size);
+            break;
+        }
+        case FLOAT16_2:
+        case FLOAT16_4:
+        {
+            uint16_t encoded[4];
+            for (uint32_t k = 0; k < count; k++)
+                encoded[k] = Bitwise::floatToHalf(values[k]);
+            memcpy(destination, encoded, size);
+            break;
+        }
+        case UBYTE4:
+        case UBYTE4N:
+        {
+            uint8_t encoded[4];
+            for (uint32_t k = 0; k < 4; k++)
+                encoded[k] = uint8_t(std::min(std::max(values[k], 0.0f), 1.0f) * 255.0f + 0.5f);
+            memcpy(destination, encoded, size);
+            break;
+        }
+        default:
+            memset(destination, 0, size);
+            break;
+    }
+}
+
+bool
+VertexCompression::shortIndices(size_t vertexCount)
+{
+    return vertexCount < 65536;
+}
+
+void
+VertexCompression::measure(Report& report,
+                           const uint32_t* indices, size_t indexCount, 
+                           size_t vertexCount,
+                           uint32_t vertexStrideBefore, uint32_t vertexStrideAfter,
+                           uint32_t indexSizeBefore, uint32_t indexSizeAfter,
+                           const Vector3f& positionScale)
+{
+    report.vertices = uint32_t(vertexCount);
+    report.indices = uint32_t(indexCount);
+    report.vertexStrideBefore = vertexStrideBefore;
+    report.vertexStrideAfter = vertexStrideAfter;
+    report.indexSizeBefore = indexSizeBefore;
+    report.indexSizeAfter = indexSizeAfter;
+
+    report.memoryBefore = uint32_t(vertexCount * vertexStrideBefore + indexCount * indexSizeBefore);
+    report.memoryAfter = uint32_t(vertexCount * vertexStrideAfter + indexCount * indexSizeAfter);
+
+    MeshOptimizer::CacheStats cache = 
+        MeshOptimizer::analyzeVertexCache(indices, indexCount, vertexCount);
+    size_t misses = size_t(cache.acmr * float(indexCount / 3) + 0.5f);
+    report.fetchBefore = uint32_t(misses * vertexStrideBefore + indexCount * indexSizeBefore);
+    report.fetchAfter = uint32_t(misses * vertexStrideAfter + indexCount * indexSizeAfter);
+
+    // Half a quantization step on the longest axis.
+    float extent = std::max(positionScale.x, std::max(positionScale.y, positionScale.z));
+    report.positionError = extent / 65535.0f * 0.5f;
+}
+
+}
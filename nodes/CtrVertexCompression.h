@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_VERTEX_COMPRESSION
+#define INCLUDED_CRT_VERTEX_COMPRESSION
+
+#include <CtrPlatform.h>
+#include <CtrVector3.h>
+#include <CtrVertexElement.h>
+
+namespace Ctr
+{
+//--------------------------------------------------------------------
+//
+// VertexCompression
+//
+// Packing for compact vertex buffers. Positions are USHORT4N relative
+// to the mesh bounds, unit vectors are octahedral SHORT2N and texture
+// coordinates FLOAT16_2, 16 bytes per vertex against 32 for floats.
+// StreamedMesh encodes its float streams with encodeElement according
+// to the declaration, so the host copies stay in float.
+//
+// Shaders decode positions and normals with:
+//
+//   float4 PositionDecode[2] : MESHPOSITIONDECODE;
+//
+//   float3 decodePosition(float4 p)
+//   {
+//       return PositionDecode[0].xyz + p.xyz * PositionDecode[1].xyz;
+//   }
+//
+//   float3 decodeOctahedral(float2 e)
+//   {
+//       float3 n = float3(e, 1.0 - abs(e.x) - abs(e.y));
+//       float t = saturate(-n.z);
+//       n.xy += n.xy >= 0.0 ? -t : t;
+//       return normalize(n);
+//   }
+//
+// MESHPOSITIONDECODE is the identity for float meshes, so the same
+// shader serves both layouts.
+//
+//--------------------------------------------------------------------
+class VertexCompression
+{
+  public:
+    // Memory and per draw bandwidth of one mesh in both layouts.
+    struct Report
+    {
+        uint32_t               vertices;
+        uint32_t               indices;
+        uint32_t               vertexStrideBefore;
+        uint32_t               vertexStrideAfter;
+        uint32_t               indexSizeBefore;
+        uint32_t               indexSizeAfter;
+        // Vertex and index buffer bytes.
+        uint32_t               memoryBefore;
+        uint32_t               memoryAfter;
+        // Bytes read by one draw, the index buffer plus one vertex per
+        // post transform cache miss.
+        uint32_t               fetchBefore;
+        uint32_t               fetchAfter;
+        // Largest object space position error from quantization.
+        float                  positionError;
+    };
+
+    static uint16_t            quantizeUnorm16(float value);
+    static float               dequantizeUnorm16(uint16_t value);
+    static int16_t             quantizeSnorm16(float value);
+    static float               dequantizeSnorm16(int16_t value);
+
+    static void                encodeOctahedral(const Vector3f& normal, int16_t encoded[2]);
+    static Vector3f            decodeOctahedral(const int16_t encoded[2]);
+
+    static void                encodePosition(const Vector3f& position, 
+                                              const Vector3f& offset, const Vector3f& scale,
+                                              uint16_t encoded[4]);
+    static Vector3f            decodePosition(const uint16_t encoded[4],
+                                              const Vector3f& offset, const Vector3f& scale);
+
+    // Compressed POSITION, NORMAL, TEXCOORD layout, end marker included.
+    // tangents adds a SHORT4N TANGENT, xyz and the bitangent sign.
+    static void                declaration(std::vector<VertexElement>& elements,
+                                           bool tangents = false);
+
+    // Writes one element of one vertex from components floats. Positions
+    // stored as normalized integers are taken relative to offset and scale.
+    static void                encodeElement(const VertexElement& element,
+                                             const float* source, uint32_t components,
+                                             const Vector3f& offset, const Vector3f& scale,
+                                             uint8_t* destination);
+
+    // 16 bit indices address every vertex.
+    static bool                shortIndices(size_t vertexCount);
+
+    static void                measure(Report& report,
+                                       const uint32_t* indices, size_t indexCount, 
+                                       size_t vertexCount,
+                                       uint32_t vertexStrideBefore, uint32_t vertexStrideAfter,
+                                       uint32_t indexSizeBefore, uint32_t indexSizeAfter,
+                                       const Vector3f& positionScale);
+};
+}
+
+#endif
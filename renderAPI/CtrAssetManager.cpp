@@ -44,7 +44,9 @@
 #include <CtrLog.h>
 #include <sys/stat.h>
 
+#if IBL_USE_LIBZIP
 #include <zip.h>
+#endif
 
 namespace Ctr
 {
@@ -73,8 +75,8 @@ AssetManager::openXmlDocument(const std::string& resourcePathName)
 {
     pugi::xml_document * xmlDocument = nullptr;
 
-    std::unique_ptr<typename DataStream> stream = 
-        std::unique_ptr<typename DataStream>(openStream(resourcePathName));
+    std::unique_ptr<DataStream> stream = 
+        std::unique_ptr<DataStream>(openStream(resourcePathName));
     if (stream)
     {
         xmlDocument = new pugi::xml_document();
@@ -114,6 +116,7 @@ AssetManager::openArchive(const std::string& archivePathName,
                           ArchiveHandle& resultHandle)
 {
     bool result = false;
+#if IBL_USE_LIBZIP
     int error = 0;
     zip *z = zip_open(archivePathName.c_str(), 0, &error);
     if (z == nullptr)
@@ -128,6 +131,9 @@ AssetManager::openArchive(const std::string& archivePathName,
         _archives.insert(std::make_pair(resultHandle, z));
         result = true;
     }
+#else
+    LOG("Built without libzip, can't open archive " << archivePathName);
+#endif
     return result;
 }
 
@@ -142,6 +148,7 @@ AssetManager::openCompressedStream(const ArchiveHandle& handle,
                                    const std::string& streamPathName)
 {
     DataStream* dataStream = nullptr;
+#if IBL_USE_LIBZIP
     int idx = -1;
     auto it = _archives.find(handle);
     zip* archive = nullptr;
@@ -177,6 +184,7 @@ AssetManager::openCompressedStream(const ArchiveHandle& handle,
             }
         }
     }
+#endif
 
     return dataStream;
 }
@@ -38,101 +38,379 @@
 //    THE SOFTWARE.                                                                   //
 //                                                                                    //
 //------------------------------------------------------------------------------------//
+
 #include <CtrFileChangeWatcher.h>
 #include <CtrLog.h>
 
+#if !(_WIN32 || _WIN64) && __linux__
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
 namespace Ctr
 {
+namespace
+{
+// How long the watch thread sleeps when nothing is pending.
+const uint32_t IdleWaitMilliseconds = 250;
+
+std::string
+normalizePath(std::string path)
+{
+    std::replace(path.begin(), path.end(), '\\', '/');
+    while (path.length() > 1 && path.back() == '/')
+    {
+        path.pop_back();
+    }
+    return path;
+}
+
+// Editor swap and backup files never need a reload.
+bool
+ignoredFile(const std::string& filePathName)
+{
+    size_t slash = filePathName.rfind('/');
+    std::string name = slash == std::string::npos ? filePathName : filePathName.substr(slash + 1);
+    return name.empty() || name[0] == '.' || name.back() == '~';
+}
+}
+
+//-----------------------------------------------------------
+// Bounded single producer, single consumer ring of changed
+// paths. The watch thread is the only producer, the frame
+// thread calling FileChangeWatcher::update the only consumer.
+//-----------------------------------------------------------
+class FileChangeQueue
+{
+  public:
+    FileChangeQueue() :
+        _head(0),
+        _tail(0)
+    {
+    }
+
+    bool push(const std::string& filePathName)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        _paths[tail & (Capacity - 1)] = filePathName;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(std::string& filePathName)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        filePathName.swap(_paths[head & (Capacity - 1)]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    enum { Capacity = 1024 };
+
+    std::string                _paths[Capacity];
+    std::atomic<size_t>        _head;
+    std::atomic<size_t>        _tail;
+};
+
+#if _WIN32 || _WIN64
+
 #define MAX_BUFFER  4096
-typedef struct DIRECTORY_INFO {   
-HANDLE      hDir;   
-TCHAR       lpszDirName[MAX_BUFFER];   
-CHAR        lpBuffer[MAX_BUFFER];   
-DWORD       dwBufLength;   
-OVERLAPPED  Overlapped;   
+typedef struct DIRECTORY_INFO {
+HANDLE      hDir;
+std::string root;
+DWORD       lpBuffer[MAX_BUFFER / sizeof(DWORD)];
+DWORD       dwBufLength;
+OVERLAPPED  Overlapped;
 }*PDIRECTORY_INFO, *LPDIRECTORY_INFO;
 
-namespace
+//-----------------------------------------------------------
+// One directory handle per root, all bound to a single
+// completion port that the watch thread waits on.
+//-----------------------------------------------------------
+struct FileWatchPlatform
 {
-FileChangeWatcher*  fileChangeWatcher = nullptr;
+    FileWatchPlatform() :
+        completionPort(nullptr)
+    {
+    }
+
+    ~FileWatchPlatform()
+    {
+        for (LPDIRECTORY_INFO di : directories)
+        {
+            CancelIo(di->hDir);
+            CloseHandle(di->hDir);
+            delete di;
+        }
+        if (completionPort)
+        {
+            CloseHandle(completionPort);
+        }
+    }
 
-void WINAPI CheckChangedFile( LPDIRECTORY_INFO lpdi,   
-                              PFILE_NOTIFY_INFORMATION lpfni)   
-{   
-    TCHAR      szFullPathName[MAX_PATH];   
+    static bool issueRead(LPDIRECTORY_INFO di)
+    {
+        return ReadDirectoryChangesW(di->hDir,
+                                     di->lpBuffer,
+                                     MAX_BUFFER,
+                                     TRUE,
+                                     FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME,
+                                     &di->dwBufLength,
+                                     &di->Overlapped,
+                                     NULL) != 0;
+    }
+
+    bool addRoot(const std::string& root)
+    {
+        std::wstring pathName(root.begin(), root.end());
+        LPDIRECTORY_INFO di = new DIRECTORY_INFO();
+        di->root = root;
+        di->hDir = CreateFileW(pathName.c_str(),
+                               FILE_LIST_DIRECTORY,
+                               FILE_SHARE_READ |
+                               FILE_SHARE_WRITE |
+                               FILE_SHARE_DELETE,
+                               NULL,
+                               OPEN_EXISTING,
+                               FILE_FLAG_BACKUP_SEMANTICS |
+                               FILE_FLAG_OVERLAPPED,
+                               NULL);
+        if (di->hDir == INVALID_HANDLE_VALUE)
+        {
+            delete di;
+            return false;
+        }
 
-    lstrcpy( szFullPathName, lpdi->lpszDirName );   
-    lstrcat( szFullPathName, L"/" );   
+        completionPort = CreateIoCompletionPort(di->hDir, completionPort, (ULONG_PTR)di, 0);
+        if (!completionPort || !issueRead(di))
+        {
+            CloseHandle(di->hDir);
+            delete di;
+            return false;
+        }
+        directories.push_back(di);
+        return true;
+    }
 
-    lstrcat( szFullPathName, lpfni->FileName );
+    void wait(FileChangeWatcher* watcher, uint32_t milliseconds)
+    {
+        DWORD numBytes = 0;
+        LPDIRECTORY_INFO di = nullptr;
+        LPOVERLAPPED lpOverlapped = nullptr;
+        GetQueuedCompletionStatus(completionPort,
+                                  &numBytes,
+                                  reinterpret_cast<PULONG_PTR>(&di),
+                                  &lpOverlapped,
+                                  milliseconds);
+        // Timeout, or the wake posted by wake().
+        if (!di)
+            return;
 
-    std::wstring wPathName(szFullPathName);
-    std::string filePathName(wPathName.begin(), wPathName.end());
+        if (numBytes > 0)
+        {
+            PFILE_NOTIFY_INFORMATION fni = (PFILE_NOTIFY_INFORMATION)di->lpBuffer;
+            for (;;)
+            {
+                if (fni->Action != FILE_ACTION_REMOVED && fni->Action != FILE_ACTION_RENAMED_OLD_NAME)
+                {
+                    // FileName is not null terminated.
+                    std::wstring fileName(fni->FileName, fni->FileNameLength / sizeof(WCHAR));
+                    watcher->addChange(di->root + "/" + std::string(fileName.begin(), fileName.end()));
+                }
+                if (!fni->NextEntryOffset)
+                    break;
+                fni = (PFILE_NOTIFY_INFORMATION)((LPBYTE)fni + fni->NextEntryOffset);
+            }
+        }
+        else
+        {
+            LOG_WARNING("File watch buffer overflowed in " << di->root);
+        }
 
-    if (fileChangeWatcher)
+        // Reissue the watch command
+        issueRead(di);
+    }
+
+    void wake()
     {
-        fileChangeWatcher->addChange(filePathName);
+        PostQueuedCompletionStatus(completionPort, 0, 0, NULL);
     }
-}
 
-void WINAPI handleDirectoryChange(ULONG_PTR dwCompletionPort)
+    HANDLE                        completionPort;
+    std::vector<LPDIRECTORY_INFO> directories;
+};
+
+#elif __linux__
+
+//-----------------------------------------------------------
+// inotify is not recursive, so every directory under a root
+// gets its own watch, and directories created later are
+// added as they appear. A pipe wakes poll for shutdown.
+//-----------------------------------------------------------
+struct FileWatchPlatform
 {
-    DWORD numBytes;
-    DWORD cbOffset;
-    LPDIRECTORY_INFO di;
-    LPOVERLAPPED lpOverlapped;
-    PFILE_NOTIFY_INFORMATION fni;
+    FileWatchPlatform() :
+        inotifyHandle(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+    {
+        wakePipe[0] = wakePipe[1] = -1;
+        if (pipe(wakePipe) == 0)
+        {
+            fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+        }
+    }
 
-    do
+    ~FileWatchPlatform()
     {
-        // Retrieve the directory info for this directory   
-        // through the completion key   
-        GetQueuedCompletionStatus( (HANDLE) dwCompletionPort,   
-                                   &numBytes,   
-                                   reinterpret_cast<PULONG_PTR>(&di),   
-                                   &lpOverlapped,   
-                                   INFINITE);   
-        if ( di )   
-        {   
-   
-            fni = (PFILE_NOTIFY_INFORMATION)di->lpBuffer;   
-   
-            do   
-            {   
-                cbOffset = fni->NextEntryOffset;   
-   
-                //if( fni->Action == FILE_ACTION_MODIFIED )   
-                CheckChangedFile( di, fni );   
-   
-                fni = (PFILE_NOTIFY_INFORMATION)((LPBYTE) fni + cbOffset);   
-   
-            } while( cbOffset );   
-   
-            // Reissue the watch command   
-            ReadDirectoryChangesW( di->hDir,di->lpBuffer,   
-                                   MAX_BUFFER,   
-                                   TRUE,   
-                                   FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_ATTRIBUTES,   
-                                   &di->dwBufLength,   
-                                   &di->Overlapped,   
-                                   NULL);   
-        }   
-   
+        if (inotifyHandle >= 0)
+            close(inotifyHandle);
+        if (wakePipe[0] >= 0)
+            close(wakePipe[0]);
+        if (wakePipe[1] >= 0)
+            close(wakePipe[1]);
     }
-    while( di );
-}
-}
 
-FileChangeWatcher::FileChangeWatcher() :
-    _processHandle(nullptr),
-    _processCompletionHandle(nullptr)
+    bool addRoot(const std::string& root)
+    {
+        return inotifyHandle >= 0 && addDirectory(root);
+    }
+
+    bool addDirectory(const std::string& path)
+    {
+        const uint32_t mask = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE_SELF;
+        int watch = inotify_add_watch(inotifyHandle, path.c_str(), mask | IN_ONLYDIR);
+        if (watch < 0)
+        {
+            return false;
+        }
+        directories[watch] = path;
+
+        if (DIR* dir = opendir(path.c_str()))
+        {
+            while (dirent* entry = readdir(dir))
+            {
+                std::string name = entry->d_name;
+                if (name == "." || name == "..")
+                    continue;
+
+                std::string child = path + "/" + name;
+                struct stat status;
+                if (stat(child.c_str(), &status) == 0 && S_ISDIR(status.st_mode))
+                {
+                    addDirectory(child);
+                }
+            }
+            closedir(dir);
+        }
+        return true;
+    }
+
+    void wait(FileChangeWatcher* watcher, uint32_t milliseconds)
+    {
+        pollfd handles[2] = { { inotifyHandle, POLLIN, 0 }, { wakePipe[0], POLLIN, 0 } };
+        if (poll(handles, 2, (int)milliseconds) <= 0)
+            return;
+
+        if (handles[1].revents & POLLIN)
+        {
+            char drain[64];
+            while (read(wakePipe[0], drain, sizeof(drain)) > 0)
+            {
+            }
+        }
+
+        if (!(handles[0].revents & POLLIN))
+            return;
+
+        alignas(inotify_event) char buffer[16384];
+        ssize_t length = 0;
+        while ((length = read(inotifyHandle, buffer, sizeof(buffer))) > 0)
+        {
+            for (char* ptr = buffer; ptr < buffer + length; )
+            {
+                const inotify_event* event = (const inotify_event*)ptr;
+                ptr += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    LOG_WARNING("File watch queue overflowed, some changes were lost");
+                    continue;
+                }
+
+                auto directory = directories.find(event->wd);
+                if (directory == directories.end())
+                    continue;
+
+                if (event->mask & IN_IGNORED)
+                {
+                    directories.erase(directory);
+                    continue;
+                }
+                if (event->len == 0)
+                    continue;
+
+                std::string filePathName = directory->second + "/" + event->name;
+                if (event->mask & IN_ISDIR)
+                {
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                        addDirectory(filePathName);
+                }
+                else
+                {
+                    watcher->addChange(filePathName);
+                }
+            }
+        }
+    }
+
+    void wake()
+    {
+        if (wakePipe[1] >= 0)
+        {
+            char signal = 1;
+            ssize_t written = write(wakePipe[1], &signal, 1);
+            (void)written;
+        }
+    }
+
+    int                        inotifyHandle;
+    int                        wakePipe[2];
+    std::map<int, std::string> directories;
+};
+
+#else
+
+// No watch backend on this platform; hot reload is unavailable.
+struct FileWatchPlatform
 {
-    if (!fileChangeWatcher)
+    bool addRoot(const std::string&) { return false; }
+    void wait(FileChangeWatcher*, uint32_t milliseconds)
     {
-        fileChangeWatcher = this;
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
     }
+    void wake() {}
+};
+
+#endif
 
-    initialize();
+FileChangeWatcher::FileChangeWatcher() :
+    _debounce(100),
+    _platform(new FileWatchPlatform()),
+    _queue(new FileChangeQueue()),
+    _stop(false)
+{
 }
 
 FileChangeWatcher::~FileChangeWatcher()
@@ -141,108 +419,140 @@ FileChangeWatcher::~FileChangeWatcher()
 }
 
 bool
-FileChangeWatcher::initialize()
+FileChangeWatcher::addRoot(const std::string& path)
 {
-    unsigned long tid = 0;
-    // Max length of lpszDirName?
-    wchar_t currentPath[4096];
-    memset(currentPath, 0, sizeof(wchar_t)* 4096);
-    _wgetcwd(currentPath, 4096);
-    std::wstring pathName = currentPath + std::wstring(L"/data/shadersD3D11");
-
-    _dirInfo = new DIRECTORY_INFO ();
-    _dirInfo->hDir = CreateFile(pathName.c_str(),
-                                FILE_LIST_DIRECTORY,   
-                                FILE_SHARE_READ |   
-                                FILE_SHARE_WRITE |   
-                                FILE_SHARE_DELETE,   
-                                NULL,   
-                                OPEN_EXISTING,   
-                                FILE_FLAG_BACKUP_SEMANTICS |   
-                                FILE_FLAG_OVERLAPPED,   
-                                NULL);   
-    
-    if( _dirInfo->hDir == INVALID_HANDLE_VALUE )   
-    {   
-        LOG( "Unable to open directory for file watching");
+    if (_thread.joinable())
+    {
+        LOG_WARNING("Cannot add watch root " << path << " after the watcher has started");
         return false;
     }
-    
-    memcpy(_dirInfo->lpszDirName, pathName.c_str(), sizeof(wchar_t) * pathName.length());
-    _processCompletionHandle= CreateIoCompletionPort( _dirInfo->hDir,   
-                                                     _processCompletionHandle,   
-                                                     (ULONG_PTR)_dirInfo,   
-                                                     0);   
 
-    ReadDirectoryChangesW(_dirInfo->hDir,   
-                          _dirInfo->lpBuffer,   
-                          MAX_BUFFER,   
-                          TRUE,   
-                          FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_ATTRIBUTES,   
-                          &_dirInfo->dwBufLength,&_dirInfo->Overlapped,   
-                          NULL);  
+    std::string root = normalizePath(path);
+    if (std::find(_roots.begin(), _roots.end(), root) != _roots.end())
+    {
+        return true;
+    }
 
+    if (!_platform->addRoot(root))
+    {
+        LOG("Unable to open directory " << root << " for file watching");
+        return false;
+    }
 
+    LOG("Watching " << root << " for changes");
+    _roots.push_back(root);
+    return true;
+}
 
-    _processHandle = CreateThread(NULL, 0,   
-                                  (LPTHREAD_START_ROUTINE) handleDirectoryChange,   
-                                  _processCompletionHandle,   
-                                  0,   
-                                  &tid);
+void
+FileChangeWatcher::setDebounce(uint32_t milliseconds)
+{
+    _debounce = std::chrono::milliseconds(milliseconds);
+}
 
+bool
+FileChangeWatcher::initialize()
+{
+    if (_roots.empty() || _thread.joinable())
+    {
+        return false;
+    }
+
+    _stop.store(false);
+    _thread = std::thread(&FileChangeWatcher::run, this);
     return true;
 }
 
 bool
 FileChangeWatcher::destroy()
 {
-    if(_processHandle!=nullptr)
+    if (_thread.joinable())
     {
-        // Post completion
-        PostQueuedCompletionStatus( _processCompletionHandle, 0, 0, NULL );   
+        _stop.store(true);
+        _platform->wake();
+        _thread.join();
+        return true;
+    }
+    return false;
+}
 
-        // Wait for thread to stop
-        if(_processHandle!=nullptr)
+void
+FileChangeWatcher::run()
+{
+    while (!_stop.load())
+    {
+        // Sleep until the oldest pending path settles, or until the next event.
+        uint32_t timeout = IdleWaitMilliseconds;
+        if (!_pending.empty())
         {
-            WaitForSingleObject(_processHandle,INFINITE);
-            CloseHandle(_processHandle);
+            auto now = std::chrono::steady_clock::now();
+            auto oldest = _pending.begin()->second;
+            for (auto it = _pending.begin(); it != _pending.end(); it++)
+            {
+                oldest = std::min(oldest, it->second);
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(oldest + _debounce - now);
+            timeout = (uint32_t)std::max((long long)remaining.count(), 1ll);
         }
-        CloseHandle(_processCompletionHandle);
-        // Close monitoring handle
-        CloseHandle(_dirInfo->hDir);
-        delete _dirInfo;
-        return true;
+
+        _platform->wait(this, timeout);
+        publish();
     }
-    return false;
 }
 
 void
-FileChangeWatcher::addChange(const std::string& filename)
+FileChangeWatcher::publish()
 {
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = _pending.begin(); it != _pending.end(); )
     {
-        std::lock_guard<std::recursive_mutex> lock(_taskLock);
-        LOG ("Added change " << filename);
-        _changeList.insert (std::string(filename));
+        if (now - it->second >= _debounce)
+        {
+            // Leave it pending if the frame thread has fallen behind.
+            if (!_queue->push(it->first))
+                return;
+            it = _pending.erase(it);
+        }
+        else
+        {
+            it++;
+        }
     }
 }
 
-bool
-FileChangeWatcher::hasChanges() const
+void
+FileChangeWatcher::addChange(const std::string& filePathName)
 {
+    std::string path = normalizePath(filePathName);
+    if (!ignoredFile(path))
     {
-        std::lock_guard<std::recursive_mutex> lock(_taskLock);
-        return _changeList.size() > 0;
+        // Every event restarts the window for that path.
+        _pending[path] = std::chrono::steady_clock::now();
     }
 }
 
-std::set<std::string>
-FileChangeWatcher::changeList() const
+void
+FileChangeWatcher::update()
 {
+    _changes.clear();
+
+    std::string filePathName;
+    while (_queue->pop(filePathName))
     {
-        std::lock_guard<std::recursive_mutex> lock(_taskLock);
-        std::set<std::string> changes = _changeList;
-        _changeList.clear();
-        return changes;
+        LOG("Added change " << filePathName);
+        _changes.insert(filePathName);
     }
 }
+
+bool
+FileChangeWatcher::hasChanges() const
+{
+    return !_changes.empty();
+}
+
+const std::set<std::string>&
+FileChangeWatcher::changes() const
+{
+    return _changes;
+}
 }
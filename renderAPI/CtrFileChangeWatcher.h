@@ -38,41 +38,73 @@
 //    THE SOFTWARE.                                                                   //
 //                                                                                    //
 //------------------------------------------------------------------------------------//
+
 #ifndef INCLUDED_FILE_CHANGE_WATCHER
 #define INCLUDED_FILE_CHANGE_WATCHER
 
 #include <CtrPlatform.h>
 #include <memory>
-#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
 
 namespace Ctr
 {
-struct DIRECTORY_INFO;
+struct FileWatchPlatform;
+class FileChangeQueue;
+
+//-----------------------------------------------------------
+// class FileChangeWatcher
+// Watches one or more directory trees for modified files
+// (ReadDirectoryChangesW on Windows, inotify on Linux).
+// A watch thread coalesces bursts of events per file and only
+// publishes a path once it has been quiet for the debounce
+// window. Published paths go through a lock free queue that
+// update() drains once per frame.
+//-----------------------------------------------------------
 class FileChangeWatcher
 {
   public:
     FileChangeWatcher();
     virtual ~FileChangeWatcher();
 
+    // Roots are relative to the working directory and must be added
+    // before initialize. Reported paths are root + "/" + relative path.
+    bool                          addRoot(const std::string& path);
+    void                          setDebounce(uint32_t milliseconds);
+
     bool                          initialize();
+
+    // Moves everything published since the last call into changes().
+    void                          update();
+
     bool                          hasChanges() const;
-    std::set<std::string>         changeList() const;
+    const std::set<std::string>&  changes() const;
 
-    void                          addChange(const std::string& filename);
+    // Called on the watch thread by the platform backend for every raw event.
+    void                          addChange(const std::string& filePathName);
 
   protected:
     bool                          destroy();
 
-  protected:
-    HANDLE                        _processHandle;
-    HANDLE                        _processCompletionHandle;
+  private:
+    void                          run();
+    void                          publish();
 
   private:
-    mutable std::set<std::string>  _changeList;
+    std::vector<std::string>           _roots;
+    std::chrono::milliseconds          _debounce;
+
+    std::unique_ptr<FileWatchPlatform> _platform;
+    std::unique_ptr<FileChangeQueue>   _queue;
+    std::thread                        _thread;
+    std::atomic<bool>                  _stop;
 
-    mutable std::recursive_mutex   _taskLock;
-    DIRECTORY_INFO  *              _dirInfo;
+    // Watch thread only: last raw event time per path.
+    std::map<std::string, std::chrono::steady_clock::time_point> _pending;
+    // Frame thread only.
+    std::set<std::string>              _changes;
 };
 }
 
-#endif
\ No newline at end of file
+#endif
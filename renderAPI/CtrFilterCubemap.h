@@ -24,6 +24,7 @@
 #define INCLUDED_CRT_FILTER_CUBEMAP
 
 #include <CtrTextureImage.h>
+#include <CtrParallel.h>
 
 namespace Ctr
 {
@@ -34,6 +35,10 @@ enum CubemapFixupType
     CP_FIXUP_AVERAGE_HERMITE,
     CP_FIXUP_PULL_HERMITE,
     CP_FIXUP_PULL_LINEAR,
+    // Resample each face so that the border texel centers lie on the cube edges,
+    // then average the shared border texels. For targets sampled without 
+    // seamless cube filtering (the fixup width is ignored).
+    CP_FIXUP_STRETCH,
 };
 
 //used to index cube faces
@@ -64,418 +69,581 @@ struct CPCubeMapNeighbor
     uint8_t m_Edge;    //edge in neighboring face that abuts this face
 };
 
-
 //---------------------------------------------------
 // Source: AMDCubemapGen.
-// Fixup cube edges
-// average texels on cube map faces across the edges.
+// Static cube topology tables.
 //---------------------------------------------------
-template <typename T>
-void
-fixupCubeEdges (Ctr::TextureImagePtr cubemap, 
-                int32_t mipId, 
-                CubemapFixupType fixupType, 
-                float fixupWidth)
-{
-
-CPCubeMapNeighbor sg_CubeNgh[6][4] =
+struct CPCubeMapTables
 {
-    //XPOS face
-    {{CP_FACE_Z_POS, CP_EDGE_RIGHT },
-     {CP_FACE_Z_NEG, CP_EDGE_LEFT  },
-     {CP_FACE_Y_POS, CP_EDGE_RIGHT },
-     {CP_FACE_Y_NEG, CP_EDGE_RIGHT }},
-    //XNEG face
-    {{CP_FACE_Z_NEG, CP_EDGE_RIGHT },
-     {CP_FACE_Z_POS, CP_EDGE_LEFT  },
-     {CP_FACE_Y_POS, CP_EDGE_LEFT  },
-     {CP_FACE_Y_NEG, CP_EDGE_LEFT  }},
-    //YPOS face
-    {{CP_FACE_X_NEG, CP_EDGE_TOP },
-     {CP_FACE_X_POS, CP_EDGE_TOP },
-     {CP_FACE_Z_NEG, CP_EDGE_TOP },
-     {CP_FACE_Z_POS, CP_EDGE_TOP }},
-    //YNEG face
-    {{CP_FACE_X_NEG, CP_EDGE_BOTTOM},
-     {CP_FACE_X_POS, CP_EDGE_BOTTOM},
-     {CP_FACE_Z_POS, CP_EDGE_BOTTOM},
-     {CP_FACE_Z_NEG, CP_EDGE_BOTTOM}},
-    //ZPOS face
-    {{CP_FACE_X_NEG, CP_EDGE_RIGHT  },
-     {CP_FACE_X_POS, CP_EDGE_LEFT   },
-     {CP_FACE_Y_POS, CP_EDGE_BOTTOM },
-     {CP_FACE_Y_NEG, CP_EDGE_TOP    }},
-    //ZNEG face
-    {{CP_FACE_X_POS, CP_EDGE_RIGHT  },
-     {CP_FACE_X_NEG, CP_EDGE_LEFT   },
-     {CP_FACE_Y_POS, CP_EDGE_TOP    },
-     {CP_FACE_Y_NEG, CP_EDGE_BOTTOM }}
+    static const CPCubeMapNeighbor& neighbor(int32_t face, int32_t edge)
+    {
+        static const CPCubeMapNeighbor sg_CubeNgh[6][4] =
+        {
+            //XPOS face
+            {{CP_FACE_Z_POS, CP_EDGE_RIGHT },
+             {CP_FACE_Z_NEG, CP_EDGE_LEFT  },
+             {CP_FACE_Y_POS, CP_EDGE_RIGHT },
+             {CP_FACE_Y_NEG, CP_EDGE_RIGHT }},
+            //XNEG face
+            {{CP_FACE_Z_NEG, CP_EDGE_RIGHT },
+             {CP_FACE_Z_POS, CP_EDGE_LEFT  },
+             {CP_FACE_Y_POS, CP_EDGE_LEFT  },
+             {CP_FACE_Y_NEG, CP_EDGE_LEFT  }},
+            //YPOS face
+            {{CP_FACE_X_NEG, CP_EDGE_TOP },
+             {CP_FACE_X_POS, CP_EDGE_TOP },
+             {CP_FACE_Z_NEG, CP_EDGE_TOP },
+             {CP_FACE_Z_POS, CP_EDGE_TOP }},
+            //YNEG face
+            {{CP_FACE_X_NEG, CP_EDGE_BOTTOM},
+             {CP_FACE_X_POS, CP_EDGE_BOTTOM},
+             {CP_FACE_Z_POS, CP_EDGE_BOTTOM},
+             {CP_FACE_Z_NEG, CP_EDGE_BOTTOM}},
+            //ZPOS face
+            {{CP_FACE_X_NEG, CP_EDGE_RIGHT  },
+             {CP_FACE_X_POS, CP_EDGE_LEFT   },
+             {CP_FACE_Y_POS, CP_EDGE_BOTTOM },
+             {CP_FACE_Y_NEG, CP_EDGE_TOP    }},
+            //ZNEG face
+            {{CP_FACE_X_POS, CP_EDGE_RIGHT  },
+             {CP_FACE_X_NEG, CP_EDGE_LEFT   },
+             {CP_FACE_Y_POS, CP_EDGE_TOP    },
+             {CP_FACE_Y_NEG, CP_EDGE_BOTTOM }}
+        };
+        return sg_CubeNgh[face][edge];
+    }
+
+    //The 12 edges of the cubemap, (entries are used to index into the neighbor table)
+    // this table is used to average over the edges.
+    static const int32_t* edge(int32_t edgeId)
+    {
+        static const int32_t sg_CubeEdgeList[12][2] = {
+           {CP_FACE_X_POS, CP_EDGE_LEFT},
+           {CP_FACE_X_POS, CP_EDGE_RIGHT},
+           {CP_FACE_X_POS, CP_EDGE_TOP},
+           {CP_FACE_X_POS, CP_EDGE_BOTTOM},
+
+           {CP_FACE_X_NEG, CP_EDGE_LEFT},
+           {CP_FACE_X_NEG, CP_EDGE_RIGHT},
+           {CP_FACE_X_NEG, CP_EDGE_TOP},
+           {CP_FACE_X_NEG, CP_EDGE_BOTTOM},
+
+           {CP_FACE_Z_POS, CP_EDGE_TOP},
+           {CP_FACE_Z_POS, CP_EDGE_BOTTOM},
+           {CP_FACE_Z_NEG, CP_EDGE_TOP},
+           {CP_FACE_Z_NEG, CP_EDGE_BOTTOM}
+        };
+        return sg_CubeEdgeList[edgeId];
+    }
+
+    // The 12 edges split into 4 rounds of 3. Edges in a round touch 6 distinct 
+    // faces, so they can be fixed up concurrently without sharing texels.
+    static const int32_t* edgeRound(int32_t roundId)
+    {
+        static const int32_t sg_CubeEdgeRounds[4][3] = {
+            { 0, 6, 11 },
+            { 1, 7, 8 },
+            { 2, 4, 9 },
+            { 3, 5, 10 }
+        };
+        return sg_CubeEdgeRounds[roundId];
+    }
+
+    static int32_t corner(int32_t face, int32_t cornerId)
+    {
+        static const int32_t sg_CubeCornerList[6][4] = {
+           { CP_CORNER_PPP, CP_CORNER_PPN, CP_CORNER_PNP, CP_CORNER_PNN }, // XPOS face
+           { CP_CORNER_NPN, CP_CORNER_NPP, CP_CORNER_NNN, CP_CORNER_NNP }, // XNEG face
+           { CP_CORNER_NPN, CP_CORNER_PPN, CP_CORNER_NPP, CP_CORNER_PPP }, // YPOS face
+           { CP_CORNER_NNP, CP_CORNER_PNP, CP_CORNER_NNN, CP_CORNER_PNN }, // YNEG face
+           { CP_CORNER_NPP, CP_CORNER_PPP, CP_CORNER_NNP, CP_CORNER_PNP }, // ZPOS face
+           { CP_CORNER_PPN, CP_CORNER_NPN, CP_CORNER_PNN, CP_CORNER_NNN }  // ZNEG face
+        };
+        return sg_CubeCornerList[face][cornerId];
+    }
 };
 
-//The 12 edges of the cubemap, (entries are used to index into the neighbor table)
-// this table is used to average over the edges.
-int32_t sg_CubeEdgeList[12][2] = {
-   {CP_FACE_X_POS, CP_EDGE_LEFT},
-   {CP_FACE_X_POS, CP_EDGE_RIGHT},
-   {CP_FACE_X_POS, CP_EDGE_TOP},
-   {CP_FACE_X_POS, CP_EDGE_BOTTOM},
-
-   {CP_FACE_X_NEG, CP_EDGE_LEFT},
-   {CP_FACE_X_NEG, CP_EDGE_RIGHT},
-   {CP_FACE_X_NEG, CP_EDGE_TOP},
-   {CP_FACE_X_NEG, CP_EDGE_BOTTOM},
-
-   {CP_FACE_Z_POS, CP_EDGE_TOP},
-   {CP_FACE_Z_POS, CP_EDGE_BOTTOM},
-   {CP_FACE_Z_NEG, CP_EDGE_TOP},
-   {CP_FACE_Z_NEG, CP_EDGE_BOTTOM}
-};
-
-int32_t sg_CubeCornerList[6][4] = {
-   { CP_CORNER_PPP, CP_CORNER_PPN, CP_CORNER_PNP, CP_CORNER_PNN }, // XPOS face
-   { CP_CORNER_NPN, CP_CORNER_NPP, CP_CORNER_NNN, CP_CORNER_NNP }, // XNEG face
-   { CP_CORNER_NPN, CP_CORNER_PPN, CP_CORNER_NPP, CP_CORNER_PPP }, // YPOS face
-   { CP_CORNER_NNP, CP_CORNER_PNP, CP_CORNER_NNN, CP_CORNER_PNN }, // YNEG face
-   { CP_CORNER_NPP, CP_CORNER_PPP, CP_CORNER_NNP, CP_CORNER_PNP }, // ZPOS face
-   { CP_CORNER_PPN, CP_CORNER_NPN, CP_CORNER_PNN, CP_CORNER_NNN }  // ZNEG face
-};
-
-
-   Ctr::PixelBox face0 = cubemap->getPixelBox(0, mipId);
-   int32_t nChannels = (int32_t)(face0.getNumChannels());
-   uint32_t size = (uint32_t)(face0.size().x);
-
-   T* edgeStartPtr = nullptr;
-   T* neighborEdgeStartPtr = nullptr;
-
-   //number of texels inward towards cubeface center to apply fixup to
-   int32_t fixupDist = 0;
-
-   // note that if functionality to filter across the three texels for each corner, then 
-   T * cornerPtr[8][3];      //indexed by corner and face idx
-   T * faceCornerPtrs[4];    //corner pointers for face
-   int32_t cornerNumPtrs[8];         //indexed by corner and face idx
-
-   //if there is no fixup, or fixup width = 0, do nothing
-   if((fixupType == CP_FIXUP_NONE) ||
-      (fixupWidth == 0)  )
-   {
-      return;
-   }
-
-   //special case 1x1 cubemap, average face colors
-   if (size == 1)
-   {
-      //iterate over channels
-       for (int32_t k = 0; k<nChannels; k++)
-      {
-         double  accum = 0.0f;
-         //iterate over faces to accumulate face colors
-         for (int32_t faceId = 0; faceId < 6; faceId++)
-         {
-            Ctr::PixelBox face = cubemap->getPixelBox(faceId, mipId);
-            T* ptr = (T*)(face.data);
-            accum += ptr[k];
-         }
-
-         //compute average over 6 face colors
-         accum /= 6.0;
-
-         //iterate over faces to distribute face colors
-         for (uint32_t faceId = 0; faceId < 6; faceId++)
-         {
-            Ctr::PixelBox face = cubemap->getPixelBox(faceId, mipId);
-            T* ptr = (T*)(face.data);
-            ptr[k] = (T)(accum);
-         }
-      }
-
-      return;
-   }
-
-   //iterate over corners
-   for (uint32_t iCorner = 0; iCorner < 8; iCorner++)
-   {
-      cornerNumPtrs[iCorner] = 0;
-   }
-
-   // Iterate over faces to collect list of corner texel pointers
-   for (uint32_t faceId = 0; faceId < 6; faceId++)
-   {
-      Ctr::PixelBox face = cubemap->getPixelBox(faceId, mipId);
-
-      // The 4 corner pointers for this face
-      T* ptr = (T*)(face.data);
-
-      faceCornerPtrs[0] = &ptr[0];
-      faceCornerPtrs[1] = &ptr[( (size - 1) * nChannels) ];
-      faceCornerPtrs[2] = &ptr[( (size) * (size - 1) * nChannels) ];
-      faceCornerPtrs[3] = &ptr[( (((size) * (size - 1)) + (size - 1)) * nChannels )];
-
-      // Iterate over face corners to collect cube corner pointers
-      for (int32_t i = 0; i < 4; i++)
-      {
-         int32_t corner = sg_CubeCornerList[faceId][i];
-         cornerPtr[corner][ cornerNumPtrs[corner] ] = faceCornerPtrs[i];
-         cornerNumPtrs[corner]++;
-      }
-   }
-
-   // iterate over corners to average across corner tap values
-   for (int32_t cornerId = 0; cornerId < 8; cornerId++)
-   {
-      for (int32_t k = 0; k < nChannels; k++)
-      {             
-         double cornerTapAccum = 0.0;
-
-         // iterate over corner texels and average results
-         for(int32_t i = 0; i < 3; i++ )
-         {
-            cornerTapAccum += *(cornerPtr[cornerId][i] + k);
-         }
-
-         // divide by 3 to compute average of corner tap values
-         cornerTapAccum *= (1.0 / 3.0);
-
-         // iterate over corner texels and average results
-         for(int32_t i = 0; i < 3; i++)
-         {
-            *(cornerPtr[cornerId][i] + k) = (T)(cornerTapAccum);
-         }
-      }
-   }   
-
-
-   //maximum width of fixup region is one half of the cube face size
-   fixupDist = (int32_t)Ctr::minValue( (float)(fixupWidth), (float)(size / 2.0f));
-
-   //iterate over the twelve edges of the cube to average across edges
-   for(int32_t i = 0; i < 12; i++)
-   {
-      int32_t face = sg_CubeEdgeList[i][0];
-      int32_t edge = sg_CubeEdgeList[i][1];
-
-      const CPCubeMapNeighbor& neighborInfo = sg_CubeNgh[face][edge];
-      int32_t neighborFace = neighborInfo.m_Face;
-      int32_t neighborEdge = neighborInfo.m_Edge;
-
-      Ctr::PixelBox faceBox = cubemap->getPixelBox(face, mipId);
-      Ctr::PixelBox neighborBox = cubemap->getPixelBox(neighborFace, mipId);
-
-      edgeStartPtr = (T*)faceBox.data;
-      neighborEdgeStartPtr = (T*)neighborBox.data;
-
-      int32_t edgeWalk = 0;
-      int32_t neighborEdgeWalk = 0;
-
-      //amount to pointer to sample taps away from cube face
-      int32_t edgePerpWalk = 0;
-      int32_t neighborEdgePerpWalk = 0;
-
-      //Determine walking pointers based on edge type
-      // e.g. CP_EDGE_LEFT, CP_EDGE_RIGHT, CP_EDGE_TOP, CP_EDGE_BOTTOM
-      switch(edge)
-      {
-         case CP_EDGE_LEFT:
-            // no change to faceEdgeStartPtr  
-            edgeWalk = nChannels * size;
-            edgePerpWalk = nChannels;
-         break;
-         case CP_EDGE_RIGHT:
-            edgeStartPtr += (size - 1) * nChannels;
-            edgeWalk = nChannels * size;
-            edgePerpWalk = -nChannels;
-         break;
-         case CP_EDGE_TOP:
-            // no change to faceEdgeStartPtr  
-            edgeWalk = nChannels;
-            edgePerpWalk = nChannels * size;
-         break;
-         case CP_EDGE_BOTTOM:
-            edgeStartPtr += (size) * (size - 1) * nChannels;
-            edgeWalk = nChannels;
-            edgePerpWalk = -(int32_t)(nChannels * size);
-         break;
-      }
-
-      //For certain types of edge abutments, the neighbor edge walk needs to 
-      //  be flipped: the cases are 
-      // if a left   edge mates with a left or bottom  edge on the neighbor
-      // if a top    edge mates with a top or right edge on the neighbor
-      // if a right  edge mates with a right or top edge on the neighbor
-      // if a bottom edge mates with a bottom or left  edge on the neighbor
-      //Seeing as the edges are enumerated as follows 
-      // left   =0 
-      // right  =1 
-      // top    =2 
-      // bottom =3            
-      // 
-      //If the edge enums are the same, or the sum of the enums == 3, 
-      //  the neighbor edge walk needs to be flipped
-      if( (edge == neighborEdge) || ((edge + neighborEdge) == 3) )
-      {   //swapped direction neighbor edge walk
-         switch(neighborEdge)
-         {
-            case CP_EDGE_LEFT:  //start at lower left and walk up
-               neighborEdgeStartPtr += (size - 1) * (size) *  nChannels;
-               neighborEdgeWalk = -(int32_t)(nChannels * size);
-               neighborEdgePerpWalk = nChannels;
-            break;
-            case CP_EDGE_RIGHT: //start at lower right and walk up
-               neighborEdgeStartPtr += ((size - 1)*(size) + (size - 1)) * nChannels;
-               neighborEdgeWalk = -(int32_t)(nChannels * size);
-               neighborEdgePerpWalk = -nChannels;
-            break;
-            case CP_EDGE_TOP:   //start at upper right and walk left
-               neighborEdgeStartPtr += (size - 1) * nChannels;
-               neighborEdgeWalk = -nChannels;
-               neighborEdgePerpWalk = (nChannels * size);
-            break;
-            case CP_EDGE_BOTTOM: //start at lower right and walk left
-               neighborEdgeStartPtr += ((size - 1)*(size) + (size - 1)) * nChannels;
-               neighborEdgeWalk = -nChannels;
-               neighborEdgePerpWalk = -(int32_t)(nChannels * size);
-            break;
-         }            
-      }
-      else
-      { //swapped direction neighbor edge walk
-         switch (neighborEdge)
-         {
-            case CP_EDGE_LEFT: //start at upper left and walk down
-               //no change to neighborEdgeStartPtr for this case since it points 
-               // to the upper left corner already
-               neighborEdgeWalk = nChannels * size;
-               neighborEdgePerpWalk = nChannels;
+//---------------------------------------------------
+// Pointer walks (in elements) along an edge and its neighbor edge
+// for a face of size x size texels with nChannels channels.
+//---------------------------------------------------
+struct CPCubeEdgeWalk
+{
+    int32_t start;
+    int32_t walk;
+    int32_t perpWalk;
+    int32_t neighborStart;
+    int32_t neighborWalk;
+    int32_t neighborPerpWalk;
+
+    CPCubeEdgeWalk(int32_t edge, int32_t neighborEdge, int32_t size, int32_t nChannels)
+    {
+        start = 0;
+        neighborStart = 0;
+
+        //Determine walking pointers based on edge type
+        // e.g. CP_EDGE_LEFT, CP_EDGE_RIGHT, CP_EDGE_TOP, CP_EDGE_BOTTOM
+        switch(edge)
+        {
+            case CP_EDGE_LEFT:
+                walk = nChannels * size;
+                perpWalk = nChannels;
             break;
-            case CP_EDGE_RIGHT: //start at upper right and walk down
-               neighborEdgeStartPtr += (size - 1) * nChannels;
-               neighborEdgeWalk = nChannels * size;
-               neighborEdgePerpWalk = -nChannels;
+            case CP_EDGE_RIGHT:
+                start = (size - 1) * nChannels;
+                walk = nChannels * size;
+                perpWalk = -nChannels;
             break;
-            case CP_EDGE_TOP:   //start at upper left and walk left
-               //no change to neighborEdgeStartPtr for this case since it points 
-               // to the upper left corner already
-               neighborEdgeWalk = nChannels;
-               neighborEdgePerpWalk = (nChannels * size);
+            case CP_EDGE_TOP:
+                walk = nChannels;
+                perpWalk = nChannels * size;
             break;
-            case CP_EDGE_BOTTOM: //start at lower left and walk left
-               neighborEdgeStartPtr += (size) * (size - 1) * nChannels;
-               neighborEdgeWalk = nChannels;
-               neighborEdgePerpWalk = -(int32_t)(nChannels * size);
+            default:
+            case CP_EDGE_BOTTOM:
+                start = (size) * (size - 1) * nChannels;
+                walk = nChannels;
+                perpWalk = -(nChannels * size);
             break;
-         }
-      }
-
-
-      //Perform edge walk, to average across the 12 edges and smoothly propagate change to 
-      //nearby neighborhood
-
-      //step ahead one texel on edge
-      edgeStartPtr += edgeWalk;
-      neighborEdgeStartPtr += neighborEdgeWalk;
-
-      // note that this loop does not process the corner texels, since they have already been
-      //  averaged across faces across earlier
-      for(int32_t j=1; j< (int32_t)(size - 1); j++)       
-      {             
-         //for each set of taps along edge, average them
-         // and rewrite the results into the edges
-         for(int32_t k = 0; k<nChannels; k++)
-         {             
-            double edgeTap, neighborEdgeTap, avgTap;  //edge tap, neighborEdgeTap and the average of the two
-            double edgeTapDev, neighborEdgeTapDev;
+        }
+
+        //For certain types of edge abutments, the neighbor edge walk needs to 
+        //  be flipped: the cases are 
+        // if a left   edge mates with a left or bottom  edge on the neighbor
+        // if a top    edge mates with a top or right edge on the neighbor
+        // if a right  edge mates with a right or top edge on the neighbor
+        // if a bottom edge mates with a bottom or left  edge on the neighbor
+        //If the edge enums are the same, or the sum of the enums == 3, 
+        //  the neighbor edge walk needs to be flipped
+        if( (edge == neighborEdge) || ((edge + neighborEdge) == 3) )
+        {
+            switch(neighborEdge)
+            {
+                case CP_EDGE_LEFT:  //start at lower left and walk up
+                    neighborStart = (size - 1) * (size) *  nChannels;
+                    neighborWalk = -(nChannels * size);
+                    neighborPerpWalk = nChannels;
+                break;
+                case CP_EDGE_RIGHT: //start at lower right and walk up
+                    neighborStart = ((size - 1)*(size) + (size - 1)) * nChannels;
+                    neighborWalk = -(nChannels * size);
+                    neighborPerpWalk = -nChannels;
+                break;
+                case CP_EDGE_TOP:   //start at upper right and walk left
+                    neighborStart = (size - 1) * nChannels;
+                    neighborWalk = -nChannels;
+                    neighborPerpWalk = (nChannels * size);
+                break;
+                default:
+                case CP_EDGE_BOTTOM: //start at lower right and walk left
+                    neighborStart = ((size - 1)*(size) + (size - 1)) * nChannels;
+                    neighborWalk = -nChannels;
+                    neighborPerpWalk = -(nChannels * size);
+                break;
+            }            
+        }
+        else
+        {
+            switch (neighborEdge)
+            {
+                case CP_EDGE_LEFT: //start at upper left and walk down
+                    neighborWalk = nChannels * size;
+                    neighborPerpWalk = nChannels;
+                break;
+                case CP_EDGE_RIGHT: //start at upper right and walk down
+                    neighborStart = (size - 1) * nChannels;
+                    neighborWalk = nChannels * size;
+                    neighborPerpWalk = -nChannels;
+                break;
+                case CP_EDGE_TOP:   //start at upper left and walk left
+                    neighborWalk = nChannels;
+                    neighborPerpWalk = (nChannels * size);
+                break;
+                default:
+                case CP_EDGE_BOTTOM: //start at lower left and walk left
+                    neighborStart = (size) * (size - 1) * nChannels;
+                    neighborWalk = nChannels;
+                    neighborPerpWalk = -(nChannels * size);
+                break;
+            }
+        }
+    }
+};
 
-            edgeTap = *(edgeStartPtr + k);
-            neighborEdgeTap = *(neighborEdgeStartPtr + k);
+//---------------------------------------------------
+// Fixup weight for taps perpendicular to an edge.
+//---------------------------------------------------
+inline double
+cubeFixupWeight(CubemapFixupType fixupType, int32_t iFixup, int32_t fixupDist)
+{
+    //fractional amount to apply change in tap intensity along edge to taps 
+    //  in a perpendicular direction to edge 
+    double fixupFrac = (double)(fixupDist - iFixup) / (double)(fixupDist); 
+    switch (fixupType)
+    {
+        case CP_FIXUP_PULL_HERMITE:
+        case CP_FIXUP_AVERAGE_HERMITE:
+            //hermite spline interpolation between 1 and 0 with both pts derivatives = 0 
+            // e.g. smooth step
+            // the full formula for hermite interpolation is:
+            //              
+            //                  [  2  -2   1   1 ][ p0 ] 
+            // [t^3  t^2  t  1 ][ -3   3  -2  -1 ][ p1 ]
+            //                  [  0   0   1   0 ][ d0 ]
+            //                  [  1   0   0   0 ][ d1 ]
+            // 
+            // Where p0 and p1 are the point locations and d0, and d1 are their respective derivatives
+            // t is the parameteric coordinate used to specify an interpoltion point on the spline
+            // and ranges from 0 to 1.
+            //  if p0 = 0 and p1 = 1, and d0 and d1 = 0, the interpolation reduces to
+            //
+            //  p(t) =  - 2t^3 + 3t^2
+            return ((-2.0 * fixupFrac + 3.0) * fixupFrac * fixupFrac);
+        default:
+            return fixupFrac;
+    }
+}
 
-            //compute average of tap intensity values
-            avgTap = 0.5f * (edgeTap + neighborEdgeTap);
+//---------------------------------------------------
+// Average one pair of edge taps and propagate the change
+// into the fixup region on both sides of the edge.
+// weights[iFixup] for iFixup in [1, fixupDist).
+//---------------------------------------------------
+template <typename T>
+inline void
+fixupEdgeTaps(T* edgePtr, 
+              T* neighborPtr, 
+              int32_t edgePerpWalk, 
+              int32_t neighborPerpWalk,
+              int32_t nChannels,
+              const double* weights,
+              int32_t fixupDist,
+              bool average)
+{
+    for (int32_t k = 0; k < nChannels; k++)
+    {
+        double edgeTap = (double)edgePtr[k];
+        double neighborEdgeTap = (double)neighborPtr[k];
+        double avgTap = 0.5 * (edgeTap + neighborEdgeTap);
+
+        edgePtr[k] = (T)(avgTap);
+        neighborPtr[k] = (T)(avgTap);
+
+        double edgeTapDev = edgeTap - avgTap;
+        double neighborEdgeTapDev = neighborEdgeTap - avgTap;
+
+        for (int32_t iFixup = 1; iFixup < fixupDist; iFixup++)
+        {
+            T* edgeTapPtr = edgePtr + (iFixup * edgePerpWalk) + k;
+            T* neighborTapPtr = neighborPtr + (iFixup * neighborPerpWalk) + k;
+            if (average)
+            {
+                //perform weighted average of edge tap value and current tap
+                edgeTapDev = (double)(*edgeTapPtr) - avgTap;
+                neighborEdgeTapDev = (double)(*neighborTapPtr) - avgTap;
+            }
+            // vary intensity of taps within fixup region toward edge values to hide changes made to edge taps
+            *edgeTapPtr -= (T)(weights[iFixup] * edgeTapDev);
+            *neighborTapPtr -= (T)(weights[iFixup] * neighborEdgeTapDev);
+        }
+    }
+}
 
-            //propagate average of taps to edge taps
-            (*(edgeStartPtr + k)) = (T)(avgTap);
-            (*(neighborEdgeStartPtr + k)) = (T)(avgTap);
+// RGBA float taps blend all channels in two double registers, rounding
+// at the same points as the scalar path.
+inline void
+fixupEdgeTaps(float* edgePtr, 
+              float* neighborPtr, 
+              int32_t edgePerpWalk, 
+              int32_t neighborPerpWalk,
+              int32_t nChannels,
+              const double* weights,
+              int32_t fixupDist,
+              bool average)
+{
+#if CTR_SSE
+    if (nChannels == 4)
+    {
+        __m128 edgeTapValue = _mm_loadu_ps(edgePtr);
+        __m128 neighborTapValue = _mm_loadu_ps(neighborPtr);
+        __m128d edgeTap[2] = { _mm_cvtps_pd(edgeTapValue), _mm_cvtps_pd(_mm_movehl_ps(edgeTapValue, edgeTapValue)) };
+        __m128d neighborEdgeTap[2] = { _mm_cvtps_pd(neighborTapValue), _mm_cvtps_pd(_mm_movehl_ps(neighborTapValue, neighborTapValue)) };
+        __m128d avgTap[2];
+        __m128d edgeTapDev[2];
+        __m128d neighborEdgeTapDev[2];
+        for (int32_t half = 0; half < 2; half++)
+        {
+            avgTap[half] = _mm_mul_pd(_mm_add_pd(edgeTap[half], neighborEdgeTap[half]), _mm_set1_pd(0.5));
+            edgeTapDev[half] = _mm_sub_pd(edgeTap[half], avgTap[half]);
+            neighborEdgeTapDev[half] = _mm_sub_pd(neighborEdgeTap[half], avgTap[half]);
+        }
+
+        __m128 avgTapValue = _mm_movelh_ps(_mm_cvtpd_ps(avgTap[0]), _mm_cvtpd_ps(avgTap[1]));
+        _mm_storeu_ps(edgePtr, avgTapValue);
+        _mm_storeu_ps(neighborPtr, avgTapValue);
+
+        for (int32_t iFixup = 1; iFixup < fixupDist; iFixup++)
+        {
+            float* edgeTapPtr = edgePtr + (iFixup * edgePerpWalk);
+            float* neighborTapPtr = neighborPtr + (iFixup * neighborPerpWalk);
+            edgeTapValue = _mm_loadu_ps(edgeTapPtr);
+            neighborTapValue = _mm_loadu_ps(neighborTapPtr);
+            if (average)
+            {
+                edgeTapDev[0] = _mm_sub_pd(_mm_cvtps_pd(edgeTapValue), avgTap[0]);
+                edgeTapDev[1] = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(edgeTapValue, edgeTapValue)), avgTap[1]);
+                neighborEdgeTapDev[0] = _mm_sub_pd(_mm_cvtps_pd(neighborTapValue), avgTap[0]);
+                neighborEdgeTapDev[1] = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(neighborTapValue, neighborTapValue)), avgTap[1]);
+            }
+            __m128d weight = _mm_set1_pd(weights[iFixup]);
+            __m128 edgeTapChange = _mm_movelh_ps(_mm_cvtpd_ps(_mm_mul_pd(weight, edgeTapDev[0])), 
+                                                 _mm_cvtpd_ps(_mm_mul_pd(weight, edgeTapDev[1])));
+            __m128 neighborTapChange = _mm_movelh_ps(_mm_cvtpd_ps(_mm_mul_pd(weight, neighborEdgeTapDev[0])), 
+                                                     _mm_cvtpd_ps(_mm_mul_pd(weight, neighborEdgeTapDev[1])));
+            _mm_storeu_ps(edgeTapPtr, _mm_sub_ps(edgeTapValue, edgeTapChange));
+            _mm_storeu_ps(neighborTapPtr, _mm_sub_ps(neighborTapValue, neighborTapChange));
+        }
+        return;
+    }
+#endif
+    fixupEdgeTaps<float>(edgePtr, neighborPtr, edgePerpWalk, neighborPerpWalk, 
+                         nChannels, weights, fixupDist, average);
+}
 
-            edgeTapDev = edgeTap - avgTap;
-            neighborEdgeTapDev = neighborEdgeTap - avgTap;
+//---------------------------------------------------
+// Stretch a face so that its border texel centers sit on the cube edges.
+// Texel x samples the source at x * size / (size - 1) - 0.5.
+//---------------------------------------------------
+template <typename T>
+void
+stretchCubeFace(T* data, int32_t size, int32_t nChannels)
+{
+    if (size < 2)
+        return;
+
+    std::vector<float> source(data, data + size * size * nChannels);
+    float scale = (float)size / (float)(size - 1);
+
+    for (int32_t y = 0; y < size; y++)
+    {
+        float py = Ctr::clamped(y * scale - 0.5f, 0.0f, (float)(size - 1));
+        int32_t y0 = (int32_t)py;
+        int32_t y1 = Ctr::minValue(y0 + 1, size - 1);
+        float fy = py - y0;
+
+        for (int32_t x = 0; x < size; x++)
+        {
+            float px = Ctr::clamped(x * scale - 0.5f, 0.0f, (float)(size - 1));
+            int32_t x0 = (int32_t)px;
+            int32_t x1 = Ctr::minValue(x0 + 1, size - 1);
+            float fx = px - x0;
+
+            const float* t00 = &source[(y0 * size + x0) * nChannels];
+            const float* t10 = &source[(y0 * size + x1) * nChannels];
+            const float* t01 = &source[(y1 * size + x0) * nChannels];
+            const float* t11 = &source[(y1 * size + x1) * nChannels];
+            T* dst = data + (y * size + x) * nChannels;
+            for (int32_t k = 0; k < nChannels; k++)
+            {
+                float top = t00[k] + (t10[k] - t00[k]) * fx;
+                float bottom = t01[k] + (t11[k] - t01[k]) * fx;
+                dst[k] = (T)(top + (bottom - top) * fy);
+            }
+        }
+    }
+}
 
-            //iterate over taps in direction perpendicular to edge, and 
-            //  adjust intensity values gradualy to obscure change in intensity values of 
-            //  edge averaging.
-            for(int32_t iFixup = 1; iFixup < fixupDist; iFixup++)
+//---------------------------------------------------
+// Source: AMDCubemapGen.
+// Fixup cube edges of a single mip.
+// average texels on cube map faces across the edges.
+// parallelEdges processes each round of 3 independent edges concurrently.
+//---------------------------------------------------
+template <typename T>
+void
+fixupCubeMip (const Ctr::TextureImagePtr& cubemap, 
+              int32_t mipId, 
+              CubemapFixupType fixupType, 
+              float fixupWidth,
+              bool parallelEdges)
+{
+    //if there is no fixup, or fixup width = 0, do nothing
+    if((fixupType == CP_FIXUP_NONE) ||
+       (fixupWidth == 0 && fixupType != CP_FIXUP_STRETCH))
+    {
+        return;
+    }
+
+    T* faceData[6];
+    for (int32_t faceId = 0; faceId < 6; faceId++)
+    {
+        faceData[faceId] = (T*)(cubemap->getPixelBox(faceId, mipId).data);
+    }
+
+    Ctr::PixelBox face0 = cubemap->getPixelBox(0, mipId);
+    int32_t nChannels = (int32_t)(face0.getNumChannels());
+    int32_t size = (int32_t)(face0.size().x);
+
+    //special case 1x1 cubemap, average face colors
+    if (size == 1)
+    {
+        for (int32_t k = 0; k < nChannels; k++)
+        {
+            double accum = 0.0;
+            for (int32_t faceId = 0; faceId < 6; faceId++)
+            {
+                accum += faceData[faceId][k];
+            }
+            accum /= 6.0;
+            for (int32_t faceId = 0; faceId < 6; faceId++)
+            {
+                faceData[faceId][k] = (T)(accum);
+            }
+        }
+        return;
+    }
+
+    if (fixupType == CP_FIXUP_STRETCH)
+    {
+        for (int32_t faceId = 0; faceId < 6; faceId++)
+        {
+            stretchCubeFace<T>(faceData[faceId], size, nChannels);
+        }
+        // The border texels now represent the same directions, only they need averaging.
+        fixupWidth = 1.0f;
+    }
+
+    // Collect the 3 texels sharing each cube corner and average them.
+    T* cornerPtr[8][3];
+    int32_t cornerNumPtrs[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    for (int32_t faceId = 0; faceId < 6; faceId++)
+    {
+        T* ptr = faceData[faceId];
+        T* faceCornerPtrs[4] = 
+        { 
+            &ptr[0],
+            &ptr[(size - 1) * nChannels],
+            &ptr[(size * (size - 1)) * nChannels],
+            &ptr[((size * (size - 1)) + (size - 1)) * nChannels]
+        };
+
+        for (int32_t i = 0; i < 4; i++)
+        {
+            int32_t corner = CPCubeMapTables::corner(faceId, i);
+            cornerPtr[corner][cornerNumPtrs[corner]++] = faceCornerPtrs[i];
+        }
+    }
+
+    for (int32_t cornerId = 0; cornerId < 8; cornerId++)
+    {
+        for (int32_t k = 0; k < nChannels; k++)
+        {             
+            double cornerTapAccum = 0.0;
+            for (int32_t i = 0; i < 3; i++)
+            {
+                cornerTapAccum += cornerPtr[cornerId][i][k];
+            }
+            cornerTapAccum *= (1.0 / 3.0);
+            for (int32_t i = 0; i < 3; i++)
             {
-               //fractional amount to apply change in tap intensity along edge to taps 
-               //  in a perpendicular direction to edge 
-               double fixupFrac = (double)(fixupDist - iFixup) / (double)(fixupDist); 
-               double fixupWeight;
-
-               switch (fixupType)
-               {
-                  case CP_FIXUP_PULL_LINEAR:
-                  {
-                     fixupWeight = fixupFrac;
-                  }
-                  break;
-
-                  case CP_FIXUP_PULL_HERMITE:
-                  {
-                     //hermite spline interpolation between 1 and 0 with both pts derivatives = 0 
-                     // e.g. smooth step
-                     // the full formula for hermite interpolation is:
-                     //              
-                     //                  [  2  -2   1   1 ][ p0 ] 
-                     // [t^3  t^2  t  1 ][ -3   3  -2  -1 ][ p1 ]
-                     //                  [  0   0   1   0 ][ d0 ]
-                     //                  [  1   0   0   0 ][ d1 ]
-                     // 
-                     // Where p0 and p1 are the point locations and d0, and d1 are their respective derivatives
-                     // t is the parameteric coordinate used to specify an interpoltion point on the spline
-                     // and ranges from 0 to 1.
-                     //  if p0 = 0 and p1 = 1, and d0 and d1 = 0, the interpolation reduces to
-                     //
-                     //  p(t) =  - 2t^3 + 3t^2
-                     fixupWeight = ((-2.0 * fixupFrac + 3.0) * fixupFrac * fixupFrac);
-                  }
-                  break;
-                  case CP_FIXUP_AVERAGE_LINEAR:
-                  {
-                     fixupWeight = fixupFrac;
-
-                     //perform weighted average of edge tap value and current tap
-                     // fade off weight linearly as a function of distance from edge
-                     edgeTapDev = 
-                        (*(edgeStartPtr + (iFixup * edgePerpWalk) + k)) - avgTap;
-                     neighborEdgeTapDev = 
-                        (*(neighborEdgeStartPtr + (iFixup * neighborEdgePerpWalk) + k)) - avgTap;
-                  }
-                  break;
-
-                  case CP_FIXUP_AVERAGE_HERMITE:
-                  {
-                     fixupWeight = ((-2.0 * fixupFrac + 3.0) * fixupFrac * fixupFrac);
-
-                     //perform weighted average of edge tap value and current tap
-                     // fade off weight using hermite spline with distance from edge
-                     //  as parametric coordinate
-                     edgeTapDev = 
-                        (*(edgeStartPtr + (iFixup * edgePerpWalk) + k)) - avgTap;
-                     neighborEdgeTapDev = 
-                        (*(neighborEdgeStartPtr + (iFixup * neighborEdgePerpWalk) + k)) - avgTap;
-                  }
-                  break;
-               }
-
-               // vary intensity of taps within fixup region toward edge values to hide changes made to edge taps
-               *(edgeStartPtr + (iFixup * edgePerpWalk) + k) -= (T)(fixupWeight * edgeTapDev);
-               *(neighborEdgeStartPtr + (iFixup * neighborEdgePerpWalk) + k) -= (T)(fixupWeight * neighborEdgeTapDev);
+                cornerPtr[cornerId][i][k] = (T)(cornerTapAccum);
             }
-         }
+        }
+    }   
+
+    //maximum width of fixup region is one half of the cube face size
+    int32_t fixupDist = (int32_t)Ctr::minValue(fixupWidth, size / 2.0f);
+
+    std::vector<double> weights(Ctr::maxValue(fixupDist, 1));
+    for (int32_t iFixup = 1; iFixup < fixupDist; iFixup++)
+    {
+        weights[iFixup] = cubeFixupWeight(fixupType, iFixup, fixupDist);
+    }
+
+    bool average = fixupType == CP_FIXUP_AVERAGE_LINEAR || fixupType == CP_FIXUP_AVERAGE_HERMITE;
+
+    auto fixupEdge = [&](int32_t edgeId)
+    {
+        const int32_t* edgeInfo = CPCubeMapTables::edge(edgeId);
+        int32_t face = edgeInfo[0];
+        int32_t edge = edgeInfo[1];
+        const CPCubeMapNeighbor& neighborInfo = CPCubeMapTables::neighbor(face, edge);
+        CPCubeEdgeWalk walk(edge, neighborInfo.m_Edge, size, nChannels);
+
+        //step ahead one texel on edge, corners have already been averaged.
+        T* edgePtr = faceData[face] + walk.start + walk.walk;
+        T* neighborPtr = faceData[neighborInfo.m_Face] + walk.neighborStart + walk.neighborWalk;
+
+        for (int32_t j = 1; j < size - 1; j++)
+        {
+            fixupEdgeTaps(edgePtr, neighborPtr, walk.perpWalk, walk.neighborPerpWalk,
+                          nChannels, &weights[0], fixupDist, average);
+            edgePtr += walk.walk;
+            neighborPtr += walk.neighborWalk;
+        }
+    };
+
+    if (parallelEdges)
+    {
+        for (int32_t roundId = 0; roundId < 4; roundId++)
+        {
+            const int32_t* edges = CPCubeMapTables::edgeRound(roundId);
+            Ctr::parallelFor(int32_t(0), int32_t(3), [&](int32_t i)
+            {
+                fixupEdge(edges[i]);
+            });
+        }
+    }
+    else
+    {
+        //iterate over the twelve edges of the cube to average across edges
+        for (int32_t edgeId = 0; edgeId < 12; edgeId++)
+        {
+            fixupEdge(edgeId);
+        }
+    }
+}
+
+//---------------------------------------------------
+// Source: AMDCubemapGen.
+// Fixup cube edges
+// average texels on cube map faces across the edges.
+//---------------------------------------------------
+template <typename T>
+void
+fixupCubeEdges (Ctr::TextureImagePtr cubemap, 
+                int32_t mipId, 
+                CubemapFixupType fixupType, 
+                float fixupWidth)
+{
+    fixupCubeMip<T>(cubemap, mipId, fixupType, fixupWidth, false);
+}
 
-         edgeStartPtr += edgeWalk;
-         neighborEdgeStartPtr += neighborEdgeWalk;
-      }        
-   }
+//---------------------------------------------------
+// Fixup cube edges for every mip of the cube map in one call.
+// Mips are processed concurrently, and the edges of each mip 
+// in rounds of 3. The fixup width of each mip is 
+// max(mipSize * fixupWidthScale, minFixupWidth) texels.
+// Near the corners the averaging modes touch texels from two edges,
+// so the round order there differs slightly from fixupCubeEdges.
+//---------------------------------------------------
+template <typename T>
+void
+fixupCubeEdgesAllMips (Ctr::TextureImagePtr cubemap, 
+                       CubemapFixupType fixupType, 
+                       float fixupWidthScale,
+                       float minFixupWidth = 1.0f)
+{
+    int32_t numMips = Ctr::maxValue((int32_t)cubemap->getNumMipmaps(), 1);
+    Ctr::parallelFor(int32_t(0), numMips, [&](int32_t mipId)
+    {
+        float mipSize = (float)cubemap->getPixelBox(0, mipId).size().x;
+        fixupCubeMip<T>(cubemap, 
+                        mipId, 
+                        fixupType, 
+                        Ctr::maxValue(mipSize * fixupWidthScale, minFixupWidth),
+                        true);
+    });
 }
 }
 
-#endif
\ No newline at end of file
+#endif
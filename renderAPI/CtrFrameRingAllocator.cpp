@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrFrameRingAllocator.h>
+#include <CtrLog.h>
+
+namespace Ctr
+{
+namespace
+{
+size_t
+alignUp (uintptr_t address, size_t alignment)
+{
+    return size_t((address + alignment - 1) & ~uintptr_t(alignment - 1));
+}
+}
+
+FrameRingAllocator::FrameRingAllocator (size_t capacity, uint32_t framesInFlight) :
+    _memory (capacity),
+    _head (0),
+    _used (0),
+    _framesInFlight (std::max (framesInFlight, 1u)),
+    _frameSize (0)
+{
+    memset (&_frameStats, 0, sizeof(Stats));
+    memset (&_lastFrameStats, 0, sizeof(Stats));
+}
+
+FrameRingAllocator::~FrameRingAllocator()
+{
+}
+
+void*
+FrameRingAllocator::allocate (size_t size, size_t alignment)
+{
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        LOG_WARNING ("FrameRingAllocator alignment " << alignment << " is not a power of two");
+        return nullptr;
+    }
+
+    uintptr_t base = (uintptr_t)_memory.data();
+    size_t start = alignUp (base + _head, alignment) - base;
+    size_t taken = start - _head + size;
+
+    // Allocations are contiguous, so the tail of the ring is skipped when it is too short.
+    if (start + size > _memory.size())
+    {
+        start = alignUp (base, alignment) - base;
+        taken = _memory.size() - _head + start + size;
+    }
+
+    if (size == 0 || _used + taken > _memory.size())
+    {
+        _frameStats.failedAllocations++;
+        return nullptr;
+    }
+
+    _head = start + size;
+    _used += taken;
+    _frameSize += taken;
+
+    _frameStats.allocations++;
+    _frameStats.allocatedBytes += uint32_t(size);
+    return &_memory[start];
+}
+
+void
+FrameRingAllocator::beginFrame()
+{
+    _frameSizes.push_back (_frameSize);
+    _frameSize = 0;
+
+    while (_frameSizes.size() >= _framesInFlight)
+    {
+        _used -= _frameSizes.front();
+        _frameSizes.pop_front();
+    }
+
+    _frameStats.usedBytes = uint32_t(_used);
+    _lastFrameStats = _frameStats;
+    memset (&_frameStats, 0, sizeof(Stats));
+}
+
+size_t
+FrameRingAllocator::capacity() const
+{
+    return _memory.size();
+}
+
+size_t
+FrameRingAllocator::used() const
+{
+    return _used;
+}
+
+uint32_t
+FrameRingAllocator::framesInFlight() const
+{
+    return _framesInFlight;
+}
+
+const FrameRingAllocator::Stats&
+FrameRingAllocator::stats() const
+{
+    return _lastFrameStats;
+}
+
+}
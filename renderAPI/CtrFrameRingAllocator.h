@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_FRAME_RING_ALLOCATOR
+#define INCLUDED_CRT_FRAME_RING_ALLOCATOR
+
+#include <CtrPlatform.h>
+
+namespace Ctr
+{
+//------------------------------------------------------------------
+// Ring of host memory for transient per draw data, such as the
+// instance matrices staged by MeshInstancer. Allocations are never
+// freed individually; everything allocated in a frame is retired
+// together once framesInFlight further frames have begun. Not
+// thread safe, threads recording in parallel take separate rings
+// or allocate up front.
+//------------------------------------------------------------------
+class FrameRingAllocator
+{
+  public:
+    // Counters for the last completed frame.
+    struct Stats
+    {
+        uint32_t               allocations;
+        uint32_t               allocatedBytes;
+        uint32_t               failedAllocations;
+        // Bytes live across all frames in flight.
+        uint32_t               usedBytes;
+    };
+
+    FrameRingAllocator (size_t capacity = 1 << 20, uint32_t framesInFlight = 3);
+    ~FrameRingAllocator();
+
+    //-------------------------------------------------------------
+    // Returns nullptr if the frames in flight have filled the ring.
+    //-------------------------------------------------------------
+    void*                      allocate (size_t size, size_t alignment = 16);
+
+    //-------------------------------------------------------------
+    // Retires the oldest frame once framesInFlight are live.
+    //-------------------------------------------------------------
+    void                       beginFrame();
+
+    size_t                     capacity() const;
+    size_t                     used() const;
+    uint32_t                   framesInFlight() const;
+    const Stats&               stats() const;
+
+  private:
+    std::vector<uint8_t>       _memory;
+    size_t                     _head;
+    size_t                     _used;
+    uint32_t                   _framesInFlight;
+    // Bytes, padding included, taken by each frame still live.
+    std::list<size_t>          _frameSizes;
+    size_t                     _frameSize;
+    Stats                      _frameStats;
+    Stats                      _lastFrameStats;
+};
+
+}
+
+#endif
@@ -40,17 +40,212 @@
 //------------------------------------------------------------------------------------//
 
 #include <CtrGpuConstantBuffer.h>
+#include <CtrIGpuBuffer.h>
+#include <CtrIDevice.h>
+#include <CtrICommandList.h>
 
 namespace Ctr
 {
+GpuConstantBuffer::Stats GpuConstantBuffer::_frameStats = { 0, 0, 0, 0, 0 };
+GpuConstantBuffer::Stats GpuConstantBuffer::_lastFrameStats = { 0, 0, 0, 0, 0 };
 
-GpuConstantBuffer::GpuConstantBuffer (Ctr::IDevice* device) : IRenderResource (device)
+GpuConstantBuffer::GpuConstantBuffer (Ctr::IDevice* device) : IRenderResource (device),
+    _dirtyBegin (0),
+    _dirtyEnd (0),
+    _shadowBuffer (nullptr)
 {
     _valueIndex = 0;
 }
 
 GpuConstantBuffer::~GpuConstantBuffer()
 {
+    safedelete (_shadowBuffer);
 }
 
-}
\ No newline at end of file
+void
+GpuConstantBuffer::initializeShadow (uint32_t size)
+{
+    safedelete (_shadowBuffer);
+
+    // Constant buffers are sized in whole registers.
+    _shadow.assign ((size + 15) & ~15, 0);
+    _dirtyBegin = 0;
+    _dirtyEnd = uint32_t(_shadow.size());
+}
+
+bool
+GpuConstantBuffer::shadowed() const
+{
+    return !_shadow.empty();
+}
+
+const std::vector<uint8_t>&
+GpuConstantBuffer::shadow() const
+{
+    return _shadow;
+}
+
+void
+GpuConstantBuffer::write (uint32_t offset, const void* data, uint32_t size) const
+{
+    if (ICommandList* commandList = ICommandList::recording())
+    {
+        if (ICommandList::ConstantBufferShadow* shadow = commandList->constantBufferShadow (this))
+        {
+            writeShadow (shadow->data, shadow->dirtyBegin, shadow->dirtyEnd, 
+                         commandList->constantBufferStats(), offset, data, size);
+        }
+        return;
+    }
+    writeShadow (_shadow, _dirtyBegin, _dirtyEnd, _frameStats, offset, data, size);
+}
+
+void
+GpuConstantBuffer::writeShadow (std::vector<uint8_t>& shadow,
+                                uint32_t& dirtyBegin,
+                                uint32_t& dirtyEnd,
+                                Stats& stats,
+                                uint32_t offset, const void* data, uint32_t size)
+{
+    if (offset >= shadow.size())
+        return;
+
+    size = std::min (size, uint32_t(shadow.size()) - offset);
+    stats.writes++;
+
+    uint8_t* target = &shadow[offset];
+    if (memcmp (target, data, size) == 0)
+    {
+        stats.redundantWrites++;
+        return;
+    }
+    memcpy (target, data, size);
+
+    if (dirtyEnd == dirtyBegin)
+    {
+        dirtyBegin = offset;
+        dirtyEnd = offset + size;
+    }
+    else
+    {
+        dirtyBegin = std::min (dirtyBegin, offset);
+        dirtyEnd = std::max (dirtyEnd, offset + size);
+    }
+}
+
+bool
+GpuConstantBuffer::dirty() const
+{
+    return _dirtyEnd > _dirtyBegin;
+}
+
+uint32_t
+GpuConstantBuffer::dirtyBegin() const
+{
+    return _dirtyBegin;
+}
+
+uint32_t
+GpuConstantBuffer::dirtyEnd() const
+{
+    return _dirtyEnd;
+}
+
+bool
+GpuConstantBuffer::commit() const
+{
+    if (ICommandList* commandList = ICommandList::recording())
+    {
+        ICommandList::ConstantBufferShadow* shadow = commandList->constantBufferShadow (this);
+        if (!shadow || shadow->dirtyEnd <= shadow->dirtyBegin)
+            return false;
+
+        if (!shadow->buffer)
+        {
+            // Creating and binding the buffer touches the effect.
+            std::lock_guard<std::mutex> lock (ICommandList::effectMutex());
+            shadow->buffer = shadowBuffer();
+        }
+        return shadow->buffer && upload (shadow->buffer, shadow->data, 
+                                         shadow->dirtyBegin, shadow->dirtyEnd,
+                                         commandList->constantBufferStats());
+    }
+
+    if (!dirty())
+        return false;
+
+    Ctr::IGpuBuffer* buffer = shadowBuffer();
+    return buffer && upload (buffer, _shadow, _dirtyBegin, _dirtyEnd, _frameStats);
+}
+
+Ctr::IGpuBuffer*
+GpuConstantBuffer::shadowBuffer() const
+{
+    if (!_shadowBuffer)
+    {
+        Ctr::GpuBufferParameters parameters =
+            Ctr::GpuBufferParameters::setupConstantBuffer (_shadow.size());
+        if (!(_shadowBuffer = _deviceInterface->createBufferResource (&parameters)))
+        {
+            LOG ("Failed to create shadow buffer for constant buffer " << name());
+            return nullptr;
+        }
+        bindShadowBuffer (_shadowBuffer);
+    }
+    return _shadowBuffer;
+}
+
+bool
+GpuConstantBuffer::upload (Ctr::IGpuBuffer* buffer,
+                           const std::vector<uint8_t>& shadow,
+                           uint32_t& dirtyBegin,
+                           uint32_t& dirtyEnd,
+                           Stats& stats) const
+{
+    // Write discard renames the whole buffer, so the whole shadow goes up
+    // even when only part of it is dirty.
+    if (void* data = buffer->lock())
+    {
+        memcpy (data, &shadow[0], shadow.size());
+        buffer->unlock();
+
+        stats.uploads++;
+        stats.uploadedBytes += uint32_t(shadow.size());
+        stats.dirtyBytes += dirtyEnd - dirtyBegin;
+        dirtyBegin = dirtyEnd = 0;
+        return true;
+    }
+    return false;
+}
+
+void
+GpuConstantBuffer::invalidateShadow() const
+{
+    _dirtyBegin = 0;
+    _dirtyEnd = uint32_t(_shadow.size());
+}
+
+const GpuConstantBuffer::Stats&
+GpuConstantBuffer::stats()
+{
+    return _lastFrameStats;
+}
+
+void
+GpuConstantBuffer::resetStats()
+{
+    _lastFrameStats = _frameStats;
+    memset (&_frameStats, 0, sizeof(Stats));
+}
+
+void
+GpuConstantBuffer::addStats (const Stats& stats)
+{
+    _frameStats.writes += stats.writes;
+    _frameStats.redundantWrites += stats.redundantWrites;
+    _frameStats.uploads += stats.uploads;
+    _frameStats.uploadedBytes += stats.uploadedBytes;
+    _frameStats.dirtyBytes += stats.dirtyBytes;
+}
+
+}
@@ -52,9 +52,28 @@ class ITexture;
 class GpuTechnique;
 class IGpuBuffer;
 
+//------------------------------------------------------------------
+// Constant buffers keep a host shadow of their contents. Variables
+// write into the shadow, which records the dirty byte range, and the
+// shader commits every dirty buffer with a single map just before it
+// is applied, so several variable updates cost one upload per draw.
+// While a command list records on the calling thread, write and
+// commit use the list's copy of the shadow instead.
+//------------------------------------------------------------------
 class GpuConstantBuffer : public IRenderResource
 {
   public:
+    // Upload counters for the last completed frame.
+    struct Stats
+    {
+        uint32_t               writes;
+        // Writes that matched the shadow and did not dirty it.
+        uint32_t               redundantWrites;
+        uint32_t               uploads;
+        uint32_t               uploadedBytes;
+        uint32_t               dirtyBytes;
+    };
+
     GpuConstantBuffer (Ctr::IDevice* device);
     virtual ~GpuConstantBuffer();
 
@@ -76,8 +95,64 @@ class GpuConstantBuffer : public IRenderResource
     virtual const std::string&    annotation (const std::string&) = 0;
     virtual void                  setConstantBuffer (const Ctr::IGpuBuffer* buffer) const = 0;
 
+    //-------------------------------------------------------------
+    // Sizes the shadow. Buffers without a shadow are left entirely
+    // to the backend.
+    //-------------------------------------------------------------
+    void                          initializeShadow (uint32_t size);
+    bool                          shadowed() const;
+    const std::vector<uint8_t>&   shadow() const;
+
+    void                          write (uint32_t offset, const void* data, uint32_t size) const;
+    bool                          dirty() const;
+    uint32_t                      dirtyBegin() const;
+    uint32_t                      dirtyEnd() const;
+
+    //-------------------------------------------------------------
+    // Uploads the shadow if it is dirty. Returns true if it mapped.
+    //-------------------------------------------------------------
+    bool                          commit() const;
+
+    //-------------------------------------------------------------
+    // Marks the whole shadow dirty, for when the buffer was last
+    // uploaded from somewhere else (an executed command list).
+    //-------------------------------------------------------------
+    void                          invalidateShadow() const;
+
+    static const Stats&           stats();
+    // Called once per frame by IDevice::update.
+    static void                   resetStats();
+    // Adds counters kept elsewhere (a command list) to this frame's.
+    static void                   addStats (const Stats& stats);
+
   protected:
+    //-------------------------------------------------------------
+    // Binds the buffer commit uploads into in place of the buffer
+    // the backend would otherwise manage.
+    //-------------------------------------------------------------
+    virtual void                  bindShadowBuffer (const Ctr::IGpuBuffer* buffer) const = 0;
+
+    Ctr::IGpuBuffer*              shadowBuffer() const;
+    bool                          upload (Ctr::IGpuBuffer* buffer,
+                                          const std::vector<uint8_t>& shadow,
+                                          uint32_t& dirtyBegin,
+                                          uint32_t& dirtyEnd,
+                                          Stats& stats) const;
+    static void                   writeShadow (std::vector<uint8_t>& shadow,
+                                               uint32_t& dirtyBegin,
+                                               uint32_t& dirtyEnd,
+                                               Stats& stats,
+                                               uint32_t offset, const void* data, uint32_t size);
+
     uint32_t                      _valueIndex;
+
+    mutable std::vector<uint8_t>  _shadow;
+    mutable uint32_t              _dirtyBegin;
+    mutable uint32_t              _dirtyEnd;
+    mutable Ctr::IGpuBuffer*      _shadowBuffer;
+
+    static Stats                  _frameStats;
+    static Stats                  _lastFrameStats;
 };
 
 }
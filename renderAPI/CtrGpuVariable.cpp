@@ -39,12 +39,16 @@
 //                                                                                    //
 //------------------------------------------------------------------------------------//
 #include <CtrGpuVariable.h>
+#include <CtrGpuConstantBuffer.h>
 
 namespace Ctr
 {
-GpuVariable::GpuVariable (Ctr::IDevice* device) : IRenderResource (device)
+GpuVariable::GpuVariable (Ctr::IDevice* device) : IRenderResource (device),
+    _constantBuffer (nullptr),
+    _bufferOffset (0)
 {
     _valueIndex = 0;
+    memset (&_bufferLayout, 0, sizeof(BufferLayout));
 }
 
 GpuVariable::~GpuVariable()
@@ -63,6 +67,148 @@ GpuVariable::device()
     return _deviceInterface;
 }
 
+void
+GpuVariable::attach (Ctr::GpuConstantBuffer* constantBuffer, 
+                     uint32_t offset,
+                     const BufferLayout& layout)
+{
+    _constantBuffer = constantBuffer;
+    _bufferOffset = offset;
+    _bufferLayout = layout;
+}
+
+Ctr::GpuConstantBuffer*
+GpuVariable::constantBuffer() const
+{
+    return _constantBuffer;
+}
+
+uint32_t
+GpuVariable::bufferOffset() const
+{
+    return _bufferOffset;
+}
+
+const GpuVariable::BufferLayout&
+GpuVariable::bufferLayout() const
+{
+    return _bufferLayout;
+}
+
+uint32_t
+GpuVariable::packMatrix (const float* source, float* target) const
+{
+    // Registers hold the columns of column_major matrices and the rows of row_major ones.
+    bool columnMajor = _bufferLayout.columnMajor;
+    uint32_t rows = std::min (std::max (_bufferLayout.rows, 1u), 4u);
+    uint32_t columns = std::min (std::max (_bufferLayout.columns, 1u), 4u);
+
+    memset (target, 0, sizeof(float) * 16);
+    for (uint32_t row = 0; row < rows; row++)
+    {
+        for (uint32_t column = 0; column < columns; column++)
+        {
+            if (columnMajor)
+                target[column * 4 + row] = source[row * 4 + column];
+            else
+                target[row * 4 + column] = source[row * 4 + column];
+        }
+    }
+
+    uint32_t registers = columnMajor ? columns : rows;
+    uint32_t lastRegister = columnMajor ? rows : columns;
+    return ((registers - 1) * 4 + lastRegister) * sizeof(float);
+}
+
+uint32_t
+GpuVariable::elementCount (uint32_t count) const
+{
+    return _bufferLayout.elements > 0 ? std::min (count, _bufferLayout.elements) : std::min (count, 1u);
+}
+
+bool
+GpuVariable::writeValue (const void* value, uint32_t size) const
+{
+    if (!_constantBuffer)
+        return false;
+
+    _constantBuffer->write (_bufferOffset, value, std::min (size, _bufferLayout.size));
+    return true;
+}
+
+bool
+GpuVariable::writeMatrix (const float* value) const
+{
+    if (!_constantBuffer)
+        return false;
+
+    float packed[16];
+    uint32_t size = packMatrix (value, packed);
+    _constantBuffer->write (_bufferOffset, packed, size);
+    return true;
+}
+
+bool
+GpuVariable::writeMatrixArray (const float* value, uint32_t count) const
+{
+    if (!_constantBuffer)
+        return false;
+
+    float packed[16];
+    for (uint32_t i = 0; i < elementCount (count); i++)
+    {
+        uint32_t size = packMatrix (&value[i * 16], packed);
+        _constantBuffer->write (_bufferOffset + i * _bufferLayout.stride, packed, size);
+    }
+    return true;
+}
+
+bool
+GpuVariable::writeVector (const float* value) const
+{
+    if (!_constantBuffer)
+        return false;
+
+    uint32_t size = std::min (_bufferLayout.columns, 4u) * sizeof(float);
+    _constantBuffer->write (_bufferOffset, value, std::min (size, _bufferLayout.size));
+    return true;
+}
+
+bool
+GpuVariable::writeVectorArray (const float* value, uint32_t count) const
+{
+    if (!_constantBuffer)
+        return false;
+
+    uint32_t size = std::min (_bufferLayout.columns, 4u) * sizeof(float);
+    for (uint32_t i = 0; i < elementCount (count); i++)
+    {
+        _constantBuffer->write (_bufferOffset + i * _bufferLayout.stride, &value[i * 4], size);
+    }
+    return true;
+}
+
+bool
+GpuVariable::writeFloatArray (const float* value, uint32_t count) const
+{
+    if (!_constantBuffer)
+        return false;
+
+    if (_bufferLayout.elements == 0)
+    {
+        // A single vector set component by component.
+        writeValue (value, uint32_t(sizeof(float) * count));
+    }
+    else
+    {
+        for (uint32_t i = 0; i < elementCount (count); i++)
+        {
+            _constantBuffer->write (_bufferOffset + i * _bufferLayout.stride, &value[i], sizeof(float));
+        }
+    }
+    return true;
+}
+
 bool isIndexedSemantic (const std::string& targetSemantic)
 {
     if (targetSemantic.size() == 0)
@@ -53,6 +53,7 @@ class IGpuBuffer;
 class IVertexBuffer;
 class IIndexBuffer;
 class IDepthSurface;
+class GpuConstantBuffer;
 
 bool isIndexedSemantic (const std::string& targetSemantic);
 int semanticIndex (const std::string& targetSemantic);
@@ -104,8 +105,51 @@ class GpuVariable : public IRenderResource
     const Ctr::IDevice*     device() const;
     Ctr::IDevice*           device();
 
+    //-------------------------------------------------------
+    // Register layout of a variable in its constant buffer.
+    // Scalars and vectors have a single row.
+    //-------------------------------------------------------
+    struct BufferLayout
+    {
+        uint32_t                  rows;
+        uint32_t                  columns;
+        bool                      columnMajor;
+        // Zero for variables that are not arrays.
+        uint32_t                  elements;
+        uint32_t                  stride;
+        uint32_t                  size;
+    };
+
+    //-------------------------------------------------------
+    // Values of attached variables are written into the
+    // constant buffer shadow at the given offset.
+    //-------------------------------------------------------
+    void                          attach (Ctr::GpuConstantBuffer* constantBuffer, 
+                                          uint32_t offset,
+                                          const BufferLayout& layout);
+    Ctr::GpuConstantBuffer*       constantBuffer() const;
+    uint32_t                      bufferOffset() const;
+    const BufferLayout&           bufferLayout() const;
+
   protected:
+    //-------------------------------------------------------
+    // Pack values into the attached shadow as the shader
+    // declares them. Return false if nothing is attached.
+    //-------------------------------------------------------
+    bool                          writeValue (const void* value, uint32_t size) const;
+    bool                          writeMatrix (const float* value) const;
+    bool                          writeMatrixArray (const float* value, uint32_t count) const;
+    bool                          writeVector (const float* value) const;
+    bool                          writeVectorArray (const float* value, uint32_t count) const;
+    bool                          writeFloatArray (const float* value, uint32_t count) const;
+
+    uint32_t                      packMatrix (const float* source, float* target) const;
+    uint32_t                      elementCount (uint32_t count) const;
+
     uint32_t                      _valueIndex;
+    Ctr::GpuConstantBuffer*       _constantBuffer;
+    uint32_t                      _bufferOffset;
+    BufferLayout                  _bufferLayout;
 };
 
 }
@@ -57,6 +57,8 @@ HDRPresentationPolicy::HDRPresentationPolicy (Ctr::IDevice* device) :
     _usePostFXAA(true),
     _currentFXAAPreset(5),
     _sourceTexture(0),
+    _ownsSourceTexture(true),
+    _sourceHandle(Ctr::RenderTargetPool::InvalidHandle),
     _renderTargetA(0)
 {
     Ctr::ShaderMgr* shaderMgr = _device->shaderMgr();
@@ -65,12 +67,14 @@ HDRPresentationPolicy::HDRPresentationPolicy (Ctr::IDevice* device) :
     uint32_t sampleQuality = device->multiSampleQuality();
 
     // In the anti aliasing case this texture becomes the swap texture
-    _renderTargetA = _device->createTexture(&TextureParameters ("HDR Texture 1",
-                             Ctr::TextureImagePtr(),
-                             Ctr::TwoD,
-                             Ctr::RenderTarget,
-                             Ctr::PF_FLOAT16_RGBA,
-                             Ctr::Vector3i(MIRROR_BACK_BUFFER, MIRROR_BACK_BUFFER, 1)));                                                                      
+    Ctr::TextureParameters renderTargetInit = 
+            Ctr::TextureParameters ("HDR Texture 1",
+                                   Ctr::TextureImagePtr(),
+                                   Ctr::TwoD,
+                                   Ctr::RenderTarget,
+                                   Ctr::PF_FLOAT16_RGBA,
+                                   Ctr::Vector3i(MIRROR_BACK_BUFFER, MIRROR_BACK_BUFFER, 1));
+    _renderTargetA = _device->createTexture(&renderTargetInit);                                                                      
 
     Ctr::TextureParameters sourceInit = 
             Ctr::TextureParameters ("SourceHDR",
@@ -115,7 +119,39 @@ HDRPresentationPolicy::HDRPresentationPolicy (Ctr::IDevice* device) :
 HDRPresentationPolicy::~HDRPresentationPolicy()
 {
     _device->destroyResource(_renderTargetA);
-    _device->destroyResource(_sourceTexture);
+    if (_ownsSourceTexture)
+    {
+        _device->destroyResource(_sourceTexture);
+    }
+}
+
+void
+HDRPresentationPolicy::declareTargets (Ctr::RenderTargetPool& pool, uint32_t pass)
+{
+    PresentationPolicy::declareTargets(pool, pass);
+
+    _sourceHandle = Ctr::RenderTargetPool::InvalidHandle;
+    if (_usePostFXAA)
+    {
+        _sourceHandle = pool.declare("SourceHDR", Ctr::RenderTargetPool::Description(Ctr::PF_A8R8G8B8));
+        pool.use(_sourceHandle, pass);
+    }
+}
+
+void
+HDRPresentationPolicy::bindTargets (const Ctr::RenderTargetPool& pool)
+{
+    PresentationPolicy::bindTargets(pool);
+
+    if (Ctr::ITexture* texture = pool.texture(_sourceHandle))
+    {
+        if (_ownsSourceTexture)
+        {
+            _device->destroyResource(_sourceTexture);
+            _ownsSourceTexture = false;
+        }
+        _sourceTexture = texture;
+    }
 }
 
 bool
@@ -81,6 +81,11 @@ class HDRPresentationPolicy : public PresentationPolicy
                                            const Camera* camera);
 
     virtual const FrameBuffer& sceneFrameBuffer() const;
+
+    // Adds the FXAA source, which only lives while the policy renders.
+    virtual void               declareTargets (Ctr::RenderTargetPool& pool, uint32_t pass);
+    virtual void               bindTargets (const Ctr::RenderTargetPool& pool);
+
   protected:
 
   private:
@@ -91,6 +96,8 @@ class HDRPresentationPolicy : public PresentationPolicy
     ITexture*                  _renderTarget;
     ITexture*                  _lastRenderTarget;
     ITexture*                  _sourceTexture;
+    bool                       _ownsSourceTexture;
+    Ctr::RenderTargetPool::Handle _sourceHandle;
 
     std::vector<const Ctr::IShader*>        _fxaaShader;
     bool                       _usePostFXAA;
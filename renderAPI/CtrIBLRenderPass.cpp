@@ -57,6 +57,7 @@
 #include <CtrShaderMgr.h>
 #include <CtrIEffect.h>
 #include <CtrMatrixAlgo.h>
+#include <CtrProfiler.h>
 
 namespace Ctr
 {
@@ -86,7 +87,7 @@ IBLRenderPass::IBLRenderPass(Ctr::IDevice* device) :
     if (!_deviceInterface->shaderMgr()->addShader("IblColorConvertEnvironment.fx", _colorConversionShader, true))
     {
         LOG("ERROR: Could not add the environment color conversion shader.");
-        throw (std::exception("No color conversion shader available for probes"));
+        throw (std::runtime_error("No color conversion shader available for probes"));
     }
     else
     {
@@ -317,6 +318,8 @@ IBLRenderPass::refineSpecular(Ctr::Scene* scene,
 void
 IBLRenderPass::render (Ctr::Scene* scene)
 {
+    CTR_PROFILE_SCOPE("IBLRenderPass::render");
+
     Ctr::Camera* camera           = scene->camera();
 
     _deviceInterface->enableDepthWrite();
@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrICommandList.h>
+#include <CtrIDevice.h>
+
+namespace Ctr
+{
+namespace
+{
+thread_local ICommandList* recordingList = nullptr;
+}
+
+ICommandList::ICommandList (IDevice* device) :
+    _device (device),
+    _cullMode (Ctr::CCW)
+{
+    memset (&_parameterStats, 0, sizeof(ShaderParameterValue::Stats));
+    memset (&_constantBufferStats, 0, sizeof(GpuConstantBuffer::Stats));
+}
+
+ICommandList::~ICommandList()
+{
+}
+
+bool
+ICommandList::begin()
+{
+    _constantBufferShadows.clear();
+    _scopeStates.clear();
+    _lastValues.clear();
+    memset (&_parameterStats, 0, sizeof(ShaderParameterValue::Stats));
+    memset (&_constantBufferStats, 0, sizeof(GpuConstantBuffer::Stats));
+    _cullMode = _device->cullMode();
+    return true;
+}
+
+void
+ICommandList::record (const std::function<void()>& commands)
+{
+    ICommandList* previous = recordingList;
+    recordingList = this;
+    try
+    {
+        commands();
+    }
+    catch (...)
+    {
+        recordingList = previous;
+        throw;
+    }
+    recordingList = previous;
+}
+
+bool
+ICommandList::end()
+{
+    return true;
+}
+
+bool
+ICommandList::execute()
+{
+    bool executed = executeRecorded();
+
+    for (auto it = _constantBufferShadows.begin(); it != _constantBufferShadows.end(); it++)
+    {
+        it->first->invalidateShadow();
+    }
+    // Values the list wrote past the immediate change tracking.
+    ShaderParameterValue::invalidateAll();
+
+    ShaderParameterValue::addStats (_parameterStats);
+    GpuConstantBuffer::addStats (_constantBufferStats);
+    return executed;
+}
+
+ICommandList*
+ICommandList::recording()
+{
+    return recordingList;
+}
+
+std::mutex&
+ICommandList::effectMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+IDevice*
+ICommandList::device() const
+{
+    return _device;
+}
+
+ICommandList::ConstantBufferShadow*
+ICommandList::constantBufferShadow (const GpuConstantBuffer* constantBuffer)
+{
+    auto it = _constantBufferShadows.find (constantBuffer);
+    if (it == _constantBufferShadows.end())
+    {
+        if (!constantBuffer->shadowed())
+            return nullptr;
+
+        // Nothing writes the immediate shadow while lists record. The
+        // buffer may hold another list's upload, so it all goes up.
+        ConstantBufferShadow& shadow = _constantBufferShadows[constantBuffer];
+        shadow.data = constantBuffer->shadow();
+        shadow.dirtyBegin = 0;
+        shadow.dirtyEnd = uint32_t(shadow.data.size());
+        shadow.buffer = nullptr;
+        return &shadow;
+    }
+    return &it->second;
+}
+
+ParameterScopeState&
+ICommandList::scopeState (const void* shader)
+{
+    return _scopeStates[shader];
+}
+
+std::vector<uint8_t>&
+ICommandList::lastValue (const ShaderParameterValue* value)
+{
+    return _lastValues[value];
+}
+
+Ctr::CullMode
+ICommandList::cullMode() const
+{
+    return _cullMode;
+}
+
+void
+ICommandList::setCullMode (Ctr::CullMode cullMode)
+{
+    _cullMode = cullMode;
+}
+
+ShaderParameterValue::Stats&
+ICommandList::parameterStats()
+{
+    return _parameterStats;
+}
+
+GpuConstantBuffer::Stats&
+ICommandList::constantBufferStats()
+{
+    return _constantBufferStats;
+}
+
+}
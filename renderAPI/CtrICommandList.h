@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_ICOMMAND_LIST
+#define INCLUDED_CRT_ICOMMAND_LIST
+
+#include <CtrPlatform.h>
+#include <CtrRenderEnums.h>
+#include <CtrGpuConstantBuffer.h>
+#include <CtrShaderParameterValue.h>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+
+namespace Ctr
+{
+class IDevice;
+class IGpuBuffer;
+
+//------------------------------------------------------------------
+// Device work recorded on a worker thread and executed later, in
+// order, on the render thread. While a thread records, the calls it
+// makes into shaders, constant buffers and the device land in the
+// list instead of the shared immediate state:
+//
+//   - constant buffer writes go to a per list copy of the shadow,
+//     seeded from the immediate shadow, and commits upload from it
+//   - shaders evaluate frame and camera scoped values against a per
+//     list ParameterScopeState, and parameter values are change
+//     detected against the values last written by the list
+//   - parameter and upload counters are kept per list and added to
+//     the frame counters when the list executes
+//
+// The list starts from the device state current at begin(), and the
+// immediate state is left as it was before begin() once executed.
+// Anything reached while recording that is not per list (effect
+// variables, lazily created buffers) is guarded by effectMutex().
+// Recording reads the scene, so it must be updated first.
+//------------------------------------------------------------------
+class ICommandList
+{
+  public:
+    struct ConstantBufferShadow
+    {
+        std::vector<uint8_t>   data;
+        uint32_t               dirtyBegin;
+        uint32_t               dirtyEnd;
+        // Immediate shadow buffer, cached after the first commit.
+        IGpuBuffer*            buffer;
+    };
+
+    ICommandList (IDevice* device);
+    virtual ~ICommandList();
+
+    //-------------------------------------------------------------
+    // Render thread. Drops the last recording and captures the
+    // device state the next one starts from.
+    //-------------------------------------------------------------
+    virtual bool                begin();
+
+    //-------------------------------------------------------------
+    // Runs commands on the calling thread with this list as the
+    // recording target. Lists may record on separate threads at
+    // the same time, a list on one thread at a time.
+    //-------------------------------------------------------------
+    void                        record (const std::function<void()>& commands);
+
+    // Recording thread, after the last record.
+    virtual bool                end();
+
+    //-------------------------------------------------------------
+    // Render thread. Submits the recording and folds its counters
+    // into the frame counters. Immediate constant buffer shadows
+    // the list wrote are uploaded again on their next commit.
+    //-------------------------------------------------------------
+    bool                        execute();
+
+    // The list the calling thread records into, or nullptr.
+    static ICommandList*        recording();
+    static std::mutex&          effectMutex();
+
+    IDevice*                    device() const;
+
+    ConstantBufferShadow*       constantBufferShadow (const GpuConstantBuffer* constantBuffer);
+    ParameterScopeState&        scopeState (const void* shader);
+    std::vector<uint8_t>&       lastValue (const ShaderParameterValue* value);
+
+    Ctr::CullMode               cullMode() const;
+    virtual void                setCullMode (Ctr::CullMode cullMode);
+
+    ShaderParameterValue::Stats& parameterStats();
+    GpuConstantBuffer::Stats&   constantBufferStats();
+
+  protected:
+    virtual bool                executeRecorded() = 0;
+
+    IDevice*                    _device;
+    Ctr::CullMode               _cullMode;
+
+  private:
+    std::map<const GpuConstantBuffer*, ConstantBufferShadow> _constantBufferShadows;
+    std::map<const void*, ParameterScopeState> _scopeStates;
+    std::unordered_map<const ShaderParameterValue*, std::vector<uint8_t> > _lastValues;
+    ShaderParameterValue::Stats _parameterStats;
+    GpuConstantBuffer::Stats    _constantBufferStats;
+};
+
+}
+
+#endif
@@ -57,5 +57,17 @@ IComputeShader::hash() const
     return _hash;
 }
 
+bool
+IComputeShader::compile()
+{
+    return true;
+}
+
+const std::set<std::string>&
+IComputeShader::dependencies() const
+{
+    return _dependencies;
+}
+
 }
 
@@ -86,10 +86,15 @@ IComputeShader : public IRenderResource
     virtual const std::string&  filePathName() const = 0;
     virtual const std::string&  includePathName() const =0;
 
+    // See IShader::compile and IShader::dependencies.
+    virtual bool                compile();
+    const std::set<std::string>& dependencies() const;
+
     const Hash&                 hash() const;
 
   protected:
     Hash                        _hash;
+    std::set<std::string>       _dependencies;
 };
 }
 
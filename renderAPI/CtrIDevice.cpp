@@ -45,11 +45,14 @@
 #include <CtrShaderMgr.h>
 #include <CtrTextureMgr.h>
 #include <CtrShaderParameterValueFactory.h>
+#include <CtrShaderParameterValue.h>
 #include <CtrVertexDeclarationMgr.h>
-#include <CtrInputManager.h>
 #include <CtrColorResolve.h>
 #include <CtrDepthResolve.h>
 #include <CtrPostEffectsMgr.h>
+#include <CtrFileChangeWatcher.h>
+#include <CtrFrameRingAllocator.h>
+#include <CtrGpuConstantBuffer.h>
 
 namespace Ctr
 {
@@ -131,22 +134,38 @@ IDevice::IDevice () :
     _multiSampleQuality(0),
     _sceneDrawMode(Ctr::Filled),
     _usePrecompiledShaders(true),
+    _commandListCount(0),
     _depthResolveEffect(nullptr),
     _colorResolveEffect(nullptr),
     _vertexDeclarationMgr(nullptr),
     _textureMgr(nullptr),
     _shaderValueFactory(nullptr),
     _shaderMgr(nullptr),
-    _postEffectsMgr(nullptr)
+    _postEffectsMgr(nullptr),
+    _fileChangeWatcher(nullptr),
+    _transientAllocator(nullptr),
+    _frameIndex(0)
 {
 }
 
 void
 IDevice::update()
 {
+    _frameIndex++;
+    ShaderParameterValue::resetStats();
+    GpuConstantBuffer::resetStats();
+    _transientAllocator->beginFrame();
+
+    _fileChangeWatcher->update();
     _shaderMgr->update();
 }
 
+uint64_t
+IDevice::frameIndex() const
+{
+    return _frameIndex;
+}
+
 bool
 IDevice::initialize(const Ctr::ApplicationRenderParameters& deviceParameters)
 {
@@ -157,11 +176,20 @@ IDevice::initialize(const Ctr::ApplicationRenderParameters& deviceParameters)
 bool
 IDevice::postInitialize(const Ctr::ApplicationRenderParameters& deviceParameters)
 {
+    // Hot reload roots. Missing directories are skipped.
+    _fileChangeWatcher = new FileChangeWatcher();
+    _fileChangeWatcher->addRoot("data/shadersD3D11");
+    _fileChangeWatcher->addRoot("data/Textures");
+    _fileChangeWatcher->addRoot("data/materials");
+    _fileChangeWatcher->addRoot("data/meshes");
+    _fileChangeWatcher->initialize();
+
     _vertexDeclarationMgr = new Ctr::VertexDeclarationMgr(_application, this);
     _textureMgr = new TextureMgr(_application, this);
     _shaderValueFactory = new ShaderParameterValueFactory(this);
     _shaderMgr = new Ctr::ShaderMgr(this);
     _postEffectsMgr = new PostEffectsMgr(_application, this);
+    _transientAllocator = new FrameRingAllocator();
 
     {
         _colorResolveEffect = new Ctr::ColorResolve(this);
@@ -176,6 +204,24 @@ IDevice::postInitialize(const Ctr::ApplicationRenderParameters& deviceParameters
     return true;
 }
 
+ICommandList*
+IDevice::createCommandList()
+{
+    return nullptr;
+}
+
+uint32_t
+IDevice::commandListCount() const
+{
+    return _commandListCount;
+}
+
+void
+IDevice::setCommandListCount(uint32_t commandListCount)
+{
+    _commandListCount = commandListCount;
+}
+
 bool
 IDevice::usePrecompiledShaders() const
 {
@@ -203,6 +249,8 @@ IDevice::free()
     safedelete(_shaderValueFactory);
     safedelete(_postEffectsMgr);
     safedelete(_textureMgr);
+    safedelete(_fileChangeWatcher);
+    safedelete(_transientAllocator);
 
     _application = nullptr;
 
@@ -225,15 +273,15 @@ IDevice::sharedRenderTarget(int width, int height, Ctr::PixelFormat format, bool
         }
     }
 
-    Ctr::ITexture* texture = 
-        createTexture(&TextureParameters ("tempTex",
-                                          TextureImagePtr(),
-                                          Ctr::TwoD,
-                                          Ctr::RenderTarget,
-                                          format,
-                                          Ctr::Vector3i(width, height, 1),
-                                          false,
-                                          1, 1, 0, 1, useUAV));
+    TextureParameters textureInit ("tempTex",
+                                   TextureImagePtr(),
+                                   Ctr::TwoD,
+                                   Ctr::RenderTarget,
+                                   format,
+                                   Ctr::Vector3i(width, height, 1),
+                                   false,
+                                   1, 1, 0, 1, useUAV);
+    Ctr::ITexture* texture = createTexture(&textureInit);
     if (texture)
     {
         _temporaryTexturePool.push_back(texture);
@@ -288,4 +336,16 @@ IDevice::postEffectsMgr()
     return _postEffectsMgr;
 }
 
+FileChangeWatcher*
+IDevice::fileChangeWatcher()
+{
+    return _fileChangeWatcher;
+}
+
+FrameRingAllocator*
+IDevice::transientAllocator()
+{
+    return _transientAllocator;
+}
+
 }
\ No newline at end of file
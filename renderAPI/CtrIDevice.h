@@ -72,6 +72,9 @@ class ShaderMgr;
 class VertexDeclarationMgr;
 class TextureMgr;
 class PostEffectsMgr;
+class FileChangeWatcher;
+class FrameRingAllocator;
+class ICommandList;
 class ShaderParameterValueFactory;
 class DepthResolve;
 class ColorResolve;
@@ -124,7 +127,9 @@ class IDevice
     void                        setSceneDrawMode(Ctr::DrawMode);
     Ctr::DrawMode                sceneDrawMode() const;
 
+    // Per frame tick, advances frameIndex.
     void                        update();
+    uint64_t                    frameIndex() const;
 
     virtual void                printState() = 0;
     virtual void                syncState() = 0;
@@ -223,6 +228,25 @@ class IDevice
                                                       uint32_t faceCount, 
                                                       uint32_t indexOffset,
                                                       uint32_t vertexOffset) const = 0;
+
+    // Draws instanceCount instances, told apart in shaders by SV_InstanceID.
+    virtual bool                drawIndexedPrimitiveInstanced (const IVertexDeclaration*, 
+                                                               const IIndexBuffer*, 
+                                                               const IVertexBuffer*, 
+                                                               const GpuTechnique *,
+                                                               PrimitiveType, 
+                                                               uint32_t faceCount, 
+                                                               uint32_t indexOffset,
+                                                               uint32_t vertexOffset,
+                                                               uint32_t instanceCount) const = 0;
+
+    // Lists that record draws on worker threads, see ICommandList.
+    // Backends without them return nullptr and draw on this thread.
+    virtual ICommandList*       createCommandList();
+    // Command lists RenderQueue records a large queue into. 0, the
+    // default, is one per hardware thread and 1 draws serially.
+    uint32_t                    commandListCount() const;
+    void                        setCommandListCount(uint32_t);
     
     virtual bool                blitSurfaces (const ISurface* destination, 
                                               const ISurface* src, 
@@ -295,6 +319,10 @@ class IDevice
     TextureMgr*                  textureMgr();
     ShaderParameterValueFactory* shaderValueFactory();
     PostEffectsMgr *             postEffectsMgr();
+    // Content changes seen this frame, drained in update().
+    FileChangeWatcher*           fileChangeWatcher();
+    // Transient per frame memory, advanced in update().
+    FrameRingAllocator*          transientAllocator();
 
   protected:
     bool                         _useMultiSampleAntiAliasing;
@@ -303,6 +331,7 @@ class IDevice
     Ctr::FrameBuffer              _currentFrameBuffer;
     Ctr::DrawMode                 _sceneDrawMode;
     bool                         _usePrecompiledShaders;
+    uint32_t                     _commandListCount;
     std::vector <Ctr::ITexture*>  _temporaryTexturePool;
     const Ctr::Application*       _application;
 
@@ -311,6 +340,9 @@ class IDevice
     TextureMgr*                  _textureMgr;
     ShaderParameterValueFactory* _shaderValueFactory;
     PostEffectsMgr *             _postEffectsMgr;
+    FileChangeWatcher*           _fileChangeWatcher;
+    FrameRingAllocator*          _transientAllocator;
+    uint64_t                     _frameIndex;
     DepthResolve*                _depthResolveEffect;
     ColorResolve*                _colorResolveEffect;
 };
@@ -49,7 +49,7 @@ RenderResourceParameters::~RenderResourceParameters(){};
 
 DeviceParameters::DeviceParameters() : 
     RenderResourceParameters(),
-    _windowHandle (false),
+    _windowHandle (0),
     _application (0),
     _useSLIIfAvailable (0),
     _windowed (0),
@@ -401,11 +401,13 @@ DepthSurfaceParameters::setHeight (int height) {
     _height = height;
 }
 
-IndexBufferParameters::IndexBufferParameters(uint32_t sizeInBytesVal, bool isRingBuffered, bool isDynamic) 
+IndexBufferParameters::IndexBufferParameters(uint32_t sizeInBytesVal, bool isRingBuffered, bool isDynamic,
+                                             IndexFormat format) 
 {
     _sizeInBytes = sizeInBytesVal;
     _isRingBuffered = isRingBuffered;
     _isDynamic = isDynamic;
+    _format = format;
 };
 
 IndexBufferParameters::IndexBufferParameters (const IndexBufferParameters& in)
@@ -413,6 +415,7 @@ IndexBufferParameters::IndexBufferParameters (const IndexBufferParameters& in)
     _sizeInBytes =     in.sizeInBytes();
     _isDynamic = in.dynamic();
     _isRingBuffered = in.ringBuffered();
+    _format = in.format();
 };
 
 unsigned int                
@@ -433,6 +436,12 @@ IndexBufferParameters::dynamic() const
     return _isDynamic;
 }
 
+IndexFormat
+IndexBufferParameters::format() const
+{
+    return _format;
+}
+
 VertexBufferParameters::VertexBufferParameters(uint32_t sizeInBytesVal,
                      bool isRingBuffered, 
                      bool streamOut , 
@@ -229,18 +229,21 @@ class DepthSurfaceParameters  : public RenderResourceParameters
 class IndexBufferParameters : public RenderResourceParameters
 {    
   public:
-    IndexBufferParameters(uint32_t sizeInBytesVal, bool isRingBuffered = false, bool isDynamic = false);
+    IndexBufferParameters(uint32_t sizeInBytesVal, bool isRingBuffered = false, bool isDynamic = false,
+                          IndexFormat format = INDEX32);
 
     IndexBufferParameters (const IndexBufferParameters& in);
 
     unsigned int               sizeInBytes() const;
     bool                       ringBuffered() const;
     bool                       dynamic() const;
+    IndexFormat                format() const;
 
   private:
     unsigned                   _sizeInBytes;
     bool                       _isRingBuffered;
     bool                       _isDynamic;
+    IndexFormat                _format;
 };
 
 class VertexBufferParameters : public RenderResourceParameters
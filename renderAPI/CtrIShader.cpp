@@ -42,7 +42,8 @@
 
 namespace Ctr
 {
-IShader::IShader (Ctr::IDevice* device) : IRenderResource (device)
+IShader::IShader (Ctr::IDevice* device) : IRenderResource (device),
+    _supportsInstancing (false)
 {
 }
 
@@ -56,6 +57,24 @@ IShader::hash() const
     return _hash;
 }
 
+bool
+IShader::supportsInstancing() const
+{
+    return _supportsInstancing;
+}
+
+bool
+IShader::compile()
+{
+    return true;
+}
+
+const std::set<std::string>&
+IShader::dependencies() const
+{
+    return _dependencies;
+}
+
 const std::string&
 IShader::includeFilePathName() const
 {
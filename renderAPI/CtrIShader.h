@@ -56,6 +56,13 @@ class GpuConstantBuffer;
 class IGpuBuffer;
 class IEffect;
 
+enum ShaderBindFlags
+{
+    BindTechniqueParameters = (1<<0),
+    BindMaterialParameters  = (1<<1),
+    BindAllParameters       = BindTechniqueParameters | BindMaterialParameters
+};
+
 class
 IShader : public IRenderResource
 {
@@ -100,6 +107,14 @@ IShader : public IRenderResource
     virtual bool                renderMeshes (const RenderRequest& request,
                                               const std::set<const Mesh*>&) const = 0;
 
+    //----------------------------------------------------------------
+    // Renders a mesh from a sorted queue. Technique and material
+    // parameters are only set when flagged in bindFlags, otherwise the
+    // values bound by the previous queued mesh are reused.
+    //----------------------------------------------------------------
+    virtual bool                renderQueuedMesh (const RenderRequest& request,
+                                                  uint32_t bindFlags) const = 0;
+
     virtual bool                renderInstancedBuffer (const RenderRequest& request,
                                                        const Ctr::IGpuBuffer* instanceBuffer) const = 0;
 
@@ -140,6 +155,19 @@ IShader : public IRenderResource
     
     virtual const IEffect*      effect () const = 0;
 
+    //----------------------------------------------------------------
+    // Compiles the source to bytecode without touching device state,
+    // so ShaderMgr can compile several shaders at once. The next
+    // create() consumes the result. The default has nothing to do.
+    //----------------------------------------------------------------
+    virtual bool                compile();
+
+    //----------------------------------------------------------------
+    // Every file read by the last compile: the source, the include
+    // file and the transitive #include set.
+    //----------------------------------------------------------------
+    const std::set<std::string>& dependencies() const;
+
     const std::string&          shaderStream() const;
     const std::string&          filePathName() const;
     const std::string&          includeFilePathName() const;
@@ -153,8 +181,16 @@ IShader : public IRenderResource
 
     const Hash&                 hash() const;
 
+    //----------------------------------------------------------------
+    // True when the shader declares INSTANCEWORLDMATRICES, so meshes
+    // sharing geometry can be drawn with one instanced call.
+    //----------------------------------------------------------------
+    bool                        supportsInstancing() const;
+
   protected:
     Hash                        _hash;
+    bool                        _supportsInstancing;
+    std::set<std::string>       _dependencies;
   private:
     std::string                _shaderStream;
     std::string                _fileName;
@@ -74,7 +74,24 @@ class  IVertexDeclaration : public IRenderResource
             case FLOAT4:   
                 return 4 * sizeof(float);
             case UBYTE4:
+            case UBYTE4N:
                 return 4 * sizeof(uint8_t);
+            case SHORT2:
+            case SHORT2N:
+            case USHORT2N:
+                return 2 * sizeof(uint16_t);
+            case SHORT4:
+            case SHORT4N:
+            case USHORT4N:
+                return 4 * sizeof(uint16_t);
+            case FLOAT16_2:
+                return 2 * sizeof(uint16_t);
+            case FLOAT16_4:
+                return 4 * sizeof(uint16_t);
+            case UINT8:
+                return sizeof(uint8_t);
+            case UINT32:
+                return sizeof(uint32_t);
         }
         return 0;
     }
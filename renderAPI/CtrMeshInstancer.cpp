@@ -0,0 +1,239 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrMeshInstancer.h>
+#include <CtrRenderQueue.h>
+#include <CtrIndexedMesh.h>
+#include <CtrMaterial.h>
+#include <CtrIShader.h>
+#include <CtrIDevice.h>
+#include <CtrIGpuBuffer.h>
+#include <CtrIRenderResourceParameters.h>
+#include <CtrFrameRingAllocator.h>
+#include <CtrLog.h>
+
+namespace Ctr
+{
+namespace
+{
+const uint32_t MinInstanceCapacity = 256;
+}
+
+MeshInstancer::MeshInstancer(IDevice* device) :
+    _device (device),
+    _groupCount (0),
+    _instanceBuffer (nullptr),
+    _capacity (0),
+    _uploaded (nullptr),
+    _uploadedCount (0),
+    _uploadedFrame (0)
+{
+    memset(&_stats, 0, sizeof(Stats));
+}
+
+MeshInstancer::~MeshInstancer()
+{
+    safedelete(_instanceBuffer);
+}
+
+void
+MeshInstancer::clear()
+{
+    for (uint32_t groupId = 0; groupId < _groupCount; groupId++)
+        _groups[groupId].requests.clear();
+    _groupIds.clear();
+    _groupCount = 0;
+    memset(&_stats, 0, sizeof(Stats));
+}
+
+bool
+MeshInstancer::add(const RenderRequest& request)
+{
+    const IndexedMesh* mesh = dynamic_cast<const IndexedMesh*>(request.mesh);
+    if (!mesh || mesh->geometry() == mesh)
+        return false;
+
+    const IShader* shader = request.material ? request.material->shader() : nullptr;
+    if (!shader || !shader->supportsInstancing())
+        return false;
+
+    GroupKey key(std::make_pair(mesh->geometry(), request.lod), 
+                 std::make_pair((const void*)request.technique, (const void*)request.material));
+    auto it = _groupIds.find(key);
+    if (it == _groupIds.end())
+    {
+        if (_groupCount == _groups.size())
+            _groups.push_back(Group());
+        it = _groupIds.insert(std::make_pair(key, _groupCount++)).first;
+    }
+    _groups[it->second].requests.push_back(request);
+    _stats.meshes++;
+    return true;
+}
+
+bool
+MeshInstancer::reserve(uint32_t matrixCount)
+{
+    if (_instanceBuffer && matrixCount <= _capacity)
+        return true;
+
+    uint32_t capacity = std::max(_capacity, MinInstanceCapacity);
+    while (capacity < matrixCount)
+        capacity *= 2;
+
+    safedelete(_instanceBuffer);
+    _capacity = 0;
+    _uploaded = nullptr;
+
+    GpuBufferParameters parameters(PF_FLOAT32_RGBA, capacity * 4, nullptr, true);
+    if (!(_instanceBuffer = _device->createBufferResource(&parameters)))
+    {
+        LOG("Failed to create instance buffer for " << capacity << " matrices");
+        return false;
+    }
+    _capacity = capacity;
+    return true;
+}
+
+void
+MeshInstancer::upload(const Matrix44f* matrices, uint32_t matrixCount)
+{
+    // The last upload is only comparable while its frame is in flight.
+    FrameRingAllocator* allocator = _device->transientAllocator();
+    if (_uploaded && 
+        _device->frameIndex() - _uploadedFrame < allocator->framesInFlight() &&
+        _uploadedCount == matrixCount &&
+        memcmp(_uploaded, matrices, matrixCount * sizeof(Matrix44f)) == 0)
+    {
+        _uploaded = matrices;
+        _uploadedFrame = _device->frameIndex();
+        _stats.unchangedUploads++;
+        return;
+    }
+
+    _uploaded = nullptr;
+    if (Matrix44f* locked = (Matrix44f*)_instanceBuffer->lock())
+    {
+        memcpy(locked, matrices, matrixCount * sizeof(Matrix44f));
+        _instanceBuffer->unlock();
+
+        _uploaded = matrices;
+        _uploadedCount = matrixCount;
+        _uploadedFrame = _device->frameIndex();
+        _stats.uploads++;
+        _stats.uploadedBytes += matrixCount * uint32_t(sizeof(Matrix44f));
+    }
+    else
+    {
+        LOG("Failed to lock instance buffer for " << matrixCount << " matrices");
+    }
+}
+
+void
+MeshInstancer::build(RenderQueue& queue)
+{
+    uint32_t matrixCount = 0;
+    for (uint32_t groupId = 0; groupId < _groupCount; groupId++)
+    {
+        if (_groups[groupId].requests.size() > 1)
+            matrixCount += (uint32_t)_groups[groupId].requests.size();
+    }
+
+    // Write discard drops the previous contents, so every batch of the
+    // pass is staged and then uploaded in one lock before any of them 
+    // is drawn. A full transient allocator falls back to writing the
+    // locked buffer directly.
+    Matrix44f* matrices = nullptr;
+    bool staged = false;
+    if (matrixCount > 0 && reserve(matrixCount))
+    {
+        matrices = (Matrix44f*)_device->transientAllocator()->allocate(matrixCount * sizeof(Matrix44f));
+        staged = matrices != nullptr;
+        if (!staged)
+        {
+            _uploaded = nullptr;
+            if ((matrices = (Matrix44f*)_instanceBuffer->lock()))
+            {
+                _stats.uploads++;
+                _stats.uploadedBytes += matrixCount * uint32_t(sizeof(Matrix44f));
+            }
+        }
+    }
+
+    uint32_t offset = 0;
+    for (uint32_t groupId = 0; groupId < _groupCount; groupId++)
+    {
+        const std::vector<RenderRequest>& requests = _groups[groupId].requests;
+        if (requests.size() > 1 && matrices)
+        {
+            for (size_t i = 0; i < requests.size(); i++)
+                matrices[offset + i] = requests[i].mesh->worldTransform();
+
+            RenderRequest request = requests[0];
+            request.instanceBuffer = _instanceBuffer;
+            request.instanceOffset = offset;
+            request.instanceCount = (uint32_t)requests.size();
+            queue.add(request);
+
+            offset += request.instanceCount;
+            _stats.batches++;
+            _stats.instancedMeshes += request.instanceCount;
+        }
+        else
+        {
+            for (auto it = requests.begin(); it != requests.end(); it++)
+                queue.add(*it);
+        }
+    }
+
+    if (staged)
+        upload(matrices, matrixCount);
+    else if (matrices)
+        _instanceBuffer->unlock();
+}
+
+const MeshInstancer::Stats&
+MeshInstancer::stats() const
+{
+    return _stats;
+}
+
+}
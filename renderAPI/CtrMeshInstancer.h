@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_MESH_INSTANCER
+#define INCLUDED_CRT_MESH_INSTANCER
+
+#include <CtrPlatform.h>
+#include <CtrRenderRequest.h>
+#include <CtrMatrix44.h>
+
+namespace Ctr
+{
+class IDevice;
+class IGpuBuffer;
+class IndexedMesh;
+class RenderQueue;
+
+//--------------------------------------------------------------------
+//
+// MeshInstancer
+//
+// Groups the requests of a pass by shared geometry, level of detail,
+// technique and material, and turns each group of two or more into
+// one instanced request. The world matrices of every batch are
+// written to a single dynamic Buffer<float4>, four rows per instance,
+// which shaders read through the INSTANCEWORLDMATRICES and
+// INSTANCEPARAMETERS semantics.
+//
+// The matrices are staged in the device's transient allocator first.
+// When they match the previous build, which is still live there, the
+// buffer already holds them and is not locked again, so static
+// scenes upload nothing after their first frame.
+//
+// Only meshes that share geometry (IndexedMesh::share) and whose
+// shader declares INSTANCEWORLDMATRICES are accepted.
+//
+//--------------------------------------------------------------------
+class MeshInstancer
+{
+  public:
+    struct Stats
+    {
+        uint32_t               meshes;
+        // Instanced draws and the meshes they replaced.
+        uint32_t               batches;
+        uint32_t               instancedMeshes;
+        // Buffer locks, and builds whose matrices were already uploaded.
+        uint32_t               uploads;
+        uint32_t               uploadedBytes;
+        uint32_t               unchangedUploads;
+    };
+
+    MeshInstancer(IDevice* device);
+    ~MeshInstancer();
+
+    void                       clear();
+    // Returns false if the request cannot be instanced, the caller
+    // should queue it as is.
+    bool                       add(const RenderRequest& request);
+    // Uploads the instance matrices and adds one request per group.
+    void                       build(RenderQueue& queue);
+
+    const Stats&               stats() const;
+
+  private:
+    struct Group
+    {
+        std::vector<RenderRequest> requests;
+    };
+    // Geometry and level of detail, technique and material.
+    typedef std::pair<std::pair<const IndexedMesh*, uint32_t>, 
+                      std::pair<const void*, const void*> > GroupKey;
+
+    bool                       reserve(uint32_t matrixCount);
+    void                       upload(const Matrix44f* matrices, uint32_t matrixCount);
+
+    IDevice*                   _device;
+    std::map<GroupKey, uint32_t> _groupIds;
+    std::vector<Group>         _groups;
+    uint32_t                   _groupCount;
+
+    IGpuBuffer*                _instanceBuffer;
+    uint32_t                   _capacity;
+
+    // Matrices of the last upload, in the transient allocator.
+    const Matrix44f*           _uploaded;
+    uint32_t                   _uploadedCount;
+    uint64_t                   _uploadedFrame;
+
+    Stats                      _stats;
+};
+
+}
+
+#endif
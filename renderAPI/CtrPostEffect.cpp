@@ -57,6 +57,8 @@ _technique(0),
 _shader(0),
 _textureIn(0),
 _postEffectTexture(nullptr),
+_ownsTexture(false),
+_targetHandle(Ctr::RenderTargetPool::InvalidHandle),
 _format (format),
 _verticalPass (false)
 {
@@ -76,6 +78,7 @@ _verticalPass (false)
                              Ctr::Vector3i(MIRROR_BACK_BUFFER, MIRROR_BACK_BUFFER, 1));
 
         _postEffectTexture = _device->createTexture(&textureData);
+        _ownsTexture = true;
     }
 
     _postEffectBounds = Ctr::Region2i(Ctr::Vector2i(0,0), Ctr::Vector2i(_device->backbuffer()->width(), _device->backbuffer()->height()));
@@ -83,7 +86,42 @@ _verticalPass (false)
 
 PostEffect::~PostEffect()
 {
-    _device->destroyResource(_postEffectTexture);
+    if (_ownsTexture)
+    {
+        _device->destroyResource(_postEffectTexture);
+    }
+}
+
+void
+PostEffect::declareTargets (Ctr::RenderTargetPool& pool, uint32_t pass)
+{
+    _targetHandle = Ctr::RenderTargetPool::InvalidHandle;
+    if (_format != Ctr::PF_UNKNOWN)
+    {
+        _targetHandle = pool.declare(_name.empty() ? "PostEffect" : _name, 
+                                     Ctr::RenderTargetPool::Description(_format));
+        pool.use(_targetHandle, pass);
+    }
+}
+
+void
+PostEffect::bindTargets (const Ctr::RenderTargetPool& pool)
+{
+    if (Ctr::ITexture* texture = pool.texture(_targetHandle))
+    {
+        if (_ownsTexture)
+        {
+            _device->destroyResource(_postEffectTexture);
+            _ownsTexture = false;
+        }
+        _postEffectTexture = texture;
+    }
+}
+
+Ctr::RenderTargetPool::Handle
+PostEffect::targetHandle() const
+{
+    return _targetHandle;
 }
 
 
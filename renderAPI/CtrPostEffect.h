@@ -45,6 +45,7 @@
 #include <CtrRenderTargetQuad.h>
 #include <CtrITexture.h>
 #include <CtrISurface.h>
+#include <CtrRenderTargetPool.h>
 
 namespace Ctr
 {
@@ -158,12 +159,28 @@ class PostEffect  : public Ctr::RenderTargetQuad
 
     virtual bool                recreateOnResize() { return true; }
 
+    //-------------------------------------------------------------
+    // Declares the targets the effect renders to in the given pass
+    // and binds the textures the pool assigned to them. Once bound
+    // the effect gives up the target it created for itself.
+    //-------------------------------------------------------------
+    virtual void                declareTargets (Ctr::RenderTargetPool& pool, uint32_t pass);
+    virtual void                bindTargets (const Ctr::RenderTargetPool& pool);
+
+    //-------------------------------
+    // The handle of texture() in the 
+    // pool, once declared.
+    //-------------------------------
+    Ctr::RenderTargetPool::Handle targetHandle() const;
+
   protected:
     
     //---------------------
     //Render Texture Target
     //---------------------
     Ctr::ITexture*            _postEffectTexture;
+    bool                      _ownsTexture;
+    Ctr::RenderTargetPool::Handle _targetHandle;
 
 
     //--------------------------
@@ -46,6 +46,7 @@
 #include <CtrViewportProperty.h>
 #include <CtrISurface.h>
 #include <CtrHDRPresentationPolicy.h>
+#include <CtrProfiler.h>
 #include <strstream>
 
 namespace Ctr
@@ -53,7 +54,8 @@ namespace Ctr
 
 PostEffectsMgr::PostEffectsMgr (const Ctr::Application* application,
                                 Ctr::IDevice* device) : 
-    _deviceInterface(device)
+    _deviceInterface(device),
+    _targetPool(device)
 {
     _usingPostEffects = false;
     _presentationPolicies.insert (std::make_pair (HDR, new HDRPresentationPolicy(_deviceInterface)));
@@ -87,6 +89,13 @@ PostEffectsMgr::setActivePolicy  (PostEffectPresentationPolicy policyType)
 PostEffectsMgr::~PostEffectsMgr()
 {
     clearPathway();
+    _targetPool.free();
+}
+
+const RenderTargetPool&
+PostEffectsMgr::targetPool() const
+{
+    return _targetPool;
 }
 
 bool 
@@ -232,9 +241,40 @@ PostEffectsMgr::presentationBackBuffer()
 void 
 PostEffectsMgr::render(const Camera* camera) const
 {
+    CTR_PROFILE_SCOPE("PostEffectsMgr::render");
+
     Ctr::DrawMode drawMode = _deviceInterface->getDrawMode ();
     _deviceInterface->setDrawMode (Ctr::Filled);
     uint32_t i = 0;
+
+    // The policy renders in pass 0, effect i in pass i + 1 and the sync to
+    // the back buffer reads the last output in the pass after that. Every
+    // output lives from the pass that writes it to the pass that reads it.
+    {
+        _targetPool.begin();
+        _activePolicy->declareTargets(_targetPool, 0);
+        RenderTargetPool::Handle source = _activePolicy->targetHandle();
+
+        uint32_t pass = 1;
+        for (; pass <= _postEffects.size(); pass++)
+        {
+            PostEffect* postEffect = _postEffects[pass-1];
+            _targetPool.use(source, pass);
+            postEffect->declareTargets(_targetPool, pass);
+            if (postEffect->targetHandle() != RenderTargetPool::InvalidHandle)
+                source = postEffect->targetHandle();
+        }
+        _targetPool.use(source, pass);
+
+        _targetPool.compile();
+        _activePolicy->bindTargets(_targetPool);
+        for (i = 0; i < _postEffects.size(); i++)
+        {
+            _postEffects[i]->bindTargets(_targetPool);
+        }
+        i = 0;
+    }
+
     _activePolicy->prepareForBackBuffer(camera);
     
     //if (_usingPostEffects)
@@ -251,6 +291,13 @@ PostEffectsMgr::render(const Camera* camera) const
             {
                 swapChain = _postEffects[i]->texture();
             }
+            else if (_postEffects[i]->texture() && swapChain)
+            {
+                // Pass the input through so later effects read the output
+                // the lifetimes were computed for.
+                _deviceInterface->blitSurfaces(_postEffects[i]->texture()->surface(), swapChain->surface());
+                swapChain = _postEffects[i]->texture();
+            }
         }
         _deviceInterface->enableDepthWrite();
     }
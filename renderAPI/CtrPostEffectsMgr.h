@@ -43,6 +43,7 @@
 
 #include <CtrPlatform.h>
 #include <CtrFrameBuffer.h>
+#include <CtrRenderTargetPool.h>
 #include <CtrVector2.h>
 #include <CtrVector3.h>
 #include <CtrVector4.h>
@@ -144,6 +145,11 @@ class PostEffectsMgr
 
     const FrameBuffer&          sceneFrameBuffer() const;
 
+    //-----------------------------------------------
+    // Transient targets shared by the effect chain.
+    //-----------------------------------------------
+    const RenderTargetPool&     targetPool() const;
+
   protected:
     typedef std::map <PostEffectPresentationPolicy, 
                       PresentationPolicy*>       PresentationPolicyMap;
@@ -173,6 +179,8 @@ class PostEffectsMgr
     PresentationPolicyMap        _presentationPolicies;
 
     Ctr::IDevice*                 _deviceInterface;
+
+    mutable RenderTargetPool     _targetPool;
 };
 }
 
@@ -209,6 +209,12 @@ enum TextureType
     StagingFromFile
 };
 
+enum IndexFormat
+{
+    INDEX16 = 0,
+    INDEX32
+};
+
 enum DeclarationMethod
 {
     METHOD_DEFAULT = 0,
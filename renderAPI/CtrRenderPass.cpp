@@ -64,6 +64,7 @@
 #include <CtrRenderTargetQuad.h>
 #include <CtrViewport.h>
 #include <CtrPostEffectsMgr.h>
+#include <CtrFrustum.h>
 
 namespace Ctr
 {
@@ -71,8 +72,14 @@ RenderPass::RenderPass(Ctr::IDevice* device) :
     Ctr::Node (std::string("RenderPass")),
     IRenderResource (device),
     _cullMode (Ctr::CCW),
-    _enabled (true)
+    _enabled (true),
+    _frustumCulling (true),
+    _meshesSubmitted (0),
+    _meshesCulled (0),
+    _instancer (device),
+    _lodPixelError (1.0f)
 {
+    memset(&_lodStats, 0, sizeof(LodStats));
 }
 
 RenderPass::~RenderPass()
@@ -89,19 +96,109 @@ void
 RenderPass::renderMeshes(const std::string& passName, const Ctr::Scene* scene)
 {
     const std::vector<Ctr::Mesh*>& meshes = scene->meshesForPass(passName);
-    for (auto it = meshes.begin(); it != meshes.end(); it++)
+    const Ctr::Camera* camera = scene->camera();
+
+    _meshesSubmitted = 0;
+    _meshesCulled = 0;
+    _visibleMeshes.clear();
+    memset(&_lodStats, 0, sizeof(LodStats));
+
+    if (_frustumCulling)
+    {
+        // Cull against the cached transforms, as these are what the shaders bind.
+        Frustum frustum(camera->cameraTransformCache()->viewProjMatrix());
+        scene->cullMeshesForPass(passName, frustum, _visibleMeshes);
+    }
+    else
+    {
+        _visibleMeshes.resize(meshes.size());
+        for (uint32_t meshId = 0; meshId < (uint32_t)meshes.size(); meshId++)
+            _visibleMeshes[meshId] = meshId;
+    }
+    _meshesCulled = (uint32_t)(meshes.size() - _visibleMeshes.size());
+
+    // Meshes sharing geometry and material collapse into instanced draws, 
+    // then sort by state so consecutive draws can share technique and 
+    // material binds.
+    _renderQueue.clear();
+    _instancer.clear();
+    // Sized against the viewport of the bound target, which is not the
+    // backbuffer for probe faces, shadow maps and the like.
+    const CameraTransformCache& transforms = *camera->cameraTransformCache();
+    Ctr::Viewport viewport;
+    _deviceInterface->getViewport(&viewport);
+    float pixelScale = transforms.projMatrix()[1][1] * viewport._height * 0.5f;
+    for (auto it = _visibleMeshes.begin(); it != _visibleMeshes.end(); it++)
     {
-        const Ctr::Mesh* mesh = (*it);
-        const Ctr::Material* material = mesh->material();
-        const Ctr::IShader* shader = material->shader();
-        const Ctr::GpuTechnique* technique = material->technique();
-    
-        RenderRequest renderRequest (technique, scene, scene->camera(), mesh);
+        const Ctr::Mesh* mesh = meshes[*it];
         if (mesh->visible())
         {
-            shader->renderMesh(renderRequest);
+            const Ctr::Material* material = mesh->material();
+            RenderRequest request(material->technique(), scene, camera, mesh);
+            request.lod = selectLod(mesh, transforms, pixelScale);
+
+            _lodStats.meshes[std::min(request.lod, uint32_t(LodStats::Levels - 1))]++;
+            _lodStats.triangles += mesh->lodPrimitiveCount(request.lod);
+            _lodStats.fullTriangles += mesh->lodPrimitiveCount(0);
+
+            if (!_instancer.add(request))
+                _renderQueue.add(request);
         }
     }
+    _instancer.build(_renderQueue);
+    _renderQueue.sort();
+    _renderQueue.submit(_deviceInterface);
+    _meshesSubmitted = _renderQueue.stats().draws + 
+                       _instancer.stats().instancedMeshes - _instancer.stats().batches;
 }
 
-}
\ No newline at end of file
+uint32_t
+RenderPass::selectLod(const Ctr::Mesh* mesh, 
+                      const CameraTransformCache& transforms,
+                      float pixelScale) const
+{
+    uint32_t lodCount = mesh->lodCount();
+    if (lodCount <= 1 || _lodPixelError <= 0.0f || !mesh->hasBounds())
+        return 0;
+
+    // World bounding sphere: the local sphere moved by the world transform
+    // and grown by its largest axis scale. Object space errors grow by the
+    // same scale.
+    const Matrix44f& world = mesh->worldTransform();
+    const Region3f& localBounds = mesh->localBounds();
+    Vector3f localCenter = (localBounds.minExtent + localBounds.maxExtent) * 0.5f;
+    float localRadius = (localBounds.maxExtent - localBounds.minExtent).length() * 0.5f;
+
+    Vector3f center;
+    float scaleSquared = 0.0f;
+    for (uint32_t j = 0; j < 3; j++)
+    {
+        center[j] = world[3][j];
+        float axisSquared = 0.0f;
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            center[j] += localCenter[i] * world[i][j];
+            axisSquared += world[j][i] * world[j][i];
+        }
+        scaleSquared = std::max(scaleSquared, axisSquared);
+    }
+    float scale = sqrtf(scaleSquared);
+    float radius = localRadius * scale;
+
+    // Measured at the nearest point of the sphere, inside it draw level 0.
+    float distance = (center - transforms.cameraLocation()).length() - radius;
+    if (distance <= transforms.zNear() || radius <= 0.0f)
+        return 0;
+
+    float pixelsPerUnit = pixelScale * scale / distance;
+    uint32_t lod = 0;
+    for (uint32_t level = 1; level < lodCount; level++)
+    {
+        if (mesh->lodError(level) * pixelsPerUnit > _lodPixelError)
+            break;
+        lod = level;
+    }
+    return lod;
+}
+
+}
@@ -46,11 +46,15 @@
 #include <CtrTypedProperty.h>
 #include <CtrRenderEnums.h>
 #include <CtrIRenderResource.h>
+#include <CtrRenderQueue.h>
+#include <CtrMeshInstancer.h>
 
 namespace Ctr
 {
 class Scene;
 class IDevice;
+class Mesh;
+class CameraTransformCache;
 
 enum TransformSpace
 {
@@ -82,11 +86,57 @@ class RenderPass : public IRenderResource, public Ctr::Node
     void                       renderMeshes(const std::string& passName, 
                                             const Ctr::Scene* scene);
 
+    void                       setFrustumCulling(bool frustumCulling) {
+                                   _frustumCulling = frustumCulling;
+    }
+    bool                       frustumCulling() const {
+                                   return _frustumCulling;
+    }
+
+    // Meshes with a level of detail chain draw their coarsest level whose
+    // error projects to at most this many pixels. 0 always draws level 0.
+    void                       setLodPixelError(float pixels) {
+                                   _lodPixelError = pixels;
+    }
+    float                      lodPixelError() const {
+                                   return _lodPixelError;
+    }
+
+    struct LodStats
+    {
+        enum { Levels = 8 };
+        // Meshes drawn at each level, coarser ones count in the last.
+        uint32_t               meshes[Levels];
+        uint32_t               triangles;
+        // Triangles of the same meshes at level 0.
+        uint32_t               fullTriangles;
+    };
+
+    // Counters for the last renderMeshes call.
+    uint32_t                   meshesSubmitted() const { return _meshesSubmitted; }
+    uint32_t                   meshesCulled() const { return _meshesCulled; }
+    const RenderQueue::Stats&  renderQueueStats() const { return _renderQueue.stats(); }
+    const MeshInstancer::Stats& instancerStats() const { return _instancer.stats(); }
+    const LodStats&            lodStats() const { return _lodStats; }
+
   protected:
+    // pixelScale is the height in pixels of one world unit at a view
+    // distance of one.
+    uint32_t                   selectLod(const Ctr::Mesh* mesh, 
+                                         const CameraTransformCache& transforms,
+                                         float pixelScale) const;
 
     Ctr::CullMode               _cullMode;
     bool                       _enabled;
     std::string                _passName;
+    bool                       _frustumCulling;
+    uint32_t                   _meshesSubmitted;
+    uint32_t                   _meshesCulled;
+    std::vector<uint32_t>      _visibleMeshes;
+    RenderQueue                _renderQueue;
+    MeshInstancer              _instancer;
+    float                      _lodPixelError;
+    LodStats                   _lodStats;
 };
 
 }
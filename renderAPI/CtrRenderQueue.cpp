@@ -0,0 +1,358 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+#include <CtrRenderQueue.h>
+#include <CtrIShader.h>
+#include <CtrMaterial.h>
+#include <CtrMesh.h>
+#include <CtrCamera.h>
+#include <CtrIDevice.h>
+#include <CtrICommandList.h>
+#include <CtrParallel.h>
+#include <thread>
+
+namespace Ctr
+{
+namespace
+{
+const uint32_t LayerBits     = 4;
+const uint32_t ShaderBits    = 12;
+const uint32_t TechniqueBits = 8;
+const uint32_t MaterialBits  = 16;
+const uint32_t DepthBits     = 24;
+
+const uint32_t DepthShift     = 0;
+const uint32_t MaterialShift  = DepthShift + DepthBits;
+const uint32_t TechniqueShift = MaterialShift + MaterialBits;
+const uint32_t ShaderShift    = TechniqueShift + TechniqueBits;
+const uint32_t LayerShift     = ShaderShift + ShaderBits;
+
+inline uint64_t
+field(uint32_t value, uint32_t bits, uint32_t shift)
+{
+    return (uint64_t(value) & ((uint64_t(1) << bits) - 1)) << shift;
+}
+
+// Below this a command list costs more to record and execute than it saves.
+const size_t MinDrawsPerList = 64;
+}
+
+RenderQueue::RenderQueue()
+{
+    memset(&_stats, 0, sizeof(Stats));
+}
+
+RenderQueue::~RenderQueue()
+{
+    for (size_t listId = 0; listId < _commandLists.size(); listId++)
+    {
+        safedelete(_commandLists[listId]);
+    }
+}
+
+void
+RenderQueue::clear()
+{
+    _requests.clear();
+    _keys.clear();
+    _order.clear();
+    _shaderIds.clear();
+    _techniqueIds.clear();
+    _materialIds.clear();
+}
+
+size_t
+RenderQueue::size() const
+{
+    return _requests.size();
+}
+
+const RenderQueue::Stats&
+RenderQueue::stats() const
+{
+    return _stats;
+}
+
+uint64_t
+RenderQueue::makeKey(uint32_t layer, 
+                     uint32_t shaderId, 
+                     uint32_t techniqueId, 
+                     uint32_t materialId, 
+                     uint32_t depth)
+{
+    return field(layer, LayerBits, LayerShift) |
+           field(shaderId, ShaderBits, ShaderShift) |
+           field(techniqueId, TechniqueBits, TechniqueShift) |
+           field(materialId, MaterialBits, MaterialShift) |
+           field(depth, DepthBits, DepthShift);
+}
+
+uint32_t
+RenderQueue::denseId(std::map<const void*, uint32_t>& ids, const void* object)
+{
+    auto it = ids.find(object);
+    if (it != ids.end())
+    {
+        return it->second;
+    }
+    uint32_t id = (uint32_t)ids.size();
+    ids.insert(std::make_pair(object, id));
+    return id;
+}
+
+uint32_t
+RenderQueue::quantizedDepth(const RenderRequest& request) const
+{
+    if (!request.camera)
+    {
+        return 0;
+    }
+
+    const CameraTransformCachePtr& ctc = request.camera->cameraTransformCache();
+    const Matrix44f& view = ctc->viewMatrix();
+
+    Vector3f center;
+    if (request.mesh->hasBounds())
+    {
+        const Region3f& bounds = request.mesh->worldBounds();
+        center = (bounds.minExtent + bounds.maxExtent) * 0.5f;
+    }
+    else
+    {
+        center = request.mesh->worldTranslation();
+    }
+
+    float viewZ = center.x * view[0][2] + center.y * view[1][2] + center.z * view[2][2] + view[3][2];
+    float zNear = ctc->zNear();
+    float range = ctc->zFar() - zNear;
+    float t = range > 0 ? (viewZ - zNear) / range : 0.0f;
+    t = std::min(std::max(t, 0.0f), 1.0f);
+    return (uint32_t)(t * float((1 << DepthBits) - 1));
+}
+
+void
+RenderQueue::add(const RenderRequest& request, uint32_t layer)
+{
+    const Material* material = request.material;
+    const IShader* shader = material ? material->shader() : nullptr;
+
+    uint64_t key = makeKey(layer,
+                           denseId(_shaderIds, shader),
+                           denseId(_techniqueIds, request.technique),
+                           denseId(_materialIds, material),
+                           quantizedDepth(request));
+
+    _order.push_back((uint32_t)_requests.size());
+    _requests.push_back(request);
+    _keys.push_back(key);
+}
+
+void
+RenderQueue::sort()
+{
+    if (_keys.size() > 1)
+    {
+        radixSort();
+    }
+}
+
+void
+RenderQueue::radixSort()
+{
+    // LSD radix sort on 8 bit digits. Stable, so equal keys keep queue order.
+    size_t count = _keys.size();
+    _scratchKeys.resize(count);
+    _scratchOrder.resize(count);
+
+    for (uint32_t shift = 0; shift < 64; shift += 8)
+    {
+        size_t histogram[256];
+        memset(histogram, 0, sizeof(histogram));
+        for (size_t i = 0; i < count; i++)
+        {
+            histogram[(_keys[i] >> shift) & 0xff]++;
+        }
+
+        // Every key shares this digit, nothing to do.
+        if (histogram[(_keys[0] >> shift) & 0xff] == count)
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (uint32_t digit = 0; digit < 256; digit++)
+        {
+            size_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t slot = histogram[(_keys[i] >> shift) & 0xff]++;
+            _scratchKeys[slot] = _keys[i];
+            _scratchOrder[slot] = _order[i];
+        }
+        _keys.swap(_scratchKeys);
+        _order.swap(_scratchOrder);
+    }
+}
+
+void
+RenderQueue::submit()
+{
+    memset(&_stats, 0, sizeof(Stats));
+    submit(0, _order.size(), _stats);
+}
+
+void
+RenderQueue::submit(IDevice* device)
+{
+    const size_t drawCount = _order.size();
+    uint32_t threadCount = device->commandListCount();
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t listCount = std::min(size_t(threadCount), drawCount / MinDrawsPerList);
+
+    while (listCount > 1 && _commandLists.size() < listCount)
+    {
+        ICommandList* commandList = device->createCommandList();
+        if (!commandList)
+        {
+            break;
+        }
+        _commandLists.push_back(commandList);
+    }
+    listCount = std::min(listCount, _commandLists.size());
+
+    for (size_t listId = 0; listId < listCount; listId++)
+    {
+        if (!_commandLists[listId]->begin())
+        {
+            listCount = 0;
+        }
+    }
+    if (listCount <= 1)
+    {
+        submit();
+        return;
+    }
+
+    _commandListStats.resize(listCount);
+    Ctr::parallelFor(size_t(0), listCount, [&](size_t listId)
+    {
+        ICommandList* commandList = _commandLists[listId];
+        Stats& stats = _commandListStats[listId];
+        memset(&stats, 0, sizeof(Stats));
+
+        commandList->record([&]()
+        {
+            submit(drawCount * listId / listCount, 
+                   drawCount * (listId + 1) / listCount, 
+                   stats);
+        });
+        commandList->end();
+    });
+
+    memset(&_stats, 0, sizeof(Stats));
+    for (size_t listId = 0; listId < listCount; listId++)
+    {
+        _commandLists[listId]->execute();
+
+        const Stats& stats = _commandListStats[listId];
+        _stats.draws += stats.draws;
+        _stats.shaderChanges += stats.shaderChanges;
+        _stats.techniqueBinds += stats.techniqueBinds;
+        _stats.techniqueBindsSaved += stats.techniqueBindsSaved;
+        _stats.materialBinds += stats.materialBinds;
+        _stats.materialBindsSaved += stats.materialBindsSaved;
+    }
+    _stats.commandLists = uint32_t(listCount);
+}
+
+void
+RenderQueue::submit(size_t first, size_t last, Stats& stats) const
+{
+    const IShader* boundShader = nullptr;
+    const GpuTechnique* boundTechnique = nullptr;
+    const Material* boundMaterial = nullptr;
+
+    for (size_t i = first; i < last; i++)
+    {
+        const RenderRequest& request = _requests[_order[i]];
+        const IShader* shader = request.material ? request.material->shader() : nullptr;
+        if (!shader)
+        {
+            continue;
+        }
+
+        uint32_t bindFlags = 0;
+        if (shader != boundShader || request.technique != boundTechnique)
+        {
+            stats.shaderChanges += shader != boundShader ? 1 : 0;
+            bindFlags = BindAllParameters;
+        }
+        else if (request.material != boundMaterial)
+        {
+            bindFlags = BindMaterialParameters;
+        }
+
+        if (bindFlags & BindTechniqueParameters)
+            stats.techniqueBinds++;
+        else
+            stats.techniqueBindsSaved++;
+
+        if (bindFlags & BindMaterialParameters)
+            stats.materialBinds++;
+        else
+            stats.materialBindsSaved++;
+
+        shader->renderQueuedMesh(request, bindFlags);
+        stats.draws++;
+
+        boundShader = shader;
+        boundTechnique = request.technique;
+        boundMaterial = request.material;
+    }
+}
+
+}
@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+#ifndef INCLUDED_CRT_RENDER_QUEUE
+#define INCLUDED_CRT_RENDER_QUEUE
+
+#include <CtrPlatform.h>
+#include <CtrRenderRequest.h>
+
+namespace Ctr
+{
+class IShader;
+class IDevice;
+class ICommandList;
+
+//--------------------------------------------------------------------
+//
+// RenderQueue
+//
+// Collects RenderRequests for a pass and sorts them on a 64 bit key
+// so that meshes sharing a shader, technique and material are drawn
+// together, front to back within each state group:
+//
+//   | layer 4 | shader 12 | technique 8 | material 16 | depth 24 |
+//
+// Shader, technique and material ids are dense per queue build. If a
+// field overflows the ids alias, which only costs grouping; redundant
+// bind detection always compares the actual objects.
+//
+//--------------------------------------------------------------------
+class RenderQueue
+{
+  public:
+    struct Stats
+    {
+        uint32_t               draws;
+        uint32_t               shaderChanges;
+        uint32_t               techniqueBinds;
+        uint32_t               techniqueBindsSaved;
+        uint32_t               materialBinds;
+        uint32_t               materialBindsSaved;
+        // Lists recorded by the last parallel submit.
+        uint32_t               commandLists;
+    };
+
+    RenderQueue();
+    ~RenderQueue();
+
+    void                       clear();
+    // Layer is the most significant sort field, e.g. a pass or sub pass id.
+    void                       add(const RenderRequest& request, uint32_t layer = 0);
+    void                       sort();
+    // Draws the queue in key order, skipping redundant technique and material binds.
+    void                       submit();
+    // Same, but large queues are split into ranges recorded into the
+    // device's command lists on worker threads, then executed in order.
+    void                       submit(IDevice* device);
+
+    size_t                     size() const;
+    const Stats&               stats() const;
+
+    static uint64_t            makeKey(uint32_t layer, 
+                                       uint32_t shaderId, 
+                                       uint32_t techniqueId, 
+                                       uint32_t materialId,
+                                       uint32_t depth);
+
+  private:
+    uint32_t                   denseId(std::map<const void*, uint32_t>& ids, 
+                                       const void* object);
+    uint32_t                   quantizedDepth(const RenderRequest& request) const;
+    void                       radixSort();
+    // Draws the sorted requests [first, last). The first draw binds
+    // all of its parameters, so ranges may be recorded separately.
+    void                       submit(size_t first, size_t last, Stats& stats) const;
+
+    std::vector<RenderRequest> _requests;
+    std::vector<uint64_t>      _keys;
+    std::vector<uint32_t>      _order;
+    std::vector<uint64_t>      _scratchKeys;
+    std::vector<uint32_t>      _scratchOrder;
+
+    std::map<const void*, uint32_t> _shaderIds;
+    std::map<const void*, uint32_t> _techniqueIds;
+    std::map<const void*, uint32_t> _materialIds;
+
+    std::vector<ICommandList*> _commandLists;
+    std::vector<Stats>         _commandListStats;
+
+    Stats                      _stats;
+};
+
+}
+
+#endif
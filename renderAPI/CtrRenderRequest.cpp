@@ -43,7 +43,11 @@
 
 namespace Ctr
 {
-RenderRequest::RenderRequest()
+RenderRequest::RenderRequest() :
+    instanceBuffer (nullptr),
+    instanceOffset (0),
+    instanceCount (0),
+    lod (0)
 {
 }
 
@@ -51,7 +55,11 @@ RenderRequest::RenderRequest(const Ctr::GpuTechnique* techniqueIn, const Ctr::Sc
     technique(techniqueIn),
     scene (scene),
     camera(cameraIn),
-    mesh (meshIn)
+    mesh (meshIn),
+    instanceBuffer (nullptr),
+    instanceOffset (0),
+    instanceCount (0),
+    lod (0)
 {
     material = meshIn->material();
 }
@@ -50,6 +50,7 @@ class Scene;
 class Camera;
 class Mesh;
 class Material;
+class IGpuBuffer;
 
 class 
 RenderRequest 
@@ -64,6 +65,15 @@ RenderRequest
     const Ctr::Material*     material;
     const Ctr::Scene*        scene;
 
+    // Set for instanced draws: instanceCount world matrices, four float4
+    // rows each, starting at matrix instanceOffset of instanceBuffer.
+    const Ctr::IGpuBuffer*   instanceBuffer;
+    uint32_t                 instanceOffset;
+    uint32_t                 instanceCount;
+
+    // Level of detail to draw, see Mesh::lodCount.
+    uint32_t                 lod;
+
 };
 
 }
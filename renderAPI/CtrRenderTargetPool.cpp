@@ -0,0 +1,272 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrRenderTargetPool.h>
+#include <CtrIDevice.h>
+#include <CtrITexture.h>
+#include <CtrIRenderResourceParameters.h>
+#include <CtrLog.h>
+
+namespace Ctr
+{
+RenderTargetPool::Description::Description(PixelFormat formatValue,
+                                           uint32_t widthValue,
+                                           uint32_t heightValue,
+                                           uint32_t sampleCountValue) :
+    format(formatValue),
+    width(widthValue),
+    height(heightValue),
+    sampleCount(sampleCountValue)
+{
+}
+
+bool
+RenderTargetPool::Description::operator == (const Description& other) const
+{
+    return format == other.format &&
+           width == other.width &&
+           height == other.height &&
+           sampleCount == other.sampleCount;
+}
+
+RenderTargetPool::RenderTargetPool(IDevice* device) :
+    _device(device),
+    _createdCount(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+    free();
+}
+
+void
+RenderTargetPool::free()
+{
+    for (size_t i = 0; i < _textures.size(); i++)
+    {
+        _device->destroyResource(_textures[i].texture);
+    }
+    _textures.clear();
+    _targets.clear();
+}
+
+void
+RenderTargetPool::begin()
+{
+    _targets.clear();
+}
+
+RenderTargetPool::Handle
+RenderTargetPool::declare(const std::string& name, const Description& description)
+{
+    Target target;
+    target.name = name;
+    target.description = description;
+    target.firstPass = UINT32_MAX;
+    target.lastPass = 0;
+    target.texture = SIZE_MAX;
+    _targets.push_back(target);
+    return Handle(_targets.size() - 1);
+}
+
+void
+RenderTargetPool::use(Handle handle, uint32_t pass)
+{
+    if (handle >= _targets.size())
+        return;
+
+    Target& target = _targets[handle];
+    target.firstPass = std::min(target.firstPass, pass);
+    target.lastPass = std::max(target.lastPass, pass);
+}
+
+bool
+RenderTargetPool::compile()
+{
+    for (size_t i = 0; i < _textures.size(); i++)
+    {
+        _textures[i].used = false;
+    }
+
+    // Placing targets in order of their first pass packs each
+    // description into the fewest textures.
+    std::vector<Handle> order;
+    for (Handle i = 0; i < _targets.size(); i++)
+    {
+        if (_targets[i].firstPass != UINT32_MAX)
+            order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](Handle a, Handle b)
+    {
+        return _targets[a].firstPass < _targets[b].firstPass;
+    });
+
+    bool result = true;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        Target& target = _targets[order[i]];
+
+        size_t slot = SIZE_MAX;
+        for (size_t j = 0; j < _textures.size(); j++)
+        {
+            const PooledTexture& pooled = _textures[j];
+            if (pooled.description == target.description &&
+                (!pooled.used || pooled.busyUntil < target.firstPass))
+            {
+                slot = j;
+                break;
+            }
+        }
+
+        if (slot == SIZE_MAX)
+        {
+            std::ostringstream name;
+            name << "Transient Target " << _createdCount++;
+
+            TextureParameters textureData(name.str(),
+                                          Ctr::TextureImagePtr(),
+                                          Ctr::TwoD,
+                                          Ctr::RenderTarget,
+                                          target.description.format,
+                                          Ctr::Vector3i(target.description.width, target.description.height, 1),
+                                          false, 1, target.description.sampleCount);
+
+            PooledTexture pooled;
+            pooled.description = target.description;
+            pooled.texture = _device->createTexture(&textureData);
+            if (!pooled.texture)
+            {
+                LOG_CRITICAL("Failed to create render target for " << target.name);
+                result = false;
+                continue;
+            }
+            pooled.bytes = pooled.texture->byteSize() * std::max(1, pooled.texture->multiSampleCount());
+            pooled.used = false;
+            pooled.busyUntil = 0;
+            _textures.push_back(pooled);
+            slot = _textures.size() - 1;
+        }
+
+        _textures[slot].used = true;
+        _textures[slot].busyUntil = target.lastPass;
+        target.texture = slot;
+    }
+
+    // Textures the frame no longer asks for, for example after the
+    // effect chain or the back buffer size changed.
+    std::vector<size_t> remap(_textures.size(), SIZE_MAX);
+    std::vector<PooledTexture> kept;
+    for (size_t i = 0; i < _textures.size(); i++)
+    {
+        if (_textures[i].used)
+        {
+            remap[i] = kept.size();
+            kept.push_back(_textures[i]);
+        }
+        else
+        {
+            _device->destroyResource(_textures[i].texture);
+        }
+    }
+    _textures.swap(kept);
+
+    Stats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.targets = uint32_t(order.size());
+    stats.textures = uint32_t(_textures.size());
+
+    uint32_t lastPass = 0;
+    for (size_t i = 0; i < _targets.size(); i++)
+    {
+        Target& target = _targets[i];
+        if (target.texture == SIZE_MAX)
+            continue;
+        target.texture = remap[target.texture];
+        stats.unaliasedBytes += _textures[target.texture].bytes;
+        lastPass = std::max(lastPass, target.lastPass);
+    }
+    for (size_t i = 0; i < _textures.size(); i++)
+    {
+        stats.aliasedBytes += _textures[i].bytes;
+    }
+    for (uint32_t pass = 0; pass <= lastPass && !_targets.empty(); pass++)
+    {
+        size_t liveBytes = 0;
+        for (size_t i = 0; i < _targets.size(); i++)
+        {
+            const Target& target = _targets[i];
+            if (target.texture != SIZE_MAX && target.firstPass <= pass && pass <= target.lastPass)
+                liveBytes += _textures[target.texture].bytes;
+        }
+        stats.livePeakBytes = std::max(stats.livePeakBytes, liveBytes);
+    }
+
+    if (stats.targets != _stats.targets ||
+        stats.textures != _stats.textures ||
+        stats.aliasedBytes != _stats.aliasedBytes)
+    {
+        LOG("Render targets: " << stats.targets << " targets in " << stats.textures << " textures, " 
+            << stats.unaliasedBytes / (1024 * 1024) << " MB unaliased, " 
+            << stats.aliasedBytes / (1024 * 1024) << " MB aliased, " 
+            << stats.livePeakBytes / (1024 * 1024) << " MB live peak");
+    }
+    _stats = stats;
+
+    return result;
+}
+
+ITexture*
+RenderTargetPool::texture(Handle handle) const
+{
+    if (handle >= _targets.size() || _targets[handle].texture == SIZE_MAX)
+        return nullptr;
+    return _textures[_targets[handle].texture].texture;
+}
+
+const RenderTargetPool::Stats&
+RenderTargetPool::stats() const
+{
+    return _stats;
+}
+
+}
@@ -0,0 +1,145 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_RENDER_TARGET_POOL
+#define INCLUDED_CRT_RENDER_TARGET_POOL
+
+#include <CtrPlatform.h>
+#include <CtrPixelFormat.h>
+#include <CtrRenderEnums.h>
+
+namespace Ctr
+{
+class IDevice;
+class ITexture;
+
+//------------------------------------------------------------------
+// Transient render targets for one frame. Passes declare the
+// targets they render to and read from in execution order, and
+// compile() works out the first and last pass that uses each one.
+// Targets whose lifetimes do not overlap and that share a size,
+// format and sample count are given the same texture. Textures
+// are kept across frames and released once a frame stops asking
+// for them.
+//------------------------------------------------------------------
+class RenderTargetPool
+{
+  public:
+    typedef uint32_t           Handle;
+    static const Handle        InvalidHandle = UINT32_MAX;
+
+    struct Description
+    {
+        Description(PixelFormat format = PF_A8R8G8B8,
+                    uint32_t width = MIRROR_BACK_BUFFER,
+                    uint32_t height = MIRROR_BACK_BUFFER,
+                    uint32_t sampleCount = 1);
+
+        bool                   operator == (const Description& other) const;
+
+        PixelFormat            format;
+        // May be one of the MIRROR_BACK_BUFFER sizes.
+        uint32_t               width;
+        uint32_t               height;
+        uint32_t               sampleCount;
+    };
+
+    // Counters for the last compiled frame.
+    struct Stats
+    {
+        uint32_t               targets;
+        uint32_t               textures;
+        // Every target in a texture of its own.
+        size_t                 unaliasedBytes;
+        size_t                 aliasedBytes;
+        // Most target memory live in any one pass.
+        size_t                 livePeakBytes;
+    };
+
+    RenderTargetPool(IDevice* device);
+    ~RenderTargetPool();
+
+    // Forgets the targets declared for the previous frame.
+    void                       begin();
+
+    Handle                     declare(const std::string& name, const Description& description);
+    void                       use(Handle target, uint32_t pass);
+
+    // Assigns textures, creating them as needed.
+    bool                       compile();
+
+    // Valid after compile(), nullptr for targets no pass used.
+    ITexture*                  texture(Handle target) const;
+
+    const Stats&               stats() const;
+
+    // Destroys every pooled texture.
+    void                       free();
+
+  private:
+    struct Target
+    {
+        std::string            name;
+        Description            description;
+        uint32_t               firstPass;
+        uint32_t               lastPass;
+        size_t                 texture;
+    };
+
+    struct PooledTexture
+    {
+        Description            description;
+        ITexture*              texture;
+        size_t                 bytes;
+        bool                   used;
+        // Last pass of the latest target placed in it.
+        uint32_t               busyUntil;
+    };
+
+    IDevice*                   _device;
+    std::vector<Target>        _targets;
+    std::vector<PooledTexture> _textures;
+    uint32_t                   _createdCount;
+    Stats                      _stats;
+};
+}
+
+#endif
@@ -93,9 +93,10 @@ ScreenOrientedQuad::initialize (const Ctr::Region2f& screenLocation, bool backgr
     Vector2f tpos[] = {Vector2f(0, 1), Vector2f(0, 0), 
                            Vector2f(1, 1), Vector2f(1, 0) };    
 
+    VertexDeclarationParameters vertexDeclarationParameters(vertexElements);
     if (IVertexDeclaration* vertexDeclaration =
         Ctr::VertexDeclarationMgr::vertexDeclarationMgr()->createVertexDeclaration
-        (&VertexDeclarationParameters(vertexElements)))
+        (&vertexDeclarationParameters))
     {
         setVertexDeclaration (vertexDeclaration);
         _positionStream = new Ctr::VertexStream
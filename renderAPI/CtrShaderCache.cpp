@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrShaderCache.h>
+#include <CtrLog.h>
+#include <atomic>
+
+#if _WIN32 || _WIN64
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace Ctr
+{
+namespace
+{
+// Kept outside data/shadersD3D11 so cache writes don't wake the shader watcher.
+const char*    CacheDirectory = "data/shaderCacheD3D11";
+// Bump when the entry layout or anything feeding the key changes.
+const uint32_t CacheVersion = 1;
+const uint32_t CacheMagic = 'C' | ('S' << 8) | ('H' << 16) | ('C' << 24);
+
+struct CacheEntryHeader
+{
+    uint32_t   magic;
+    uint32_t   version;
+    uint64_t   size;
+};
+
+void
+createCacheDirectory()
+{
+#if _WIN32 || _WIN64
+    _mkdir(CacheDirectory);
+#else
+    mkdir(CacheDirectory, 0755);
+#endif
+}
+
+std::atomic<uint32_t> temporaryFileIndex(0);
+}
+
+bool ShaderCache::_enabled = true;
+
+Hash
+ShaderCache::key(const std::string& preprocessedSource,
+                 const std::map<std::string, std::string>& defines,
+                 const std::string& entryPoint,
+                 const std::string& profile,
+                 uint32_t flags)
+{
+    std::ostringstream options;
+    options << CacheVersion << "|" << entryPoint << "|" << profile << "|" << flags;
+    for (auto it = defines.begin(); it != defines.end(); it++)
+    {
+        options << "|" << it->first << "=" << it->second;
+    }
+
+    Hash hash(preprocessedSource);
+    hash.append(Hash(options.str()));
+    return hash;
+}
+
+std::string
+ShaderCache::filePathName(const Hash& key)
+{
+    return std::string(CacheDirectory) + "/" + key.hexString() + ".bin";
+}
+
+bool
+ShaderCache::load(const Hash& key, std::vector<char>& bytecode)
+{
+    if (!_enabled)
+        return false;
+
+    std::ifstream file(filePathName(key).c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+        return false;
+
+    CacheEntryHeader header;
+    if (!file.read((char*)&header, sizeof(header)) ||
+        header.magic != CacheMagic ||
+        header.version != CacheVersion ||
+        header.size == 0)
+    {
+        return false;
+    }
+
+    bytecode.resize((size_t)header.size);
+    if (!file.read(&bytecode[0], bytecode.size()))
+    {
+        // Truncated entry, recompile.
+        bytecode.clear();
+        return false;
+    }
+    return true;
+}
+
+bool
+ShaderCache::store(const Hash& key, const void* bytecode, size_t size)
+{
+    if (!_enabled || size == 0)
+        return false;
+
+    createCacheDirectory();
+
+    // Write beside the entry and rename, so a concurrent load never sees a partial file.
+    const std::string entryPathName = filePathName(key);
+    std::ostringstream temporaryPathName;
+    temporaryPathName << entryPathName << "." << temporaryFileIndex.fetch_add(1) << ".tmp";
+    {
+        std::ofstream file(temporaryPathName.str().c_str(), std::ios::out | std::ios::binary);
+        if (!file)
+        {
+            LOG("Cannot write shader cache entry " << entryPathName);
+            return false;
+        }
+
+        CacheEntryHeader header = { CacheMagic, CacheVersion, (uint64_t)size };
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)bytecode, size);
+        if (!file)
+        {
+            file.close();
+            remove(temporaryPathName.str().c_str());
+            return false;
+        }
+    }
+
+    if (rename(temporaryPathName.str().c_str(), entryPathName.c_str()) != 0)
+    {
+        // Another thread stored the same key first.
+        remove(temporaryPathName.str().c_str());
+    }
+    return true;
+}
+
+void
+ShaderCache::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+bool
+ShaderCache::enabled()
+{
+    return _enabled;
+}
+}
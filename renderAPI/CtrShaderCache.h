@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_SHADER_CACHE
+#define INCLUDED_CRT_SHADER_CACHE
+
+#include <CtrPlatform.h>
+#include <CtrHash.h>
+
+namespace Ctr
+{
+//-----------------------------------------------------------
+// class ShaderCache
+// On disk cache of compiled shader bytecode. Entries are
+// keyed by a hash of the preprocessed source, so edits to any
+// include invalidate them, along with the defines, entry
+// point, profile and compile flags. Safe to call from the
+// parallel recompile in ShaderMgr::update.
+//-----------------------------------------------------------
+class ShaderCache
+{
+  public:
+    static Hash                key(const std::string& preprocessedSource,
+                                   const std::map<std::string, std::string>& defines,
+                                   const std::string& entryPoint,
+                                   const std::string& profile,
+                                   uint32_t flags);
+
+    static bool                load(const Hash& key, std::vector<char>& bytecode);
+    static bool                store(const Hash& key, const void* bytecode, size_t size);
+
+    static std::string         filePathName(const Hash& key);
+
+    static void                setEnabled(bool enabled);
+    static bool                enabled();
+
+  private:
+    static bool                _enabled;
+};
+}
+
+#endif
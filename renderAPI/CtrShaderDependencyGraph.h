@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_SHADER_DEPENDENCY_GRAPH
+#define INCLUDED_CRT_SHADER_DEPENDENCY_GRAPH
+
+#include <CtrPlatform.h>
+
+namespace Ctr
+{
+//-----------------------------------------------------------
+// Maps every file a shader read while compiling (its source,
+// its include file and the transitive #include set) back to
+// the shaders that depend on it, so a changed file only
+// reloads its dependents.
+//-----------------------------------------------------------
+template <typename T>
+class ShaderDependencyGraph
+{
+  public:
+    // Replaces the recorded dependencies of shader.
+    void                       update(T* shader, const std::set<std::string>& files)
+    {
+        remove(shader);
+        for (auto it = files.begin(); it != files.end(); it++)
+        {
+            _dependents[*it].insert(shader);
+        }
+        _files[shader] = files;
+    }
+
+    void                       remove(T* shader)
+    {
+        auto files = _files.find(shader);
+        if (files == _files.end())
+            return;
+
+        for (auto it = files->second.begin(); it != files->second.end(); it++)
+        {
+            auto dependents = _dependents.find(*it);
+            if (dependents != _dependents.end())
+            {
+                dependents->second.erase(shader);
+                if (dependents->second.empty())
+                    _dependents.erase(dependents);
+            }
+        }
+        _files.erase(files);
+    }
+
+    // Adds the shaders depending on filePathName to dependents.
+    void                       collect(const std::string& filePathName, std::set<T*>& dependents) const
+    {
+        auto it = _dependents.find(filePathName);
+        if (it != _dependents.end())
+        {
+            dependents.insert(it->second.begin(), it->second.end());
+        }
+    }
+
+    size_t                     fileCount() const { return _dependents.size(); }
+
+  private:
+    std::map<std::string, std::set<T*> > _dependents;
+    std::map<T*, std::set<std::string> > _files;
+};
+}
+
+#endif
@@ -48,7 +48,10 @@
 #include <CtrAssetManager.h>
 #include <CtrEntity.h>
 #include <CtrFileChangeWatcher.h>
+#if _WIN32 || _WIN64
 #include <direct.h>
+#endif
+#include <CtrParallel.h>
 
 namespace Ctr
 {
@@ -56,8 +59,6 @@ namespace Ctr
 ShaderMgr::ShaderMgr(Ctr::IDevice* device) : 
     _deviceInterface(device)
 {
-    _fileChangeWatcher.reset(new FileChangeWatcher());
-
     // Load the user shader manifest
     std::string filename = "data/ShaderManifest.xml";
     std::unique_ptr<typename pugi::xml_document> doc = 
@@ -142,6 +143,7 @@ ShaderMgr::create()
     for (auto iterator = _shaderList.begin(); iterator != _shaderList.end(); ++iterator)
     {
         (*iterator).second->create();
+        _shaderDependencies.update((*iterator).second, (*iterator).second->dependencies());
     }
     return true;
 }
@@ -160,6 +162,7 @@ ShaderMgr::addShader(const std::string& filename,
         {
             LOG ("Created shader " << filePathName.c_str() << " and adding to shader mgr");
             _shaderList.insert(std::make_pair(Ctr::Hash(filePathName), shader));
+            _shaderDependencies.update(shader, shader->dependencies());
             return true;
         }
         else
@@ -173,70 +176,67 @@ ShaderMgr::addShader(const std::string& filename,
 void
 ShaderMgr::update()
 {
-    if (_fileChangeWatcher->hasChanges())
+    const FileChangeWatcher* fileChangeWatcher = _deviceInterface->fileChangeWatcher();
+    if (!fileChangeWatcher || !fileChangeWatcher->hasChanges())
     {
-        std::set<std::string> changed = _fileChangeWatcher->changeList();
-        for (auto it = changed.begin(); it != changed.end(); it++)
-        {
-            LOG("Detected change: " << *it);
-        }
+        return;
+    }
 
-        for (auto it = _shaderList.begin(); it != _shaderList.end(); it++)
-        {
-            LOG("Have shader " << (*it).second->filePathName());
-            // Shader stores a relative path. We just want to rfind the path
-            // For the moment to detect a modified shader.
-            for (auto cit = changed.begin(); cit != changed.end(); cit++)
-            {
-                // Shader name
-                if ((*cit).rfind((*it).second->filePathName()) != std::string::npos)
-                {
-                    LOG("Reloading " << (*it).second->filePathName());
-                    (*it).second->free();
-                    (*it).second->create();
-                }
-                // Include name
-                else if ((*it).second->includeFilePathName().length() > 0)
-                { 
-                    if ((*cit).rfind((*it).second->includeFilePathName()))
-                    {
-                        (*it).second->free();
-                        (*it).second->create();
-                    }
-                }
-            }
-        }
+    // Only shaders that read a changed file, directly or through an include.
+    std::set<IShader*> shaders;
+    std::set<IComputeShader*> computeShaders;
+    const std::set<std::string>& changed = fileChangeWatcher->changes();
+    for (auto it = changed.begin(); it != changed.end(); it++)
+    {
+        _shaderDependencies.collect(*it, shaders);
+        _computeShaderDependencies.collect(*it, computeShaders);
+    }
+
+    if (shaders.empty() && computeShaders.empty())
+    {
+        return;
+    }
 
-        for (auto it = _computeShaderList.begin(); it != _computeShaderList.end(); it++)
+    // Compile in parallel. Device objects are recreated serially below.
+    std::vector<IShader*> shaderQueue(shaders.begin(), shaders.end());
+    std::vector<IComputeShader*> computeShaderQueue(computeShaders.begin(), computeShaders.end());
+    std::vector<uint8_t> compiled(shaderQueue.size() + computeShaderQueue.size(), 0);
+    Ctr::parallelFor(size_t(0), compiled.size(), [&](size_t i)
+    {
+        if (i < shaderQueue.size())
+            compiled[i] = shaderQueue[i]->compile() ? 1 : 0;
+        else
+            compiled[i] = computeShaderQueue[i - shaderQueue.size()]->compile() ? 1 : 0;
+    });
+
+    for (size_t i = 0; i < shaderQueue.size(); i++)
+    {
+        IShader* shader = shaderQueue[i];
+        // A failed compile keeps the previous effect alive, the error is in the log.
+        if (compiled[i])
         {
-            LOG("Have compute shader " << it->second->filePathName());
-            // ComputeShader stores a relative path. We just want to rfind the path
-            // For the moment to detect a modified shader.
-            for (auto cit = changed.begin(); cit != changed.end(); cit++)
-            {
-                if ((*cit).rfind(it->second->filePathName()) != std::string::npos ||
-                    (*cit).rfind((it)->second->includePathName()) != std::string::npos)
-                {
-                    LOG("Reloading " << it->second->filePathName());
-                    it->second->free();
-                    it->second->create();
-                }
-                else if ((it)->second->includePathName().length() > 0)
-                {
-                    if ((*cit).rfind((it)->second->includePathName()) != std::string::npos)
-                    {
-                        LOG("Reloading " << it->second->filePathName());
-                        it->second->free();
-                        it->second->create();
-                    }
-                }
-            }
+            LOG("Reloading " << shader->filePathName());
+            shader->free();
+            shader->create();
         }
+        _shaderDependencies.update(shader, shader->dependencies());
+    }
 
-        for (auto it = _trackedMeshes.begin(); it != _trackedMeshes.end(); it++)
+    for (size_t i = 0; i < computeShaderQueue.size(); i++)
+    {
+        IComputeShader* shader = computeShaderQueue[i];
+        if (compiled[shaderQueue.size() + i])
         {
-            resolveShaders(*it);
+            LOG("Reloading " << shader->filePathName());
+            shader->free();
+            shader->create();
         }
+        _computeShaderDependencies.update(shader, shader->dependencies());
+    }
+
+    for (auto it = _trackedMeshes.begin(); it != _trackedMeshes.end(); it++)
+    {
+        resolveShaders(*it);
     }
 }
 
@@ -275,6 +275,7 @@ ShaderMgr::addComputeShaderFromFile (const std::string& filename,
             LOG ("Created compute shader " << filePathName.c_str() << " and adding to shader mgr");
             
             _computeShaderList.insert(std::make_pair(stream.str(), shader));            
+            _computeShaderDependencies.update(shader, shader->dependencies());
             shaderOut = shader;
             return true;
         }
@@ -354,6 +355,7 @@ ShaderMgr::addShader(const std::string& filename,
                 // LOG ("Shader created successfully from " << filePathName);
                 // TODO: fix hash!                
                 _shaderList.insert(std::make_pair(Ctr::Hash(filePathName+includeFileName), tshader));
+                _shaderDependencies.update(tshader, tshader->dependencies());
                 shader = tshader;
                 return true;
             }
@@ -386,6 +388,7 @@ ShaderMgr::addShader(const std::string& filename,
                 // LOG ("Shader created successfully from " << filePathName);
                 // TODO: Fix hash!
                 _shaderList.insert(std::make_pair(Ctr::Hash(filePathName), tshader));
+                _shaderDependencies.update(tshader, tshader->dependencies());
 
                 shader = tshader;
                 return true;
@@ -434,6 +437,7 @@ ShaderMgr::addShader(const std::string& filename,
                 // TODO: Fix hash!
 
                 _shaderList.insert(std::make_pair(Ctr::Hash(filePathKeyName), tshader));
+                _shaderDependencies.update(tshader, tshader->dependencies());
                 shader = tshader;
                 return true;
             }
@@ -44,6 +44,7 @@
 
 #include <CtrPlatform.h>
 #include <CtrHash.h>
+#include <CtrShaderDependencyGraph.h>
 
 namespace Ctr
 {
@@ -53,7 +54,6 @@ class IShader;
 class IComputeShader;
 class GpuTechnique;
 class IDevice;
-class FileChangeWatcher;
 class Mesh;
 
 class ShaderMgr
@@ -166,8 +166,11 @@ class ShaderMgr
     ShaderList                 _shaderList;
 
     std::map<std::string, std::string> _shaderNameManifest;
-    std::unique_ptr<FileChangeWatcher> _fileChangeWatcher;
     std::set<Mesh*>                    _trackedMeshes;
+
+    // File -> dependent shaders, refreshed whenever a shader compiles.
+    ShaderDependencyGraph<IShader>        _shaderDependencies;
+    ShaderDependencyGraph<IComputeShader> _computeShaderDependencies;
 };
 }
 
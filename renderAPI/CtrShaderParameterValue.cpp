@@ -44,15 +44,22 @@
 #include <CtrGpuTechnique.h>
 #include <CtrGpuVariable.h>
 #include <CtrIEffect.h>
+#include <CtrCamera.h>
+#include <CtrICommandList.h>
 
 namespace Ctr
 {
+ShaderParameterValue::Stats ShaderParameterValue::_frameStats = { 0, 0, 0 };
+ShaderParameterValue::Stats ShaderParameterValue::_lastFrameStats = { 0, 0, 0 };
+uint32_t ShaderParameterValue::_generation = 0;
+
 ShaderParameterValue::ShaderParameterValue (const GpuVariable* variable, 
                                             Ctr::IEffect*effect) :
 _variable (variable),
 _effect (effect),
 _parameterScope (PerMesh),
-_parameterIndex (0)
+_parameterIndex (0),
+_lastGeneration (0)
 {
 }
 
@@ -61,14 +68,192 @@ ShaderParameterValue::~ShaderParameterValue()
 }
 
 ShaderParameter
-ShaderParameterValue::parameterType()
+ShaderParameterValue::parameterType() const
 {
     return _parameterType;
 }
 
 void
 ShaderParameterValue::unbind() const
-{ _variable->unbind(); }
+{ 
+    _variable->unbind(); 
+    invalidate();
+}
+
+void
+ShaderParameterValue::evaluate (const Ctr::RenderRequest& request) const
+{
+    if (ICommandList* commandList = ICommandList::recording())
+        commandList->parameterStats().evaluated++;
+    else
+        _frameStats.evaluated++;
+    setParam (request);
+}
+
+void
+ShaderParameterValue::invalidate() const
+{
+    if (ICommandList* commandList = ICommandList::recording())
+        commandList->lastValue (this).clear();
+    else
+        _lastValue.clear();
+}
+
+void
+ShaderParameterValue::invalidateAll()
+{
+    _generation++;
+}
+
+uint32_t
+ShaderParameterValue::generation()
+{
+    return _generation;
+}
+
+void
+ShaderParameterValue::skip (uint32_t count)
+{
+    if (ICommandList* commandList = ICommandList::recording())
+        commandList->parameterStats().skipped += count;
+    else
+        _frameStats.skipped += count;
+}
+
+const ShaderParameterValue::Stats&
+ShaderParameterValue::stats()
+{
+    return _lastFrameStats;
+}
+
+void
+ShaderParameterValue::resetStats()
+{
+    _lastFrameStats = _frameStats;
+    memset(&_frameStats, 0, sizeof(Stats));
+}
+
+void
+ShaderParameterValue::addStats (const Stats& stats)
+{
+    _frameStats.evaluated += stats.evaluated;
+    _frameStats.skipped += stats.skipped;
+    _frameStats.unchanged += stats.unchanged;
+}
+
+bool
+ShaderParameterValue::changed (const void* data, size_t size) const
+{
+    if (ICommandList* commandList = ICommandList::recording())
+    {
+        std::vector<uint8_t>& lastValue = commandList->lastValue (this);
+        if (lastValue.size() == size && memcmp(&lastValue[0], data, size) == 0)
+        {
+            commandList->parameterStats().unchanged++;
+            return false;
+        }
+        lastValue.assign ((const uint8_t*)data, (const uint8_t*)data + size);
+        return true;
+    }
+
+    if (_lastGeneration == _generation &&
+        _lastValue.size() == size && memcmp(&_lastValue[0], data, size) == 0)
+    {
+        _frameStats.unchanged++;
+        return false;
+    }
+
+    _lastValue.resize (size);
+    memcpy (&_lastValue[0], data, size);
+    _lastGeneration = _generation;
+    return true;
+}
+
+void
+ShaderParameterValue::setValue (const void* data, uint32_t size) const
+{
+    if (changed (data, size))
+        _variable->set (data, size);
+}
+
+void
+ShaderParameterValue::setMatrix (const float* data) const
+{
+    if (changed (data, sizeof(float) * 16))
+        _variable->setMatrix (data);
+}
+
+void
+ShaderParameterValue::setMatrixArray (const float* data, uint32_t count) const
+{
+    if (changed (data, sizeof(float) * 16 * count))
+        _variable->setMatrixArray (data, count);
+}
+
+void
+ShaderParameterValue::setVector (const float* data) const
+{
+    if (changed (data, sizeof(float) * 4))
+        _variable->setVector (data);
+}
+
+ParameterScopeState::ParameterScopeState()
+{
+    invalidate();
+}
+
+bool
+ParameterScopeState::frameChanged (const Ctr::RenderRequest& request, uint64_t frameIndex)
+{
+    uint32_t generation = ShaderParameterValue::generation();
+    if (frameIndex == _frameIndex && request.scene == _scene && generation == _frameGeneration)
+        return false;
+
+    _frameIndex = frameIndex;
+    _scene = request.scene;
+    _frameGeneration = generation;
+    return true;
+}
+
+bool
+ParameterScopeState::cameraChanged (const Ctr::RenderRequest& request, uint64_t frameIndex)
+{
+    // Camera values also read camera properties, so refresh at least once a frame.
+    const CameraTransformCache* transforms = 
+        request.camera ? request.camera->cameraTransformCache().get() : nullptr;
+    uint32_t revision = transforms ? transforms->revision() : 0;
+
+    uint32_t generation = ShaderParameterValue::generation();
+
+    if (frameIndex == _cameraFrameIndex && 
+        request.camera == _camera &&
+        transforms == _cameraTransforms && 
+        revision == _cameraRevision &&
+        generation == _cameraGeneration)
+    {
+        return false;
+    }
+
+    _cameraFrameIndex = frameIndex;
+    _camera = request.camera;
+    _cameraTransforms = transforms;
+    _cameraRevision = revision;
+    _cameraGeneration = generation;
+    return true;
+}
+
+void
+ParameterScopeState::invalidate()
+{
+    _frameIndex = UINT64_MAX;
+    _scene = nullptr;
+    _cameraFrameIndex = UINT64_MAX;
+    _camera = nullptr;
+    _cameraTransforms = nullptr;
+    _cameraRevision = 0;
+    _frameGeneration = 0;
+    _cameraGeneration = 0;
+}
 
 void
 ShaderParameterValue::setParameterType (ShaderParameter parameterType)
@@ -49,6 +49,8 @@
 namespace Ctr
 {
 class Camera;
+class CameraTransformCache;
+class Scene;
 class Mesh;
 class PostEffect;
 class GpuVariable;
@@ -244,25 +246,66 @@ enum ShaderParameter
     UserAlbedo, 
     UserRM,
     IblOccl,
-    TextureScaleOffset
+    TextureScaleOffset,
+
+    // Vertex compression
+    MeshPositionDecode,
+
+    // Instancing
+    InstanceWorldMatrices,
+    InstanceParameters
 };
 
 enum ParameterScope
 {
+    // Object scope, evaluated for every draw.
     PerMesh,
-    PerTechnique
+    PerTechnique,
+    // Depends only on the request material.
+    PerMaterial,
+    // Depends only on the scene, evaluated once per frame.
+    PerFrame,
+    // Depends only on the request camera, evaluated when the camera changes.
+    PerCamera
 };
 
 class ShaderParameterValue
 {
   public:    
+    // Binding counters for the last completed frame.
+    struct Stats
+    {
+        // setParam calls.
+        uint32_t               evaluated;
+        // Frame and camera scoped values not evaluated as their scope had not changed.
+        uint32_t               skipped;
+        // Evaluated values equal to the last write, GpuVariable::set was not called.
+        uint32_t               unchanged;
+    };
+
     ShaderParameterValue (const GpuVariable* variable, IEffect*effect);
     virtual ~ShaderParameterValue();
 
     virtual void                setParam (const Ctr::RenderRequest& request) const = 0;
 
+    // Counted setParam.
+    void                        evaluate (const Ctr::RenderRequest& request) const;
+    // Forgets the last written value so the next evaluate always writes.
+    void                        invalidate() const;
+    // Same for every value and scope state, once variables were written
+    // outside their change tracking (by an executed command list).
+    static void                 invalidateAll();
+    static uint32_t             generation();
+
+    // Counted against the recording command list, if any.
+    static void                 skip (uint32_t count);
+    static const Stats&         stats();
+    // Called once per frame by IDevice::update.
+    static void                 resetStats();
+    static void                 addStats (const Stats& stats);
+
     uint32_t                    parameterIndex() const {return _parameterIndex;}
-    ShaderParameter                parameterType();
+    ShaderParameter                parameterType() const;
     ParameterScope              parameterScope() const { return _parameterScope; }
     void                        setParameterScope (ParameterScope scope) { _parameterScope = scope; };
     virtual bool                bindsResource() const { return false; }
@@ -274,11 +317,46 @@ class ShaderParameterValue
     void                        setParameterType (ShaderParameter parameterType);    
     void                        setParameterIndex (uint32_t index) { _parameterIndex = index;}
 
+    // Change detected writes to _variable. Textures and buffers are always set.
+    void                        setValue (const void* data, uint32_t size) const;
+    void                        setMatrix (const float* data) const;
+    void                        setMatrixArray (const float* data, uint32_t count) const;
+    void                        setVector (const float* data) const;
+    bool                        changed (const void* data, size_t size) const;
+
     ParameterScope              _parameterScope;
     IEffect*                    _effect;
     const GpuVariable*          _variable;
     ShaderParameter             _parameterType;
     uint32_t                    _parameterIndex;
+    mutable std::vector<uint8_t> _lastValue;
+    mutable uint32_t            _lastGeneration;
+
+    static Stats                _frameStats;
+    static Stats                _lastFrameStats;
+    static uint32_t             _generation;
+};
+
+// What a shader's frame and camera scoped values were last evaluated against.
+class ParameterScopeState
+{
+  public:
+    ParameterScopeState();
+
+    // Both record the new state when they return true.
+    bool                        frameChanged (const Ctr::RenderRequest& request, uint64_t frameIndex);
+    bool                        cameraChanged (const Ctr::RenderRequest& request, uint64_t frameIndex);
+    void                        invalidate();
+
+  private:
+    uint64_t                    _frameIndex;
+    const Scene*                _scene;
+    uint64_t                    _cameraFrameIndex;
+    const Camera*               _camera;
+    const CameraTransformCache* _cameraTransforms;
+    uint32_t                    _cameraRevision;
+    uint32_t                    _frameGeneration;
+    uint32_t                    _cameraGeneration;
 };
 
 }
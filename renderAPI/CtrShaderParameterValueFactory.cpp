@@ -95,7 +95,7 @@ class WorldMatrixValue :  public ShaderParameterValue
     virtual void setParam (const Ctr::RenderRequest& request) const
     {
         Ctr::Matrix44f world = request.mesh->worldTransform();        
-        _variable->setMatrix((const float*)&world);
+        setMatrix ((const float*)&world);
     }
 
     static bool supports (GpuVariable* variable)
@@ -116,7 +116,7 @@ class MeshGroupIdValue :  public ShaderParameterValue
     virtual void setParam (const Ctr::RenderRequest& request) const
     {
         uint32_t groupId = request.mesh->groupId();
-        _variable->set((const uint32_t*)&groupId, sizeof(uint32_t));
+        setValue ((const uint32_t*)&groupId, sizeof(uint32_t));
     }
 
     static bool supports (GpuVariable* variable)
@@ -125,6 +125,78 @@ class MeshGroupIdValue :  public ShaderParameterValue
     }
 };
 
+// float4 [2], offset and scale of quantized positions. Identity for float meshes.
+class MeshPositionDecodeValue :  public ShaderParameterValue
+{
+  public:
+    MeshPositionDecodeValue(const GpuVariable* variable, Ctr::IEffect*effect): 
+        ShaderParameterValue (variable, effect)
+    {
+        setParameterType (MeshPositionDecode);
+    }
+
+    virtual void setParam (const Ctr::RenderRequest& request) const
+    {
+        const Ctr::Vector3f& offset = request.mesh->positionDecodeOffset();
+        const Ctr::Vector3f& scale = request.mesh->positionDecodeScale();
+        float decode[8] = { offset.x, offset.y, offset.z, 0.0f,
+                            scale.x, scale.y, scale.z, 1.0f };
+        setValue (decode, sizeof(decode));
+    }
+
+    static bool supports (GpuVariable* variable)
+    {
+        return _strcmpi((char*)variable->semantic().c_str(), "MESHPOSITIONDECODE")==0;
+    }
+};
+
+// Buffer<float4> of world matrix rows for instanced draws.
+class InstanceWorldMatricesValue :  public ShaderParameterValue
+{
+  public:
+    InstanceWorldMatricesValue(const GpuVariable* variable, Ctr::IEffect*effect): 
+        ShaderParameterValue (variable, effect)
+    {
+        setParameterType (InstanceWorldMatrices);
+    }
+
+    virtual void setParam (const Ctr::RenderRequest& request) const
+    {
+        if (request.instanceBuffer)
+        {
+            _variable->setResource(request.instanceBuffer);
+        }
+    }
+
+    static bool supports (GpuVariable* variable)
+    {
+        return _strcmpi((char*)variable->semantic().c_str(), "INSTANCEWORLDMATRICES")==0;
+    }
+};
+
+// uint2, first matrix and instance count. The count is 0 for draws that
+// are not instanced, which use WORLD.
+class InstanceParametersValue :  public ShaderParameterValue
+{
+  public:
+    InstanceParametersValue(const GpuVariable* variable, Ctr::IEffect*effect): 
+        ShaderParameterValue (variable, effect)
+    {
+        setParameterType (InstanceParameters);
+    }
+
+    virtual void setParam (const Ctr::RenderRequest& request) const
+    {
+        uint32_t parameters[2] = { request.instanceOffset, request.instanceCount };
+        setValue (parameters, sizeof(parameters));
+    }
+
+    static bool supports (GpuVariable* variable)
+    {
+        return _strcmpi((char*)variable->semantic().c_str(), "INSTANCEPARAMETERS")==0;
+    }
+};
+
 class WorldViewProjectionValue :  public ShaderParameterValue
 {
   public:
@@ -142,7 +214,7 @@ class WorldViewProjectionValue :  public ShaderParameterValue
         const Ctr::Matrix44f& viewProj = ctc->viewProjMatrix();
         world = world * viewProj;
 
-        _variable->setMatrix((const float*)&world);
+        setMatrix ((const float*)&world);
     }
 
     static bool supports (GpuVariable* variable)
@@ -157,6 +229,7 @@ public:
     UserAlbedoValue(const GpuVariable* variable, Ctr::IEffect*effect) :
         ShaderParameterValue(variable, effect)
     {
+        setParameterScope(PerMaterial);
         setParameterType(UserAlbedo);
     }
 
@@ -165,7 +238,7 @@ public:
         if (const Material* material = request.material)
         {
             const Vector4f& userAlbedo = material->userAlbedo();
-            _variable->setVector(&userAlbedo.x);
+            setVector (&userAlbedo.x);
         }
     }
 
@@ -181,6 +254,7 @@ public:
     UserRMValue(const GpuVariable* variable, Ctr::IEffect*effect) :
         ShaderParameterValue(variable, effect)
     {
+        setParameterScope(PerMaterial);
         setParameterType(UserRM);
     }
 
@@ -189,7 +263,7 @@ public:
         if (const Material* material = request.material)
         {
             const Vector4f& userRM = material->userRM();
-            _variable->setVector(&userRM.x);
+            setVector (&userRM.x);
         }
     }
 
@@ -206,6 +280,7 @@ public:
     IblOcclValue(const GpuVariable* variable, Ctr::IEffect*effect) :
         ShaderParameterValue(variable, effect)
     {
+        setParameterScope(PerMaterial);
         setParameterType(IblOccl);
     }
 
@@ -214,7 +289,7 @@ public:
         if (const Material* material = request.material)
         {
             const Vector4f& iblOccl = material->iblOccl();
-            _variable->setVector(&iblOccl.x);
+            setVector (&iblOccl.x);
         }
     }
 
@@ -230,6 +305,7 @@ public:
     DetailMapValue(const GpuVariable* variable, Ctr::IEffect*effect) :
         ShaderParameterValue(variable, effect)
     {
+        setParameterScope(PerMaterial);
         setParameterType(DetailMap);
     }
 
@@ -254,6 +330,7 @@ class MaterialDiffuseValue :  public ShaderParameterValue
     MaterialDiffuseValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
+        setParameterScope (PerMaterial);
         setParameterType (MaterialDiffuse);        
     }
 
@@ -261,7 +338,7 @@ class MaterialDiffuseValue :  public ShaderParameterValue
     {
         if (const Material* material = request.material)
         {           
-            _variable->setVector((const float*)&material->albedoColor());
+            setVector ((const float*)&material->albedoColor());
         }
     }
 
@@ -277,6 +354,7 @@ class SpecularIntensityValue : public ShaderParameterValue
     SpecularIntensityValue(const GpuVariable* variable, Ctr::IEffect*effect) :
         ShaderParameterValue(variable, effect)
     {
+        setParameterScope(PerMaterial);
         setParameterType(SpecularIntensity);
     }
 
@@ -285,7 +363,7 @@ class SpecularIntensityValue : public ShaderParameterValue
         if (const Material* material = request.material)
         {
             float specularIntensity = material->specularIntensity();
-            _variable->set(&specularIntensity, sizeof(float));
+            setValue (&specularIntensity, sizeof(float));
         }
     }
 
@@ -301,6 +379,7 @@ class RoughnessScaleValue : public ShaderParameterValue
     RoughnessScaleValue(const GpuVariable* variable, Ctr::IEffect*effect) :
         ShaderParameterValue(variable, effect)
     {
+        setParameterScope(PerMaterial);
         setParameterType(RoughnessScale);
     }
 
@@ -309,7 +388,7 @@ class RoughnessScaleValue : public ShaderParameterValue
         if (const Material* material = request.material)
         {
             float roughnessScale = material->roughnessScale();
-            _variable->set(&roughnessScale, sizeof(float));
+            setValue (&roughnessScale, sizeof(float));
         }
     }
 
@@ -325,6 +404,7 @@ class SpecularWorkflowValue : public ShaderParameterValue
       SpecularWorkflowValue(const GpuVariable* variable, Ctr::IEffect*effect) :
         ShaderParameterValue(variable, effect)
     {
+        setParameterScope(PerMaterial);
         setParameterType(SpecularWorkflowType);
     }
 
@@ -360,7 +440,7 @@ class SpecularWorkflowValue : public ShaderParameterValue
                     break;
                 }
             }
-            _variable->setVector(&specularModifiers.x);
+            setVector (&specularModifiers.x);
         }
     }
 
@@ -377,6 +457,7 @@ class ViewProjectionValue :  public ShaderParameterValue
     ViewProjectionValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
+        setParameterScope (PerCamera);
         setParameterType (ViewProjection);        
     }
 
@@ -384,7 +465,7 @@ class ViewProjectionValue :  public ShaderParameterValue
     {
         const Ctr::CameraTransformCachePtr ctc = request.camera->cameraTransformCache();
         Ctr::Matrix44f viewProj = ctc->viewProjMatrix();
-        _variable->setMatrix((const float*)&viewProj);
+        setMatrix ((const float*)&viewProj);
     }
 
     static bool supports (GpuVariable* variable)
@@ -399,6 +480,7 @@ class ProjectionValue :  public ShaderParameterValue
      ProjectionValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
+        setParameterScope (PerCamera);
         setParameterType (Projection);        
     }
 
@@ -407,7 +489,7 @@ class ProjectionValue :  public ShaderParameterValue
         const Ctr::CameraTransformCachePtr ctc = request.camera->cameraTransformCache();
         const Ctr::Matrix44f& projection = ctc->projMatrix();
 
-        _variable->setMatrix((const float*)&projection);
+        setMatrix ((const float*)&projection);
     }
 
     static bool supports (GpuVariable* variable)
@@ -432,7 +514,7 @@ class ScreenSizeValue :  public ShaderParameterValue
         {
             Ctr::Vector2f screenSize = Ctr::Vector2f ((float)rt->postEffectBounds().size().x, 
                                                       (float)rt->postEffectBounds().size().y);
-            _variable->set ( (const float*)&screenSize, 
+            setValue ( (const float*)&screenSize, 
                                 sizeof(Ctr::Vector2f));        
         }
         else
@@ -454,7 +536,7 @@ class ViewValue :  public ShaderParameterValue
     ViewValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
-        setParameterScope (PerTechnique);
+        setParameterScope (PerCamera);
         setParameterType (View);        
     }
 
@@ -462,7 +544,7 @@ class ViewValue :  public ShaderParameterValue
     {
         const Ctr::CameraTransformCachePtr ctc = request.camera->cameraTransformCache();
         const Ctr::Matrix44f& matrix = ctc->viewMatrix();
-        _variable->setMatrix ((const float*)&matrix);
+        setMatrix ((const float*)&matrix);
     }
 
     static bool supports (GpuVariable* variable)
@@ -477,7 +559,7 @@ class ViewRightValue :  public ShaderParameterValue
     ViewRightValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
-        setParameterScope (PerTechnique);
+        setParameterScope (PerCamera);
         setParameterType (ViewRight);        
     }
 
@@ -489,7 +571,7 @@ class ViewRightValue :  public ShaderParameterValue
 
         Ctr::Vector4f right4(right.x, right.y, right.z, 0.0f);
 
-        _variable->setVector((const float*)&right4);
+        setVector ((const float*)&right4);
     }
 
     static bool supports (GpuVariable* variable)
@@ -504,7 +586,7 @@ class ViewUpValue :  public ShaderParameterValue
     ViewUpValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
-        setParameterScope (PerTechnique);
+        setParameterScope (PerCamera);
         setParameterType (ViewUp);        
     }
 
@@ -518,7 +600,7 @@ class ViewUpValue :  public ShaderParameterValue
 
         Ctr::Vector4f up4(up.x, up.y, up.z, 0.0f);
 
-        _variable->setVector((const float*)&up4);
+        setVector ((const float*)&up4);
     }
 
     static bool supports (GpuVariable* variable)
@@ -533,7 +615,7 @@ class ViewLookAtValue :  public ShaderParameterValue
     ViewLookAtValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
-        setParameterScope (PerTechnique);
+        setParameterScope (PerCamera);
         setParameterType (ViewLookAt);        
     }
 
@@ -541,7 +623,8 @@ class ViewLookAtValue :  public ShaderParameterValue
     {
         const Ctr::Vector3f& forward = request.camera->forward();
         Ctr::Vector3f normalized = forward.normalized();
-        _variable->setVector((const float*)&normalized);
+        Ctr::Vector4f normalized4(normalized.x, normalized.y, normalized.z, 0.0f);
+        setVector ((const float*)&normalized4);
     }
 
     static bool supports (GpuVariable* variable)
@@ -565,7 +648,7 @@ class WorldViewValue :  public ShaderParameterValue
         const Ctr::Matrix44f& matView = ctc->viewMatrix();
 
         Ctr::Matrix44f matrix = request.mesh->worldTransform() * request.camera->viewMatrix();                    
-        _variable->setMatrix((const float*)&matrix);
+        setMatrix ((const float*)&matrix);
     }
 
     static bool supports (GpuVariable* variable)
@@ -580,6 +663,7 @@ class SpecularRMCMapValue :  public ShaderParameterValue
     SpecularRMCMapValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
+        setParameterScope (PerMaterial);
         setParameterType (SpecularRMCMap);        
     }
 
@@ -615,7 +699,7 @@ class RenderDebugTermValue :  public ShaderParameterValue
     RenderDebugTermValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
-        setParameterScope (PerTechnique);
+        setParameterScope (PerMaterial);
         setParameterType (RenderDebugTermOut);        
     }
 
@@ -624,7 +708,7 @@ class RenderDebugTermValue :  public ShaderParameterValue
         if (const Material* material = request.material)
         {
             float debugTerm = (float)material->debugTerm();
-            _variable->set ((const float*)&debugTerm, sizeof (float));
+            setValue ((const float*)&debugTerm, sizeof (float));
         }
     }
 
@@ -641,6 +725,7 @@ class DiffuseMapValue :  public ShaderParameterValue
     DiffuseMapValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
+        setParameterScope (PerMaterial);
         setParameterType (NormalMap);
     }
 
@@ -669,6 +754,7 @@ class NormalMapValue :  public ShaderParameterValue
     NormalMapValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
+        setParameterScope (PerMaterial);
         setParameterType (NormalMap);
     }
 
@@ -697,6 +783,7 @@ class TextureGammaValue :  public ShaderParameterValue
     TextureGammaValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
+        setParameterScope (PerMaterial);
         setParameterType (TextureGamma);        
     }
 
@@ -705,7 +792,7 @@ class TextureGammaValue :  public ShaderParameterValue
         {
             // mdavidson TODO
             float gamma = request.material->textureGamma();
-            _variable->set ((const float*)&gamma, sizeof (float));
+            setValue ((const float*)&gamma, sizeof (float));
         }
     }
 
@@ -722,7 +809,7 @@ class EyeLocationValue :  public ShaderParameterValue
    EyeLocationValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {        
-        setParameterScope (PerMesh);
+        setParameterScope (PerCamera);
         setParameterType (EyeLocation);        
     }
 
@@ -737,7 +824,7 @@ class EyeLocationValue :  public ShaderParameterValue
 
             // Paraboloid direction goes in location
             Ctr::Vector4f eyeLocation (t.x, t.y, t.z, ctc->dpDir());
-            _variable->setVector ((const float*)&eyeLocation.x);
+            setVector ((const float*)&eyeLocation.x);
         }
     }
 
@@ -754,14 +841,14 @@ class CameraZNearValue : public ShaderParameterValue
     CameraZNearValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
-        setParameterScope (PerTechnique);
+        setParameterScope (PerCamera);
         setParameterType (CameraZNear);        
     }
 
     virtual void setParam (const Ctr::RenderRequest& request) const
     {
         float value = request.camera->zNear();
-        _variable->set (&value, sizeof(float));
+        setValue (&value, sizeof(float));
     }
 
     static bool supports (GpuVariable* variable)
@@ -776,14 +863,14 @@ class CameraZFarValue : public ShaderParameterValue
     CameraZFarValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
-        setParameterScope (PerTechnique);
+        setParameterScope (PerCamera);
         setParameterType (CameraZFar);        
     }
 
     virtual void setParam (const Ctr::RenderRequest& request) const
     {
         float value = request.camera->zFar();
-        _variable->set (&value, sizeof(float));
+        setValue (&value, sizeof(float));
     }
 
     static bool supports (GpuVariable* variable)
@@ -804,8 +891,9 @@ class IBLBrdfValue :  public ShaderParameterValue
     
     virtual void setParam (const Ctr::RenderRequest& request) const
     {
+        if (const Ctr::Brdf* brdf = request.scene->activeBrdf())
         {
-            _variable->setTexture(request.scene->activeBrdf()->brdfLut());
+            _variable->setTexture(brdf->brdfLut());
         }
     }
 
@@ -847,7 +935,7 @@ public:
 	CubeViewsValue(const GpuVariable* variable, Ctr::IEffect*effect) :
 		ShaderParameterValue(variable, effect)
 	{
-		setParameterScope(PerTechnique);
+		setParameterScope(PerCamera);
 		setParameterType(CubeViews);
 	}
 
@@ -885,7 +973,7 @@ public:
 		upDirection = Ctr::Vector3f(0.0f, 1.0f, 0.0f);
 		Ctr::viewMatrixLH(eyeLocation, lookDirection, upDirection, &cubeViews[5]);
 
-		_variable->setMatrixArray((const float*)&cubeViews[0], 6);
+		setMatrixArray ((const float*)&cubeViews[0], 6);
 	}
 
 	static bool supports(GpuVariable* variable)
@@ -928,7 +1016,7 @@ class IBLSourceEnvironmentScaleValue :  public ShaderParameterValue
         ShaderParameterValue (variable, effect)
     {
         setParameterType (IBLSourceEnvironmentScale);
-        setParameterScope(PerTechnique);
+        setParameterScope(PerFrame);
     }
 
     virtual void setParam (const Ctr::RenderRequest& request) const
@@ -936,7 +1024,7 @@ class IBLSourceEnvironmentScaleValue :  public ShaderParameterValue
         if (_variable->valueIndex() < request.scene->probes().size())
         {
             float environmentScale = (float)(request.scene->probes()[0]->environmentScale());
-            _variable->set (&environmentScale, sizeof(float));
+            setValue (&environmentScale, sizeof(float));
         }
     }
 
@@ -953,7 +1041,7 @@ class IBLSpecularMipDeltasValue :  public ShaderParameterValue
         ShaderParameterValue (variable, effect)
     {
         setParameterType (IBLSpecularMipDeltas);
-        setParameterScope(PerTechnique);
+        setParameterScope(PerFrame);
     }
 
     virtual void setParam (const Ctr::RenderRequest& request) const
@@ -962,7 +1050,7 @@ class IBLSpecularMipDeltasValue :  public ShaderParameterValue
         {
             float mipCountDelta = (float)(request.scene->probes()[0]->specularCubeMap()->resource()->mipLevels());
             mipCountDelta = Ctr::maxValue((mipCountDelta-request.scene->probes()[0]->mipDrop())-1.0f, 1.0f);
-            _variable->set (&mipCountDelta, sizeof(float));
+            setValue (&mipCountDelta, sizeof(float));
         }
     }
 
@@ -979,7 +1067,7 @@ class IBLSourceMipCountValue :  public ShaderParameterValue
         ShaderParameterValue (variable, effect)
     {
         setParameterType (IBLSourceMipCount);
-        setParameterScope(PerTechnique);
+        setParameterScope(PerFrame);
     }
 
     virtual void setParam (const Ctr::RenderRequest& request) const
@@ -988,7 +1076,7 @@ class IBLSourceMipCountValue :  public ShaderParameterValue
         {
             float mipCountDelta = (float)(request.scene->probes()[0]->environmentCubeMap()->resource()->mipLevels());
             mipCountDelta = Ctr::maxValue(mipCountDelta-1.0f, 1.0f);
-            _variable->set (&mipCountDelta, sizeof(float));
+            setValue (&mipCountDelta, sizeof(float));
         }
     }
 
@@ -1004,7 +1092,7 @@ class IBLCorrectionValue :  public ShaderParameterValue
     IBLCorrectionValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
-        setParameterScope (PerTechnique);
+        setParameterScope (PerFrame);
         setParameterType (IBLCorrection);
     }
 
@@ -1016,7 +1104,7 @@ class IBLCorrectionValue :  public ShaderParameterValue
             // Contrast, Saturation, Hue, placeholder
             Ctr::Vector4f iblCorrection = 
                 Ctr::Vector4f(probe->iblContrast(), probe->iblSaturation(), probe->iblHue(), 1.0f);
-            _variable->setVector ((const float*)&iblCorrection.x);
+            setVector ((const float*)&iblCorrection.x);
         }
     }
 
@@ -1032,7 +1120,7 @@ public:
     TextureScaleOffsetValue(const GpuVariable* variable, Ctr::IEffect*effect) :
         ShaderParameterValue(variable, effect)
     {
-        setParameterScope(PerMesh);
+        setParameterScope(PerMaterial);
         setParameterType(TextureScaleOffset);
     }
 
@@ -1041,7 +1129,7 @@ public:
         if (request.material)
         {
             const Ctr::Vector4f& tso = request.material->textureScaleOffset();
-            _variable->setVector((const float*)&tso.x);
+            setVector ((const float*)&tso.x);
         }
     }
 
@@ -1057,7 +1145,7 @@ class IBLMaxValueValue :  public ShaderParameterValue
     IBLMaxValueValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
-        setParameterScope (PerTechnique);
+        setParameterScope (PerFrame);
         setParameterType (IBLMaxValue);
     }
 
@@ -1069,7 +1157,7 @@ class IBLMaxValueValue :  public ShaderParameterValue
                              request.scene->probes()[0]->maxPixelG(),
                              request.scene->probes()[0]->maxPixelB(),
                              1.0f);
-            _variable->setVector ((const float*)&iblCorrection.x);
+            setVector ((const float*)&iblCorrection.x);
         }
     }
 
@@ -1086,7 +1174,7 @@ class EnvironmentMapValue :  public ShaderParameterValue
         ShaderParameterValue (variable, effect)
     {
         setParameterType (EnvironmentMap);
-        setParameterScope(PerMesh);
+        setParameterScope(PerMaterial);
     }
 
     virtual void setParam (const Ctr::RenderRequest& request) const
@@ -1145,14 +1233,14 @@ class ExposureParameterValue :  public ShaderParameterValue
     ExposureParameterValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
-        setParameterScope (PerTechnique);
+        setParameterScope (PerCamera);
         setParameterType (Exposure);        
     }
 
     virtual void setParam (const Ctr::RenderRequest& request) const
     {
         float value = request.camera->exposureProperty()->get();
-        _variable->set (&value, sizeof(float));
+        setValue (&value, sizeof(float));
     }
 
     static bool supports (GpuVariable* variable)
@@ -1167,14 +1255,14 @@ class GammaParameterValue :  public ShaderParameterValue
     GammaParameterValue (const GpuVariable* variable, Ctr::IEffect*effect) : 
         ShaderParameterValue (variable, effect)
     {
-        setParameterScope (PerTechnique);
+        setParameterScope (PerCamera);
         setParameterType (Gamma);        
     }
 
     virtual void setParam (const Ctr::RenderRequest& request) const
     {
         float value = request.camera->gammaProperty()->get();
-        _variable->set (&value, sizeof(float));
+        setValue (&value, sizeof(float));
     }
 
     static bool supports (GpuVariable* variable)
@@ -1259,7 +1347,7 @@ class TextureInputSizeValue :  public ShaderParameterValue
             if (const ITexture* postProcessTexture = rt->input(_variable->valueIndex()))
             {
                 Ctr::Vector2f size = Ctr::Vector2f((float) postProcessTexture->width(), (float) postProcessTexture->height());
-                _variable->set (&size.x, sizeof (float) * 2);
+                setValue (&size.x, sizeof (float) * 2);
             }
         }
     }
@@ -1292,7 +1380,7 @@ class TextureInputWidthValue :  public ShaderParameterValue
             if (const ITexture* postProcessTexture = rt->input(_variable->valueIndex()))
             {
                 float width = (float) postProcessTexture->width();
-                _variable->set (&width, sizeof (float));
+                setValue (&width, sizeof (float));
             }
         }
     }
@@ -1325,7 +1413,7 @@ class TextureInputHeightValue :  public ShaderParameterValue
             if (const ITexture* postProcessTexture = rt->input(_variable->valueIndex()))
             {
                 float height = (float) postProcessTexture->height();
-                _variable->set (&height, sizeof (float));
+                setValue (&height, sizeof (float));
             }
         }
     }
@@ -1358,7 +1446,7 @@ class TargetTextureSizeValue :  public ShaderParameterValue
             if (const ISurface* surface = rt->texture()->surface())
             {
                 Ctr::Vector2f size = Ctr::Vector2f((float) surface->width(), (float) surface->height());
-                _variable->set (&size.x, sizeof (float) * 2);
+                setValue (&size.x, sizeof (float) * 2);
             }
         }
         else
@@ -1367,7 +1455,7 @@ class TargetTextureSizeValue :  public ShaderParameterValue
             float width = (float)(request.mesh->device()->backbuffer()->width());
             float height = (float)(request.mesh->device()->backbuffer()->height());
             Ctr::Vector2f size (width, height);
-            _variable->set (&size.x, sizeof (float) * 2);
+            setValue (&size.x, sizeof (float) * 2);
         }
     }
 
@@ -1394,14 +1482,14 @@ class TargetTextureWidthValue :  public ShaderParameterValue
             if (const ITexture* postProcessTexture = rt->currentSource())
             {
                 float width = (float) postProcessTexture->width();
-                _variable->set (&width, sizeof (float));
+                setValue (&width, sizeof (float));
             }
         }
         else
         {
             // TODO: Need to access current back buffer.
             float width = (float)(request.mesh->device()->backbuffer()->width());
-            _variable->set (&width, sizeof (float));
+            setValue (&width, sizeof (float));
         }
     }
 
@@ -1427,14 +1515,14 @@ class TargetTextureHeightValue :  public ShaderParameterValue
             if (const ITexture* postProcessTexture = rt->currentSource())
             {
                 float height = (float)postProcessTexture->height();
-                _variable->set (&height, sizeof (float));
+                setValue (&height, sizeof (float));
             }
         }
         else
         {
             // TODO: Need to access current back buffer.
             float height = (float)(request.mesh->device()->backbuffer()->height());
-            _variable->set (&height, sizeof (float));
+            setValue (&height, sizeof (float));
         }
     }
 
@@ -1458,7 +1546,7 @@ class BackBufferWidthValue :  public ShaderParameterValue
         {
             // TODO: Need to access current back buffer.
             uint32_t width = (uint32_t)(request.mesh->device()->backbuffer()->width());
-            _variable->set (&width, sizeof (uint32_t));
+            setValue (&width, sizeof (uint32_t));
         }
     }
 
@@ -1482,7 +1570,7 @@ class BackBufferHeightValue :  public ShaderParameterValue
         {
             // TODO: Need to access current back buffer.
             uint32_t height = (uint32_t)(request.mesh->device()->backbuffer()->height());
-            _variable->set (&height, sizeof (uint32_t));
+            setValue (&height, sizeof (uint32_t));
         }
     }
 
@@ -1622,6 +1710,9 @@ ShaderParameterValueFactory::createShaderParameterValue (Ctr::IDevice* device,
         _parameters.insert (new ShaderParameterFactory <CameraZNearValue>());
         _parameters.insert (new ShaderParameterFactory <CameraZFarValue>());
         _parameters.insert (new ShaderParameterFactory <MeshGroupIdValue>());
+        _parameters.insert (new ShaderParameterFactory <MeshPositionDecodeValue>());
+        _parameters.insert (new ShaderParameterFactory <InstanceWorldMatricesValue>());
+        _parameters.insert (new ShaderParameterFactory <InstanceParametersValue>());
         _parameters.insert (new ShaderParameterFactory <BackBufferWidthValue>());
         _parameters.insert (new ShaderParameterFactory <BackBufferHeightValue>());
         _parameters.insert (new ShaderParameterFactory <IBLDiffuseProbeMapValue>());
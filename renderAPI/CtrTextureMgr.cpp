@@ -50,7 +50,10 @@
 #include <CtrTextureImage.h>
 #include <CtrApplication.h>
 #include <CtrStringUtilities.h>
+#include <CtrProfiler.h>
+#if _WIN32 || _WIN64
 #include <direct.h>
+#endif
 
 namespace Ctr
 {
@@ -73,6 +76,7 @@ TextureMgr::loadImage(const std::string& filePathName,
     }
     else
     {
+        CTR_PROFILE_SCOPE("TextureMgr::loadImage");
         image.reset(new Ctr::TextureImage());
         image->load(filePathName.c_str(), std::string(), archiveHash);
         if (image->valid())
@@ -44,6 +44,7 @@
 #include <CtrIVertexDeclaration.h>
 #include <CtrFormatConversionD3D11.h>
 #include <CtrLog.h>
+#include <CtrCommandListD3D11.h>
 
 namespace Ctr
 {
@@ -349,6 +350,18 @@ BufferD3D11::lock()
 {
     D3D11_MAPPED_SUBRESOURCE mappedResource;
 
+    // Deferred contexts only map with discard, which this always does.
+    if (Ctr::CommandListD3D11* commandList = Ctr::CommandListD3D11::recording())
+    {
+        if (SUCCEEDED(commandList->context()->Map (_buffer, 0, 
+                                                   D3D11_MAP_WRITE_DISCARD, 0, 
+                                                   &mappedResource)))
+        {
+            return mappedResource.pData;
+        }
+        return 0;
+    }
+
     if (SUCCEEDED(_immediateCtx->Map (_buffer, 0, 
                                       D3D11_MAP_WRITE_DISCARD, 0, 
                                       &mappedResource)))
@@ -363,6 +376,12 @@ BufferD3D11::lock()
 bool
 BufferD3D11::unlock()
 {
+    if (Ctr::CommandListD3D11* commandList = Ctr::CommandListD3D11::recording())
+    {
+        commandList->context()->Unmap(_buffer, 0);
+        return true;
+    }
+
     _immediateCtx->Unmap(_buffer, 0);
     _locked = false;
     return true;
@@ -0,0 +1,259 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrCommandListD3D11.h>
+#include <CtrLog.h>
+
+namespace Ctr
+{
+const CommandListD3D11* CommandListD3D11::_appliedList = nullptr;
+
+CommandListD3D11::CommandListD3D11 (Ctr::DeviceD3D11* device) :
+    Ctr::ICommandList (device),
+    _deviceD3D11 (device),
+    _context (nullptr),
+    _commandList (nullptr),
+    _rasterState (nullptr)
+{
+    memset (&_rasterStateDesc, 0, sizeof (_rasterStateDesc));
+    ID3D11Device* direct3d = *_deviceD3D11;
+    if (FAILED(direct3d->CreateDeferredContext (0, &_context)))
+    {
+        LOG ("Failed to create deferred context");
+    }
+}
+
+CommandListD3D11::~CommandListD3D11()
+{
+    {
+        std::lock_guard<std::mutex> lock (effectMutex());
+        if (_appliedList == this)
+        {
+            _appliedList = nullptr;
+        }
+    }
+    saferelease (_commandList);
+    saferelease (_rasterState);
+    saferelease (_context);
+}
+
+bool
+CommandListD3D11::begin()
+{
+    if (!_context)
+        return false;
+
+    saferelease (_commandList);
+    saferelease (_rasterState);
+    _bindings.clear();
+    if (!Ctr::ICommandList::begin())
+        return false;
+
+    _rasterStateDesc = _deviceD3D11->rasterStateDesc();
+    _deviceD3D11->applyState (_context);
+    return true;
+}
+
+bool
+CommandListD3D11::end()
+{
+    saferelease (_commandList);
+    if (FAILED(_context->FinishCommandList (FALSE, &_commandList)))
+    {
+        LOG ("Failed to finish command list");
+        return false;
+    }
+    return Ctr::ICommandList::end();
+}
+
+void
+CommandListD3D11::setCullMode (Ctr::CullMode cullMode)
+{
+    Ctr::ICommandList::setCullMode (cullMode);
+    switch (cullMode)
+    {
+        case Ctr::CCW:
+            _rasterStateDesc.CullMode = D3D11_CULL_FRONT;
+            break;
+        case Ctr::CW:
+            _rasterStateDesc.CullMode = D3D11_CULL_BACK;
+            break;
+        case Ctr::CullNone:
+            _rasterStateDesc.CullMode = D3D11_CULL_NONE;
+            break;
+        default:
+            break;
+    }
+
+    // The device is free threaded, and returns the same object for
+    // an equal description.
+    saferelease (_rasterState);
+    ID3D11Device* direct3d = *_deviceD3D11;
+    direct3d->CreateRasterizerState (&_rasterStateDesc, &_rasterState);
+    _context->RSSetState (_rasterState);
+}
+
+CommandListD3D11::Binding&
+CommandListD3D11::binding (ID3DX11EffectVariable* variable, BindingType type)
+{
+    Binding& binding = _bindings[variable];
+    binding.type = type;
+    binding.count = 0;
+    binding.resourceView = nullptr;
+    binding.unorderedView = nullptr;
+    binding.dirty = true;
+    return binding;
+}
+
+void
+CommandListD3D11::setValue (ID3DX11EffectVariable* variable,
+                            BindingType type,
+                            const void* value,
+                            uint32_t size,
+                            uint32_t count)
+{
+    Binding& valueBinding = binding (variable, type);
+    valueBinding.value.assign ((const uint8_t*)value, (const uint8_t*)value + size);
+    valueBinding.count = count;
+}
+
+void
+CommandListD3D11::setResource (ID3DX11EffectVariable* variable,
+                               ID3D11ShaderResourceView* resourceView)
+{
+    binding (variable, ShaderResource).resourceView = resourceView;
+}
+
+void
+CommandListD3D11::setUnorderedResource (ID3DX11EffectVariable* variable,
+                                        ID3D11UnorderedAccessView* unorderedView)
+{
+    binding (variable, UnorderedResource).unorderedView = unorderedView;
+}
+
+void
+CommandListD3D11::applyPass (ID3DX11EffectPass* pass)
+{
+    std::lock_guard<std::mutex> lock (effectMutex());
+
+    // Another list may have set the same variables since this one applied.
+    bool applyAll = _appliedList != this;
+    for (auto it = _bindings.begin(); it != _bindings.end(); it++)
+    {
+        Binding& binding = it->second;
+        if (!applyAll && !binding.dirty)
+            continue;
+
+        ID3DX11EffectVariable* variable = it->first;
+        float* value = binding.value.empty() ? nullptr : (float*)&binding.value[0];
+        switch (binding.type)
+        {
+            case RawValue:
+                variable->SetRawValue (value, 0, uint32_t(binding.value.size()));
+                break;
+            case MatrixValue:
+                variable->AsMatrix()->SetMatrix (value);
+                break;
+            case MatrixArrayValue:
+                variable->AsMatrix()->SetMatrixArray (value, 0, binding.count);
+                break;
+            case VectorValue:
+                variable->AsVector()->SetFloatVector (value);
+                break;
+            case VectorArrayValue:
+                variable->AsVector()->SetFloatVectorArray (value, 0, binding.count);
+                break;
+            case FloatArrayValue:
+                variable->AsScalar()->SetFloatArray (value, 0, binding.count);
+                break;
+            case ShaderResource:
+                variable->AsShaderResource()->SetResource (binding.resourceView);
+                break;
+            case UnorderedResource:
+                variable->AsUnorderedAccessView()->SetUnorderedAccessView (binding.unorderedView);
+                break;
+        }
+        binding.dirty = false;
+    }
+    _appliedList = this;
+
+    pass->Apply (0, _context);
+}
+
+ID3D11DeviceContext*
+CommandListD3D11::context() const
+{
+    return _context;
+}
+
+CommandListD3D11*
+CommandListD3D11::recording()
+{
+    return dynamic_cast<CommandListD3D11*>(Ctr::ICommandList::recording());
+}
+
+ID3D11DeviceContext*
+CommandListD3D11::context (ID3D11DeviceContext* immediateCtx)
+{
+    if (CommandListD3D11* commandList = recording())
+    {
+        return commandList->context();
+    }
+    return immediateCtx;
+}
+
+bool
+CommandListD3D11::executeRecorded()
+{
+    if (!_commandList)
+        return false;
+
+    ID3D11DeviceContext* immediateCtx = _deviceD3D11->immediateCtx();
+    immediateCtx->ExecuteCommandList (_commandList, FALSE);
+    saferelease (_commandList);
+
+    // Not restoring in ExecuteCommandList leaves the immediate context 
+    // cleared, and the device knows what to put back.
+    _deviceD3D11->applyState (immediateCtx);
+    return true;
+}
+
+}
@@ -0,0 +1,137 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_COMMAND_LIST_D3D11
+#define INCLUDED_COMMAND_LIST_D3D11
+
+#include <CtrPlatform.h>
+#include <CtrICommandList.h>
+#include <CtrRenderDeviceD3D11.h>
+
+namespace Ctr
+{
+//------------------------------------------------------------------------
+// Records into a deferred context and executes it on the immediate one
+// with ExecuteCommandList. The context starts from the device's raster,
+// depth, blend, viewport and target state, and the immediate context
+// gets that state back once the list executes.
+//
+// Effect variables are shared by every list, so values set on variables
+// outside constant buffer shadows are kept here and set on the effect
+// just before each pass is applied, with effectMutex held. Only changed
+// values are set again unless another list applied in between. A list
+// starts with none, so a draw must set what it reads through its own
+// shader parameters.
+//------------------------------------------------------------------------
+class CommandListD3D11 : public Ctr::ICommandList
+{
+  public:
+    enum BindingType
+    {
+        RawValue,
+        MatrixValue,
+        MatrixArrayValue,
+        VectorValue,
+        VectorArrayValue,
+        FloatArrayValue,
+        ShaderResource,
+        UnorderedResource
+    };
+
+    CommandListD3D11 (Ctr::DeviceD3D11* device);
+    virtual ~CommandListD3D11();
+
+    virtual bool                begin();
+    virtual bool                end();
+
+    // Recording thread.
+    virtual void                setCullMode (Ctr::CullMode cullMode);
+    void                        setValue (ID3DX11EffectVariable* variable,
+                                          BindingType type,
+                                          const void* value,
+                                          uint32_t size,
+                                          uint32_t count);
+    void                        setResource (ID3DX11EffectVariable* variable,
+                                             ID3D11ShaderResourceView* resourceView);
+    void                        setUnorderedResource (ID3DX11EffectVariable* variable,
+                                                      ID3D11UnorderedAccessView* unorderedView);
+    void                        applyPass (ID3DX11EffectPass* pass);
+
+    ID3D11DeviceContext*        context() const;
+
+    static CommandListD3D11*    recording();
+
+    //-------------------------------------------------------------
+    // The deferred context of the list the calling thread records
+    // into, otherwise immediateCtx.
+    //-------------------------------------------------------------
+    static ID3D11DeviceContext* context (ID3D11DeviceContext* immediateCtx);
+
+  protected:
+    virtual bool                executeRecorded();
+
+  private:
+    struct Binding
+    {
+        BindingType                type;
+        std::vector<uint8_t>       value;
+        uint32_t                   count;
+        ID3D11ShaderResourceView*  resourceView;
+        ID3D11UnorderedAccessView* unorderedView;
+        bool                       dirty;
+    };
+
+    Binding&                    binding (ID3DX11EffectVariable* variable, BindingType type);
+
+    Ctr::DeviceD3D11*           _deviceD3D11;
+    ID3D11DeviceContext*        _context;
+    ID3D11CommandList*          _commandList;
+    D3D11_RASTERIZER_DESC       _rasterStateDesc;
+    ID3D11RasterizerState*      _rasterState;
+    std::map<ID3DX11EffectVariable*, Binding> _bindings;
+
+    // List whose bindings the effect variables hold, guarded by effectMutex.
+    static const CommandListD3D11* _appliedList;
+};
+
+}
+
+#endif
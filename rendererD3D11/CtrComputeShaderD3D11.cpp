@@ -46,6 +46,8 @@
 #include <CtrTexture2DD3D11.h>
 #include <CtrAssetManager.h>
 #include <CtrLog.h>
+#include <CtrShaderIncludeD3D11.h>
+#include <CtrShaderCache.h>
 #include <D3Dcompiler.h> 
 
 namespace Ctr
@@ -128,17 +130,32 @@ ComputeShaderD3D11::~ComputeShaderD3D11()
 bool
 ComputeShaderD3D11::create() 
 { 
-    D3D10_SHADER_MACRO* definesPtr = nullptr;
-    if (_defines.size() > 0)
-        &_defines[0];
+    // ShaderMgr compiles changed shaders ahead of time, in parallel.
+    if (_pendingBytecode.empty() && !compile())
+    {
+        return false;
+    }
+
+    std::vector<char> bytecode;
+    bytecode.swap(_pendingBytecode);
+    if (SUCCEEDED(_direct3d->CreateComputeShader(&bytecode[0], bytecode.size(), nullptr, &_computeShader)))
+    {
+        return true;
+    }
+    return false;
+}
 
+bool
+ComputeShaderD3D11::compile()
+{
+    _pendingBytecode.clear();
 
     std::string includeStream;
     if (_includeFilePathName.length() > 0)
     {
         LOG("Loading compute include " << _includeFilePathName);
-        if (std::unique_ptr<typename DataStream> fileStream =
-            std::unique_ptr<typename DataStream>(AssetManager::assetManager()->openStream(_includeFilePathName)))
+        if (std::unique_ptr<DataStream> fileStream =
+            std::unique_ptr<DataStream>(AssetManager::assetManager()->openStream(_includeFilePathName)))
         {
             size_t bufferSize = fileStream->size();
             char* stringBuffer = new char[bufferSize + 1];
@@ -149,13 +166,14 @@ ComputeShaderD3D11::create()
         }
     }
 
-    std::string shaderStream;
+    // Shaders created from a stream keep the stream they were given.
     if (filePathName().length() > 0)
     {
         LOG("Loading compute shader " << filePathName());
 
-        if (std::unique_ptr<typename DataStream> fileStream =
-            std::unique_ptr<typename DataStream>(AssetManager::assetManager()->openStream(filePathName())))
+        std::string shaderStream;
+        if (std::unique_ptr<DataStream> fileStream =
+            std::unique_ptr<DataStream>(AssetManager::assetManager()->openStream(filePathName())))
         {
             size_t bufferSize = fileStream->size();
             char* stringBuffer = new char[bufferSize + 1];
@@ -164,18 +182,53 @@ ComputeShaderD3D11::create()
             shaderStream = std::string(stringBuffer);
             safedeletearray(stringBuffer);
         }
+        _stream = includeStream + "\n" + shaderStream;
     }
-
-    _stream = includeStream + "\n" + shaderStream;
-
     _hash.build(_stream);
-    if (ID3DBlob* compiledShader = compileShaderFromStream(_stream.c_str(), _functionName.c_str(), "cs_5_0", definesPtr))
+
+    _dependencies.clear();
+    if (_filePathName.length() > 0)
+        _dependencies.insert(ShaderIncludeD3D11::normalize(_filePathName));
+    if (_includeFilePathName.length() > 0)
+        _dependencies.insert(ShaderIncludeD3D11::normalize(_includeFilePathName));
+
+    // Defines are applied here, so the expanded source alone keys the cache.
+    ShaderIncludeD3D11 includeHandler(_filePathName);
+    ID3D10Blob* preprocessed = nullptr;
+    ID3D10Blob* errors = nullptr;
+    HRESULT result = D3DPreprocess(_stream.c_str(), _stream.size(), _filePathName.c_str(),
+                                   _defines.size() > 0 ? &_defines[0] : nullptr,
+                                   &includeHandler, &preprocessed, &errors);
+    _dependencies.insert(includeHandler.files().begin(), includeHandler.files().end());
+    if (FAILED(result))
     {
-        if (SUCCEEDED(_direct3d->CreateComputeShader(compiledShader->GetBufferPointer(),
-            compiledShader->GetBufferSize(), nullptr, &_computeShader)))
+        if (errors)
         {
-            return true;
+            LOG("Failed to preprocess " << _filePathName << " "
+                << std::string((const char*)errors->GetBufferPointer(), errors->GetBufferSize()));
         }
+        saferelease(errors);
+        return false;
+    }
+    saferelease(errors);
+
+    std::string preprocessedStream((const char*)preprocessed->GetBufferPointer(), preprocessed->GetBufferSize());
+    saferelease(preprocessed);
+
+    Hash cacheKey = ShaderCache::key(preprocessedStream, _defineValues, _functionName, "cs_5_0", 0);
+    if (ShaderCache::load(cacheKey, _pendingBytecode))
+    {
+        return true;
+    }
+
+    if (ID3DBlob* compiledShader = compileShaderFromStream(preprocessedStream.c_str(), _functionName.c_str(), "cs_5_0", nullptr))
+    {
+        const char* bytecode = (const char*)compiledShader->GetBufferPointer();
+        _pendingBytecode.assign(bytecode, bytecode + compiledShader->GetBufferSize());
+        saferelease(compiledShader);
+
+        ShaderCache::store(cacheKey, &_pendingBytecode[0], _pendingBytecode.size());
+        return true;
     }
     return false;
 }
@@ -209,9 +262,11 @@ ComputeShaderD3D11::includePathName() const
 D3D10_SHADER_MACRO*
 ComputeShaderD3D11::setupDefines(const std::map<std::string, std::string> & defines)
 {
-    if (defines.size() > 0)
+    _defines.clear();
+    _defineValues = defines;
+    if (_defineValues.size() > 0)
     {
-        for (auto it = defines.begin(); it != defines.end(); it++)
+        for (auto it = _defineValues.begin(); it != _defineValues.end(); it++)
         {
             D3D10_SHADER_MACRO macro = { (*it).first.c_str(), (*it).second.c_str() };
             _defines.push_back(macro);
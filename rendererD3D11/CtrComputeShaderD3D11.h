@@ -78,6 +78,9 @@ class ComputeShaderD3D11 : public Ctr::IComputeShader
     virtual bool                free();
     virtual bool                cache();
 
+    // Preprocesses and compiles, or loads from the ShaderCache. No device calls.
+    virtual bool                compile();
+
     virtual const std::string&  filePathName() const;
     virtual const std::string&  includePathName() const;
 
@@ -89,6 +92,10 @@ class ComputeShaderD3D11 : public Ctr::IComputeShader
     ID3D11SamplerState*         _pointSampler;
     Ctr::IGpuBuffer*             _constantBuffer;
     std::vector<D3D10_SHADER_MACRO> _defines;
+    // Owns the strings _defines points at.
+    std::map<std::string, std::string> _defineValues;
+    // Bytecode from compile() waiting for the next create().
+    std::vector<char>           _pendingBytecode;
 
     std::string                 _filePathName;
     std::string                 _stream;
@@ -51,8 +51,8 @@
 
 namespace Ctr
 {
-ConstantBufferD3D11::ConstantBufferD3D11() :
-GpuConstantBuffer (0),
+ConstantBufferD3D11::ConstantBufferD3D11(Ctr::IDevice* device) :
+GpuConstantBuffer (device),
 _handle(nullptr),
 _name(""),
 _semantic(""),
@@ -130,6 +130,12 @@ ConstantBufferD3D11::initialize (Ctr::IEffect* effectInterface, const int& index
     _name = std::string (_parameterDescription.Name);
     _effect = effectInterface;
 
+    // Texture buffers are left to the effect.
+    if (_variableDesc.Type == D3D10_SVT_CBUFFER)
+    {
+        initializeShadow (_variableDesc.UnpackedSize);
+    }
+
     return true;
 }
 
@@ -162,6 +168,10 @@ ConstantBufferD3D11::setConstantBuffer (const Ctr::IGpuBuffer* buffer) const
 {
     if (buffer)
     {
+        // The caller owns the contents from here on.
+        _shadow.clear();
+        _dirtyBegin = _dirtyEnd = 0;
+
        if (ID3DX11EffectConstantBuffer* resourceVariable = _handle)
        {
            ID3D11Buffer * constantBuffer = ((const Ctr::BufferD3D11*)buffer)->buffer();
@@ -178,5 +188,19 @@ ConstantBufferD3D11::setConstantBuffer (const Ctr::IGpuBuffer* buffer) const
     }
 }
 
+void
+ConstantBufferD3D11::bindShadowBuffer (const Ctr::IGpuBuffer* buffer) const
+{
+    // The effect stops updating its own copy once a buffer is set.
+    if (ID3DX11EffectConstantBuffer* resourceVariable = _handle)
+    {
+        ID3D11Buffer * constantBuffer = ((const Ctr::BufferD3D11*)buffer)->buffer();
+        if (FAILED(resourceVariable->SetConstantBuffer(constantBuffer)))
+        {
+            LOG ("Failed to bind shadow buffer for " << _name);
+        }
+    }
+}
+
 
 }
\ No newline at end of file
@@ -57,7 +57,7 @@ class TextureD3D11;
 class ConstantBufferD3D11 : public Ctr::GpuConstantBuffer
 {
   public:
-    ConstantBufferD3D11();
+    ConstantBufferD3D11(Ctr::IDevice* device);
     virtual ~ConstantBufferD3D11();
 
     void                        setParameterType (Ctr::ShaderParameter type);
@@ -104,6 +104,8 @@ class ConstantBufferD3D11 : public Ctr::GpuConstantBuffer
 
 
   protected:
+    virtual void                bindShadowBuffer (const Ctr::IGpuBuffer* buffer) const;
+
     typedef std::map<std::string, std::string>       StringMap;
     typedef StringMap::iterator         AnnotationIt;
     typedef    StringMap::const_iterator   ConstAnnotationIt;
@@ -52,6 +52,8 @@
 #include <CtrIndexBufferD3D11.h>
 #include <CtrVertexBufferD3D11.h>
 #include <CtrDepthSurfaceD3D11.h>
+#include <CtrGpuConstantBuffer.h>
+#include <CtrCommandListD3D11.h>
 
 namespace Ctr
 {
@@ -260,15 +262,75 @@ GpuVariableD3D11::unbind() const
 {
 }
 
+ID3DX11EffectConstantBuffer*
+GpuVariableD3D11::parentConstantBuffer() const
+{
+    if (!_handle || _variableDesc.Class == D3D10_SVC_OBJECT)
+        return nullptr;
+
+    ID3DX11EffectConstantBuffer* parent = _handle->GetParentConstantBuffer();
+    return parent && parent->IsValid() ? parent : nullptr;
+}
+
+void
+GpuVariableD3D11::attachShadow (Ctr::GpuConstantBuffer* constantBuffer)
+{
+    BufferLayout layout;
+    layout.rows = _variableDesc.Rows;
+    layout.columns = _variableDesc.Columns;
+    layout.columnMajor = _variableDesc.Class == D3D10_SVC_MATRIX_COLUMNS;
+    layout.elements = _variableDesc.Elements;
+    layout.stride = _variableDesc.Stride;
+    layout.size = _variableDesc.UnpackedSize;
+    attach (constantBuffer, _parameterDescription.BufferOffset, layout);
+
+    std::vector<uint8_t> initialValue (_variableDesc.UnpackedSize);
+    if (initialValue.size() > 0 &&
+        SUCCEEDED(_handle->GetRawValue (&initialValue[0], 0, uint32_t(initialValue.size()))))
+    {
+        _constantBuffer->write (_bufferOffset, &initialValue[0], uint32_t(initialValue.size()));
+    }
+}
+
+bool
+GpuVariableD3D11::setResourceView (ID3D11ShaderResourceView* resourceView) const
+{
+    if (Ctr::CommandListD3D11* commandList = Ctr::CommandListD3D11::recording())
+    {
+        commandList->setResource (_handle, resourceView);
+        return true;
+    }
+    return SUCCEEDED(_handle->AsShaderResource()->SetResource (resourceView));
+}
+
 void
 GpuVariableD3D11::setFloatArray (const float* value, uint32_t size) const
 {
+    if (writeFloatArray (value, size))
+        return;
+
+    if (Ctr::CommandListD3D11* commandList = Ctr::CommandListD3D11::recording())
+    {
+        commandList->setValue (_handle, Ctr::CommandListD3D11::FloatArrayValue, 
+                               value, sizeof(float) * size, size);
+        return;
+    }
+
     _handle->AsScalar()->SetFloatArray ((float*)value, 0, size);
 }
 
 void
 GpuVariableD3D11::set (const void* value, uint32_t size) const
 {
+    if (writeValue (value, size))
+        return;
+
+    if (Ctr::CommandListD3D11* commandList = Ctr::CommandListD3D11::recording())
+    {
+        commandList->setValue (_handle, Ctr::CommandListD3D11::RawValue, value, size, 1);
+        return;
+    }
+
     if (ID3DX11EffectVariable* effectVariable = _handle)
     {
         effectVariable->SetRawValue ((void*)value, 0, size);
@@ -278,6 +340,16 @@ GpuVariableD3D11::set (const void* value, uint32_t size) const
 void
 GpuVariableD3D11::setMatrix(const float* value) const
 {
+    if (writeMatrix (value))
+        return;
+
+    if (Ctr::CommandListD3D11* commandList = Ctr::CommandListD3D11::recording())
+    {
+        commandList->setValue (_handle, Ctr::CommandListD3D11::MatrixValue, 
+                               value, sizeof(float) * 16, 1);
+        return;
+    }
+
     if (ID3DX11EffectMatrixVariable* effectVariable = _handle->AsMatrix())
     {
         effectVariable->SetMatrix ((float*)(void*)value);
@@ -287,6 +359,16 @@ GpuVariableD3D11::setMatrix(const float* value) const
 void
 GpuVariableD3D11::setMatrixArray (const float* value, uint32_t count) const
 {
+    if (writeMatrixArray (value, count))
+        return;
+
+    if (Ctr::CommandListD3D11* commandList = Ctr::CommandListD3D11::recording())
+    {
+        commandList->setValue (_handle, Ctr::CommandListD3D11::MatrixArrayValue, 
+                               value, sizeof(float) * 16 * count, count);
+        return;
+    }
+
     if (ID3DX11EffectMatrixVariable* matrixVariable = _handle->AsMatrix())
     {
         matrixVariable->SetMatrixArray ((float*)value, 0, count);
@@ -297,6 +379,16 @@ GpuVariableD3D11::setMatrixArray (const float* value, uint32_t count) const
 void
 GpuVariableD3D11::setVectorArray (const float* value, uint32_t count) const
 {
+    if (writeVectorArray (value, count))
+        return;
+
+    if (Ctr::CommandListD3D11* commandList = Ctr::CommandListD3D11::recording())
+    {
+        commandList->setValue (_handle, Ctr::CommandListD3D11::VectorArrayValue, 
+                               value, sizeof(float) * 4 * count, count);
+        return;
+    }
+
     if (ID3DX11EffectVectorVariable* vectorVariable =
         _handle->AsVector())
     {
@@ -308,6 +400,16 @@ GpuVariableD3D11::setVectorArray (const float* value, uint32_t count) const
 void
 GpuVariableD3D11::setVector (const float* value) const
 {
+    if (writeVector (value))
+        return;
+
+    if (Ctr::CommandListD3D11* commandList = Ctr::CommandListD3D11::recording())
+    {
+        commandList->setValue (_handle, Ctr::CommandListD3D11::VectorValue, 
+                               value, sizeof(float) * 4, 1);
+        return;
+    }
+
     //if (ID3DX11EffectVariable* effectVariable = _handle)
     //{
         if (ID3DX11EffectVectorVariable* vectorVariable =
@@ -328,7 +430,7 @@ GpuVariableD3D11::setTexture (const Ctr::ITexture* texture) const
         {
             ID3D11ShaderResourceView * resourceView = nullptr;
             resourceView = ((const Ctr::TextureD3D11*)texture)->resourceView(texture->activeSlice(), texture->activeMipId());
-            resourceVariable->SetResource (resourceView);
+            setResourceView (resourceView);
             return;
         }
     }
@@ -345,7 +447,11 @@ GpuVariableD3D11::setUnorderedResource(const Ctr::IGpuBuffer* buffer) const
         {
             ID3D11UnorderedAccessView * resourceView = 
                 ((const Ctr::BufferD3D11*)buffer)->unorderedView();
-            if (FAILED(resourceVariable->SetUnorderedAccessView (resourceView)))
+            if (Ctr::CommandListD3D11* commandList = Ctr::CommandListD3D11::recording())
+            {
+                commandList->setUnorderedResource (_handle, resourceView);
+            }
+            else if (FAILED(resourceVariable->SetUnorderedAccessView (resourceView)))
             {
                 LOG ("Failed set buffer resource...");
             }
@@ -362,7 +468,7 @@ GpuVariableD3D11::setResource (const Ctr::IGpuBuffer* buffer) const
             _handle->AsShaderResource())
         {
             ID3D11ShaderResourceView * resourceView = ((const Ctr::BufferD3D11*)buffer)->resourceView();
-            if (SUCCEEDED(resourceVariable->SetResource (resourceView)))
+            if (setResourceView (resourceView))
             {
                 return;
             }
@@ -381,7 +487,7 @@ GpuVariableD3D11::setStream (const Ctr::IVertexBuffer* vertexBuffer) const
         _handle->AsShaderResource())
     {
         ID3D11ShaderResourceView * resourceView = ((const Ctr::VertexBufferD3D11*)vertexBuffer)->shaderResourceView();
-        resourceVariable->SetResource(resourceView);
+        setResourceView (resourceView);
     }
 }
 
@@ -392,7 +498,7 @@ GpuVariableD3D11::setStream (const Ctr::IIndexBuffer* indexBuffer) const
         _handle->AsShaderResource())
     {
         ID3D11ShaderResourceView * resourceView = ((const Ctr::IndexBufferD3D11*)indexBuffer)->resourceView();
-        resourceVariable->SetResource(resourceView);
+        setResourceView (resourceView);
     }
 }
 
@@ -403,7 +509,7 @@ GpuVariableD3D11::setDepthTexture (const Ctr::IDepthSurface* depthSurface) const
         _handle->AsShaderResource())
     {
         ID3D11ShaderResourceView * resourceView = ((const Ctr::DepthSurfaceD3D11*)depthSurface)->resourceView();
-        resourceVariable->SetResource (resourceView);
+        setResourceView (resourceView);
     
         return;
     }
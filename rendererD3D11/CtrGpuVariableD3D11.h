@@ -123,7 +123,25 @@ class GpuVariableD3D11 : public Ctr::GpuVariable
 
     virtual void                unbind() const;
 
+    //-----------------------------------------------------
+    // Constant buffer holding the variable, null for
+    // objects and texture buffer members.
+    //-----------------------------------------------------
+    ID3DX11EffectConstantBuffer* parentConstantBuffer() const;
+
+    //-----------------------------------------------------
+    // Writes go to the constant buffer shadow from here on,
+    // which is seeded with the effect's initial value.
+    //-----------------------------------------------------
+    void                        attachShadow (Ctr::GpuConstantBuffer* constantBuffer);
+
   protected:
+    //-----------------------------------------------------
+    // Sets the view on the effect, or on the command list
+    // recording on this thread.
+    //-----------------------------------------------------
+    bool                        setResourceView (ID3D11ShaderResourceView* resourceView) const;
+
     typedef std::map<std::string, std::string>  StringMap;
       
     //---------------------------------------
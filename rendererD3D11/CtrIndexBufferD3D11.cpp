@@ -42,6 +42,7 @@
 #include <CtrIndexBufferD3D11.h>
 #include <CtrIRenderResourceParameters.h>
 #include <CtrFormatConversionD3D11.h>
+#include <CtrCommandListD3D11.h>
 
 namespace Ctr
 {
@@ -86,7 +87,8 @@ bool IndexBufferD3D11::initialize(const Ctr::IndexBufferParameters* data)
 
 bool IndexBufferD3D11::bind(uint32_t offset) const
 {
-    _immediateCtx->IASetIndexBuffer(_indexBuffer, DXGI_FORMAT_R32_UINT, (uint32_t)(_bufferCursor + offset));
+    DXGI_FORMAT format = _resource.format() == INDEX16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+    Ctr::CommandListD3D11::context (_immediateCtx)->IASetIndexBuffer(_indexBuffer, format, (uint32_t)(_bufferCursor + offset));
     return true;
 }
 
@@ -40,6 +40,7 @@
 //------------------------------------------------------------------------------------//
 #include <CtrInputLayoutCacheD3D11.h>
 #include <CtrVertexDeclarationD3D11.h>
+#include <CtrCommandListD3D11.h>
 #include <CtrLog.h>
 
 
@@ -87,6 +88,8 @@ InputLayoutCacheD3D11::initialize (ID3DX11EffectTechnique* technique, uint32_t p
 bool
 InputLayoutCacheD3D11::bindLayout (const Ctr::VertexDeclarationD3D11* vertexDeclaration) const
 {
+    // Command lists bind layouts from several threads.
+    std::lock_guard<std::mutex> lock (_layoutMutex);
     auto it = _layouts.find (vertexDeclaration);
 
     if (it == _layouts.end())
@@ -111,7 +114,7 @@ InputLayoutCacheD3D11::bindLayout (const Ctr::VertexDeclarationD3D11* vertexDecl
 
     if (ID3D11InputLayout* layout = it->second)
     {
-        _immediateCtx->IASetInputLayout (layout);
+        Ctr::CommandListD3D11::context (_immediateCtx)->IASetInputLayout (layout);
         return true;
     }
     return false;
@@ -46,6 +46,7 @@
 #include <CtrRenderEnums.h>
 #include <CtrRenderDeviceD3D11.h>
 #include <CtrPlatform.h>
+#include <mutex>
 
 namespace Ctr
 {
@@ -64,6 +65,7 @@ class InputLayoutCacheD3D11
   protected:
     typedef std::map <const Ctr::VertexDeclarationD3D11*, ID3D11InputLayout*>       LayoutMap;
     mutable LayoutMap               _layouts;
+    mutable std::mutex              _layoutMutex;
     uint32_t                        _passIndex;
 
     ID3DX11EffectTechnique*         _technique;
@@ -56,6 +56,7 @@
 #include <CtrShaderD3D11.h>
 #include <CtrRenderTargetTextureD3D11.h>
 #include <CtrComputeShaderD3D11.h>
+#include <CtrCommandListD3D11.h>
 #include <CtrTexture2DD3D11.h>
 #include <CtrColorResolve.h>
 #include <CtrDepthResolve.h>
@@ -510,6 +511,7 @@ DeviceD3D11::DeviceD3D11()
     _currentSurfaceCount = 0;
     _currentUAVCount = 0;        
     _blendFactor = Ctr::Vector4f(1,1,1,1);
+    memset (&_currentScissorRect, 0, sizeof (_currentScissorRect));
 
     for (uint32_t i = 0; i < MAX_RENDER_TARGETS; i++)
     {
@@ -982,12 +984,11 @@ DeviceD3D11::setScissorEnabled(bool scissorEnabled)
 void
 DeviceD3D11::setScissorRect(int x, int y, int width, int height)
 {
-    D3D11_RECT rc;
-    rc.left = x;
-    rc.top = y;
-    rc.right = x + width;
-    rc.bottom = y + height;
-    _immediateCtx->RSSetScissorRects(1, &rc);
+    _currentScissorRect.left = x;
+    _currentScissorRect.top = y;
+    _currentScissorRect.right = x + width;
+    _currentScissorRect.bottom = y + height;
+    _immediateCtx->RSSetScissorRects(1, &_currentScissorRect);
 }
 
 void
@@ -1098,6 +1099,67 @@ DeviceD3D11::bindSurfaceAndTargets()
     }
 }
 
+void
+DeviceD3D11::applyState (ID3D11DeviceContext* context) const
+{
+    context->RSSetState (_currentRasterState);
+    context->OMSetDepthStencilState (_currentDepthState, 0x0);
+    context->OMSetBlendState (_currentBlendState, &_blendFactor.x, 0xffffffff);
+    context->RSSetViewports (1, &_currentViewport);
+    if (_scissorEnabled)
+    {
+        context->RSSetScissorRects (1, &_currentScissorRect);
+    }
+
+    ID3D11RenderTargetView* views[MAX_RENDER_TARGETS];   
+    memset (&views[0], 0, sizeof (ID3D11RenderTargetView*) * MAX_RENDER_TARGETS);
+
+    ID3D11UnorderedAccessView * unorderedViews[MAX_RENDER_TARGETS];
+    memset (&unorderedViews[0], 0, sizeof (ID3D11UnorderedAccessView*) * MAX_RENDER_TARGETS);
+
+    // Same views bindSurfaceAndTargets last bound.
+    for (uint32_t i = 0; i < _currentSurfaceCount; i++)
+    {
+        views [i] = ((const Ctr::SurfaceD3D11*)_currentSurfaces [i])->surface();
+    }
+
+    for (uint32_t i = 0; i < _currentUAVCount; i++)
+    {
+        if (const Ctr::BufferD3D11* resource = 
+            dynamic_cast <const Ctr::BufferD3D11*>
+            (_currentUnorderedSurfaces[i]))
+        {
+            unorderedViews [i] = resource->unorderedView();
+        }
+        else if (const Ctr::VertexBufferD3D11* vertexBufferResource =
+                 dynamic_cast<const Ctr::VertexBufferD3D11*>(_currentUnorderedSurfaces[i]))
+        {
+            unorderedViews [i] = vertexBufferResource->unorderedResourceView();
+        }
+    }
+
+    ID3D11DepthStencilView* depthSurfaceView = 0;
+    if (_currentDepthSurface)
+    {
+        depthSurfaceView = ((Ctr::DepthSurfaceD3D11*)_currentDepthSurface)->surface();
+    }
+
+    UINT initialCounts[D3D11_PS_CS_UAV_REGISTER_COUNT] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    context->OMSetRenderTargetsAndUnorderedAccessViews(_currentSurfaceCount,
+                                                       &views[0], 
+                                                       depthSurfaceView, 
+                                                       _currentSurfaceCount,/* start uav slot*/ 
+                                                       MAX_RENDER_TARGETS, 
+                                                       &unorderedViews[0], 
+                                                       initialCounts);
+}
+
+const D3D11_RASTERIZER_DESC&
+DeviceD3D11::rasterStateDesc() const
+{
+    return _currentRasterStateDesc;
+}
+
 bool
 DeviceD3D11::resizeDevice (const Ctr::Vector2i& newSize)
 {
@@ -1273,7 +1335,8 @@ DeviceD3D11::drawPrimitive (const IVertexDeclaration* vertexDeclaration,
                                uint32_t primitiveCount,
                                uint32_t vertexOffset) const
 {
-    _immediateCtx->IASetIndexBuffer (0, DXGI_FORMAT_R32_UINT,0);
+    ID3D11DeviceContext* context = Ctr::CommandListD3D11::context (_immediateCtx);
+    context->IASetIndexBuffer (0, DXGI_FORMAT_R32_UINT,0);
     if (vertexBuffer->bind())
     {
         D3D11_PRIMITIVE_TOPOLOGY topology = (D3D11_PRIMITIVE_TOPOLOGY)(primitiveType);
@@ -1292,7 +1355,7 @@ DeviceD3D11::drawPrimitive (const IVertexDeclaration* vertexDeclaration,
                     return false;
             }
         }
-        _immediateCtx->IASetPrimitiveTopology (topology);
+        context->IASetPrimitiveTopology (topology);
 
         uint32_t vertexCount = 0;
         switch (topology)
@@ -1318,7 +1381,7 @@ DeviceD3D11::drawPrimitive (const IVertexDeclaration* vertexDeclaration,
             default: 
                 break;
         }
-        _immediateCtx->Draw (vertexCount, vertexOffset);
+        context->Draw (vertexCount, vertexOffset);
     }
     return true;
 }
@@ -1344,6 +1407,21 @@ DeviceD3D11::drawIndexedPrimitive (const IVertexDeclaration* vertexDeclaration,
                                       uint32_t faceCount,
                                       uint32_t indexOffset,
                                       uint32_t vertexOffset) const
+{
+    return drawIndexedPrimitiveInstanced (vertexDeclaration, indexBuffer, vertexBuffer, technique,
+                                          primitiveType, faceCount, indexOffset, vertexOffset, 1);
+}
+
+bool
+DeviceD3D11::drawIndexedPrimitiveInstanced (const IVertexDeclaration* vertexDeclaration, 
+                                            const IIndexBuffer* indexBuffer, 
+                                            const IVertexBuffer* vertexBuffer, 
+                                            const GpuTechnique* technique,
+                                            PrimitiveType primitiveType, 
+                                            uint32_t faceCount,
+                                            uint32_t indexOffset,
+                                            uint32_t vertexOffset,
+                                            uint32_t instanceCount) const
 {
     bool result = false;
     if (vertexBuffer->bind() && indexBuffer->bind())
@@ -1362,7 +1440,8 @@ DeviceD3D11::drawIndexedPrimitive (const IVertexDeclaration* vertexDeclaration,
             }
         }
 
-        _immediateCtx->IASetPrimitiveTopology (topology);
+        ID3D11DeviceContext* context = Ctr::CommandListD3D11::context (_immediateCtx);
+        context->IASetPrimitiveTopology (topology);
         //LOG ("Set topology " << (uint32_t)(topology));
         
         uint32_t indexCount = 0;
@@ -1446,7 +1525,14 @@ DeviceD3D11::drawIndexedPrimitive (const IVertexDeclaration* vertexDeclaration,
             default: 
                 break;
         }        
-        _immediateCtx->DrawIndexed(indexCount, indexOffset, vertexOffset);
+        if (instanceCount > 1)
+        {
+            context->DrawIndexedInstanced(indexCount, instanceCount, indexOffset, vertexOffset, 0);
+        }
+        else
+        {
+            context->DrawIndexed(indexCount, indexOffset, vertexOffset);
+        }
     }
     return result;
 }
@@ -1688,12 +1774,22 @@ DeviceD3D11::disableStencilTest()
 Ctr::CullMode
 DeviceD3D11::cullMode() const
 {
+    if (const Ctr::ICommandList* commandList = Ctr::ICommandList::recording())
+    {
+        return commandList->cullMode();
+    }
     return _cullMode;
 }
 
 void
 DeviceD3D11::setCullMode (Ctr::CullMode cullMode)
 {
+    if (Ctr::ICommandList* commandList = Ctr::ICommandList::recording())
+    {
+        commandList->setCullMode (cullMode);
+        return;
+    }
+
     _cullMode = cullMode;
     switch (_cullMode)
     {
@@ -1879,6 +1975,12 @@ DeviceD3D11::createShader (const Ctr::RenderResourceParameters* data)
     return nullptr;
 }
 
+Ctr::ICommandList *
+DeviceD3D11::createCommandList()
+{
+    return new Ctr::CommandListD3D11(this);
+}
+
 Ctr::IComputeShader *
 DeviceD3D11::createComputeShader (const Ctr::RenderResourceParameters* data)
 {
@@ -159,6 +159,7 @@ class DeviceD3D11 : public IDevice
     virtual ITexture *          createTexture (const Ctr::RenderResourceParameters* data = 0);
     virtual IComputeShader *    createComputeShader (const Ctr::RenderResourceParameters* data = 0);
     virtual IShader *           createShader (const Ctr::RenderResourceParameters* data = 0);
+    virtual ICommandList *      createCommandList();
 
     virtual void                destroyResource(Ctr::IRenderResource* resource);
 
@@ -183,6 +184,16 @@ class DeviceD3D11 : public IDevice
                                                      uint32_t indexOffset,
                                                      uint32_t vertexOffset) const;
 
+    virtual bool               drawIndexedPrimitiveInstanced (const IVertexDeclaration*, 
+                                                              const IIndexBuffer*, 
+                                                              const IVertexBuffer*, 
+                                                              const GpuTechnique* technique,
+                                                              PrimitiveType, 
+                                                              uint32_t faceCount,
+                                                              uint32_t indexOffset,
+                                                              uint32_t vertexOffset,
+                                                              uint32_t instanceCount) const;
+
     virtual bool               blitSurfaces (const ISurface* destination, 
                                              const ISurface* src, 
                                              TextureFilter filterType = Ctr::TEXFILTER_POINT,
@@ -286,6 +297,13 @@ class DeviceD3D11 : public IDevice
     virtual void                bindDepthSurface (const Ctr::IDepthSurface* surface);
     void                        bindSurfaceAndTargets();
 
+    //-----------------------------------------------------
+    // Sets the raster, depth and blend state, viewport,
+    // scissor and targets the device tracks on context.
+    //-----------------------------------------------------
+    void                        applyState (ID3D11DeviceContext* context) const;
+    const D3D11_RASTERIZER_DESC& rasterStateDesc() const;
+
     virtual bool                resizeDevice (const Ctr::Vector2i& newSize);
 
     virtual bool                texelIsCenter() { return false; }
@@ -315,6 +333,7 @@ class DeviceD3D11 : public IDevice
     Ctr::RenderWindow*          _window;
     bool                       _initialized;
     D3D11_VIEWPORT             _currentViewport;
+    D3D11_RECT                 _currentScissorRect;
     ID3D11DeviceContext*       _immediateCtx;
 
     SurfaceD3D11*              _backbuffer;
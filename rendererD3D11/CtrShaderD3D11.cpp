@@ -53,6 +53,9 @@
 #include <CtrEffectD3D11.h>
 #include <CtrAssetManager.h>
 #include <CtrMaterial.h>
+#include <CtrShaderIncludeD3D11.h>
+#include <CtrShaderCache.h>
+#include <CtrCommandListD3D11.h>
 #include <d3dcompiler.h>
 
 namespace Ctr
@@ -88,6 +91,11 @@ inline void generateDumpFile(const std::string& filename, const char* error, con
      return;
 }
 
+inline std::string blobString(ID3D10Blob* blob)
+{
+    return std::string((const char*)blob->GetBufferPointer(), blob->GetBufferSize());
+}
+
 }
 
 ShaderD3D11::ShaderD3D11(Ctr::DeviceD3D11* device)  :
@@ -144,8 +152,13 @@ ShaderD3D11::free()
     }
 
     _shaderParameterValues.clear();
+    _supportsInstancing = false;
     _meshParameters.clear();
     _techniqueParameters.clear();
+    _materialParameters.clear();
+    _frameParameters.clear();
+    _cameraParameters.clear();
+    _scopeState.invalidate();
     _parameters.clear();
     _techniques.clear();
     _constantBuffers.clear();
@@ -197,11 +210,29 @@ ShaderD3D11::create()
 {
     free();
 
+    if (createEffect ())
+    {
+        D3DX11_EFFECT_DESC desc;
+        if (SUCCEEDED (_effect->effect()->GetDesc (&desc)))
+        {
+            enumerateTechniques (desc, _verbose);
+            enumerateVariables (desc, _verbose);
+            passVariables();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+ShaderD3D11::compile()
+{
+    _pendingBytecode.clear();
 
     std::string includeStream;
     if (IShader::includeFilePathName().length() > 0)
-    if (std::unique_ptr<typename DataStream> fileStream =
-        std::unique_ptr<typename DataStream>(AssetManager::assetManager()->openStream(IShader::includeFilePathName())))
+    if (std::unique_ptr<DataStream> fileStream =
+        std::unique_ptr<DataStream>(AssetManager::assetManager()->openStream(IShader::includeFilePathName())))
     {
         size_t fileSize = fileStream->size();
         char* buffer = new char[fileSize + 1];
@@ -212,8 +243,8 @@ ShaderD3D11::create()
     }
 
     std::string shaderStream;
-    if (std::unique_ptr<typename DataStream> fileStream =
-        std::unique_ptr<typename DataStream>(AssetManager::assetManager()->openStream(IShader::filePathName())))
+    if (std::unique_ptr<DataStream> fileStream =
+        std::unique_ptr<DataStream>(AssetManager::assetManager()->openStream(IShader::filePathName())))
     {
         size_t fileSize = fileStream->size();
         char* buffer = new char[fileSize + 1];
@@ -224,19 +255,84 @@ ShaderD3D11::create()
     }
 
     setShaderStream((includeStream+shaderStream).c_str());
+    _hash.build(IShader::shaderStream());
 
-    if (createEffect ())
+    _dependencies.clear();
+    _dependencies.insert(ShaderIncludeD3D11::normalize(IShader::filePathName()));
+    if (IShader::includeFilePathName().length() > 0)
     {
-        D3DX11_EFFECT_DESC desc;
-        if (SUCCEEDED (_effect->effect()->GetDesc (&desc)))
+        _dependencies.insert(ShaderIncludeD3D11::normalize(IShader::includeFilePathName()));
+    }
+
+    uint32_t hlslFlags = D3DCOMPILE_ENABLE_BACKWARDS_COMPATIBILITY | D3DCOMPILE_SKIP_OPTIMIZATION;
+    std::vector<D3D10_SHADER_MACRO>       vectorDefines;
+    if (_defines.size() > 0)
+    {
+        hlslFlags = D3D10_SHADER_ENABLE_BACKWARDS_COMPATIBILITY;
+        for (auto it = _defines.begin(); it != _defines.end(); it++)
         {
-            enumerateTechniques (desc, _verbose);
-            enumerateVariables (desc, _verbose);
-            passVariables();
-            return true;
+            D3D10_SHADER_MACRO macro = {(*it).first.c_str(), (*it).second.c_str()};
+            vectorDefines.push_back (macro);
         }
+        D3D10_SHADER_MACRO nullMacro = {0, 0};
+        vectorDefines.push_back (nullMacro);
     }
-    return false;
+    const D3D_SHADER_MACRO* macros = vectorDefines.size() > 0 ? (const D3D_SHADER_MACRO*)&vectorDefines[0] : nullptr;
+
+    // Expand #includes first: the expanded text keys the bytecode cache and the
+    // include handler records every file this shader depends on.
+    ShaderIncludeD3D11 includeHandler(IShader::filePathName());
+    ID3D10Blob * preprocessed = 0;
+    ID3D10Blob * errors = 0;
+    HRESULT result = D3DPreprocess(IShader::shaderStream().c_str(), IShader::shaderStream().size(),
+                                   IShader::filePathName().c_str(), macros, &includeHandler,
+                                   &preprocessed, &errors);
+    _dependencies.insert(includeHandler.files().begin(), includeHandler.files().end());
+    if (FAILED(result))
+    {
+        LOG ("Failed to preprocess " << IShader::filePathName());
+        if (errors)
+        {
+            generateDumpFile(IShader::filePathName(), blobString(errors).c_str(), IShader::shaderStream());
+        }
+        saferelease(errors);
+        return false;
+    }
+    saferelease(errors);
+
+    std::string preprocessedStream((const char*)preprocessed->GetBufferPointer(), preprocessed->GetBufferSize());
+    saferelease(preprocessed);
+
+    Hash cacheKey = ShaderCache::key(preprocessedStream, _defines, "", "fx_5_0", hlslFlags);
+    if (ShaderCache::load(cacheKey, _pendingBytecode))
+    {
+        return true;
+    }
+
+    ID3D10Blob * shaderCode = 0;
+    if(FAILED(D3DCompile(preprocessedStream.c_str(), preprocessedStream.size(), IShader::filePathName().c_str(), 
+                         nullptr, nullptr, "", "fx_5_0", hlslFlags, 0, &shaderCode, &errors)))
+    { 
+        LOG ("Failed to compile " << IShader::filePathName());
+        
+        // Open file and dump error information.
+        if(errors) 
+        { 
+            std::string errorText = blobString(errors);
+            generateDumpFile(IShader::filePathName(), errorText.c_str(), IShader::shaderStream());
+            LOG ("Error Compiling ShaderD3D11" << errorText);
+        } 
+        saferelease(errors);
+        return false;
+    }
+    saferelease(errors);
+
+    const char* bytecode = (const char*)shaderCode->GetBufferPointer();
+    _pendingBytecode.assign(bytecode, bytecode + shaderCode->GetBufferSize());
+    saferelease(shaderCode);
+
+    ShaderCache::store(cacheKey, &_pendingBytecode[0], _pendingBytecode.size());
+    return true;
 }
 
 bool 
@@ -269,8 +365,21 @@ ShaderD3D11::getParameterType(Ctr::GpuVariable* variable)
             case Ctr::PerTechnique:
                 _techniqueParameters.insert (_techniqueParameters.begin(), value);
                 break;
+            case Ctr::PerMaterial:
+                _materialParameters.insert (_materialParameters.begin(), value);
+                break;
+            case Ctr::PerFrame:
+                _frameParameters.insert (_frameParameters.begin(), value);
+                break;
+            case Ctr::PerCamera:
+                _cameraParameters.insert (_cameraParameters.begin(), value);
+                break;
         }
         _shaderParameterValues.insert (_shaderParameterValues.begin(), value);
+        if (value->parameterType() == Ctr::InstanceWorldMatrices)
+        {
+            _supportsInstancing = true;
+        }
     }
 }
 
@@ -279,79 +388,17 @@ ShaderD3D11::createEffect ()
 {
     try
     {        
-        uint32_t hlslFlags = 0;
-
+        // ShaderMgr compiles changed shaders ahead of time, in parallel.
+        if (_pendingBytecode.empty() && !compile())
         {
-            hlslFlags = D3D10_SHADER_ENABLE_BACKWARDS_COMPATIBILITY;
+            return false;
         }
-    
-        ID3D10Blob * shaderCode = 0;
-        ID3D10Blob * errors = 0;
 
-        std::vector<D3D10_SHADER_MACRO>       vectorDefines;
-        if (_defines.size() > 0)
-        {
-            for (auto it = _defines.begin(); it != _defines.end(); it++)
-            {
-                D3D10_SHADER_MACRO macro = {(*it).first.c_str(), (*it).second.c_str()};
-                vectorDefines.push_back (macro);
-            }
-            D3D10_SHADER_MACRO nullMacro = {0, 0};
-            vectorDefines.push_back (nullMacro);
-            
-            _hash.build(shaderStream());
-        
-            if(FAILED(D3DCompile(shaderStream().c_str(), shaderStream().size(), 0, (const D3D_SHADER_MACRO*)&*vectorDefines.begin(), nullptr, "", "fx_5_0", 
-                                  hlslFlags, 0, &shaderCode, &errors)))
-            { 
-        
-                // LOG ("Failed to compile ... " << shaderStream() << "\n");
-                LOG ("Failed to compile " << IShader::filePathName());
-        
-                if(errors) 
-                { 
-        
-                    char* buffer = new char[errors->GetBufferSize()+1];
-                    memset(&buffer[0], 0, errors->GetBufferSize()+1);
-                    memcpy(&buffer[0], errors->GetBufferPointer(), errors->GetBufferSize());
-                    // LOG ("Error Compiling ShaderD3D11" << buffer);
-        
-                    generateDumpFile(IShader::filePathName(), buffer, shaderStream());
-        
-                    delete[] (buffer);
-                } 
-        
-                return false;
-            } 
-        }
-        else
-        {
-            _hash.build(shaderStream());
-            if(FAILED(D3DCompile(shaderStream().c_str(), shaderStream().size(), 0, 0, nullptr, "", "fx_5_0", 
-                                 D3DCOMPILE_ENABLE_BACKWARDS_COMPATIBILITY | D3DCOMPILE_SKIP_OPTIMIZATION
-                                 , 0,  &shaderCode, &errors)))
-            { 
-                LOG ("Failed to compile " << IShader::filePathName());
-        
-                // Open file and dump error information.
-        
-                if(errors) 
-                { 
-                    char* buffer = new char[errors->GetBufferSize()+1];
-                    memset(&buffer[0], 0, errors->GetBufferSize()+1);
-                    memcpy(&buffer[0], errors->GetBufferPointer(), errors->GetBufferSize());
-                    generateDumpFile(IShader::filePathName(), buffer, shaderStream());
-                    LOG ("Error Compiling ShaderD3D11" << buffer);
-                    delete[] (buffer);
-                } 
-                return false;
-            }
-        }
-        
         safedeletearray (_compiledBuffer);
-        _compiledBufferSize = shaderCode->GetBufferSize();
+        _compiledBufferSize = _pendingBytecode.size();
         _compiledBuffer = new char[_compiledBufferSize];
-        memcpy (_compiledBuffer, shaderCode->GetBufferPointer(), _compiledBufferSize * sizeof(char));
+        memcpy (_compiledBuffer, &_pendingBytecode[0], _compiledBufferSize * sizeof(char));
+        _pendingBytecode.clear();
      
         // Create effect 
         ID3DX11Effect* effect = 0;
@@ -378,6 +425,13 @@ ShaderD3D11::enumerateVariables(const D3DX11_EFFECT_DESC& desc, bool verbose)
 {
     bool result = true;
 
+    for (uint32_t i = 0; i < desc.ConstantBuffers; i++)
+    {
+        ConstantBufferD3D11 * constantBuffer = new ConstantBufferD3D11(_deviceInterface);
+        constantBuffer->initialize (_effect, i);
+        _constantBuffers.push_back(constantBuffer);
+    }
+
     for (uint32_t i = 0; i < desc.GlobalVariables; i++)
     {
         GpuVariableD3D11 * variable = new GpuVariableD3D11(_deviceInterface);
@@ -388,17 +442,35 @@ ShaderD3D11::enumerateVariables(const D3DX11_EFFECT_DESC& desc, bool verbose)
         {
             setName(variable->annotation("ToString").c_str());                
         }
-    }
 
-    for (uint32_t i = 0; i < desc.ConstantBuffers; i++)
-    {
-        ConstantBufferD3D11 * constantBuffer = new ConstantBufferD3D11();
-        constantBuffer->initialize (_effect, i);
-        _constantBuffers.push_back(constantBuffer);
+        // Numeric variables write into their constant buffer's shadow.
+        if (ID3DX11EffectConstantBuffer* parent = variable->parentConstantBuffer())
+        {
+            for (auto it = _constantBuffers.begin(); it != _constantBuffers.end(); it++)
+            {
+                ConstantBufferD3D11* constantBuffer = 
+                    static_cast<ConstantBufferD3D11*>(*it);
+                if (constantBuffer->handle() == parent && constantBuffer->shadowed())
+                {
+                    variable->attachShadow (constantBuffer);
+                    break;
+                }
+            }
+        }
     }
 
     return result;        
 }
+
+bool
+ShaderD3D11::commitConstantBuffers() const
+{
+    for (auto it = _constantBuffers.begin(); it != _constantBuffers.end(); it++)
+    {
+        (*it)->commit();
+    }
+    return true;
+}
 bool 
 ShaderD3D11::enumerateTechniques(const D3DX11_EFFECT_DESC& desc, bool verbose)
 {
@@ -518,13 +590,48 @@ ShaderD3D11::setParameters (const Ctr::PostEffect* target) const
 bool 
 ShaderD3D11::setParameters (const Ctr::RenderRequest& request) const
 {
-    for (auto parameter = _shaderParameterValues.begin();
-             parameter != _shaderParameterValues.end(); 
-             parameter++)
+    setFrameParameters (request);
+    setCameraParameters (request);
+    setTechniqueParameters (request);
+    setMaterialParameters (request);
+    setMeshParameters (request);
+    
+    return true;
+}
+
+bool 
+ShaderD3D11::setFrameParameters (const Ctr::RenderRequest& request) const
+{
+    if (!scopeState().frameChanged (request, _deviceInterface->frameIndex()))
     {
-        (*parameter)->setParam (request);
+        Ctr::ShaderParameterValue::skip ((uint32_t)_frameParameters.size());
+        return true;
+    }
+
+    for (auto it = _frameParameters.begin();
+         it != _frameParameters.end(); 
+         it++)
+    {
+        (*it)->evaluate (request);
+    }
+    return true;
+}
+
+bool 
+ShaderD3D11::setCameraParameters (const Ctr::RenderRequest& request) const
+{
+    if (!scopeState().cameraChanged (request, _deviceInterface->frameIndex()))
+    {
+        Ctr::ShaderParameterValue::skip ((uint32_t)_cameraParameters.size());
+        return true;
+    }
+
+    for (auto it = _cameraParameters.begin();
+         it != _cameraParameters.end(); 
+         it++)
+    {
+        (*it)->evaluate (request);
     }
-    
     return true;
 }
 
@@ -535,7 +642,7 @@ ShaderD3D11::setTechniqueParameters (const Ctr::RenderRequest& request) const
          it != _techniqueParameters.end(); 
          it++)
     {
-        (*it)->setParam (request);
+        (*it)->evaluate (request);
     }
     return true;
 }
@@ -547,7 +654,19 @@ ShaderD3D11::setMeshParameters (const Ctr::RenderRequest& request) const
          it != _meshParameters.end(); 
          it++)
     {
-        (*it)->setParam (request);
+        (*it)->evaluate (request);
+    }
+    return true;
+}
+
+bool 
+ShaderD3D11::setMaterialParameters (const Ctr::RenderRequest& request) const
+{
+    for (auto it = _materialParameters.begin();
+         it != _materialParameters.end(); 
+         it++)
+    {
+        (*it)->evaluate (request);
     }
     return true;
 }
@@ -589,11 +708,13 @@ ShaderD3D11::renderMeshSubset (Ctr::PrimitiveType primitiveType,
                 // Need to set input handle here
                 if (technique->setupInputLayout (request.mesh, passIndex))
                 {
-                    techniqueHandle->GetPassByIndex (passIndex)->Apply(0, _immediateCtx);
+                    commitConstantBuffers();
+                    applyPass (techniqueHandle, passIndex);
 
                     // This assumes that the vertex buffer is already bound
-                    _immediateCtx->IASetPrimitiveTopology((D3D_PRIMITIVE_TOPOLOGY)(primitiveType));
-                    _immediateCtx->DrawIndexed((uint32_t)(numIndices), (uint32_t)(startIndex), 0);
+                    ID3D11DeviceContext* context = Ctr::CommandListD3D11::context (_immediateCtx);
+                    context->IASetPrimitiveTopology((D3D_PRIMITIVE_TOPOLOGY)(primitiveType));
+                    context->DrawIndexed((uint32_t)(numIndices), (uint32_t)(startIndex), 0);
                 }
             }
 
@@ -647,7 +768,8 @@ ShaderD3D11::renderMesh (const Ctr::RenderRequest& request) const
                 // Need to set input handle here
                 if (technique->setupInputLayout (request.mesh, passIndex))
                 {
-                    techniqueHandle->GetPassByIndex (passIndex)->Apply(0, _immediateCtx);
+                    commitConstantBuffers();
+                    applyPass (techniqueHandle, passIndex);
                     request.mesh->render(&request, technique);
                 }
             }
@@ -665,6 +787,58 @@ ShaderD3D11::renderMesh (const Ctr::RenderRequest& request) const
     return true;
 }
 
+bool
+ShaderD3D11::renderQueuedMesh (const Ctr::RenderRequest& request,
+                               uint32_t bindFlags) const
+{
+    if (!request.mesh->visible())
+        return true;
+
+    Ctr::CullMode cachedCullMode =
+            _deviceInterface->cullMode();
+    bool twoSided = request.material && request.material->twoSided();
+
+    if (const Ctr::GpuTechniqueD3D11* technique = 
+        dynamic_cast<const Ctr::GpuTechniqueD3D11*>(request.technique))
+    {
+        setFrameParameters (request);
+        setCameraParameters (request);
+        if (bindFlags & Ctr::BindTechniqueParameters)
+            setTechniqueParameters (request);
+        if (bindFlags & Ctr::BindMaterialParameters)
+            setMaterialParameters (request);
+        setMeshParameters (request);
+
+        if (twoSided)
+        {
+            _deviceInterface->setCullMode (Ctr::CullNone);
+        }
+
+        ID3DX11EffectTechnique* techniqueHandle = 
+            technique->handle();
+
+        const D3DX11_TECHNIQUE_DESC& description =
+            technique->description();
+
+        for (uint32_t passIndex = 0; passIndex < description.Passes; passIndex++)
+        {
+            if (technique->setupInputLayout (request.mesh, passIndex))
+            {
+                commitConstantBuffers();
+                applyPass (techniqueHandle, passIndex);
+                request.mesh->render(&request, technique);
+            }
+        }
+
+        if (twoSided)
+        {
+            _deviceInterface->setCullMode (cachedCullMode);
+        }
+    }
+
+    return true;
+}
+
 bool 
 ShaderD3D11::renderMeshes (const Ctr::RenderRequest& inputRequest,
                            const std::set<const Ctr::Mesh*>      & meshes) const
@@ -702,7 +876,10 @@ ShaderD3D11::renderMeshes (const Ctr::RenderRequest& inputRequest,
                 const D3DX11_TECHNIQUE_DESC& description =
                     technique->description();
 
+               setFrameParameters (request);
+               setCameraParameters (request);
                setTechniqueParameters (request);
+               setMaterialParameters (request);
                setMeshParameters (request);
                
                 for (uint32_t passIndex = 0; passIndex < description.Passes; passIndex++)
@@ -710,7 +887,8 @@ ShaderD3D11::renderMeshes (const Ctr::RenderRequest& inputRequest,
                     // Need to set input handle here
                     if (technique->setupInputLayout (mesh, passIndex))
                     {
-                        techniqueHandle->GetPassByIndex (passIndex)->Apply(0, _immediateCtx);
+                        commitConstantBuffers();
+                        applyPass (techniqueHandle, passIndex);
                         mesh->render(&request, technique);
                     }
                 }
@@ -725,6 +903,28 @@ ShaderD3D11::renderMeshes (const Ctr::RenderRequest& inputRequest,
     return true;
 }
 
+Ctr::ParameterScopeState&
+ShaderD3D11::scopeState() const
+{
+    if (Ctr::ICommandList* commandList = Ctr::ICommandList::recording())
+        return commandList->scopeState (this);
+    return _scopeState;
+}
+
+void
+ShaderD3D11::applyPass (ID3DX11EffectTechnique* techniqueHandle, uint32_t passIndex) const
+{
+    ID3DX11EffectPass* pass = techniqueHandle->GetPassByIndex (passIndex);
+    if (Ctr::CommandListD3D11* commandList = Ctr::CommandListD3D11::recording())
+    {
+        commandList->applyPass (pass);
+    }
+    else
+    {
+        pass->Apply(0, _immediateCtx);
+    }
+}
+
 bool
 ShaderD3D11::renderInstancedBuffer (const Ctr::RenderRequest& request,
                                const Ctr::IGpuBuffer* instanceBuffer)  const
@@ -741,23 +941,28 @@ ShaderD3D11::renderInstancedBuffer (const Ctr::RenderRequest& request,
             ID3DX11EffectTechnique* techniqueHandle = 
                 technique->handle();
 
+            setFrameParameters (request);
+            setCameraParameters (request);
             setTechniqueParameters (request);
+            setMaterialParameters (request);
             setMeshParameters (request);
 
             for (uint32_t passIndex = 0; passIndex < description.Passes; passIndex++)
             {
-                techniqueHandle->GetPassByIndex (passIndex)->Apply(0, _immediateCtx);
+                commitConstantBuffers();
+                applyPass (techniqueHandle, passIndex);
 
                 ID3D11Buffer* vertexBuffers[2] = { nullptr , nullptr};
                 UINT strides[2] = { 0, 0 };
                 UINT offsets[2] = { 0, 0 };
-                _immediateCtx->IASetIndexBuffer(nullptr, DXGI_FORMAT_UNKNOWN, 0);
-                _immediateCtx->IASetVertexBuffers(0, 2, vertexBuffers, strides, offsets);
-                _immediateCtx->IASetInputLayout(nullptr);
+                ID3D11DeviceContext* context = Ctr::CommandListD3D11::context (_immediateCtx);
+                context->IASetIndexBuffer(nullptr, DXGI_FORMAT_UNKNOWN, 0);
+                context->IASetVertexBuffers(0, 2, vertexBuffers, strides, offsets);
+                context->IASetInputLayout(nullptr);
                 // TODO: Topology as input
-                _immediateCtx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST); 
+                context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST); 
 
-                _immediateCtx->DrawInstancedIndirect(resource->buffer(), 0);
+                context->DrawInstancedIndirect(resource->buffer(), 0);
             }
         }
     }
@@ -44,6 +44,7 @@
 
 #include <CtrPlatform.h>
 #include <CtrIShader.h>
+#include <CtrShaderParameterValue.h>
 #include <CtrVector2.h>
 
 namespace Ctr
@@ -86,6 +87,13 @@ class ShaderD3D11: public Ctr::IShader
     virtual bool                create();
     virtual bool                cache();
 
+    //------------------------------------------------------------
+    // Preprocesses and compiles the effect, or loads the bytecode
+    // from the ShaderCache. No device calls; safe to run in
+    // parallel with other shaders.
+    //------------------------------------------------------------
+    virtual bool                compile();
+
     //----------------------------------
     // Creates a shader in the shadermgr
     //----------------------------------
@@ -119,6 +127,9 @@ class ShaderD3D11: public Ctr::IShader
     bool                       renderMeshes (const Ctr::RenderRequest& request,
                                              const std::set<const Ctr::Mesh*>      & mesh) const;
 
+    virtual bool               renderQueuedMesh (const Ctr::RenderRequest& request,
+                                                 uint32_t bindFlags) const;
+
     virtual bool               renderInstancedBuffer (const Ctr::RenderRequest& request,
                                                       const Ctr::IGpuBuffer* instanceBuffer)  const;
 
@@ -132,10 +143,20 @@ class ShaderD3D11: public Ctr::IShader
     //-------------------------------------------
     bool                       passVariables();
 
+    //----------------------------------------------------------------
+    // Frame and camera scoped values are only evaluated when the frame
+    // or camera differs from the one they were last evaluated against.
+    //----------------------------------------------------------------
+    bool                       setFrameParameters (const Ctr::RenderRequest& request) const;
+
+    bool                       setCameraParameters (const Ctr::RenderRequest& request) const;
+
     bool                       setTechniqueParameters (const Ctr::RenderRequest& request) const;
 
     bool                       setMeshParameters (const Ctr::RenderRequest& request) const;
 
+    bool                       setMaterialParameters (const Ctr::RenderRequest& request) const;
+
     //--------------------------------------------
     // Sets up parameters for rendering for a mesh
     //--------------------------------------------
@@ -184,6 +205,21 @@ class ShaderD3D11: public Ctr::IShader
 
     void                        unbindShaderResources();
 
+    //-------------------------------------------------
+    // Uploads dirty constant buffer shadows, one map
+    // per buffer. Called before every pass is applied.
+    //-------------------------------------------------
+    bool                        commitConstantBuffers() const;
+    // The recording command list's scope state, if any.
+    Ctr::ParameterScopeState&   scopeState() const;
+
+    //-------------------------------------------------
+    // Applies the pass on the immediate context, or
+    // through the command list recording on this thread.
+    //-------------------------------------------------
+    void                        applyPass (ID3DX11EffectTechnique* techniqueHandle, 
+                                           uint32_t passIndex) const;
+
   private:
     //------------------------
     // The internal EffectD3D11
@@ -206,6 +242,10 @@ class ShaderD3D11: public Ctr::IShader
     VariableValueList           _shaderParameterValues;
     VariableValueList           _meshParameters;
     VariableValueList           _techniqueParameters;
+    VariableValueList           _materialParameters;
+    VariableValueList           _frameParameters;
+    VariableValueList           _cameraParameters;
+    mutable Ctr::ParameterScopeState _scopeState;
 
     //------------------------------------------------------------------
     // Maintain a cache of parameters that should be
@@ -222,6 +262,9 @@ class ShaderD3D11: public Ctr::IShader
     char *                      _compiledBuffer;
     size_t                      _compiledBufferSize;
 
+    // Bytecode from compile() waiting for the next create().
+    std::vector<char>           _pendingBytecode;
+
 
   protected:
     ID3D11Device*               _direct3d;
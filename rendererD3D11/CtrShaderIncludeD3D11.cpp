@@ -0,0 +1,157 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrShaderIncludeD3D11.h>
+#include <CtrAssetManager.h>
+#include <CtrDataStream.h>
+#include <CtrLog.h>
+
+namespace Ctr
+{
+namespace
+{
+const char* ShaderDirectory = "data/shadersD3D11";
+
+std::string
+directoryOf(const std::string& filePathName)
+{
+    size_t slash = filePathName.rfind('/');
+    return slash == std::string::npos ? std::string() : filePathName.substr(0, slash);
+}
+}
+
+ShaderIncludeD3D11::ShaderIncludeD3D11(const std::string& sourceFilePathName) :
+    _sourceDirectory(directoryOf(normalize(sourceFilePathName)))
+{
+}
+
+ShaderIncludeD3D11::~ShaderIncludeD3D11()
+{
+}
+
+std::string
+ShaderIncludeD3D11::normalize(const std::string& filePathName)
+{
+    std::string path = filePathName;
+    std::replace(path.begin(), path.end(), '\\', '/');
+
+    std::vector<std::string> segments;
+    std::stringstream stream(path);
+    std::string segment;
+    while (std::getline(stream, segment, '/'))
+    {
+        if (segment.empty() || segment == ".")
+            continue;
+        if (segment == ".." && segments.size() > 0 && segments.back() != "..")
+            segments.pop_back();
+        else
+            segments.push_back(segment);
+    }
+
+    std::string normalized = path.length() > 0 && path[0] == '/' ? "/" : "";
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+        normalized += (i > 0 ? "/" : "") + segments[i];
+    }
+    return normalized;
+}
+
+HRESULT __stdcall
+ShaderIncludeD3D11::Open(D3D_INCLUDE_TYPE includeType,
+                         LPCSTR fileName,
+                         LPCVOID parentData,
+                         LPCVOID* data,
+                         UINT* bytes)
+{
+    std::string parentDirectory = _sourceDirectory;
+    auto parent = _directories.find(parentData);
+    if (parent != _directories.end())
+    {
+        parentDirectory = parent->second;
+    }
+
+    // Quoted includes look beside the includer first, system includes only in the shader root.
+    std::vector<std::string> candidates;
+    if (includeType == D3D_INCLUDE_LOCAL && parentDirectory.length() > 0)
+    {
+        candidates.push_back(normalize(parentDirectory + "/" + fileName));
+    }
+    candidates.push_back(normalize(std::string(ShaderDirectory) + "/" + fileName));
+
+    for (auto it = candidates.begin(); it != candidates.end(); it++)
+    {
+        if (!AssetManager::fileExists(*it))
+            continue;
+
+        std::unique_ptr<DataStream> fileStream(AssetManager::assetManager()->openStream(*it));
+        if (!fileStream)
+            continue;
+
+        size_t fileSize = fileStream->size();
+        char* buffer = new char[fileSize + 1];
+        fileStream->read(buffer, fileSize);
+        buffer[fileSize] = 0;
+
+        _files.insert(*it);
+        _directories[buffer] = directoryOf(*it);
+        *data = buffer;
+        *bytes = (UINT)fileSize;
+        return S_OK;
+    }
+
+    LOG("Cannot resolve shader include " << fileName);
+    return E_FAIL;
+}
+
+HRESULT __stdcall
+ShaderIncludeD3D11::Close(LPCVOID data)
+{
+    _directories.erase(data);
+    delete[] (const char*)data;
+    return S_OK;
+}
+
+const std::set<std::string>&
+ShaderIncludeD3D11::files() const
+{
+    return _files;
+}
+}
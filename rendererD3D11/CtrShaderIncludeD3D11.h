@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_SHADER_INCLUDE_D3D11
+#define INCLUDED_CRT_SHADER_INCLUDE_D3D11
+
+#include <CtrPlatform.h>
+
+namespace Ctr
+{
+//-----------------------------------------------------------
+// ID3DInclude that resolves #include "file" against the
+// including file's directory, then data/shadersD3D11, and
+// reads through the AssetManager. Every file it opens is
+// recorded, giving the transitive include set of a compile.
+//-----------------------------------------------------------
+class ShaderIncludeD3D11 : public ID3DInclude
+{
+  public:
+    ShaderIncludeD3D11(const std::string& sourceFilePathName);
+    virtual ~ShaderIncludeD3D11();
+
+    HRESULT __stdcall          Open(D3D_INCLUDE_TYPE includeType,
+                                    LPCSTR fileName,
+                                    LPCVOID parentData,
+                                    LPCVOID* data,
+                                    UINT* bytes);
+    HRESULT __stdcall          Close(LPCVOID data);
+
+    const std::set<std::string>& files() const;
+
+    // Forward slashes, with "." and ".." segments folded.
+    static std::string         normalize(const std::string& filePathName);
+
+  private:
+    std::string                _sourceDirectory;
+    std::set<std::string>      _files;
+    // Directory of each open include, keyed by its buffer, for nested relative includes.
+    std::map<LPCVOID, std::string> _directories;
+};
+}
+
+#endif
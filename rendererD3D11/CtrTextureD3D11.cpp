@@ -648,25 +648,11 @@ TextureD3D11::save(const std::string& filePathName,
         {
             if (parameters->format() == Ctr::PF_A8R8G8B8)
             {
-                for (uint32_t mipId = 0; mipId < textureImage->getNumMipmaps(); mipId++)
-                {
-                    PixelBox mip = textureImage->getPixelBox();
-                    fixupCubeEdges <uint8_t> (textureImage, 
-                                              mipId,
-                                              CP_FIXUP_AVERAGE_HERMITE, 
-                                              Ctr::maxValue(mip.size().x * 0.015f, 1.0f));
-                }
+                fixupCubeEdgesAllMips <uint8_t> (textureImage, CP_FIXUP_AVERAGE_HERMITE, 0.015f);
             }
             else if (parameters->format() == PixelFormat::PF_FLOAT32_RGBA)
             {
-                for (uint32_t mipId = 0; mipId < textureImage->getNumMipmaps(); mipId++)
-                {
-                    PixelBox mip = textureImage->getPixelBox();
-                    fixupCubeEdges <float> (textureImage, 
-                                            mipId,
-                                            CP_FIXUP_AVERAGE_HERMITE, 
-                                            Ctr::maxValue(mip.size().x * 0.015f, 1.0f));
-                }
+                fixupCubeEdgesAllMips <float> (textureImage, CP_FIXUP_AVERAGE_HERMITE, 0.015f);
             }
         }
 
@@ -678,14 +664,14 @@ TextureD3D11::save(const std::string& filePathName,
             switch (threeChannelFormat)
             {
                 case PF_FLOAT32_RGB:
-                    splitChannelsForFormat<typename float>(textureImage, textureImageRGB, textureImageMMM);
+                    splitChannelsForFormat<float>(textureImage, textureImageRGB, textureImageMMM);
                     break;
                 case PF_FLOAT16_RGB:
-                    splitChannelsForFormat<typename uint16_t>(textureImage, textureImageRGB, textureImageMMM);
+                    splitChannelsForFormat<uint16_t>(textureImage, textureImageRGB, textureImageMMM);
                     break;
                 case PF_R8G8B8:
                 case PF_B8G8R8:
-                    splitChannelsForFormat<typename uint8_t>(textureImage, textureImageRGB, textureImageMMM);
+                    splitChannelsForFormat<uint8_t>(textureImage, textureImageRGB, textureImageMMM);
                     break;
             }
 
@@ -44,6 +44,7 @@
 #include <CtrIVertexDeclaration.h>
 #include <CtrFormatConversionD3D11.h>
 #include <CtrLog.h>
+#include <CtrCommandListD3D11.h>
 
 namespace Ctr
 {
@@ -352,7 +353,7 @@ bool VertexBufferD3D11::bind(uint32_t bufferOffset) const
 {
     uint32_t offset = uint32_t(_bufferCursor+bufferOffset);
     uint32_t stride = _vertexDeclaration->vertexStride();
-    _immediateCtx->IASetVertexBuffers(0, 1, &_vertexBuffer, &stride, &offset);
+    Ctr::CommandListD3D11::context (_immediateCtx)->IASetVertexBuffers(0, 1, &_vertexBuffer, &stride, &offset);
     return true;
 }
 
@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrBufferHeadless.h>
+#include <CtrRenderDeviceHeadless.h>
+#include <CtrCommandListHeadless.h>
+
+namespace Ctr
+{
+BufferHeadless::BufferHeadless (Ctr::DeviceHeadless* device) : 
+    Ctr::IGpuBuffer (device),
+    _commandLog (device->commandLog()),
+    _locked (false)
+{
+}
+
+BufferHeadless::~BufferHeadless()
+{
+    free();
+}
+
+bool
+BufferHeadless::initialize (const Ctr::GpuBufferParameters* data)
+{
+    _resource = *data;
+    return create();
+}
+
+bool
+BufferHeadless::create()
+{
+    size_t elementCount = _resource.elementCount();
+    if (_resource.sizeBasedOnBackBuffer())
+    {
+        elementCount = _deviceInterface->backbuffer()->width() *
+            _deviceInterface->backbuffer()->height() * _resource.elementSizeMultiplier();
+    }
+
+    if (_resource.format() == Ctr::PF_UNKNOWN &&
+        _resource.formatWidth() == 0 &&
+        _resource.byteWidth() == 0)
+    {
+        LOG ("Cannot deduce format width from UNKNOWN");
+        return false;
+    }
+
+    size_t byteStride = _resource.format() == Ctr::PF_UNKNOWN ?
+        _resource.formatWidth() : Ctr::PixelUtil::getNumElemBytes(_resource.format());
+
+    size_t byteWidth = byteStride * elementCount;
+    if (byteWidth == 0)
+    {
+        byteWidth = _resource.byteWidth();
+    }
+
+    _data.assign (byteWidth, 0);
+    if (_resource.streamPtr() && byteWidth > 0)
+    {
+        memcpy (&_data[0], _resource.streamPtr(), byteWidth);
+    }
+    return true;
+}
+
+bool
+BufferHeadless::free()
+{
+    std::vector<uint8_t>().swap (_data);
+    _locked = false;
+    return true;
+}
+
+bool
+BufferHeadless::cache()
+{
+    return true;
+}
+
+void*
+BufferHeadless::lock()
+{
+    if (_data.empty())
+        return nullptr;
+
+    // Lists map the buffer independently and copy in when they execute,
+    // as deferred contexts do with write discard maps.
+    if (Ctr::CommandListHeadless* commandList = Ctr::CommandListHeadless::recording())
+        return commandList->map (this, _data.size());
+
+    if (_locked)
+        return nullptr;
+
+    _commandLog->record (Ctr::CommandLogHeadless::Map, this, uint32_t(_data.size()));
+    _locked = true;
+    return &_data[0];
+}
+
+bool
+BufferHeadless::unlock()
+{
+    if (Ctr::CommandListHeadless::recording())
+        return true;
+
+    if (!_locked)
+        return false;
+    _locked = false;
+    return true;
+}
+
+bool
+BufferHeadless::bind() const
+{
+    _commandLog->record (Ctr::CommandLogHeadless::BindBuffer, this);
+    return true;
+}
+
+bool
+BufferHeadless::bindToStreamOut() const
+{
+    _commandLog->record (Ctr::CommandLogHeadless::BindBuffer, this);
+    return true;
+}
+
+size_t
+BufferHeadless::size() const
+{
+    return _data.size();
+}
+
+const uint8_t*
+BufferHeadless::data() const
+{
+    return _data.empty() ? nullptr : &_data[0];
+}
+
+void
+BufferHeadless::clearUnorderedAccessViewFloat(float clearValue)
+{
+    float* values = (float*)data();
+    std::fill (values, values + _data.size() / sizeof(float), clearValue);
+    _commandLog->record (Ctr::CommandLogHeadless::Clear, this, uint32_t(_data.size()));
+}
+
+void
+BufferHeadless::clearUnorderedAccessViewUint(uint32_t clearValue)
+{
+    uint32_t* values = (uint32_t*)data();
+    std::fill (values, values + _data.size() / sizeof(uint32_t), clearValue);
+    _commandLog->record (Ctr::CommandLogHeadless::Clear, this, uint32_t(_data.size()));
+}
+
+}
@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_BUFFER_RESOURCE_HEADLESS
+#define INCLUDED_CRT_BUFFER_RESOURCE_HEADLESS
+
+#include <CtrPlatform.h>
+#include <CtrIGpuBuffer.h>
+
+namespace Ctr
+{
+class DeviceHeadless;
+class CommandLogHeadless;
+
+class BufferHeadless : public Ctr::IGpuBuffer
+{
+  public:
+    BufferHeadless (Ctr::DeviceHeadless* device);
+    virtual ~BufferHeadless();
+
+    virtual bool               initialize (const Ctr::GpuBufferParameters* data);
+    virtual bool               create();
+    virtual bool               free();
+    virtual bool               cache();
+
+    virtual void*              lock();
+    virtual bool               unlock();
+
+    virtual bool               bind() const;
+    virtual bool               bindToStreamOut() const;
+
+    virtual size_t             size() const;
+    const uint8_t*             data() const;
+
+    virtual bool               recreateOnResize() { return _resource.sizeBasedOnBackBuffer(); }
+    virtual void               clearUnorderedAccessViewFloat(float clearValue);
+    virtual void               clearUnorderedAccessViewUint(uint32_t clearValue);
+
+  private:
+    friend class CommandListHeadless;
+
+    Ctr::CommandLogHeadless*   _commandLog;
+    Ctr::GpuBufferParameters   _resource;
+    std::vector<uint8_t>       _data;
+    bool                       _locked;
+};
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrCommandListHeadless.h>
+#include <CtrRenderDeviceHeadless.h>
+#include <CtrBufferHeadless.h>
+#include <CtrGpuVariableHeadless.h>
+
+namespace Ctr
+{
+CommandListHeadless::CommandListHeadless (Ctr::DeviceHeadless* device) :
+    Ctr::ICommandList (device),
+    _commandLog (device->commandLog()),
+    _stagingCount (0)
+{
+}
+
+CommandListHeadless::~CommandListHeadless()
+{
+}
+
+bool
+CommandListHeadless::begin()
+{
+    _commands.clear();
+    _values.clear();
+    _stagingCount = 0;
+    _boundResources.clear();
+    return Ctr::ICommandList::begin();
+}
+
+void
+CommandListHeadless::record (Ctr::CommandLogHeadless::Type type, 
+                             const void* object, 
+                             uint32_t count)
+{
+    Command command = { type, count, object, nullptr, 0 };
+    _commands.push_back (command);
+}
+
+void
+CommandListHeadless::setValue (const Ctr::GpuVariableHeadless* variable,
+                               const void* data, 
+                               size_t size)
+{
+    Command command = { Ctr::CommandLogHeadless::SetVariable, uint32_t(size), variable, nullptr, _values.size() };
+    _commands.push_back (command);
+    _values.insert (_values.end(), (const uint8_t*)data, (const uint8_t*)data + size);
+}
+
+void
+CommandListHeadless::setResource (Ctr::CommandLogHeadless::Type type,
+                                  const Ctr::GpuVariableHeadless* variable,
+                                  const void* resource)
+{
+    Command command = { type, 0, variable, resource, 0 };
+    _commands.push_back (command);
+    _boundResources[variable] = resource;
+}
+
+const void*
+CommandListHeadless::boundResource (const Ctr::GpuVariableHeadless* variable,
+                                    const void* immediateResource) const
+{
+    auto it = _boundResources.find (variable);
+    return it != _boundResources.end() ? it->second : immediateResource;
+}
+
+void*
+CommandListHeadless::map (Ctr::BufferHeadless* buffer, size_t size)
+{
+    if (_stagingCount == _staging.size())
+    {
+        _staging.push_back (std::vector<uint8_t>());
+    }
+    std::vector<uint8_t>& staging = _staging[_stagingCount];
+    staging.assign (size, 0);
+
+    Command command = { Ctr::CommandLogHeadless::Map, uint32_t(size), buffer, nullptr, _stagingCount++ };
+    _commands.push_back (command);
+    return &staging[0];
+}
+
+size_t
+CommandListHeadless::commandCount() const
+{
+    return _commands.size();
+}
+
+CommandListHeadless*
+CommandListHeadless::recording()
+{
+    return dynamic_cast<CommandListHeadless*>(Ctr::ICommandList::recording());
+}
+
+bool
+CommandListHeadless::executeRecorded()
+{
+    for (auto it = _commands.begin(); it != _commands.end(); it++)
+    {
+        const Command& command = *it;
+        switch (command.type)
+        {
+            case Ctr::CommandLogHeadless::SetVariable:
+            {
+                const Ctr::GpuVariableHeadless* variable = (const Ctr::GpuVariableHeadless*)command.object;
+                variable->_value.assign (_values.begin() + command.offset, 
+                                         _values.begin() + command.offset + command.count);
+                break;
+            }
+            case Ctr::CommandLogHeadless::SetTexture:
+            case Ctr::CommandLogHeadless::SetResource:
+                ((const Ctr::GpuVariableHeadless*)command.object)->_boundResource = command.resource;
+                break;
+            case Ctr::CommandLogHeadless::Map:
+            {
+                Ctr::BufferHeadless* buffer = (Ctr::BufferHeadless*)command.object;
+                const std::vector<uint8_t>& staging = _staging[command.offset];
+                memcpy (&buffer->_data[0], &staging[0], std::min (staging.size(), buffer->_data.size()));
+                break;
+            }
+            default:
+                break;
+        }
+        _commandLog->record (command.type, command.object, command.count);
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_COMMAND_LIST_HEADLESS
+#define INCLUDED_COMMAND_LIST_HEADLESS
+
+#include <CtrPlatform.h>
+#include <CtrICommandList.h>
+#include <CtrCommandLogHeadless.h>
+#include <deque>
+
+namespace Ctr
+{
+class DeviceHeadless;
+class BufferHeadless;
+class GpuVariableHeadless;
+
+//------------------------------------------------------------------------
+// Headless stand in for a deferred context. While it records, the
+// command log hands it every command, variable values and resources are
+// kept here rather than on the variables, and mapped buffers are staged.
+// Executing replays all of it in order into the device's command log,
+// so a frame recorded in parallel logs what a serial one would, plus
+// the rebinds each list starts with.
+//------------------------------------------------------------------------
+class CommandListHeadless : public Ctr::ICommandList
+{
+  public:
+    CommandListHeadless (Ctr::DeviceHeadless* device);
+    virtual ~CommandListHeadless();
+
+    virtual bool                begin();
+
+    // Recording thread.
+    void                        record (Ctr::CommandLogHeadless::Type type, 
+                                        const void* object, 
+                                        uint32_t count);
+    void                        setValue (const Ctr::GpuVariableHeadless* variable,
+                                          const void* data, 
+                                          size_t size);
+    void                        setResource (Ctr::CommandLogHeadless::Type type,
+                                             const Ctr::GpuVariableHeadless* variable,
+                                             const void* resource);
+    // What the list last set on variable, otherwise the immediate resource.
+    const void*                 boundResource (const Ctr::GpuVariableHeadless* variable,
+                                               const void* immediateResource) const;
+    void*                       map (Ctr::BufferHeadless* buffer, size_t size);
+
+    size_t                      commandCount() const;
+
+    static CommandListHeadless* recording();
+
+  protected:
+    virtual bool                executeRecorded();
+
+  private:
+    struct Command
+    {
+        Ctr::CommandLogHeadless::Type type;
+        uint32_t                count;
+        const void*             object;
+        // Bound resource, or the offset of a value or staged map.
+        const void*             resource;
+        size_t                  offset;
+    };
+
+    Ctr::CommandLogHeadless*    _commandLog;
+    std::vector<Command>        _commands;
+    std::vector<uint8_t>        _values;
+    // Maps must stay put until the buffer is unlocked.
+    std::deque<std::vector<uint8_t> > _staging;
+    size_t                      _stagingCount;
+    std::map<const Ctr::GpuVariableHeadless*, const void*> _boundResources;
+};
+
+}
+
+#endif
@@ -0,0 +1,317 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrCommandLogHeadless.h>
+#include <CtrCommandListHeadless.h>
+#include <iomanip>
+
+namespace Ctr
+{
+namespace
+{
+const char* commandNames[CommandLogHeadless::TypeCount] =
+{
+    "Draw",
+    "DrawIndexed",
+    "DrawInstanced",
+    "Dispatch",
+    "BindVertexBuffer",
+    "BindIndexBuffer",
+    "BindVertexDeclaration",
+    "BindBuffer",
+    "BindFrameBuffer",
+    "BindComputeShader",
+    "ApplyTechnique",
+    "SetVariable",
+    "SetTexture",
+    "SetResource",
+    "SetState",
+    "SetViewport",
+    "Clear",
+    "Blit",
+    "Map"
+};
+
+const uint32_t MaxCommandCount = (1u << 24) - 1;
+}
+
+CommandLogHeadless::FrameStats::FrameStats() :
+    frame (0),
+    cpuTimeMs (0),
+    commands (0),
+    draws (0),
+    binds (0),
+    stateChanges (0),
+    primitives (0)
+{
+    memset (counts, 0, sizeof(counts));
+}
+
+double
+CommandLogHeadless::FrameStats::drawsPerMs() const
+{
+    return cpuTimeMs > 0 ? double(draws) / cpuTimeMs : 0;
+}
+
+double
+CommandLogHeadless::FrameStats::bindsPerDraw() const
+{
+    return draws > 0 ? double(binds) / double(draws) : 0;
+}
+
+CommandLogHeadless::CommandLogHeadless() :
+    _recording (true),
+    _inFrame (false)
+{
+    _commands.reserve (4096);
+}
+
+CommandLogHeadless::~CommandLogHeadless()
+{
+}
+
+void
+CommandLogHeadless::beginFrame()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_inFrame)
+    {
+        finishFrame();
+    }
+
+    uint64_t frame = _totals.frame;
+    _current = FrameStats();
+    _current.frame = frame;
+    _commands.clear();
+    _inFrame = true;
+    _frameStart = Clock::now();
+}
+
+void
+CommandLogHeadless::endFrame()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    finishFrame();
+}
+
+void
+CommandLogHeadless::finishFrame()
+{
+    if (!_inFrame)
+        return;
+
+    _current.cpuTimeMs = 
+        std::chrono::duration<double, std::milli>(Clock::now() - _frameStart).count();
+    _last = _current;
+
+    _totals.frame++;
+    _totals.cpuTimeMs += _current.cpuTimeMs;
+    _totals.commands += _current.commands;
+    _totals.draws += _current.draws;
+    _totals.binds += _current.binds;
+    _totals.stateChanges += _current.stateChanges;
+    _totals.primitives += _current.primitives;
+    for (uint32_t i = 0; i < TypeCount; i++)
+    {
+        _totals.counts[i] += _current.counts[i];
+    }
+
+    _inFrame = false;
+}
+
+void
+CommandLogHeadless::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _commands.clear();
+    _current = FrameStats();
+    _last = FrameStats();
+    _totals = FrameStats();
+    _inFrame = false;
+}
+
+void
+CommandLogHeadless::record (Type type, const void* object, uint32_t count)
+{
+    if (CommandListHeadless* commandList = CommandListHeadless::recording())
+    {
+        commandList->record (type, object, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _current.commands++;
+    _current.counts[type]++;
+
+    if (isDraw (type))
+    {
+        _current.draws++;
+        _current.primitives += count;
+    }
+    else if (isBind (type))
+    {
+        _current.binds++;
+    }
+    else if (type == SetState)
+    {
+        _current.stateChanges++;
+    }
+
+    if (_recording)
+    {
+        uint64_t ns = _inFrame ? 
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _frameStart).count() : 0;
+
+        Command command;
+        command.type = type;
+        command.count = std::min(count, MaxCommandCount);
+        command.time = uint32_t(std::min(ns, uint64_t(UINT_MAX)));
+        command.object = object;
+        _commands.push_back (command);
+    }
+}
+
+void
+CommandLogHeadless::setRecording (bool recording)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _recording = recording;
+    if (!_recording)
+    {
+        _commands.clear();
+    }
+}
+
+bool
+CommandLogHeadless::recording() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _recording;
+}
+
+const std::vector<CommandLogHeadless::Command>&
+CommandLogHeadless::commands() const
+{
+    return _commands;
+}
+
+const CommandLogHeadless::FrameStats&
+CommandLogHeadless::currentFrame() const
+{
+    return _current;
+}
+
+const CommandLogHeadless::FrameStats&
+CommandLogHeadless::lastFrame() const
+{
+    return _last;
+}
+
+const CommandLogHeadless::FrameStats&
+CommandLogHeadless::totals() const
+{
+    return _totals;
+}
+
+void
+CommandLogHeadless::writeSummary (std::ostream& stream) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const FrameStats& frame = _last;
+    double frames = double(std::max(_totals.frame, uint64_t(1)));
+
+    stream << std::fixed << std::setprecision(3);
+    stream << "Headless frames: " << _totals.frame 
+           << ", avg cpu ms: " << _totals.cpuTimeMs / frames 
+           << ", draws/ms: " << _totals.drawsPerMs()
+           << ", binds/draw: " << _totals.bindsPerDraw() << "\n";
+    stream << "Last frame " << frame.frame << ": " << frame.cpuTimeMs << " ms, "
+           << frame.commands << " commands, " << frame.draws << " draws, "
+           << frame.primitives << " primitives, " << frame.binds << " binds, "
+           << frame.stateChanges << " state changes\n";
+    stream << "    " << std::left << std::setw(24) << "Command" << std::right
+           << std::setw(12) << "Last frame" << std::setw(16) << "Avg per frame" << "\n";
+
+    for (uint32_t i = 0; i < TypeCount; i++)
+    {
+        if (_totals.counts[i] > 0)
+        {
+            stream << "    " << std::left << std::setw(24) << commandNames[i] << std::right
+                   << std::setw(12) << frame.counts[i] 
+                   << std::setw(16) << double(_totals.counts[i]) / frames << "\n";
+        }
+    }
+}
+
+const char*
+CommandLogHeadless::typeName (Type type)
+{
+    return type < TypeCount ? commandNames[type] : "Unknown";
+}
+
+bool
+CommandLogHeadless::isBind (Type type)
+{
+    switch (type)
+    {
+        case BindVertexBuffer:
+        case BindIndexBuffer:
+        case BindVertexDeclaration:
+        case BindBuffer:
+        case BindFrameBuffer:
+        case BindComputeShader:
+        case ApplyTechnique:
+        case SetVariable:
+        case SetTexture:
+        case SetResource:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool
+CommandLogHeadless::isDraw (Type type)
+{
+    return type == Draw || type == DrawIndexed || type == DrawInstanced;
+}
+
+}
@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_COMMAND_LOG_HEADLESS
+#define INCLUDED_COMMAND_LOG_HEADLESS
+
+#include <CtrPlatform.h>
+#include <chrono>
+#include <mutex>
+
+namespace Ctr
+{
+//------------------------------------------------------------------------
+// Compact record of every draw, bind and state call made against the
+// headless device. Counts are always kept; the per command stream (type,
+// object, count and a nanosecond offset from the start of the frame) is
+// only kept while recording is enabled.
+//
+// record may be called from several threads at once (draw calls on the
+// device are const and reach the log from wherever they are issued), so
+// every mutation takes the log lock. The accessors hand out references
+// and are meant to be read between frames. Commands recorded into a
+// CommandListHeadless reach the log when the list executes.
+//------------------------------------------------------------------------
+class CommandLogHeadless
+{
+  public:
+    enum Type
+    {
+        Draw = 0,
+        DrawIndexed,
+        DrawInstanced,
+        Dispatch,
+        BindVertexBuffer,
+        BindIndexBuffer,
+        BindVertexDeclaration,
+        BindBuffer,
+        BindFrameBuffer,
+        BindComputeShader,
+        ApplyTechnique,
+        SetVariable,
+        SetTexture,
+        SetResource,
+        SetState,
+        SetViewport,
+        Clear,
+        Blit,
+        Map,
+        TypeCount
+    };
+
+    struct Command
+    {
+        uint32_t               type  : 8;
+        uint32_t               count : 24;
+        uint32_t               time;
+        const void*            object;
+    };
+
+    struct FrameStats
+    {
+        FrameStats();
+
+        double                 drawsPerMs() const;
+        double                 bindsPerDraw() const;
+
+        uint64_t               frame;
+        double                 cpuTimeMs;
+        uint64_t               commands;
+        uint64_t               draws;
+        uint64_t               binds;
+        uint64_t               stateChanges;
+        uint64_t               primitives;
+        uint64_t               counts[TypeCount];
+    };
+
+  public:
+    CommandLogHeadless();
+    ~CommandLogHeadless();
+
+    void                       beginFrame();
+    void                       endFrame();
+    void                       reset();
+
+    void                       record (Type type, const void* object = nullptr, uint32_t count = 0);
+
+    // Keep the per command stream as well as the counts.
+    void                       setRecording (bool recording);
+    bool                       recording() const;
+
+    // Commands recorded since the last beginFrame.
+    const std::vector<Command>& commands() const;
+
+    // Stats for the frame in flight, the last completed frame
+    // and every frame since the last reset.
+    const FrameStats&          currentFrame() const;
+    const FrameStats&          lastFrame() const;
+    const FrameStats&          totals() const;
+
+    void                       writeSummary (std::ostream& stream) const;
+
+    static const char*         typeName (Type type);
+    static bool                isBind (Type type);
+    static bool                isDraw (Type type);
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    void                       finishFrame();
+
+    mutable std::mutex         _mutex;
+    bool                       _recording;
+    bool                       _inFrame;
+    Clock::time_point          _frameStart;
+    std::vector<Command>       _commands;
+    FrameStats                 _current;
+    FrameStats                 _last;
+    FrameStats                 _totals;
+};
+
+}
+
+#endif
@@ -0,0 +1,232 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrComputeShaderHeadless.h>
+#include <CtrRenderDeviceHeadless.h>
+#include <CtrCommandLogHeadless.h>
+#include <CtrAssetManager.h>
+#include <CtrLog.h>
+
+namespace Ctr
+{
+ComputeShaderHeadless::ComputeShaderHeadless (Ctr::DeviceHeadless* device) :
+    Ctr::IComputeShader(device),
+    _device(device),
+    _constantBuffer(nullptr)
+{
+}
+
+ComputeShaderHeadless::~ComputeShaderHeadless()
+{
+    free();
+    safedelete(_constantBuffer);
+}
+
+bool
+ComputeShaderHeadless::create() 
+{ 
+    if (_filePathName.length() > 0)
+    {
+        std::string includeStream;
+        if (_includeFilePathName.length() > 0)
+        {
+            if (std::unique_ptr<DataStream> fileStream =
+                std::unique_ptr<DataStream>(AssetManager::assetManager()->openStream(_includeFilePathName)))
+            {
+                includeStream.resize(fileStream->size());
+                if (includeStream.size() > 0)
+                    fileStream->read(&includeStream[0], includeStream.size());
+            }
+        }
+
+        std::string shaderStream;
+        if (std::unique_ptr<DataStream> fileStream =
+            std::unique_ptr<DataStream>(AssetManager::assetManager()->openStream(_filePathName)))
+        {
+            shaderStream.resize(fileStream->size());
+            if (shaderStream.size() > 0)
+                fileStream->read(&shaderStream[0], shaderStream.size());
+        }
+        else
+        {
+            LOG("Headless compute shader source " << _filePathName << " not found");
+        }
+
+        _stream = includeStream + "\n" + shaderStream;
+    }
+
+    _dependencies.clear();
+    if (_filePathName.length() > 0)
+        _dependencies.insert(_filePathName);
+    if (_includeFilePathName.length() > 0)
+        _dependencies.insert(_includeFilePathName);
+
+    _hash.build(_stream);
+    return true;
+}
+
+bool
+ComputeShaderHeadless::free() 
+{ 
+    return true;
+}
+
+bool
+ComputeShaderHeadless::cache() 
+{
+    return true;
+}
+
+const std::string&
+ComputeShaderHeadless::filePathName() const
+{
+    return _filePathName;
+}
+
+const std::string&
+ComputeShaderHeadless::includePathName() const
+{
+    return _includeFilePathName;
+}
+
+bool
+ComputeShaderHeadless::initializeFromFile (const std::string& shaderFilePathName,
+                                           const std::string& includeFilePathName,
+                                           const std::string& functionName,
+                                           const std::map<std::string, std::string> & defines)
+{
+    _filePathName = shaderFilePathName;
+    _includeFilePathName = includeFilePathName;
+    _stream = "";
+    _functionName = functionName;
+    _defines = defines;
+
+    return create();
+}
+
+bool
+ComputeShaderHeadless::initializeFromStream (const std::string& stream,
+                                             const std::string& functionName,
+                                             const std::map<std::string, std::string> & defines)
+{
+    _filePathName = "";
+    _stream = stream;
+    _functionName = functionName;
+    _defines = defines;
+
+    return create();
+}
+
+bool
+ComputeShaderHeadless::createConstantBuffer(size_t size)
+{
+    if (!_constantBuffer)
+    {
+        Ctr::GpuBufferParameters constantBufferResourceData =
+            Ctr::GpuBufferParameters::setupConstantBuffer
+            (static_cast<size_t>(size + (16 - (size % 16))));
+
+        _constantBuffer = _deviceInterface->createBufferResource(&constantBufferResourceData);
+    }
+
+    return _constantBuffer != nullptr;
+}
+
+bool
+ComputeShaderHeadless::updateConstantBuffer(void* src, size_t bytes)
+{
+    if (_constantBuffer)
+    {
+        if (void * data = _constantBuffer->lock())
+        {
+            memcpy(data, src, bytes);
+            _constantBuffer->unlock();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+ComputeShaderHeadless::bind() const
+{
+    _device->commandLog()->record(Ctr::CommandLogHeadless::BindComputeShader, this);
+    if (_constantBuffer)
+        _constantBuffer->bind();
+    return true;
+}
+
+bool
+ComputeShaderHeadless::unbind() const
+{
+    _device->commandLog()->record(Ctr::CommandLogHeadless::BindComputeShader, nullptr);
+    return true;
+}
+
+bool
+ComputeShaderHeadless::dispatch(const Ctr::Vector3i& groupBounds) const
+{
+    _device->commandLog()->record(Ctr::CommandLogHeadless::Dispatch, this,
+                                  uint32_t(groupBounds.x * groupBounds.y * groupBounds.z));
+    return true;
+}
+
+bool
+ComputeShaderHeadless::setResources(const std::vector<const Ctr::IRenderResource*>& resources) const
+{
+    for (size_t i = 0; i < resources.size(); i++)
+    {
+        _device->commandLog()->record(Ctr::CommandLogHeadless::SetResource, resources[i]);
+    }
+    return true;
+}
+
+bool
+ComputeShaderHeadless::setViews(const std::vector<const Ctr::IRenderResource*>& views) const
+{
+    for (size_t i = 0; i < views.size(); i++)
+    {
+        _device->commandLog()->record(Ctr::CommandLogHeadless::SetResource, views[i]);
+    }
+    return true;
+}
+
+}
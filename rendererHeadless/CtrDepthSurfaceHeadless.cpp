@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrDepthSurfaceHeadless.h>
+#include <CtrRenderDeviceHeadless.h>
+
+namespace Ctr
+{
+DepthSurfaceHeadless::DepthSurfaceHeadless (Ctr::DeviceHeadless* device) : 
+    Ctr::IDepthSurface (device),
+    _commandLog (device->commandLog()),
+    _initializationData (nullptr),
+    _width (0),
+    _height (0)
+{
+}
+
+DepthSurfaceHeadless::~DepthSurfaceHeadless()
+{
+    safedelete (_initializationData);
+}
+
+bool
+DepthSurfaceHeadless::initialize (const Ctr::DepthSurfaceParameters* resource)
+{
+    safedelete (_initializationData);
+    _initializationData = new DepthSurfaceParameters(*resource);
+    return create();
+}
+
+bool
+DepthSurfaceHeadless::create()
+{
+    if (!_initializationData)
+        return false;
+
+    _width = _initializationData->width();
+    _height = _initializationData->height();
+
+    if ((_width == 0 || _height == 0) && _deviceInterface->backbuffer())
+    {
+        _width = _deviceInterface->backbuffer()->width();
+        _height = _deviceInterface->backbuffer()->height();
+    }
+    return _width > 0 && _height > 0;
+}
+
+bool
+DepthSurfaceHeadless::free()
+{
+    return true;
+}
+
+bool
+DepthSurfaceHeadless::cache()
+{
+    return true;
+}
+
+bool
+DepthSurfaceHeadless::recreateOnResize()
+{
+    return _initializationData && _initializationData->createFromBackBuffer();
+}
+
+bool
+DepthSurfaceHeadless::bind (uint32_t index) const
+{
+    _deviceInterface->bindDepthSurface (this);
+    return true;
+}
+
+void
+DepthSurfaceHeadless::setSize (const Ctr::Vector2i& size)
+{
+    if (_initializationData)
+    {
+        _initializationData->setWidth (size.x);
+        _initializationData->setHeight (size.y);
+    }
+    _width = size.x;
+    _height = size.y;
+}
+
+bool
+DepthSurfaceHeadless::clear()
+{
+    _commandLog->record (Ctr::CommandLogHeadless::Clear, this);
+    return true;
+}
+
+bool
+DepthSurfaceHeadless::clearStencil()
+{
+    _commandLog->record (Ctr::CommandLogHeadless::Clear, this);
+    return true;
+}
+
+int
+DepthSurfaceHeadless::multiSampleCount() const
+{
+    return _initializationData ? _initializationData->multiSampleCount() : 1;
+}
+
+int
+DepthSurfaceHeadless::multiSampleQuality() const
+{
+    return _initializationData ? _initializationData->multiSampleQuality() : 0;
+}
+
+int
+DepthSurfaceHeadless::width() const
+{
+    return _width;
+}
+
+int
+DepthSurfaceHeadless::height() const
+{
+    return _height;
+}
+
+}
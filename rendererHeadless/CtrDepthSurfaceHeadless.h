@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_DEPTHSURFACE_HEADLESS
+#define INCLUDED_CRT_DEPTHSURFACE_HEADLESS
+
+#include <CtrPlatform.h>
+#include <CtrIDepthSurface.h>
+
+namespace Ctr
+{
+class DeviceHeadless;
+class CommandLogHeadless;
+
+//--------------------------------------------------------------
+// Depth surfaces are never read back on the CPU, so only their
+// dimensions are kept. Clears and binds are recorded.
+//--------------------------------------------------------------
+class DepthSurfaceHeadless : public Ctr::IDepthSurface
+{
+  public:
+    DepthSurfaceHeadless (Ctr::DeviceHeadless* device);
+    virtual ~DepthSurfaceHeadless();
+
+    virtual bool               initialize (const Ctr::DepthSurfaceParameters* resource);
+    virtual bool               create();
+    virtual bool               free();
+    virtual bool               cache();
+    virtual bool               recreateOnResize();
+
+    virtual bool               bind (uint32_t index) const;
+    virtual void               setSize (const Ctr::Vector2i& size);
+    virtual bool               clear();
+    virtual bool               clearStencil();
+
+    virtual int                multiSampleCount() const;
+    virtual int                multiSampleQuality() const;
+    virtual int                width() const;
+    virtual int                height() const;
+
+  private:
+    Ctr::CommandLogHeadless*   _commandLog;
+    Ctr::DepthSurfaceParameters* _initializationData;
+    int                        _width;
+    int                        _height;
+};
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrGpuConstantBufferHeadless.h>
+#include <CtrRenderDeviceHeadless.h>
+
+namespace Ctr
+{
+ConstantBufferHeadless::ConstantBufferHeadless (Ctr::DeviceHeadless* device,
+                                                const std::string& name) :
+    Ctr::GpuConstantBuffer (device),
+    _commandLog (device->commandLog()),
+    _name (name),
+    _parameterType (Ctr::UnknownParameter),
+    _size (0),
+    _packable (true),
+    _boundBuffer (nullptr)
+{
+}
+
+ConstantBufferHeadless::~ConstantBufferHeadless()
+{
+    free();
+}
+
+void
+ConstantBufferHeadless::setParameterType (Ctr::ShaderParameter type)
+{
+    _parameterType = type;
+}
+
+bool
+ConstantBufferHeadless::free()
+{
+    _members.clear();
+    _boundBuffer = nullptr;
+    return true;
+}
+
+void
+ConstantBufferHeadless::setConstantBuffer (const Ctr::IGpuBuffer* buffer) const
+{
+    if (buffer)
+    {
+        // The caller owns the contents from here on.
+        _shadow.clear();
+        _dirtyBegin = _dirtyEnd = 0;
+
+        _boundBuffer = buffer;
+        _commandLog->record (Ctr::CommandLogHeadless::BindBuffer, this);
+    }
+}
+
+void
+ConstantBufferHeadless::bindShadowBuffer (const Ctr::IGpuBuffer* buffer) const
+{
+    _boundBuffer = buffer;
+    _commandLog->record (Ctr::CommandLogHeadless::BindBuffer, this);
+}
+
+const std::string&
+ConstantBufferHeadless::semantic() const
+{
+    return _semantic;
+}
+
+const std::string&
+ConstantBufferHeadless::name() const
+{
+    return _name;
+}
+
+const std::string&
+ConstantBufferHeadless::annotation (const std::string& key)
+{
+    return _annotations[key];
+}
+
+void
+ConstantBufferHeadless::add (Ctr::GpuVariable* variable,
+                             const Ctr::GpuVariable::BufferLayout& layout)
+{
+    uint32_t registers = layout.columnMajor ? layout.columns : layout.rows;
+    uint32_t offset = _size;
+    if (layout.elements > 0 || registers > 1 || (offset & 15) + layout.size > 16)
+    {
+        offset = (offset + 15) & ~15;
+    }
+
+    Member member = { variable, offset, layout };
+    _members.push_back (member);
+    _size = offset + layout.size;
+}
+
+void
+ConstantBufferHeadless::addUnknown()
+{
+    _packable = false;
+}
+
+bool
+ConstantBufferHeadless::finalize()
+{
+    if (!_packable || _size == 0)
+    {
+        _members.clear();
+        return false;
+    }
+
+    initializeShadow (_size);
+    for (auto it = _members.begin(); it != _members.end(); it++)
+    {
+        it->variable->attach (this, it->offset, it->layout);
+    }
+    return true;
+}
+
+uint32_t
+ConstantBufferHeadless::size() const
+{
+    return uint32_t(_shadow.size());
+}
+
+const Ctr::IGpuBuffer*
+ConstantBufferHeadless::boundBuffer() const
+{
+    return _boundBuffer;
+}
+
+}
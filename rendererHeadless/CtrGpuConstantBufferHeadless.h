@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CONSTANT_BUFFER_HEADLESS
+#define INCLUDED_CONSTANT_BUFFER_HEADLESS
+
+#include <CtrPlatform.h>
+#include <CtrGpuConstantBuffer.h>
+#include <CtrGpuVariable.h>
+
+namespace Ctr
+{
+class DeviceHeadless;
+class CommandLogHeadless;
+
+//-----------------------------------------------------------
+// cbuffer (or $Globals) declared in a headless shader's
+// source. Members are packed with the HLSL rules as they are
+// declared, and the shadow is sized once the block closes.
+//-----------------------------------------------------------
+class ConstantBufferHeadless : public Ctr::GpuConstantBuffer
+{
+  public:
+    ConstantBufferHeadless (Ctr::DeviceHeadless* device,
+                            const std::string& name);
+    virtual ~ConstantBufferHeadless();
+
+    void                        setParameterType (Ctr::ShaderParameter type);
+
+    virtual bool                create(){ return true; };
+    virtual bool                cache(){ return true; };
+    virtual bool                free();
+
+    virtual void                setConstantBuffer (const Ctr::IGpuBuffer* buffer) const;
+
+    const std::string&          semantic() const;
+    const std::string&          name() const;
+    const std::string&          annotation (const std::string&);
+
+    //-----------------------------------------------------
+    // Places a member after the previous ones. A register
+    // is never straddled and arrays and matrices start on
+    // a register boundary.
+    //-----------------------------------------------------
+    void                        add (Ctr::GpuVariable* variable,
+                                     const Ctr::GpuVariable::BufferLayout& layout);
+
+    //-----------------------------------------------------
+    // A member whose layout is unknown leaves the whole
+    // buffer unshadowed.
+    //-----------------------------------------------------
+    void                        addUnknown();
+
+    //-----------------------------------------------------
+    // Sizes the shadow and attaches the members to it.
+    //-----------------------------------------------------
+    bool                        finalize();
+
+    uint32_t                    size() const;
+    const Ctr::IGpuBuffer*      boundBuffer() const;
+
+  protected:
+    virtual void                bindShadowBuffer (const Ctr::IGpuBuffer* buffer) const;
+
+  private:
+    struct Member
+    {
+        Ctr::GpuVariable*                 variable;
+        uint32_t                          offset;
+        Ctr::GpuVariable::BufferLayout    layout;
+    };
+
+    typedef std::map<std::string, std::string>  StringMap;
+
+    Ctr::CommandLogHeadless*    _commandLog;
+    std::string                 _name;
+    std::string                 _semantic;
+    StringMap                   _annotations;
+    Ctr::ShaderParameter        _parameterType;
+    std::vector<Member>         _members;
+    uint32_t                    _size;
+    bool                        _packable;
+    mutable const Ctr::IGpuBuffer* _boundBuffer;
+};
+
+}
+
+#endif
@@ -0,0 +1,242 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrGpuVariableHeadless.h>
+#include <CtrRenderDeviceHeadless.h>
+#include <CtrCommandListHeadless.h>
+
+namespace Ctr
+{
+GpuVariableHeadless::GpuVariableHeadless (Ctr::DeviceHeadless* device,
+                                          const std::string& name,
+                                          const std::string& semantic) :
+    Ctr::GpuVariable (device),
+    _commandLog (device->commandLog()),
+    _name (name),
+    _semantic (semantic),
+    _parameterType (Ctr::UnknownParameter),
+    _boundResource (nullptr)
+{
+}
+
+GpuVariableHeadless::~GpuVariableHeadless()
+{
+}
+
+void
+GpuVariableHeadless::setParameterType (Ctr::ShaderParameter type)
+{
+    _parameterType = type;
+}
+
+Ctr::ShaderParameter
+GpuVariableHeadless::parameterType() const
+{
+    return _parameterType;
+}
+
+bool
+GpuVariableHeadless::free()
+{
+    std::vector<uint8_t>().swap (_value);
+    _boundResource = nullptr;
+    return true;
+}
+
+void
+GpuVariableHeadless::setValue (const void* data, size_t size) const
+{
+    if (Ctr::CommandListHeadless* commandList = Ctr::CommandListHeadless::recording())
+    {
+        commandList->setValue (this, data, size);
+        return;
+    }
+
+    _value.resize (size);
+    if (size > 0)
+    {
+        memcpy (&_value[0], data, size);
+    }
+    _commandLog->record (Ctr::CommandLogHeadless::SetVariable, this, uint32_t(size));
+}
+
+void
+GpuVariableHeadless::set (const void* data, uint32_t size) const
+{
+    setValue (data, size);
+    writeValue (data, size);
+}
+
+void
+GpuVariableHeadless::setMatrix(const float* data) const
+{
+    setValue (data, sizeof(float) * 16);
+    writeMatrix (data);
+}
+
+void
+GpuVariableHeadless::setMatrixArray (const float* data, uint32_t size) const
+{
+    setValue (data, sizeof(float) * 16 * size);
+    writeMatrixArray (data, size);
+}
+
+void
+GpuVariableHeadless::setVectorArray (const float* data, uint32_t size) const
+{
+    setValue (data, sizeof(float) * 4 * size);
+    writeVectorArray (data, size);
+}
+
+void
+GpuVariableHeadless::setVector (const float* data) const
+{
+    setValue (data, sizeof(float) * 4);
+    writeVector (data);
+}
+
+void
+GpuVariableHeadless::setFloatArray(const float* data, uint32_t count) const
+{
+    setValue (data, sizeof(float) * count);
+    writeFloatArray (data, count);
+}
+
+void
+GpuVariableHeadless::setTexture (const Ctr::ITexture* texture) const
+{
+    setBoundResource (Ctr::CommandLogHeadless::SetTexture, texture);
+}
+
+void
+GpuVariableHeadless::setDepthTexture (const Ctr::IDepthSurface* depthSurface) const
+{
+    setBoundResource (Ctr::CommandLogHeadless::SetTexture, depthSurface);
+}
+
+void
+GpuVariableHeadless::setResource (const Ctr::IGpuBuffer* buffer) const
+{
+    setBoundResource (Ctr::CommandLogHeadless::SetResource, buffer);
+}
+
+void
+GpuVariableHeadless::setUnorderedResource(const Ctr::IGpuBuffer* buffer) const
+{
+    setBoundResource (Ctr::CommandLogHeadless::SetResource, buffer);
+}
+
+void
+GpuVariableHeadless::setStream (const Ctr::IVertexBuffer* vertexBuffer) const
+{
+    setBoundResource (Ctr::CommandLogHeadless::SetResource, vertexBuffer);
+}
+
+void
+GpuVariableHeadless::setStream (const Ctr::IIndexBuffer* indexBuffer) const
+{
+    setBoundResource (Ctr::CommandLogHeadless::SetResource, indexBuffer);
+}
+
+const std::string&
+GpuVariableHeadless::semantic() const
+{
+    return _semantic;
+}
+
+const std::string&
+GpuVariableHeadless::name() const
+{
+    return _name;
+}
+
+const std::string&
+GpuVariableHeadless::annotation (const std::string& key)
+{
+    return _annotations[key];
+}
+
+const Ctr::ITexture*
+GpuVariableHeadless::texture() const
+{
+    return nullptr;
+}
+
+void
+GpuVariableHeadless::unbind() const
+{
+    if (Ctr::CommandListHeadless* commandList = Ctr::CommandListHeadless::recording())
+    {
+        if (commandList->boundResource (this, _boundResource))
+            commandList->setResource (Ctr::CommandLogHeadless::SetResource, this, nullptr);
+    }
+    else if (_boundResource)
+    {
+        setBoundResource (Ctr::CommandLogHeadless::SetResource, nullptr);
+    }
+}
+
+void
+GpuVariableHeadless::setBoundResource (Ctr::CommandLogHeadless::Type type, const void* resource) const
+{
+    if (Ctr::CommandListHeadless* commandList = Ctr::CommandListHeadless::recording())
+    {
+        commandList->setResource (type, this, resource);
+        return;
+    }
+
+    _boundResource = resource;
+    _commandLog->record (type, this);
+}
+
+const std::vector<uint8_t>&
+GpuVariableHeadless::value() const
+{
+    return _value;
+}
+
+const void*
+GpuVariableHeadless::boundResource() const
+{
+    return _boundResource;
+}
+
+}
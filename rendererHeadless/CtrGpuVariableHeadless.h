@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_TECHNIQUE_SAS_VARIABLE_HEADLESS
+#define INCLUDED_TECHNIQUE_SAS_VARIABLE_HEADLESS
+
+#include <CtrPlatform.h>
+#include <CtrShaderParameterValue.h>
+#include <CtrGpuVariable.h>
+#include <CtrCommandLogHeadless.h>
+
+namespace Ctr
+{
+class DeviceHeadless;
+
+//-----------------------------------------------------------
+// Shader variable declared in a headless shader's source.
+// The last value set is kept, and written into the
+// constant buffer shadow when the variable has a known
+// layout. Resources are held by pointer. While a command
+// list records, values and resources go to the list and
+// land here when it executes.
+//-----------------------------------------------------------
+class GpuVariableHeadless : public Ctr::GpuVariable
+{
+  public:
+    GpuVariableHeadless (Ctr::DeviceHeadless* device,
+                         const std::string& name,
+                         const std::string& semantic);
+    virtual ~GpuVariableHeadless();
+
+    void                        setParameterType (Ctr::ShaderParameter type);
+    Ctr::ShaderParameter        parameterType() const;
+
+    virtual bool                create(){ return true; };
+    virtual bool                cache(){ return true; };
+    virtual bool                free();
+
+    virtual void                set (const void*, uint32_t size) const;
+    virtual void                setMatrix(const float*) const;
+    virtual void                setMatrixArray (const float*, uint32_t size) const;
+    virtual void                setVectorArray (const float*, uint32_t size) const;    
+    virtual void                setVector (const float*) const;
+    virtual void                setFloatArray(const float*, uint32_t count) const;
+    virtual void                setTexture (const Ctr::ITexture*) const;
+    virtual void                setDepthTexture (const Ctr::IDepthSurface*) const;
+    virtual void                setResource (const Ctr::IGpuBuffer*) const;
+    virtual void                setUnorderedResource(const Ctr::IGpuBuffer*) const;
+    virtual void                setStream (const Ctr::IVertexBuffer* vertexBuffer) const;
+    virtual void                setStream (const Ctr::IIndexBuffer* indexBuffer) const;
+
+    const std::string&          semantic() const;
+    const std::string&          name() const;
+    const std::string&          annotation (const std::string&);
+
+    virtual const Ctr::ITexture* texture() const;
+    virtual void                unbind() const;
+
+    // Last value and resource set on the variable.
+    const std::vector<uint8_t>& value() const;
+    const void*                 boundResource() const;
+
+  protected:
+    void                        setValue (const void* data, size_t size) const;
+    void                        setBoundResource (Ctr::CommandLogHeadless::Type type, 
+                                                  const void* resource) const;
+
+  private:
+    friend class CommandListHeadless;
+
+    typedef std::map<std::string, std::string>  StringMap;
+
+    Ctr::CommandLogHeadless*    _commandLog;
+    std::string                 _name;
+    std::string                 _semantic;
+    StringMap                   _annotations;
+    Ctr::ShaderParameter        _parameterType;
+    mutable std::vector<uint8_t> _value;
+    mutable const void*         _boundResource;
+};
+
+}
+
+#endif
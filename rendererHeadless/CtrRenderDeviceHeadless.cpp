@@ -0,0 +1,829 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrRenderDeviceHeadless.h>
+#include <CtrApplication.h>
+#include <CtrGpuTechnique.h>
+#include <CtrLog.h>
+#include <CtrBufferHeadless.h>
+#include <CtrVertexBufferHeadless.h>
+#include <CtrIndexBufferHeadless.h>
+#include <CtrVertexDeclarationHeadless.h>
+#include <CtrDepthSurfaceHeadless.h>
+#include <CtrSurfaceHeadless.h>
+#include <CtrTextureHeadless.h>
+#include <CtrShaderHeadless.h>
+#include <CtrComputeShaderHeadless.h>
+#include <CtrCommandListHeadless.h>
+
+namespace Ctr
+{
+namespace
+{
+uint32_t
+elementCount (Ctr::PrimitiveType primitiveType, uint32_t primitiveCount)
+{
+    switch (primitiveType)
+    {
+        case Ctr::PointList:
+            return primitiveCount;
+        case Ctr::LineList:
+            return primitiveCount * 2;
+        case Ctr::LineStrip:
+            return primitiveCount + 1;
+        case Ctr::TriangleList:
+            return primitiveCount * 3;
+        case Ctr::TriangleStrip:
+            return primitiveCount + 2;
+        default:
+            return primitiveCount;
+    }
+}
+}
+
+DeviceHeadless::DeviceHeadless() :
+    _backbufferTexture (nullptr),
+    _depthbuffer (nullptr),
+    _drawMode (Ctr::Filled),
+    _cullMode (Ctr::CCW),
+    _blendPipelineType (Ctr::BlendAlpha),
+    _scissorEnabled (false),
+    _initialized (false)
+{
+    _useMultiSampleAntiAliasing = false;
+    _multiSampleCount = 1;
+    _multiSampleQuality = 0;
+}
+
+DeviceHeadless::~DeviceHeadless()
+{
+    free();
+}
+
+bool
+DeviceHeadless::free()
+{
+    // Managers hold shaders and textures, release them before the backbuffer.
+    IDevice::free();
+
+    safedelete (_depthbuffer);
+    safedelete (_backbufferTexture);
+    _deviceFrameBuffer = Ctr::FrameBuffer();
+    _initialized = false;
+    return true;
+}
+
+bool
+DeviceHeadless::initialize (const Ctr::ApplicationRenderParameters& deviceParameters)
+{
+    IDevice::initialize(deviceParameters);
+
+    if (!createBackbuffer (deviceParameters.size()))
+    {
+        THROW ("Failed to create headless backbuffer");
+    }
+
+    _deviceFrameBuffer = Ctr::FrameBuffer(backbuffer(), _depthbuffer);
+    setupViewport (_deviceFrameBuffer);
+    _initialized = true;
+
+    // Setup managers and default post effects.
+    postInitialize(deviceParameters);
+
+    // Resource creation during startup is not part of any frame.
+    _commandLog.reset();
+
+    return _initialized;
+}
+
+bool
+DeviceHeadless::createBackbuffer (const Ctr::Vector2i& size)
+{
+    Ctr::TextureParameters backbufferData =
+        Ctr::TextureParameters ("HeadlessBackbuffer",
+                                Ctr::TextureImagePtr(),
+                                Ctr::TwoD,
+                                Ctr::RenderTarget,
+                                Ctr::PF_A8R8G8B8,
+                                Ctr::Vector3i(std::max(size.x, 1), std::max(size.y, 1), 1));
+
+    _backbufferTexture = new Ctr::TextureHeadless (this);
+    if (!_backbufferTexture->initialize (&backbufferData))
+    {
+        safedelete (_backbufferTexture);
+        return false;
+    }
+
+    _depthbuffer = new Ctr::DepthSurfaceHeadless (this);
+    Ctr::DepthSurfaceParameters depthData (Ctr::PF_DEPTH24S8,
+                                           _backbufferTexture->width(),
+                                           _backbufferTexture->height());
+    if (!_depthbuffer->initialize (&depthData))
+    {
+        safedelete (_depthbuffer);
+        return false;
+    }
+    return true;
+}
+
+Ctr::CommandLogHeadless*
+DeviceHeadless::commandLog() const
+{
+    return &_commandLog;
+}
+
+const Ctr::FrameBuffer& 
+DeviceHeadless::deviceFrameBuffer() const
+{
+    return _deviceFrameBuffer;
+}
+
+bool
+DeviceHeadless::beginRender()
+{
+    _commandLog.beginFrame();
+    _commandLog.record (Ctr::CommandLogHeadless::Clear, backbuffer());
+    _commandLog.record (Ctr::CommandLogHeadless::Clear, _depthbuffer);
+    return true;
+}
+
+bool
+DeviceHeadless::present()
+{
+    bindFrameBuffer (_deviceFrameBuffer);
+    _commandLog.endFrame();
+    return true;
+}
+
+void
+DeviceHeadless::copyStructureCount(const Ctr::IGpuBuffer* dst, const Ctr::IGpuBuffer* src)
+{
+    _commandLog.record (Ctr::CommandLogHeadless::Blit, dst);
+}
+
+bool
+DeviceHeadless::supportsHardwareTessellationStage() const
+{
+    return false;
+}
+
+void
+DeviceHeadless::printState()
+{
+    LOG ("Headless device: cull " << _cullMode << " draw mode " << _drawMode 
+         << " blend " << _blendPipelineType << " scissor " << _scissorEnabled);
+}
+
+void
+DeviceHeadless::syncState()
+{
+    recordState();
+}
+
+void
+DeviceHeadless::recordState() const
+{
+    _commandLog.record (Ctr::CommandLogHeadless::SetState);
+}
+
+Window*    
+DeviceHeadless::renderWindow()
+{
+    return nullptr;
+}
+
+void
+DeviceHeadless::setViewport(const Viewport* viewport)
+{
+    _currentViewport = *viewport;
+    _commandLog.record (Ctr::CommandLogHeadless::SetViewport);
+}
+
+void
+DeviceHeadless::getViewport(Viewport* viewport) const
+{
+    *viewport = _currentViewport;
+}
+
+bool
+DeviceHeadless::setColorWriteState (bool r, bool g, bool b, bool a) 
+{
+    recordState();
+    return true;
+}
+
+void*
+DeviceHeadless::rawDevice()
+{
+    return nullptr;
+}
+
+const Ctr::ISurface*    
+DeviceHeadless::backbuffer() const
+{
+    return _backbufferTexture ? _backbufferTexture->surface(0, 0) : nullptr;
+}
+
+const Ctr::IDepthSurface*
+DeviceHeadless::depthbuffer() const
+{
+    return _depthbuffer;
+}
+
+void
+DeviceHeadless::setupStencil(uint8_t readMask, 
+                             uint8_t writeMask,
+                             Ctr::CompareFunction frontCompare,
+                             Ctr::StencilOp frontStencilFailOp,
+                             Ctr::StencilOp frontStencilPassOp,
+                             Ctr::StencilOp frontZFailOp,
+                             Ctr::CompareFunction backCompare,
+                             Ctr::StencilOp backStencilFailOp,
+                             Ctr::StencilOp backStencilPassOp,
+                             Ctr::StencilOp backZFailOp)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setupStencil(uint8_t readMask,
+                             uint8_t writeMask,
+                             Ctr::CompareFunction frontCompare,
+                             Ctr::StencilOp frontStencilFailOp,
+                             Ctr::StencilOp frontStencilPassOp,
+                             Ctr::StencilOp frontZFailOp)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::bindSurface (int level, const Ctr::ISurface* surface) 
+{
+    _commandLog.record (Ctr::CommandLogHeadless::BindFrameBuffer, surface);
+}
+
+void
+DeviceHeadless::bindDepthSurface (const Ctr::IDepthSurface* surface)
+{
+    _commandLog.record (Ctr::CommandLogHeadless::BindFrameBuffer, surface);
+}
+
+void
+DeviceHeadless::setupViewport (const Ctr::FrameBuffer& frameBuffer)
+{
+    if (frameBuffer.colorSurface(0))
+    {
+        _currentViewport = Ctr::Viewport (0.0f, 0.0f,
+                                          float(frameBuffer.colorSurface(0)->width()),
+                                          float(frameBuffer.colorSurface(0)->height()),
+                                          0.0f, 1.0f);
+        _commandLog.record (Ctr::CommandLogHeadless::SetViewport);
+    }
+    else if (frameBuffer.depthSurface())
+    {
+        _currentViewport = Ctr::Viewport (0.0f, 0.0f,
+                                          float(frameBuffer.depthSurface()->width()),
+                                          float(frameBuffer.depthSurface()->height()),
+                                          0.0f, 1.0f);
+        _commandLog.record (Ctr::CommandLogHeadless::SetViewport);
+    }
+    else
+    {
+        LOG ("Failure, no surface to determine size from ");
+    }
+}
+
+bool
+DeviceHeadless::bindFrameBuffer (const Ctr::FrameBuffer& framebuffer)
+{
+    _currentFrameBuffer = framebuffer;
+    _commandLog.record (Ctr::CommandLogHeadless::BindFrameBuffer, framebuffer.colorSurface(0));
+    return true;
+}
+
+void
+DeviceHeadless::resetShaderPipeline()
+{
+}
+
+void
+DeviceHeadless::clearShaderResources() const
+{
+}
+
+void
+DeviceHeadless::resetViewsAndShaders() const
+{
+}
+
+Ctr::BlendPipelineType 
+DeviceHeadless::blendPipeline() const
+{
+    return _blendPipelineType;
+}
+
+void
+DeviceHeadless::setupBlendPipeline(Ctr::BlendPipelineType blendPipelineType) 
+{
+    _blendPipelineType = blendPipelineType;
+    recordState();
+}
+
+bool
+DeviceHeadless::scissorEnabled() const
+{
+    return _scissorEnabled;
+}
+
+void
+DeviceHeadless::setScissorEnabled(bool scissorEnabled)
+{
+    _scissorEnabled = scissorEnabled;
+    recordState();
+}
+
+void
+DeviceHeadless::setScissorRect(int x, int y, int width, int height)
+{
+    recordState();
+}
+
+bool
+DeviceHeadless::resizeDevice (const Ctr::Vector2i& newSize)
+{
+    if (_initialized && _backbufferTexture &&
+        (uint32_t(newSize.x) != _backbufferTexture->width() ||
+         uint32_t(newSize.y) != _backbufferTexture->height()))
+    {
+        IRenderResource::beginResize();
+
+        safedelete (_depthbuffer);
+        safedelete (_backbufferTexture);
+        if (!createBackbuffer (newSize))
+        {
+            LOG ("Failed to resize headless backbuffer");
+            return false;
+        }
+        _deviceFrameBuffer = Ctr::FrameBuffer(backbuffer(), _depthbuffer);
+
+        // Recreate released size dependent items.
+        IRenderResource::endResize();
+
+        setupViewport (_deviceFrameBuffer);
+        bindFrameBuffer (_deviceFrameBuffer);
+    }
+    return true;
+}
+
+bool 
+DeviceHeadless::reset()
+{
+    return true;
+}
+
+bool
+DeviceHeadless::blitSurfaces (const ISurface* destination, 
+                              const ISurface* source, 
+                              TextureFilter filterType,
+                              size_t arrayOffset) const
+{
+    _commandLog.record (Ctr::CommandLogHeadless::Blit, destination);
+    return true;
+}
+
+bool
+DeviceHeadless::blitSurfaces (const IDepthSurface* destination, 
+                              const IDepthSurface* source, 
+                              TextureFilter filterType) const
+{
+    _commandLog.record (Ctr::CommandLogHeadless::Blit, destination);
+    return true;
+}
+
+bool
+DeviceHeadless::clearSurfaces (uint32_t indexToClearTo, 
+                               unsigned long clearType, 
+                               float redClear, 
+                               float greenClear, 
+                               float blueClear, 
+                               float alphaClear) const
+{
+    if (clearType & CLEAR_TARGET)
+    {
+        _commandLog.record (Ctr::CommandLogHeadless::Clear, 
+                            _currentFrameBuffer.colorSurface(0), indexToClearTo + 1);
+    }
+    if (clearType & (CLEAR_ZBUFFER | CLEAR_STENCIL))
+    {
+        _commandLog.record (Ctr::CommandLogHeadless::Clear, _currentFrameBuffer.depthSurface());
+    }
+    return false;
+}
+
+bool
+DeviceHeadless::drawPrimitive (const IVertexDeclaration* vertexDeclaration, 
+                               const IVertexBuffer* vertexBuffer, 
+                               const GpuTechnique* technique,
+                               PrimitiveType primitiveType, 
+                               uint32_t primitiveCount,
+                               uint32_t vertexOffset) const
+{
+    if (vertexDeclaration)
+        vertexDeclaration->bind();
+
+    if (vertexBuffer->bind())
+    {
+        _commandLog.record (Ctr::CommandLogHeadless::Draw, technique, 
+                            elementCount (primitiveType, primitiveCount));
+    }
+    return true;
+}
+
+bool
+DeviceHeadless::drawIndexedPrimitive (const IVertexDeclaration* vertexDeclaration, 
+                                      const IIndexBuffer* indexBuffer, 
+                                      const IVertexBuffer* vertexBuffer, 
+                                      const GpuTechnique* technique,
+                                      PrimitiveType primitiveType, 
+                                      uint32_t faceCount,
+                                      uint32_t indexOffset,
+                                      uint32_t vertexOffset) const
+{
+    if (vertexDeclaration)
+        vertexDeclaration->bind();
+
+    if (vertexBuffer->bind() && indexBuffer->bind())
+    {
+        _commandLog.record (Ctr::CommandLogHeadless::DrawIndexed, technique, 
+                            elementCount (primitiveType, faceCount));
+    }
+    return true;
+}
+
+bool
+DeviceHeadless::drawIndexedPrimitiveInstanced (const IVertexDeclaration* vertexDeclaration, 
+                                               const IIndexBuffer* indexBuffer, 
+                                               const IVertexBuffer* vertexBuffer, 
+                                               const GpuTechnique* technique,
+                                               PrimitiveType primitiveType, 
+                                               uint32_t faceCount,
+                                               uint32_t indexOffset,
+                                               uint32_t vertexOffset,
+                                               uint32_t instanceCount) const
+{
+    if (vertexDeclaration)
+        vertexDeclaration->bind();
+
+    if (vertexBuffer->bind() && indexBuffer->bind())
+    {
+        _commandLog.record (Ctr::CommandLogHeadless::DrawInstanced, technique, 
+                            elementCount (primitiveType, faceCount) * instanceCount);
+    }
+    return true;
+}
+
+bool
+DeviceHeadless::setNullTarget (uint32_t index)
+{
+    _commandLog.record (Ctr::CommandLogHeadless::BindFrameBuffer);
+    return true;
+}
+
+void
+DeviceHeadless::setNullStreamOut()
+{
+}
+
+bool
+DeviceHeadless::writeFrontBufferToFile (const std::string& filename) const
+{
+    return _backbufferTexture && _backbufferTexture->save (filename);
+}
+
+void
+DeviceHeadless::enableAlphaBlending()
+{
+    recordState();
+}
+
+void
+DeviceHeadless::disableAlphaBlending()
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setAlphaToCoverageEnable (bool value)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setBlendProperty (const Ctr::BlendOp& op)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setSrcFunction (const Ctr::AlphaFunction& srcFunction)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setDestFunction (const Ctr::AlphaFunction& alphaFunc)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setAlphaBlendProperty (const Ctr::BlendOp& op)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setAlphaDestFunction (const Ctr::AlphaFunction& alphaFunc)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setAlphaSrcFunction (const Ctr::AlphaFunction& alphaFunc)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setDrawMode (Ctr::DrawMode drawMode)
+{
+    _drawMode = drawMode;
+    recordState();
+}
+
+Ctr::DrawMode
+DeviceHeadless::getDrawMode () const
+{
+    return _drawMode;
+}
+
+void
+DeviceHeadless::fogEnable()
+{
+}
+
+void
+DeviceHeadless::fogDisable()
+{
+}
+
+void
+DeviceHeadless::disableDepthWrite()
+{
+    recordState();
+}
+
+void
+DeviceHeadless::enableDepthWrite()
+{
+    recordState();
+}
+
+void
+DeviceHeadless::disableZTest()
+{
+    recordState();
+}
+
+void
+DeviceHeadless::enableZTest()
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setZFunction (Ctr::CompareFunction compareFunc)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setFrontFaceStencilFunction(Ctr::CompareFunction compareFunc)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::setFrontFaceStencilPass(Ctr::StencilOp op)
+{
+    recordState();
+}
+
+void
+DeviceHeadless::enableStencilTest()
+{
+    recordState();
+}
+
+void
+DeviceHeadless::disableStencilTest()
+{
+    recordState();
+}
+
+Ctr::CullMode
+DeviceHeadless::cullMode() const
+{
+    if (Ctr::ICommandList* commandList = Ctr::ICommandList::recording())
+        return commandList->cullMode();
+    return _cullMode;
+}
+
+void
+DeviceHeadless::setCullMode (Ctr::CullMode cullMode)
+{
+    if (Ctr::ICommandList* commandList = Ctr::ICommandList::recording())
+        commandList->setCullMode (cullMode);
+    else
+        _cullMode = cullMode;
+    recordState();
+}
+
+void
+DeviceHeadless::setNullPixelShader()
+{
+}
+
+void
+DeviceHeadless::setNullVertexShader()
+{
+}
+
+bool
+DeviceHeadless::isRenderTextureFormatSupported (const Ctr::PixelFormat& format)
+{
+    return true;
+}
+
+Ctr::IGpuBuffer *   
+DeviceHeadless::createBufferResource (const Ctr::RenderResourceParameters* data)
+{
+    if (const Ctr::GpuBufferParameters* resource = 
+        dynamic_cast<const Ctr::GpuBufferParameters*>(data))
+    {
+        Ctr::BufferHeadless* bufferResource = new Ctr::BufferHeadless(this);
+        if (bufferResource->initialize (resource))
+        {
+            return bufferResource;
+        }
+        safedelete (bufferResource);
+    }
+    return nullptr;
+}
+
+Ctr::IVertexBuffer *     
+DeviceHeadless::createVertexBuffer (const Ctr::RenderResourceParameters* data)
+{
+    if (const Ctr::VertexBufferParameters* resource = 
+        dynamic_cast<const Ctr::VertexBufferParameters*>(data))
+    {
+        Ctr::VertexBufferHeadless* vertexBuffer = new VertexBufferHeadless (this);
+        if (vertexBuffer->initialize (resource))
+        {
+            return vertexBuffer;
+        }
+        safedelete (vertexBuffer);
+    }
+    return nullptr;
+}
+
+Ctr::IIndexBuffer *      
+DeviceHeadless::createIndexBuffer (const Ctr::RenderResourceParameters* data)
+{
+    if (const Ctr::IndexBufferParameters* resource = 
+        dynamic_cast<const Ctr::IndexBufferParameters*>(data))
+    {
+        IndexBufferHeadless* indexBuffer = new IndexBufferHeadless (this);
+        if (indexBuffer->initialize (resource))
+        {
+            return indexBuffer;
+        }
+        safedelete (indexBuffer);
+    }
+    return nullptr;
+}
+
+Ctr::IVertexDeclaration * 
+DeviceHeadless::createVertexDeclaration (const Ctr::RenderResourceParameters* data)
+{
+    if (const Ctr::VertexDeclarationParameters* resource =
+        dynamic_cast <const Ctr::VertexDeclarationParameters*>(data))
+    {
+        VertexDeclarationHeadless* declaration = new VertexDeclarationHeadless (this);
+        if (declaration->initialize (resource))
+        {
+            return declaration;
+        }
+        safedelete (declaration);
+    }
+    return nullptr;
+}
+
+Ctr::IDepthSurface *     
+DeviceHeadless::createDepthSurface(const Ctr::RenderResourceParameters* data)
+{
+    if (const Ctr::DepthSurfaceParameters* resource =
+        dynamic_cast<const Ctr::DepthSurfaceParameters*> (data))
+    {
+        Ctr::DepthSurfaceHeadless* depthSurface = new Ctr::DepthSurfaceHeadless (this);
+        if (depthSurface->initialize (resource))
+        {
+            return depthSurface;
+        }
+        safedelete (depthSurface);
+    }
+    return nullptr;
+}
+
+Ctr::ITexture *          
+DeviceHeadless::createTexture (const Ctr::RenderResourceParameters* data)
+{
+    if (const Ctr::TextureParameters* textureData = 
+        dynamic_cast<const Ctr::TextureParameters*>(data))
+    {
+        Ctr::ITexture* texture = new Ctr::TextureHeadless (this);
+        if (texture->initialize (textureData))
+        {
+            return texture;
+        }
+        else
+        {
+            safedelete (texture);
+        }
+    }
+    return nullptr;
+}
+
+Ctr::IShader *           
+DeviceHeadless::createShader (const Ctr::RenderResourceParameters* data)
+{
+    return new Ctr::ShaderHeadless(this);
+}
+
+Ctr::IComputeShader *
+DeviceHeadless::createComputeShader (const Ctr::RenderResourceParameters* data)
+{
+    return new Ctr::ComputeShaderHeadless(this);
+}
+
+Ctr::ICommandList *
+DeviceHeadless::createCommandList()
+{
+    return new Ctr::CommandListHeadless(this);
+}
+
+void
+DeviceHeadless::destroyResource(Ctr::IRenderResource* resource)
+{
+    delete resource;
+}
+
+}
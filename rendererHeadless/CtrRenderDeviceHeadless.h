@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_HEADLESS_DEVICE
+#define INCLUDED_HEADLESS_DEVICE
+
+#include <CtrPlatform.h>
+#include <CtrIDevice.h>
+#include <CtrCommandLogHeadless.h>
+
+namespace Ctr
+{
+class Application;
+class TextureHeadless;
+class DepthSurfaceHeadless;
+
+//------------------------------------------------------------------------
+// Device without a GPU. Resources live in host memory and every draw,
+// bind and state call is recorded into a CommandLogHeadless so that the
+// CPU side of a frame (scene update, render passes, parameter binding)
+// can be run and measured on machines without D3D11.
+//------------------------------------------------------------------------
+class DeviceHeadless : public IDevice
+{
+  public:
+    DeviceHeadless();
+    virtual ~DeviceHeadless();
+
+    Ctr::Window*                renderWindow();
+
+    bool                        initialize (const Ctr::ApplicationRenderParameters& deviceParameters);
+    virtual bool                free();
+
+    bool                        beginRender();
+    bool                        present();
+
+    virtual void                printState();
+    virtual void                syncState();
+    virtual bool                reset();
+
+    Ctr::CommandLogHeadless*    commandLog() const;
+
+    virtual const Ctr::ISurface*    backbuffer() const;
+    virtual const Ctr::IDepthSurface* depthbuffer() const;
+    virtual const Ctr::FrameBuffer& deviceFrameBuffer() const;
+
+    // Resource management functions
+    virtual IGpuBuffer *        createBufferResource (const Ctr::RenderResourceParameters* data = 0);
+    virtual IVertexBuffer *     createVertexBuffer (const Ctr::RenderResourceParameters* data = 0);
+    virtual IIndexBuffer *      createIndexBuffer (const Ctr::RenderResourceParameters* data = 0);
+    virtual IVertexDeclaration * createVertexDeclaration (const Ctr::RenderResourceParameters* data = 0);
+    virtual IDepthSurface *     createDepthSurface(const Ctr::RenderResourceParameters* data = 0);
+    virtual ITexture *          createTexture (const Ctr::RenderResourceParameters* data = 0);
+    virtual IComputeShader *    createComputeShader (const Ctr::RenderResourceParameters* data = 0);
+    virtual IShader *           createShader (const Ctr::RenderResourceParameters* data = 0);
+    virtual ICommandList *      createCommandList();
+    virtual void                destroyResource(Ctr::IRenderResource* resource);
+    virtual void                setupBlendPipeline(BlendPipelineType blendPipelineType);
+    virtual Ctr::BlendPipelineType blendPipeline() const;
+
+    virtual void                resetShaderPipeline();
+
+    bool                        setColorWriteState (bool r  = true, bool g  = true, 
+                                                    bool b  = true, bool a = true);
+
+    virtual bool                drawPrimitive (const IVertexDeclaration*, 
+                                               const IVertexBuffer*, 
+                                               const GpuTechnique* technique,
+                                               PrimitiveType, 
+                                               uint32_t primitiveCount,
+                                               uint32_t vertexOffset) const;
+
+    virtual bool                drawIndexedPrimitive (const IVertexDeclaration*, 
+                                                      const IIndexBuffer*, 
+                                                      const IVertexBuffer*, 
+                                                      const GpuTechnique* technique,
+                                                      PrimitiveType, 
+                                                      uint32_t faceCount,
+                                                      uint32_t indexOffset,
+                                                      uint32_t vertexOffset) const;
+
+    virtual bool                drawIndexedPrimitiveInstanced (const IVertexDeclaration*, 
+                                                               const IIndexBuffer*, 
+                                                               const IVertexBuffer*, 
+                                                               const GpuTechnique* technique,
+                                                               PrimitiveType, 
+                                                               uint32_t faceCount,
+                                                               uint32_t indexOffset,
+                                                               uint32_t vertexOffset,
+                                                               uint32_t instanceCount) const;
+
+    virtual bool                blitSurfaces (const ISurface* destination, 
+                                              const ISurface* src, 
+                                              TextureFilter filterType = Ctr::TEXFILTER_POINT,
+                                              size_t arrayOffset = 0) const;
+
+    virtual bool                blitSurfaces (const IDepthSurface* destination, 
+                                              const IDepthSurface* src, 
+                                              TextureFilter filterType = Ctr::TEXFILTER_POINT) const;
+
+    virtual bool                clearSurfaces (uint32_t index, unsigned long clearType, 
+                                               float redClear = 0.0f, 
+                                               float greenClear = 0.0f, 
+                                               float blueClear = 0.0f, 
+                                               float alphaClear = 0.0f) const;
+
+    virtual bool                scissorEnabled() const;
+    virtual void                setScissorEnabled(bool scissorEnabled);
+    virtual void                setScissorRect(int x, int y, int width, int height);
+
+    virtual bool                setNullTarget (uint32_t index);
+    virtual void                setNullStreamOut();
+
+    virtual void                setViewport (const Viewport*);
+    virtual void                getViewport(Viewport*) const;
+
+    virtual void*               rawDevice();
+    virtual bool                writeFrontBufferToFile (const std::string& ) const;
+
+    // State Management Functions
+    virtual void                enableAlphaBlending();
+    virtual void                disableAlphaBlending();
+    virtual void                setAlphaToCoverageEnable (bool value);
+
+    virtual void                setBlendProperty (const Ctr::BlendOp&);
+    virtual void                setSrcFunction (const Ctr::AlphaFunction&);
+    virtual void                setDestFunction (const Ctr::AlphaFunction&);
+
+    virtual void                setAlphaBlendProperty (const Ctr::BlendOp&);
+    virtual void                setAlphaDestFunction (const Ctr::AlphaFunction&);
+    virtual void                setAlphaSrcFunction (const Ctr::AlphaFunction&);
+
+    virtual void                fogEnable();
+    virtual void                fogDisable();
+
+    virtual void                disableDepthWrite();
+    virtual void                enableDepthWrite();
+    virtual void                disableZTest();
+    virtual void                enableZTest();
+    virtual void                setZFunction (Ctr::CompareFunction);
+
+    virtual void                setFrontFaceStencilFunction(Ctr::CompareFunction);
+    virtual void                setFrontFaceStencilPass(Ctr::StencilOp compareFunc);
+
+    virtual void                setupStencil(uint8_t readMask,
+                                             uint8_t writeMask,
+                                             Ctr::CompareFunction frontCompare,
+                                             Ctr::StencilOp frontStencilFailOp,
+                                             Ctr::StencilOp frontStencilPassOp,
+                                             Ctr::StencilOp frontZFailOp,
+                                             Ctr::CompareFunction backCompare,
+                                             Ctr::StencilOp backStencilFailOp,
+                                             Ctr::StencilOp backStencilPassOp,
+                                             Ctr::StencilOp backZFailOp);
+
+    virtual void                setupStencil(uint8_t readMask,
+                                             uint8_t writeMask,
+                                             Ctr::CompareFunction frontCompare,
+                                             Ctr::StencilOp frontStencilFailOp,
+                                             Ctr::StencilOp frontStencilPassOp,
+                                             Ctr::StencilOp frontZFailOp);
+
+    virtual void                enableStencilTest();
+    virtual void                disableStencilTest();
+    virtual void                setCullMode (Ctr::CullMode);
+    virtual Ctr::CullMode       cullMode() const;
+    virtual void                setNullPixelShader();
+    virtual void                setNullVertexShader();
+
+    virtual bool                isRenderTextureFormatSupported (const Ctr::PixelFormat& format);
+
+    virtual void                setDrawMode (Ctr::DrawMode);
+    virtual Ctr::DrawMode       getDrawMode () const;
+
+    virtual void                copyStructureCount(const Ctr::IGpuBuffer* dst, const Ctr::IGpuBuffer* src);
+
+    virtual bool                supportsHardwareTessellationStage() const;
+
+    virtual void                bindSurface (int level, const Ctr::ISurface* surface);
+    virtual void                bindDepthSurface (const Ctr::IDepthSurface* surface);
+
+    virtual bool                resizeDevice (const Ctr::Vector2i& newSize);
+    virtual bool                texelIsCenter() { return false; }
+
+    virtual bool                bindFrameBuffer (const Ctr::FrameBuffer& framebuffer);
+    virtual void                setupViewport (const Ctr::FrameBuffer& frameBuffer);
+
+    virtual void                resetViewsAndShaders() const;
+    virtual void                clearShaderResources() const;
+
+  protected:
+    bool                        createBackbuffer (const Ctr::Vector2i& size);
+    void                        recordState() const;
+
+  private:
+    mutable Ctr::CommandLogHeadless _commandLog;
+
+    TextureHeadless*            _backbufferTexture;
+    DepthSurfaceHeadless*       _depthbuffer;
+    Ctr::FrameBuffer            _deviceFrameBuffer;
+    Ctr::Viewport               _currentViewport;
+
+    Ctr::DrawMode               _drawMode;
+    Ctr::CullMode               _cullMode;
+    Ctr::BlendPipelineType      _blendPipelineType;
+    bool                        _scissorEnabled;
+    bool                        _initialized;
+};
+
+}
+
+#endif
@@ -0,0 +1,862 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrShaderHeadless.h>
+#include <CtrRenderDeviceHeadless.h>
+#include <CtrGpuTechniqueHeadless.h>
+#include <CtrGpuVariableHeadless.h>
+#include <CtrGpuConstantBufferHeadless.h>
+#include <CtrICommandList.h>
+#include <CtrShaderParameterValueFactory.h>
+#include <CtrAssetManager.h>
+#include <CtrMesh.h>
+#include <CtrMaterial.h>
+#include <regex>
+
+namespace Ctr
+{
+namespace
+{
+std::string
+readStream (const std::string& filePathName, bool& found)
+{
+    found = false;
+    std::string stream;
+    if (filePathName.length() > 0)
+    if (std::unique_ptr<DataStream> fileStream =
+        std::unique_ptr<DataStream>(AssetManager::assetManager()->openStream(filePathName)))
+    {
+        size_t fileSize = fileStream->size();
+        stream.resize (fileSize);
+        if (fileSize > 0)
+        {
+            fileStream->read (&stream[0], fileSize);
+        }
+        found = true;
+    }
+    return stream;
+}
+
+// Removes comments and preprocessor lines, keeping line structure.
+std::string
+stripSource (const std::string& source)
+{
+    std::string result;
+    result.reserve (source.size());
+
+    bool lineStart = true;
+    for (size_t i = 0; i < source.size(); i++)
+    {
+        char c = source[i];
+        if (c == '/' && i + 1 < source.size() && source[i+1] == '/')
+        {
+            while (i < source.size() && source[i] != '\n') i++;
+            result += '\n';
+            lineStart = true;
+            continue;
+        }
+        if (c == '/' && i + 1 < source.size() && source[i+1] == '*')
+        {
+            i += 2;
+            while (i + 1 < source.size() && !(source[i] == '*' && source[i+1] == '/')) i++;
+            i++;
+            result += ' ';
+            continue;
+        }
+        if (lineStart && c == '#')
+        {
+            while (i < source.size() && source[i] != '\n') i++;
+            result += '\n';
+            continue;
+        }
+        if (c == '\n')
+            lineStart = true;
+        else if (!isspace((unsigned char)c))
+            lineStart = false;
+        result += c;
+    }
+    return result;
+}
+
+bool
+isObjectType (const std::string& type)
+{
+    static const std::regex objectExpression 
+        ("^(RW)?(Texture|texture|Sampler|sampler|Buffer|StructuredBuffer|ByteAddressBuffer)|"
+         "^(Append|Consume)StructuredBuffer|State$|Shader$|^string$");
+    return std::regex_search (type, objectExpression);
+}
+
+// Register layout of a numeric type, false for structs and anything unknown.
+bool
+numericLayout (const std::string& type, 
+               const std::string& arraySize,
+               bool rowMajor,
+               Ctr::GpuVariable::BufferLayout& layout)
+{
+    static const std::regex numericExpression ("^(float|half|int|uint|bool|dword)([1-4])?(?:x([1-4]))?$");
+
+    std::smatch match;
+    bool matrix = false;
+    if (type == "matrix")
+    {
+        layout.rows = layout.columns = 4;
+        matrix = true;
+    }
+    else if (type == "vector")
+    {
+        layout.rows = 1;
+        layout.columns = 4;
+    }
+    else if (std::regex_search (type, match, numericExpression))
+    {
+        matrix = match[3].matched;
+        layout.rows = matrix ? uint32_t(std::stoul (match[2])) : 1;
+        layout.columns = matrix ? uint32_t(std::stoul (match[3])) : 
+                         match[2].matched ? uint32_t(std::stoul (match[2])) : 1;
+    }
+    else
+    {
+        return false;
+    }
+
+    // Effects default to column_major packing.
+    layout.columnMajor = matrix && !rowMajor;
+    layout.elements = 0;
+    if (arraySize.length() > 0)
+    {
+        if (arraySize.find_first_not_of ("0123456789 \t") != std::string::npos ||
+            arraySize.find_first_of ("0123456789") == std::string::npos)
+            return false;
+        layout.elements = uint32_t(std::stoul (arraySize));
+        if (layout.elements == 0)
+            return false;
+    }
+
+    uint32_t registers = layout.columnMajor ? layout.columns : layout.rows;
+    uint32_t lastRegister = layout.columnMajor ? layout.rows : layout.columns;
+    uint32_t elementSize = ((registers - 1) * 4 + lastRegister) * sizeof(float);
+
+    layout.stride = registers * 16;
+    layout.size = layout.elements > 0 ? 
+        (layout.elements - 1) * layout.stride + elementSize : elementSize;
+    return true;
+}
+}
+
+ShaderHeadless::ShaderHeadless (Ctr::DeviceHeadless* device) :
+    Ctr::IShader (device),
+    _device (device),
+    _sourceAvailable (false),
+    _verbose (false),
+    _allowDeprecated (true)
+{
+}
+
+ShaderHeadless::~ShaderHeadless()
+{
+    free();
+}
+
+bool
+ShaderHeadless::cache()
+{
+    return true;
+}
+
+bool
+ShaderHeadless::free()
+{
+    for (auto it = _parameters.begin(); it != _parameters.end(); it++)
+    {
+        safedelete((*it));
+    }
+    for (auto it = _techniques.begin(); it != _techniques.end(); it++)
+    {
+        safedelete((*it));
+    }
+    for (auto it = _constantBuffers.begin(); it != _constantBuffers.end(); it++)
+    {
+        safedelete((*it));
+    }
+    if (_deviceInterface->shaderValueFactory())
+    {
+        for (auto it = _shaderParameterValues.begin(); it != _shaderParameterValues.end(); it++)
+        {
+            _deviceInterface->shaderValueFactory()->removeShaderParameterValue (*it);
+        }
+    }
+
+    _shaderParameterValues.clear();
+    _supportsInstancing = false;
+    _meshParameters.clear();
+    _techniqueParameters.clear();
+    _materialParameters.clear();
+    _frameParameters.clear();
+    _cameraParameters.clear();
+    _scopeState.invalidate();
+    _parameters.clear();
+    _constantBuffers.clear();
+    _techniques.clear();
+    return true;
+}
+
+bool
+ShaderHeadless::initialize (const std::string& filename, 
+                            const std::string& includePathName,
+                            bool  verbose, 
+                            bool  allowDeprecated)
+{
+    setFilename(filename.c_str());
+    setIncludeFilename(includePathName.c_str());
+
+    _verbose = verbose;
+    _allowDeprecated = allowDeprecated;
+
+    return create();
+}
+
+bool
+ShaderHeadless::initialize (const std::string& filePathName,
+                            const std::string& includePathName,
+                            bool verbose,
+                            bool allowDeprecated,
+                            const std::map<std::string, std::string>& defines)
+{
+    _defines = defines;
+    return initialize(filePathName, includePathName, verbose, allowDeprecated);
+}
+
+bool
+ShaderHeadless::create()
+{
+    free();
+
+    bool includeFound = false;
+    bool shaderFound = false;
+    std::string includeSource = readStream (IShader::includeFilePathName(), includeFound);
+    std::string shaderSource = readStream (IShader::filePathName(), shaderFound);
+
+    setShaderStream ((includeSource + shaderSource).c_str());
+    _hash.build (shaderStream());
+    _sourceAvailable = shaderFound;
+
+    // No preprocessor here, so only the two files read above are tracked.
+    _dependencies.clear();
+    _dependencies.insert (IShader::filePathName());
+    if (IShader::includeFilePathName().length() > 0)
+        _dependencies.insert (IShader::includeFilePathName());
+
+    // Named by the file until a SHADERNAME annotation says otherwise, so
+    // that materials still resolve when the source is missing.
+    std::string stem = IShader::filePathName();
+    stem = stem.substr (stem.find_last_of ("/\\") + 1);
+    setName (stem.substr (0, stem.find_last_of ('.')).c_str());
+
+    if (_sourceAvailable)
+    {
+        parseSource (shaderStream());
+        if (_verbose)
+        {
+            LOG ("Headless shader " << filePathName() << ": " << _techniques.size() 
+                 << " techniques, " << _parameters.size() << " variables");
+        }
+    }
+    else
+    {
+        LOG ("Headless shader source " << filePathName() << " not found, techniques will be created on request");
+    }
+
+    passVariables();
+    return true;
+}
+
+void
+ShaderHeadless::parseSource (const std::string& source)
+{
+    static const std::regex bufferExpression ("^\\s*(cbuffer|tbuffer)\\b\\s*(\\w*)");
+    static const std::regex techniqueExpression ("^\\s*technique(10|11)?\\s+(\\w+)");
+    static const std::regex passExpression ("^\\s*pass\\b");
+
+    const std::string stripped = stripSource (source);
+
+    std::string statement;
+    uint32_t depth = 0;
+    uint32_t annotationDepth = 0;
+    bool inBuffer = false;
+    std::string techniqueName;
+    uint32_t passCount = 0;
+
+    // Globals outside any cbuffer are packed into $Globals.
+    Ctr::ConstantBufferHeadless* globals = new Ctr::ConstantBufferHeadless (_device, "$Globals");
+    Ctr::ConstantBufferHeadless* constantBuffer = nullptr;
+
+    for (size_t i = 0; i < stripped.size(); i++)
+    {
+        char c = stripped[i];
+
+        // Annotations follow the semantic, and may contain ';'.
+        bool declarationScope = depth == 0 || (inBuffer && depth == 1);
+        if (declarationScope && statement.find(':') != std::string::npos)
+        {
+            if (c == '<') annotationDepth++;
+            else if (c == '>' && annotationDepth > 0) annotationDepth--;
+        }
+        if (annotationDepth > 0)
+        {
+            statement += c;
+            continue;
+        }
+
+        if (c == '{')
+        {
+            std::smatch match;
+            if (depth == 0 && std::regex_search (statement, match, bufferExpression))
+            {
+                inBuffer = true;
+                if (match[1] == "cbuffer")
+                {
+                    constantBuffer = new Ctr::ConstantBufferHeadless (_device, match[2]);
+                }
+            }
+            else if (depth == 0 && std::regex_search (statement, match, techniqueExpression))
+            {
+                techniqueName = match[2];
+                passCount = 0;
+            }
+            else if (depth == 1 && techniqueName.length() > 0 &&
+                     std::regex_search (statement, passExpression))
+            {
+                passCount++;
+            }
+            statement.clear();
+            depth++;
+        }
+        else if (c == '}')
+        {
+            if (depth > 0)
+                depth--;
+            if (depth == 0)
+            {
+                if (techniqueName.length() > 0)
+                {
+                    addTechnique (techniqueName, passCount);
+                    techniqueName.clear();
+                }
+                if (constantBuffer)
+                {
+                    addConstantBuffer (constantBuffer);
+                    constantBuffer = nullptr;
+                }
+                inBuffer = false;
+            }
+            statement.clear();
+        }
+        else if (c == ';')
+        {
+            if (declarationScope)
+            {
+                parseDeclaration (statement, inBuffer ? constantBuffer : globals);
+            }
+            statement.clear();
+        }
+        else
+        {
+            statement += c;
+        }
+    }
+
+    if (constantBuffer)
+    {
+        addConstantBuffer (constantBuffer);
+    }
+    addConstantBuffer (globals);
+}
+
+void
+ShaderHeadless::addConstantBuffer (Ctr::ConstantBufferHeadless* constantBuffer)
+{
+    if (constantBuffer->finalize())
+    {
+        _constantBuffers.push_back (constantBuffer);
+    }
+    else
+    {
+        delete constantBuffer;
+    }
+}
+
+void
+ShaderHeadless::parseDeclaration (const std::string& statement,
+                                  Ctr::ConstantBufferHeadless* constantBuffer)
+{
+    static const std::regex declarationExpression 
+        ("^\\s*(?:(?:uniform|shared|static|const|extern|row_major|column_major)\\s+)*"
+         "([A-Za-z_]\\w*(?:\\s*<[^>]*>)?)\\s+([A-Za-z_]\\w*)\\s*(?:\\[([^\\]]*)\\])?\\s*(?::\\s*([A-Za-z_]\\w*))?");
+    static const std::regex rowMajorExpression ("^\\s*(?:\\w+\\s+)*row_major\\b");
+
+    std::smatch match;
+    if (std::regex_search (statement, match, declarationExpression))
+    {
+        const std::string type = match[1];
+        const std::string name = match[2];
+        const std::string arraySize = match[3];
+        const std::string semantic = match[4];
+
+        // static variables are not settable from the application.
+        static const std::regex staticExpression ("^\\s*(?:\\w+\\s+)*static\\b");
+        if (type == "typedef" || type == "struct" || std::regex_search (statement, staticExpression))
+            return;
+
+        for (auto it = _parameters.begin(); it != _parameters.end(); it++)
+        {
+            if ((*it)->name() == name)
+                return;
+        }
+
+        Ctr::GpuVariableHeadless* variable = new Ctr::GpuVariableHeadless (_device, name, semantic);
+        _parameters.push_back (variable);
+
+        // Materials find their shader by the SHADERNAME annotation, as on D3D11.
+        static const std::regex shaderNameExpression ("\\bToString\\s*=\\s*\"([^\"]*)\"");
+        std::smatch shaderNameMatch;
+        if (semantic == "SHADERNAME" && 
+            std::regex_search (statement, shaderNameMatch, shaderNameExpression))
+        {
+            setName (shaderNameMatch.str(1).c_str());
+        }
+
+        if (constantBuffer && !isObjectType (type))
+        {
+            // Declarations of several variables are only partly parsed.
+            size_t declaratorEnd = statement.find_first_of (":<=", match.position(2));
+            bool single = statement.find (',', match.position(2)) >= declaratorEnd;
+
+            Ctr::GpuVariable::BufferLayout layout;
+            bool rowMajor = std::regex_search (statement, rowMajorExpression);
+            if (single && numericLayout (type, arraySize, rowMajor, layout))
+                constantBuffer->add (variable, layout);
+            else
+                constantBuffer->addUnknown();
+        }
+    }
+}
+
+void
+ShaderHeadless::addTechnique (const std::string& name, uint32_t passCount)
+{
+    _techniques.push_back (new Ctr::GpuTechniqueHeadless (_device, name, passCount));
+}
+
+bool 
+ShaderHeadless::passVariables()
+{
+    for (auto variable = _parameters.begin();
+        variable != _parameters.end(); 
+        variable++)
+    {
+        getParameterType ((*variable));
+    }
+    return true;
+}
+
+void 
+ShaderHeadless::getParameterType(Ctr::GpuVariable* variable)
+{
+    if (const Ctr::ShaderParameterValue* value = 
+        _deviceInterface->shaderValueFactory()->createShaderParameterValue(_deviceInterface,
+                                                                           variable, nullptr))
+    {
+        switch (value->parameterScope())
+        {
+            case Ctr::PerMesh:
+                _meshParameters.insert (_meshParameters.begin(), value);
+                break;
+            case Ctr::PerTechnique:
+                _techniqueParameters.insert (_techniqueParameters.begin(), value);
+                break;
+            case Ctr::PerMaterial:
+                _materialParameters.insert (_materialParameters.begin(), value);
+                break;
+            case Ctr::PerFrame:
+                _frameParameters.insert (_frameParameters.begin(), value);
+                break;
+            case Ctr::PerCamera:
+                _cameraParameters.insert (_cameraParameters.begin(), value);
+                break;
+        }
+        _shaderParameterValues.insert (_shaderParameterValues.begin(), value);
+        if (value->parameterType() == Ctr::InstanceWorldMatrices)
+        {
+            _supportsInstancing = true;
+        }
+    }
+}
+
+uint32_t
+ShaderHeadless::techniqueCount() const
+{
+    return uint32_t(_techniques.size());
+}
+
+const Ctr::IEffect*
+ShaderHeadless::effect() const
+{
+    return nullptr;
+}
+
+const Ctr::GpuTechnique*
+ShaderHeadless::getTechnique(uint32_t index) const
+{
+    uint32_t techniqueIndex = 0;
+    for (auto it = _techniques.begin(); it != _techniques.end(); it++, techniqueIndex++)
+    {
+        if (techniqueIndex == index)
+        {
+            return *it;
+        }
+    }
+    return nullptr;
+}
+
+bool
+ShaderHeadless::getTechniqueByName(const std::string& name, 
+                                   const Ctr::GpuTechnique*& technique) const
+{
+    for (auto techniqueIt = _techniques.begin();
+        techniqueIt != _techniques.end(); 
+        techniqueIt++)
+    {
+        if ((*techniqueIt)->name() == name)
+        {
+            technique = (*techniqueIt);
+            return true;
+        }
+    }
+
+    if (!_sourceAvailable)
+    {
+        Ctr::GpuTechniqueHeadless* headlessTechnique = new Ctr::GpuTechniqueHeadless (_device, name);
+        _techniques.push_back (headlessTechnique);
+        technique = headlessTechnique;
+        return true;
+    }
+
+    LOG ("Failed to find technique by name = " << name << " for shader " << this->name()  << "\n");
+    return false;
+}
+
+bool
+ShaderHeadless::getParameterByName (const std::string& parameterName, 
+                                    const Ctr::GpuVariable*& coreVariable) const
+{
+    coreVariable = nullptr;
+
+    for (auto it = _parameters.begin();
+         it != _parameters.end();
+         it++)
+    {
+        if ((*it)->name() == parameterName)
+        {
+            coreVariable = (*it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+ShaderHeadless::getConstantBufferByName(const std::string& constantBufferName,
+                                        const Ctr::GpuConstantBuffer*& constantBuffer) const
+{
+    constantBuffer = nullptr;
+    for (auto it = _constantBuffers.begin(); it != _constantBuffers.end(); it++)
+    {
+        if ((*it)->name() == constantBufferName)
+        {
+            constantBuffer = (*it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool 
+ShaderHeadless::setParameters (const Ctr::PostEffect* target) const
+{
+    return true;
+}
+
+bool 
+ShaderHeadless::setParameters (const Ctr::RenderRequest& request) const
+{
+    setFrameParameters (request);
+    setCameraParameters (request);
+    setTechniqueParameters (request);
+    setMaterialParameters (request);
+    setMeshParameters (request);
+    return true;
+}
+
+bool 
+ShaderHeadless::setFrameParameters (const Ctr::RenderRequest& request) const
+{
+    if (!scopeState().frameChanged (request, _deviceInterface->frameIndex()))
+    {
+        Ctr::ShaderParameterValue::skip ((uint32_t)_frameParameters.size());
+        return true;
+    }
+
+    for (auto it = _frameParameters.begin(); it != _frameParameters.end(); it++)
+    {
+        (*it)->evaluate (request);
+    }
+    return true;
+}
+
+bool 
+ShaderHeadless::setCameraParameters (const Ctr::RenderRequest& request) const
+{
+    if (!scopeState().cameraChanged (request, _deviceInterface->frameIndex()))
+    {
+        Ctr::ShaderParameterValue::skip ((uint32_t)_cameraParameters.size());
+        return true;
+    }
+
+    for (auto it = _cameraParameters.begin(); it != _cameraParameters.end(); it++)
+    {
+        (*it)->evaluate (request);
+    }
+    return true;
+}
+
+bool 
+ShaderHeadless::setTechniqueParameters (const Ctr::RenderRequest& request) const
+{
+    for (auto it = _techniqueParameters.begin(); it != _techniqueParameters.end(); it++)
+    {
+        (*it)->evaluate (request);
+    }
+    return true;
+}
+
+bool 
+ShaderHeadless::setMeshParameters (const Ctr::RenderRequest& request) const
+{
+    for (auto it = _meshParameters.begin(); it != _meshParameters.end(); it++)
+    {
+        (*it)->evaluate (request);
+    }
+    return true;
+}
+
+bool 
+ShaderHeadless::setMaterialParameters (const Ctr::RenderRequest& request) const
+{
+    for (auto it = _materialParameters.begin(); it != _materialParameters.end(); it++)
+    {
+        (*it)->evaluate (request);
+    }
+    return true;
+}
+
+Ctr::ParameterScopeState&
+ShaderHeadless::scopeState() const
+{
+    if (Ctr::ICommandList* commandList = Ctr::ICommandList::recording())
+        return commandList->scopeState (this);
+    return _scopeState;
+}
+
+bool
+ShaderHeadless::commitConstantBuffers() const
+{
+    for (auto it = _constantBuffers.begin(); it != _constantBuffers.end(); it++)
+    {
+        (*it)->commit();
+    }
+    return true;
+}
+
+bool
+ShaderHeadless::drawMesh (const Ctr::RenderRequest& request,
+                          const Ctr::GpuTechniqueHeadless* technique) const
+{
+    Ctr::CullMode cachedCullMode = _deviceInterface->cullMode();
+    bool twoSided = request.material && request.material->twoSided();
+
+    if (twoSided)
+    {
+        _deviceInterface->setCullMode (Ctr::CullNone);
+    }
+
+    for (uint32_t passIndex = 0; passIndex < technique->passCount(); passIndex++)
+    {
+        commitConstantBuffers();
+        technique->apply (passIndex);
+        request.mesh->render (&request, technique);
+    }
+
+    if (twoSided)
+    {
+        _deviceInterface->setCullMode (cachedCullMode);
+    }
+    return true;
+}
+
+bool
+ShaderHeadless::renderMeshSubset (Ctr::PrimitiveType primitiveType,
+                                  size_t startIndex,
+                                  size_t numIndices,
+                                  const Ctr::RenderRequest& request) const
+{
+    if (const Ctr::GpuTechniqueHeadless* technique = 
+        dynamic_cast<const Ctr::GpuTechniqueHeadless*>(request.technique))
+    {
+        setParameters (request);
+        for (uint32_t passIndex = 0; passIndex < technique->passCount(); passIndex++)
+        {
+            commitConstantBuffers();
+            technique->apply (passIndex);
+            // This assumes that the vertex buffer is already bound
+            _device->commandLog()->record (Ctr::CommandLogHeadless::DrawIndexed, 
+                                           technique, uint32_t(numIndices));
+        }
+    }
+    return true;
+}
+
+bool
+ShaderHeadless::renderMesh (const Ctr::RenderRequest& request) const
+{
+    if (!request.mesh->visible())
+        return true;
+
+    if (const Ctr::GpuTechniqueHeadless* technique = 
+        dynamic_cast<const Ctr::GpuTechniqueHeadless*>(request.technique))
+    {
+        if (setParameters (request))
+        {
+            Ctr::RenderRequest meshRequest = request;
+            meshRequest.material = request.mesh->material();
+            drawMesh (meshRequest, technique);
+        }
+    }
+    return true;
+}
+
+bool
+ShaderHeadless::renderQueuedMesh (const Ctr::RenderRequest& request,
+                                  uint32_t bindFlags) const
+{
+    if (!request.mesh->visible())
+        return true;
+
+    if (const Ctr::GpuTechniqueHeadless* technique = 
+        dynamic_cast<const Ctr::GpuTechniqueHeadless*>(request.technique))
+    {
+        setFrameParameters (request);
+        setCameraParameters (request);
+        if (bindFlags & Ctr::BindTechniqueParameters)
+            setTechniqueParameters (request);
+        if (bindFlags & Ctr::BindMaterialParameters)
+            setMaterialParameters (request);
+        setMeshParameters (request);
+
+        drawMesh (request, technique);
+    }
+    return true;
+}
+
+bool 
+ShaderHeadless::renderMeshes (const Ctr::RenderRequest& inputRequest,
+                              const std::set<const Ctr::Mesh*>& meshes) const
+{
+    Ctr::RenderRequest request = inputRequest;
+
+    if (const Ctr::GpuTechniqueHeadless* technique = 
+        dynamic_cast<const Ctr::GpuTechniqueHeadless*>(request.technique))
+    {
+        for (auto it = meshes.begin(); it != meshes.end(); it++)
+        {
+            const Ctr::Mesh* mesh = (*it);
+            if (!mesh->visible())
+                continue;
+
+            request.mesh = mesh;
+            request.material = mesh->material();
+
+            setFrameParameters (request);
+            setCameraParameters (request);
+            setTechniqueParameters (request);
+            setMaterialParameters (request);
+            setMeshParameters (request);
+
+            drawMesh (request, technique);
+        }
+    }
+    return true;
+}
+
+bool
+ShaderHeadless::renderInstancedBuffer (const Ctr::RenderRequest& request,
+                                       const Ctr::IGpuBuffer* instanceBuffer)  const
+{
+    if (const Ctr::GpuTechniqueHeadless* technique = 
+        dynamic_cast<const Ctr::GpuTechniqueHeadless*>(request.technique))
+    {
+        setFrameParameters (request);
+        setCameraParameters (request);
+        setTechniqueParameters (request);
+        setMaterialParameters (request);
+        setMeshParameters (request);
+
+        for (uint32_t passIndex = 0; passIndex < technique->passCount(); passIndex++)
+        {
+            commitConstantBuffers();
+            technique->apply (passIndex);
+            _device->commandLog()->record (Ctr::CommandLogHeadless::DrawInstanced, instanceBuffer);
+        }
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,169 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_SHADER_HEADLESS
+#define INCLUDED_CRT_SHADER_HEADLESS
+
+#include <CtrPlatform.h>
+#include <CtrIShader.h>
+#include <CtrShaderParameterValue.h>
+
+namespace Ctr
+{
+class DeviceHeadless;
+class CommandLogHeadless;
+class GpuTechniqueHeadless;
+class GpuVariableHeadless;
+class ConstantBufferHeadless;
+class ShaderParameterValue;
+
+//------------------------------------------------------------------------
+// Shader that is never compiled. The effect source is scanned for
+// techniques and for global and cbuffer declarations so that variables
+// reach ShaderParameterValueFactory with their semantics, and rendering
+// binds them per scope exactly as ShaderD3D11 does. Numeric variables are
+// packed into their cbuffer's shadow, which is committed before each pass
+// is applied. When the source cannot be opened techniques are created on
+// first request instead.
+//------------------------------------------------------------------------
+class ShaderHeadless : public Ctr::IShader
+{
+  public:
+    typedef std::list<Ctr::GpuTechniqueHeadless*>        TechniqueList;
+    typedef std::list<Ctr::GpuVariableHeadless*>         VariableList;
+    typedef std::list<Ctr::ConstantBufferHeadless*>      ConstantBufferList;
+    typedef std::list<const Ctr::ShaderParameterValue*>  VariableValueList;
+
+  public:
+    ShaderHeadless (Ctr::DeviceHeadless* device);
+    virtual ~ShaderHeadless();
+
+    virtual bool                free();
+    virtual bool                create();
+    virtual bool                cache();
+
+    virtual bool                initialize (const std::string& filename, 
+                                            const std::string& includePathName,
+                                            bool  verbose, 
+                                            bool  allowDeprecated);
+
+    virtual bool                initialize (const std::string& file,
+                                            const std::string& include,
+                                            bool verbose,
+                                            bool allowDeprecated,
+                                            const std::map<std::string, std::string>& defines);
+
+    virtual bool                getTechniqueByName (const std::string& name, 
+                                                    const Ctr::GpuTechnique*& technique) const;
+    virtual bool                getParameterByName (const std::string& parameterName,
+                                                    const Ctr::GpuVariable*& coreVariable) const;
+    virtual bool                getConstantBufferByName(const std::string& constantBufferName,
+                                                        const Ctr::GpuConstantBuffer*&) const;
+
+    virtual bool                renderMesh (const Ctr::RenderRequest& request) const;
+    virtual bool                renderMeshes (const Ctr::RenderRequest& request,
+                                              const std::set<const Ctr::Mesh*>& meshes) const;
+    virtual bool                renderQueuedMesh (const Ctr::RenderRequest& request,
+                                                  uint32_t bindFlags) const;
+    virtual bool                renderInstancedBuffer (const Ctr::RenderRequest& request,
+                                                       const Ctr::IGpuBuffer* instanceBuffer) const;
+    virtual bool                renderMeshSubset (Ctr::PrimitiveType primitiveType,
+                                                  size_t startIndex,
+                                                  size_t numIndices,
+                                                  const Ctr::RenderRequest& request) const;
+
+    virtual bool                passVariables();
+    bool                        setFrameParameters (const Ctr::RenderRequest& request) const;
+    bool                        setCameraParameters (const Ctr::RenderRequest& request) const;
+    bool                        setTechniqueParameters (const Ctr::RenderRequest& request) const;
+    bool                        setMeshParameters (const Ctr::RenderRequest& request) const;
+    bool                        setMaterialParameters (const Ctr::RenderRequest& request) const;
+
+    //------------------------------------------------------------
+    // Uploads every dirty constant buffer. Called before a pass
+    // is applied.
+    //------------------------------------------------------------
+    bool                        commitConstantBuffers() const;
+    // The recording command list's scope state, if any.
+    Ctr::ParameterScopeState&   scopeState() const;
+
+    virtual bool                setParameters (const Ctr::RenderRequest& request) const;
+    virtual void                getParameterType (Ctr::GpuVariable* param);
+    virtual bool                setParameters (const Ctr::PostEffect* target) const;
+
+    virtual uint32_t            techniqueCount() const;
+    virtual const Ctr::GpuTechnique* getTechnique (uint32_t index) const;
+    virtual const Ctr::IEffect* effect () const;
+
+  protected:
+    //------------------------------------------------------------
+    // Finds techniques and variable declarations in the source.
+    //------------------------------------------------------------
+    void                        parseSource (const std::string& source);
+    void                        parseDeclaration (const std::string& statement,
+                                                  Ctr::ConstantBufferHeadless* constantBuffer);
+    void                        addConstantBuffer (Ctr::ConstantBufferHeadless* constantBuffer);
+    void                        addTechnique (const std::string& name, uint32_t passCount);
+
+    bool                        drawMesh (const Ctr::RenderRequest& request,
+                                          const Ctr::GpuTechniqueHeadless* technique) const;
+
+  private:
+    Ctr::DeviceHeadless*        _device;
+    mutable TechniqueList       _techniques;
+    VariableList                _parameters;
+    ConstantBufferList          _constantBuffers;
+    VariableValueList           _shaderParameterValues;
+    VariableValueList           _meshParameters;
+    VariableValueList           _techniqueParameters;
+    VariableValueList           _materialParameters;
+    VariableValueList           _frameParameters;
+    VariableValueList           _cameraParameters;
+    mutable Ctr::ParameterScopeState _scopeState;
+    bool                        _sourceAvailable;
+    bool                        _verbose;
+    bool                        _allowDeprecated;
+    std::map<std::string, std::string> _defines;
+};
+
+}
+
+#endif
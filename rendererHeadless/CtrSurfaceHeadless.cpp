@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrSurfaceHeadless.h>
+#include <CtrRenderDeviceHeadless.h>
+#include <CtrITexture.h>
+
+namespace Ctr
+{
+SurfaceHeadless::SurfaceHeadless (Ctr::DeviceHeadless* device) : 
+    Ctr::ISurface (device),
+    _commandLog (device->commandLog()),
+    _texture (nullptr),
+    _firstLevel (0),
+    _numberOfLevels (1),
+    _mipLevel (-1)
+{
+}
+
+SurfaceHeadless::~SurfaceHeadless()
+{
+}
+
+bool
+SurfaceHeadless::initialize (int firstLevel, 
+                             int numberOfLevels,
+                             ITexture* texture,
+                             int mipLevel)
+{
+    _firstLevel = firstLevel;
+    _numberOfLevels = numberOfLevels;
+    _texture = texture;
+    _mipLevel = mipLevel;
+    return create();
+}
+
+bool
+SurfaceHeadless::create()
+{
+    return _texture != nullptr;
+}
+
+bool
+SurfaceHeadless::free()
+{
+    return true;
+}
+
+bool
+SurfaceHeadless::cache()
+{
+    return true;
+}
+
+bool
+SurfaceHeadless::bind (uint32_t level) const
+{
+    _deviceInterface->bindSurface (level, this);
+    return true;
+}
+
+bool
+SurfaceHeadless::bindAndClear (uint32_t level) const
+{
+    _commandLog->record (Ctr::CommandLogHeadless::Clear, this);
+    _deviceInterface->bindSurface (level, this);
+    return true;
+}
+
+unsigned int
+SurfaceHeadless::width() const
+{
+    if (!_texture)
+        return 0;
+    return std::max(_texture->width() >> std::max(_mipLevel, 0), 1u);
+}
+
+unsigned int
+SurfaceHeadless::height() const
+{
+    if (!_texture)
+        return 0;
+    return std::max(_texture->height() >> std::max(_mipLevel, 0), 1u);
+}
+
+bool
+SurfaceHeadless::writeToFile (const std::string& filename) const
+{
+    return _texture && _texture->save (filename, false, false, false, std::max(_mipLevel, 0));
+}
+
+const Ctr::ITexture*
+SurfaceHeadless::texture() const
+{
+    return _texture;
+}
+
+int
+SurfaceHeadless::firstLevel() const
+{
+    return _firstLevel;
+}
+
+int
+SurfaceHeadless::numberOfLevels() const
+{
+    return _numberOfLevels;
+}
+
+int
+SurfaceHeadless::mipLevel() const
+{
+    return _mipLevel;
+}
+
+}
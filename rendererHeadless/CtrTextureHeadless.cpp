@@ -0,0 +1,539 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrTextureHeadless.h>
+#include <CtrSurfaceHeadless.h>
+#include <CtrRenderDeviceHeadless.h>
+#include <CtrTextureImage.h>
+
+namespace Ctr
+{
+namespace
+{
+uint32_t
+mirroredSize (uint32_t requested, uint32_t backbufferSize)
+{
+    switch (requested)
+    {
+        case MIRROR_BACK_BUFFER:         return backbufferSize;
+        case MIRROR_BACK_BUFFER_HALF:    return backbufferSize / 2;
+        case MIRROR_BACK_BUFFER_QUARTER: return backbufferSize / 4;
+        case MIRROR_BACK_BUFFER_EIGTH:   return backbufferSize / 8;
+        default:                         return requested;
+    }
+}
+}
+
+TextureHeadless::TextureHeadless (Ctr::DeviceHeadless* device) : 
+    Ctr::ITexture (device),
+    _commandLog (device->commandLog()),
+    _sliceCount (0),
+    _storageSize (0),
+    _mapped (false),
+    _mappedSlice (0),
+    _mappedMip (0),
+    _maxValue (1, 1, 1, 1),
+    _maxValueCached (false)
+{
+}
+
+TextureHeadless::~TextureHeadless()
+{
+    free();
+}
+
+bool
+TextureHeadless::initialize (const Ctr::TextureParameters* data)
+{
+    safedelete (_resource);
+    _resource = new Ctr::TextureParameters (*data);
+    _width = _resource->width();
+    _height = _resource->height();
+    _depth = _resource->depth();
+    _format = _resource->format();
+    _textureCount = _resource->textureCount();
+    _multiSampleCount = _resource->multiSampleCount();
+    _multiSampleQuality = _resource->multiSampleQuality();
+
+    return create();
+}
+
+bool
+TextureHeadless::create()
+{
+    free();
+
+    const Ctr::TextureImageArray& images = _resource->images();
+    bool fromImages = _resource->type() != Ctr::RenderTarget && images.size() > 0;
+
+    if (fromImages)
+    {
+        const Ctr::TextureImagePtr& image = images[0];
+        for (auto it = images.begin() + 1; it != images.end(); it++)
+        {
+            if ((*it)->getWidth() != image->getWidth() ||
+                (*it)->getHeight() != image->getHeight() ||
+                (*it)->getFormat() != image->getFormat())
+            {
+                LOG ("Failed to load image array due to size or format mismatch");
+                return false;
+            }
+        }
+
+        _width = uint32_t(image->getWidth());
+        _height = uint32_t(image->getHeight());
+        _format = image->getFormat();
+        _mipCount = uint32_t(std::max(image->getNumMipmaps(), size_t(1)));
+        _sliceCount = uint32_t(image->getNumFaces() * images.size());
+    }
+    else
+    {
+        if (_resource->type() == Ctr::FromFile || _resource->type() == Ctr::StagingFromFile)
+        {
+            LOG ("Failed to load any images for headless texture");
+            return false;
+        }
+
+        if (recreateOnResize())
+        {
+            if (const Ctr::ISurface* backbuffer = _deviceInterface->backbuffer())
+            {
+                _width = mirroredSize (_resource->width(), backbuffer->width());
+                _height = mirroredSize (_resource->height(), backbuffer->height());
+            }
+        }
+
+        _mipCount = uint32_t(std::max(_resource->mipLevels(), size_t(1)));
+        if (_resource->generateMipMaps() && _mipCount == 1)
+        {
+            _mipCount = numberOfMipsInChain (std::max(_width, _height));
+        }
+        _sliceCount = std::max(uint32_t(_resource->textureCount()), 1u);
+        if (isCubeMap() && _sliceCount < 6)
+        {
+            _sliceCount = 6;
+        }
+    }
+
+    size_t elementBytes = Ctr::PixelUtil::getNumElemBytes(_format);
+    _channels = uint32_t(Ctr::PixelUtil::getComponentCount(_format));
+    _pixelChannelPitch = _channels > 0 ? uint32_t(elementBytes / _channels) : 0;
+
+    _levelOffsets.resize (_sliceCount * _mipCount);
+    _storageSize = 0;
+    for (uint32_t slice = 0; slice < _sliceCount; slice++)
+    {
+        for (uint32_t mip = 0; mip < _mipCount; mip++)
+        {
+            _levelOffsets[slice * _mipCount + mip] = _storageSize;
+            _storageSize += Ctr::PixelUtil::getMemorySize(std::max(_width >> mip, 1u),
+                                                          std::max(_height >> mip, 1u),
+                                                          1, _format);
+        }
+    }
+
+    if (fromImages)
+    {
+        allocate();
+        size_t offset = 0;
+        for (auto it = images.begin(); it != images.end(); it++)
+        {
+            size_t imageSize = std::min((*it)->getSize(), _storageSize - offset);
+            memcpy (&_data[offset], (*it)->getData(), imageSize);
+            offset += imageSize;
+        }
+    }
+    else if (_resource->type() == Ctr::Procedural)
+    {
+        allocate();
+    }
+
+    return _storageSize > 0;
+}
+
+bool
+TextureHeadless::recreateOnResize()
+{
+    return _resource->type() == Ctr::RenderTarget &&
+           mirroredSize (_resource->width(), 0) != _resource->width();
+}
+
+bool
+TextureHeadless::free()
+{
+    for (auto it = _surfaces.begin(); it != _surfaces.end(); it++)
+    {
+        delete it->second;
+    }
+    _surfaces.clear();
+    std::vector<uint8_t>().swap (_data);
+    _mapped = false;
+    _maxValueCached = false;
+    return true;
+}
+
+bool
+TextureHeadless::cache()
+{
+    return true;
+}
+
+bool
+TextureHeadless::allocate() const
+{
+    if (_data.size() != _storageSize)
+    {
+        _data.assign (_storageSize, 0);
+    }
+    return !_data.empty();
+}
+
+bool
+TextureHeadless::bindSurface(int renderTargetIndex) const
+{
+    if (const ISurface* renderSurface = surface())
+    {
+        return renderSurface->bind (renderTargetIndex);
+    }
+    return false;
+}
+
+bool
+TextureHeadless::clearSurface (uint32_t layerId, float r, float g, float b, float a)
+{
+    _commandLog->record (Ctr::CommandLogHeadless::Clear, this, layerId);
+    return true;
+}
+
+bool
+TextureHeadless::isCubeMap() const
+{
+    return _resource && _resource->dimension() == Ctr::CubeMap;
+}
+
+const ISurface*
+TextureHeadless::surface(int32_t arrayId, int32_t mipId) const
+{
+    if (!_resource || _resource->type() != Ctr::RenderTarget)
+        return nullptr;
+    if (arrayId >= int32_t(_sliceCount) || mipId >= int32_t(_mipCount))
+        return nullptr;
+
+    auto key = std::make_pair(arrayId, mipId);
+    auto it = _surfaces.find (key);
+    if (it != _surfaces.end())
+    {
+        return it->second;
+    }
+
+    Ctr::SurfaceHeadless* renderSurface = 
+        new Ctr::SurfaceHeadless (dynamic_cast<Ctr::DeviceHeadless*>(_deviceInterface));
+    renderSurface->initialize (arrayId < 0 ? 0 : arrayId, 
+                               arrayId < 0 ? _sliceCount : 1, 
+                               const_cast<TextureHeadless*>(this), mipId);
+    _surfaces.insert (std::make_pair(key, renderSurface));
+    return renderSurface;
+}
+
+const Ctr::Vector4f&
+TextureHeadless::maxValue() const
+{
+    if (!_maxValueCached)
+    {
+        _maxValueCached = true;
+        if (!_data.empty() && !Ctr::PixelUtil::isCompressed(_format))
+        {
+            _maxValue = Ctr::Vector4f(-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX);
+            size_t elementBytes = Ctr::PixelUtil::getNumElemBytes(_format);
+            for (uint32_t slice = 0; slice < _sliceCount; slice++)
+            {
+                const uint8_t* src = levelData (slice, 0);
+                for (size_t i = 0; i < area(); i++, src += elementBytes)
+                {
+                    Ctr::Vector4f value;
+                    Ctr::PixelUtil::unpackColor (&value.x, &value.y, &value.z, &value.w, _format, src);
+                    for (uint32_t c = 0; c < 4; c++)
+                        _maxValue[c] = std::max(_maxValue[c], value[c]);
+                }
+            }
+        }
+    }
+    return _maxValue;
+}
+
+void
+TextureHeadless::generateMipMaps() const
+{
+    _commandLog->record (Ctr::CommandLogHeadless::Blit, this, _mipCount);
+}
+
+bool
+TextureHeadless::map(uint32_t imageLevel, uint32_t mipLevel) const
+{
+    if (_mapped || imageLevel >= _sliceCount || mipLevel >= _mipCount || !allocate())
+        return false;
+
+    _commandLog->record (Ctr::CommandLogHeadless::Map, this, uint32_t(levelSize(imageLevel, mipLevel)));
+    _mapped = true;
+    _mappedSlice = imageLevel;
+    _mappedMip = mipLevel;
+    return true;
+}
+
+bool
+TextureHeadless::unmap() const
+{
+    if (!_mapped)
+        return false;
+    _mapped = false;
+    return true;
+}
+
+bool
+TextureHeadless::mapForRead() const
+{
+    return map (0, 0);
+}
+
+bool
+TextureHeadless::unmapFromRead() const
+{
+    return unmap();
+}
+
+bool
+TextureHeadless::mapForWrite()
+{
+    _maxValueCached = false;
+    return map (0, 0);
+}
+
+uint8_t*
+TextureHeadless::texel (uint32_t x, uint32_t y) const
+{
+    uint32_t mipWidth = std::max(_width >> _mappedMip, 1u);
+    uint32_t mipHeight = std::max(_height >> _mappedMip, 1u);
+    if (x >= mipWidth || y >= mipHeight || Ctr::PixelUtil::isCompressed(_format))
+        return nullptr;
+
+    return levelData (_mappedSlice, _mappedMip) + 
+        (size_t(y) * mipWidth + x) * Ctr::PixelUtil::getNumElemBytes(_format);
+}
+
+bool
+TextureHeadless::write (const Ctr::Vector4f& value, const Ctr::Vector2f& pos)
+{
+    if (!_mapped)
+    {
+        THROW ("You must map the texture before writing pixels! " << __FILE__ << " " << __LINE__);
+    }
+
+    if (uint8_t* dst = texel (uint32_t(pos.x), uint32_t(pos.y)))
+    {
+        Ctr::PixelUtil::packColor (value.x, value.y, value.z, value.w, _format, dst);
+        _maxValueCached = false;
+        return true;
+    }
+    return false;
+}
+
+bool
+TextureHeadless::write (const Ctr::PixelBox& pixelBox,
+                        uint32_t mipLevel)
+{
+    if (mipLevel >= _mipCount || !allocate())
+        return false;
+
+    _commandLog->record (Ctr::CommandLogHeadless::Map, this, uint32_t(levelSize(0, mipLevel)));
+    _maxValueCached = false;
+
+    uint32_t mipWidth = std::max(_width >> mipLevel, 1u);
+    uint32_t mipHeight = std::max(_height >> mipLevel, 1u);
+
+    if (Ctr::PixelUtil::isCompressed(_format) || Ctr::PixelUtil::isCompressed(pixelBox.format))
+    {
+        memcpy (levelData(0, mipLevel), pixelBox.data, 
+                std::min(levelSize(0, mipLevel), pixelBox.getConsecutiveSize()));
+        return true;
+    }
+
+    Ctr::PixelBox dst (mipWidth, mipHeight, 1, _format, levelData(0, mipLevel));
+    if (pixelBox.size().x == mipWidth && pixelBox.size().y == mipHeight)
+    {
+        Ctr::PixelUtil::bulkPixelConversion (pixelBox, dst);
+    }
+    else
+    {
+        Ctr::TextureImage::scale (pixelBox, dst, Ctr::TextureImage::FILTER_NEAREST);
+    }
+    return true;
+}
+
+bool
+TextureHeadless::write(uint8_t* pixels)
+{
+    if (!allocate())
+        return false;
+
+    _commandLog->record (Ctr::CommandLogHeadless::Map, this, uint32_t(levelSize(0, 0)));
+    _maxValueCached = false;
+    memcpy (levelData(0, 0), pixels, levelSize(0, 0));
+    return true;
+}
+
+bool
+TextureHeadless::writeSubRegion(const Ctr::byte* srcPtr, uint32_t offsetX, uint32_t offsetY, uint32_t w, uint32_t h, uint32_t bytesPerPixel)
+{
+    if (!allocate() || offsetX + w > _width || offsetY + h > _height)
+        return false;
+
+    _commandLog->record (Ctr::CommandLogHeadless::Map, this, w * h * bytesPerPixel);
+    _maxValueCached = false;
+
+    uint8_t* dst = levelData(0, 0);
+    size_t dstRowPitch = size_t(_width) * bytesPerPixel;
+    for (uint32_t row = 0; row < h; row++)
+    {
+        memcpy (dst + (offsetY + row) * dstRowPitch + offsetX * bytesPerPixel, 
+                srcPtr + size_t(row) * w * bytesPerPixel, 
+                size_t(w) * bytesPerPixel);
+    }
+    return true;
+}
+
+Ctr::Vector4f
+TextureHeadless::read (const Ctr::Vector2f& pos) const
+{
+    uint32_t mipWidth = std::max(_width >> _mappedMip, 1u);
+    uint32_t mipHeight = std::max(_height >> _mappedMip, 1u);
+    return read (Ctr::Vector2i(int(std::min(pos.x, 1.0f) * (mipWidth - 1)),
+                               int(std::min(pos.y, 1.0f) * (mipHeight - 1))));
+}
+
+Ctr::Vector4f
+TextureHeadless::read (const Ctr::Vector2i& pos) const
+{
+    if (!_mapped)
+    {
+        THROW ("You must map the texture before reading pixels! " << __FILE__ << " " << __LINE__);
+    }
+
+    Ctr::Vector4f pixel (0, 0, 0, 0);
+    if (pos.x >= 0 && pos.y >= 0)
+    {
+        if (const uint8_t* src = texel (uint32_t(pos.x), uint32_t(pos.y)))
+        {
+            Ctr::PixelUtil::unpackColor (&pixel.x, &pixel.y, &pixel.z, &pixel.w, _format, src);
+        }
+    }
+    return pixel;
+}
+
+Ctr::Vector4f
+TextureHeadless::read (Ctr::byte* pixels) const
+{
+    if (allocate())
+    {
+        memcpy (pixels, levelData(0, 0), levelSize(0, 0));
+    }
+    return Ctr::Vector4f();
+}
+
+bool
+TextureHeadless::save(const std::string& filePathName,
+                      bool fixSeams,
+                      bool splitChannels,
+                      bool rgbOnly,
+                      int32_t mipLevel,
+                      const Ctr::ITexture* mergeMap) const
+{
+    uint32_t mip = mipLevel < 0 ? 0 : uint32_t(mipLevel);
+    if (mip >= _mipCount || !allocate())
+        return false;
+
+    try
+    {
+        Ctr::TextureImage image;
+        image.loadDynamicTextureImage (levelData(0, mip), 
+                                       std::max(_width >> mip, 1u), 
+                                       std::max(_height >> mip, 1u), 
+                                       1, _format, false);
+        image.save (filePathName);
+    }
+    catch (const std::exception& e)
+    {
+        LOG ("Failed to save headless texture " << filePathName << ": " << e.what());
+        return false;
+    }
+    return true;
+}
+
+size_t
+TextureHeadless::byteSize() const
+{
+    return _storageSize;
+}
+
+uint32_t
+TextureHeadless::sliceCount() const
+{
+    return _sliceCount;
+}
+
+uint8_t*
+TextureHeadless::levelData (uint32_t slice, uint32_t mip) const
+{
+    if (slice >= _sliceCount || mip >= _mipCount || _data.empty())
+        return nullptr;
+    return &_data[_levelOffsets[slice * _mipCount + mip]];
+}
+
+size_t
+TextureHeadless::levelSize (uint32_t slice, uint32_t mip) const
+{
+    if (slice >= _sliceCount || mip >= _mipCount)
+        return 0;
+    return Ctr::PixelUtil::getMemorySize(std::max(_width >> mip, 1u),
+                                         std::max(_height >> mip, 1u),
+                                         1, _format);
+}
+
+}
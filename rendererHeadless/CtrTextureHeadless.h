@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#ifndef INCLUDED_CRT_TEXTURE_HEADLESS
+#define INCLUDED_CRT_TEXTURE_HEADLESS
+
+#include <CtrPlatform.h>
+#include <CtrITexture.h>
+#include <CtrVector4.h>
+
+namespace Ctr
+{
+class DeviceHeadless;
+class CommandLogHeadless;
+class SurfaceHeadless;
+
+//------------------------------------------------------------------------
+// Host memory texture. Texels are stored slice major with each slice
+// holding its full mip chain, matching TextureImage's face layout.
+// Work the GPU would do (clears, mip generation) is recorded but not
+// executed. Render targets only allocate storage when the CPU first maps,
+// reads or writes them.
+//------------------------------------------------------------------------
+class TextureHeadless : public Ctr::ITexture
+{
+  public:
+    TextureHeadless (Ctr::DeviceHeadless* device);
+    virtual ~TextureHeadless();
+
+    virtual bool               initialize (const Ctr::TextureParameters* resource);
+    virtual bool               create();
+    virtual bool               free();
+    virtual bool               cache();
+    virtual bool               recreateOnResize();
+
+    virtual bool               bindSurface(int renderTargetIndex) const;
+    virtual bool               clearSurface (uint32_t layerId, float r  = 1.0f, float g  = 1.0f, float b  = 1.0f, float a = 1.0f);
+    virtual bool               isCubeMap() const;
+
+    virtual const ISurface*    surface(int32_t arrayId = -1, int32_t mipId = -1) const;
+    virtual const Ctr::Vector4f& maxValue() const;
+    virtual void               generateMipMaps() const;
+
+    virtual bool               map(uint32_t imageLevel = 0, uint32_t mipLevel = 0) const;
+    virtual bool               unmap() const;
+    virtual bool               mapForRead() const;
+    virtual bool               unmapFromRead() const;
+    virtual bool               mapForWrite();
+
+    virtual bool               write (const Ctr::Vector4f&, const Ctr::Vector2f& pos);
+    virtual bool               write (const Ctr::PixelBox& pixelBox,
+                                      uint32_t mipLevel);
+    virtual bool               write (uint8_t* pixels);
+    virtual bool               writeSubRegion(const Ctr::byte* srcPtr, uint32_t offsetX, uint32_t offsetY, uint32_t w, uint32_t h, uint32_t bytesPerPixel);
+
+    virtual Ctr::Vector4f      read (const Ctr::Vector2f& pos) const;
+    virtual Ctr::Vector4f      read (const Ctr::Vector2i& pos) const;
+    virtual Ctr::Vector4f      read (Ctr::byte* pos) const;
+
+    virtual bool               save(const std::string& filePathName,
+                                    bool fixSeams = false,
+                                    bool splitChannels = false,
+                                    bool rgbOnly = false,
+                                    int32_t mipLevel = -1,
+                                    const Ctr::ITexture* mergeMap = nullptr) const;
+
+    virtual size_t             byteSize() const;
+
+    uint32_t                   sliceCount() const;
+    // Host copy of the given slice and mip, nullptr if out of range.
+    uint8_t*                   levelData (uint32_t slice, uint32_t mip) const;
+    size_t                     levelSize (uint32_t slice, uint32_t mip) const;
+
+  protected:
+    bool                       allocate() const;
+    uint8_t*                   texel (uint32_t x, uint32_t y) const;
+
+  private:
+    Ctr::CommandLogHeadless*   _commandLog;
+    uint32_t                   _sliceCount;
+    std::vector<size_t>        _levelOffsets;
+    size_t                     _storageSize;
+    mutable std::vector<uint8_t> _data;
+
+    mutable bool               _mapped;
+    mutable uint32_t           _mappedSlice;
+    mutable uint32_t           _mappedMip;
+
+    mutable Ctr::Vector4f      _maxValue;
+    mutable bool               _maxValueCached;
+
+    typedef std::map<std::pair<int32_t, int32_t>, SurfaceHeadless*> SurfaceMap;
+    mutable SurfaceMap         _surfaces;
+};
+
+}
+
+#endif
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrVertexBufferHeadless.h>
+#include <CtrRenderDeviceHeadless.h>
+
+namespace Ctr
+{
+VertexBufferHeadless::VertexBufferHeadless (Ctr::DeviceHeadless* device) : 
+    Ctr::IVertexBuffer (device),
+    _commandLog (device->commandLog()),
+    _locked (false),
+    _isRingBuffer (false),
+    _bufferCursor (0),
+    _lastCopySize (0)
+{
+    _vertexDeclaration = nullptr;
+}
+
+VertexBufferHeadless::~VertexBufferHeadless()
+{
+    free();
+}
+
+bool
+VertexBufferHeadless::initialize (const Ctr::VertexBufferParameters* data)
+{
+    _resource = Ctr::VertexBufferParameters(*data);
+    return create();
+}
+
+bool
+VertexBufferHeadless::create()
+{
+    _isRingBuffer = _resource.ringBuffered();
+    _bufferCursor = 0;
+    _lastCopySize = 0;
+
+    // Same ten frame no-overwrite window as the D3D11 ring buffers.
+    size_t sizeInBytes = _resource.sizeInBytes() * (_isRingBuffer ? 10 : 1);
+    _data.assign (sizeInBytes, 0);
+    if (_resource.vertexPtr() && _resource.sizeInBytes() > 0)
+    {
+        memcpy (&_data[0], _resource.vertexPtr(), _resource.sizeInBytes());
+    }
+    return sizeInBytes > 0;
+}
+
+bool
+VertexBufferHeadless::free()
+{
+    std::vector<uint8_t>().swap (_data);
+    _locked = false;
+    return true;
+}
+
+bool
+VertexBufferHeadless::cache()
+{
+    return true;
+}
+
+void*
+VertexBufferHeadless::lock(size_t byteSize)
+{
+    if (_locked || _data.empty())
+        return nullptr;
+
+    if (_isRingBuffer)
+    {
+        if (byteSize <= 0)
+        {
+            LOG_CRITICAL("VertexBuffer mapping failure while attempting to map ring buffer");
+        }
+
+        // Align to 16 bytes.
+        if (byteSize % 16 != 0)
+            byteSize += 16 - (byteSize % 16);
+
+        if ((_bufferCursor + _lastCopySize + byteSize) > _data.size())
+        {
+            _bufferCursor = 0;
+        }
+        else
+        {
+            _bufferCursor += _lastCopySize;
+        }
+        _lastCopySize = byteSize;
+    }
+
+    _commandLog->record (Ctr::CommandLogHeadless::Map, this, uint32_t(byteSize));
+    _locked = true;
+    return &_data[_bufferCursor];
+}
+
+bool
+VertexBufferHeadless::unlock()
+{
+    if (!_locked)
+        return false;
+    _locked = false;
+    return true;
+}
+
+bool
+VertexBufferHeadless::bind(uint32_t bufferOffset) const
+{
+    _commandLog->record (Ctr::CommandLogHeadless::BindVertexBuffer, this, 
+                         uint32_t(_bufferCursor + bufferOffset));
+    return true;
+}
+
+bool
+VertexBufferHeadless::bindToStreamOut() const
+{
+    _commandLog->record (Ctr::CommandLogHeadless::BindBuffer, this);
+    return true;
+}
+
+size_t
+VertexBufferHeadless::size() const
+{
+    return _data.size();
+}
+
+const uint8_t*
+VertexBufferHeadless::data() const
+{
+    return _data.empty() ? nullptr : &_data[0];
+}
+
+}
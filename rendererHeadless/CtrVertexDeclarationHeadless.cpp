@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//               _________        .__  __    __                                       //
+//               \_   ___ \_______|__|/  |__/  |_  ___________                        //
+//               /    \  \/\_  __ \  \   __\   __\/ __ \_  __ \                       //
+//               \     \____|  | \/  ||  |  |  | \  ___/|  | \/                       //
+//                \______  /|__|  |__||__|  |__|  \___  >__|                          //
+//                       \/                           \/                              //
+//                                                                                    //
+//    Critter is provided under the MIT License(MIT)                                  //
+//    Critter uses portions of other open source software.                            //
+//    Please review the LICENSE file for further details.                             //
+//                                                                                    //
+//    Copyright(c) 2015 Matt Davidson                                                 //
+//                                                                                    //
+//    Permission is hereby granted, free of charge, to any person obtaining a copy    //
+//    of this software and associated documentation files(the "Software"), to deal    //
+//    in the Software without restriction, including without limitation the rights    //
+//    to use, copy, modify, merge, publish, distribute, sublicense, and / or sell     //
+//    copies of the Software, and to permit persons to whom the Software is           //
+//    furnished to do so, subject to the following conditions :                       //
+//                                                                                    //
+//    1. Redistributions of source code must retain the above copyright notice,       //
+//    this list of conditions and the following disclaimer.                           //
+//    2. Redistributions in binary form must reproduce the above copyright notice,    //
+//    this list of conditions and the following disclaimer in the                     //
+//    documentation and / or other materials provided with the distribution.          //
+//    3. Neither the name of the copyright holder nor the names of its                //
+//    contributors may be used to endorse or promote products derived                 //
+//    from this software without specific prior written permission.                   //
+//                                                                                    //
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      //
+//    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        //
+//    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE      //
+//    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          //
+//    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   //
+//    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN       //
+//    THE SOFTWARE.                                                                   //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+#include <CtrVertexDeclarationHeadless.h>
+#include <CtrRenderDeviceHeadless.h>
+
+namespace Ctr
+{
+VertexDeclarationHeadless::VertexDeclarationHeadless (Ctr::DeviceHeadless* device) : 
+    Ctr::IVertexDeclaration (device),
+    _commandLog (device->commandLog()),
+    _vertexStride (0)
+{
+}
+
+VertexDeclarationHeadless::~VertexDeclarationHeadless()
+{
+}
+
+bool
+VertexDeclarationHeadless::initialize (const Ctr::VertexDeclarationParameters* resource)
+{
+    const std::vector<Ctr::VertexElement> & elements = resource->elements();
+
+    // The last element is the end of declaration marker.
+    if (elements.size() < 2)
+        return false;
+
+    const Ctr::VertexElement& element = elements[elements.size()-2];
+    _vertexStride = element.offset() + IVertexDeclaration::elementToSize(element.type());
+    _declaration = elements;
+
+    return create();
+}
+
+bool
+VertexDeclarationHeadless::create()
+{
+    return _vertexStride > 0;
+}
+
+bool
+VertexDeclarationHeadless::free()
+{
+    return true;
+}
+
+bool
+VertexDeclarationHeadless::cache()
+{
+    return true;
+}
+
+bool
+VertexDeclarationHeadless::bind() const
+{
+    _commandLog->record (Ctr::CommandLogHeadless::BindVertexDeclaration, this);
+    return true;
+}
+
+uint32_t
+VertexDeclarationHeadless::vertexStreamCount() const
+{
+    // Always float.
+    return _vertexStride / sizeof(float);
+}
+
+unsigned int
+VertexDeclarationHeadless::vertexStride() const
+{
+    return _vertexStride;
+}
+
+const std::vector <Ctr::VertexElement>& 
+VertexDeclarationHeadless::getDeclaration() const
+{
+    return _declaration;
+}
+
+}
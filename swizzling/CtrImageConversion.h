@@ -43,11 +43,10 @@
 #define INCLUDED_IMAGE_CONVERSION
 
 #include <CtrPlatform.h>
-#include <CtrRenderNode.h>
-#include <CtrTypedProperty.h>
-#include <CtrIDevice.h>
+#include <CtrMath.h>
+#include <CtrLimits.h>
 #include <CtrBitwise.h>
-#include <ppl.h>
+#include <CtrParallel.h>
 
 namespace Ctr
 {
@@ -61,95 +60,79 @@ namespace Ctr
             dst = T(src);
         }
         
-        template < >
         inline void operator()(uint8_t& dst, const uint8_t& src) const
         {
             dst = src;
         }
 
-        template < >
         inline void operator()(uint8_t& dst, const uint16_t& src) const
         {
             dst = uint8_t(((float)(src) / USHRT_MAX) * 255.0f);
         }
 
-        template < >
         inline void operator()(uint8_t& dst, const half& src) const
         {
             dst = (uint8_t)(Bitwise::halfToFloat(src()) * 255.0f);
         }
 
-        template < >
         inline void operator()(uint8_t& dst, const float& src) const
         {
             dst = (uint8_t)(src * 255.0f);
         }
-        template < >
         inline void operator()(uint16_t& dst, const uint8_t& src) const
         {
             dst = (uint16_t)((src / 255.0f) * USHRT_MAX);
         }
 
-        template < >
         inline void operator()(uint16_t& dst, const float& src) const
         {
             dst = (uint16_t)(saturate(src) * USHRT_MAX);
         }
 
-        template < >
         inline void operator()(uint16_t& dst, const uint16_t& src) const
         {
             dst = src;
         }
-        template < >
         inline void operator()(uint16_t& dst, const half& src) const
         {
             dst = uint16_t(saturate(Bitwise::halfToFloat(src())) / USHRT_MAX);
         }
 
-        template < >
         inline void operator()(half& dst, const uint8_t& src) const
         {
             dst = Bitwise::floatToHalf((src / 255.0f));
         }
 
-        template < >
         inline void operator()(half& dst, const uint16_t& src) const
         {
             dst = Bitwise::floatToHalf(float(src / USHRT_MAX));
         }
 
-        template < >
         inline void operator()(half& dst, const half& src) const
         {
             dst = src;
         }
 
-        template < >
         inline void operator()(half& dst, const float& src) const
         {
             dst = Bitwise::floatToHalf(src);
         }
          
-        template < >
         inline void operator()(float& dst, const uint8_t& src) const
         {
             dst = (float)(src) / 255.0f;
         }
 
-        template < >
         inline void operator()(float& dst, const uint16_t& src) const
         {
             dst = (float)(src) / USHRT_MAX;
         }
 
-        template < >
         inline void operator()(float& dst, const half& src) const
         {
             dst = Bitwise::halfToFloat(src());
         }
 
-        template < >
         inline void operator()(float& dst, const float& src) const
         {
             dst = src;
@@ -162,110 +145,94 @@ namespace Ctr
             dst = T(src);
         }
 
-        template < >
         inline void operator()(uint8_t& dst, const uint8_t& src, float power) const
         {
             float converted = saturate(pow((((float)src)/255.0f), power));
             dst = (uint8_t)(converted * 255.0f);
         }
 
-        template < >
         inline void operator()(uint8_t& dst, const uint16_t& src, float power) const
         {
             float converted = saturate(pow((((float)src) / USHRT_MAX), power));
             dst = uint8_t(converted * 255.0f);
         }
 
-        template < >
         inline void operator()(uint8_t& dst, const half& src, float power) const
         {
             float converted = saturate(pow(Bitwise::halfToFloat(src()), power));
             dst = (uint8_t)(converted * 255.0f);
         }
 
-        template < >
         inline void operator()(uint8_t& dst, const float& src, float power) const
         {
             float converted = saturate(pow(src, power));
             dst = (uint8_t)(converted * 255.0f);
         }
-        template < >
         inline void operator()(uint16_t& dst, const uint8_t& src, float power) const
         {
             float converted = saturate(pow(((src / 255.0f)), power));
             dst = (uint16_t)(converted * USHRT_MAX);
         }
 
-        template < >
         inline void operator()(uint16_t& dst, const float& src, float power) const
         {
             float converted = saturate(pow(src, power));
             dst = (uint16_t)(converted * USHRT_MAX);
         }
 
-        template < >
         inline void operator()(uint16_t& dst, const uint16_t& src, float power) const
         {
             float converted = saturate(float(pow((float)(src / USHRT_MAX), power)));
             dst = uint16_t(converted * USHRT_MAX);
         }
-        template < >
         inline void operator()(uint16_t& dst, const half& src, float power) const
         {
             float converted = saturate(pow(saturate(Bitwise::halfToFloat(src())), power));
             dst = uint16_t(converted / USHRT_MAX);
         }
 
-        template < >
         inline void operator()(half& dst, const uint8_t& src, float power) const
         {
             float converted = saturate(pow((src / 255.0f), power));
             dst = Bitwise::floatToHalf(converted);
         }
 
-        template < >
         inline void operator()(half& dst, const uint16_t& src, float power) const
         {
             float converted = saturate(pow(float(src / USHRT_MAX), power));
             dst = Bitwise::floatToHalf(converted);
         }
 
-        template < >
         inline void operator()(half& dst, const half& src, float power) const
         {
             float converted = saturate(pow(Bitwise::halfToFloat(src()), power));
             dst = Bitwise::floatToHalf(converted);
         }
 
-        template < >
         inline void operator()(half& dst, const float& src, float power) const
         {
             float converted = saturate(pow(src, power));
             dst = Bitwise::floatToHalf(converted);
         }
 
-        template < >
         inline void operator()(float& dst, const uint8_t& src, float power) const
         {
             float converted = saturate(pow(float(src / 255.0f), power));
             dst = (float)(converted);
         }
 
-        template < >
         inline void operator()(float& dst, const uint16_t& src, float power) const
         {
             float converted = saturate(pow(float(src / USHRT_MAX), power));
             dst = (float)(converted);
         }
 
-        template < >
         inline void operator()(float& dst, const half& src, float power) const
         {
             float converted = saturate(pow(Bitwise::halfToFloat(src()), power));
             dst = converted;
         }
 
-        template < >
         inline void operator()(float& dst, const float& src, float power) const
         {
             float converted = saturate(pow(src, power));
@@ -374,14 +341,14 @@ namespace Ctr
         {
             if (channelMapping)
             {
-                concurrency::parallel_for(size_t(0), size_t(height), [&](size_t rowId)
+                Ctr::parallelFor(size_t(0), size_t(height), [&](size_t rowId)
                 {
                     convert(rowId, dst, src, width, height, dstChannels, srcChannels, channelMapping, dstGamma, srcGamma);
                 });
             }
             else
             {
-                concurrency::parallel_for(size_t(0), size_t(height), [&](size_t rowId)
+                Ctr::parallelFor(size_t(0), size_t(height), [&](size_t rowId)
                 {
                     convert(rowId, dst, src, width, height, dstChannels, srcChannels, dstGamma, srcGamma);
                 });
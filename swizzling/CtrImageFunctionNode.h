@@ -45,10 +45,13 @@
 #include <CtrRenderNode.h>
 #include <CtrTypedProperty.h>
 #include <CtrIDevice.h>
+#include <CtrRenderNode.h>
+#include <CtrTypedProperty.h>
+#include <CtrIDevice.h>
 #include <CtrImageConversion.h>
 #include <CtrITexture.h>
 #include <CtrTextureMgr.h>
-#include <ppl.h>
+#include <CtrParallel.h>
 #include <CtrVector3.h>
 
 namespace Ctr
@@ -359,7 +362,7 @@ class ImageFileSourceFunction : public ImageFunction
             PixelBox sourcePixelBox = sourceImage->getPixelBox();
             size_t sourceWidth = sourceImage->getWidth();
             size_t sourceHeight = sourceImage->getHeight();
-            concurrency::parallel_for(size_t(0), size_t(sourceWidth), [&](size_t rowId)
+            Ctr::parallelFor(size_t(0), size_t(sourceWidth), [&](size_t rowId)
             {
                 (*this)(rowId, sourceWidth, sourceHeight, sourcePixelBox, fillColor, fillAlpha);
             });
@@ -1057,7 +1060,7 @@ public:
                 size_t mipWidth = mipImage->getWidth();
                 size_t mipHeight = mipImage->getHeight();
                 uint8_t* mipPixels = (uint8_t*)mipPixelBox.data;
-                concurrency::parallel_for(size_t(0), size_t(mipHeight), [&](size_t rowId)
+                Ctr::parallelFor(size_t(0), size_t(mipHeight), [&](size_t rowId)
                 {
                     for (size_t columnId = 0; columnId < mipWidth; columnId++)
                     {
@@ -1180,11 +1183,11 @@ class ImageProcessorFunction : public ImageFunctionT
         ImageFunctionT(n, this)
     {
         using std::placeholders::_1;
-        addTask(std::make_pair(_imageResultProperty,
-            std::bind(&ImageProcessorFunction<typename ImageFunctionT>::computeImage, this, _1)));
-        addTask(std::make_pair(_textureResultProperty,
+        this->addTask(std::make_pair(this->_imageResultProperty,
+            std::bind(&ImageProcessorFunction<ImageFunctionT>::computeImage, this, _1)));
+        this->addTask(std::make_pair(this->_textureResultProperty,
             std::bind(&ImageFunction::computeTexture, this, _1)));
-        addTask(std::make_pair(_convertedRGBAImageProperty,
+        this->addTask(std::make_pair(this->_convertedRGBAImageProperty,
             std::bind(&ImageFunction::computeRGBAImage, this, _1)));
 
         ImageFunctionT::setup();
@@ -1201,7 +1204,7 @@ class ImageProcessorFunction : public ImageFunctionT
         for (uint32_t sourceId = 0; sourceId < 5; sourceId++)
         {
             const TextureImageProperty* sourceProperty = 
-                imageDependency(sourceId);
+                this->imageDependency(sourceId);
 
             if (!sourceProperty)
             {
@@ -1220,12 +1223,12 @@ class ImageProcessorFunction : public ImageFunctionT
             }
         }
 
-        cacheProcessingOptions(sources);
-        size_t _imageWidth = imageWidth();
-        size_t _imageHeight = imageHeight();
+        this->cacheProcessingOptions(sources);
+        size_t _imageWidth = this->imageWidth();
+        size_t _imageHeight = this->imageHeight();
 
         PixelFormat format;
-        switch (componentCount())
+        switch (this->componentCount())
         {
             case 1:
                 format = PF_FLOAT32_R;
@@ -1251,12 +1254,12 @@ class ImageProcessorFunction : public ImageFunctionT
                              IF_DEFAULT);
         Ctr::PixelBox destinationPixelBox = destinationImage->getPixelBox(0,0);
 
-        concurrency::parallel_for(size_t(0), size_t(_imageHeight), [&](size_t rowId)
+        Ctr::parallelFor(size_t(0), size_t(_imageHeight), [&](size_t rowId)
         {
             (*this)(rowId, _imageWidth, _imageHeight, sources, destinationPixelBox);
         });
 
-        _imageResultProperty->set(destinationImage);
+        this->_imageResultProperty->set(destinationImage);
     }
 
   protected:
@@ -1281,7 +1284,7 @@ template <typename Function>
 class ImageFunctionNode : public Ctr::RenderNode
 {
   public:
-    typedef ImageFunctionPropertyT<typename Function> ImageFunctionProperty;
+    typedef ImageFunctionPropertyT<Function> ImageFunctionProperty;
 
     ImageFunctionNode(Ctr::IDevice* device) : 
         Ctr::RenderNode(device),
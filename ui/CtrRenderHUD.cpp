@@ -49,6 +49,11 @@
 #include <CtrRenderDeviceD3D11.h>
 #include <CtrImageWidget.h>
 #include <CtrApplication.h>
+#include <CtrProfiler.h>
+#include <CtrShaderParameterValue.h>
+#include <CtrGpuConstantBuffer.h>
+#include <CtrUIRenderer.h>
+#include <Ctrimgui.h>
 
 namespace Ctr
 {
@@ -60,6 +65,9 @@ RenderHUD::RenderHUD (Ctr::Application* application,
                       Ctr::InputState* inputState,
                       const std::string& logoPath) :
 _drawFps (false),
+_drawProfiler (false),
+_profilerScroll (0),
+_profileCaptureIndex (0),
 _inputState (inputState),
 _logoPath (logoPath),
 _application (application),
@@ -136,6 +144,66 @@ RenderHUD::uiVisible(void) const
     return _uiVisible;
 }
 
+bool
+RenderHUD::profilerVisible() const
+{
+    return _drawProfiler;
+}
+
+void
+RenderHUD::setProfilerVisible(bool value)
+{
+    _drawProfiler = value;
+}
+
+void
+RenderHUD::showProfilerUI(int x, int y, int width, int height)
+{
+#if CTR_PROFILE
+    std::vector<Ctr::ProfileZoneStats> zones;
+    Ctr::Profiler::frameStats(zones);
+
+    imguiBeginScrollArea("Profiler", x, y, width, height, &_profilerScroll);
+    imguiLabel("Frame %llu: %.2f ms", (unsigned long long)Ctr::Profiler::frame(), Ctr::Profiler::frameMs());
+    const Ctr::ShaderParameterValue::Stats& parameterStats = Ctr::ShaderParameterValue::stats();
+    imguiLabel("Parameters: %u evaluated, %u skipped, %u unchanged", 
+               parameterStats.evaluated, parameterStats.skipped, parameterStats.unchanged);
+    const Ctr::GpuConstantBuffer::Stats& bufferStats = Ctr::GpuConstantBuffer::stats();
+    imguiLabel("Constant buffers: %u uploads, %u KB, %u/%u redundant writes", 
+               bufferStats.uploads, bufferStats.uploadedBytes / 1024, 
+               bufferStats.redundantWrites, bufferStats.writes);
+    const Ctr::UIRenderer::Stats& uiStats = Ctr::UIRenderer::stats();
+    imguiLabel("UI: %u draws, %u maps, %u widgets, %u vertices", 
+               uiStats.draws, uiStats.maps, uiStats.recorded, uiStats.vertices);
+    if (Ctr::Profiler::capturing())
+    {
+        imguiLabel(imguiRGBA(255, 96, 96), "Capturing trace (F9 to stop)");
+    }
+    imguiSeparatorLine();
+
+    uint32_t thread = UINT_MAX;
+    for (auto it = zones.begin(); it != zones.end(); it++)
+    {
+        if (it->thread != thread)
+        {
+            thread = it->thread;
+            imguiLabel(imguiRGBA(160, 160, 255), "Thread %u", thread);
+        }
+
+        std::string indent(it->depth * 2, ' ');
+        imguiLabel("%s%s  %.2f ms (avg %.2f, max %.2f) x%u", 
+                   indent.c_str(), it->name, it->totalMs, it->averageMs, it->maxMs, it->calls);
+    }
+
+    if (uint64_t dropped = Ctr::Profiler::droppedEvents())
+    {
+        imguiSeparatorLine();
+        imguiLabel(imguiRGBA(255, 96, 96), "%llu events dropped", (unsigned long long)dropped);
+    }
+    imguiEndScrollArea();
+#endif
+}
+
 bool
 RenderHUD::update(double elapsedTime)
 {
@@ -157,6 +225,24 @@ RenderHUD::update(double elapsedTime)
     {
         _drawFps = true;
     }
+    if (_inputState->getKeyState(DIK_F6))
+    {
+        _drawProfiler = false;
+    }
+    if (_inputState->getKeyState(DIK_F5))
+    {
+        _drawProfiler = true;
+    }
+    if (_inputState->getKeyState(DIK_F8) && !Ctr::Profiler::capturing())
+    {
+        Ctr::Profiler::beginCapture();
+    }
+    if (_inputState->getKeyState(DIK_F9) && Ctr::Profiler::capturing())
+    {
+        std::ostringstream stream;
+        stream << "data/profiles/trace" << _profileCaptureIndex++ << ".json";
+        Ctr::Profiler::endCapture(stream.str());
+    }
     
     return true;
 }
@@ -170,6 +256,8 @@ RenderHUD::create()
 void
 RenderHUD::render(const Ctr::Camera* camera)
 {
+    CTR_PROFILE_SCOPE("RenderHUD::render");
+
     Ctr::DrawMode drawMode = _deviceInterface->getDrawMode ();
     _deviceInterface->setDrawMode (Ctr::Filled);
 
@@ -92,6 +92,15 @@ class RenderHUD
 
     Ctr::ImageWidget*           logo();
 
+    //-------------------------------------------------------
+    // Per zone timings from Ctr::Profiler. Must be called
+    // between imguiBeginFrame and imguiEndFrame, typically
+    // from showApplicationUI when profilerVisible() is set.
+    //-------------------------------------------------------
+    void                       showProfilerUI(int x, int y, int width, int height);
+    bool                       profilerVisible() const;
+    void                       setProfilerVisible(bool);
+
   protected:
 
     Ctr::Application*           _application;
@@ -106,6 +115,9 @@ class RenderHUD
     Ctr::InputState*            _inputState;
 
     bool                       _drawFps;
+    bool                       _drawProfiler;
+    int32_t                    _profilerScroll;
+    uint32_t                   _profileCaptureIndex;
     std::string                _logoPath;
     float                      _elapsedTime;
 };